@@ -0,0 +1,196 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "verse.h"
+#include "verse_types.h"
+
+#include "v_commands.h"
+#include "v_node_commands.h"
+#include "v_taggroup_commands.h"
+#include "v_tag_commands.h"
+#include "v_layer_commands.h"
+#include "v_in_queue.h"
+
+#include "b_bench.h"
+
+/* Number of different commands packed in cycle */
+#define CMD_COUNT		256
+/* Size of buffer for packed commands */
+#define BUFFER_SIZE		65536
+/* Size of payload of unpacked packet */
+#define PAYLOAD_SIZE	1400
+
+/* Function creating i-th command of one family */
+typedef struct Generic_Cmd *(*BCmdCreateFunc)(const uint32 i);
+
+static struct Generic_Cmd *b_node_cmd_create(const uint32 i)
+{
+	return v_node_create_create(65536 + i, 1, 100, (uint16)i);
+}
+
+static struct Generic_Cmd *b_taggroup_cmd_create(const uint32 i)
+{
+	return v_taggroup_create_create(65536, (uint16)i, 1);
+}
+
+static struct Generic_Cmd *b_tag_cmd_create(const uint32 i)
+{
+	uint32 value = i;
+	return v_tag_set_create(65536, 1, (uint16)i, VRS_VALUE_TYPE_UINT32, 1, &value);
+}
+
+static struct Generic_Cmd *b_layer_cmd_create(const uint32 i)
+{
+	real32 value[3] = {(real32)i, 0.5f, -1.0f};
+	return v_layer_set_value_create(65536, 1, i, VRS_VALUE_TYPE_REAL32, 3, value);
+}
+
+/**
+ * \brief Benchmark of packing commands of one family (v_cmd_pack())
+ */
+static void b_cmd_pack(struct VBench *bench, const uint32 count,
+		BCmdCreateFunc create)
+{
+	struct Generic_Cmd *cmds[CMD_COUNT];
+	char *buffer = (char*)malloc(BUFFER_SIZE);
+	uint32 i, buffer_pos = 0;
+
+	assert(buffer != NULL);
+
+	for(i = 0; i < CMD_COUNT; i++) {
+		cmds[i] = create(i);
+		assert(cmds[i] != NULL);
+	}
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		struct Generic_Cmd *cmd = cmds[i % CMD_COUNT];
+		if(buffer_pos + PAYLOAD_SIZE > BUFFER_SIZE) {
+			bench->bytes += buffer_pos;
+			buffer_pos = 0;
+		}
+		buffer_pos += v_cmd_pack(&buffer[buffer_pos], cmd, v_cmd_size(cmd), 0);
+	}
+	b_bench_stop(bench);
+
+	bench->bytes += buffer_pos;
+	bench->ops += count;
+
+	for(i = 0; i < CMD_COUNT; i++) {
+		v_cmd_destroy(&cmds[i]);
+	}
+	free(buffer);
+}
+
+/**
+ * \brief Benchmark of unpacking commands of one family (v_cmd_unpack()).
+ * Commands are unpacked from the payload of one packet to incoming queue.
+ */
+static void b_cmd_unpack(struct VBench *bench, const uint32 count,
+		BCmdCreateFunc create)
+{
+	struct VInQueue *in_queue = v_in_queue_create();
+	struct Generic_Cmd *cmd;
+	char buffer[PAYLOAD_SIZE];
+	uint32 i, cmd_count = 0;
+	uint16 buffer_pos = 0;
+
+	/* Pack payload of packet */
+	for(i = 0; buffer_pos + 64 < PAYLOAD_SIZE; i++) {
+		cmd = create(i);
+		assert(cmd != NULL);
+		buffer_pos += v_cmd_pack(&buffer[buffer_pos], cmd, v_cmd_size(cmd), 0);
+		v_cmd_destroy(&cmd);
+		cmd_count++;
+	}
+
+	for(i = 0; i < count; i += cmd_count) {
+		b_bench_start(bench);
+		v_cmd_unpack(buffer, buffer_pos, in_queue);
+		b_bench_stop(bench);
+
+		bench->ops += cmd_count;
+		bench->bytes += buffer_pos;
+
+		while((cmd = v_in_queue_pop(in_queue)) != NULL) {
+			v_cmd_destroy(&cmd);
+		}
+	}
+
+	v_in_queue_destroy(&in_queue);
+}
+
+void b_cmd_pack_node(struct VBench *bench, const uint32 count)
+{
+	b_cmd_pack(bench, count, b_node_cmd_create);
+}
+
+void b_cmd_pack_taggroup(struct VBench *bench, const uint32 count)
+{
+	b_cmd_pack(bench, count, b_taggroup_cmd_create);
+}
+
+void b_cmd_pack_tag(struct VBench *bench, const uint32 count)
+{
+	b_cmd_pack(bench, count, b_tag_cmd_create);
+}
+
+void b_cmd_pack_layer(struct VBench *bench, const uint32 count)
+{
+	b_cmd_pack(bench, count, b_layer_cmd_create);
+}
+
+void b_cmd_unpack_node(struct VBench *bench, const uint32 count)
+{
+	b_cmd_unpack(bench, count, b_node_cmd_create);
+}
+
+void b_cmd_unpack_taggroup(struct VBench *bench, const uint32 count)
+{
+	b_cmd_unpack(bench, count, b_taggroup_cmd_create);
+}
+
+void b_cmd_unpack_tag(struct VBench *bench, const uint32 count)
+{
+	b_cmd_unpack(bench, count, b_tag_cmd_create);
+}
+
+void b_cmd_unpack_layer(struct VBench *bench, const uint32 count)
+{
+	b_cmd_unpack(bench, count, b_layer_cmd_create);
+}
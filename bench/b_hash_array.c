@@ -0,0 +1,147 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "verse_types.h"
+#include "v_list.h"
+
+#include "b_bench.h"
+
+/* Structure of item stored in hash array */
+typedef struct BHashItem {
+	uint32	id;
+	uint32	value;
+} BHashItem;
+
+/**
+ * \brief This function creates array of items with keys, that differ in high
+ * bits too, and it adds them to hash array, when add is 1.
+ */
+static struct BHashItem *b_hash_array_prepare(struct VHashArrayBase *hash_array,
+		const uint32 count,
+		const int add)
+{
+	struct BHashItem *items;
+	uint32 i;
+
+	items = (struct BHashItem*)calloc(count, sizeof(struct BHashItem));
+	assert(items != NULL);
+
+	v_hash_array_init(hash_array, HASH_MOD_65536,
+			offsetof(BHashItem, id), sizeof(uint32));
+
+	for(i = 0; i < count; i++) {
+		items[i].id = i * 2654435761U;
+		items[i].value = i;
+		if(add == 1) {
+			v_hash_array_add_item(hash_array, &items[i], sizeof(BHashItem));
+		}
+	}
+
+	return items;
+}
+
+/**
+ * \brief Benchmark of adding items to hash array
+ */
+void b_hash_array_add(struct VBench *bench, const uint32 count)
+{
+	struct VHashArrayBase hash_array;
+	struct BHashItem *items = b_hash_array_prepare(&hash_array, count, 0);
+	uint32 i;
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		v_hash_array_add_item(&hash_array, &items[i], sizeof(BHashItem));
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+
+	v_hash_array_destroy(&hash_array);
+	free(items);
+}
+
+/**
+ * \brief Benchmark of finding items in hash array
+ */
+void b_hash_array_find(struct VBench *bench, const uint32 count)
+{
+	struct VHashArrayBase hash_array;
+	struct BHashItem *items = b_hash_array_prepare(&hash_array, count, 1);
+	struct BHashItem key;
+	uint32 i, found = 0;
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		/* Every second key does not exist */
+		key.id = (i / 2) * 2654435761U + (i % 2);
+		if(v_hash_array_find_item(&hash_array, &key) != NULL) {
+			found++;
+		}
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+	assert(found >= count / 2);
+	(void)found;
+
+	v_hash_array_destroy(&hash_array);
+	free(items);
+}
+
+/**
+ * \brief Benchmark of removing items from hash array
+ */
+void b_hash_array_remove(struct VBench *bench, const uint32 count)
+{
+	struct VHashArrayBase hash_array;
+	struct BHashItem *items = b_hash_array_prepare(&hash_array, count, 1);
+	uint32 i;
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		v_hash_array_remove_item(&hash_array, &items[i]);
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+
+	v_hash_array_destroy(&hash_array);
+	free(items);
+}
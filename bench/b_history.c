@@ -0,0 +1,152 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "verse.h"
+#include "verse_types.h"
+
+#include "v_commands.h"
+#include "v_layer_commands.h"
+#include "v_history.h"
+#include "v_out_queue.h"
+#include "v_in_queue.h"
+#include "v_sys_commands.h"
+
+#include "b_bench.h"
+
+/* Number of packets added to the history at once */
+#define PACKET_COUNT		64
+/* Number of commands in one packet */
+#define PACKET_CMD_COUNT	16
+
+/**
+ * \brief This function creates context of fake connection in OPEN state
+ * without flow control and congestion control.
+ */
+struct BConnCtx *b_conn_ctx_create(const uint8 cmd_cmpr)
+{
+	struct BConnCtx *ctx = (struct BConnCtx*)calloc(1, sizeof(struct BConnCtx));
+	struct VDgramConn *dgram_conn;
+
+	assert(ctx != NULL);
+
+	v_init_session(&ctx->session);
+	ctx->session.in_queue = v_in_queue_create();
+	ctx->session.out_queue = v_out_queue_create();
+	ctx->session.dgram_conn = dgram_conn =
+			(struct VDgramConn*)calloc(1, sizeof(struct VDgramConn));
+	assert(dgram_conn != NULL);
+
+	v_conn_dgram_init(dgram_conn);
+	dgram_conn->host_state = UDP_CLIENT_STATE_OPEN;
+	dgram_conn->fc_meth = FC_NONE;
+	dgram_conn->cc_meth = CC_NONE;
+	dgram_conn->cwin = 0xFFFF;
+	dgram_conn->host_cmd_cmpr = cmd_cmpr;
+	dgram_conn->io_ctx.mtu = DEFAULT_MTU;
+	dgram_conn->io_ctx.host_addr.ip_ver = IPV4;
+
+	/* Sent packets are only queued in batch */
+	v_packet_batch_init(&ctx->batch);
+	dgram_conn->io_ctx.batch = &ctx->batch;
+
+	CTX_current_session_set(&ctx->C, &ctx->session);
+	CTX_current_dgram_conn_set(&ctx->C, dgram_conn);
+	CTX_io_ctx_set(&ctx->C, &dgram_conn->io_ctx);
+	CTX_s_packet_set(&ctx->C, &ctx->s_packet);
+	CTX_r_packet_set(&ctx->C, &ctx->r_packet);
+
+	return ctx;
+}
+
+/**
+ * \brief This function destroys context of fake connection
+ */
+void b_conn_ctx_destroy(struct BConnCtx *ctx)
+{
+	ctx->session.dgram_conn->io_ctx.batch = NULL;
+	v_destroy_session(&ctx->session);
+	free(ctx);
+}
+
+/**
+ * \brief Benchmark of history of sent packets. One operation is adding
+ * packet with commands to the history and removing acknowledged packet
+ * from the history.
+ */
+void b_packet_history(struct VBench *bench, const uint32 count)
+{
+	struct BConnCtx *ctx = b_conn_ctx_create(CMPR_ADDR_SHARE);
+	struct VDgramConn *dgram_conn = ctx->session.dgram_conn;
+	struct VPacket_History *history = &dgram_conn->packet_history;
+	struct Generic_Cmd **cmds;
+	struct VSent_Packet *sent_packet;
+	real32 value[3] = {1.0f, 2.0f, 3.0f};
+	uint32 i, j, k, packet_id = 1;
+
+	cmds = (struct Generic_Cmd**)malloc(PACKET_COUNT * PACKET_CMD_COUNT *
+			sizeof(struct Generic_Cmd*));
+	assert(cmds != NULL);
+
+	for(i = 0; i < count; i += PACKET_COUNT) {
+		for(j = 0; j < PACKET_COUNT * PACKET_CMD_COUNT; j++) {
+			cmds[j] = v_layer_set_value_create(65536, 1, j,
+					VRS_VALUE_TYPE_REAL32, 3, value);
+		}
+
+		b_bench_start(bench);
+		for(j = 0; j < PACKET_COUNT; j++) {
+			sent_packet = v_packet_history_add_packet(history, packet_id + j);
+			assert(sent_packet != NULL);
+			for(k = 0; k < PACKET_CMD_COUNT; k++) {
+				v_packet_history_add_cmd(history, sent_packet,
+						cmds[j * PACKET_CMD_COUNT + k], VRS_DEFAULT_PRIORITY);
+			}
+		}
+		for(j = 0; j < PACKET_COUNT; j++) {
+			v_packet_history_rem_packet(&ctx->C, packet_id + j);
+		}
+		b_bench_stop(bench);
+
+		packet_id += PACKET_COUNT;
+		bench->ops += PACKET_COUNT;
+	}
+
+	free(cmds);
+	b_conn_ctx_destroy(ctx);
+}
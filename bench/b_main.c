@@ -0,0 +1,322 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+/*
+ * Microbenchmarks of core data structures and codecs of verse library.
+ * Results are printed in JSON format to make tracking of performance
+ * regressions possible.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "verse.h"
+#include "verse_types.h"
+
+#include "v_slab.h"
+
+#include "b_bench.h"
+
+/* Maximal number of runs of one benchmark */
+#define MAX_REPEAT		100
+
+/**
+ * Description of one benchmark
+ */
+typedef struct VBenchDesc {
+	const char		*name;		/* Name of benchmark */
+	VBenchFunc		func;		/* Function running benchmark */
+	uint32			count;		/* Default number of operations in one run */
+} VBenchDesc;
+
+static const struct VBenchDesc benchmarks[] = {
+		{"hash_array_add", b_hash_array_add, 100000},
+		{"hash_array_find", b_hash_array_find, 100000},
+		{"hash_array_remove", b_hash_array_remove, 100000},
+		{"out_queue_push_tail_shared", b_out_queue_push_tail_shared, 100000},
+		{"out_queue_push_tail_unshared", b_out_queue_push_tail_unshared, 100000},
+		{"out_queue_pop_shared", b_out_queue_pop_shared, 100000},
+		{"out_queue_pop_unshared", b_out_queue_pop_unshared, 100000},
+		{"in_queue_push", b_in_queue_push, 100000},
+		{"in_queue_pop", b_in_queue_pop, 100000},
+		{"cmd_pack_node", b_cmd_pack_node, 1000000},
+		{"cmd_pack_taggroup", b_cmd_pack_taggroup, 1000000},
+		{"cmd_pack_tag", b_cmd_pack_tag, 1000000},
+		{"cmd_pack_layer", b_cmd_pack_layer, 1000000},
+		{"cmd_unpack_node", b_cmd_unpack_node, 100000},
+		{"cmd_unpack_taggroup", b_cmd_unpack_taggroup, 100000},
+		{"cmd_unpack_tag", b_cmd_unpack_tag, 100000},
+		{"cmd_unpack_layer", b_cmd_unpack_layer, 100000},
+		{"packet_history", b_packet_history, 10000},
+		{"send_packet_addr_share", b_send_packet_addr_share, 10000},
+		{"send_packet_deflate", b_send_packet_deflate, 10000},
+		{NULL, NULL, 0}
+};
+
+/* Number of calls of malloc(), calloc() and realloc() */
+static uint64 alloc_count = 0;
+
+#ifdef __GLIBC__
+/* Allocations are counted by wrappers of allocation functions of glibc. Verse
+ * library is linked dynamically, then these wrappers are used by the library
+ * too. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	alloc_count++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	alloc_count++;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	alloc_count++;
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+/**
+ * \brief This function returns number of objects allocated from slab
+ * allocator by this thread
+ */
+static uint64 slab_alloc_count(void)
+{
+	struct VSlabStats stats[SLAB_CLASS_COUNT];
+	uint64 count = 0;
+	int i;
+
+	v_slab_get_stats(stats);
+
+	for(i = 0; i < SLAB_CLASS_COUNT; i++) {
+		count += stats[i].alloc_count;
+	}
+
+	return count;
+}
+
+/**
+ * \brief This function starts measuring of benchmark
+ */
+void b_bench_start(struct VBench *bench)
+{
+	bench->start_slab_allocs = slab_alloc_count();
+	bench->start_allocs = alloc_count;
+	clock_gettime(CLOCK_MONOTONIC, &bench->start);
+}
+
+/**
+ * \brief This function stops measuring of benchmark and it adds measured
+ * time and allocations to the results.
+ */
+void b_bench_stop(struct VBench *bench)
+{
+	struct timespec stop;
+
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	bench->allocs += alloc_count - bench->start_allocs;
+	bench->ns += (uint64)(stop.tv_sec - bench->start.tv_sec) * 1000000000ULL +
+			(uint64)stop.tv_nsec - (uint64)bench->start.tv_nsec;
+	bench->slab_allocs += slab_alloc_count() - bench->start_slab_allocs;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+	double d = *(const double*)a - *(const double*)b;
+	return (d > 0) - (d < 0);
+}
+
+/**
+ * \brief This function runs one benchmark several times and it prints
+ * results in JSON format.
+ *
+ * The first run is not measured (warm up of caches and allocators). Time
+ * of one operation is median of all runs.
+ */
+static void run_benchmark(FILE *out,
+		const struct VBenchDesc *desc,
+		const uint32 count,
+		const int repeat,
+		const int first)
+{
+	struct VBench bench;
+	double ns_per_op[MAX_REPEAT], median;
+	int i;
+
+	memset(&bench, 0, sizeof(struct VBench));
+	desc->func(&bench, count);
+
+	for(i = 0; i < repeat; i++) {
+		memset(&bench, 0, sizeof(struct VBench));
+		desc->func(&bench, count);
+		ns_per_op[i] = (bench.ops > 0) ? (double)bench.ns / bench.ops : 0.0;
+	}
+
+	qsort(ns_per_op, repeat, sizeof(double), cmp_double);
+	median = (repeat % 2 == 1) ? ns_per_op[repeat/2] :
+			(ns_per_op[repeat/2 - 1] + ns_per_op[repeat/2]) / 2;
+
+	/* Allocations are the same in all runs, then the last run is used */
+	fprintf(out, "%s\t\t{\n", (first == 1) ? "" : ",\n");
+	fprintf(out, "\t\t\t\"name\": \"%s\",\n", desc->name);
+	fprintf(out, "\t\t\t\"ops\": %llu,\n", (unsigned long long)bench.ops);
+	fprintf(out, "\t\t\t\"ns_per_op\": %.2f,\n", median);
+	fprintf(out, "\t\t\t\"ns_per_op_min\": %.2f,\n", ns_per_op[0]);
+	fprintf(out, "\t\t\t\"ns_per_op_max\": %.2f,\n", ns_per_op[repeat - 1]);
+#ifdef __GLIBC__
+	fprintf(out, "\t\t\t\"allocs_per_op\": %.3f,\n",
+			(bench.ops > 0) ? (double)bench.allocs / bench.ops : 0.0);
+#else
+	fprintf(out, "\t\t\t\"allocs_per_op\": null,\n");
+#endif
+	fprintf(out, "\t\t\t\"slab_allocs_per_op\": %.3f,\n",
+			(bench.ops > 0) ? (double)bench.slab_allocs / bench.ops : 0.0);
+	fprintf(out, "\t\t\t\"ops_per_sec\": %.0f,\n",
+			(median > 0) ? 1e9 / median : 0.0);
+	fprintf(out, "\t\t\t\"bytes_per_sec\": %.0f\n",
+			(median > 0 && bench.ops > 0) ?
+					(double)bench.bytes / bench.ops * 1e9 / median : 0.0);
+	fprintf(out, "\t\t}");
+	fflush(out);
+}
+
+/**
+ * \brief This function print help of benchmark command
+ */
+static void print_help(char *prog_name)
+{
+	printf("\n Usage: %s [OPTION...]\n\n", prog_name);
+	printf("  This program runs microbenchmarks of verse library\n\n");
+	printf("  Options:\n");
+	printf("   -h               display this help and exit\n");
+	printf("   -l               list benchmarks and exit\n");
+	printf("   -f filter        run only benchmarks with name containing filter\n");
+	printf("   -r repeat        number of measured runs of each benchmark (default: 5)\n");
+	printf("   -s scale         multiply number of operations by scale (default: 1.0)\n");
+	printf("   -o file          write results to the file instead of stdout\n\n");
+}
+
+/**
+ * \brief Main function of benchmarks
+ */
+int main(int argc, char *argv[])
+{
+	FILE *out = stdout;
+	const char *filter = NULL, *out_file = NULL;
+	double scale = 1.0;
+	int opt, repeat = 5, first = 1, i;
+	uint32 count;
+
+	while( (opt = getopt(argc, argv, "hlf:r:s:o:")) != -1) {
+		switch(opt) {
+			case 'f':
+				filter = optarg;
+				break;
+			case 'r':
+				repeat = atoi(optarg);
+				if(repeat < 1 || repeat > MAX_REPEAT) {
+					printf("Unsupported number of runs: %s\n", optarg);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 's':
+				scale = atof(optarg);
+				if(scale <= 0.0) {
+					printf("Unsupported scale: %s\n", optarg);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 'o':
+				out_file = optarg;
+				break;
+			case 'l':
+				for(i = 0; benchmarks[i].name != NULL; i++) {
+					printf("%s\n", benchmarks[i].name);
+				}
+				exit(EXIT_SUCCESS);
+			case 'h':
+				print_help(argv[0]);
+				exit(EXIT_SUCCESS);
+			case ':':
+				exit(EXIT_FAILURE);
+			case '?':
+				exit(EXIT_FAILURE);
+				break;
+		}
+	}
+
+	vrs_set_debug_level(VRS_PRINT_NONE);
+
+	if(out_file != NULL) {
+		out = fopen(out_file, "w");
+		if(out == NULL) {
+			perror("fopen()");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	fprintf(out, "{\n\t\"repeat\": %d,\n\t\"scale\": %g,\n\t\"benchmarks\": [\n",
+			repeat, scale);
+
+	for(i = 0; benchmarks[i].name != NULL; i++) {
+		if(filter != NULL && strstr(benchmarks[i].name, filter) == NULL) {
+			continue;
+		}
+		count = (uint32)(benchmarks[i].count * scale);
+		if(count == 0) {
+			count = 1;
+		}
+		run_benchmark(out, &benchmarks[i], count, repeat, first);
+		first = 0;
+	}
+
+	fprintf(out, "\n\t]\n}\n");
+
+	if(out != stdout) {
+		fclose(out);
+	}
+
+	return EXIT_SUCCESS;
+}
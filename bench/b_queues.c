@@ -0,0 +1,229 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "verse.h"
+#include "verse_types.h"
+
+#include "v_commands.h"
+#include "v_layer_commands.h"
+#include "v_out_queue.h"
+#include "v_in_queue.h"
+
+#include "b_bench.h"
+
+/**
+ * \brief This function creates array of Layer_Set_Value commands. When shared
+ * is 1, then all commands have the same node and layer and their address could
+ * be shared in packets. Otherwise every command has own node.
+ */
+static struct Generic_Cmd **b_queue_cmds_create(const uint32 count,
+		const int shared)
+{
+	struct Generic_Cmd **cmds;
+	real32 value[3] = {1.0f, 2.0f, 3.0f};
+	uint32 i;
+
+	cmds = (struct Generic_Cmd**)malloc(count * sizeof(struct Generic_Cmd*));
+	assert(cmds != NULL);
+
+	for(i = 0; i < count; i++) {
+		cmds[i] = v_layer_set_value_create((shared == 1) ? 65536 : 65536 + i,
+				1, (shared == 1) ? i : 0, VRS_VALUE_TYPE_REAL32, 3, value);
+		assert(cmds[i] != NULL);
+	}
+
+	return cmds;
+}
+
+/**
+ * \brief This function destroys all commands in array and array itself
+ */
+static void b_queue_cmds_destroy(struct Generic_Cmd **cmds, const uint32 count)
+{
+	uint32 i;
+
+	for(i = 0; i < count; i++) {
+		if(cmds[i] != NULL) {
+			v_cmd_destroy(&cmds[i]);
+		}
+	}
+
+	free(cmds);
+}
+
+/**
+ * \brief This function pops all commands from outgoing queue and it stores
+ * them in array of commands. It returns number of popped commands.
+ */
+static uint32 b_out_queue_pop_all(struct VOutQueue *out_queue,
+		struct Generic_Cmd **cmds,
+		const uint32 count)
+{
+	struct Generic_Cmd *cmd;
+	uint32 i = 0;
+	uint16 cmd_count, len;
+	int8 share;
+
+	do {
+		len = 0;
+		cmd = v_out_queue_pop(out_queue, VRS_DEFAULT_PRIORITY,
+				&cmd_count, &share, &len);
+		if(cmd != NULL && i < count) {
+			cmds[i++] = cmd;
+		}
+	} while(cmd != NULL);
+
+	return i;
+}
+
+/**
+ * \brief Benchmark of pushing commands to the outgoing queue
+ */
+static void b_out_queue_push_tail(struct VBench *bench, const uint32 count,
+		const int shared)
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct Generic_Cmd **cmds = b_queue_cmds_create(count, shared);
+	uint32 i;
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, cmds[i]);
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+
+	b_out_queue_pop_all(out_queue, cmds, count);
+	b_queue_cmds_destroy(cmds, count);
+	v_out_queue_destroy(&out_queue);
+}
+
+/**
+ * \brief Benchmark of popping commands from the outgoing queue
+ */
+static void b_out_queue_pop(struct VBench *bench, const uint32 count,
+		const int shared)
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct Generic_Cmd **cmds = b_queue_cmds_create(count, shared);
+	uint32 i, popped;
+
+	for(i = 0; i < count; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, cmds[i]);
+	}
+
+	b_bench_start(bench);
+	popped = b_out_queue_pop_all(out_queue, cmds, count);
+	b_bench_stop(bench);
+
+	bench->ops += popped;
+	assert(popped == count);
+
+	b_queue_cmds_destroy(cmds, count);
+	v_out_queue_destroy(&out_queue);
+}
+
+void b_out_queue_push_tail_shared(struct VBench *bench, const uint32 count)
+{
+	b_out_queue_push_tail(bench, count, 1);
+}
+
+void b_out_queue_push_tail_unshared(struct VBench *bench, const uint32 count)
+{
+	b_out_queue_push_tail(bench, count, 0);
+}
+
+void b_out_queue_pop_shared(struct VBench *bench, const uint32 count)
+{
+	b_out_queue_pop(bench, count, 1);
+}
+
+void b_out_queue_pop_unshared(struct VBench *bench, const uint32 count)
+{
+	b_out_queue_pop(bench, count, 0);
+}
+
+/**
+ * \brief Benchmark of pushing commands to the incoming queue
+ */
+void b_in_queue_push(struct VBench *bench, const uint32 count)
+{
+	struct VInQueue *in_queue = v_in_queue_create();
+	struct Generic_Cmd **cmds = b_queue_cmds_create(count, 1);
+	uint32 i;
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		v_in_queue_push(in_queue, cmds[i]);
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+
+	for(i = 0; i < count; i++) {
+		cmds[i] = v_in_queue_pop(in_queue);
+	}
+	b_queue_cmds_destroy(cmds, count);
+	v_in_queue_destroy(&in_queue);
+}
+
+/**
+ * \brief Benchmark of popping commands from the incoming queue
+ */
+void b_in_queue_pop(struct VBench *bench, const uint32 count)
+{
+	struct VInQueue *in_queue = v_in_queue_create();
+	struct Generic_Cmd **cmds = b_queue_cmds_create(count, 1);
+	uint32 i;
+
+	for(i = 0; i < count; i++) {
+		v_in_queue_push(in_queue, cmds[i]);
+	}
+
+	b_bench_start(bench);
+	for(i = 0; i < count; i++) {
+		cmds[i] = v_in_queue_pop(in_queue);
+	}
+	b_bench_stop(bench);
+
+	bench->ops += count;
+
+	b_queue_cmds_destroy(cmds, count);
+	v_in_queue_destroy(&in_queue);
+}
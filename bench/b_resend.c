@@ -0,0 +1,107 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "verse.h"
+#include "verse_types.h"
+
+#include "v_commands.h"
+#include "v_layer_commands.h"
+#include "v_history.h"
+#include "v_out_queue.h"
+#include "v_resend_mechanism.h"
+#include "v_sys_commands.h"
+
+#include "b_bench.h"
+
+/**
+ * \brief Benchmark of packing commands from outgoing queue to packets
+ * (send_packet_in_OPEN_CLOSEREQ_state()). The count is number of commands
+ * in outgoing queue and one operation is one sent packet.
+ */
+static void b_send_packet(struct VBench *bench, const uint32 count,
+		const uint8 cmd_cmpr)
+{
+	struct BConnCtx *ctx = b_conn_ctx_create(cmd_cmpr);
+	struct VDgramConn *dgram_conn = ctx->session.dgram_conn;
+	struct Generic_Cmd *cmd;
+	uint32 i, first_id, packet_count = 0;
+	int ret;
+
+	/* Values of one layer changed at once */
+	for(i = 0; i < count; i++) {
+		real32 value[3] = {(real32)i, 0.5f, -1.0f};
+		cmd = v_layer_set_value_create(65536, 1, i,
+				VRS_VALUE_TYPE_REAL32, 3, value);
+		v_out_queue_push_tail(ctx->session.out_queue, 0,
+				VRS_DEFAULT_PRIORITY, cmd);
+	}
+
+	first_id = dgram_conn->host_id + dgram_conn->count_s_pay;
+
+	b_bench_start(bench);
+	while(v_out_queue_get_count(ctx->session.out_queue) > 0) {
+		ret = send_packet_in_OPEN_CLOSEREQ_state(&ctx->C);
+		if(ret != SEND_PACKET_SUCCESS && ret != SEND_PACKET_FULL) {
+			break;
+		}
+		bench->bytes += dgram_conn->io_ctx.buf_size;
+		packet_count++;
+		/* Drop queued packet */
+		ctx->batch.count = 0;
+	}
+	b_bench_stop(bench);
+
+	bench->ops += packet_count;
+
+	/* All packets are acknowledged */
+	for(i = 0; i < packet_count; i++) {
+		v_packet_history_rem_packet(&ctx->C, first_id + i);
+	}
+
+	b_conn_ctx_destroy(ctx);
+}
+
+void b_send_packet_addr_share(struct VBench *bench, const uint32 count)
+{
+	b_send_packet(bench, count, CMPR_ADDR_SHARE);
+}
+
+void b_send_packet_deflate(struct VBench *bench, const uint32 count)
+{
+	b_send_packet(bench, count, CMPR_DEFLATE);
+}
@@ -0,0 +1,115 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#ifndef B_BENCH_H_
+#define B_BENCH_H_
+
+#include <time.h>
+
+#include "verse_types.h"
+
+#include "v_context.h"
+#include "v_session.h"
+#include "v_connection.h"
+#include "v_network.h"
+
+/**
+ * Result of one run of one benchmark. Benchmark measures only code between
+ * b_bench_start() and b_bench_stop(), then preparation of data could be
+ * excluded from results.
+ */
+typedef struct VBench {
+	uint64			ops;			/**< Number of measured operations */
+	uint64			bytes;			/**< Number of processed bytes (0, when it has no meaning) */
+	uint64			ns;				/**< Measured time in nanoseconds */
+	uint64			allocs;			/**< Number of malloc(), calloc() and realloc() calls */
+	uint64			slab_allocs;	/**< Number of objects allocated from slab allocator */
+	struct timespec	start;			/**< Time of last b_bench_start() */
+	uint64			start_allocs;
+	uint64			start_slab_allocs;
+} VBench;
+
+/**
+ * Context of fake connection used by benchmarks of sending packets. Packets
+ * are queued in batch, that is never flushed, then no system call is used.
+ */
+typedef struct BConnCtx {
+	struct vContext		C;
+	struct VSession		session;
+	struct VPacket		s_packet;
+	struct VPacket		r_packet;
+	struct VPacketBatch	batch;
+} BConnCtx;
+
+/* Function running one benchmark with the number of operations given by
+ * count */
+typedef void (*VBenchFunc)(struct VBench *bench, const uint32 count);
+
+void b_bench_start(struct VBench *bench);
+void b_bench_stop(struct VBench *bench);
+
+/* b_hash_array.c */
+void b_hash_array_add(struct VBench *bench, const uint32 count);
+void b_hash_array_find(struct VBench *bench, const uint32 count);
+void b_hash_array_remove(struct VBench *bench, const uint32 count);
+
+/* b_queues.c */
+void b_out_queue_push_tail_shared(struct VBench *bench, const uint32 count);
+void b_out_queue_push_tail_unshared(struct VBench *bench, const uint32 count);
+void b_out_queue_pop_shared(struct VBench *bench, const uint32 count);
+void b_out_queue_pop_unshared(struct VBench *bench, const uint32 count);
+void b_in_queue_push(struct VBench *bench, const uint32 count);
+void b_in_queue_pop(struct VBench *bench, const uint32 count);
+
+/* b_commands.c */
+void b_cmd_pack_node(struct VBench *bench, const uint32 count);
+void b_cmd_pack_taggroup(struct VBench *bench, const uint32 count);
+void b_cmd_pack_tag(struct VBench *bench, const uint32 count);
+void b_cmd_pack_layer(struct VBench *bench, const uint32 count);
+void b_cmd_unpack_node(struct VBench *bench, const uint32 count);
+void b_cmd_unpack_taggroup(struct VBench *bench, const uint32 count);
+void b_cmd_unpack_tag(struct VBench *bench, const uint32 count);
+void b_cmd_unpack_layer(struct VBench *bench, const uint32 count);
+
+/* b_history.c */
+struct BConnCtx *b_conn_ctx_create(const uint8 cmd_cmpr);
+void b_conn_ctx_destroy(struct BConnCtx *ctx);
+void b_packet_history(struct VBench *bench, const uint32 count);
+
+/* b_resend.c */
+void b_send_packet_addr_share(struct VBench *bench, const uint32 count);
+void b_send_packet_deflate(struct VBench *bench, const uint32 count);
+
+#endif /* B_BENCH_H_ */
@@ -0,0 +1,22 @@
+#!/bin/sh
+#
+# Build and install legacy MongoDB C Driver (mongo.h, libmongoc) used by
+# Verse server compiled with MongoDB support.
+
+set -e
+
+MONGO_C_DRIVER_VERSION="${MONGO_C_DRIVER_VERSION:-v0.8.1}"
+MONGO_C_DRIVER_DIR="${TMPDIR:-/tmp}/mongo-c-driver-legacy"
+
+SUDO=""
+if [ "$(id -u)" -ne 0 ]; then
+	SUDO="sudo"
+fi
+
+rm -rf "${MONGO_C_DRIVER_DIR}"
+git clone --depth 1 -b "${MONGO_C_DRIVER_VERSION}" \
+	https://github.com/mongodb/mongo-c-driver-legacy.git "${MONGO_C_DRIVER_DIR}"
+
+make -C "${MONGO_C_DRIVER_DIR}"
+${SUDO} make -C "${MONGO_C_DRIVER_DIR}" install
+${SUDO} ldconfig
@@ -0,0 +1,76 @@
+#!/bin/sh
+#
+# Smoke test of Verse server compiled with MongoDB support. MongoDB server
+# has to run at MONGODB_HOST (default: localhost).
+#
+# The first server saves node created by verse_client to MongoDB. The second
+# server restores this node from MongoDB and loads its tag groups and layers,
+# when verse_client uses it again.
+#
+# Usage: mongodb_smoke.sh <build_dir>
+
+set -e
+
+BUILD_DIR="$(cd "${1:-build}" && pwd)"
+SOURCE_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+MONGODB_HOST="${MONGODB_HOST:-localhost}"
+WORK_DIR="$(mktemp -d)"
+CONFIG="${WORK_DIR}/server.ini"
+
+cd "${SOURCE_DIR}"
+
+cat > "${CONFIG}" <<END
+[Global]
+TCP_port = 12344 ;
+
+[Users]
+Method = file ;
+FileType = csv ;
+File = "${SOURCE_DIR}/config/users.csv" ;
+
+[MongoDB]
+ServerHostname = "${MONGODB_HOST}" ;
+ServerPort = 27017 ;
+DatabaseName = "verse_smoke_test_$$" ;
+SaveInterval = 1 ;
+EvictTime = 0 ;
+END
+
+# Run verse server and verse client, then stop verse server
+run() {
+	"${BUILD_DIR}/bin/verse_server" -c "${CONFIG}" -D debug \
+		> "${WORK_DIR}/server$1.log" 2>&1 &
+	server_pid=$!
+	sleep 1
+	timeout 10 "${BUILD_DIR}/bin/verse_client" -u a -p a -s none localhost \
+		> "${WORK_DIR}/client$1.log" 2>&1 || true
+	sleep 2
+	kill -INT ${server_pid} 2> /dev/null || true
+	wait ${server_pid} || true
+}
+
+# Print server log and fail, when pattern is not found in the log
+expect() {
+	if ! grep -q "$2" "${WORK_DIR}/server$1.log"; then
+		cat "${WORK_DIR}/server$1.log"
+		echo "FAILED: '$2' not found in log of server $1"
+		exit 1
+	fi
+}
+
+run 1
+expect 1 "Connection to MongoDB server .* succeeded"
+expect 1 "Data saved to MongoDB"
+
+run 2
+expect 2 "Data restored from MongoDB"
+expect 2 "Data of node: .* loaded from MongoDB"
+
+if grep -q "MongoDB.*failed\|Unable to load data of node" "${WORK_DIR}"/server*.log; then
+	cat "${WORK_DIR}"/server*.log
+	echo "FAILED: errors of MongoDB in server log"
+	exit 1
+fi
+
+rm -rf "${WORK_DIR}"
+echo "MongoDB smoke test passed"
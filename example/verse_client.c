@@ -247,7 +247,7 @@ static void cb_receive_layer_create(const uint8_t session_id,
 		my_test_layer_id = layer_id;
 
 		/* Test of subscribing to layer */
-		vrs_send_layer_subscribe(session_id, my_test_node_prio, node_id, layer_id, 0, 0);
+		vrs_send_layer_subscribe(session_id, my_test_node_prio, node_id, layer_id, 0, 0, 0);
 
 		/* Test of creating child layer */
 		vrs_send_layer_create(session_id, my_test_node_prio,
@@ -475,7 +475,7 @@ static void cb_receive_taggroup_create(const uint8_t session_id,
 		vrs_send_taggroup_create(session_id, my_test_node_prio, node_id, custom_type);
 
 		/* Test of subscribing to tag group */
-		vrs_send_taggroup_subscribe(session_id, my_test_node_prio, node_id, taggroup_id, 0, 0);
+		vrs_send_taggroup_subscribe(session_id, my_test_node_prio, node_id, taggroup_id, 0, 0, 0);
 
 		/* Test of uint8 tag create */
 		vrs_send_tag_create(session_id, my_test_node_prio, node_id,
@@ -517,7 +517,7 @@ static void cb_receive_node_create(const uint8_t session_id,
 	} else if(node_id == VRS_USERS_PARENT_NODE_ID) {
 		printf("\tParent of User Nodes\n");
 		/* Example of node subscribe command */
-		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0);
+		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0, 0);
 	} else if(node_id == VRS_SCENE_PARENT_NODE_ID) {
 		printf("\tParent of Scene Nodes\n");
 		/* Example of node un-subscribe command */
@@ -535,7 +535,7 @@ static void cb_receive_node_create(const uint8_t session_id,
 		/* Client should subscribe to his avarat node to be able receive information
 		 * about nodes, that was created by this client */
 		printf("\tMy Avatar Node\n");
-		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0);
+		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0, 0);
 
 		/* Test of sending wrong node_perm command (client doesn't own this node) */
 		vrs_send_node_perm(session_id, VRS_DEFAULT_PRIORITY, node_id, my_user_id, VRS_PERM_NODE_READ | VRS_PERM_NODE_WRITE);
@@ -566,7 +566,7 @@ static void cb_receive_node_create(const uint8_t session_id,
 		my_test_node_id = node_id;
 
 		/* Test of subscribing to my own node */
-		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0);
+		vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, node_id, 0, 0, 0);
 
 		/* Test of changing priority of my node */
 		vrs_send_node_prio(session_id, VRS_DEFAULT_PRIORITY, node_id, my_test_node_prio);
@@ -733,10 +733,10 @@ static void cb_receive_connect_accept(const uint8_t session_id,
 	 * to the root node of the node tree. Id of root node is still 0. This
 	 * function is called with level 1. It means, that this client will be
 	 * subscribed to the root node and its child nodes (1, 2, 3) */
-	vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, 0, 0, 0);
+	vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, 0, 0, 0, 0);
 
 	/* Check if server allow double subscribe? */
-	vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, 1, 0, 0);
+	vrs_send_node_subscribe(session_id, VRS_DEFAULT_PRIORITY, 1, 0, 0, 0);
 
 	/* Try to create new node */
 	vrs_send_node_create(session_id, VRS_DEFAULT_PRIORITY, MY_TEST_NODE_CT);
@@ -910,7 +910,7 @@ static void print_help(char *prog_name)
 	printf("   -p  --password    PASSWORD   Password used for login at Verse server.\n");
 	printf("   -t  --protocol    [udp|tcp]  Transport protocol used for data exchange (default=udp).\n");
 	printf("   -s  --security    [none|tls] Security of data exchange (default=tls).\n");
-	printf("   -c  --compression [none|addrshare]\n");
+	printf("   -c  --compression [none|addrshare|deflate]\n");
 	printf("                                Compression used for data exchange (default=addshare)\n");
 	printf("   -D  --debug-level [none|info|error|warning|debug]\n");
 	printf("                                Use debug level (default=none).\n\n");
@@ -950,7 +950,7 @@ int main(int argc, char *argv[])
 	/* When client was started with some arguments */
 	if(argc > 1) {
 		/* Parse all options */
-		while( (opt = getopt_long(argc, argv, "hu:p:s:t:D:", long_options, &option_index)) != -1) {
+		while( (opt = getopt_long(argc, argv, "hu:p:s:t:c:D:", long_options, &option_index)) != -1) {
 			switch(opt) {
 				case 's':
 					if(strcmp(optarg, "none") == 0) {
@@ -987,10 +987,13 @@ int main(int argc, char *argv[])
 				case 'c':
 					if(strcmp(optarg, "none") == 0) {
 						flags |= VRS_CMD_CMPR_NONE;
-						flags &= ~VRS_CMD_CMPR_ADDR_SHARE;
+						flags &= ~(VRS_CMD_CMPR_ADDR_SHARE | VRS_CMD_CMPR_DEFLATE);
 					} else if(strcmp(optarg, "addrshare") == 0) {
-						flags &= ~VRS_CMD_CMPR_NONE;
+						flags &= ~(VRS_CMD_CMPR_NONE | VRS_CMD_CMPR_DEFLATE);
 						flags |= VRS_CMD_CMPR_ADDR_SHARE;
+					} else if(strcmp(optarg, "deflate") == 0) {
+						flags &= ~(VRS_CMD_CMPR_NONE | VRS_CMD_CMPR_ADDR_SHARE);
+						flags |= VRS_CMD_CMPR_DEFLATE;
 					} else {
 						printf("ERROR: unsupported command compression\n\n");
 						print_help(argv[0]);
@@ -0,0 +1,66 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#ifndef V_CMD_CODEC_H_
+#define V_CMD_CODEC_H_
+
+#include "verse_types.h"
+
+#include "v_commands.h"
+
+/**
+ * Specialised function packing items of one command. Items with index lower
+ * than first_item are not packed (they are shared with previous command).
+ * The function returns number of packed bytes.
+ */
+typedef uint16 (*VCmdPackFunc)(char *buffer,
+		const struct Generic_Cmd *cmd,
+		const int first_item);
+
+/**
+ * Specialised function unpacking items of one command with fixed length.
+ * Items with index lower than first_item are not unpacked. The function
+ * returns number of unpacked bytes.
+ */
+typedef uint32 (*VCmdUnpackFunc)(const char *buffer,
+		struct Generic_Cmd *cmd,
+		const int first_item);
+
+/* Tables of functions generated from cmd_struct[] by v_cmd_gen. Items of
+ * commands without specialised function are NULL. */
+extern const VCmdPackFunc v_cmd_pack_funcs[MAX_CMD_ID+1];
+extern const VCmdUnpackFunc v_cmd_unpack_funcs[MAX_CMD_ID+1];
+
+#endif /* V_CMD_CODEC_H_ */
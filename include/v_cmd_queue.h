@@ -51,6 +51,10 @@ typedef struct VCommandQueue {
 } VCommandQueue;
 
 struct VCommandQueue *v_cmd_queue_create(uint8 id, uint8 copy_bucket, uint8 fake_cmds);
+struct VCommandQueue *v_cmd_queue_get(struct VCommandQueue **cmd_queues,
+		uint8 id,
+		uint8 copy_bucket,
+		uint8 fake_cmds);
 void v_cmd_queue_destroy(struct VCommandQueue *cmd_queue);
 
 #endif /* V_CMD_QUEUE_H_ */
@@ -175,6 +175,42 @@
 #define CMD_LAYER_SET_VEC3_REAL64	159
 #define CMD_LAYER_SET_VEC4_REAL64	160
 
+/* Layer Set Delta (values are XORed with baseline value known by client) */
+#define CMD_LAYER_SET_DELTA_UINT8	161
+#define CMD_LAYER_SET_DELTA_VEC2_UINT8	162
+#define CMD_LAYER_SET_DELTA_VEC3_UINT8	163
+#define CMD_LAYER_SET_DELTA_VEC4_UINT8	164
+
+#define CMD_LAYER_SET_DELTA_UINT16	165
+#define CMD_LAYER_SET_DELTA_VEC2_UINT16	166
+#define CMD_LAYER_SET_DELTA_VEC3_UINT16	167
+#define CMD_LAYER_SET_DELTA_VEC4_UINT16	168
+
+#define CMD_LAYER_SET_DELTA_UINT32	169
+#define CMD_LAYER_SET_DELTA_VEC2_UINT32	170
+#define CMD_LAYER_SET_DELTA_VEC3_UINT32	171
+#define CMD_LAYER_SET_DELTA_VEC4_UINT32	172
+
+#define CMD_LAYER_SET_DELTA_UINT64	173
+#define CMD_LAYER_SET_DELTA_VEC2_UINT64	174
+#define CMD_LAYER_SET_DELTA_VEC3_UINT64	175
+#define CMD_LAYER_SET_DELTA_VEC4_UINT64	176
+
+#define CMD_LAYER_SET_DELTA_REAL16	177
+#define CMD_LAYER_SET_DELTA_VEC2_REAL16	178
+#define CMD_LAYER_SET_DELTA_VEC3_REAL16	179
+#define CMD_LAYER_SET_DELTA_VEC4_REAL16	180
+
+#define CMD_LAYER_SET_DELTA_REAL32	181
+#define CMD_LAYER_SET_DELTA_VEC2_REAL32	182
+#define CMD_LAYER_SET_DELTA_VEC3_REAL32	183
+#define CMD_LAYER_SET_DELTA_VEC4_REAL32	184
+
+#define CMD_LAYER_SET_DELTA_REAL64	185
+#define CMD_LAYER_SET_DELTA_VEC2_REAL64	186
+#define CMD_LAYER_SET_DELTA_VEC3_REAL64	187
+#define CMD_LAYER_SET_DELTA_VEC4_REAL64	188
+
 /* Maximal theoretical number of command ID */
 #define MIN_CMD_ID					32
 #define MAX_CMD_ID					255
@@ -274,7 +310,36 @@ typedef struct Generic_Cmd {
 #define REAL64(data) *(real64*)&(data)
 #define PTR(data)    *(void**)&(data)
 
+/* Maximal size of regular command, that could be decoded from view of
+ * received commands to the buffer on the stack */
+#define CMD_VIEW_MAX_CMD_SIZE	64
+
+/* Minimal count of commands compressed to one command in received packet,
+ * when view is created instead of allocating all commands */
+#define CMD_VIEW_MIN_COUNT		8
+
+/**
+ * Receive buffer containing node commands of one received packet. Views
+ * of commands (Cmd_View_Cmd) point into this buffer and the buffer is freed,
+ * when the last reference is dropped.
+ */
+typedef struct VCmdBuffer {
+	uint32			refs;		/* Number of references at the buffer */
+	uint16			size;		/* Size of data in the buffer */
+	char			data[1];	/* Received data */
+} VCmdBuffer;
+
+/**
+ * Buffer on the stack for one command decoded from view
+ */
+typedef union VCmdViewBuf {
+	struct Generic_Cmd	cmd;
+	uint64				align;
+	uint8				data[CMD_VIEW_MAX_CMD_SIZE];
+} VCmdViewBuf;
+
 struct VInQueue;
+struct Cmd_View_Cmd;
 
 uint16 v_cmd_unpack_len(const char *buffer,
 		uint16 *length,
@@ -283,6 +348,8 @@ uint16 v_cmd_pack_len(char *buffer, const uint16 length);
 
 void v_cmd_print(const unsigned char level,
 		const struct Generic_Cmd *cmd);
+struct Generic_Cmd *v_cmd_alloc(const uint8 cmd_id);
+struct Generic_Cmd *v_cmd_share(struct Generic_Cmd *cmd);
 void v_cmd_destroy(struct Generic_Cmd **cmd);
 int v_cmd_struct_size(const struct Generic_Cmd *cmd);
 int v_cmd_size(const struct Generic_Cmd *cmd);
@@ -305,6 +372,13 @@ uint16 v_cmds_len(struct Generic_Cmd *cmd,
 		uint8 share,
 		uint16 len);
 struct VCommandQueue *v_node_cmd_queue_create(uint8 id, uint8 copy_bucket);
+
+struct VCmdBuffer *v_cmd_buffer_create(const char *data, uint16 size);
+struct VCmdBuffer *v_cmd_buffer_ref(struct VCmdBuffer *cmd_buffer);
+void v_cmd_buffer_release(struct VCmdBuffer **cmd_buffer);
+int v_cmd_view_get(const struct Cmd_View_Cmd *view,
+		uint16 index,
+		struct Generic_Cmd *cmd);
 struct Generic_Cmd *v_cmd_fake_ack(struct Generic_Cmd *cmd);
 
 #endif /* V_COMMANDS_H_ */
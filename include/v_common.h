@@ -49,4 +49,8 @@ void v_init_log_file(FILE *fd);
 void v_print_log(const uint8 level, const char *format, ...);
 void v_print_log_simple(const uint8 level, const char *format, ...);
 
+real16 v_real32_to_real16(const real32 value);
+real16 v_real64_to_real16(const real64 value);
+real32 v_real16_to_real32(const real16 value);
+
 #endif /* V_COMMON_H */
@@ -0,0 +1,61 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+
+#ifndef V_COMPRESS_H_
+#define V_COMPRESS_H_
+
+#include "verse_types.h"
+
+/* Node commands are not compressed, when they are shorter then this
+ * threshold, because it would not help */
+#define CMPR_MIN_PAYLOAD_SIZE	32
+/* Level of deflate compression (1 is the fastest, 9 is the best) */
+#define CMPR_DEFLATE_LEVEL		6
+/* The first byte of compressed node commands. Receiver unpacks system
+ * commands until it finds byte bigger then MAX_SYS_CMD_ID and the first byte
+ * of deflate stream could be smaller. */
+#define CMPR_PAYLOAD_MARK		0xFF
+
+int v_compress_is_supported(const uint8 cmpr);
+uint16 v_compress_payload(const uint8 cmpr,
+		char *buffer,
+		const uint16 len);
+const char *v_decompress_payload(const uint8 cmpr,
+		const char *buffer,
+		const uint16 len,
+		uint16 *data_len);
+
+#endif /* V_COMPRESS_H_ */
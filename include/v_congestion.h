@@ -0,0 +1,107 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#if !defined V_CONGESTION_H
+#define V_CONGESTION_H
+
+#include <sys/time.h>
+
+#include "verse_types.h"
+
+/* Algorithms used for congestion control method CC_TCP_LIKE. The algorithm
+ * is only local decision of sender and it is not negotiated with peer. */
+#define CC_ALG_RESERVED		0
+#define CC_ALG_NEWRENO		1
+#define CC_ALG_CUBIC		2
+
+#define DEFAULT_CC_ALG		CC_ALG_CUBIC
+
+/* Initial congestion window (in count of MTU) */
+#define CC_INIT_CWIN		10
+/* Minimal congestion window (in count of MTU) */
+#define CC_MIN_CWIN			2
+
+/* Retransmission timeout (values are in microseconds) */
+#define CC_INIT_RTO			1000000
+#define CC_MIN_RTO			200000
+#define CC_MAX_RTO			60000000
+
+/* Constants of CUBIC (multiplied by 1000) */
+#define CUBIC_C				400
+#define CUBIC_BETA			700
+
+struct VDgramConn;
+
+/**
+ * State of congestion control at one datagram connection
+ */
+typedef struct VCCState {
+	uint32			ssthresh;		/* Slow start threshold */
+	uint32			acked;			/* Acknowledged bytes not used for increasing cwin yet */
+	uint32			recover;		/* Last payload ID sent before loss was detected */
+	uint8			in_recovery;	/* Loss was detected and ID of recover is valid */
+	struct timeval	tv_rto;			/* Time of last expiration of RTO */
+	/* CUBIC */
+	uint32			w_max;			/* Window before last reduction */
+	uint32			w_est;			/* Estimation of window of standard TCP */
+	uint32			k;				/* Time to reach w_max again [us] */
+	uint64			epoch_start;	/* Time, when current congestion avoidance began [us] */
+} VCCState;
+
+/**
+ * Congestion control algorithm. Callback functions are called, when
+ * acknowledgment was received, when loss was detected and when retransmission
+ * timeout expired.
+ */
+typedef struct VCCAlgorithm {
+	uint8			id;				/* ID of algorithm */
+	const char		*name;			/* Name of algorithm used in configuration */
+	void			(*init)(struct VDgramConn *dgram_conn);
+	void			(*ack)(struct VDgramConn *dgram_conn, uint32 acked_size, const struct timeval *tv);
+	void			(*loss)(struct VDgramConn *dgram_conn, const struct timeval *tv);
+	void			(*timeout)(struct VDgramConn *dgram_conn, const struct timeval *tv);
+} VCCAlgorithm;
+
+const struct VCCAlgorithm *v_cc_find_algorithm(const char *name);
+const struct VCCAlgorithm *v_cc_get_algorithm(uint8 id);
+
+void v_cc_init(struct VDgramConn *dgram_conn, uint8 alg_id);
+void v_cc_rtt_sample(struct VDgramConn *dgram_conn, uint32 rtt);
+void v_cc_ack(struct VDgramConn *dgram_conn, uint32 acked_size, const struct timeval *tv);
+void v_cc_nak(struct VDgramConn *dgram_conn, uint32 nak_id, const struct timeval *tv);
+int v_cc_check_timeout(struct VDgramConn *dgram_conn, const struct timeval *tv);
+uint32 v_cc_send_window(struct VDgramConn *dgram_conn);
+
+#endif /* V_CONGESTION_H */
@@ -43,6 +43,7 @@
 
 #include "v_network.h"
 #include "v_history.h"
+#include "v_congestion.h"
 #include "v_context.h"
 
 /* Client states (UDP) */
@@ -132,7 +133,11 @@ typedef struct VDgramConn {
 	unsigned char			fc_meth;			/* Negotiated Flow Control method */
 	unsigned char			cc_meth;			/* Negotiated Congestion Control method */
 	unsigned int			srtt;				/* Smoothed Round-Trip Time */
+	unsigned int			rttvar;				/* Round-Trip Time variation */
+	unsigned int			rto;				/* Retransmission timeout */
 	unsigned int			cwin;				/* Congestion Control Window */
+	unsigned char			cc_alg;				/* Algorithm used for TCP like Congestion Control */
+	struct VCCState			cc_state;			/* State of Congestion Control algorithm */
 	unsigned int			rwin_host;			/* Flow Control Window of host (my) */
 	unsigned int			rwin_peer;			/* Flow Control Window of peer */
 	unsigned int			sent_size;			/* Size of data that were sent and were not acknowledged */
@@ -0,0 +1,96 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#ifndef V_DELTA_H_
+#define V_DELTA_H_
+
+#include "verse_types.h"
+#include "v_list.h"
+
+/* Number of values sent to one client, that could be used as base value of
+ * delta (server keeps only these values for each item) */
+#define DELTA_HISTORY_LEN		4
+/* Number of decoded values kept by client for each item. It is bigger than
+ * history of server, because base value of delta could be reordered with
+ * newer values */
+#define DELTA_RECV_HISTORY_LEN	(2*DELTA_HISTORY_LEN)
+/* Maximal distance between sequence number of delta and its base value
+ * (only 16 bits of sequence numbers are sent) */
+#define DELTA_MAX_DISTANCE		0x7FFF
+
+/**
+ * Decoded values of one layer item received as delta
+ */
+typedef struct VDeltaRecvItem {
+	/* Key */
+	uint32			node_id;
+	uint32			item_id;
+	uint16			layer_id;
+	/* Values */
+	uint16			value_size;		/**< Size of one value in bytes */
+	uint32			newest_seq;		/**< Sequence number of newest delivered value */
+	uint32			count;			/**< Number of stored values */
+	uint32			seqs[DELTA_RECV_HISTORY_LEN];	/**< Sequence numbers of stored values */
+	uint8			data[1];		/**< Stored values (seqs[i] is value at data[i*value_size]) */
+} VDeltaRecvItem;
+
+#define DELTA_RECV_KEY_SIZE		(2*sizeof(uint32) + sizeof(uint16))
+
+/**
+ * Values received as delta in one session (used only by client)
+ */
+typedef struct VDeltaRecv {
+	struct VHashArrayBase	items;		/**< Items stored by node, layer and item ID */
+	uint32					last_seq;	/**< The newest received sequence number */
+} VDeltaRecv;
+
+uint8 v_delta_type_size(const uint8 data_type);
+
+struct VDeltaRecv *v_delta_recv_create(void);
+void v_delta_recv_destroy(struct VDeltaRecv **delta_recv);
+int v_delta_recv_value(struct VDeltaRecv *delta_recv,
+		const uint32 node_id,
+		const uint16 layer_id,
+		const uint32 item_id,
+		const uint16 value_size,
+		const uint16 seq,
+		const uint16 base,
+		const void *delta,
+		void *value);
+void v_delta_recv_remove(struct VDeltaRecv *delta_recv,
+		const uint32 node_id,
+		const uint16 layer_id);
+
+#endif /* V_DELTA_H_ */
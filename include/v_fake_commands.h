@@ -58,6 +58,8 @@
 #define FAKE_CMD_TAG_DESTROY_ACK		21
 #define FAKE_CMD_LAYER_CREATE_ACK		22
 #define FAKE_CMD_LAYER_DESTROY_ACK		23
+#define FAKE_CMD_CMD_VIEW				24
+#define FAKE_CMD_LAYER_SET_ACK			25
 
 /* -------------- Fake Client Commands -------------- */
 
@@ -187,6 +189,30 @@ typedef struct Layer_Destroy_Ack_Cmd {
 	uint16			layer_id;
 } Layer_Destroy_Ack_Cmd;
 
+typedef struct Layer_Set_Ack_Cmd {
+	uint8			id;
+	uint32			node_id;
+	uint16			layer_id;
+	uint32			item_id;
+	uint16			seq;		/* Sequence number of acknowledged delta */
+} Layer_Set_Ack_Cmd;
+
+/**
+ * View of several commands with the same ID compressed in one received
+ * packet. Commands are not decoded, when packet is received. Commands are
+ * decoded from the receive buffer with v_cmd_view_get(), when they are
+ * handled.
+ */
+typedef struct Cmd_View_Cmd {
+	uint8				id;
+	uint8				cmd_id;			/* ID of viewed commands */
+	uint8				share;			/* Size of address shared by all commands */
+	uint8				skip_items;		/* Count of items in shared address */
+	uint16				count;			/* Count of commands in view */
+	uint16				offset;			/* Offset of the first command in buffer */
+	struct VCmdBuffer	*buffer;		/* Receive buffer with commands */
+} Cmd_View_Cmd;
+
 struct Generic_Cmd;
 
 void v_fake_cmd_print(const unsigned char level,
@@ -296,4 +322,24 @@ struct Generic_Cmd *v_fake_layer_destroy_ack_create(uint32 node_id,
 		uint16 layer_id);
 void v_fake_layer_destroy_ack_destroy(struct Generic_Cmd **cmd);
 
+/* Layer_Set_Ack */
+void v_fake_layer_set_ack_print(const unsigned char level,
+		const struct Generic_Cmd *cmd);
+struct Generic_Cmd *v_fake_layer_set_ack_create(uint32 node_id,
+		uint16 layer_id,
+		uint32 item_id,
+		uint16 seq);
+void v_fake_layer_set_ack_destroy(struct Generic_Cmd **cmd);
+
+/* Cmd_View */
+void v_fake_cmd_view_print(const unsigned char level,
+		const struct Generic_Cmd *cmd);
+struct Generic_Cmd *v_fake_cmd_view_create(struct VCmdBuffer *buffer,
+		uint16 offset,
+		uint8 cmd_id,
+		uint8 share,
+		uint8 skip_items,
+		uint16 count);
+void v_fake_cmd_view_destroy(struct Generic_Cmd **cmd);
+
 #endif /* V_FAKE_COMMANDS_H_ */
@@ -44,38 +44,48 @@
 
 #define INIT_ACK_NAK_HISTORY_SIZE	2
 
+/* Initial length of ring buffer of sent packets (it has to be power of 2) */
+#define INIT_PACKET_HISTORY_LEN		64
+/* Initial length of array of commands in one sent packet */
+#define INIT_SENT_CMDS_LEN			16
+
 /**
  * This structure does not contain own command, but it only contain pointer
  * at command in the queue.
  */
 typedef struct VSent_Command {
-	struct VSent_Command	*prev, *next;	/* Item of linked list */
 	struct VBucket			*vbucket;		/* Pointer at item of command data in bucket list */
 	uint8					id;				/* ID of command */
 	uint8					prio;			/* The priority that was used for sending this command */
 } VSent_Command;
 
 /**
- * Structure of sent packet. This structure contains the linked list of
+ * Structure of sent packet. This structure contains the array of
  * pointers at commands. Commands are stored in queue. If any command with
  * the same address is sent to the peer in packet with higher packet ID,
  * then content of current command is obsolete and pointer at command is set
  * as NULL. Then it would be necessary to re-send only not NULL commands.
  */
 typedef struct VSent_Packet {
-	struct VSent_Packet		*prev, *next;	/* Item of linked list */
 	uint32					id;				/* ID of packet */
-	struct VListBase		cmds;			/* Linked list of pointers at commands */
+	uint8					used;			/* Slot in ring buffer contains packet */
+	struct VSent_Command	*cmds;			/* Array of pointers at commands (it is kept, when slot is reused) */
+	uint16					cmd_count;		/* Count of commands in the array */
+	uint16					cmd_length;		/* Length of allocated array */
+	uint16					size;			/* Size of commands added to sent_size of connection */
 	struct timeval			tv;				/* The time, when packet was sent */
 } VSent_Packet;
 
 /**
- * Structure containing history of sent packets. The packets contains linked
- * list of sent commands. The command lists contains sent hashed commands.
+ * Structure containing history of sent packets. The packets contains array
+ * of sent commands. The command lists contains sent hashed commands.
  */
 typedef struct VPacket_History {
-	/* Linked list of sent packets */
-	struct VListBase		packets;
+	/* Ring buffer of sent packets indexed by ID of packet */
+	struct VSent_Packet		*packets;
+	uint32					length;			/* Length of ring buffer (power of 2) */
+	uint32					first_id;		/* ID of the oldest packet in history */
+	uint32					count;			/* Count of packets in history */
 	/* Own sent commands are stored in separated structure. Each type of command
 	 * has own slots */
 	struct VCommandQueue	*cmd_hist[MAX_CMD_ID+1];
@@ -42,6 +42,7 @@
 
 #include "v_commands.h"
 #include "v_list.h"
+#include "v_ready_ring.h"
 
 /* Maximal size of incoming queue is 1MB */
 #define IN_QUEUE_DEFAULT_MAX_SIZE 1048576
@@ -66,6 +67,10 @@ typedef struct VInQueue {
 	uint32					size;		/**< Size of stored commands in bytes */
 	uint32					max_size;	/**< Maximal allowed size of commands stored in this queue */
 	uint32					count;		/**< Count of stored commands */
+	struct VReadyRing		*ready_ring;	/**< Ring notified, when queue becomes not empty (optional) */
+	void					*ready_item;	/**< Item added to the ready_ring (e.g. session) */
+	uint8					ready;		/**< Queue was added to the ready_ring and not drained yet */
+	uint8					cmd_views;	/**< Received commands could be stored as views of receive buffer */
 } VInQueue;
 
 uint32 v_in_queue_size(struct VInQueue *in_queue);
@@ -73,6 +78,9 @@ uint32 v_in_queue_cmd_count(struct VInQueue *in_queue);
 struct Generic_Cmd *v_in_queue_pop(struct VInQueue *in_queue);
 int v_in_queue_push(struct VInQueue *in_queue, struct Generic_Cmd *cmd);
 int v_in_queue_init(struct VInQueue *in_queue, int max_size);
+void v_in_queue_set_ready_ring(struct VInQueue *in_queue,
+		struct VReadyRing *ready_ring,
+		void *ready_item);
 struct VInQueue *v_in_queue_create(void);
 void v_in_queue_destroy(struct VInQueue **in_queue);
 
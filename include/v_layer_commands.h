@@ -41,6 +41,10 @@
 
 #define VRS_RESERVED_LAYER_ID		0xFFFF
 
+/* Flag sent in Flags of layer subscribe command. It requests values of
+ * layer items as delta (Layer_Set_Delta) */
+#define LAYER_SUBSCRIBE_DELTA		0x01
+
 struct Generic_Cmd *v_layer_create_create(const uint32 node_id,
 		const uint16 parent_layer_id,
 		const uint16 layer_id,
@@ -54,12 +58,17 @@ struct Generic_Cmd *v_layer_destroy_create(const uint32 node_id,
 struct Generic_Cmd *v_layer_subscribe_create(const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32);
+		const uint32 crc32,
+		const uint8 precision,
+		const uint8 flags,
+		const uint32 epoch);
 
 struct Generic_Cmd *v_layer_unsubscribe_create(const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32);
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch);
 
 struct Generic_Cmd *v_layer_set_value_create(const uint32 node_id,
 		const uint16 layer_id,
@@ -68,6 +77,15 @@ struct Generic_Cmd *v_layer_set_value_create(const uint32 node_id,
 		const uint8 count,
 		const void *value);
 
+struct Generic_Cmd *v_layer_set_delta_create(const uint32 node_id,
+		const uint16 layer_id,
+		const uint32 item_id,
+		const uint8 data_type,
+		const uint8 count,
+		const uint16 seq,
+		const uint16 base,
+		const void *value);
+
 struct Generic_Cmd *v_layer_unset_value_create(const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 item_id);
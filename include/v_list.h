@@ -46,10 +46,22 @@
 
 #define INIT_ARRAY_LEN		1
 
+/* Flags HASH_MOD_256 and HASH_MOD_65536 are only hints about expected number
+ * of items now. Array of slots grows according number of items. */
 #define HASH_MOD_256		1
 #define HASH_MOD_65536		2
 #define	HASH_COPY_BUCKET	4
 
+/* Minimal length of array of slots (it has to be power of 2) */
+#define HASH_MIN_LENGTH		8
+/* Maximal number of items in small hashed linked list. Small hashed linked
+ * list doesn't allocate array of slots and items are searched in the linked
+ * list */
+#define HASH_SMALL_COUNT	8
+/* Number of items moved from old array of slots to the new one in one call
+ * of add/remove function during resizing */
+#define HASH_MIGRATE_STEP	16
+
 typedef struct VItem {
 	struct VItem	*prev, *next;
 } VItem;
@@ -77,20 +89,27 @@ typedef struct VBucket {
 	struct VBucket		*prev, *next;
 	void				*data;
 	void				*ptr;
+	/* Ring of buckets with the same key (only one of them is in slot) */
+	struct VBucket		*key_prev, *key_next;
 } VBucket;
 
-typedef struct VBucketP {
-	struct VBucket		*vbucket;	/* Pointer at item in linked list */
-	struct VBucketP		*next;		/* Pointer at next item, when there is collision of hash function */
-} VBucketP;
+typedef struct VHashSlot {
+	uint32				hash;		/* Cached hash of the key */
+	struct VBucket		*vbucket;	/* Pointer at one bucket of ring with the key (NULL for empty slot) */
+} VHashSlot;
 
 typedef struct VHashArrayBase {
-	struct VListBase	lb;
-	struct VBucketP		*buckets;	/* Array of buckets */
-	uint32				length;		/* Length of the array of buckets (2^8 or 2^16)*/
+	struct VListBase	lb;			/* Linked list of buckets in order of adding */
+	struct VHashSlot	*slots;		/* Array of slots (open addressing, linear probing, NULL for small list) */
+	uint32				length;		/* Length of the array of slots (power of 2) */
 	uint32				count;		/* Number of items in the linked list */
-	/* Pointer at hash function returning pointer at item in linked list */
-	int32				(*hash_func)(struct VHashArrayBase *hash_array, void *item);
+	uint32				key_count;	/* Number of different keys (used slots) */
+	/* Incremental resizing: items are moved from the old array of slots in
+	 * small steps to avoid long pauses, when big array grows */
+	struct VHashSlot	*old_slots;	/* Old array of slots (NULL, when table is not resized) */
+	uint32				old_length;	/* Length of the old array of slots */
+	struct VBucket		*migrate_next;	/* Next bucket moved to new array of slots */
+	struct VBucket		*migrate_last;	/* Last bucket moved to new array of slots */
 	uint8				key_offset;	/* Offset of key from the begining of the key */
 	uint8				key_size;	/* Size of key in bytes */
 	pthread_mutex_t		mutex;
@@ -123,6 +142,8 @@ struct VBucket *v_hash_array_find_item(struct VHashArrayBase *hash_array,
 		void *item);
 int v_hash_array_remove_item(struct VHashArrayBase *hash_array,
 		void *item);
+int v_hash_array_remove_bucket(struct VHashArrayBase *hash_array,
+		struct VBucket *vbucket);
 struct VBucket *v_hash_array_add_item(struct VHashArrayBase *hash_array,
 		void *item,
 		uint16 item_size);
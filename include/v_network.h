@@ -54,8 +54,8 @@
 #define ANK_FLAG	1 << 5
 #define SYN_FLAG	1 << 4
 #define FIN_FLAG	1 << 3
+#define CMP_FLAG	1 << 2	/* Node commands in payload are compressed */
 /* Reservation of flags */
-/* #define _FLAG	1 << 2 */
 /* #define _FLAG	1 << 1 */
 /* #define _FLAG	1 */
 
@@ -74,8 +74,11 @@
 #define MAX_NODE_COMMAND_COUNT		(MAX_PACKET_SIZE / (1+1))
 /* Default Ethernet MTU */
 #define DEFAULT_MTU					(1500 - 40 - 8)
-/* Define alpha value for computing SRTT */
-#define RTT_ALPHA					0.9
+/* Maximal number of packets sent or received with one system call */
+#define MAX_PACKET_BATCH_COUNT		32
+/* Maximal size of packet, that could be queued in batch; bigger packets
+ * are sent immediately */
+#define MAX_PACKET_BATCH_SIZE		1500
 
 /* It was not possible to send packet, because error of*/
 #define SEND_PACKET_ERROR			0
@@ -98,6 +101,7 @@
 
 #define SOCKET_CONNECTED			1
 #define SOCKET_SECURED				2
+#define SOCKET_SHARED				4	/* Socket is shared by many connections */
 
 /* How long should client or server wait for packet in select() function */
 #define TIMEOUT			1
@@ -112,11 +116,11 @@
  *
  *    0             0     1         1         2     2             3
  *    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
- *   +-------+-------+-+-+-+-+-+-----+---------------+---------------+
- *   |       |       |P|A|A|S|F|     |                               |
- * 0 |Version|  RES  |A|C|N|Y|I| RES |            Window Size        |
- *   |       |       |Y|K|K|N|N|     |                               |
- *   +-------+-------+-+-+-+-+-+-----+---------------+---------------+
+ *   +-------+-------+-+-+-+-+-+-+---+---------------+---------------+
+ *   |       |       |P|A|A|S|F|C|   |                               |
+ * 0 |Version|  RES  |A|C|N|Y|I|M|RES|            Window Size        |
+ *   |       |       |Y|K|K|N|N|P|   |                               |
+ *   +-------+-------+-+-+-+-+-+-+---+---------------+---------------+
  * 1 |                           Payload ID                          |
  *   +---------------+---------------+---------------+---------------+
  * 2 |                           ACK_NAK ID                          |
@@ -132,7 +136,7 @@
  *   .                                                               .
  *   |                                                               |
  *   +---------------+---------------+---------------+---------------+
- *   |                         Node Commands                         |
+ *   |           Node Commands (compressed, when CMP is set)         |
  *   .                                                               .
  *   .                                                               .
  *   |                                                               |
@@ -216,6 +220,25 @@ typedef struct VNetworkAddress {
 	unsigned short			port;		/* Port number */
 } VNetworkAddress;
 
+/* Packet queued in batch of outgoing packets */
+typedef struct VBatchPacket {
+	struct VNetworkAddress	peer_addr;	/* Destination (unused for connected socket) */
+	unsigned char			connected;	/* Packet is sent through connected socket */
+	unsigned short			buf_size;	/* Size of packet */
+	char					buf[MAX_PACKET_BATCH_SIZE];
+} VBatchPacket;
+
+/**
+ * Batch of outgoing packets. Packets sent by many connections to the same
+ * socket are queued here and they are sent with one system call, when batch
+ * is flushed.
+ */
+typedef struct VPacketBatch {
+	int						sockfd;		/* Socket used by queued packets */
+	unsigned int			count;		/* Number of queued packets */
+	struct VBatchPacket		packets[MAX_PACKET_BATCH_COUNT];
+} VPacketBatch;
+
 /* Context for sending and receiving packets */
 typedef struct IO_CTX {
 	struct VNetworkAddress	host_addr;		/* Address of application running this code */
@@ -225,6 +248,7 @@ typedef struct IO_CTX {
 	int						sockfd;			/* UDP/TCP/WebSocket socket */
 	unsigned char			flags;			/* Flags for sending and receiving context */
 	unsigned short			mtu;			/* MTU of connection discovered with PMTU */
+	struct VPacketBatch		*batch;			/* Batch of outgoing packets (NULL, when packets are sent immediately) */
 #ifdef WITH_OPENSSL
 	/* Security */
 	SSL						*ssl;
@@ -255,6 +279,15 @@ int v_tcp_write(struct IO_CTX *io_ctx, int *error_num);
 int v_receive_packet(struct IO_CTX *io_ctx, int *error_num);
 int v_send_packet(struct IO_CTX *io_ctx, int *error_num);
 
+void v_packet_batch_init(struct VPacketBatch *batch);
+int v_packet_batch_flush(struct VPacketBatch *batch);
+int v_receive_packet_batch(int sockfd,
+		char **bufs,
+		ssize_t *buf_sizes,
+		struct VNetworkAddress *peer_addrs,
+		unsigned int count,
+		int *error_num);
+
 int v_unpack_packet_header(const char *buffer, const unsigned short buffer_len, struct VPacket *vpacket);
 int v_pack_packet_header(const VPacket *vpacket, char *buffer);
 
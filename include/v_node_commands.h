@@ -52,11 +52,14 @@ struct Generic_Cmd *v_node_destroy_create(uint32 node_id);
 
 struct Generic_Cmd *v_node_subscribe_create(uint32 node_id,
 		uint32 version,
-		uint32 crc32);
+		uint32 crc32,
+		uint32 epoch);
 
 struct Generic_Cmd *v_node_unsubscribe_create(uint32 node_id,
 		const uint32 version,
-		const uint32 crc32);
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch);
 
 struct Generic_Cmd *v_node_prio_create(uint32 node_id, uint8 prio);
 
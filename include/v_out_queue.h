@@ -49,10 +49,19 @@
 /* Maximal priority of command and queue */
 #define MAX_PRIORITY		255
 
-/* TODO: negotiate this value that set up priorities of queues */
-#define REAL_PRIO_MUL		0.1
-#define MAX_REAL_PRIO_VAL	(VRS_DEFAULT_PRIORITY*1000)
-#define MIN_REAL_PRIO_VAL	1
+/* Weights of priority queues used by deficit round robin scheduler. Weight
+ * of default priority is OUT_QUEUE_DEFAULT_WEIGHT and weight of each higher
+ * (lower) priority is OUT_QUEUE_WEIGHT_STEP bigger (smaller). */
+#define OUT_QUEUE_DEFAULT_WEIGHT	VRS_DEFAULT_PRIORITY
+#define OUT_QUEUE_WEIGHT_STEP		0.1
+#define OUT_QUEUE_MAX_WEIGHT		(OUT_QUEUE_DEFAULT_WEIGHT*1000)
+#define OUT_QUEUE_MIN_WEIGHT		1
+
+/* Number of words in bitmap of not empty priority queues */
+#define PRIO_MAP_LEN		((MAX_PRIORITY+1)/32)
+
+/* Maximal number of commands popped from priority queue at once */
+#define OUT_QUEUE_BATCH_SIZE	64
 
 #define OUT_QUEUE_ADD_TAIL	1
 #define OUT_QUEUE_ADD_HEAD	2
@@ -65,6 +74,20 @@
 /* Maximal size of outgoing queue is 1MB */
 #define OUT_QUEUE_DEFAULT_MAX_SIZE 1048576
 
+/**
+ * Values shared by sequence of commands with the same ID in priority queue.
+ * They are allocated at once and commands point at them. Values are updated,
+ * when command is added to the sequence or removed from it, then length of
+ * compressed commands is never computed again, when commands are packed.
+ */
+typedef struct VOutQueueRun {
+	uint16					counter;		/**< Number of commands in the sequence */
+	uint16					len;			/**< Length of the compressed sequence */
+	uint16					item_len;		/**< Length of one command without shared address */
+	uint8					head_len;		/**< Length of OpCode, sharing and shared address */
+	int8					share;			/**< Size of address that could be shared */
+} VOutQueueRun;
+
 /**
  * Structure storing information about outgoing command waiting in the outgoing
  * queue
@@ -74,9 +97,7 @@ typedef struct VOutQueueCommand {
 	struct VBucket			*vbucket;		/**< Own data of command stored in hashed linked list of commands */
 	uint8					id;				/**< ID of command */
 	uint8					prio;			/**< Current priority of the command */
-	uint16					*counter;		/**< Pointer at number (allocated at heap) of following commands with same id */
-	int8					*share;			/**< Pointer at size (allocated at heap) of address that could be shared between commands with same id */
-	uint16					*len;			/**< Pointer at length of the compressed sequence of command with same ID */
+	struct VOutQueueRun		*run;			/**< Sequence of commands with same ID (NULL, when command is alone) */
 } VOutQueueCommand;
 
 /**
@@ -86,9 +107,24 @@ typedef struct VPrioOutQueue {
 	struct VListBase	cmds;	/**< Linked list of commands */
 	uint32				size;	/**< Size of stored commands (with this priority) in bytes */
 	uint32				count;	/**< Count of stored commands (with this priority) */
-	real32				r_prio;	/**< Real value of this priority queue */
+	uint32				weight;	/**< Weight of this priority queue used by scheduler */
+	uint32				deficit;/**< Number of bytes, that could be still sent from this queue */
 } VPrioOutQueue;
 
+/**
+ * Commands popped from one priority queue at once. When more commands are
+ * popped and compressed is 1, then commands are sequence of commands with the
+ * same ID and they could be packed as one compressed command.
+ */
+typedef struct VOutQueueBatch {
+	struct Generic_Cmd		*cmds[OUT_QUEUE_BATCH_SIZE];	/**< Popped commands */
+	uint16					count;			/**< Number of popped commands */
+	uint16					len;			/**< Length of popped commands in packet */
+	int8					share;			/**< Size of address shared by compressed commands */
+	uint8					compressed;		/**< Commands are one compressed sequence */
+	uint8					prio;			/**< Priority of commands */
+} VOutQueueBatch;
+
 /**
  * List of queues for incoming and outgoing commands. This is actually quueue
  * for all commands divided to the subqueues for all possible priorities of
@@ -101,12 +137,25 @@ typedef struct VOutQueue {
 	uint32					size;			/**< Size of stored commands in bytes */
 	uint32					max_size;		/**< Maximal allowed size of commands stored in this queue */
 	uint32					count;			/**< Count of stored commands */
-	uint8					max_prio;		/**< Maximal used priority queue */
-	uint8					min_prio;		/**< Minimal used priority queue */
-	real32					r_prio_sum_high;/**< Summary of all real priorities <MAX_PRIO, DEFAULT_PRIO> */
-	real32					r_prio_sum_low;	/**< Summary of all real priorities <DEFAULT_PRIO-1, MIN_PRIO> */
+	uint32					prio_map[PRIO_MAP_LEN];	/**< Bitmap of not empty priority queues */
+	uint32					weight_sum_high;/**< Summary of weights of not empty queues <MAX_PRIO, DEFAULT_PRIO> */
+	uint32					weight_sum_low;	/**< Summary of weights of not empty queues <DEFAULT_PRIO-1, MIN_PRIO> */
 } VOutQueue;
 
+/**
+ * Scheduler of priority queues used, when one packet or message is packed.
+ * Priority queues are visited from the highest priority. Each not empty queue
+ * gets quantum of bytes according its weight (deficit round robin) and the
+ * rest of quantum is kept for next packet, when the queue is not empty.
+ */
+typedef struct VOutQueueSched {
+	struct VOutQueue		*out_queue;		/**< Scheduled outgoing queue */
+	uint32					window;			/**< Size of window for commands in this packet */
+	int16					prio;			/**< Current priority queue (-1, when all were visited) */
+	uint8					visited;		/**< Quantum was already added to current priority queue */
+	uint8					cmpr;			/**< Type of command compression */
+} VOutQueueSched;
+
 int	v_out_queue_init(struct VOutQueue *out_queue, int max_size);
 struct VOutQueue *v_out_queue_create(void);
 void v_out_queue_destroy(struct VOutQueue **out_queue);
@@ -126,11 +175,14 @@ uint32 v_out_queue_get_count_prio(struct VOutQueue *out_queue, uint8 prio);
 uint32 v_out_queue_get_size_prio(struct VOutQueue *out_queue, uint8 prio);
 uint32 v_out_queue_get_count(struct VOutQueue *out_queue);
 uint32 v_out_queue_get_size(struct VOutQueue *out_queue);
-uint8 v_out_queue_get_max_prio(struct VOutQueue *out_queue);
-uint8 v_out_queue_get_min_prio(struct VOutQueue *out_queue);
-real32 v_out_queue_get_prio(struct VOutQueue *out_queue, uint8 prio);
-real32 v_out_queue_get_prio_sum_high(struct VOutQueue *out_queue);
-real32 v_out_queue_get_prio_sum_low(struct VOutQueue *out_queue);
+
+void v_out_queue_sched_init(struct VOutQueueSched *sched,
+		struct VOutQueue *out_queue,
+		uint32 window,
+		uint8 cmpr);
+uint16 v_out_queue_sched_pop(struct VOutQueueSched *sched,
+		uint16 space,
+		struct VOutQueueBatch *batch);
 
 #endif
 
@@ -38,6 +38,12 @@
 
 #include "verse_types.h"
 
+/* Arrays of values are converted with SSSE3 byte shuffle, when it is
+ * supported by compiler and CPU (detected at runtime) */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define V_PACK_SSSE3
+#endif
+
 size_t vnp_raw_pack_string8(void *buffer, char *string);
 size_t vnp_raw_pack_uint8(void *buffer,  uint8 data);
 size_t vnp_raw_pack_uint16(void *buffer, uint16 data);
@@ -47,4 +53,9 @@ size_t vnp_raw_pack_real16(void *buffer, real16 data);
 size_t vnp_raw_pack_real32(void *buffer, real32 data);
 size_t vnp_raw_pack_real64(void *buffer, real64 data);
 
+size_t vnp_raw_swap_array(void *dst, const void *src, const size_t size, const size_t count);
+size_t vnp_raw_pack_uint16_array(void *buffer, const void *data, const size_t count);
+size_t vnp_raw_pack_uint32_array(void *buffer, const void *data, const size_t count);
+size_t vnp_raw_pack_uint64_array(void *buffer, const void *data, const size_t count);
+
 #endif
@@ -0,0 +1,66 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#ifndef V_READY_RING_H_
+#define V_READY_RING_H_
+
+#include "verse_types.h"
+
+/**
+ * One cell of ring buffer. The sequence number says, if the cell is free
+ * for producer or it is ready for consumer.
+ */
+typedef struct VReadyRingCell {
+	uint32			seq;		/**< Sequence number of this cell */
+	void			*item;		/**< The pointer at queued item */
+} VReadyRingCell;
+
+/**
+ * Bounded lock-free ring buffer with multiple producers and single consumer.
+ * It is used for notification of data thread about queues with new commands.
+ */
+typedef struct VReadyRing {
+	struct VReadyRingCell	*cells;		/**< Array of cells */
+	uint32					mask;		/**< Length of array - 1 (length is power of 2) */
+	uint32					head;		/**< Position used by producers */
+	uint32					tail;		/**< Position used by single consumer */
+} VReadyRing;
+
+int v_ready_ring_push(struct VReadyRing *ring, void *item);
+void *v_ready_ring_pop(struct VReadyRing *ring);
+int v_ready_ring_init(struct VReadyRing *ring, uint32 size);
+void v_ready_ring_destroy(struct VReadyRing *ring);
+
+#endif /* V_READY_RING_H_ */
@@ -55,6 +55,7 @@
 #include "v_connection.h"
 #include "v_out_queue.h"
 #include "v_in_queue.h"
+#include "v_delta.h"
 
 #define TOKEN_SIZE		16
 
@@ -108,6 +109,9 @@ typedef struct VSession {
 	float					fps_host;		/* FPS used by this host */
 	float					fps_peer;		/* Negotiated FPS used by peer */
 	unsigned char			tmp_flags;		/* Temporary flags (notification of received system commands) */
+	/* Delta coding of layer values */
+	uint32					delta_seq;		/* The last sequence number of sent delta (verse server specific) */
+	struct VDeltaRecv		*delta_recv;	/* Values received as delta (verse client specific) */
 	/* Information about client program */
 	char					*client_name;
 	char					*client_version;
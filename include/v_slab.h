@@ -0,0 +1,79 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#ifndef V_SLAB_H_
+#define V_SLAB_H_
+
+#include <stddef.h>
+
+#include "verse_types.h"
+
+/* Size of the smallest class of objects (it has to be power of 2 and bigger
+ * than pointer) */
+#define SLAB_MIN_SIZE		16
+/* Number of size classes (16, 32, 64, 128, 256 and 512 bytes). Bigger
+ * objects are allocated with malloc() */
+#define SLAB_CLASS_COUNT	6
+#define SLAB_MAX_SIZE		(SLAB_MIN_SIZE << (SLAB_CLASS_COUNT - 1))
+/* Size of memory allocated for one class at once */
+#define SLAB_CHUNK_SIZE		65536
+/* Number of objects moved between cache of thread and shared depot at once */
+#define SLAB_BATCH_SIZE		32
+/* Maximal number of free objects in cache of one thread and one class */
+#define SLAB_CACHE_SIZE		(4*SLAB_BATCH_SIZE)
+
+/**
+ * Statistics of one size class. Counters of threads are added to the
+ * statistics, when thread exchanges objects with shared depot, then
+ * alloc_count and free_count could be a little bit old.
+ */
+typedef struct VSlabStats {
+	uint32			size;			/**< Size of objects in this class */
+	uint32			chunk_count;	/**< Number of allocated chunks */
+	uint64			obj_count;		/**< Number of objects in all chunks */
+	uint64			depot_count;	/**< Number of free objects in shared depot */
+	uint64			alloc_count;	/**< Number of allocated objects */
+	uint64			free_count;		/**< Number of freed objects */
+	uint64			refill_count;	/**< Number of batches taken from depot */
+	uint64			flush_count;	/**< Number of batches returned to depot */
+} VSlabStats;
+
+void *v_slab_alloc(size_t size);
+void *v_slab_calloc(size_t size);
+void v_slab_free(void *ptr, size_t size);
+void v_slab_get_stats(struct VSlabStats stats[SLAB_CLASS_COUNT]);
+void v_slab_print_stats(const unsigned char level);
+
+#endif /* V_SLAB_H_ */
@@ -82,6 +82,7 @@
 #define CMPR_RESERVED			0	/* Should never be used */
 #define CMPR_NONE				1
 #define CMPR_ADDR_SHARE			2
+#define CMPR_DEFLATE			3	/* Address sharing and deflate of node commands */
 
 /* Minimal and maximal count of method types in USER_AUTH_FAILURE system command */
 #define VRS_MIN_UA_METHOD_COUNT		0
@@ -51,11 +51,14 @@ struct Generic_Cmd *v_taggroup_destroy_create(uint32 node_id,
 struct Generic_Cmd *v_taggroup_subscribe_create(uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32);
+		uint32 crc32,
+		uint32 epoch);
 
 struct Generic_Cmd *v_taggroup_unsubscribe_create(uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32);
+		uint32 crc32,
+		uint8 versing,
+		uint32 epoch);
 
 #endif /* V_TAGGROUP_COMMAND_H_ */
@@ -72,11 +72,13 @@ typedef struct VFuncStorage {
 	void (*receive_node_subscribe)(const uint8 session_id,
 			const uint32 node_id,
 			const uint32 version,
-			const uint32 crc32);
+			const uint32 crc32,
+			const uint32 epoch);
 	void (*receive_node_unsubscribe)(const uint8 session_id,
 			const uint32 node_id,
 			const uint32 version,
-			const uint32 crc32);
+			const uint32 crc32,
+			const uint32 epoch);
 	void (*receive_node_perm)(const uint8 session_id,
 			uint32 node_id,
 			uint16 user_id,
@@ -105,12 +107,14 @@ typedef struct VFuncStorage {
 			const uint32 node_id,
 			const uint16 taggroup_id,
 			const uint32 crc32,
-			const uint32 version);
+			const uint32 version,
+			const uint32 epoch);
 	void (*receive_taggroup_unsubscribe)(const uint8 session_id,
 			const uint32 node_id,
 			const uint16 taggroup_id,
 			const uint32 crc32,
-			const uint32 version);
+			const uint32 version,
+			const uint32 epoch);
 	void (*receive_tag_create)(const uint8 session_id,
 			const uint32 node_id,
 			const uint16 taggroup_id,
@@ -144,12 +148,14 @@ typedef struct VFuncStorage {
 			const uint32_t node_id,
 			const uint16_t layer_id,
 			const uint32_t version,
-			const uint32_t crc32);
+			const uint32_t crc32,
+			const uint32_t epoch);
 	void (*receive_layer_unsubscribe)(const uint8_t session_id,
 			const uint32_t node_id,
 			const uint16_t layer_id,
 			const uint32_t version,
-			const uint32_t crc32);
+			const uint32_t crc32,
+			const uint32_t epoch);
 	void (*receive_layer_set_value)(const uint8_t session_id,
 			const uint32_t node_id,
 			const uint16_t layer_id,
@@ -158,6 +158,8 @@ extern "C" {
 #define VRS_TP_WEBSOCKET			16	/* Transport protocol: WebSocket */
 #define VRS_CMD_CMPR_NONE			32	/* No command compression */
 #define VRS_CMD_CMPR_ADDR_SHARE		64	/* Share command addresses to compress commands */
+#define VRS_CMD_CMPR_DEFLATE		128	/* Share addresses and deflate payload of packets */
+#define VRS_VALUE_DELTA				256	/* Receive layer values as delta against acknowledged values (use it with VRS_CMD_CMPR_DEFLATE) */
 
 /* Types of verse values */
 #define VRS_VALUE_TYPE_RESERVED		0
@@ -170,6 +172,10 @@ extern "C" {
 #define VRS_VALUE_TYPE_REAL64		7
 #define VRS_VALUE_TYPE_STRING8		8
 
+/* Precision of values sent to layer subscriber */
+#define VRS_LAYER_PRECISION_FULL	0	/* Values are sent in data type of layer */
+#define VRS_LAYER_PRECISION_REAL16	1	/* Values of real32 and real64 layers are sent as real16 */
+
 /* Parameters of session */
 #define VRS_SESSION_IN_QUEUE_MAX_SIZE		1
 #define VRS_SESSION_IN_QUEUE_FREE_SPACE		2
@@ -428,6 +434,10 @@ void vrs_register_receive_node_destroy(void (*func)(const uint8_t session_id,
  * \param[in]	version		The requested version that client request. The client
  * has to have local copy of this version.
  * \param[in]	crc32		The crc32 of requested version.
+ * \param[in]	epoch		The epoch of requested version received in
+ * Node_UnSubscribe command. When epoch of node at server is different (node
+ * was destroyed and created again, server was restarted, etc.), then server
+ * sends whole node.
  *
  * \return		This function returns VRS_SUCCESS (0), when the session_id
  * was valid value, it returns VRS_FAILURE (1) otherwise.
@@ -436,7 +446,8 @@ int32_t vrs_send_node_subscribe(const uint8_t session_id,
 		const uint8_t prio,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32);
+		const uint32_t crc32,
+		const uint32_t epoch);
 
 /**
  * \brief This function register callback function for command Node_Subscribe
@@ -446,11 +457,13 @@ int32_t vrs_send_node_subscribe(const uint8_t session_id,
  * \param[in]	node_id		The ID that client wants to be subscribed for.
  * \param[in]	version		The version of node
  * \param[in]	crc32		The CRC32 of the node
+ * \param[in]	epoch		The epoch of version of the node
  */
 void vrs_register_receive_node_subscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
 
 /**
  * \brief This function tries to send command Node_Unsubscribe to the server.
@@ -479,11 +492,13 @@ int32_t vrs_send_node_unsubscribe(const uint8_t session_id,
  * \param[in]	node_id		The ID that client wants to be unsubscribed from.
  * \param[in]	version		The version of node
  * \param[in]	crc32		The CRC32 of the node
+ * \param[in]	epoch		The epoch of version of the node
  */
 void vrs_register_receive_node_unsubscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
 
 /**
  * \brief This function tries to send command Node_Owner to the server
@@ -716,6 +731,8 @@ void vrs_register_receive_taggroup_destroy(void (*func)(const uint8_t session_id
  * \param[in]	version			The version that client tries to subscribed for
  * \param[in]	crc32			The crc32 of subscribed version (when version is 0,
  * then the crc32 is defined as zero)
+ * \param[in]	epoch			The epoch of subscribed version received in
+ * TagGroup_UnSubscribe command
  *
  * \return		This function returns VRS_SUCCESS (0), when the session_id
  * was valid value, it returns VRS_FAILURE (1) otherwise.
@@ -725,7 +742,8 @@ int32_t vrs_send_taggroup_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32);
+		const uint32_t crc32,
+		const uint32_t epoch);
 
 /**
  * \brief This function register callback function for command TagGroup_Subscribe
@@ -737,12 +755,14 @@ int32_t vrs_send_taggroup_subscribe(const uint8_t session_id,
  * \param[in]	version		The version that client subscribed for
  * \param[in]	crc32		The crc32 of subscribed version (when version is 0,
  * then the crc32 is defined as zero)
+ * \param[in]	epoch		The epoch of subscribed version
  */
 void vrs_register_receive_taggroup_subscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
 
 /**
  * \brief This function send command TagGroup_Unsubscribe to the server
@@ -775,12 +795,15 @@ int32_t vrs_send_taggroup_unsubscribe(const uint8_t session_id,
  * \param[in]	version		The version of unsubscibed taggroup (generated by server)
  * \param[in]	crc32		The crc32 of unsubscribed version (when version is 0,
  * then the crc32 is defined as zero)
+ * \param[in]	epoch		The epoch of unsubscribed version, that has to be
+ * sent together with version in next TagGroup_Subscribe
  */
 void vrs_register_receive_taggroup_unsubscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
 
 /**
  * \brief This function send command Tag_Create to the server
@@ -978,6 +1001,8 @@ void vrs_register_receive_layer_destroy(void (*func)(const uint8_t session_id,
  * \param[in]	layer_id		The ID of layer that will be destroyed
  * \param[in]	version			The version that client wants to subscribe to
  * \param[in]	crc32			The CRC32 code
+ * \param[in]	epoch			The epoch of version received in
+ * Layer_UnSubscribe command
  *
  * \return	This function returns VRS_SUCCESS (0), when the session_id
  * was valid value, it returns VRS_FAILURE (1) otherwise.
@@ -987,7 +1012,8 @@ int32_t vrs_send_layer_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32);
+		const uint32_t crc32,
+		const uint32_t epoch);
 
 /**
  * \brief This function register callback function for command Layer_Subscribe
@@ -998,12 +1024,44 @@ int32_t vrs_send_layer_subscribe(const uint8_t session_id,
  * \param[in]	layer_id		The ID of layer that will be destroyed
  * \param[in]	version			The version that client wants to subscribe to
  * \param[in]	crc32			The CRC32 code
+ * \param[in]	epoch			The epoch of version
  */
 void vrs_register_receive_layer_subscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
+
+/**
+ * \brief This function sends command layer_subscribe to verse server with
+ * requested precision of values
+ *
+ * When VRS_LAYER_PRECISION_REAL16 is requested, then verse server sends
+ * values of real32 and real64 layers as half precision floats and callback
+ * function of Layer_Set_Value receives them with VRS_VALUE_TYPE_REAL16 type.
+ * Such values could be converted with vrs_real16_to_real32(). Values of
+ * other layers are not changed.
+ *
+ * \param[in]	session_id		The ID of session with verse server.
+ * \param[in]	prio			The priority of node
+ * \param[in]	node_id			The ID of node with layer
+ * \param[in]	layer_id		The ID of layer that will be subscribed
+ * \param[in]	version			The version that client wants to subscribe to
+ * \param[in]	precision		The precision of values (VRS_LAYER_PRECISION_*)
+ * \param[in]	epoch			The epoch of version received in
+ * Layer_UnSubscribe command
+ *
+ * \return	This function returns VRS_SUCCESS (0), when the session_id
+ * was valid value, it returns VRS_FAILURE (1) otherwise.
+ */
+int32_t vrs_send_layer_subscribe_precision(const uint8_t session_id,
+		const uint8_t prio,
+		const uint32_t node_id,
+		const uint16_t layer_id,
+		const uint32_t version,
+		const uint8_t precision,
+		const uint32_t epoch);
 
 /**
  * \brief This function sends command layer_subscribe to verse server
@@ -1030,13 +1088,17 @@ int32_t vrs_send_layer_unsubscribe(const uint8_t session_id,
  * \param[in]	prio			The priority of node
  * \param[in]	node_id			The ID of node, where layer will be destroyed
  * \param[in]	layer_id		The ID of layer that will be destroyed
- * \param[in]	versing			The flag if client requires versing of this layer
+ * \param[in]	version			The version of layer
+ * \param[in]	crc32			The CRC32 of layer
+ * \param[in]	epoch			The epoch of version, that has to be sent
+ * together with version in next Layer_Subscribe
  */
 void vrs_register_receive_layer_unsubscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32));
+		const uint32_t crc32,
+		const uint32_t epoch));
 
 /**
  * \brief This function sets value of layer item
@@ -1114,6 +1176,12 @@ void vrs_register_receive_layer_unset_value(void (*func)(const uint8_t session_i
 		const uint16_t layer_id,
 		const uint32_t item_id));
 
+/**
+ * \brief This function converts half precision float received in value of
+ * VRS_VALUE_TYPE_REAL16 type to single precision float
+ */
+float vrs_real16_to_real32(const uint16_t value);
+
 #if defined __cplusplus
 }
 #endif
@@ -25,6 +25,50 @@
 #ifndef VS_DATA_H_
 #define VS_DATA_H_
 
+#include <pthread.h>
+
+#include "verse_types.h"
+#include "v_list.h"
+
+/* Default number of threads handling node commands */
+#define DEFAULT_DATA_THREAD_COUNT	1
+/* Maximal number of threads handling node commands */
+#define MAX_DATA_THREAD_COUNT		64
+
+struct VS_CTX;
+struct VSession;
+struct Generic_Cmd;
+
+/**
+ * Node command waiting in the queue of data shard
+ */
+typedef struct VSDataShardCmd {
+	struct VSDataShardCmd	*prev, *next;
+	struct VSession			*vsession;	/* Session that sent this command */
+	struct Generic_Cmd		*cmd;		/* Received command */
+} VSDataShardCmd;
+
+/**
+ * Data shard is worker thread handling node commands of nodes with
+ * node_id % shard_count == index. Commands, that modify only content of one
+ * node (tag groups, tags and layers), are handled in shards in parallel.
+ * Other commands are handled by main data thread, when all shards are idle.
+ */
+typedef struct VSDataShard {
+	struct VS_CTX		*vs_ctx;		/* The pointer at verse server context */
+	pthread_t			thread;			/* Worker thread of this shard */
+	pthread_mutex_t		mutex;			/* Mutex protecting queue of commands */
+	pthread_cond_t		work_cond;		/* Signaled, when new command was added */
+	pthread_cond_t		idle_cond;		/* Signaled, when shard handled all commands */
+	struct VListBase	cmds;			/* Queue of commands */
+	uint32				count;			/* Number of queued and handled commands */
+	uint8				index;			/* Index of this shard */
+	uint8				running;		/* Worker thread should continue */
+} VSDataShard;
+
+int vs_data_shards_init(struct VS_CTX *vs_ctx);
+void vs_data_shards_destroy(struct VS_CTX *vs_ctx);
+int vs_data_shard_is_idle(struct VS_CTX *vs_ctx, uint32 node_id);
 void *vs_data_loop(void *arg);
 
 #endif /* VS_DATA_H_ */
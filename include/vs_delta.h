@@ -0,0 +1,80 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#ifndef VS_DELTA_H_
+#define VS_DELTA_H_
+
+#include "verse_types.h"
+
+#include "v_session.h"
+#include "v_delta.h"
+
+#include "vs_layer_values.h"
+
+/**
+ * \brief State of delta coding of one layer item for one subscriber.
+ *
+ * It is stored in the dense storage of layer items together with the base
+ * value (the newest value acknowledged by client) and the ring of the last
+ * DELTA_HISTORY_LEN sent values. Only values in this ring could become base
+ * value, when they are acknowledged.
+ */
+typedef struct VSDeltaItem {
+	uint32		sent_seq[DELTA_HISTORY_LEN];	/**< Sequence numbers of sent values */
+	uint32		sent_count;		/**< Number of values sent to the client */
+	uint32		base_seq;		/**< Sequence number of base value */
+	uint32		base_index;		/**< Index of base value in sent values */
+	uint8		base_valid;		/**< Base value was acknowledged by client */
+} VSDeltaItem;
+
+/**
+ * \brief State of delta coding of one layer for one subscriber.
+ */
+typedef struct VSDelta {
+	struct VSLayerValues	items;		/**< State of items (VSDeltaItem, base and sent values) */
+	uint8					*empty;		/**< State of item, that was never sent */
+	uint16					value_size;	/**< Size of value sent to the client */
+	uint16					header_size;	/**< Aligned size of VSDeltaItem */
+} VSDelta;
+
+struct VSDelta *vs_delta_create(uint16 value_size);
+
+void vs_delta_destroy(struct VSDelta **delta);
+
+int vs_delta_encode(struct VSDelta *delta,
+		struct VSession *vsession,
+		uint32 item_id,
+		const void *value,
+		uint16 *seq,
+		uint16 *base,
+		void *out);
+
+void vs_delta_ack(struct VSDelta *delta,
+		struct VSession *vsession,
+		uint32 item_id,
+		uint16 seq);
+
+void vs_delta_remove(struct VSDelta *delta, uint32 item_id);
+
+#endif /* VS_DELTA_H_ */
@@ -0,0 +1,122 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#ifndef VS_DGRAM_WORKER_H_
+#define VS_DGRAM_WORKER_H_
+
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "verse_types.h"
+#include "v_list.h"
+
+/* Default number of threads handling datagram connections */
+#define DEFAULT_DGRAM_THREAD_COUNT	1
+/* Maximal number of threads handling datagram connections */
+#define MAX_DGRAM_THREAD_COUNT		64
+
+/* Maximal number of events returned by one call of epoll_wait() */
+#define DGRAM_WORKER_MAX_EVENTS		64
+/* Maximal number of packets received from shared socket with one system call */
+#define DGRAM_WORKER_MAX_RECV		16
+
+struct VS_CTX;
+struct VSession;
+struct VPacket;
+struct VPacketBatch;
+struct vContext;
+
+/**
+ * Key of datagram connection using shared port. Connections are identified
+ * by address and port of client. All bytes of unused part of address have
+ * to be zero.
+ */
+typedef struct VSDgramConnKey {
+	uint8				ip_ver;			/* Version of IP */
+	uint8				reserved;		/* Padding (always zero) */
+	uint16				port;			/* Port of client (network byte order) */
+	uint8				addr[16];		/* IPv4 or IPv6 address of client */
+} VSDgramConnKey;
+
+/**
+ * Datagram connection handled by datagram worker
+ */
+typedef struct VSDgramWorkerConn {
+	struct VSDgramWorkerConn	*prev, *next;
+	struct VSDgramConnKey	key;		/* Address of client (only for shared port) */
+	struct VSDgramWorker	*worker;	/* Worker handling this connection */
+	struct vContext		*C;				/* Copy of Verse context used by this connection */
+	struct VSession		*vsession;		/* Session of this connection */
+	struct timeval		tv_update;		/* Time of next update (sending) of connection */
+	uint8				closed;			/* Connection was closed by state machine */
+	uint8				canceled;		/* Connection was canceled by TCP thread */
+} VSDgramWorkerConn;
+
+/**
+ * Datagram worker is thread handling many datagram connections. It waits for
+ * incoming packets on sockets of all connections with epoll and connections
+ * are updated with negotiated FPS using timerfd.
+ */
+typedef struct VSDgramWorker {
+	struct VS_CTX		*vs_ctx;		/* The pointer at verse server context */
+	pthread_t			thread;			/* Thread of this worker */
+	pthread_mutex_t		mutex;			/* Mutex protecting lists of connections */
+	pthread_cond_t		release_cond;	/* Signaled, when connection was released */
+	struct VListBase	new_conns;		/* Connections added by TCP threads */
+	struct VListBase	conns;			/* Connections handled by this worker */
+	uint32				count;			/* Number of new and handled connections */
+	struct VPacket		*r_packet;		/* Packet structure for receiving shared by all connections */
+	struct VPacket		*s_packet;		/* Packet structure for sending shared by all connections */
+	int					epoll_fd;		/* Epoll instance */
+	int					timer_fd;		/* Timer of the nearest update of connection */
+	int					event_fd;		/* Notification about new or canceled connections */
+	int					dgram_fd;		/* Socket bound to shared port (-1, when not used) */
+	char				*bufs[DGRAM_WORKER_MAX_RECV];	/* Spare buffers for packets received from shared socket */
+	struct VPacketBatch	*batch;			/* Packets sent by connections, flushed before waiting for events */
+	uint8				index;			/* Index of this worker */
+	uint8				running;		/* Worker thread should continue */
+} VSDgramWorker;
+
+/**
+ * Demultiplexing of packets received at shared port. Each worker has own
+ * socket bound to the shared port with SO_REUSEPORT. New connections wait in
+ * the list of pending connections, until first packet with negotiated token
+ * is received. The worker, that received this packet, handles connection
+ * since then, because kernel delivers packets from the same client to the
+ * same socket.
+ */
+typedef struct VSDgramDemux {
+	pthread_mutex_t		mutex;			/* Mutex protecting table and list */
+	pthread_cond_t		release_cond;	/* Signaled, when pending connection was removed from the list */
+	struct VHashArrayBase	conns;		/* Connections indexed by address of client */
+	struct VListBase	pending;		/* Connections waiting for first packet */
+} VSDgramDemux;
+
+int vs_dgram_workers_init(struct VS_CTX *vs_ctx);
+void vs_dgram_workers_destroy(struct VS_CTX *vs_ctx);
+int vs_dgram_workers_add_conn(struct VS_CTX *vs_ctx, struct vContext *C);
+void vs_dgram_workers_cancel_conn(struct VS_CTX *vs_ctx, struct VSession *vsession);
+void vs_dgram_workers_wait_conn(struct VS_CTX *vs_ctx, struct VSession *vsession);
+
+#endif /* VS_DGRAM_WORKER_H_ */
@@ -42,6 +42,10 @@ typedef struct VSEntitySubscriber {
 	struct VSEntitySubscriber	*prev, *next;
 	/* Pointer at node subscriber */
 	struct VSNodeSubscriber		*node_sub;
+	/* Precision of values requested by client (used only by layers) */
+	uint8						precision;
+	/* State of delta coding requested by client (used only by layers) */
+	struct VSDelta				*delta;
 } VSEntitySubscriber;
 
 typedef struct VSEntityFollower {
@@ -0,0 +1,103 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#ifndef VS_JOURNAL_H_
+#define VS_JOURNAL_H_
+
+#include "verse_types.h"
+
+/* Maximal number of changes stored in journal of one entity */
+#define JOURNAL_MAX_LENGTH			1024
+/* Number of entries allocated, when the first change is added */
+#define JOURNAL_MIN_LENGTH			16
+
+/* Type of change of item */
+#define JOURNAL_ITEM_CREATE			1	/* Item was created (it did not exist before) */
+#define JOURNAL_ITEM_CHANGE			2	/* Value of existing item was changed */
+#define JOURNAL_ITEM_DESTROY		3	/* Item was destroyed */
+
+/**
+ * \brief One change of entity in journal
+ */
+typedef struct VSJournalEntry {
+	uint32		version;		/**< Version of entity after change */
+	uint32		item_id;		/**< The ID of changed item (layer item, tag) */
+	uint8		type;			/**< The type of change */
+} VSJournalEntry;
+
+/**
+ * \brief Bounded journal of changes of one entity (layer, tag group).
+ *
+ * Journal is ring buffer of the last JOURNAL_MAX_LENGTH changes. It covers
+ * all changes made after base_version. When the oldest change is dropped,
+ * then base_version is moved to the version of this change. Client holding
+ * version covered by journal can receive only changed items.
+ *
+ * Versions of entity are not unique, when entity is destroyed and created
+ * again with the same ID or when version is changed without journal. Such
+ * journal gets new epoch and client has to send epoch received together
+ * with its version.
+ */
+typedef struct VSJournal {
+	struct VSJournalEntry	*entries;	/**< Ring buffer of changes (NULL until first change) */
+	uint32		first;			/**< Index of the oldest change */
+	uint32		count;			/**< Number of changes */
+	uint32		length;			/**< Allocated length of ring buffer */
+	uint32		base_version;	/**< Journal contains all changes after this version */
+	uint32		epoch;			/**< Epoch of versions covered by journal */
+} VSJournal;
+
+/**
+ * \brief Item changed since some version
+ */
+typedef struct VSJournalChange {
+	uint32		item_id;		/**< The ID of changed item */
+	uint8		created;		/**< Item did not exist in the old version */
+	uint8		destroyed;		/**< Item was destroyed (and maybe created again) */
+} VSJournalChange;
+
+uint32 vs_journal_new_epoch(void);
+
+void vs_journal_init(struct VSJournal *journal, uint32 version, uint32 epoch);
+
+void vs_journal_destroy(struct VSJournal *journal);
+
+void vs_journal_reset(struct VSJournal *journal, uint32 version, uint32 epoch);
+
+void vs_journal_add(struct VSJournal *journal,
+		uint32 version,
+		uint32 item_id,
+		uint8 type);
+
+int vs_journal_changes(struct VSJournal *journal,
+		uint32 epoch,
+		uint32 version,
+		uint32 cur_version,
+		struct VSJournalChange **changes);
+
+struct VSJournalChange *vs_journal_find_change(struct VSJournalChange *changes,
+		int change_count,
+		uint32 item_id);
+
+#endif /* VS_JOURNAL_H_ */
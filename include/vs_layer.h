@@ -30,20 +30,14 @@
 #include "v_list.h"
 
 #include "vs_node.h"
+#include "vs_layer_values.h"
+#include "vs_journal.h"
 
 #define FIRST_LAYER_ID				0
 #define LAST_LAYER_ID				65534	/* 2^16 - 2 */
 
 #define MAX_LAYERS_COUNT			65534	/* Max number of layer that could be stored inside one node */
 
-/**
- * \brief The structure storing own value(s)
- */
-typedef struct VSLayerValue {
-	uint32	id;
-	void	*value;
-} VSLayerValue;
-
 /**
  * \brief The structure storing information about layer
  */
@@ -53,7 +47,7 @@ typedef struct VSLayer {
 	uint8					data_type;		/**< The type of values stored in this layer */
 	uint8					num_vec_comp;	/**< The number of vector components (1, 2, 3, 4) */
 	uint16					custom_type;	/**< The type of layer defined by client */
-	struct VHashArrayBase	values;			/**< The hashed linked list of values */
+	struct VSLayerValues	values;			/**< The dense storage of item values */
 	/* Parent-Child */
 	struct VSLayer			*parent;		/**< The parent layer */
 	struct VListBase		child_layers;	/**< The list of child layers */
@@ -65,6 +59,7 @@ typedef struct VSLayer {
 	uint32					version;		/**< Current version of layer */
 	uint32					saved_version;	/**< last saved version of layer */
 	uint32					crc32;			/**< CRC32 of current layer version */
+	struct VSJournal		journal;		/**< Journal of recent changes of items */
 #ifdef WITH_MONGODB
 	bson_oid_t				oid;
 #endif
@@ -116,6 +111,10 @@ int vs_handle_layer_set_value(struct VS_CTX *vs_ctx,
 		uint8 data_type,
 		uint8 count);
 
+int vs_handle_layer_set_ack(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd);
+
 int vs_handle_layer_unset_value(struct VS_CTX *vs_ctx,
 		struct VSession *vsession,
 		struct Generic_Cmd *layer_unset_value_cmd);
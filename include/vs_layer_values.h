@@ -0,0 +1,79 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#ifndef VS_LAYER_VALUES_H_
+#define VS_LAYER_VALUES_H_
+
+#include "verse_types.h"
+
+/* Minimal number of items allocated in dense arrays */
+#define LAYER_VALUES_MIN_LENGTH		4
+/* Maximal number of items of small layer. Small layer doesn't use sparse
+ * index and items are searched in the dense array of IDs */
+#define LAYER_VALUES_SMALL_COUNT	8
+
+/**
+ * \brief Dense storage of layer items.
+ *
+ * IDs of items and values of items are stored in two dense arrays (value of
+ * item with ID ids[i] is stored at data[i*value_size]). Sparse index maps
+ * item ID to the position in dense arrays. It is open addressing array of
+ * positions (position + 1 is stored, zero is empty slot). Sparse index is
+ * not allocated until layer has more than LAYER_VALUES_SMALL_COUNT items.
+ * When item is unset, then the last item is moved to its position and dense
+ * arrays don't contain any hole.
+ */
+typedef struct VSLayerValues {
+	uint32		*ids;			/**< Dense array of item IDs */
+	uint8		*data;			/**< Dense array of item values */
+	uint32		count;			/**< Number of items */
+	uint32		length;			/**< Allocated number of items in dense arrays */
+	uint32		*index;			/**< Sparse index (item ID -> position + 1) */
+	uint32		index_length;	/**< Length of sparse index (power of 2) */
+	uint16		value_size;		/**< Size of one item value in bytes */
+} VSLayerValues;
+
+/**
+ * \brief This macro returns pointer at value of item at position i
+ */
+#define vs_layer_values_at(values, i)	((void*)((values)->data + (size_t)(i) * (values)->value_size))
+
+int vs_layer_values_init(struct VSLayerValues *values, uint16 value_size);
+
+void vs_layer_values_destroy(struct VSLayerValues *values);
+
+void *vs_layer_values_find(struct VSLayerValues *values, uint32 item_id);
+
+void *vs_layer_values_set(struct VSLayerValues *values,
+		uint32 item_id,
+		const void *value);
+
+int vs_layer_values_unset(struct VSLayerValues *values, uint32 item_id);
+
+int vs_layer_values_load(struct VSLayerValues *values,
+		const uint32 *ids,
+		const void *data,
+		uint32 count);
+
+#endif /* VS_LAYER_VALUES_H_ */
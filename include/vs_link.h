@@ -40,6 +40,7 @@ typedef struct VSLink {
 	struct VSNode *child;
 } VSLink;
 
+int vs_link_test_nodes(struct VSNode *parent, struct VSNode *child);
 struct VSLink *vs_link_create(struct VSNode *parent, struct VSNode *child);
 int vs_handle_link_change(struct VS_CTX *vs_ctx,
 		struct VSession *vsession,
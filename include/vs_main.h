@@ -42,10 +42,15 @@
 #include "vs_user.h"
 #include "vs_node.h"
 
+#ifdef WITH_MONGODB
+#include "vs_mongo_main.h"
+#endif
+
 #include "v_connection.h"
 #include "v_network.h"
 #include "v_context.h"
 #include "v_list.h"
+#include "v_ready_ring.h"
 
 /* Default configuration file of verse server */
 #define DEFAULT_SERVER_CONFIG_FILE			"/etc/verse/server.ini"
@@ -94,8 +99,12 @@ typedef struct VSData {
 	struct VSNode		*user_node;					/* Pointer at parent of all user nodes (node_id=2) */
 	struct VSNode		*scene_node;				/* Pointer at parent of all scene nodes (node_id=3) */
 	/* Thread staff */
-	pthread_mutex_t		mutex;						/* Connection threads needs create avatar nodes occasionally */
+	pthread_rwlock_t	lock;						/* Data shards hold read lock, commands modifying node tree
+													   and connection threads (avatar nodes) hold write lock */
+	struct VSDataShard	*shards;					/* Array of data shards (worker threads) */
+	unsigned char		shard_count;				/* Number of data shards */
 	sem_t				*sem;						/* Semaphore used for notification data thread (some data were added to the queue) */
+	struct VReadyRing	ready_sessions;				/* Sessions with not empty incoming queue */
 	char				*sem_name;					/* The name of named semaphore */
 } VSData;
 
@@ -120,10 +129,16 @@ typedef struct VS_CTX {
 	struct VSession		**vsessions;				/* List of sessions and session with connection attempts */
 	unsigned int		in_queue_max_size;			/* Default value of max size of incoming queue */
 	unsigned int		out_queue_max_size;			/* Default value of max size of outgoing queue */
+	unsigned char		data_threads;				/* Number of threads handling node commands */
+	unsigned char		dgram_threads;				/* Number of threads handling datagram connections */
+	struct VSDgramWorker	*dgram_workers;			/* Array of datagram workers */
+	unsigned char		dgram_worker_count;			/* Number of running datagram workers */
 	/* Ports for connections */
 	unsigned short		port_low;					/* The lowest port number in port range */
 	unsigned short		port_high;					/* The highest port number in port range */
 	struct VS_Port		*port_list;					/* List of free ports used for communication with clients */
+	unsigned short		dgram_shared_port;			/* Port shared by all datagram connections (0 = disabled) */
+	struct VSDgramDemux	*dgram_demux;				/* Table of connections using shared port */
 	/* Data for packet receiving */
 	struct IO_CTX 		tcp_io_ctx;					/* Verse context for TCP connection attempts */
 	struct IO_CTX		ws_io_ctx;					/* Verse context for WebSocket connection attempts */
@@ -139,6 +154,7 @@ typedef struct VS_CTX {
 													   negotiated during authentication of users */
 	char				*ded;						/* String of Data Exchange Definition (Version, URL, etc.) */
 	unsigned char		cc_meth;					/* Allowed methods of Congestion Control */
+	unsigned char		cc_alg;						/* Algorithm of TCP like Congestion Control */
 	unsigned char		fc_meth;					/* Allowed methods of Flow Control */
 	unsigned char		rwin_scale;					/* Scale of Flow Control Window */
 	unsigned char		cmd_cmpr;					/* Prefered command compression */
@@ -157,6 +173,11 @@ typedef struct VS_CTX {
 	/* WebSocket thread */
 	pthread_t			websocket_thread;			/* WebSocket thread */
 	pthread_attr_t		websocket_thread_attr;		/* The attribute of WebSocket thread*/
+	/* Built-in persistence */
+	unsigned char		persist_engine;				/* Engine used for persistence of shared data */
+	char				*persist_dir;				/* Directory with snapshot and write-ahead log */
+	unsigned int		persist_snapshot_interval;	/* Period of creating snapshots (seconds) */
+	struct VSPersist	*persist;					/* Running persistence engine (NULL, when disabled) */
 #ifdef WITH_MONGODB
 	pthread_t			save_thread;				/* Thread for continuous saving of shared data */
 	mongo				*mongo_conn;				/* Connection to MongoDB server */
@@ -168,6 +189,13 @@ typedef struct VS_CTX {
 	char				*mongo_node_ns;				/* Namespace used for saving nodes */
 	char				*mongo_tg_ns;				/* Namespace used for saving tag groups */
 	char				*mongo_layer_ns;			/* Namesapce used for saving layers */
+	unsigned int		mongodb_save_interval;		/* Period of saving changed data (seconds) */
+	unsigned int		mongodb_save_batch;			/* Maximal number of documents saved in one batch */
+	unsigned int		mongodb_evict_time;			/* Idle time of node before eviction (seconds, 0 = never) */
+	pthread_mutex_t		mongo_mutex;				/* Mutex of connection shared by data and saving thread */
+	struct VSMongoQueue	mongo_dirty;				/* FIFO of nodes with changes, that were not saved yet */
+	struct VSMongoQueue	mongo_idle;					/* FIFO of nodes with data in memory (candidates of eviction) */
+	pthread_mutex_t		mongo_queue_mutex;			/* Mutex of FIFOs filled by data shards */
 #endif
 } VS_CTX;
 
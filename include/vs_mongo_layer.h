@@ -26,10 +26,11 @@
 #define VS_MONGO_LAYER_H_
 
 struct VS_CTX;
+struct VSMongoSaveBatch;
 struct VSNode;
 struct VSLayer;
 
-int vs_mongo_layer_save(struct VS_CTX *vs_ctx,
+int vs_mongo_layer_snapshot(struct VSMongoSaveBatch *batch,
 		struct VSNode *node,
 		struct VSLayer *layer);
 
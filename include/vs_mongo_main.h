@@ -27,7 +27,76 @@
 
 #define MONGO_HAVE_STDINT 1
 
+#include <mongo.h>
+#include <time.h>
+
+#include "verse_types.h"
+#include "v_list.h"
+
+/* Default period of saving changed data to MongoDB (in seconds) */
+#define MONGO_SAVE_INTERVAL		5
+/* Default maximal number of documents saved in one batch */
+#define MONGO_SAVE_BATCH_SIZE	64
+/* Default time (in seconds), when data of node without subscriber are
+ * removed from memory */
+#define MONGO_EVICT_TIME		300
+
+#define MONGO_QUEUE_MIN_LENGTH	64
+
+/* Types of entities saved to MongoDB */
+#define MONGO_SAVE_NODE			1
+#define MONGO_SAVE_TAGGROUP		2
+#define MONGO_SAVE_LAYER		3
+
 struct VS_CTX;
+struct VSNode;
+
+typedef struct VSMongoQueueItem {
+	uint32					node_id;			/* ID of queued node */
+	time_t					time;				/* Time, when node was queued */
+} VSMongoQueueItem;
+
+typedef struct VSMongoQueue {
+	struct VSMongoQueueItem	*items;				/* Ring buffer of queued nodes (NULL until first push) */
+	uint32					first;				/* Index of the oldest item */
+	uint32					count;				/* Number of queued items */
+	uint32					length;				/* Allocated length of ring buffer */
+} VSMongoQueue;
+
+/**
+ * Snapshot of one changed entity. Document is created, when server holds
+ * lock of data and it is written to MongoDB without this lock.
+ */
+typedef struct VSMongoSaveItem {
+	struct VSMongoSaveItem	*prev, *next;
+	uint8					type;				/* Type of entity (node, tag group or layer) */
+	uint8					insert;				/* Document is new and it will be inserted */
+	uint8					failed;				/* Writing of document failed */
+	uint32					node_id;			/* ID of node */
+	uint16					item_id;			/* ID of tag group or layer */
+	uint32					old_saved_version;	/* Saved version of entity before snapshot */
+	bson					cond;				/* Condition of update (not used for insert) */
+	bson					doc;				/* New document or update operation */
+} VSMongoSaveItem;
+
+/**
+ * Batch of snapshots written to MongoDB at once
+ */
+typedef struct VSMongoSaveBatch {
+	struct VListBase		items;
+	uint32					count;
+} VSMongoSaveBatch;
+
+struct VSMongoSaveItem *vs_mongo_save_item_add(struct VSMongoSaveBatch *batch,
+		uint8 type,
+		uint32 node_id,
+		uint16 item_id,
+		uint32 old_saved_version,
+		uint8 insert);
+
+void vs_mongo_node_dirty(struct VS_CTX *vs_ctx, struct VSNode *node);
+void vs_mongo_branch_dirty(struct VS_CTX *vs_ctx, struct VSNode *node);
+void vs_mongo_node_evictable(struct VS_CTX *vs_ctx, struct VSNode *node);
 
 int vs_mongo_context_save(struct VS_CTX *vs_ctx);
 int vs_mongo_context_load(struct VS_CTX *vs_ctx);
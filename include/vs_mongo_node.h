@@ -27,12 +27,19 @@
 #define VS_MONGO_NODE_H_
 
 struct VS_CTX;
+struct VSMongoSaveBatch;
 struct VSNode;
 
 int vs_mongo_node_node_exist(struct VS_CTX *vs_ctx,
 		uint32 node_id);
 
-int vs_mongo_node_save(struct VS_CTX *vs_ctx, struct VSNode *node);
+int vs_mongo_node_snapshot(struct VS_CTX *vs_ctx,
+		struct VSMongoSaveBatch *batch,
+		struct VSNode *node);
+
+int vs_mongo_node_load_data(struct VS_CTX *vs_ctx, struct VSNode *node);
+
+int vs_mongo_node_evict_data(struct VSNode *node);
 
 struct VSNode *vs_mongo_node_load_linked(struct VS_CTX *vs_ctx,
 		struct VSNode *parent_node,
@@ -27,10 +27,11 @@
 #define VS_MONGO_TAGGROUP_H_
 
 struct VS_CTX;
+struct VSMongoSaveBatch;
 struct VSNode;
 struct VSTagGroup;
 
-int vs_mongo_taggroup_save(struct VS_CTX *vs_ctx,
+int vs_mongo_taggroup_snapshot(struct VSMongoSaveBatch *batch,
 		struct VSNode *node,
 		struct VSTagGroup *tg);
 
@@ -30,6 +30,8 @@
 #ifndef VS_NODE_H_
 #define VS_NODE_H_
 
+#include <time.h>
+
 #include "verse_types.h"
 
 #include "v_session.h"
@@ -37,8 +39,12 @@
 #include "vs_main.h"
 #include "vs_user.h"
 #include "vs_entity.h"
+#include "vs_journal.h"
 
 #define VS_NODE_SAVEABLE	1	/* This flag specify that node should be saved */
+#define VS_NODE_UNLOADED	2	/* Tag groups and layers of node are stored only in MongoDB */
+#define VS_NODE_DIRTY		4	/* Node is queued for saving to MongoDB */
+#define VS_NODE_IDLE_QUEUED	8	/* Node is queued for eviction of data from memory */
 
 typedef struct VSNodeLock {
 	struct VSession			*session;
@@ -89,6 +95,12 @@ typedef struct VSNode {
 	uint32					version;		/* Current version of node */
 	uint32					saved_version;	/* Last saved version of node */
 	uint32					crc32;			/* CRC32 of node (not supported yet) */
+	struct VSJournal		child_journal;	/* Journal of linked and unlinked child nodes */
+	struct VSJournal		tg_journal;		/* Journal of created and destroyed tag groups */
+	struct VSJournal		layer_journal;	/* Journal of created and destroyed layers */
+#ifdef WITH_MONGODB
+	time_t					idle_since;		/* Time, when node lost last subscriber */
+#endif
 } VSNode;
 
 struct VSNode *vs_node_create_linked(struct VS_CTX *vs_ctx,
@@ -114,6 +126,8 @@ int vs_handle_node_prio(struct VS_CTX *vs_ctx,
 
 void vs_node_inc_version(struct VSNode *node);
 
+void vs_node_journal_reset(struct VSNode *node, uint32 version);
+
 int vs_node_is_created(struct VSNode *node);
 
 int vs_handle_node_unsubscribe(struct VS_CTX *vs_ctx,
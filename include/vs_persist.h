@@ -0,0 +1,172 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#ifndef VS_PERSIST_H_
+#define VS_PERSIST_H_
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "verse_types.h"
+
+/* Persistence engines */
+#define PERSIST_ENGINE_NONE			0
+#define PERSIST_ENGINE_WAL			1	/* Built-in snapshot + write-ahead log */
+
+/* Default directory with persistent data */
+#define PERSIST_DIRECTORY			"."
+
+/* Default period of creating snapshots (in seconds) */
+#define PERSIST_SNAPSHOT_INTERVAL	300
+
+/* Names of files in directory of persistent data */
+#define PERSIST_SNAPSHOT_FILE		"verse.snap"
+#define PERSIST_WAL_FILE			"verse.wal"
+
+#define PERSIST_SNAPSHOT_MAGIC		"VRSSNAP"
+#define PERSIST_FORMAT_VERSION		1
+
+/* Types of records stored in write-ahead log and snapshot */
+#define PERSIST_NODE_CREATE			1
+#define PERSIST_NODE_DESTROY		2
+#define PERSIST_NODE_LINK			3
+#define PERSIST_NODE_PERM			4
+#define PERSIST_NODE_OWNER			5
+#define PERSIST_TAGGROUP_CREATE		6
+#define PERSIST_TAGGROUP_DESTROY	7
+#define PERSIST_TAG_CREATE			8
+#define PERSIST_TAG_DESTROY			9
+#define PERSIST_TAG_SET				10
+#define PERSIST_LAYER_CREATE		11
+#define PERSIST_LAYER_DESTROY		12
+#define PERSIST_LAYER_SET			13
+#define PERSIST_LAYER_UNSET			14
+#define PERSIST_LAYER_VALUES		15	/* All items of layer (used only in snapshot) */
+
+/* Records are aligned to this size, then arrays of layer values could be
+ * used directly from mapped snapshot */
+#define PERSIST_RECORD_ALIGN		8
+
+struct VS_CTX;
+struct VSNode;
+struct VSUser;
+struct VSTagGroup;
+struct VSTag;
+struct VSLayer;
+
+/**
+ * Header of one record. Data of record (value of tag or layer item) follows
+ * the header.
+ */
+typedef struct VSPersistRecord {
+	uint32			size;			/* Size of record including header, data and padding */
+	uint32			checksum;		/* Checksum of record (only in write-ahead log) */
+	uint8			type;			/* Type of record */
+	uint8			data_type;		/* Data type of tag or layer */
+	uint8			count;			/* Count of values in tag or layer item */
+	uint8			reserved;
+	uint16			entity_id;		/* ID of tag group or layer */
+	uint16			custom_type;	/* Custom type of node, tag group, tag or layer */
+	uint32			node_id;		/* ID of node */
+	uint32			ref_id;			/* ID of user, parent node or parent layer */
+	uint32			item_id;		/* ID of tag, layer item, owner, permissions or count of items */
+	uint32			data_size;		/* Size of data following the header */
+} VSPersistRecord;
+
+/**
+ * Header of snapshot file
+ */
+typedef struct VSPersistSnapshotHeader {
+	char			magic[8];		/* PERSIST_SNAPSHOT_MAGIC */
+	uint32			format;			/* PERSIST_FORMAT_VERSION */
+	uint32			wal_seq;		/* The first log, that is not included in snapshot */
+	uint32			last_common_node_id;
+	uint32			record_count;	/* Number of records in snapshot */
+	uint64			size;			/* Size of snapshot including header */
+} VSPersistSnapshotHeader;
+
+/**
+ * Built-in persistence engine
+ */
+typedef struct VSPersist {
+	FILE			*wal;			/* Current write-ahead log */
+	uint32			wal_seq;		/* Sequence number of current log */
+	uint32			record_count;	/* Number of records in current log */
+	pid_t			snapshot_pid;	/* Process writing snapshot (0, when no snapshot is written) */
+	uint32			snapshot_seq;	/* The first log not included in snapshot written by this process */
+	pthread_mutex_t	mutex;			/* Mutex of write-ahead log */
+	pthread_t		thread;			/* Thread flushing log and writing snapshots */
+} VSPersist;
+
+int vs_persist_init(struct VS_CTX *vs_ctx);
+void vs_persist_destroy(struct VS_CTX *vs_ctx);
+void *vs_persist_loop(void *arg);
+
+void vs_persist_node_create(struct VS_CTX *vs_ctx, struct VSNode *node);
+void vs_persist_node_destroy(struct VS_CTX *vs_ctx, struct VSNode *node);
+void vs_persist_node_link(struct VS_CTX *vs_ctx, struct VSNode *node);
+void vs_persist_node_perm(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSUser *user,
+		uint8 permissions);
+void vs_persist_node_owner(struct VS_CTX *vs_ctx, struct VSNode *node);
+
+void vs_persist_taggroup_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg);
+void vs_persist_taggroup_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg);
+
+void vs_persist_tag_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag);
+void vs_persist_tag_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag);
+void vs_persist_tag_set(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag);
+
+void vs_persist_layer_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer);
+void vs_persist_layer_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer);
+void vs_persist_layer_set(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id,
+		const void *value);
+void vs_persist_layer_unset(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id);
+
+#endif /* VS_PERSIST_H_ */
@@ -29,6 +29,7 @@
 #include "v_list.h"
 
 #include "vs_node.h"
+#include "vs_journal.h"
 
 #define FIRST_TAGGROUP_ID		0
 #define LAST_TAGGROUP_ID		65534	/* 2^16 - 2 */
@@ -53,6 +54,7 @@ typedef struct VSTagGroup {
 	uint32					version;
 	uint32					saved_version;
 	uint32					crc32;
+	struct VSJournal		journal;		/* Journal of recent changes of tags */
 #ifdef WITH_MONGODB
 	bson_oid_t				oid;
 #endif
@@ -34,6 +34,11 @@
 
 #define DTLS_COOKIE_SECRET_LENGTH	16
 
+/* Results of handling events of datagram connection */
+#define VS_DGRAM_CONN_CLOSE			0
+#define VS_DGRAM_CONN_CONTINUE		1
+#define VS_DGRAM_CONN_RESTART		2
+
 #if OPENSSL_VERSION_NUMBER>=0x10000000
 int vs_dtls_generate_cookie(SSL *ssl, unsigned char *cookie, unsigned int *cookie_len);
 int vs_dtls_verify_cookie(SSL *ssl, unsigned char *cookie, unsigned int cookie_len);
@@ -42,6 +47,12 @@ void vs_init_dgram_conn(struct VDgramConn *dgram_conn);
 void vs_destroy_vconn(struct VDgramConn *dgram_conn);
 int vs_handle_packet(struct vContext *C, int vs_STATE_handle_packet(struct vContext*C));
 int vs_send_packet(struct vContext *C);
+int vs_dgram_conn_open(struct vContext *C);
+int vs_dgram_conn_handle_received(struct vContext *C);
+int vs_dgram_conn_receive(struct vContext *C);
+int vs_dgram_conn_update(struct vContext *C);
+void vs_dgram_conn_release(struct vContext *C);
+void vs_dgram_port_free(struct VS_CTX *vs_ctx, unsigned short port);
 void *vs_main_dgram_loop(void *arg);
 void vs_close_dgram_conn(struct VDgramConn *dgram_conn);
 
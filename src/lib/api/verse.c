@@ -53,6 +53,7 @@
 #include "v_node_commands.h"
 #include "v_tag_commands.h"
 #include "v_layer_commands.h"
+#include "v_delta.h"
 
 #include "vc_main.h"
 #include "vc_tcp_connect.h"
@@ -68,7 +69,9 @@ static int vc_send_command(const uint8 session_id,
 		struct Generic_Cmd *cmd);
 static int vc_init_VC_CTX(void);
 static void vc_call_callback_func(const uint8 session_id,
+		struct VSession *vsession,
 		struct Generic_Cmd *cmd);
+static uint8 vc_layer_subscribe_flags(const uint8 session_id);
 static void *vc_new_session_thread(void *arg);
 
 
@@ -285,9 +288,10 @@ int32_t vrs_send_node_subscribe(const uint8_t session_id,
 		const uint8_t prio,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
-	struct Generic_Cmd *node_subscribe_cmd = v_node_subscribe_create(node_id, version, crc32);
+	struct Generic_Cmd *node_subscribe_cmd = v_node_subscribe_create(node_id, version, crc32, epoch);
 	return vc_send_command(session_id, prio, node_subscribe_cmd);
 }
 
@@ -295,7 +299,8 @@ int32_t vrs_send_node_subscribe(const uint8_t session_id,
 void vrs_register_receive_node_subscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_node_subscribe = func;
@@ -307,7 +312,7 @@ int32_t vrs_send_node_unsubscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint8_t versing)
 {
-	struct Generic_Cmd *node_unsubscribe_cmd = v_node_unsubscribe_create(node_id, 0, versing);
+	struct Generic_Cmd *node_unsubscribe_cmd = v_node_unsubscribe_create(node_id, 0, 0, versing, 0);
 	return vc_send_command(session_id, prio, node_unsubscribe_cmd);
 }
 
@@ -315,7 +320,8 @@ int32_t vrs_send_node_unsubscribe(const uint8_t session_id,
 void vrs_register_receive_node_unsubscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_node_unsubscribe = func;
@@ -525,9 +531,10 @@ int32_t vrs_send_taggroup_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
-	struct Generic_Cmd *taggroup_subscribe_cmd = v_taggroup_subscribe_create(node_id, taggroup_id, version, crc32);
+	struct Generic_Cmd *taggroup_subscribe_cmd = v_taggroup_subscribe_create(node_id, taggroup_id, version, crc32, epoch);
 	return vc_send_command(session_id, prio, taggroup_subscribe_cmd);
 }
 
@@ -536,7 +543,8 @@ void vrs_register_receive_taggroup_subscribe(void (*func)(const uint8_t session_
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_taggroup_subscribe = func;
@@ -549,7 +557,7 @@ int32_t vrs_send_taggroup_unsubscribe(const uint8_t session_id,
 		const uint16_t taggroup_id,
 		const uint8_t versing)
 {
-	struct Generic_Cmd *taggroup_unsubscribe_cmd = v_taggroup_unsubscribe_create(node_id, taggroup_id, 0, versing);
+	struct Generic_Cmd *taggroup_unsubscribe_cmd = v_taggroup_unsubscribe_create(node_id, taggroup_id, 0, 0, versing, 0);
 	return vc_send_command(session_id, prio, taggroup_unsubscribe_cmd);
 }
 
@@ -558,7 +566,8 @@ void vrs_register_receive_taggroup_unsubscribe(void (*func)(const uint8_t sessio
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_taggroup_unsubscribe = func;
@@ -689,9 +698,29 @@ int32_t vrs_send_layer_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
-	struct Generic_Cmd *layer_subscribe_cmd = v_layer_subscribe_create(node_id, layer_id, version, crc32);
+	struct Generic_Cmd *layer_subscribe_cmd = v_layer_subscribe_create(node_id, layer_id, version,
+			crc32, VRS_LAYER_PRECISION_FULL, vc_layer_subscribe_flags(session_id), epoch);
+	return vc_send_command(session_id, prio, layer_subscribe_cmd);
+}
+
+
+/**
+ * \brief This function sends layer_subscribe command with requested
+ * precision of values.
+ */
+int32_t vrs_send_layer_subscribe_precision(const uint8_t session_id,
+		const uint8_t prio,
+		const uint32_t node_id,
+		const uint16_t layer_id,
+		const uint32_t version,
+		const uint8_t precision,
+		const uint32_t epoch)
+{
+	struct Generic_Cmd *layer_subscribe_cmd = v_layer_subscribe_create(node_id, layer_id, version,
+			0, precision, vc_layer_subscribe_flags(session_id), epoch);
 	return vc_send_command(session_id, prio, layer_subscribe_cmd);
 }
 
@@ -700,7 +729,8 @@ void vrs_register_receive_layer_subscribe(void (*func)(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_layer_subscribe = func;
@@ -713,7 +743,7 @@ int32_t vrs_send_layer_unsubscribe(const uint8_t session_id,
 		const uint16_t layer_id,
 		const uint8_t versing)
 {
-	struct Generic_Cmd *layer_unsubscribe_cmd = v_layer_unsubscribe_create(node_id, layer_id, 0, versing);
+	struct Generic_Cmd *layer_unsubscribe_cmd = v_layer_unsubscribe_create(node_id, layer_id, 0, 0, versing, 0);
 	return vc_send_command(session_id, prio, layer_unsubscribe_cmd);
 }
 
@@ -722,7 +752,8 @@ void vrs_register_receive_layer_unsubscribe(void (*func)(const uint8_t session_i
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32))
+		const uint32_t crc32,
+		const uint32_t epoch))
 {
 	vc_init_VC_CTX();
 	vc_ctx->vfs.receive_layer_unsubscribe = func;
@@ -979,7 +1010,7 @@ int32_t vrs_callback_update(const uint8_t session_id)
 				while(v_in_queue_cmd_count(vc_ctx->vsessions[i]->in_queue) > 0) {
 					cmd = v_in_queue_pop(vc_ctx->vsessions[i]->in_queue);
 
-					vc_call_callback_func(session_id, cmd);
+					vc_call_callback_func(session_id, vc_ctx->vsessions[i], cmd);
 
 					v_cmd_destroy(&cmd);
 				}
@@ -1034,6 +1065,85 @@ char *vrs_strerror(const uint32_t error_num)
 	return error_string;
 }
 
+/**
+ * \brief This function converts half precision float to single precision
+ * float
+ */
+float vrs_real16_to_real32(const uint16_t value)
+{
+	return v_real16_to_real32(value);
+}
+
+
+/**
+ * \brief This function returns flags of layer subscribe command. Layer
+ * values are requested as delta, when session was created with
+ * VRS_VALUE_DELTA flag.
+ */
+static uint8 vc_layer_subscribe_flags(const uint8 session_id)
+{
+	int i;
+
+	if(vc_ctx == NULL) {
+		return 0;
+	}
+
+	for(i=0; i<vc_ctx->max_sessions; i++) {
+		if(vc_ctx->vsessions[i]!=NULL &&
+				vc_ctx->vsessions[i]->session_id==session_id)
+		{
+			return (vc_ctx->vsessions[i]->flags & VRS_VALUE_DELTA) ?
+					LAYER_SUBSCRIBE_DELTA : 0;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * \brief This function decodes value of layer item received as delta and
+ * calls callback function for layer_set_value, when decoded value is the
+ * newest one.
+ */
+static void vc_receive_layer_set_delta(const uint8 session_id,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	uint8 data_type = (cmd->id - CMD_LAYER_SET_DELTA_UINT8)/4 + VRS_VALUE_TYPE_UINT8;
+	uint8 count = (cmd->id - CMD_LAYER_SET_DELTA_UINT8)%4 + 1;
+	uint16 value_size = count*v_delta_type_size(data_type);
+	uint64 value[4];
+
+	if(vsession->delta_recv == NULL) {
+		vsession->delta_recv = v_delta_recv_create();
+		if(vsession->delta_recv == NULL) {
+			return;
+		}
+	}
+
+	if(v_delta_recv_value(vsession->delta_recv,
+			UINT32(cmd->data[0]),
+			UINT16(cmd->data[UINT32_SIZE]),
+			UINT32(cmd->data[UINT32_SIZE + UINT16_SIZE]),
+			value_size,
+			UINT16(cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]),
+			UINT16(cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE]),
+			&cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE],
+			value) == 1)
+	{
+		if(vc_ctx->vfs.receive_layer_set_value != NULL) {
+			vc_ctx->vfs.receive_layer_set_value(session_id,
+					UINT32(cmd->data[0]),
+					UINT16(cmd->data[UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE + UINT16_SIZE]),
+					data_type,
+					count,
+					value);
+		}
+	}
+}
+
 
 /**
  * \brief This function is generic function for putting command to outgoing
@@ -1087,6 +1197,7 @@ static int vc_send_command(const uint8 session_id,
  * commands
  */
 static void vc_call_callback_func(const uint8 session_id,
+		struct VSession *vsession,
 		struct Generic_Cmd *cmd)
 {
 	switch(cmd->id) {
@@ -1121,6 +1232,9 @@ static void vc_call_callback_func(const uint8 session_id,
 		}
 		break;
 	case CMD_NODE_DESTROY:
+		v_delta_recv_remove(vsession->delta_recv,
+				UINT32(cmd->data[0]),
+				VRS_RESERVED_LAYER_ID);
 		if(vc_ctx->vfs.receive_node_destroy != NULL) {
 			vc_ctx->vfs.receive_node_destroy(session_id,
 					UINT32(cmd->data[0]));
@@ -1131,7 +1245,8 @@ static void vc_call_callback_func(const uint8 session_id,
 			vc_ctx->vfs.receive_node_subscribe(session_id,
 					UINT32(cmd->data[0]),
 					UINT32(cmd->data[UINT32_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE]));
 		}
 		break;
 	case CMD_NODE_UNSUBSCRIBE:
@@ -1139,7 +1254,8 @@ static void vc_call_callback_func(const uint8 session_id,
 			vc_ctx->vfs.receive_node_unsubscribe(session_id,
 					UINT32(cmd->data[0]),
 					UINT32(cmd->data[UINT32_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE + UINT8_SIZE]));
 		}
 		break;
 	case CMD_NODE_PERMISSION:
@@ -1199,7 +1315,8 @@ static void vc_call_callback_func(const uint8 session_id,
 					UINT32(cmd->data[0]),
 					UINT16(cmd->data[UINT32_SIZE]),
 					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE]));
 		}
 		break;
 	case CMD_TAGGROUP_UNSUBSCRIBE:
@@ -1208,7 +1325,8 @@ static void vc_call_callback_func(const uint8 session_id,
 					UINT32(cmd->data[0]),
 					UINT16(cmd->data[UINT32_SIZE]),
 					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE]));
 		}
 		break;
 	case CMD_TAG_CREATE:
@@ -1351,6 +1469,9 @@ static void vc_call_callback_func(const uint8 session_id,
 		}
 		break;
 	case CMD_LAYER_DESTROY:
+		v_delta_recv_remove(vsession->delta_recv,
+				UINT32(cmd->data[0]),
+				UINT16(cmd->data[UINT32_SIZE]));
 		if(vc_ctx->vfs.receive_layer_destroy != NULL) {
 			vc_ctx->vfs.receive_layer_destroy(session_id,
 					UINT32(cmd->data[0]),
@@ -1363,7 +1484,8 @@ static void vc_call_callback_func(const uint8 session_id,
 					UINT32(cmd->data[0]),
 					UINT16(cmd->data[UINT32_SIZE]),
 					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE+UINT8_SIZE]));
 		}
 		break;
 	case CMD_LAYER_UNSUBSCRIBE:
@@ -1372,7 +1494,8 @@ static void vc_call_callback_func(const uint8 session_id,
 					UINT32(cmd->data[0]),
 					UINT16(cmd->data[UINT32_SIZE]),
 					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE]),
-					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]));
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE]));
 		}
 		break;
 	case CMD_LAYER_UNSET_VALUE:
@@ -1481,6 +1604,36 @@ static void vc_call_callback_func(const uint8 session_id,
 					&cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]);
 		}
 		break;
+	case CMD_LAYER_SET_DELTA_UINT8:
+	case CMD_LAYER_SET_DELTA_VEC2_UINT8:
+	case CMD_LAYER_SET_DELTA_VEC3_UINT8:
+	case CMD_LAYER_SET_DELTA_VEC4_UINT8:
+	case CMD_LAYER_SET_DELTA_UINT16:
+	case CMD_LAYER_SET_DELTA_VEC2_UINT16:
+	case CMD_LAYER_SET_DELTA_VEC3_UINT16:
+	case CMD_LAYER_SET_DELTA_VEC4_UINT16:
+	case CMD_LAYER_SET_DELTA_UINT32:
+	case CMD_LAYER_SET_DELTA_VEC2_UINT32:
+	case CMD_LAYER_SET_DELTA_VEC3_UINT32:
+	case CMD_LAYER_SET_DELTA_VEC4_UINT32:
+	case CMD_LAYER_SET_DELTA_UINT64:
+	case CMD_LAYER_SET_DELTA_VEC2_UINT64:
+	case CMD_LAYER_SET_DELTA_VEC3_UINT64:
+	case CMD_LAYER_SET_DELTA_VEC4_UINT64:
+	case CMD_LAYER_SET_DELTA_REAL16:
+	case CMD_LAYER_SET_DELTA_VEC2_REAL16:
+	case CMD_LAYER_SET_DELTA_VEC3_REAL16:
+	case CMD_LAYER_SET_DELTA_VEC4_REAL16:
+	case CMD_LAYER_SET_DELTA_REAL32:
+	case CMD_LAYER_SET_DELTA_VEC2_REAL32:
+	case CMD_LAYER_SET_DELTA_VEC3_REAL32:
+	case CMD_LAYER_SET_DELTA_VEC4_REAL32:
+	case CMD_LAYER_SET_DELTA_REAL64:
+	case CMD_LAYER_SET_DELTA_VEC2_REAL64:
+	case CMD_LAYER_SET_DELTA_VEC3_REAL64:
+	case CMD_LAYER_SET_DELTA_VEC4_REAL64:
+		vc_receive_layer_set_delta(session_id, vsession, cmd);
+		break;
 	default:
 		v_print_log(VRS_PRINT_ERROR, "This command: %d is not supported yet\n", cmd->id);
 		break;
@@ -61,6 +61,7 @@
 #include "v_fake_commands.h"
 #include "v_session.h"
 #include "v_resend_mechanism.h"
+#include "v_compress.h"
 
 /************************************** REQUEST state **************************************/
 
@@ -237,13 +238,13 @@ static int vc_REQUEST_CONFIRM_L_cb(struct vContext *C, struct Generic_Cmd *cmd)
 
 	/* Server should confirm client proposal of Congestion Control (local) */
 	if(confirm_l_cmd->feature == FTR_CC_ID) {
-		/* TODO: better implementation */
 		if(confirm_l_cmd->count == 1 &&	/* Any confirm command has to include only one value */
-				confirm_l_cmd->value[0].uint8 == CC_NONE) {	/* list of supported methods */
+				(confirm_l_cmd->value[0].uint8 == CC_TCP_LIKE ||	/* list of supported methods */
+				 confirm_l_cmd->value[0].uint8 == CC_NONE)) {
 			v_print_log(VRS_PRINT_DEBUG_MSG,
 					"Local Congestion Control ID: %d confirmed\n",
 					confirm_l_cmd->value[0].uint8);
-			dgram_conn->cc_meth = CC_NONE;
+			dgram_conn->cc_meth = confirm_l_cmd->value[0].uint8;
 			return 1;
 		} else {
 			v_print_log(VRS_PRINT_ERROR, "Unsupported Congestion Control\n");
@@ -275,9 +276,7 @@ static int vc_REQUEST_CONFIRM_L_cb(struct vContext *C, struct Generic_Cmd *cmd)
 	/* Server should confirm client proposal of command compression */
 	if(confirm_l_cmd->feature == FTR_CMD_COMPRESS) {
 		if(confirm_l_cmd->count == 1) {
-			if(confirm_l_cmd->value[0].uint8 == CMPR_NONE ||
-					confirm_l_cmd->value[0].uint8 == CMPR_ADDR_SHARE)
-			{
+			if(v_compress_is_supported(confirm_l_cmd->value[0].uint8) == 1) {
 				v_print_log(VRS_PRINT_DEBUG_MSG, "Local Command Compression: %d confirmed\n",
 						confirm_l_cmd->value[0].uint8);
 				dgram_conn->host_cmd_cmpr = confirm_l_cmd->value[0].uint8;
@@ -304,13 +303,14 @@ static int vc_REQUEST_CONFIRM_R_cb(struct vContext *C, struct Generic_Cmd *cmd)
 
 	/* Server should confirm client proposal of Congestion Control (remote) */
 	if(confirm_r_cmd->feature == FTR_CC_ID) {
-		/* TODO: better implementation */
 		if(confirm_r_cmd->count == 1 &&	/* Any confirm command has to include only one value */
-				confirm_r_cmd->value[0].uint8 == CC_NONE) /* "List" of supported methods */
+				(confirm_r_cmd->value[0].uint8 == CC_TCP_LIKE ||	/* "List" of supported methods */
+				 confirm_r_cmd->value[0].uint8 == CC_NONE))
 		{
+			/* Congestion Control of server is used only at server, client
+			 * uses method confirmed in Confirm_L command */
 			v_print_log(VRS_PRINT_DEBUG_MSG, "Remote Congestion Control ID: %d confirmed\n",
 					confirm_r_cmd->value[0].uint8);
-			dgram_conn->cc_meth = CC_NONE;
 			return 1;
 		} else {
 			v_print_log(VRS_PRINT_ERROR, "Unsupported Congestion Control\n");
@@ -321,9 +321,7 @@ static int vc_REQUEST_CONFIRM_R_cb(struct vContext *C, struct Generic_Cmd *cmd)
 	/* Server should confirm client proposal of command compression */
 	if(confirm_r_cmd->feature == FTR_CMD_COMPRESS) {
 		if(confirm_r_cmd->count == 1) {
-			if(confirm_r_cmd->value[0].uint8 == CMPR_NONE ||
-					confirm_r_cmd->value[0].uint8 == CMPR_ADDR_SHARE)
-			{
+			if(v_compress_is_supported(confirm_r_cmd->value[0].uint8) == 1) {
 				v_print_log(VRS_PRINT_DEBUG_MSG, "Remote Command Compression: %d confirmed\n",
 						confirm_r_cmd->value[0].uint8);
 				dgram_conn->peer_cmd_cmpr = confirm_r_cmd->value[0].uint8;
@@ -346,8 +344,10 @@ void vc_REQUEST_init_send_packet(struct vContext *C)
 	struct VPacket *s_packet = CTX_s_packet(C);
 	int cmd_rank = 0;
 	static const uint8 cc_none = CC_NONE,
+			cc_tcp_like = CC_TCP_LIKE,
 			cmpr_none = CMPR_NONE,
-			cmpr_addr_share = CMPR_ADDR_SHARE;
+			cmpr_addr_share = CMPR_ADDR_SHARE,
+			cmpr_deflate = CMPR_DEFLATE;
 
 	/* Verse packet header */
 	s_packet->header.version = 1;
@@ -366,11 +366,11 @@ void vc_REQUEST_init_send_packet(struct vContext *C)
 
 	/* Add CC (local) proposal */
 	cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
-			CMD_CHANGE_L_ID, FTR_CC_ID, &cc_none, NULL);
+			CMD_CHANGE_L_ID, FTR_CC_ID, &cc_tcp_like, &cc_none, NULL);
 
 	/* Add CC (remote) proposal */
 	cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
-			CMD_CHANGE_R_ID, FTR_CC_ID, &cc_none, NULL);
+			CMD_CHANGE_R_ID, FTR_CC_ID, &cc_tcp_like, &cc_none, NULL);
 
 	/* Add Scale Window proposal */
 	cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
@@ -384,6 +384,16 @@ void vc_REQUEST_init_send_packet(struct vContext *C)
 		/* Client isn't able to receive compressed commands (remote proposal) */
 		cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
 				CMD_CHANGE_R_ID, FTR_CMD_COMPRESS, &cmpr_none, NULL);
+	} else if((vsession->flags & VRS_CMD_CMPR_DEFLATE) &&
+			v_compress_is_supported(CMPR_DEFLATE) == 1)
+	{
+		/* Client wants to send commands compressed with deflate. Address
+		 * sharing is proposed for servers without support of deflate */
+		cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
+				CMD_CHANGE_L_ID, FTR_CMD_COMPRESS, &cmpr_deflate, &cmpr_addr_share, NULL);
+		/* Client is able to receive commands compressed with deflate */
+		cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
+				CMD_CHANGE_R_ID, FTR_CMD_COMPRESS, &cmpr_deflate, &cmpr_addr_share, NULL);
 	} else {
 		/* Client wants to send compressed commands (local proposal) */
 		cmd_rank += v_add_negotiate_cmd(s_packet->sys_cmd, cmd_rank,
@@ -0,0 +1,334 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+/*
+ * This program generates specialised functions for packing and unpacking of
+ * node commands. It is run during build and the only input is the table
+ * cmd_struct[] describing all commands (v_cmd_struct.c). Generated functions
+ * do the same as generic v_cmd_pack() and _v_cmd_unpack_items(), but types,
+ * sizes and offsets of items are constants known to compiler.
+ *
+ * Usage: v_cmd_gen <output_file.c>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+
+#include "verse_types.h"
+
+#include "v_commands.h"
+
+extern const struct Cmd_Struct cmd_struct[];
+
+static const char *license = "\
+/*\n\
+ * This file was generated by v_cmd_gen from table cmd_struct[]\n\
+ * (src/lib/common/v_cmd_struct.c). Do not edit it.\n\
+ */\n\
+\n\
+#include <stddef.h>\n\
+\n\
+#include \"verse_types.h\"\n\
+\n\
+#include \"v_commands.h\"\n\
+#include \"v_cmd_codec.h\"\n\
+#include \"v_pack.h\"\n\
+#include \"v_unpack.h\"\n\
+\n";
+
+/**
+ * \brief This function returns suffix of pack/unpack functions for the item
+ * type or NULL, when item could not be packed with these functions.
+ */
+static const char *v_gen_type_name(const enum Cmd_Item_Type type)
+{
+	switch(type) {
+	case ITEM_INT8:
+	case ITEM_UINT8:
+		return "uint8";
+	case ITEM_INT16:
+	case ITEM_UINT16:
+		return "uint16";
+	case ITEM_INT32:
+	case ITEM_UINT32:
+		return "uint32";
+	case ITEM_INT64:
+	case ITEM_UINT64:
+		return "uint64";
+	case ITEM_REAL16:
+		return "real16";
+	case ITEM_REAL32:
+		return "real32";
+	case ITEM_REAL64:
+		return "real64";
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * \brief This function returns number of items starting at first_item with
+ * the same type stored in continuous block of memory (see
+ * _v_cmd_items_array_len() in v_commands.c).
+ */
+static int v_gen_array_len(const struct Cmd_Struct *cmd_str, int first_item)
+{
+	const struct Cmd_Item *item = &cmd_str->items[first_item];
+	int j;
+
+	if(v_gen_type_name(item->type) == NULL ||
+			(item->size != 2 && item->size != 4 && item->size != 8))
+	{
+		return 1;
+	}
+
+	for(j = first_item + 1;
+			j < cmd_str->item_count &&
+			cmd_str->items[j].type == item->type &&
+			cmd_str->items[j].offset == item->offset + (j - first_item)*item->size;
+			j++)
+	{
+	}
+
+	return j - first_item;
+}
+
+/**
+ * \brief This function writes name of the function for the command to the
+ * file (e.g.: _v_cmd_pack_node_create)
+ */
+static void v_gen_func_name(FILE *file, const char *prefix,
+		const struct Cmd_Struct *cmd_str)
+{
+	const char *c;
+
+	fprintf(file, "_v_cmd_%s_", prefix);
+	for(c = cmd_str->name; *c != '\0'; c++) {
+		fputc(tolower((unsigned char)*c), file);
+	}
+}
+
+/**
+ * \brief This function checks, if it is possible to generate functions for
+ * this command.
+ */
+static int v_gen_cmd_supported(const struct Cmd_Struct *cmd_str, int unpack)
+{
+	int i;
+
+	if(!(cmd_str->flag & NODE_CMD) || cmd_str->item_count == 0) {
+		return 0;
+	}
+
+	/* Commands with variable length are unpacked by generic code */
+	if(unpack == 1 && (cmd_str->flag & VAR_LEN)) {
+		return 0;
+	}
+
+	for(i = 0; i < cmd_str->item_count; i++) {
+		if(cmd_str->items[i].type == ITEM_STRING8) {
+			if(unpack == 1) {
+				return 0;
+			}
+		} else if(v_gen_type_name(cmd_str->items[i].type) == NULL) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function generates code for packing or unpacking of items
+ * starting at the item with index first_item
+ */
+static void v_gen_items(FILE *file, const struct Cmd_Struct *cmd_str,
+		int first_item, int last_item, int unpack, const char *indent)
+{
+	const struct Cmd_Item *item;
+	int i, count;
+
+	for(i = first_item; i < last_item; i += count) {
+		item = &cmd_str->items[i];
+		count = (i < cmd_str->key_count) ? 1 : v_gen_array_len(cmd_str, i);
+
+		if(count > 1) {
+			fprintf(file, "%s/* %s .. %s */\n", indent, item->name,
+					cmd_str->items[i + count - 1].name);
+			fprintf(file, "%sbuffer_pos += vnp_raw_%s_uint%d_array(&buffer[buffer_pos], &cmd->data[%d], %d);\n",
+					indent, (unpack == 1) ? "unpack" : "pack",
+					item->size * 8, item->offset, count);
+		} else if(item->type == ITEM_STRING8) {
+			fprintf(file, "%sbuffer_pos += vnp_raw_pack_string8(&buffer[buffer_pos], PTR(cmd->data[%d]));\t/* %s */\n",
+					indent, item->offset, item->name);
+		} else if(unpack == 1) {
+			fprintf(file, "%sbuffer_pos += vnp_raw_unpack_%s(&buffer[buffer_pos], (%s*)&cmd->data[%d]);\t/* %s */\n",
+					indent, v_gen_type_name(item->type), v_gen_type_name(item->type),
+					item->offset, item->name);
+		} else {
+			const char *type = v_gen_type_name(item->type);
+			char macro[8];
+			int j;
+
+			for(j = 0; j < (int)sizeof(macro) - 1 && type[j] != '\0'; j++) {
+				macro[j] = toupper((unsigned char)type[j]);
+			}
+			macro[j] = '\0';
+
+			fprintf(file, "%sbuffer_pos += vnp_raw_pack_%s(&buffer[buffer_pos], %s(cmd->data[%d]));\t/* %s */\n",
+					indent, type, macro, item->offset, item->name);
+		}
+	}
+}
+
+/**
+ * \brief This function generates function packing or unpacking one command
+ */
+static void v_gen_cmd_func(FILE *file, const struct Cmd_Struct *cmd_str,
+		int unpack)
+{
+	int i;
+
+	fprintf(file, "/**\n * \\brief %s items of %s command (ID: %d)\n */\n",
+			(unpack == 1) ? "Unpack" : "Pack", cmd_str->name, cmd_str->id);
+	if(unpack == 1) {
+		fprintf(file, "static uint32 ");
+		v_gen_func_name(file, "unpack", cmd_str);
+		fprintf(file, "(const char *buffer,\n\t\tstruct Generic_Cmd *cmd,\n\t\tconst int first_item)\n{\n");
+		fprintf(file, "\tuint32 buffer_pos = 0;\n\n");
+	} else {
+		fprintf(file, "static uint16 ");
+		v_gen_func_name(file, "pack", cmd_str);
+		fprintf(file, "(char *buffer,\n\t\tconst struct Generic_Cmd *cmd,\n\t\tconst int first_item)\n{\n");
+		fprintf(file, "\tuint16 buffer_pos = 0;\n\n");
+	}
+
+	/* Items of address could be shared with previous command */
+	if(cmd_str->flag & SHARE_ADDR && cmd_str->key_count > 0) {
+		fprintf(file, "\tswitch(first_item) {\n");
+		for(i = 0; i < cmd_str->key_count; i++) {
+			fprintf(file, "\tcase %d:\n", i);
+			v_gen_items(file, cmd_str, i, i + 1, unpack, "\t\t");
+			fprintf(file, "\t\t/* Falls through. */\n");
+		}
+		fprintf(file, "\tdefault:\n\t\tbreak;\n\t}\n\n");
+		v_gen_items(file, cmd_str, cmd_str->key_count, cmd_str->item_count,
+				unpack, "\t");
+	} else {
+		fprintf(file, "\t(void)first_item;\n\n");
+		v_gen_items(file, cmd_str, 0, cmd_str->item_count, unpack, "\t");
+	}
+
+	fprintf(file, "\n\treturn buffer_pos;\n}\n\n");
+}
+
+/**
+ * \brief This function generates table of functions
+ */
+static void v_gen_func_table(FILE *file, int unpack)
+{
+	int id;
+
+	fprintf(file, "const %s v_cmd_%s_funcs[MAX_CMD_ID+1] = {\n",
+			(unpack == 1) ? "VCmdUnpackFunc" : "VCmdPackFunc",
+			(unpack == 1) ? "unpack" : "pack");
+	for(id = 0; id <= MAX_CMD_ID; id++) {
+		if(v_gen_cmd_supported(&cmd_struct[id], unpack)) {
+			fprintf(file, "\t\t");
+			v_gen_func_name(file, (unpack == 1) ? "unpack" : "pack", &cmd_struct[id]);
+			fprintf(file, ",\t/* %d */\n", id);
+		} else {
+			fprintf(file, "\t\tNULL,\t/* %d */\n", id);
+		}
+	}
+	fprintf(file, "};\n\n");
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *file;
+	int id, unpack;
+
+	if(argc != 2) {
+		fprintf(stderr, "Usage: %s <output_file.c>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/* Names of generated functions are derived from names of commands */
+	for(id = 0; id <= MAX_CMD_ID; id++) {
+		int i;
+
+		if(!(cmd_struct[id].flag & NODE_CMD)) {
+			continue;
+		}
+
+		for(i = id + 1; i <= MAX_CMD_ID; i++) {
+			if((cmd_struct[i].flag & NODE_CMD) &&
+					strcmp(cmd_struct[id].name, cmd_struct[i].name) == 0)
+			{
+				fprintf(stderr, "Commands %d and %d have the same name: %s\n",
+						id, i, cmd_struct[id].name);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	file = fopen(argv[1], "w");
+	if(file == NULL) {
+		perror("fopen()");
+		return EXIT_FAILURE;
+	}
+
+	fprintf(file, "%s", license);
+
+	for(unpack = 0; unpack <= 1; unpack++) {
+		for(id = 0; id <= MAX_CMD_ID; id++) {
+			if(v_gen_cmd_supported(&cmd_struct[id], unpack)) {
+				v_gen_cmd_func(file, &cmd_struct[id], unpack);
+			}
+		}
+		v_gen_func_table(file, unpack);
+	}
+
+	if(fclose(file) != 0) {
+		perror("fclose()");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
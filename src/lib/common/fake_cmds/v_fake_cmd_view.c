@@ -0,0 +1,103 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2012, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+
+#include "v_common.h"
+#include "v_commands.h"
+#include "v_fake_commands.h"
+#include "v_slab.h"
+
+/**
+ * \brief This function print content of fake command Cmd_View.
+ */
+void v_fake_cmd_view_print(const unsigned char level,
+		const struct Generic_Cmd *cmd)
+{
+	struct Cmd_View_Cmd *view = (struct Cmd_View_Cmd *)cmd;
+	v_print_log_simple(level, "\tCmd_View: Cmd_ID: %d, Count: %d, Share: %d, Offset: %d\n",
+			view->cmd_id,
+			view->count,
+			view->share,
+			view->offset);
+}
+
+/**
+ * \brief This function creates new view of commands in receive buffer. View
+ * holds reference at the buffer.
+ *
+ * \param[in]	*buffer		The receive buffer
+ * \param[in]	offset		The offset of the first command in the buffer
+ * \param[in]	cmd_id		The ID of commands
+ * \param[in]	share		The size of address shared by all commands
+ * \param[in]	skip_items	The count of items in shared address
+ * \param[in]	count		The count of commands
+ */
+struct Generic_Cmd *v_fake_cmd_view_create(struct VCmdBuffer *buffer,
+		uint16 offset,
+		uint8 cmd_id,
+		uint8 share,
+		uint8 skip_items,
+		uint16 count)
+{
+	struct Cmd_View_Cmd *view = NULL;
+
+	view = (struct Cmd_View_Cmd*)v_slab_calloc(sizeof(struct Cmd_View_Cmd));
+	if(view != NULL) {
+		view->id = FAKE_CMD_CMD_VIEW;
+		view->cmd_id = cmd_id;
+		view->share = share;
+		view->skip_items = skip_items;
+		view->count = count;
+		view->offset = offset;
+		view->buffer = v_cmd_buffer_ref(buffer);
+	}
+
+	return (struct Generic_Cmd *)view;
+}
+
+/**
+ * \brief This function destroy Cmd_View command and it drops reference at
+ * receive buffer.
+ */
+void v_fake_cmd_view_destroy(struct Generic_Cmd **cmd)
+{
+	struct Cmd_View_Cmd **view = (struct Cmd_View_Cmd **)cmd;
+	if(view != NULL && *view != NULL) {
+		v_cmd_buffer_release(&(*view)->buffer);
+		v_slab_free(*view, sizeof(struct Cmd_View_Cmd));
+		*view = NULL;
+	}
+}
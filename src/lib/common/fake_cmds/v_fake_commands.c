@@ -85,6 +85,12 @@ void v_fake_cmd_print(const unsigned char level,
 	case FAKE_CMD_LAYER_DESTROY_ACK:
 		v_fake_layer_destroy_ack_print(level, cmd);
 		break;
+	case FAKE_CMD_LAYER_SET_ACK:
+		v_fake_layer_set_ack_print(level, cmd);
+		break;
+	case FAKE_CMD_CMD_VIEW:
+		v_fake_cmd_view_print(level, cmd);
+		break;
 	default:
 		v_print_log_simple(level, "This fake command ID: %d is not supported yet\n", cmd->id);
 		break;
@@ -136,6 +142,12 @@ void v_fake_cmd_destroy(struct Generic_Cmd **cmd)
 	case FAKE_CMD_LAYER_DESTROY_ACK:
 		v_fake_layer_destroy_ack_destroy(cmd);
 		break;
+	case FAKE_CMD_LAYER_SET_ACK:
+		v_fake_layer_set_ack_destroy(cmd);
+		break;
+	case FAKE_CMD_CMD_VIEW:
+		v_fake_cmd_view_destroy(cmd);
+		break;
 	default:
 		v_print_log(VRS_PRINT_ERROR, "This fake command id: %d could not be destroyed\n", (*cmd)->id);
 		assert(0);
@@ -164,6 +176,9 @@ int v_fake_cmd_struct_size(const struct Generic_Cmd *cmd)
 	case FAKE_CMD_FPS:
 		size = sizeof(struct Fps_Cmd);
 		break;
+	case FAKE_CMD_CMD_VIEW:
+		size = sizeof(struct Cmd_View_Cmd);
+		break;
 	default:
 		v_print_log_simple(VRS_PRINT_WARNING, "This fake command ID: %d is not supported yet\n", cmd->id);
 		assert(0);
@@ -349,6 +364,33 @@ struct VCommandQueue *v_fake_cmd_queue_create(uint8 id, uint8 copy_bucket, uint8
 				cmd_queue = NULL;
 			}
 			break;
+		case FAKE_CMD_LAYER_SET_ACK:
+			if(fake_cmds==1) {
+				cmd_queue = (struct VCommandQueue*)calloc(1, sizeof(struct VCommandQueue));
+				cmd_queue->item_size = sizeof(struct Layer_Set_Ack_Cmd);
+				cmd_queue->flag = 0;
+				v_hash_array_init(&cmd_queue->cmds,
+						HASH_MOD_256  | flag,
+						0,
+						cmd_queue->item_size);
+			} else {
+				cmd_queue = NULL;
+			}
+			break;
+		case FAKE_CMD_CMD_VIEW:
+			/* View of commands in receive buffer. Views are never
+			 * replaced, then order of commands is kept. */
+			if(fake_cmds==1) {
+				cmd_queue = (struct VCommandQueue*)calloc(1, sizeof(struct VCommandQueue));
+				cmd_queue->item_size = sizeof(struct Cmd_View_Cmd);
+				cmd_queue->flag = 0;
+				v_hash_array_init(&cmd_queue->cmds,
+						HASH_MOD_256  | flag,
+						0,
+						cmd_queue->item_size);
+			} else {
+				cmd_queue = NULL;
+			}
 			break;
 		default:
 			cmd_queue = NULL;
@@ -0,0 +1,112 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2012, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+
+#include "v_common.h"
+#include "v_fake_commands.h"
+
+/**
+ * \brief This function print content of fake command Layer_Set_Ack.
+ */
+void v_fake_layer_set_ack_print(const unsigned char level,
+		const struct Generic_Cmd *cmd)
+{
+	struct Layer_Set_Ack_Cmd *layer_set_ack = (struct Layer_Set_Ack_Cmd *)cmd;
+	v_print_log_simple(level, "\tLayer_Set_Ack: Node_ID: %d, Layer_ID: %d, Item_ID: %d, Seq: %d\n",
+			layer_set_ack->node_id,
+			layer_set_ack->layer_id,
+			layer_set_ack->item_id,
+			layer_set_ack->seq);
+}
+
+/**
+ * \brief This function initialize members of structure for Layer_Set_Ack command
+ */
+static void v_fake_layer_set_ack_init(struct Layer_Set_Ack_Cmd *layer_set_ack,
+		uint32 node_id,
+		uint16 layer_id,
+		uint32 item_id,
+		uint16 seq)
+{
+    if(layer_set_ack != NULL) {
+        /* initialize members with values */
+    	layer_set_ack->id = FAKE_CMD_LAYER_SET_ACK;
+    	layer_set_ack->node_id = node_id;
+    	layer_set_ack->layer_id = layer_id;
+    	layer_set_ack->item_id = item_id;
+    	layer_set_ack->seq = seq;
+    }
+}
+
+/**
+ * \brief this function creates new structure of Layer_Set_Ack command
+ */
+struct Generic_Cmd *v_fake_layer_set_ack_create(uint32 node_id,
+		uint16 layer_id,
+		uint32 item_id,
+		uint16 seq)
+{
+    struct Layer_Set_Ack_Cmd *layer_set_ack = NULL;
+    layer_set_ack = (struct Layer_Set_Ack_Cmd*)calloc(1, sizeof(struct Layer_Set_Ack_Cmd));
+    v_fake_layer_set_ack_init(layer_set_ack, node_id, layer_id, item_id, seq);
+    return (struct Generic_Cmd *)layer_set_ack;
+}
+
+/**
+ * \brief This function clear members of structure for Layer_Set_Ack command
+ */
+static void v_fake_layer_set_ack_clear(struct Layer_Set_Ack_Cmd *layer_set_ack)
+{
+    if(layer_set_ack != NULL) {
+        layer_set_ack->node_id = -1;
+        layer_set_ack->layer_id = -1;
+        layer_set_ack->item_id = -1;
+        layer_set_ack->seq = -1;
+    }
+}
+
+/**
+ * \brief This function destroy Layer_Set_Ack command
+ */
+void v_fake_layer_set_ack_destroy(struct Generic_Cmd **cmd)
+{
+	struct Layer_Set_Ack_Cmd **layer_set_ack = (struct Layer_Set_Ack_Cmd **)cmd;
+    if(layer_set_ack != NULL) {
+        v_fake_layer_set_ack_clear(*layer_set_ack);
+        free(*layer_set_ack);
+        *layer_set_ack = NULL;
+    }
+}
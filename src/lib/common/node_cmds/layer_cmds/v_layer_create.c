@@ -76,7 +76,7 @@ struct Generic_Cmd *v_layer_create_create(const uint32 node_id,
 		const uint16 type)
 {
 	struct Generic_Cmd *layer_create = NULL;
-	layer_create = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_LAYER_CREATE].size);
+	layer_create = v_cmd_alloc(CMD_LAYER_CREATE);
 	_v_layer_create_init(layer_create, node_id, parent_layer_id, layer_id, data_type, count, type);
 	return layer_create;
 }
@@ -64,7 +64,7 @@ struct Generic_Cmd *v_layer_destroy_create(const uint32 node_id,
 		const uint16 layer_id)
 {
 	struct Generic_Cmd *layer_destroy = NULL;
-	layer_destroy = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_LAYER_DESTROY].size);
+	layer_destroy = v_cmd_alloc(CMD_LAYER_DESTROY);
 	_v_layer_destroy_init(layer_destroy, node_id, layer_id);
 	return layer_destroy;
 }
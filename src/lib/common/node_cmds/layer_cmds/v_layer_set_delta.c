@@ -0,0 +1,94 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2012, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <assert.h>
+
+#include "v_layer_commands.h"
+#include "v_commands.h"
+#include "v_common.h"
+#include "v_delta.h"
+
+extern struct Cmd_Struct cmd_struct[];
+
+/**
+ * \brief This function initialize values of command Layer_Set_Delta
+ *
+ * The value is already XORed with value with sequence number base (when base
+ * is equal to seq, then value is complete value). Delta of real values is
+ * sent as unsigned integer of the same size.
+ */
+struct Generic_Cmd *v_layer_set_delta_create(const uint32 node_id,
+		const uint16 layer_id,
+		const uint32 item_id,
+		const uint8 data_type,
+		const uint8 count,
+		const uint16 seq,
+		const uint16 base,
+		const void *value)
+{
+	int cmd_id;
+	struct Generic_Cmd *layer_set;
+
+	assert(count>=1 && count<=4);
+	assert(data_type>=VRS_VALUE_TYPE_UINT8 && data_type<=VRS_VALUE_TYPE_REAL64);
+
+	cmd_id = CMD_LAYER_SET_DELTA_UINT8 + 4*(data_type-1) + (count-1);
+
+	layer_set = v_cmd_alloc(cmd_id);
+
+	if(layer_set == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return NULL;
+	}
+
+	layer_set->id = cmd_id;
+	UINT32(layer_set->data[0]) = node_id;
+	UINT16(layer_set->data[UINT32_SIZE]) = layer_id;
+	UINT32(layer_set->data[UINT32_SIZE + UINT16_SIZE]) = item_id;
+	UINT16(layer_set->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]) = seq;
+	UINT16(layer_set->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE]) = base;
+
+	/* Items of delta are unsigned integers with the same size as type of
+	 * value, then it is possible to copy values at once */
+	memcpy(&layer_set->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE],
+			value, count*v_delta_type_size(data_type));
+
+	return layer_set;
+}
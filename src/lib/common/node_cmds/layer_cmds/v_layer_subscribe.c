@@ -49,7 +49,10 @@ static void _v_layer_subscribe_init(struct Generic_Cmd *layer_subscribe,
 		const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 precision,
+		const uint8 flags,
+		const uint32 epoch)
 {
 	if(layer_subscribe != NULL) {
 		layer_subscribe->id = CMD_LAYER_SUBSCRIBE;
@@ -57,6 +60,9 @@ static void _v_layer_subscribe_init(struct Generic_Cmd *layer_subscribe,
 		UINT16(layer_subscribe->data[UINT32_SIZE]) = layer_id;
 		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE]) = version;
 		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]) = crc32;
+		UINT8(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE]) = precision;
+		UINT8(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT8_SIZE]) = flags;
+		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT8_SIZE + UINT8_SIZE]) = epoch;
 	}
 }
 
@@ -67,10 +73,13 @@ static void _v_layer_subscribe_init(struct Generic_Cmd *layer_subscribe,
 struct Generic_Cmd *v_layer_subscribe_create(const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 precision,
+		const uint8 flags,
+		const uint32 epoch)
 {
 	struct Generic_Cmd *layer_subscribe = NULL;
-	layer_subscribe = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_LAYER_SUBSCRIBE].size);
-	_v_layer_subscribe_init(layer_subscribe, node_id, layer_id, version, crc32);
+	layer_subscribe = v_cmd_alloc(CMD_LAYER_SUBSCRIBE);
+	_v_layer_subscribe_init(layer_subscribe, node_id, layer_id, version, crc32, precision, flags, epoch);
 	return layer_subscribe;
 }
@@ -49,7 +49,9 @@ static void _v_layer_unsubscribe_init(struct Generic_Cmd *layer_subscribe,
 		const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch)
 {
 	if(layer_subscribe != NULL) {
 		layer_subscribe->id = CMD_LAYER_UNSUBSCRIBE;
@@ -57,6 +59,8 @@ static void _v_layer_unsubscribe_init(struct Generic_Cmd *layer_subscribe,
 		UINT16(layer_subscribe->data[UINT32_SIZE]) = layer_id;
 		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE]) = version;
 		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]) = crc32;
+		UINT8(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE]) = versing;
+		UINT32(layer_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT8_SIZE]) = epoch;
 	}
 }
 
@@ -67,10 +71,12 @@ static void _v_layer_unsubscribe_init(struct Generic_Cmd *layer_subscribe,
 struct Generic_Cmd *v_layer_unsubscribe_create(const uint32 node_id,
 		const uint16 layer_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch)
 {
 	struct Generic_Cmd *layer_subscribe = NULL;
-	layer_subscribe = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_LAYER_SUBSCRIBE].size);
-	_v_layer_unsubscribe_init(layer_subscribe, node_id, layer_id, version, crc32);
+	layer_subscribe = v_cmd_alloc(CMD_LAYER_UNSUBSCRIBE);
+	_v_layer_unsubscribe_init(layer_subscribe, node_id, layer_id, version, crc32, versing, epoch);
 	return layer_subscribe;
 }
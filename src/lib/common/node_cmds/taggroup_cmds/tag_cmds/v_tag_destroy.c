@@ -67,7 +67,7 @@ struct Generic_Cmd *v_tag_destroy_create(const uint32 node_id,
 		const uint16 tag_id)
 {
 	struct Generic_Cmd *tag_destroy = NULL;
-	tag_destroy = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_TAG_DESTROY].size);
+	tag_destroy = v_cmd_alloc(CMD_TAG_DESTROY);
 	_v_tag_destroy_init(tag_destroy, node_id, taggroup_id, tag_id);
 	return tag_destroy;
 }
@@ -62,8 +62,7 @@ struct Generic_Cmd *v_tag_set_create(const uint32 node_id,
 	/* Tricky part :-) */
 	cmd_id = CMD_TAG_SET_UINT8 + 4*(data_type-1) + (count-1);
 
-	tag_set = (struct Generic_Cmd *)malloc(UINT8_SIZE +
-			cmd_struct[cmd_id].size);
+	tag_set = v_cmd_alloc(cmd_id);
 
 	if(tag_set == NULL) {
 		return NULL;
@@ -47,7 +47,8 @@ static void _v_taggroup_subscribe_init(struct Generic_Cmd *taggroup_subscribe,
 		uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint32 epoch)
 {
 	if(taggroup_subscribe != NULL) {
 		taggroup_subscribe->id = CMD_TAGGROUP_SUBSCRIBE;
@@ -55,6 +56,7 @@ static void _v_taggroup_subscribe_init(struct Generic_Cmd *taggroup_subscribe,
 		UINT16(taggroup_subscribe->data[UINT32_SIZE]) = taggroup_id;
 		UINT32(taggroup_subscribe->data[UINT32_SIZE+UINT16_SIZE]) = version;
 		UINT32(taggroup_subscribe->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]) = crc32;
+		UINT32(taggroup_subscribe->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE]) = epoch;
 	}
 }
 
@@ -64,10 +66,11 @@ static void _v_taggroup_subscribe_init(struct Generic_Cmd *taggroup_subscribe,
 struct Generic_Cmd *v_taggroup_subscribe_create(uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint32 epoch)
 {
 	struct Generic_Cmd *taggroup_subscribe = NULL;
-	taggroup_subscribe = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_TAGGROUP_SUBSCRIBE].size);
-	_v_taggroup_subscribe_init(taggroup_subscribe, node_id, taggroup_id, version, crc32);
+	taggroup_subscribe = v_cmd_alloc(CMD_TAGGROUP_SUBSCRIBE);
+	_v_taggroup_subscribe_init(taggroup_subscribe, node_id, taggroup_id, version, crc32, epoch);
 	return taggroup_subscribe;
 }
@@ -47,7 +47,9 @@ static void _v_taggroup_unsubscribe_init(struct Generic_Cmd *taggroup_unsubscrib
 		uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint8 versing,
+		uint32 epoch)
 {
 	if(taggroup_unsubscribe != NULL) {
 		taggroup_unsubscribe->id = CMD_TAGGROUP_UNSUBSCRIBE;
@@ -55,6 +57,8 @@ static void _v_taggroup_unsubscribe_init(struct Generic_Cmd *taggroup_unsubscrib
 		UINT16(taggroup_unsubscribe->data[UINT32_SIZE]) = taggroup_id;
 		UINT32(taggroup_unsubscribe->data[UINT32_SIZE+UINT16_SIZE]) = version;
 		UINT32(taggroup_unsubscribe->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]) = crc32;
+		UINT8(taggroup_unsubscribe->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE]) = versing;
+		UINT32(taggroup_unsubscribe->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE]) = epoch;
 	}
 }
 
@@ -64,10 +68,12 @@ static void _v_taggroup_unsubscribe_init(struct Generic_Cmd *taggroup_unsubscrib
 struct Generic_Cmd *v_taggroup_unsubscribe_create(uint32 node_id,
 		uint16 taggroup_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint8 versing,
+		uint32 epoch)
 {
 	struct Generic_Cmd *taggroup_unsubscribe = NULL;
-	taggroup_unsubscribe = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_TAGGROUP_UNSUBSCRIBE].size);
-	_v_taggroup_unsubscribe_init(taggroup_unsubscribe, node_id, taggroup_id, version, crc32);
+	taggroup_unsubscribe = v_cmd_alloc(CMD_TAGGROUP_UNSUBSCRIBE);
+	_v_taggroup_unsubscribe_init(taggroup_unsubscribe, node_id, taggroup_id, version, crc32, versing, epoch);
 	return taggroup_unsubscribe;
 }
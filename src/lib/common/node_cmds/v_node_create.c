@@ -69,7 +69,7 @@ struct Generic_Cmd *v_node_create_create(uint32 node_id,
 		uint16 type)
 {
 	struct Generic_Cmd *node_create = NULL;
-	node_create = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_CREATE].size);
+	node_create = v_cmd_alloc(CMD_NODE_CREATE);
 	_v_node_create_init(node_create, node_id, parent_id, user_id, type);
 	return node_create;
 }
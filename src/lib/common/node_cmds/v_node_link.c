@@ -61,7 +61,7 @@ static void _v_node_link_init(struct Generic_Cmd *node_link,
 struct Generic_Cmd *v_node_link_create(uint32 parent_node_id, uint32 child_node_id)
 {
 	struct Generic_Cmd *node_link = NULL;
-	node_link = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_LINK].size);
+	node_link = v_cmd_alloc(CMD_NODE_LINK);
 	_v_node_link_init(node_link, parent_node_id, child_node_id);
 	return node_link;
 }
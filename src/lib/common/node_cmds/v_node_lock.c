@@ -62,7 +62,7 @@ static void _v_node_lock_init(struct Generic_Cmd *node_lock,
 struct Generic_Cmd *v_node_lock_create(uint32 node_id, uint32 avatar_id)
 {
 	struct Generic_Cmd *node_lock = NULL;
-	node_lock = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_LOCK].size);
+	node_lock = v_cmd_alloc(CMD_NODE_LOCK);
 	_v_node_lock_init(node_lock, node_id, avatar_id);
 	return node_lock;
 }
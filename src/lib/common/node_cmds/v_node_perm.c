@@ -62,7 +62,7 @@ static void _v_node_perm_init(struct Generic_Cmd *node_perm,
 struct Generic_Cmd *v_node_perm_create(uint32 node_id, uint16 user_id, uint8 permissions)
 {
 	struct Generic_Cmd *node_perm = NULL;
-	node_perm = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_PERMISSION].size);
+	node_perm = v_cmd_alloc(CMD_NODE_PERMISSION);
 	_v_node_perm_init(node_perm, node_id, user_id, permissions);
 	return node_perm;
 }
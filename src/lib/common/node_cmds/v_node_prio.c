@@ -61,7 +61,7 @@ static void _v_node_prio_init(struct Generic_Cmd *node_prio,
 struct Generic_Cmd *v_node_prio_create(uint32 node_id, uint8 prio)
 {
 	struct Generic_Cmd *node_prio = NULL;
-	node_prio = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_PRIORITY].size);
+	node_prio = v_cmd_alloc(CMD_NODE_PRIORITY);
 	_v_node_prio_init(node_prio, node_id, prio);
 	return node_prio;
 }
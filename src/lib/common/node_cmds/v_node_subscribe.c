@@ -47,7 +47,8 @@ extern struct Cmd_Struct cmd_struct[];
 static void _v_node_subscribe_init(struct Generic_Cmd *node_subscribe,
 		uint32 node_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint32 epoch)
 {
 	if(node_subscribe != NULL) {
 		/* initialize members with values */
@@ -55,6 +56,7 @@ static void _v_node_subscribe_init(struct Generic_Cmd *node_subscribe,
 		UINT32(node_subscribe->data[0]) = node_id;
 		UINT32(node_subscribe->data[UINT32_SIZE]) = version;
 		UINT32(node_subscribe->data[UINT32_SIZE + UINT32_SIZE]) = crc32;
+		UINT32(node_subscribe->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE]) = epoch;
 	}
 }
 
@@ -63,10 +65,11 @@ static void _v_node_subscribe_init(struct Generic_Cmd *node_subscribe,
  */
 struct Generic_Cmd *v_node_subscribe_create(uint32 node_id,
 		uint32 version,
-		uint32 crc32)
+		uint32 crc32,
+		uint32 epoch)
 {
 	struct Generic_Cmd *node_subscribe = NULL;
-	node_subscribe = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_SUBSCRIBE].size);
-	_v_node_subscribe_init(node_subscribe, node_id, version, crc32);
+	node_subscribe = v_cmd_alloc(CMD_NODE_SUBSCRIBE);
+	_v_node_subscribe_init(node_subscribe, node_id, version, crc32, epoch);
 	return node_subscribe;
 }
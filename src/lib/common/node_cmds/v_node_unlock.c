@@ -62,7 +62,7 @@ static void _v_node_unlock_init(struct Generic_Cmd *node_unlock,
 struct Generic_Cmd *v_node_unlock_create(uint32 node_id, uint32 avatar_id)
 {
 	struct Generic_Cmd *node_unlock = NULL;
-	node_unlock = (struct Generic_Cmd*)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_UNLOCK].size);
+	node_unlock = v_cmd_alloc(CMD_NODE_UNLOCK);
 	_v_node_unlock_init(node_unlock, node_id, avatar_id);
 	return node_unlock;
 }
@@ -47,7 +47,9 @@ extern struct Cmd_Struct cmd_struct[];
 static void _v_node_unsubscribe_init(struct Generic_Cmd *node_unsubscribe,
 		const uint32 node_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch)
 {
 	if(node_unsubscribe != NULL) {
 		/* initialize members with values */
@@ -55,6 +57,8 @@ static void _v_node_unsubscribe_init(struct Generic_Cmd *node_unsubscribe,
 		UINT32(node_unsubscribe->data[0]) = node_id;
 		UINT32(node_unsubscribe->data[UINT32_SIZE]) = version;
 		UINT32(node_unsubscribe->data[UINT32_SIZE + UINT32_SIZE]) = crc32;
+		UINT8(node_unsubscribe->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE]) = versing;
+		UINT32(node_unsubscribe->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE + UINT8_SIZE]) = epoch;
 	}
 }
 
@@ -63,10 +67,12 @@ static void _v_node_unsubscribe_init(struct Generic_Cmd *node_unsubscribe,
  */
 struct Generic_Cmd *v_node_unsubscribe_create(uint32 node_id,
 		const uint32 version,
-		const uint32 crc32)
+		const uint32 crc32,
+		const uint8 versing,
+		const uint32 epoch)
 {
 	struct Generic_Cmd *node_unsubscribe = NULL;
-	node_unsubscribe = (struct Generic_Cmd *)malloc(UINT8_SIZE + cmd_struct[CMD_NODE_UNSUBSCRIBE].size);
-	_v_node_unsubscribe_init(node_unsubscribe, node_id, version, crc32);
+	node_unsubscribe = v_cmd_alloc(CMD_NODE_UNSUBSCRIBE);
+	_v_node_unsubscribe_init(node_unsubscribe, node_id, version, crc32, versing, epoch);
 	return node_unsubscribe;
 }
@@ -64,6 +64,32 @@ struct VCommandQueue *v_cmd_queue_create(uint8 id, uint8 copy_bucket, uint8 fake
 	return cmd_queue;
 }
 
+/**
+ * \brief This function returns queue for commands with id from the array of
+ * queues indexed by command ID. Queues are created lazily, when command with
+ * this id is used for the first time, then session does not allocate queues
+ * for commands, that are never sent or received.
+ *
+ * \param[in] *cmd_queues	The array of queues (MAX_CMD_ID+1 items)
+ * \param[in] id			ID of commands in the queue
+ * \param[in] copy_bucket	The flag passed to v_cmd_queue_create()
+ * \param[in] fake_cmds		The flag passed to v_cmd_queue_create()
+ *
+ * \return This function returns pointer at queue or NULL, when queue could
+ * not be created for this id.
+ */
+struct VCommandQueue *v_cmd_queue_get(struct VCommandQueue **cmd_queues,
+		uint8 id,
+		uint8 copy_bucket,
+		uint8 fake_cmds)
+{
+	if(cmd_queues[id] == NULL) {
+		cmd_queues[id] = v_cmd_queue_create(id, copy_bucket, fake_cmds);
+	}
+
+	return cmd_queues[id];
+}
+
 void v_cmd_queue_destroy(struct VCommandQueue *cmd_queue)
 {
 	v_hash_array_destroy(&cmd_queue->cmds);
@@ -40,9 +40,31 @@
 #include "v_in_queue.h"
 #include "v_cmd_queue.h"
 #include "v_common.h"
+#include "v_fake_commands.h"
+#include "v_slab.h"
+
+/**
+ * \brief This function returns size of command in the queue. Size of view
+ * is size of all commands in view.
+ */
+static uint32 v_in_queue_item_size(struct VInQueue *in_queue,
+		struct Generic_Cmd *cmd)
+{
+	struct Cmd_View_Cmd *view;
+
+	if(cmd->id == FAKE_CMD_CMD_VIEW) {
+		view = (struct Cmd_View_Cmd*)cmd;
+		return view->count * in_queue->cmds[view->cmd_id]->item_size;
+	}
+
+	return in_queue->cmds[cmd->id]->item_size;
+}
 
 /**
  * \brief This function pop command from the queue for incoming commands
+ *
+ * When the last command is popped from the queue, then the queue could be
+ * added to the ready ring again by next v_in_queue_push().
  */
 struct Generic_Cmd *v_in_queue_pop(struct VInQueue *in_queue)
 {
@@ -60,14 +82,19 @@ struct Generic_Cmd *v_in_queue_pop(struct VInQueue *in_queue)
 		assert(cmd != NULL);
 
 		/* Remove command from hashed linked list */
-		v_hash_array_remove_item(&in_queue->cmds[cmd->id]->cmds, (void*)cmd);
+		v_hash_array_remove_bucket(&in_queue->cmds[cmd->id]->cmds, queue_cmd->vbucket);
 
 		/* Remove command from queue */
-		v_list_free_item(&in_queue->queue, queue_cmd);
+		v_list_rem_item(&in_queue->queue, queue_cmd);
+		v_slab_free(queue_cmd, sizeof(struct VInQueueCommand));
 
 		/* Update total count and size of commands */
 		in_queue->count--;
-		in_queue->size -= in_queue->cmds[cmd->id]->item_size;
+		in_queue->size -= v_in_queue_item_size(in_queue, cmd);
+	}
+
+	if(in_queue->queue.first == NULL) {
+		in_queue->ready = 0;
 	}
 
 	pthread_mutex_unlock(&in_queue->lock);
@@ -87,8 +114,25 @@ int v_in_queue_push(struct VInQueue *in_queue, struct Generic_Cmd *cmd)
 	/* Lock mutex */
 	pthread_mutex_lock(&in_queue->lock);
 
-	/* Command queue has to exist for this type of command */
-	assert(in_queue->cmds[cmd->id] != NULL);
+	/* Command queue has to exist for this type of command. It is created,
+	 * when the first command of this type is received. */
+	if(v_cmd_queue_get(in_queue->cmds, cmd->id, 0, 1) == NULL) {
+		pthread_mutex_unlock(&in_queue->lock);
+		return 0;
+	}
+
+	/* View could be added only, when no command with the same ID is stored
+	 * in the queue. Otherwise newer command could replace command stored
+	 * before the view and order of commands would be changed. */
+	if(cmd->id == FAKE_CMD_CMD_VIEW) {
+		uint8 cmd_id = ((struct Cmd_View_Cmd*)cmd)->cmd_id;
+		if(v_cmd_queue_get(in_queue->cmds, cmd_id, 0, 1) == NULL ||
+				v_hash_array_count_items(&in_queue->cmds[cmd_id]->cmds) > 0)
+		{
+			pthread_mutex_unlock(&in_queue->lock);
+			return 0;
+		}
+	}
 
 	/* Try to find command with the same address, when duplicities are not
 	 * allowed in command queue */
@@ -112,7 +156,7 @@ int v_in_queue_push(struct VInQueue *in_queue, struct Generic_Cmd *cmd)
 		vbucket->data = (void*)cmd;
 	} else {
 		/* Create new command in queue */
-		struct VInQueueCommand *queue_cmd = (struct VInQueueCommand*)calloc(1, sizeof(struct VInQueueCommand));
+		struct VInQueueCommand *queue_cmd = (struct VInQueueCommand*)v_slab_calloc(sizeof(struct VInQueueCommand));
 
 		/* Add new command data */
 		queue_cmd->vbucket = v_hash_array_add_item(&in_queue->cmds[cmd->id]->cmds, cmd, in_queue->cmds[cmd->id]->item_size);
@@ -120,11 +164,22 @@ int v_in_queue_push(struct VInQueue *in_queue, struct Generic_Cmd *cmd)
 
 		/* Update count and size of queue */
 		in_queue->count++;
-		in_queue->size += in_queue->cmds[cmd->id]->item_size;
+		in_queue->size += v_in_queue_item_size(in_queue, cmd);
 
 		/* Add own command to the tail of the queue */
 		v_list_add_tail(&in_queue->queue, queue_cmd);
 	}
+
+	/* Notify consumer, that this queue is not empty. The queue is added to
+	 * the ring only once until it is drained. */
+	if(in_queue->ready_ring != NULL && in_queue->ready == 0) {
+		if(v_ready_ring_push(in_queue->ready_ring, in_queue->ready_item) == 1) {
+			in_queue->ready = 1;
+		} else {
+			v_print_log(VRS_PRINT_WARNING, "Ready ring is full\n");
+		}
+	}
+
 	/* Unlock mutex */
 	pthread_mutex_unlock(&in_queue->lock);
 
@@ -155,13 +210,35 @@ int v_in_queue_init(struct VInQueue *in_queue, int max_size)
 	in_queue->queue.first = NULL;
 	in_queue->queue.last = NULL;
 
+	in_queue->ready_ring = NULL;
+	in_queue->ready_item = NULL;
+	in_queue->ready = 0;
+
+	in_queue->cmd_views = 0;
+
+	/* Command queues are created, when they are used */
 	for(id=0; id<=MAX_CMD_ID; id++) {
-		in_queue->cmds[id] = v_cmd_queue_create(id, 0, 1);
+		in_queue->cmds[id] = NULL;
 	}
 
 	return 1;
 }
 
+/**
+ * \brief This function sets ring, that is notified, when new command is
+ * added to the empty queue. The ready_item is added to the ring.
+ */
+void v_in_queue_set_ready_ring(struct VInQueue *in_queue,
+		struct VReadyRing *ready_ring,
+		void *ready_item)
+{
+	pthread_mutex_lock(&in_queue->lock);
+	in_queue->ready_ring = ready_ring;
+	in_queue->ready_item = ready_item;
+	in_queue->ready = 0;
+	pthread_mutex_unlock(&in_queue->lock);
+}
+
 /**
  * \brief This function creates new queue for incoming commnds
  */
@@ -184,6 +261,7 @@ struct VInQueue *v_in_queue_create(void)
  */
 void v_in_queue_destroy(struct VInQueue **in_queue)
 {
+	struct VInQueueCommand *queue_cmd;
 	int id;
 
 	pthread_mutex_lock(&(*in_queue)->lock);
@@ -191,7 +269,13 @@ void v_in_queue_destroy(struct VInQueue **in_queue)
 	(*in_queue)->count = 0;
 	(*in_queue)->size = 0;
 
-	v_list_free(&(*in_queue)->queue);
+	while((queue_cmd = (*in_queue)->queue.first) != NULL) {
+		/* Destroy command, that was not popped (e.g. view holding
+		 * reference at receive buffer) */
+		v_cmd_destroy((struct Generic_Cmd**)&queue_cmd->vbucket->data);
+		v_list_rem_item(&(*in_queue)->queue, queue_cmd);
+		v_slab_free(queue_cmd, sizeof(struct VInQueueCommand));
+	}
 
 	for(id=0; id<=MAX_CMD_ID; id++) {
 		if((*in_queue)->cmds[id] != NULL) {
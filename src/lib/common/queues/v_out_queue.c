@@ -44,12 +44,17 @@
 #include "v_out_queue.h"
 #include "v_cmd_queue.h"
 #include "v_common.h"
+#include "v_slab.h"
 #include "v_commands.h"
+#include "v_sys_commands.h"
 #include "v_fake_commands.h"
 #include "v_node_commands.h"
 
-static struct VPrioOutQueue * _v_out_prio_queue_create(real32 r_prio);
+extern struct Cmd_Struct cmd_struct[];
+
+static struct VPrioOutQueue * _v_out_prio_queue_create(uint32 weight);
 static void _v_out_prio_queue_destroy(struct VPrioOutQueue *prio_queu);
+static void _v_out_queue_run_release(struct VOutQueueCommand *queue_cmd);
 static void _v_out_queue_command_add(struct VPrioOutQueue *prio_queue,
 		uint8 flag,
 		uint8 share_addr,
@@ -59,11 +64,13 @@ static struct VOutQueueCommand * _v_out_queue_command_create(struct VOutQueue *o
 		uint8 flag, uint8 prio, struct Generic_Cmd *cmd);
 static int _v_out_queue_push(struct VOutQueue *out_queue,
 		uint8 flag, uint8 prio,	struct Generic_Cmd *cmd);
+static void _v_out_queue_command_remove(struct VOutQueue *out_queue,
+		uint8 prio, struct VOutQueueCommand *queue_cmd);
 
 /**
  * \brief This function creates queue for commands with the priority
  */
-static struct VPrioOutQueue * _v_out_prio_queue_create(real32 r_prio)
+static struct VPrioOutQueue * _v_out_prio_queue_create(uint32 weight)
 {
 	struct VPrioOutQueue *prio_queue = (struct VPrioOutQueue *)calloc(1, sizeof(struct VPrioOutQueue));
 
@@ -73,17 +80,166 @@ static struct VPrioOutQueue * _v_out_prio_queue_create(real32 r_prio)
 	prio_queue->count = 0;
 	prio_queue->size = 0;
 
-	prio_queue->r_prio = r_prio;
+	prio_queue->weight = weight;
+	prio_queue->deficit = 0;
 
 	return prio_queue;
 }
 
+/**
+ * \brief This function marks priority queue as not empty
+ */
+static void _v_out_queue_prio_add(struct VOutQueue *out_queue, uint8 prio)
+{
+	out_queue->prio_map[prio >> 5] |= (1U << (prio & 31));
+
+	if(prio >= VRS_DEFAULT_PRIORITY) {
+		out_queue->weight_sum_high += out_queue->queues[prio]->weight;
+	} else {
+		out_queue->weight_sum_low += out_queue->queues[prio]->weight;
+	}
+}
+
+/**
+ * \brief This function marks priority queue as empty. The rest of quantum
+ * isn't kept for empty queue.
+ */
+static void _v_out_queue_prio_rem(struct VOutQueue *out_queue, uint8 prio)
+{
+	out_queue->prio_map[prio >> 5] &= ~(1U << (prio & 31));
+
+	if(prio >= VRS_DEFAULT_PRIORITY) {
+		out_queue->weight_sum_high -= out_queue->queues[prio]->weight;
+	} else {
+		out_queue->weight_sum_low -= out_queue->queues[prio]->weight;
+	}
+
+	out_queue->queues[prio]->deficit = 0;
+}
+
+/**
+ * \brief This function finds the highest not empty priority queue, that has
+ * priority lower or equal to prio.
+ * \return This function returns priority of queue or -1, when there is no
+ * such queue.
+ */
+static int _v_out_queue_next_prio(struct VOutQueue *out_queue, int prio)
+{
+	int i;
+	uint32 word;
+
+	if(prio < 0) return -1;
+
+	i = prio >> 5;
+	/* Ignore bits of higher priorities in the first word */
+	word = out_queue->prio_map[i] & (0xFFFFFFFFU >> (31 - (prio & 31)));
+
+	while(1) {
+		if(word != 0) {
+			return (i << 5) + (31 - __builtin_clz(word));
+		}
+		if(--i < 0) break;
+		word = out_queue->prio_map[i];
+	}
+
+	return -1;
+}
+
 /**
  * \brief This function free all commands in linked list of priority queue
  */
 static void _v_out_prio_queue_destroy(struct VPrioOutQueue *prio_queu)
 {
-	v_list_free(&prio_queu->cmds);
+	struct VOutQueueCommand *queue_cmd;
+
+	while((queue_cmd = prio_queu->cmds.first) != NULL) {
+		v_list_rem_item(&prio_queu->cmds, queue_cmd);
+		_v_out_queue_run_release(queue_cmd);
+		v_slab_free(queue_cmd, sizeof(struct VOutQueueCommand));
+	}
+}
+
+/**
+ * \brief This function returns length of count compressed commands of the
+ * sequence. It computes the same length as v_cmds_len() from values stored
+ * in the sequence.
+ */
+static uint16 _v_out_queue_run_len(const struct VOutQueueRun *run, uint16 count)
+{
+	uint32 len = run->head_len + UINT8_SIZE + (uint32)count*run->item_len;
+
+	/* Length bigger than 254 is coded with: 0xFF(1B), Length(2B) */
+	if(len >= 0xFF) {
+		len += UINT16_SIZE;
+	}
+
+	return (len < 0xFFFF) ? (uint16)len : 0xFFFF;
+}
+
+/**
+ * \brief This function returns number of commands of the sequence, that
+ * could be compressed to max_len bytes.
+ */
+static uint16 _v_out_queue_run_count(const struct VOutQueueRun *run, uint16 max_len)
+{
+	uint32 count = 0;
+
+	/* Try length coded with three bytes at first */
+	if(max_len >= run->head_len + UINT8_SIZE + UINT16_SIZE) {
+		count = (max_len - (run->head_len + UINT8_SIZE + UINT16_SIZE))/run->item_len;
+	}
+
+	/* Length of these commands would be coded with one byte */
+	if(run->head_len + UINT8_SIZE + count*run->item_len < 0xFF) {
+		if(max_len >= run->head_len + UINT8_SIZE) {
+			count = (max_len - (run->head_len + UINT8_SIZE))/run->item_len;
+		}
+		/* Keep length shorter than 255 */
+		if(run->head_len + UINT8_SIZE + count*run->item_len >= 0xFF) {
+			count = (0xFF - 1 - (run->head_len + UINT8_SIZE))/run->item_len;
+		}
+	}
+
+	return (count < run->counter) ? (uint16)count : run->counter;
+}
+
+/**
+ * \brief This function updates sizes stored in the sequence, when command was
+ * added to the sequence, removed from it or shared address was changed.
+ */
+static void _v_out_queue_run_update(struct VOutQueueRun *run, uint8 cmd_id)
+{
+	if(cmd_struct[cmd_id].flag & SHARE_ADDR) {
+		/* OpCode + Size of sharing + Shared address */
+		run->head_len = UINT8_SIZE + UINT8_SIZE + run->share;
+		run->item_len = cmd_struct[cmd_id].size - run->share;
+	} else {
+		/* OpCode */
+		run->head_len = UINT8_SIZE;
+		run->item_len = cmd_struct[cmd_id].size;
+	}
+
+	run->len = _v_out_queue_run_len(run, run->counter);
+}
+
+/**
+ * \brief This function removes command from the sequence of commands with the
+ * same ID. Shared values are freed, when it was the last command.
+ */
+static void _v_out_queue_run_release(struct VOutQueueCommand *queue_cmd)
+{
+	struct VOutQueueRun *run = queue_cmd->run;
+
+	if(run != NULL) {
+		run->counter--;
+		/* Free values, when it's last command in the queue */
+		if(run->counter == 0) {
+			v_slab_free(run, sizeof(struct VOutQueueRun));
+		} else {
+			run->len = _v_out_queue_run_len(run, run->counter);
+		}
+		queue_cmd->run = NULL;
+	}
 }
 
 /**
@@ -109,43 +265,50 @@ static void _v_out_queue_command_add(struct VPrioOutQueue *prio_queue,
 	if(border_queue_cmd != NULL) {
 
 		/* Is ID of this command same as ID of the last command
-		 * in this priority queue? */
-		if( (share_addr == 1) && (border_queue_cmd->id == queue_cmd->id)) {
+		 * in this priority queue? Full sequence is not extended, because
+		 * number of its commands would not fit to the counter. */
+		if( (share_addr == 1) && (border_queue_cmd->id == queue_cmd->id) &&
+				(border_queue_cmd->run == NULL ||
+				 border_queue_cmd->run->counter < UINT16_MAX) )
+		{
 			struct Generic_Cmd *border_cmd = (struct Generic_Cmd *)border_queue_cmd->vbucket->data;
 
+			struct VOutQueueRun *run = border_queue_cmd->run;
+
 			/* Is the last command in this priority queue and the
 			 * first command with this ID? */
-			if(border_queue_cmd->counter == NULL) {
-
-				/* Set initial number of commands with same ID */
-				border_queue_cmd->counter = (uint16*)malloc(sizeof(uint16));
-				*border_queue_cmd->counter = 1;
+			if(run == NULL) {
+				run = (struct VOutQueueRun*)v_slab_alloc(sizeof(struct VOutQueueRun));
 
-				/* Compute size of address that could be shared */
-				border_queue_cmd->share = (int8*)malloc(sizeof(int8));
-				*border_queue_cmd->share = v_cmd_cmp_addr(border_cmd, cmd, 0xFF);
+				if(run != NULL) {
+					/* Set initial number of commands with same ID */
+					run->counter = 1;
 
-				/* Allocate memory for length of compressed commands */
-				border_queue_cmd->len = (uint16*)malloc(sizeof(uint16));
-				*border_queue_cmd->len = v_cmds_len(border_cmd, *border_queue_cmd->counter, *border_queue_cmd->share, 0);
+					/* Compute size of address that could be shared */
+					run->share = v_cmd_cmp_addr(border_cmd, cmd, 0xFF);
 
-			} else if(*border_queue_cmd->share > 0) {
+					border_queue_cmd->run = run;
+				} else {
+					/* Command is queued without compression with
+					 * previous command */
+					v_print_log(VRS_PRINT_WARNING,
+							"Unable to allocate run of commands: %d\n", cmd->id);
+				}
+			} else if(run->share > 0) {
 				/* Try to update size of address that could be shared */
-				*border_queue_cmd->share = v_cmd_cmp_addr(border_cmd, cmd, *border_queue_cmd->share);
+				run->share = v_cmd_cmp_addr(border_cmd, cmd, run->share);
 			}
 
 			/* Set up pointer */
-			queue_cmd->counter = border_queue_cmd->counter;
-			queue_cmd->share = border_queue_cmd->share;
-			queue_cmd->len = border_queue_cmd->len;
+			queue_cmd->run = run;
 
 			/* Update values */
-			(*queue_cmd->counter)++;
-			*queue_cmd->len = v_cmds_len(cmd, *queue_cmd->counter, *queue_cmd->share, *queue_cmd->len);
+			if(run != NULL) {
+				run->counter++;
+				_v_out_queue_run_update(run, cmd->id);
+			}
 		} else {
-			queue_cmd->counter = NULL;
-			queue_cmd->share = NULL;
-			queue_cmd->len = NULL;
+			queue_cmd->run = NULL;
 		}
 	}
 
@@ -177,14 +340,13 @@ static struct VOutQueueCommand * _v_out_queue_command_create(struct VOutQueue *o
 		return NULL;
 	}
 
-	queue_cmd = (struct VOutQueueCommand*)calloc(1, sizeof(struct VOutQueueCommand));
+	queue_cmd = (struct VOutQueueCommand*)v_slab_calloc(sizeof(struct VOutQueueCommand));
 
 	if(queue_cmd != NULL) {
 		/* Set up id and priority of command */
 		queue_cmd->id = cmd->id;
 		queue_cmd->prio = prio;
-		queue_cmd->counter = NULL;
-		queue_cmd->share = NULL;
+		queue_cmd->run = NULL;
 
 		if(out_queue->cmds[cmd->id]->flag & NOT_SHARE_ADDR) {
 			_v_out_queue_command_add(out_queue->queues[prio], flag, 0, queue_cmd, cmd);
@@ -199,12 +361,9 @@ static struct VOutQueueCommand * _v_out_queue_command_create(struct VOutQueue *o
 
 		assert(queue_cmd->vbucket->data != NULL);
 
-		/* When this priority queue was empty, then update summary of real priorities */
+		/* When this priority queue was empty, then it has to be scheduled */
 		if(out_queue->queues[prio]->count == 0) {
-			if(prio>=VRS_DEFAULT_PRIORITY)
-				out_queue->r_prio_sum_high += out_queue->queues[prio]->r_prio;
-			else
-				out_queue->r_prio_sum_low += out_queue->queues[prio]->r_prio;
+			_v_out_queue_prio_add(out_queue, prio);
 		}
 
 		/* Update count and size of commands */
@@ -213,14 +372,6 @@ static struct VOutQueueCommand * _v_out_queue_command_create(struct VOutQueue *o
 
 		out_queue->queues[prio]->count++;
 		out_queue->queues[prio]->size += out_queue->cmds[cmd->id]->item_size;
-
-		/* If necessary update maximal or minimal priority */
-		if(prio > out_queue->max_prio) {
-			out_queue->max_prio = prio;
-		} else if(prio < out_queue->min_prio) {
-			out_queue->min_prio = prio;
-		}
-
 	}
 
 	return queue_cmd;
@@ -248,6 +399,11 @@ static int _v_out_queue_push(struct VOutQueue *out_queue,
 
 	assert(cmd != NULL);
 
+	/* Command queue is created, when first command of this type is sent */
+	if(v_cmd_queue_get(out_queue->cmds, cmd->id, 0, 1) == NULL) {
+		return 0;
+	}
+
 	/* Try to find command with the same address, when duplications are not
 	 * allowed in command queue */
 	if(out_queue->cmds[cmd->id]->flag & REMOVE_HASH_DUPS) {
@@ -263,7 +419,7 @@ static int _v_out_queue_push(struct VOutQueue *out_queue,
 			if(queue_cmd->prio != prio) {
 
 				/* Remove old obsolete data */
-				v_hash_array_remove_item(&out_queue->cmds[cmd->id]->cmds, vbucket->data);
+				v_hash_array_remove_bucket(&out_queue->cmds[cmd->id]->cmds, vbucket);
 				/* Remove old  command */
 				v_list_rem_item(&out_queue->queues[queue_cmd->prio]->cmds, queue_cmd);
 
@@ -272,24 +428,11 @@ static int _v_out_queue_push(struct VOutQueue *out_queue,
 				out_queue->queues[queue_cmd->prio]->size -= out_queue->cmds[cmd->id]->item_size;
 
 				/* If needed, then update counter of commands with the same id in the queue */
-				if(queue_cmd->counter != NULL) {
-					*queue_cmd->counter -= 1;
-					if(*queue_cmd->counter == 0) {
-						free(queue_cmd->counter);
-						queue_cmd->counter = NULL;
-						free(queue_cmd->share);
-						queue_cmd->share = NULL;
-						free(queue_cmd->len);
-						queue_cmd->len = NULL;
-					}
-				}
+				_v_out_queue_run_release(queue_cmd);
 
-				/* When this priority queue is empty now, then update summary of real priorities */
+				/* When old priority queue is empty now, then it isn't scheduled */
 				if(out_queue->queues[queue_cmd->prio]->count == 0) {
-					if(prio>=VRS_DEFAULT_PRIORITY)
-						out_queue->r_prio_sum_high -= out_queue->queues[queue_cmd->prio]->r_prio;
-					else
-						out_queue->r_prio_sum_low -= out_queue->queues[queue_cmd->prio]->r_prio;
+					_v_out_queue_prio_rem(out_queue, queue_cmd->prio);
 				}
 
 				/* Update new priority command */
@@ -308,25 +451,15 @@ static int _v_out_queue_push(struct VOutQueue *out_queue,
 
 				assert(queue_cmd->vbucket->data != NULL);
 
-				/* When this priority queue was empty, then update summary of real priorities */
+				/* When new priority queue was empty, then it has to be scheduled */
 				if(out_queue->queues[prio]->count == 0) {
-					if(prio>=VRS_DEFAULT_PRIORITY)
-						out_queue->r_prio_sum_high += out_queue->queues[prio]->r_prio;
-					else
-						out_queue->r_prio_sum_low += out_queue->queues[prio]->r_prio;
+					_v_out_queue_prio_add(out_queue, prio);
 				}
 
 				/* Update count and size in new priority queue */
 				out_queue->queues[prio]->count++;
 				out_queue->queues[prio]->size += out_queue->cmds[cmd->id]->item_size;
 
-				/* If necessary update maximal or minimal priority */
-				if(prio > out_queue->max_prio) {
-					out_queue->max_prio = prio;
-				} else if(prio < out_queue->min_prio) {
-					out_queue->min_prio = prio;
-				}
-
 			} else {
 				/* Debug print */
 #if 0
@@ -378,6 +511,11 @@ int v_out_queue_push_head(struct VOutQueue *out_queue,
 	/* Lock mutex */
 	pthread_mutex_lock(&out_queue->lock);
 
+	if(v_cmd_queue_get(out_queue->cmds, cmd->id, 0, 1) == NULL) {
+		pthread_mutex_unlock(&out_queue->lock);
+		return 0;
+	}
+
 	/* Try to find command with the same address, when duplicities are not
 	 * allowed in command queue */
 	if(out_queue->cmds[cmd->id]->flag & REMOVE_HASH_DUPS) {
@@ -427,6 +565,43 @@ int v_out_queue_push_tail(struct VOutQueue *out_queue,
 	return ret;
 }
 
+/**
+ * \brief This function removes the first command from the priority queue.
+ * Command itself isn't destroyed.
+ */
+static void _v_out_queue_command_remove(struct VOutQueue *out_queue,
+		uint8 prio,
+		struct VOutQueueCommand *queue_cmd)
+{
+	struct VPrioOutQueue *prio_queue = out_queue->queues[prio];
+	struct Generic_Cmd *cmd = (struct Generic_Cmd *)queue_cmd->vbucket->data;
+
+	/* Remove command from hashed linked list */
+	v_hash_array_remove_bucket(&out_queue->cmds[cmd->id]->cmds, queue_cmd->vbucket);
+
+	/* Remove command from priority queue */
+	v_list_rem_item(&prio_queue->cmds, queue_cmd);
+
+	/* Update total count and size of commands */
+	out_queue->count--;
+	out_queue->size -= out_queue->cmds[cmd->id]->item_size;
+
+	/* Update count and size of commands in subqueue with priority prio */
+	prio_queue->count--;
+	prio_queue->size -= out_queue->cmds[cmd->id]->item_size;
+
+	/* If needed, then update counter of commands with the same id in the queue */
+	_v_out_queue_run_release(queue_cmd);
+
+	/* When this priority queue is empty now, then it isn't scheduled */
+	if(prio_queue->count == 0) {
+		_v_out_queue_prio_rem(out_queue, prio);
+	}
+
+	/* Free queue command */
+	v_slab_free(queue_cmd, sizeof(struct VOutQueueCommand));
+}
+
 /*
  * \brief This function pop command from queue with specific priority.
  *
@@ -456,7 +631,7 @@ struct Generic_Cmd *v_out_queue_pop(struct VOutQueue *out_queue,
 	struct VPrioOutQueue *prio_queue = out_queue->queues[prio];
 	struct VOutQueueCommand *queue_cmd;
 	struct Generic_Cmd *cmd=NULL;
-	int i, can_pop_cmd = 1;
+	int can_pop_cmd = 1;
 
 	/* Lock mutex */
 	pthread_mutex_lock(&out_queue->lock);
@@ -471,37 +646,33 @@ struct Generic_Cmd *v_out_queue_pop(struct VOutQueue *out_queue,
 		assert(cmd != NULL);
 
 		/* Return value of count and length of compressed commands */
-		if(queue_cmd->counter != NULL) {
+		if(queue_cmd->run != NULL) {
+			struct VOutQueueRun *run = queue_cmd->run;
+
 			if(count != NULL) {
-				*count = *queue_cmd->counter;
+				*count = run->counter;
 			}
 			if(share != NULL) {
-				*share = *queue_cmd->share;
+				*share = run->share;
 			}
 			if(len != NULL) {
 				/* When *len value is not 0, then this value represents maximal
 				 * size of buffer that could be filled with this priority queue. This
 				 * function should return value, that is smaller or equal than this
 				 * maximum. */
-				if(*len != 0) {
-					if(*len < *queue_cmd->len) {
-						if (count != NULL) {
-							*count = v_cmd_count(cmd, *len, *queue_cmd->share);
-							/* FIXME: compute length and count correctly, when command is added to the queue */
-							*count = ((*count) > (*queue_cmd->counter)) ? *queue_cmd->counter : *count;
-							/* Is enough space in buffer to unpack this command? */
-							if(*count == 0) {
-								can_pop_cmd = 0;
-							}
-							*len = v_cmds_len(cmd, *count, *queue_cmd->share, 0);
-						} else {
+				if(*len != 0 && *len < run->len) {
+					if (count != NULL) {
+						*count = _v_out_queue_run_count(run, *len);
+						/* Is enough space in buffer to unpack this command? */
+						if(*count == 0) {
 							can_pop_cmd = 0;
 						}
+						*len = _v_out_queue_run_len(run, *count);
 					} else {
-						*len = *queue_cmd->len;
+						can_pop_cmd = 0;
 					}
 				} else {
-					*len = *queue_cmd->len;
+					*len = run->len;
 				}
 			}
 		} else {
@@ -521,73 +692,210 @@ struct Generic_Cmd *v_out_queue_pop(struct VOutQueue *out_queue,
 
 		/* Is it possible to pop command from the queue */
 		if(can_pop_cmd == 1) {
-			/* Remove command from hashed linked list */
-			v_hash_array_remove_item(&out_queue->cmds[cmd->id]->cmds, (void*)cmd);
-
-			/* Remove command from priority queue */
-			v_list_rem_item(&prio_queue->cmds, queue_cmd);
-
-			/* Update total count and size of commands */
-			out_queue->count--;
-			out_queue->size -= out_queue->cmds[cmd->id]->item_size;
-
-			/* Update count and size of commands in subqueue with priority prio */
-			out_queue->queues[prio]->count--;
-			out_queue->queues[prio]->size -= out_queue->cmds[cmd->id]->item_size;
-
-			/* If needed, then update counter of commands with the same id in the queue */
-			if(queue_cmd->counter != NULL) {
-				*queue_cmd->counter -= 1;
-				/* Free values, when it's last command in the queue */
-				if(*queue_cmd->counter == 0) {
-					free(queue_cmd->counter);
-					queue_cmd->counter = NULL;
-					free(queue_cmd->share);
-					queue_cmd->share = NULL;
-					free(queue_cmd->len);
-					queue_cmd->len = NULL;
-				}
+			_v_out_queue_command_remove(out_queue, prio, queue_cmd);
+		} else {
+			cmd = NULL;
+		}
+	}
+
+	pthread_mutex_unlock(&out_queue->lock);
+
+	return cmd;
+}
+
+/**
+ * \brief This function pops commands from the head of priority queue, that
+ * could be packed to max_len bytes. When the first command starts sequence of
+ * commands with the same ID and compression is allowed, then commands of
+ * this sequence are popped and they will be packed as one compressed command.
+ * Otherwise commands are popped as single commands. Queue has to be locked.
+ *
+ * \return This function returns number of popped commands.
+ */
+static uint16 _v_out_queue_pop_batch(struct VOutQueue *out_queue,
+		uint8 prio,
+		uint16 max_len,
+		uint8 cmpr,
+		struct VOutQueueBatch *batch)
+{
+	struct VPrioOutQueue *prio_queue = out_queue->queues[prio];
+	struct VOutQueueCommand *queue_cmd;
+	struct Generic_Cmd *cmd;
+	struct VOutQueueRun *run;
+	uint16 count, len;
+
+	batch->count = 0;
+	batch->len = 0;
+	batch->share = 0;
+	batch->compressed = 0;
+	batch->prio = prio;
+
+	queue_cmd = prio_queue->cmds.first;
+
+	if(queue_cmd == NULL) {
+		return 0;
+	}
+
+	cmd = (struct Generic_Cmd *)queue_cmd->vbucket->data;
+
+	assert(cmd != NULL);
+
+	/* Sequence of commands with the same ID (fake commands are never
+	 * compressed) */
+	if(cmpr != CMPR_NONE && queue_cmd->run != NULL && cmd->id >= MIN_CMD_ID) {
+		run = queue_cmd->run;
+
+		/* Compute number of commands, that could be packed to max_len */
+		if(run->len > max_len) {
+			count = _v_out_queue_run_count(run, max_len);
+		} else {
+			count = run->counter;
+		}
+		if(count > OUT_QUEUE_BATCH_SIZE) {
+			count = OUT_QUEUE_BATCH_SIZE;
+		}
+		if(count == 0) {
+			return 0;
+		}
+
+		batch->len = _v_out_queue_run_len(run, count);
+		batch->share = run->share;
+		batch->compressed = 1;
+
+		/* Pop all commands of sequence at once */
+		while(batch->count < count) {
+			batch->cmds[batch->count++] = (struct Generic_Cmd *)queue_cmd->vbucket->data;
+			_v_out_queue_command_remove(out_queue, prio, queue_cmd);
+
+			queue_cmd = prio_queue->cmds.first;
+
+			/* Sequence is finished, when the last command was removed */
+			if(queue_cmd == NULL || queue_cmd->run != run) {
+				break;
 			}
+		}
+	} else {
+		/* Pop single commands, until the next one is start of sequence */
+		while(batch->count < OUT_QUEUE_BATCH_SIZE) {
+			cmd = (struct Generic_Cmd *)queue_cmd->vbucket->data;
+			len = v_cmd_size(cmd);
 
-			/* When this priority queue is empty now, then update summary of
-			 * real priorities and it is possibly necessary to change maximal
-			 * or minimal priority queue*/
-			if(out_queue->queues[prio]->count == 0) {
-				if(prio>=VRS_DEFAULT_PRIORITY) {
-					out_queue->r_prio_sum_high -= out_queue->queues[prio]->r_prio;
-				} else {
-					out_queue->r_prio_sum_low -= out_queue->queues[prio]->r_prio;
-				}
+			if(batch->len + len > max_len) {
+				break;
+			}
 
-				if(out_queue->max_prio == prio && out_queue->min_prio != prio) {
-					for(i=prio; i>=out_queue->min_prio; i--) {
-						if(out_queue->queues[i]->count != 0) {
-							out_queue->max_prio = i;
-							break;
-						}
-					}
-				} else if(out_queue->min_prio == prio && out_queue->max_prio != prio) {
-					for(i=prio; i<=out_queue->max_prio; i++) {
-						if(out_queue->queues[i]->count != 0) {
-							out_queue->min_prio = i;
-							break;
-						}
-					}
-				} else if(out_queue->min_prio == prio && out_queue->max_prio == prio) {
-					out_queue->min_prio = out_queue->max_prio = VRS_DEFAULT_PRIORITY;
+			batch->cmds[batch->count++] = cmd;
+			batch->len += len;
+			_v_out_queue_command_remove(out_queue, prio, queue_cmd);
+
+			queue_cmd = prio_queue->cmds.first;
+
+			if(queue_cmd == NULL ||
+					(cmpr != CMPR_NONE && queue_cmd->run != NULL))
+			{
+				break;
+			}
+		}
+	}
+
+	return batch->count;
+}
+
+/**
+ * \brief This function initializes scheduler of priority queues for one
+ * packet or message.
+ *
+ * \param[out]	*sched		The scheduler
+ * \param[in]	*out_queue	The outgoing queue
+ * \param[in]	window		The size of window, that could be used by commands
+ * \param[in]	cmpr		The type of command compression
+ */
+void v_out_queue_sched_init(struct VOutQueueSched *sched,
+		struct VOutQueue *out_queue,
+		uint32 window,
+		uint8 cmpr)
+{
+	sched->out_queue = out_queue;
+	sched->window = window;
+	sched->cmpr = cmpr;
+	sched->visited = 0;
+
+	pthread_mutex_lock(&out_queue->lock);
+	sched->prio = _v_out_queue_next_prio(out_queue, MAX_PRIORITY);
+	pthread_mutex_unlock(&out_queue->lock);
+}
+
+/**
+ * \brief This function pops next batch of commands, that should be packed to
+ * the packet or message. Each priority queue gets quantum of window according
+ * its weight, when it is visited. Priorities higher or equal to default
+ * priority and lower priorities share window separately.
+ *
+ * \param[in]	*sched	The scheduler
+ * \param[in]	space	The free space in buffer of packet or message
+ * \param[out]	*batch	The popped commands
+ *
+ * \return This function returns number of popped commands. It returns 0, when
+ * there is nothing to send in this packet.
+ */
+uint16 v_out_queue_sched_pop(struct VOutQueueSched *sched,
+		uint16 space,
+		struct VOutQueueBatch *batch)
+{
+	struct VOutQueue *out_queue = sched->out_queue;
+	struct VPrioOutQueue *prio_queue;
+	uint32 weight_sum, quantum, limit;
+	uint16 count = 0;
+
+	if(sched->window == 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&out_queue->lock);
+
+	while(sched->prio >= 0 && space > 0) {
+		prio_queue = out_queue->queues[sched->prio];
+
+		if(prio_queue->count > 0) {
+			/* Add quantum to the queue, when it is visited first time */
+			if(sched->visited == 0) {
+				weight_sum = (sched->prio >= VRS_DEFAULT_PRIORITY) ?
+						out_queue->weight_sum_high : out_queue->weight_sum_low;
+				quantum = (uint32)(((uint64)sched->window * prio_queue->weight) / weight_sum);
+				prio_queue->deficit += quantum;
+				/* Queue can't save more than one window */
+				if(prio_queue->deficit > sched->window) {
+					prio_queue->deficit = sched->window;
 				}
+				sched->visited = 1;
+
+				v_print_log(VRS_PRINT_DEBUG_MSG, "Queue: %d, count: %d, weight: %d, deficit: %d\n",
+						sched->prio, prio_queue->count, prio_queue->weight, prio_queue->deficit);
 			}
 
-			/* Free queue command */
-			free(queue_cmd);
-		} else {
-			cmd = NULL;
+			limit = (prio_queue->deficit < space) ? prio_queue->deficit : space;
+
+			count = _v_out_queue_pop_batch(out_queue, (uint8)sched->prio, (uint16)limit,
+					sched->cmpr, batch);
+
+			if(count > 0) {
+				/* Deficit of empty queue was already cleared */
+				if(prio_queue->count > 0) {
+					prio_queue->deficit -= (batch->len < prio_queue->deficit) ?
+							batch->len : prio_queue->deficit;
+				}
+				break;
+			}
 		}
+
+		/* Go to the next not empty priority queue */
+		sched->prio = _v_out_queue_next_prio(out_queue, sched->prio - 1);
+		sched->visited = 0;
 	}
 
 	pthread_mutex_unlock(&out_queue->lock);
 
-	return cmd;
+	return count;
 }
 
 /**
@@ -596,7 +904,7 @@ struct Generic_Cmd *v_out_queue_pop(struct VOutQueue *out_queue,
 int v_out_queue_init(struct VOutQueue *out_queue, int max_size)
 {
 	int id, prio, res;
-	real32 r_prio;
+	real32 weight;
 
 	/* Initialize mutex of this queue */
 	if((res=pthread_mutex_init(&out_queue->lock, NULL))!=0) {
@@ -610,29 +918,28 @@ int v_out_queue_init(struct VOutQueue *out_queue, int max_size)
 
 	out_queue->max_size = max_size;
 
-	out_queue->max_prio = VRS_DEFAULT_PRIORITY;
-	out_queue->min_prio = VRS_DEFAULT_PRIORITY;
+	memset(out_queue->prio_map, 0, sizeof(out_queue->prio_map));
 
-	out_queue->r_prio_sum_high = 0.0;
-	out_queue->r_prio_sum_low = 0.0;
+	out_queue->weight_sum_high = 0;
+	out_queue->weight_sum_low = 0;
 
-	/* Set up high priorities */
-	r_prio = VRS_DEFAULT_PRIORITY;
+	/* Set up weights of high priorities */
+	weight = OUT_QUEUE_DEFAULT_WEIGHT;
 	for(prio=VRS_DEFAULT_PRIORITY; prio<=MAX_PRIORITY; prio++) {
-		out_queue->queues[prio] = _v_out_prio_queue_create((r_prio<MAX_REAL_PRIO_VAL)?r_prio:MAX_REAL_PRIO_VAL);
-		r_prio = r_prio + r_prio*REAL_PRIO_MUL;
+		out_queue->queues[prio] = _v_out_prio_queue_create((uint32)((weight<OUT_QUEUE_MAX_WEIGHT)?weight:OUT_QUEUE_MAX_WEIGHT));
+		weight = weight + weight*OUT_QUEUE_WEIGHT_STEP;
 	}
 
-	/* Set up low priorities */
-	r_prio = VRS_DEFAULT_PRIORITY - 1;
+	/* Set up weights of low priorities */
+	weight = OUT_QUEUE_DEFAULT_WEIGHT - 1;
 	for(prio=VRS_DEFAULT_PRIORITY-1; prio>=0; prio--) {
-		out_queue->queues[prio] = _v_out_prio_queue_create((r_prio>MIN_REAL_PRIO_VAL)?r_prio:MIN_REAL_PRIO_VAL);
-		r_prio = r_prio - r_prio*REAL_PRIO_MUL;
+		out_queue->queues[prio] = _v_out_prio_queue_create((uint32)((weight>OUT_QUEUE_MIN_WEIGHT)?weight:OUT_QUEUE_MIN_WEIGHT));
+		weight = weight - weight*OUT_QUEUE_WEIGHT_STEP;
 	}
 
-	/* Set command queues */
+	/* Command queues are created, when they are used */
 	for(id=0; id<=MAX_CMD_ID; id++) {
-		out_queue->cmds[id] = v_cmd_queue_create(id, 0, 1);
+		out_queue->cmds[id] = NULL;
 	}
 
 	return 1;
@@ -667,11 +974,10 @@ void v_out_queue_destroy(struct VOutQueue **out_queue)
 	(*out_queue)->count = 0;
 	(*out_queue)->size = 0;
 
-	(*out_queue)->max_prio = VRS_DEFAULT_PRIORITY;
-	(*out_queue)->min_prio = VRS_DEFAULT_PRIORITY;
+	memset((*out_queue)->prio_map, 0, sizeof((*out_queue)->prio_map));
 
-	(*out_queue)->r_prio_sum_high = 0.0;
-	(*out_queue)->r_prio_sum_low = 0.0;
+	(*out_queue)->weight_sum_high = 0;
+	(*out_queue)->weight_sum_low = 0;
 
 	for(id=0; id<=MAX_PRIORITY; id++) {
 		if((*out_queue)->queues[id] != NULL) {
@@ -744,52 +1050,3 @@ uint32 v_out_queue_get_size(struct VOutQueue *out_queue)
 
 	return size;
 }
-
-uint8 v_out_queue_get_max_prio(struct VOutQueue *out_queue)
-{
-	uint8 max;
-
-	pthread_mutex_lock(&out_queue->lock);
-	max = out_queue->max_prio;
-	pthread_mutex_unlock(&out_queue->lock);
-
-	return max;
-}
-
-uint8 v_out_queue_get_min_prio(struct VOutQueue *out_queue)
-{
-	uint8 min;
-
-	pthread_mutex_lock(&out_queue->lock);
-	min = out_queue->min_prio;
-	pthread_mutex_unlock(&out_queue->lock);
-
-	return min;
-}
-
-real32 v_out_queue_get_prio(struct VOutQueue *out_queue, uint8 prio)
-{
-	return out_queue->queues[prio]->r_prio;
-}
-
-real32 v_out_queue_get_prio_sum_high(struct VOutQueue *out_queue)
-{
-	real32 r_prio;
-
-	pthread_mutex_lock(&out_queue->lock);
-	r_prio = out_queue->r_prio_sum_high;
-	pthread_mutex_unlock(&out_queue->lock);
-
-	return r_prio;
-}
-
-real32 v_out_queue_get_prio_sum_low(struct VOutQueue *out_queue)
-{
-	real32 r_prio;
-
-	pthread_mutex_lock(&out_queue->lock);
-	r_prio = out_queue->r_prio_sum_low;
-	pthread_mutex_unlock(&out_queue->lock);
-
-	return r_prio;
-}
@@ -0,0 +1,162 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "v_ready_ring.h"
+#include "v_common.h"
+
+/**
+ * \brief This function adds item to the ring. This function could be called
+ * from several threads concurrently.
+ *
+ * \param[in]	*ring	The pointer at ring
+ * \param[in]	*item	The pointer at item
+ *
+ * \return This function returns 1, when item was added to the ring and it
+ * returns 0, when the ring is full.
+ */
+int v_ready_ring_push(struct VReadyRing *ring, void *item)
+{
+	struct VReadyRingCell *cell;
+	uint32 pos, seq;
+	int32 diff;
+
+	pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+	while(1) {
+		cell = &ring->cells[pos & ring->mask];
+		seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+		diff = (int32)(seq - pos);
+
+		if(diff == 0) {
+			/* Cell is free, try to reserve it */
+			if(__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 0,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		} else if(diff < 0) {
+			/* Consumer didn't read this cell yet: ring is full */
+			return 0;
+		} else {
+			/* Other producer reserved this cell */
+			pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	cell->item = item;
+	__atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+/**
+ * \brief This function removes the oldest item from the ring. Only one
+ * thread can call this function.
+ *
+ * \param[in]	*ring	The pointer at ring
+ *
+ * \return This function returns the pointer at item or NULL, when the ring
+ * is empty.
+ */
+void *v_ready_ring_pop(struct VReadyRing *ring)
+{
+	struct VReadyRingCell *cell;
+	uint32 pos = ring->tail;
+	void *item;
+
+	cell = &ring->cells[pos & ring->mask];
+
+	if((int32)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1)) < 0) {
+		return NULL;
+	}
+
+	item = cell->item;
+	ring->tail = pos + 1;
+
+	/* Make this cell free for producers of next round */
+	__atomic_store_n(&cell->seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+
+	return item;
+}
+
+/**
+ * \brief This function initializes ring, that can hold at least size items
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+int v_ready_ring_init(struct VReadyRing *ring, uint32 size)
+{
+	uint32 i, length = 1;
+
+	while(length < size) {
+		length <<= 1;
+	}
+
+	ring->cells = (struct VReadyRingCell*)malloc(length * sizeof(struct VReadyRingCell));
+	if(ring->cells == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "malloc(): %s\n", strerror(errno));
+		ring->mask = 0;
+		return 0;
+	}
+
+	for(i = 0; i < length; i++) {
+		ring->cells[i].seq = i;
+		ring->cells[i].item = NULL;
+	}
+
+	ring->mask = length - 1;
+	ring->head = 0;
+	ring->tail = 0;
+
+	return 1;
+}
+
+/**
+ * \brief This function frees memory used by ring
+ */
+void v_ready_ring_destroy(struct VReadyRing *ring)
+{
+	if(ring->cells != NULL) {
+		free(ring->cells);
+		ring->cells = NULL;
+	}
+	ring->mask = 0;
+	ring->head = 0;
+	ring->tail = 0;
+}
@@ -224,6 +224,9 @@ void v_print_negotiate_cmd(const unsigned char level, struct Negotiate_Cmd *nego
 				case CMPR_ADDR_SHARE:
 					v_print_log_simple(level, "ADDR_SHARE, ");
 					break;
+				case CMPR_DEFLATE:
+					v_print_log_simple(level, "DEFLATE, ");
+					break;
 				}
 				break;
 			case FTR_RWIN_SCALE:
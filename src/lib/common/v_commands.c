@@ -45,6 +45,7 @@
 #include "v_unpack.h"
 #include "v_pack.h"
 #include "v_list.h"
+#include "v_slab.h"
 
 #include "v_commands.h"
 #include "v_fake_commands.h"
@@ -52,1541 +53,9 @@
 #include "v_taggroup_commands.h"
 #include "v_cmd_queue.h"
 #include "v_in_queue.h"
+#include "v_cmd_codec.h"
 
-/**
- * Definition of structure of all supported commands. Following array should be
- * automatically generated from configuration file. With following structure:
- *
- * Node_Cmd(SHARE_ADDR) {
- * }
- */
-const struct Cmd_Struct cmd_struct[MAX_CMD_ID+1] = {
-		{ 0 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 1 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 2 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 3 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 4 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 5 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 6 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 7 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 8 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 9 ,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 10,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 11,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 12,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 13,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 14,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 15,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 16,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 17,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 18,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 19,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 20,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 21,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 22,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 23,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 24,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 25,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 26,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 27,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 28,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 29,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 30,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 31,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{
-				CMD_NODE_CREATE,	/* 32 */
-				NODE_CMD | SHARE_ADDR,
-				UINT16_SIZE + UINT32_SIZE,	/* Address size */
-				UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT16_SIZE, /* Command size in memory */
-				UINT8_SIZE  + UINT8_SIZE  + UINT8_SIZE  + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT16_SIZE, /* Minimal command size in packet */
-				4,	/* Number of items */
-				2,	/* Number of items that are part of address */
-				"Node_Create",	/* Name of command */
-				{	/* Items */
-						{ITEM_UINT16, UINT16_SIZE, 0, "User_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT16_SIZE, "Parent_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT16_SIZE + UINT32_SIZE, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Custom_Type"}
-				}
-		},
-		{
-				CMD_NODE_DESTROY,	/* 33 */
-				NODE_CMD | REM_DUP,
-				UINT32_SIZE, /* Address size */
-				UINT32_SIZE, /* Command size in memory */
-				UINT8_SIZE  + UINT8_SIZE + UINT32_SIZE, /* Minimal command size in packet */
-				1, /* Number of items */
-				1, /* Number of items that are part of address */
-				"Node_Destroy",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"}
-				}
-		},
-		{
-				CMD_NODE_SUBSCRIBE,	/* 34 */
-				NODE_CMD | REM_DUP,
-				UINT32_SIZE, /* Address size */
-				UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, /* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, /* Minimal command size in packet */
-				3, /* Number of items */
-				1, /* Number of items that are part of address */
-				"Node_Subscribe",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT32_SIZE, "CRC_32"}
-				}
-		},
-		{
-				CMD_NODE_UNSUBSCRIBE,	/* 35 */
-				NODE_CMD | REM_DUP,
-				UINT32_SIZE, /* Address size */
-				UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, /* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, /* Minimal command size in packet */
-				3,
-				1,
-				"Node_UnSubscribe",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT32_SIZE, "CRC_32"}
-				}
-		},
-		{ 36,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{
-				CMD_NODE_LINK,			/* 37 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE,
-				UINT32_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT32_SIZE,
-				2,
-				1,
-				"Node_Link",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Parent_Node_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE, "Child_Node_ID"}
-				}
-		},
-		{
-				CMD_NODE_PERMISSION,		/* 38 */
-				NODE_CMD | SHARE_ADDR,		/* flags*/
-				UINT16_SIZE + UINT8_SIZE,	/* Address size */
-				UINT16_SIZE + UINT8_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE + UINT8_SIZE + UINT32_SIZE,	/* Minimal command size in packet */
-				3,	/* Number of items */
-				2,	/* Number of items that are part of address */
-				"Node_Permision",	/* Name */
-				{
-						{ITEM_UINT16, UINT16_SIZE, 0, "User_ID"},
-						{ITEM_UINT8,  UINT8_SIZE,  UINT16_SIZE, "Permissions"},
-						{ITEM_UINT32, UINT32_SIZE, UINT16_SIZE + UINT8_SIZE, "Node_ID"},
-				}
-		},
-		{
-				CMD_DEFAULT_PERMISSION,		/* 39 */
-				0,
-				0,
-				0,
-				0,
-				0,
-				0,
-				"Default_Node_Permissions",
-				{
-						{ITEM_RESERVED,0,0,""},
-				}
-		},
-		{
-				CMD_NODE_OWNER,				/* 40*/
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT16_SIZE,				/* Address size */
-				UINT16_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE + UINT32_SIZE,	/* Minimal command size in packet */
-				2,	/* Number of items */
-				1,	/* Number of items that are part of address */
-				"Node_Owner",
-				{
-						{ITEM_UINT16, UINT16_SIZE, 0, "User_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT16_SIZE, "Node_ID"}
-				}
-		},
-		{
-				CMD_NODE_LOCK,				/* 41 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE,	/* Address size */
-				UINT32_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT32_SIZE, /* Minimal command size in packet */
-				2,	/* Number of items */
-				1,	/* Number of items, that are part of address */
-				"Node_Lock",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Avatar_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE, "Node_ID"}
-				}
-		},
-		{
-				CMD_NODE_UNLOCK,			/* 42 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE,				/* Address size */
-				UINT32_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT32_SIZE, /* Minimal command size in packet */
-				2,		/* Number of items */
-				1,		/* Number of items, that are part of address */
-				"Node_UnLock",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Avatar_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE, "Node_ID"}
-				}
-		},
-		{
-				CMD_NODE_PRIORITY,	/* 43 */
-				NODE_CMD | SHARE_ADDR,
-				UINT8_SIZE,
-				UINT8_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE,
-				2,
-				1,
-				"Node_Priority",
-				{
-						{ITEM_UINT8,  UINT8_SIZE, 0, "Priority"},
-						{ITEM_UINT32, UINT32_SIZE, UINT8_SIZE, "Node_ID"}
-				}
-		},
-		{ 44,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 45,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 46,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 47,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 48,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 49,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 50,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 51,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 52,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 53,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 54,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 55,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 56,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 57,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 58,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 59,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 60,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 61,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 62,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{ 63,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		/* TagGroup and Tag Commands */
-		{
-				CMD_TAGGROUP_CREATE,	/* 64 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE,	/* Address size */
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, /* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, /* Minimal command size in packet */
-				3,
-				1,
-				"TagGroup_Create",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Custom_Type"}
-				}
-		},
-		{
-				CMD_TAGGROUP_DESTROY,	/* 65 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE,
-				UINT32_SIZE + UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE,
-				2,
-				1,
-				"TagGroup_Destroy",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"}
-				}
-		},
-		{
-				CMD_TAGGROUP_SUBSCRIBE,	/* 66 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE,
-				UINT32_SIZE + UINT16_SIZE  + UINT32_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				4,
-				1,
-				"TagGroup_Subscribe",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "CRC32"}
-				}
-		},
-		{
-				CMD_TAGGROUP_UNSUBSCRIBE,	/* 67 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				4,
-				1,
-				"TagGroup_Unsubscribe",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "CRC32"}
-				}
-		},
-		{
-				CMD_TAG_CREATE,		/* 68 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE, /* Minimal command size in packet */
-				6,
-				2,
-				"Tag_Create",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT8,  UINT8_SIZE,  UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Data_Type"},
-						{ITEM_UINT8,  UINT8_SIZE,  UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE, "Count"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE, "Custom_Type"}
-				}
-		},
-		{
-				CMD_TAG_DESTROY,	/* 69 */
-				NODE_CMD | SHARE_ADDR,
-				UINT32_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				3,
-				2,
-				"Tag_Destroy",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"}
-				}
-		},
-		/* Uint8 */
-		{
-				CMD_TAG_SET_UINT8,	/* 70 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT8_SIZE,
-				4,
-				3,
-				"Tag_Set_UInt8_Scalar",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_UINT8,	/* 71 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT8_SIZE,
-				5,
-				3,
-				"Tag_Set_UInt8_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_UINT8,	/* 72 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT8_SIZE,
-				6,
-				3,
-				"Tag_Set_UInt8_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE, "Value[1]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[2]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_UINT8,	/* 73 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT8_SIZE,
-				7,
-				3,
-				"Tag_Set_UInt8_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE, "Value[1]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[2]"},
-						{ITEM_UINT8,   UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[3]"}
-				}
-		},
-		/* Uint16 */
-		{
-				CMD_TAG_SET_UINT16,	/* 74 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT16_SIZE,
-				4,
-				3,
-				"Tag_Set_UInt16",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_UINT16,	/* 75 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT16_SIZE,
-				5,
-				3,
-				"Tag_Set_UInt16_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_UINT16,	/* 76 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT16_SIZE,
-				6,
-				3,
-				"Tag_Set_UInt16_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[1]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[2]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_UINT16,	/* 77 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT16_SIZE,
-				7,
-				3,
-				"Tag_Set_UInt16_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[1]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[2]"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[3]"}
-				}
-		},
-		/* Uint32 */
-		{
-				CMD_TAG_SET_UINT32,	/* 78 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE,
-				4,
-				3,
-				"Tag_Set_UInt32",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_UINT32,	/* 79 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT32_SIZE,
-				5,
-				3,
-				"Tag_Set_UInt32_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_UINT32,	/* 80 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT32_SIZE,
-				6,
-				3,
-				"Tag_Set_UInt32_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[1]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[2]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_UINT32,	/* 81 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT32_SIZE,
-				7,
-				3,
-				"Tag_Set_UInt32_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[1]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[2]"},
-						{ITEM_UINT32,  UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[3]"}
-				}
-		},
-		/* Uint64 */
-		{
-				CMD_TAG_SET_UINT64,	/* 82 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*UINT64_SIZE,
-				4,
-				3,
-				"Tag_Set_UInt64",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_UINT64,	/* 83 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*UINT64_SIZE,
-				5,
-				3,
-				"Tag_Set_Vec2_UInt64",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_UINT64,	/* 84 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*UINT64_SIZE,
-				6,
-				3,
-				"Tag_Set_Vec3_UInt64",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE, "Value[1]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[2]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_UINT64,	/* 85 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*UINT64_SIZE,
-				7,
-				3,
-				"Tag_Set_Vec4_UInt64",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE, "Value[1]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[2]"},
-						{ITEM_UINT64,  UINT64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT64_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[3]"}
-				}
-		},
-		/* Real16 */
-		{
-				CMD_TAG_SET_REAL16,	/* 86 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*REAL16_SIZE,
-				4,
-				3,
-				"Tag_Set_Real16",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_REAL16,	/* 87 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL16_SIZE,
-				5,
-				3,
-				"Tag_Set_Real16_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_REAL16,	/* 88 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL16_SIZE,
-				6,
-				3,
-				"Tag_Set_Real16_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL16_SIZE, "Value[1]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_REAL16,	/* 89 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL16_SIZE,
-				7,
-				3,
-				"Tag_Set_Real16_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL16_SIZE, "Value[1]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[2]"},
-						{ITEM_REAL16,  REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL16_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[3]"},
-				}
-		},
-		/* Real32 */
-		{
-				CMD_TAG_SET_REAL32,	/* 90 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE,
-				4,
-				3,
-				"Tag_Set_Real32",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_REAL32,	/* 91 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL32_SIZE,
-				5,
-				3,
-				"Tag_Set_Real32_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE, "Value[1]"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_REAL32,	/* 92 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL32_SIZE,
-				6,
-				3,
-				"Tag_Set_Real16_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE, "Value[1]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_TAG_SET_VEC4_REAL32,	/* 93 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL32_SIZE,
-				7,
-				3,
-				"Tag_Set_Real32_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE, "Value[1]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[2]"},
-						{ITEM_REAL32,  REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL32_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[3]"},
-				}
-		},
-		/* Real64 */
-		{
-				CMD_TAG_SET_REAL64,	/* 94 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 1*REAL64_SIZE,
-				4,
-				3,
-				"Tag_Set_Real64",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_REAL64,	/* 95 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 2*REAL64_SIZE,
-				5,
-				3,
-				"Tag_Set_Real64_Vec2",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_TAG_SET_VEC3_REAL64,	/* 96 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 3*REAL64_SIZE,
-				6,
-				3,
-				"Tag_Set_Real64_Vec3",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE, "Value[1]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_TAG_SET_VEC2_REAL64,	/* 97 */
-				NODE_CMD | SHARE_ADDR | REM_DUP,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + 4*REAL64_SIZE,
-				7,
-				3,
-				"Tag_Set_Real64_Vec4",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[0]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE, "Value[1]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[2]"},
-						{ITEM_REAL64,  REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + REAL64_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[3]"}
-				}
-		},
-		/* String8 */
-		{
-				CMD_TAG_SET_STRING8,	/* 98 */
-				NODE_CMD | SHARE_ADDR | REM_DUP | VAR_LEN,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE,
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + STRING8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE,
-				4,
-				3,
-				"Tag_Set_String8",
-				{
-						{ITEM_UINT32,  UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE, "TagGroup_ID"},
-						{ITEM_UINT16,  UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Tag_ID"},
-						{ITEM_STRING8, STRING8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value"}
-				}
-		},
-		{ 99,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-
-		{100,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{101,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{102,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{103,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{104,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{105,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{106,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{107,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{108,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{109,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{110,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{111,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{112,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{113,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{114,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{115,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{116,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{117,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{118,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{119,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{120,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{121,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{122,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{123,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{124,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{125,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{126,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{127,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-
-		/* Layers commands */
-		{
-				CMD_LAYER_CREATE,			/* 128 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address size */
-				UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE + UINT16_SIZE,	/* Minimal command size in packet */
-				6,							/* Number of items */
-				2,							/* Number of items that are part of address */
-				"Layer_Create",				/* Command name */
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Parent_Layer_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE + UINT16_SIZE, "Layer_ID"},
-						{ITEM_UINT8, UINT8_SIZE,  UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Data_Type"},
-						{ITEM_UINT8, UINT8_SIZE,  UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE, "Count"},
-						{ITEM_UINT16, UINT16_SIZE,  UINT32_SIZE + UINT16_SIZE + UINT16_SIZE + UINT8_SIZE + UINT8_SIZE, "Custom_Type"}
-				}
-		},
-		{
-				CMD_LAYER_DESTROY,			/* 129 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE,				/* Address size */
-				UINT32_SIZE + UINT16_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE,
-				2,							/* Number of items */
-				1,							/* Number of items that are part of address */
-				"Layer_Destroy",			/* Command name */
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"}
-
-				}
-		},
-		{
-				CMD_LAYER_SUBSCRIBE,		/* 130 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE,				/* Address size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				4,							/* Number of items */
-				1,							/* Number of items that are part of address */
-				"Layer_Subscribe",			/* Command name */
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "CRC32"}
-				}
-		},
-		{
-				CMD_LAYER_UNSUBSCRIBE,		/* 131 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE,				/* Address size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				4,							/* Number of items */
-				1,							/* Number of items that are part of address */
-				"Layer_UnSubscribe",		/* Command name */
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Version"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "CRC32"}
-				}
-		},
-		{
-				CMD_LAYER_UNSET_VALUE,		/* 132 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE,	/* Command size in memory */
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE,
-				3,							/* Number of items */
-				2,							/* Number of items that are part of address */
-				"Layer_UnSet_Value",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-				}
-		},
-		/* Uint8 */
-		{
-				CMD_LAYER_SET_UINT8,		/* 133 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Uint8",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_UINT8,	/* 134 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT8_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Uint8_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_UINT8,	/* 135 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT8_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Uint8_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE, "Value[1]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_UINT8,	/* 136 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT8_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT8_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Uint8_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE, "Value[1]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[2]"},
-						{ITEM_UINT8,  UINT8_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT8_SIZE + UINT8_SIZE + UINT8_SIZE, "Value[3]"},
-				}
-		},
-		/* Uint16 */
-		{
-				CMD_LAYER_SET_UINT16,		/* 137 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Uint16",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_UINT16,	/* 138 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT16_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Uint16_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_UINT16,	/* 139 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT16_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Uint16_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE, "Value[1]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_UINT16,	/* 140 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT16_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Uint16_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE, "Value[1]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE, "Value[2]"},
-						{ITEM_UINT16, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT16_SIZE + UINT16_SIZE  + UINT16_SIZE, "Value[3]"},
-				}
-		},
-		/* Uint32 */
-		{
-				CMD_LAYER_SET_UINT32,		/* 141 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Uint32",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_UINT32,	/* 142 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT32_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Uint32_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_UINT32,	/* 143 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT32_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Uint32_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[1]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_UINT32,	/* 144 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT32_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Uint32_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[1]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[2]"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE + UINT32_SIZE, "Value[3]"},
-				}
-		},
-		/* Uint64 */
-		{
-				CMD_LAYER_SET_UINT64,		/* 145 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Uint64",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_UINT64,	/* 146 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*UINT64_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Uint64_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_UINT64,	/* 147 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*UINT64_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Uint64_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE, "Value[1]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_UINT64,	/* 148 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*UINT64_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Uint64_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE, "Value[1]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[2]"},
-						{ITEM_UINT64, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT64_SIZE + UINT64_SIZE + UINT64_SIZE, "Value[3]"},
-				}
-		},
-		/* Real16 */
-		{
-				CMD_LAYER_SET_REAL16,		/* 149 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Real16",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_REAL16,	/* 150 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL16_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Real16_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_REAL16,	/* 151 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL16_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Real16_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE, "Value[1]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_REAL16,	/* 152 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL16_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL16_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Real16_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE, "Value[1]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[2]"},
-						{ITEM_REAL16, REAL16_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL16_SIZE + REAL16_SIZE + REAL16_SIZE, "Value[3]"},
-				}
-		},
-		/* Real32 */
-		{
-				CMD_LAYER_SET_REAL32,		/* 153 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Real32",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_REAL32,	/* 154 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL32_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Real32_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_REAL32,	/* 155 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL32_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Real32_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE, "Value[1]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_REAL32,	/* 156 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL32_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL32_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Real32_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE, "Value[1]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[2]"},
-						{ITEM_REAL32, REAL32_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL32_SIZE + REAL32_SIZE + REAL32_SIZE, "Value[3]"},
-				}
-		},
-		/* Real64 */
-		{
-				CMD_LAYER_SET_REAL64,		/* 157 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE,
-				4,
-				2,
-				"Layer_Set_Value_Real64",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC2_REAL64,	/* 158 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 2*REAL64_SIZE,
-				5,
-				2,
-				"Layer_Set_Value_Real64_Vec2",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE, "Value[1]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC3_REAL64,	/* 159 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 3*REAL64_SIZE,
-				6,
-				2,
-				"Layer_Set_Value_Real64_Vec3",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE, "Value[1]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[2]"},
-				}
-		},
-		{
-				CMD_LAYER_SET_VEC4_REAL64,	/* 159 */
-				NODE_CMD | SHARE_ADDR,		/* Flags */
-				UINT32_SIZE + UINT16_SIZE,	/* Address Size */
-				UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL64_SIZE,
-				UINT8_SIZE + UINT8_SIZE + UINT8_SIZE + UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + 4*REAL64_SIZE,
-				7,
-				2,
-				"Layer_Set_Value_Real64_Vec4",
-				{
-						{ITEM_UINT32, UINT32_SIZE, 0, "Node_ID"},
-						{ITEM_UINT16, UINT16_SIZE, UINT32_SIZE, "Layer_ID"},
-						{ITEM_UINT32, UINT32_SIZE, UINT32_SIZE + UINT16_SIZE, "Item_ID"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE, "Value[0]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE, "Value[1]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[2]"},
-						{ITEM_REAL64, REAL64_SIZE, UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + REAL64_SIZE + REAL64_SIZE + REAL64_SIZE, "Value[3]"},
-				}
-		},
-
-		{161,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{162,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{163,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{164,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{165,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{166,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{167,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{168,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{169,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{170,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{171,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{172,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{173,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{174,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{175,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{176,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{177,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{178,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{179,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{180,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{181,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{182,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{183,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{184,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{185,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{186,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{187,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{188,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{189,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{190,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{191,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{192,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{193,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{194,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{195,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{196,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{197,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{198,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{199,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-
-		{200,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{201,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{202,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{203,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{204,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{205,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{206,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{207,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{208,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{209,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{210,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{211,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{212,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{213,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{214,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{215,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{216,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{217,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{218,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{219,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{220,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{221,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{222,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{223,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{224,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{225,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{226,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{227,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{228,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{229,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{230,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{231,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{232,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{233,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{234,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{235,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{236,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{237,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{238,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{239,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{240,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{241,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{242,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{243,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{244,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{245,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{246,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{247,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{248,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{249,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{250,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{251,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{252,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{253,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{254,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}},
-		{255,0,0,0,0,0,0,"",{{ITEM_RESERVED,0,0,""},}}
-};
+extern const struct Cmd_Struct cmd_struct[];
 
 /**
  * \brief This function prints content of the command
@@ -1646,26 +115,98 @@ void v_cmd_print(const unsigned char level,
 	}
 }
 
+/**
+ * Header allocated in front of every regular (node) command. One command
+ * could be shared by outgoing queues and histories of several sessions, when
+ * server sends the same change to many subscribers. Such command is immutable
+ * and it is freed, when the last reference at it is dropped.
+ */
+typedef union VCmdHeader {
+	uint32			refs;		/* Number of references at the command */
+	uint64			align;		/* Keep data of command aligned */
+} VCmdHeader;
+
+#define V_CMD_HEADER(cmd)	((union VCmdHeader*)((uint8*)(cmd) - sizeof(union VCmdHeader)))
+
+/* Size of memory allocated for command with header */
+#define V_CMD_ALLOC_SIZE(cmd_id)	(sizeof(union VCmdHeader) + UINT8_SIZE + cmd_struct[cmd_id].size)
+
+/**
+ * \brief This function allocates memory for regular command with cmd_id.
+ *
+ * Own data of command are not initialized. The new command has one reference
+ * and it has to be destroyed with v_cmd_destroy().
+ *
+ * \param[in]	cmd_id	The ID of regular command
+ *
+ * \return This function returns pointer at new command or NULL, when it was
+ * not possible to allocate memory.
+ */
+struct Generic_Cmd *v_cmd_alloc(const uint8 cmd_id)
+{
+	union VCmdHeader *header;
+	struct Generic_Cmd *cmd;
+
+	assert(cmd_id >= MIN_CMD_ID);
+
+	header = (union VCmdHeader*)v_slab_alloc(V_CMD_ALLOC_SIZE(cmd_id));
+	if(header == NULL) {
+		return NULL;
+	}
+
+	header->refs = 1;
+
+	cmd = (struct Generic_Cmd*)(header + 1);
+	cmd->id = cmd_id;
+
+	return cmd;
+}
+
+/**
+ * \brief This function adds new reference at regular command.
+ *
+ * It is used, when one command is pushed to the outgoing queues of several
+ * sessions. Every reference has to be dropped with v_cmd_destroy(). Shared
+ * command must not be modified.
+ *
+ * \param[in]	*cmd	The pointer at regular command
+ *
+ * \return This function returns pointer at the same command.
+ */
+struct Generic_Cmd *v_cmd_share(struct Generic_Cmd *cmd)
+{
+	assert(cmd->id >= MIN_CMD_ID);
+
+	__atomic_add_fetch(&V_CMD_HEADER(cmd)->refs, 1, __ATOMIC_RELAXED);
+
+	return cmd;
+}
+
 /**
  * \brief This function destroy command.
  *
  * This function should be called, when command is removed from the queue or
- * history of sent commands.
+ * history of sent commands. Regular command is freed, when the last
+ * reference at it is dropped.
  */
 void v_cmd_destroy(struct Generic_Cmd **cmd)
 {
 	if( (*cmd)->id >= MIN_CMD_ID ) {
 		/* Regular commands */
-		if( cmd_struct[(*cmd)->id].flag & VAR_LEN ) {
-			int i;
-			for(i=0; i< cmd_struct[(*cmd)->id].item_count; i++) {
-				if(cmd_struct[(*cmd)->id].items[i].type == ITEM_STRING8) {
-					/* Free string */
-					free(PTR((*cmd)->data[cmd_struct[(*cmd)->id].items[i].offset]));
+		union VCmdHeader *header = V_CMD_HEADER(*cmd);
+
+		if(__atomic_sub_fetch(&header->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+			if( cmd_struct[(*cmd)->id].flag & VAR_LEN ) {
+				int i;
+				for(i=0; i< cmd_struct[(*cmd)->id].item_count; i++) {
+					if(cmd_struct[(*cmd)->id].items[i].type == ITEM_STRING8) {
+						/* Free string */
+						free(PTR((*cmd)->data[cmd_struct[(*cmd)->id].items[i].offset]));
+					}
 				}
 			}
+			v_slab_free(header, V_CMD_ALLOC_SIZE((*cmd)->id));
 		}
-		free(*cmd);
 		*cmd = NULL;
 	} else {
 		/* Fake commands */
@@ -1734,12 +275,268 @@ uint16 v_cmd_unpack_len(const char *buffer,
 	return buffer_pos;
 }
 
+/**
+ * \brief This function returns number of items, that start at the item with
+ * index first_item and that could be packed or unpacked as one array.
+ *
+ * Such items have the same type and they are stored in continuous block of
+ * memory (e.g. components of vector values). Only items with size 2, 4 or 8
+ * bytes are merged to arrays.
+ *
+ * \param[in]	*cmd_str	The structure describing command
+ * \param[in]	first_item	The index of the first item
+ * \param[in]	last_item	The index of item following the last item
+ *
+ * \return This function returns number of items in array (at least 1).
+ */
+static int _v_cmd_items_array_len(const struct Cmd_Struct *cmd_str,
+		int first_item,
+		int last_item)
+{
+	const struct Cmd_Item *item = &cmd_str->items[first_item];
+	int j;
+
+	switch(item->type) {
+	case ITEM_INT16:
+	case ITEM_UINT16:
+	case ITEM_REAL16:
+	case ITEM_INT32:
+	case ITEM_UINT32:
+	case ITEM_REAL32:
+	case ITEM_INT64:
+	case ITEM_UINT64:
+	case ITEM_REAL64:
+		break;
+	default:
+		return 1;
+	}
+
+	for(j = first_item + 1;
+			j < last_item &&
+			cmd_str->items[j].type == item->type &&
+			cmd_str->items[j].offset == item->offset + (j - first_item)*item->size;
+			j++)
+	{
+	}
+
+	return j - first_item;
+}
+
+/**
+ * \brief This function unpacks items of command with fixed length from the
+ * buffer.
+ *
+ * \param[in]	*buffer		The buffer with the first unpacked item
+ * \param[out]	*cmd		The command filled with unpacked items
+ * \param[in]	first_item	The index of the first unpacked item
+ * \param[in]	last_item	The index of item following the last unpacked item
+ *
+ * \return This function returns count of unpacked bytes.
+ */
+static uint32 _v_cmd_unpack_items(const char *buffer,
+		struct Generic_Cmd *cmd,
+		int first_item,
+		int last_item)
+{
+	uint32 buffer_pos = 0;
+	int j, count;
+
+	/* Use function generated for this command, when all remaining items
+	 * are unpacked */
+	if(last_item == cmd_struct[cmd->id].item_count &&
+			v_cmd_unpack_funcs[cmd->id] != NULL)
+	{
+		return v_cmd_unpack_funcs[cmd->id](buffer, cmd, first_item);
+	}
+
+	for(j = first_item; j < last_item; j += count) {
+		/* Vectors of values are unpacked at once */
+		count = _v_cmd_items_array_len(&cmd_struct[cmd->id], j, last_item);
+		if(count > 1) {
+			void *data = &cmd->data[cmd_struct[cmd->id].items[j].offset];
+			switch(cmd_struct[cmd->id].items[j].size) {
+			case 2:
+				buffer_pos += vnp_raw_unpack_uint16_array(&buffer[buffer_pos], data, count);
+				break;
+			case 4:
+				buffer_pos += vnp_raw_unpack_uint32_array(&buffer[buffer_pos], data, count);
+				break;
+			case 8:
+				buffer_pos += vnp_raw_unpack_uint64_array(&buffer[buffer_pos], data, count);
+				break;
+			}
+			continue;
+		}
+
+		switch(cmd_struct[cmd->id].items[j].type) {
+		case ITEM_RESERVED:
+			assert(cmd_struct[cmd->id].items[j].type==ITEM_RESERVED);
+			break;
+		case ITEM_INT8:
+		case ITEM_UINT8:
+			buffer_pos += vnp_raw_unpack_uint8(&buffer[buffer_pos],
+					(uint8*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_INT16:
+		case ITEM_UINT16:
+			buffer_pos += vnp_raw_unpack_uint16(&buffer[buffer_pos],
+					(uint16*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_INT32:
+		case ITEM_UINT32:
+			buffer_pos += vnp_raw_unpack_uint32(&buffer[buffer_pos],
+					(uint32*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_INT64:
+		case ITEM_UINT64:
+			buffer_pos += vnp_raw_unpack_uint64(&buffer[buffer_pos],
+					(uint64*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_REAL16:
+			buffer_pos += vnp_raw_unpack_real16(&buffer[buffer_pos],
+					(real16*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_REAL32:
+			buffer_pos += vnp_raw_unpack_real32(&buffer[buffer_pos],
+					(real32*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_REAL64:
+			buffer_pos += vnp_raw_unpack_real64(&buffer[buffer_pos],
+					(real64*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
+			break;
+		case ITEM_STRING8:
+			/* Only command with variable length can include string */
+			assert(0);
+			break;
+		}
+	}
+
+	return buffer_pos;
+}
+
+/**
+ * \brief This function creates receive buffer with copy of received node
+ * commands. The buffer has one reference.
+ *
+ * Buffer of connection is reused for next received packet and for sending of
+ * packets, then received data are copied once to the buffer, that could be
+ * shared by views of commands.
+ *
+ * \return This function returns pointer at new buffer or NULL, when it was
+ * not possible to allocate memory.
+ */
+struct VCmdBuffer *v_cmd_buffer_create(const char *data, uint16 size)
+{
+	struct VCmdBuffer *cmd_buffer;
+
+	cmd_buffer = (struct VCmdBuffer*)malloc(offsetof(struct VCmdBuffer, data) + size);
+	if(cmd_buffer == NULL) {
+		return NULL;
+	}
+
+	cmd_buffer->refs = 1;
+	cmd_buffer->size = size;
+	memcpy(cmd_buffer->data, data, size);
+
+	return cmd_buffer;
+}
+
+/**
+ * \brief This function adds new reference at receive buffer.
+ */
+struct VCmdBuffer *v_cmd_buffer_ref(struct VCmdBuffer *cmd_buffer)
+{
+	__atomic_add_fetch(&cmd_buffer->refs, 1, __ATOMIC_RELAXED);
+
+	return cmd_buffer;
+}
+
+/**
+ * \brief This function drops reference at receive buffer. The buffer is
+ * freed, when the last reference is dropped.
+ */
+void v_cmd_buffer_release(struct VCmdBuffer **cmd_buffer)
+{
+	if(*cmd_buffer != NULL) {
+		if(__atomic_sub_fetch(&(*cmd_buffer)->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+			free(*cmd_buffer);
+		}
+		*cmd_buffer = NULL;
+	}
+}
+
+/**
+ * \brief This function decodes one command from the view of commands. Fields
+ * are unpacked directly from the receive buffer.
+ *
+ * \param[in]	*view	The view of commands
+ * \param[in]	index	The index of command in the view
+ * \param[out]	*cmd	The command (at least CMD_VIEW_MAX_CMD_SIZE bytes)
+ *
+ * \return This function returns 1, when command was decoded. It returns 0,
+ * when index is out of view or the view is malformed (no buffer, unsupported
+ * command or command is not in the buffer).
+ */
+int v_cmd_view_get(const struct Cmd_View_Cmd *view,
+		uint16 index,
+		struct Generic_Cmd *cmd)
+{
+	const char *data;
+	uint32 pos = 0, end;
+
+	if(view == NULL || view->buffer == NULL || index >= view->count) {
+		return 0;
+	}
+
+	if( !(cmd_struct[view->cmd_id].flag & NODE_CMD) ||
+			(cmd_struct[view->cmd_id].flag & VAR_LEN) ||
+			view->share > cmd_struct[view->cmd_id].size ||
+			UINT8_SIZE + cmd_struct[view->cmd_id].size > CMD_VIEW_MAX_CMD_SIZE)
+	{
+		return 0;
+	}
+
+	/* Command has to be complete in the receive buffer */
+	if(index > 0) {
+		pos = cmd_struct[view->cmd_id].size +
+				(index - 1) * (cmd_struct[view->cmd_id].size - view->share);
+		end = view->offset + pos +
+				cmd_struct[view->cmd_id].size - view->share;
+	} else {
+		end = view->offset + cmd_struct[view->cmd_id].size;
+	}
+	if(end > view->buffer->size) {
+		return 0;
+	}
+
+	data = &view->buffer->data[view->offset];
+	cmd->id = view->cmd_id;
+
+	if(index == 0) {
+		_v_cmd_unpack_items(data, cmd, 0, cmd_struct[cmd->id].item_count);
+	} else {
+		/* Shared address is included only in the first command */
+		_v_cmd_unpack_items(data, cmd, 0, view->skip_items);
+		_v_cmd_unpack_items(&data[pos], cmd, view->skip_items,
+				cmd_struct[cmd->id].item_count);
+	}
+
+	return 1;
+}
+
 /**
  * \brief This function unpack one command from the buffer
+ *
+ * When cmd_buffer is not NULL, then commands compressed to one long command
+ * are not decoded. View of these commands is added to the queue instead and
+ * received data are copied to cmd_buffer (created for the first view).
  */
 static int _v_cmd_unpack(const char *buffer,
 		unsigned short buffer_len,
-		struct VInQueue *v_in_queue)
+		struct VInQueue *v_in_queue,
+		const char *packet,
+		unsigned short packet_len,
+		struct VCmdBuffer **cmd_buffer)
 {
 	struct Generic_Cmd *cmd, *first_cmd = NULL;
 	uint32 buffer_pos = 0;
@@ -1808,7 +605,7 @@ static int _v_cmd_unpack(const char *buffer,
 
 	/* Check the length of the command, when length of command isn't variable */
 	if( !( cmd_struct[cmd_id].flag & VAR_LEN) ) {
-		int count=0;
+		int count=0, view_count;
 		if( ((length - cmd_addr_len) % cmd_data_len) != 0) {
 			v_print_log(VRS_PRINT_WARNING, "Bad length: %d != %d+(N*%d) of Node_Create command, skipping this command.\n",
 					length, cmd_addr_len, cmd_data_len);
@@ -1819,64 +616,58 @@ static int _v_cmd_unpack(const char *buffer,
 
 		/* TODO: check if commands could be unpacked (enough buffer size) */
 
+		/* Add only view of commands to the queue, when it is allowed. View
+		 * can't include commands, that are not in the received buffer. */
+		view_count = count;
+		if(length > buffer_len) {
+			view_count = (buffer_len > cmd_addr_len) ?
+					(buffer_len - cmd_addr_len) / cmd_data_len : 0;
+		}
+		if(cmd_buffer != NULL &&
+				view_count >= CMD_VIEW_MIN_COUNT &&
+				UINT8_SIZE + cmd_struct[cmd_id].size <= CMD_VIEW_MAX_CMD_SIZE)
+		{
+			if(*cmd_buffer == NULL) {
+				*cmd_buffer = v_cmd_buffer_create(packet, packet_len);
+			}
+			if(*cmd_buffer != NULL) {
+				cmd = v_fake_cmd_view_create(*cmd_buffer,
+						(uint16)((buffer - packet) + buffer_pos),
+						cmd_id, share, skip_items, view_count);
+				if(cmd != NULL) {
+					/* Print view before it is pushed, because data thread
+					 * could handle it and destroy it immediately */
+					if(is_log_level(VRS_PRINT_DEBUG_MSG)) {
+						printf("%c[%d;%dm", 27, 1, 34);
+						v_fake_cmd_print(VRS_PRINT_DEBUG_MSG, cmd);
+						printf("%c[%dm", 27, 0);
+					}
+					if(v_in_queue_push(v_in_queue, cmd) == 1) {
+						return buffer_pos + share + view_count*cmd_data_len;
+					}
+					/* Queue contains commands with the same ID, then
+					 * commands have to be decoded */
+					v_cmd_destroy(&cmd);
+				}
+			}
+		}
+
 		/* Unpack own commands compressed to this command */
 		for(i=0; (i < count) && (buffer_pos < buffer_len); i++) {
 			/* This creates new command */
-			cmd = (struct Generic_Cmd*)malloc((UINT8_SIZE + cmd_struct[cmd_id].size)*sizeof(uint8));
-			cmd->id = cmd_id;
+			cmd = v_cmd_alloc(cmd_id);
 
 			if( (share > 0) && (i > 0) ) {
 				memcpy(cmd->data, first_cmd->data, share);
 			}
 
-			for(j = (i==0) ? 0 : skip_items ; j<cmd_struct[cmd_id].item_count; j++) {
-				switch(cmd_struct[cmd_id].items[j].type) {
-				case ITEM_RESERVED:
-					assert(cmd_struct[cmd_id].items[j].type==ITEM_RESERVED);
-					break;
-				case ITEM_INT8:
-				case ITEM_UINT8:
-					buffer_pos += vnp_raw_unpack_uint8(&buffer[buffer_pos],
-							(uint8*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_INT16:
-				case ITEM_UINT16:
-					buffer_pos += vnp_raw_unpack_uint16(&buffer[buffer_pos],
-							(uint16*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_INT32:
-				case ITEM_UINT32:
-					buffer_pos += vnp_raw_unpack_uint32(&buffer[buffer_pos],
-							(uint32*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_INT64:
-				case ITEM_UINT64:
-					buffer_pos += vnp_raw_unpack_uint64(&buffer[buffer_pos],
-							(uint64*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_REAL16:
-					buffer_pos += vnp_raw_unpack_real16(&buffer[buffer_pos],
-							(real16*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_REAL32:
-					buffer_pos += vnp_raw_unpack_real32(&buffer[buffer_pos],
-							(real32*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_REAL64:
-					buffer_pos += vnp_raw_unpack_real64(&buffer[buffer_pos],
-							(real64*)&cmd->data[cmd_struct[cmd->id].items[j].offset]);
-					break;
-				case ITEM_STRING8:
-					/* Only command with variable length can include string */
-					assert(0);
-					break;
-				}
-			}
+			buffer_pos += _v_cmd_unpack_items(&buffer[buffer_pos], cmd,
+					(i==0) ? 0 : skip_items, cmd_struct[cmd_id].item_count);
 
 			/* Copy content of first command, when address the first command is
 			 * shared */
 			if(share > 0 && i==0) {
-				first_cmd = (struct Generic_Cmd*)calloc((UINT8_SIZE + cmd_struct[cmd_id].size), sizeof(uint8));
+				first_cmd = (struct Generic_Cmd*)v_slab_alloc(UINT8_SIZE + cmd_struct[cmd_id].size);
 				memcpy(first_cmd, cmd, (UINT8_SIZE + cmd_struct[cmd_id].size)*sizeof(uint8));
 			}
 
@@ -1892,14 +683,13 @@ static int _v_cmd_unpack(const char *buffer,
 		}
 
 		if(first_cmd != NULL) {
-			free(first_cmd);
+			v_slab_free(first_cmd, UINT8_SIZE + cmd_struct[cmd_id].size);
 			first_cmd = NULL;
 		}
 	} else {
 		for(i=0; buffer_pos<length; i++) {
 			/* This create new command */
-			cmd = (struct Generic_Cmd*)malloc((UINT8_SIZE + cmd_struct[cmd_id].size)*sizeof(uint8));
-			cmd->id = cmd_id;
+			cmd = v_cmd_alloc(cmd_id);
 
 			if( (share > 0) && (i > 0) ) {
 				memcpy(cmd->data, first_cmd->data, share);
@@ -1953,7 +743,7 @@ static int _v_cmd_unpack(const char *buffer,
 			/* Copy content of first command, when address the first command is
 			 * shared */
 			if(share > 0 && i==0) {
-				first_cmd = (struct Generic_Cmd*)calloc((UINT8_SIZE + cmd_struct[cmd_id].size), sizeof(uint8));
+				first_cmd = (struct Generic_Cmd*)v_slab_alloc(UINT8_SIZE + cmd_struct[cmd_id].size);
 				memcpy(first_cmd, cmd, (UINT8_SIZE + cmd_struct[cmd_id].size)*sizeof(uint8));
 			}
 
@@ -1969,7 +759,7 @@ static int _v_cmd_unpack(const char *buffer,
 		}
 
 		if(first_cmd != NULL) {
-			free(first_cmd);
+			v_slab_free(first_cmd, UINT8_SIZE + cmd_struct[cmd_id].size);
 			first_cmd = NULL;
 		}
 	}
@@ -1991,16 +781,22 @@ int v_cmd_unpack(const char *buffer,
 		unsigned short buffer_len,
 		struct VInQueue *v_in_queue)
 {
+	struct VCmdBuffer *cmd_buffer = NULL;
 	uint32 buffer_pos = 0;
 
 	while( buffer_pos < buffer_len )
 	{
 		/* At least command id and its length has to be unpacked */
 		if((buffer_len-buffer_pos) >= 2) {
-			buffer_pos += _v_cmd_unpack(&buffer[buffer_pos], buffer_len - buffer_pos, v_in_queue);
+			buffer_pos += _v_cmd_unpack(&buffer[buffer_pos], buffer_len - buffer_pos, v_in_queue,
+					buffer, buffer_len,
+					(v_in_queue->cmd_views == 1) ? &cmd_buffer : NULL);
 		}
 	}
 
+	/* Views of commands hold own references at the receive buffer */
+	v_cmd_buffer_release(&cmd_buffer);
+
 	return buffer_pos;
 }
 
@@ -2057,7 +853,7 @@ int v_cmd_pack(char *buffer,
 {
 	uint16 buffer_pos = 0;
 	uint8 skip_items=0;
-	int i;
+	int i, count;
 
 	if(length != 0) {
 		/* Pack Command ID */
@@ -2088,7 +884,32 @@ int v_cmd_pack(char *buffer,
 		assert(shared_size == share);
 	}
 
-	for(i=skip_items; i<cmd_struct[cmd->id].item_count; i++) {
+	/* Use function generated for this command, when it exists */
+	if(v_cmd_pack_funcs[cmd->id] != NULL) {
+		return buffer_pos + v_cmd_pack_funcs[cmd->id](&buffer[buffer_pos],
+				cmd, skip_items);
+	}
+
+	for(i=skip_items; i<cmd_struct[cmd->id].item_count; i+=count) {
+		/* Vectors of values are packed at once */
+		count = _v_cmd_items_array_len(&cmd_struct[cmd->id], i,
+				cmd_struct[cmd->id].item_count);
+		if(count > 1) {
+			const void *data = &cmd->data[cmd_struct[cmd->id].items[i].offset];
+			switch(cmd_struct[cmd->id].items[i].size) {
+			case 2:
+				buffer_pos += vnp_raw_pack_uint16_array(&buffer[buffer_pos], data, count);
+				break;
+			case 4:
+				buffer_pos += vnp_raw_pack_uint32_array(&buffer[buffer_pos], data, count);
+				break;
+			case 8:
+				buffer_pos += vnp_raw_pack_uint64_array(&buffer[buffer_pos], data, count);
+				break;
+			}
+			continue;
+		}
+
 		switch(cmd_struct[cmd->id].items[i].type) {
 		case ITEM_RESERVED:
 			assert(cmd_struct[cmd->id].items[i].type==ITEM_RESERVED);
@@ -2382,6 +1203,15 @@ struct Generic_Cmd *v_cmd_fake_ack(struct Generic_Cmd *cmd)
 				UINT16(cmd->data[UINT32_SIZE]));
 		break;
 	default:
+		/* Acknowledged delta could be used as base of next delta */
+		if(cmd->id >= CMD_LAYER_SET_DELTA_UINT8 &&
+				cmd->id <= CMD_LAYER_SET_DELTA_VEC4_REAL64)
+		{
+			fake_cmd = v_fake_layer_set_ack_create(UINT32(cmd->data[0]),
+					UINT16(cmd->data[UINT32_SIZE]),
+					UINT32(cmd->data[UINT32_SIZE + UINT16_SIZE]),
+					UINT16(cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]));
+		}
 		break;
 	}
 
@@ -167,3 +167,141 @@ void v_print_log_simple(const uint8 level, const char *format, ...)
 
 	va_end(ap);
 }
+
+/**
+ * \brief This function converts single precision float to half precision
+ * float (IEEE 754 binary16). Value is rounded to the nearest half precision
+ * float and values out of range are converted to infinity.
+ */
+real16 v_real32_to_real16(const real32 value)
+{
+	union { uint32 uint; real32 real; } punt;
+	uint32 sign, mant, rem, halfway, half;
+	int32 exp;
+
+	punt.real = value;
+	sign = (punt.uint >> 16) & 0x8000;
+	exp = (int32)((punt.uint >> 23) & 0xFF);
+	mant = punt.uint & 0x7FFFFF;
+
+	/* Infinity and NaN */
+	if(exp == 0xFF) {
+		return (real16)(sign | 0x7C00 | ((mant != 0) ? 0x200 : 0));
+	}
+
+	/* Change bias of exponent from 127 to 15 */
+	exp = exp - 127 + 15;
+
+	/* Too big values */
+	if(exp >= 0x1F) {
+		return (real16)(sign | 0x7C00);
+	}
+
+	/* Small values are converted to subnormal numbers or zero */
+	if(exp <= 0) {
+		if(exp < -10) {
+			return (real16)sign;
+		}
+		mant |= 0x800000;
+		half = mant >> (14 - exp);
+		rem = mant & ((1U << (14 - exp)) - 1);
+		halfway = 1U << (13 - exp);
+	} else {
+		half = ((uint32)exp << 10) | (mant >> 13);
+		rem = mant & 0x1FFF;
+		halfway = 0x1000;
+	}
+
+	/* Round to nearest even. Carry to exponent gives right result too. */
+	if(rem > halfway || (rem == halfway && (half & 1))) {
+		half++;
+	}
+
+	return (real16)(sign | half);
+}
+
+/**
+ * \brief This function converts double precision float to half precision
+ * float (IEEE 754 binary16). Value is rounded only once, then it could
+ * differ from conversion through single precision float.
+ */
+real16 v_real64_to_real16(const real64 value)
+{
+	union { uint64 uint; real64 real; } punt;
+	uint64 mant, rem, halfway;
+	uint32 sign, half;
+	int32 exp;
+
+	punt.real = value;
+	sign = (uint32)(punt.uint >> 48) & 0x8000;
+	exp = (int32)((punt.uint >> 52) & 0x7FF);
+	mant = punt.uint & 0xFFFFFFFFFFFFFULL;
+
+	/* Infinity and NaN */
+	if(exp == 0x7FF) {
+		return (real16)(sign | 0x7C00 | ((mant != 0) ? 0x200 : 0));
+	}
+
+	/* Change bias of exponent from 1023 to 15 */
+	exp = exp - 1023 + 15;
+
+	/* Too big values */
+	if(exp >= 0x1F) {
+		return (real16)(sign | 0x7C00);
+	}
+
+	/* Small values are converted to subnormal numbers or zero */
+	if(exp <= 0) {
+		if(exp < -10) {
+			return (real16)sign;
+		}
+		mant |= 0x10000000000000ULL;
+		half = (uint32)(mant >> (43 - exp));
+		rem = mant & ((1ULL << (43 - exp)) - 1);
+		halfway = 1ULL << (42 - exp);
+	} else {
+		half = ((uint32)exp << 10) | (uint32)(mant >> 42);
+		rem = mant & 0x3FFFFFFFFFFULL;
+		halfway = 0x20000000000ULL;
+	}
+
+	/* Round to nearest even. Carry to exponent gives right result too. */
+	if(rem > halfway || (rem == halfway && (half & 1))) {
+		half++;
+	}
+
+	return (real16)(sign | half);
+}
+
+/**
+ * \brief This function converts half precision float (IEEE 754 binary16) to
+ * single precision float.
+ */
+real32 v_real16_to_real32(const real16 value)
+{
+	union { uint32 uint; real32 real; } punt;
+	uint32 sign = ((uint32)value & 0x8000) << 16;
+	uint32 exp = (value >> 10) & 0x1F;
+	uint32 mant = value & 0x3FF;
+
+	if(exp == 0x1F) {
+		/* Infinity and NaN */
+		punt.uint = sign | 0x7F800000 | (mant << 13);
+	} else if(exp == 0) {
+		if(mant == 0) {
+			punt.uint = sign;
+		} else {
+			/* Normalize subnormal number */
+			exp = 127 - 15 + 1;
+			while((mant & 0x400) == 0) {
+				mant <<= 1;
+				exp--;
+			}
+			punt.uint = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+		}
+	} else {
+		punt.uint = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+	}
+
+	return punt.real;
+}
@@ -0,0 +1,426 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+/**
+ * \file	v_compress.c
+ * \brief	Compression of node commands in the payload of packets
+ *
+ * When CMPR_DEFLATE method of command compression is negotiated, then node
+ * commands in the payload of each packet are compressed with deflate. Every
+ * payload is compressed separately, because packets could be lost or
+ * reordered, but compressor and decompressor are primed with the dictionary
+ * of byte sequences common in streams of Verse commands. It helps a lot,
+ * because payloads are short. The payload is sent uncompressed, when
+ * compression doesn't make it shorter.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include "v_compress.h"
+#include "v_network.h"
+#include "v_sys_commands.h"
+#include "v_common.h"
+
+#ifdef WITH_ZLIB
+
+/**
+ * Dictionary used for compression of payloads. It contains the most common
+ * sequences of bytes found in payloads of packets captured between Verse
+ * server and clients creating nodes, tag groups, tags and layers and sending
+ * values of layers. The most common sequences are at the end of the
+ * dictionary, because deflate encodes shorter distances with less bits.
+ */
+static const unsigned char v_cmpr_dict[] = {
+	0xd6, 0x87, 0xe3, 0xd7, 0x0a, 0x3d, 0x3f, 0xbf, 0x32, 0xd6, 0x87, 0xe3,
+	0xd7, 0x0a, 0x3d, 0x3f, 0xc1, 0x32, 0xd6, 0x87, 0xe3, 0xd7, 0x0a, 0x3d,
+	0x0a, 0xc1, 0x32, 0xd6, 0x87, 0xe3, 0xd7, 0x0a, 0x00, 0x0a, 0xc1, 0x32,
+	0xd6, 0x87, 0xe3, 0xd7, 0x00, 0x00, 0x0a, 0xc1, 0x32, 0xd6, 0x87, 0xe3,
+	0x00, 0x00, 0x00, 0x0a, 0xc1, 0x32, 0xd6, 0x87, 0x00, 0x00, 0x00, 0x00,
+	0x0a, 0xc1, 0x32, 0xd6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xc1, 0x32,
+	0x00, 0x02, 0xa0, 0x2d, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x02, 0xa0,
+	0x2d, 0x00, 0x00, 0x01, 0x06, 0x02, 0x00, 0x02, 0xa0, 0x2d, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xf0, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x3f, 0xe8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xe8,
+	0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f, 0xf8, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x3f, 0xf8,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x3f, 0xe0, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f,
+	0x3f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x02, 0x3f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xd0, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0xd0, 0xe0, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0xe0, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0xe0, 0x12, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x20, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 0x3f, 0x80, 0x00, 0x00, 0x04, 0x40,
+	0x00, 0x00, 0x00, 0x3f, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x40,
+	0x3f, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x3f, 0x40, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x3f, 0x40, 0x00, 0x00, 0x00,
+	0x00, 0x03, 0x3f, 0xc0, 0x00, 0x00, 0x3f, 0x40, 0x00, 0x00, 0x03, 0x3f,
+	0xc0, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x03, 0x3f, 0xc0, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x3f, 0xc0, 0x3f, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x02, 0x3f, 0x80, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x00,
+	0x02, 0x3f, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x3f, 0x80,
+	0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x3f, 0x3e, 0x80, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x02, 0x00, 0x3e, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x3e, 0x80, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00,
+	0x00, 0x00, 0x3e, 0x80, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x3e,
+	0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x3f, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x00,
+	0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c, 0x0a, 0x00, 0x00, 0x00,
+	0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x04,
+	0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x09,
+	0x00, 0x00, 0x00, 0x0a, 0x03, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x07, 0x00,
+	0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x03,
+	0x06, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,
+	0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x06, 0x00,
+	0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00,
+	0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x03,
+	0x00, 0x00, 0x00, 0x04, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x01, 0x00,
+	0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+	0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x10,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x40,
+	0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x20, 0x0f,
+	0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x01, 0x20, 0x0f, 0x00, 0x00, 0x64,
+	0xff, 0x01, 0x00, 0x00, 0x00, 0x01, 0x20, 0x0f, 0x00, 0x00, 0x3f, 0xe0,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x0f, 0x00, 0x03, 0xe8, 0x00, 0x01,
+	0x00, 0x00, 0x00, 0x20, 0x0f, 0x00, 0x03, 0xe8, 0x00, 0x00, 0x00, 0x00,
+	0x20, 0x0f, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x0f, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x0f, 0x22, 0x1a, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x40, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x3f, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0x3f, 0x20, 0x1b, 0x00, 0x00, 0x64, 0x00, 0x01, 0x00,
+	0x11, 0x00, 0x03, 0xe8, 0x03, 0x00, 0x01, 0x00, 0x26, 0x11, 0x00, 0x03,
+	0xe8, 0x03, 0x00, 0x01, 0x64, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00,
+	0x00, 0x64, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0xff, 0xff, 0x01, 0x00,
+	0x00, 0x00, 0x01, 0x20, 0x00, 0xff, 0xff, 0x01, 0x00, 0x00, 0x00, 0x01,
+	0x03, 0x26, 0x0a, 0x00, 0xff, 0xff, 0x01, 0x00, 0x00, 0x03, 0x26, 0x0a,
+	0x00, 0xff, 0xff, 0x01, 0x03, 0x00, 0x03, 0x26, 0x0a, 0x00, 0xff, 0xff,
+	0x00, 0x03, 0x00, 0x03, 0x26, 0x0a, 0x00, 0xff, 0x00, 0x00, 0x03, 0x00,
+	0x03, 0x26, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x03, 0x26, 0x0a,
+	0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x03, 0x26, 0x00, 0x02, 0x00, 0x00,
+	0x00, 0x03, 0x00, 0x03, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03,
+	0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+	0x00, 0x02, 0x00, 0x02, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x00, 0x01, 0x06, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x20, 0x1b, 0x06, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00,
+	0x20, 0x1b, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x20, 0x1b, 0x06,
+	0xff, 0x01, 0x00, 0x00, 0x00, 0x00, 0x20, 0x1b, 0xff, 0xff, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20,
+	0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26, 0x0a, 0x00, 0xff,
+	0xff, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x01
+};
+
+/**
+ * Streams of zlib and buffer for compressed or decompressed data owned by
+ * one thread
+ */
+typedef struct VCmprCtx {
+	z_stream	deflate;
+	z_stream	inflate;
+	int			deflate_ready;
+	int			inflate_ready;
+	char		*buf;
+} VCmprCtx;
+
+static __thread struct VCmprCtx v_cmpr_ctx;
+static __thread int v_cmpr_registered = 0;
+
+static pthread_once_t v_cmpr_once = PTHREAD_ONCE_INIT;
+static pthread_key_t v_cmpr_key;
+
+/**
+ * \brief This function frees streams and buffer of thread, when the thread
+ * exits
+ */
+static void v_cmpr_thread_exit(void *arg)
+{
+	struct VCmprCtx *cmpr_ctx = (struct VCmprCtx*)arg;
+
+	if(cmpr_ctx->deflate_ready == 1) {
+		deflateEnd(&cmpr_ctx->deflate);
+		cmpr_ctx->deflate_ready = 0;
+	}
+
+	if(cmpr_ctx->inflate_ready == 1) {
+		inflateEnd(&cmpr_ctx->inflate);
+		cmpr_ctx->inflate_ready = 0;
+	}
+
+	if(cmpr_ctx->buf != NULL) {
+		free(cmpr_ctx->buf);
+		cmpr_ctx->buf = NULL;
+	}
+}
+
+static void v_cmpr_init(void)
+{
+	pthread_key_create(&v_cmpr_key, v_cmpr_thread_exit);
+}
+
+/**
+ * \brief This function returns context of current thread. The buffer of
+ * context is allocated, when it is used for the first time.
+ */
+static struct VCmprCtx *v_cmpr_get_ctx(void)
+{
+	if(v_cmpr_registered == 0) {
+		pthread_once(&v_cmpr_once, v_cmpr_init);
+		pthread_setspecific(v_cmpr_key, &v_cmpr_ctx);
+		v_cmpr_registered = 1;
+	}
+
+	if(v_cmpr_ctx.buf == NULL) {
+		v_cmpr_ctx.buf = (char*)malloc(MAX_PACKET_SIZE);
+		if(v_cmpr_ctx.buf == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "Unable to allocate buffer for compression\n");
+			return NULL;
+		}
+	}
+
+	return &v_cmpr_ctx;
+}
+
+/**
+ * \brief This function compresses buffer with deflate
+ *
+ * \return This function returns size of compressed data (including mark)
+ * in the buffer of context. It returns 0, when compressed data would not be
+ * shorter then original data.
+ */
+static uint16 v_deflate(struct VCmprCtx *cmpr_ctx,
+		const char *buffer,
+		const uint16 len)
+{
+	z_stream *strm = &cmpr_ctx->deflate;
+
+	if(cmpr_ctx->deflate_ready == 0) {
+		memset(strm, 0, sizeof(z_stream));
+		/* Negative window bits means raw deflate without header and checksum */
+		if(deflateInit2(strm, CMPR_DEFLATE_LEVEL, Z_DEFLATED, -MAX_WBITS,
+				8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			v_print_log(VRS_PRINT_ERROR, "deflateInit2() failed\n");
+			return 0;
+		}
+		cmpr_ctx->deflate_ready = 1;
+	} else {
+		deflateReset(strm);
+	}
+
+	deflateSetDictionary(strm, v_cmpr_dict, sizeof(v_cmpr_dict));
+
+	strm->next_in = (Bytef*)buffer;
+	strm->avail_in = len;
+	/* The first byte of buffer is reserved for CMPR_PAYLOAD_MARK */
+	strm->next_out = (Bytef*)cmpr_ctx->buf + 1;
+	/* Compressed data (with mark) has to be shorter then original data */
+	strm->avail_out = len - 2;
+
+	if(deflate(strm, Z_FINISH) != Z_STREAM_END) {
+		return 0;
+	}
+
+	cmpr_ctx->buf[0] = (char)CMPR_PAYLOAD_MARK;
+
+	return (uint16)strm->total_out + 1;
+}
+
+/**
+ * \brief This function decompresses buffer compressed with deflate
+ *
+ * \return This function returns size of decompressed data in the buffer of
+ * context. It returns -1, when data are corrupted.
+ */
+static int v_inflate(struct VCmprCtx *cmpr_ctx,
+		const char *buffer,
+		const uint16 len)
+{
+	z_stream *strm = &cmpr_ctx->inflate;
+
+	if(cmpr_ctx->inflate_ready == 0) {
+		memset(strm, 0, sizeof(z_stream));
+		if(inflateInit2(strm, -MAX_WBITS) != Z_OK) {
+			v_print_log(VRS_PRINT_ERROR, "inflateInit2() failed\n");
+			return -1;
+		}
+		cmpr_ctx->inflate_ready = 1;
+	} else {
+		inflateReset(strm);
+	}
+
+	/* Dictionary of raw inflate is set before decompression */
+	inflateSetDictionary(strm, v_cmpr_dict, sizeof(v_cmpr_dict));
+
+	strm->next_in = (Bytef*)buffer;
+	strm->avail_in = len;
+	strm->next_out = (Bytef*)cmpr_ctx->buf;
+	strm->avail_out = MAX_PACKET_SIZE;
+
+	if(inflate(strm, Z_FINISH) != Z_STREAM_END) {
+		return -1;
+	}
+
+	return (int)strm->total_out;
+}
+
+#endif /* WITH_ZLIB */
+
+/**
+ * \brief This function returns 1, when method of command compression is
+ * supported by this build of Verse library. Otherwise it returns 0.
+ */
+int v_compress_is_supported(const uint8 cmpr)
+{
+	switch(cmpr) {
+	case CMPR_NONE:
+	case CMPR_ADDR_SHARE:
+		return 1;
+	case CMPR_DEFLATE:
+#ifdef WITH_ZLIB
+		return 1;
+#else
+		return 0;
+#endif
+	default:
+		return 0;
+	}
+}
+
+/**
+ * \brief This function tries to compress node commands in the payload of
+ * packet.
+ *
+ * \param[in]		cmpr	The negotiated method of command compression
+ * \param[in,out]	*buffer	The buffer with node commands
+ * \param[in]		len		The size of node commands in the buffer
+ *
+ * \return This function returns size of compressed node commands, that
+ * replaced original commands in the buffer. When payload was not compressed,
+ * then buffer is not changed and this function returns 0.
+ */
+uint16 v_compress_payload(const uint8 cmpr,
+		char *buffer,
+		const uint16 len)
+{
+#ifdef WITH_ZLIB
+	struct VCmprCtx *cmpr_ctx;
+	uint16 cmpr_len;
+
+	if(cmpr != CMPR_DEFLATE || len < CMPR_MIN_PAYLOAD_SIZE) {
+		return 0;
+	}
+
+	if((cmpr_ctx = v_cmpr_get_ctx()) == NULL) {
+		return 0;
+	}
+
+	cmpr_len = v_deflate(cmpr_ctx, buffer, len);
+	if(cmpr_len > 0) {
+		memcpy(buffer, cmpr_ctx->buf, cmpr_len);
+	}
+
+	return cmpr_len;
+#else
+	(void)cmpr;
+	(void)buffer;
+	(void)len;
+	return 0;
+#endif
+}
+
+/**
+ * \brief This function decompresses node commands received in the payload
+ * of packet.
+ *
+ * \param[in]	cmpr		The negotiated method of command compression
+ * \param[in]	*buffer		The buffer with compressed node commands
+ * \param[in]	len			The size of compressed node commands
+ * \param[out]	*data_len	The size of decompressed node commands
+ *
+ * \return This function returns pointer at decompressed node commands. This
+ * buffer is owned by current thread and it is valid until next call of this
+ * function. When data could not be decompressed, then NULL is returned.
+ */
+const char *v_decompress_payload(const uint8 cmpr,
+		const char *buffer,
+		const uint16 len,
+		uint16 *data_len)
+{
+#ifdef WITH_ZLIB
+	struct VCmprCtx *cmpr_ctx;
+	int ret;
+
+	if(cmpr != CMPR_DEFLATE) {
+		return NULL;
+	}
+
+	if((cmpr_ctx = v_cmpr_get_ctx()) == NULL) {
+		return NULL;
+	}
+
+	if(len < 2 || (unsigned char)buffer[0] != CMPR_PAYLOAD_MARK) {
+		return NULL;
+	}
+
+	if((ret = v_inflate(cmpr_ctx, buffer + 1, len - 1)) < 0) {
+		return NULL;
+	}
+
+	*data_len = (uint16)ret;
+
+	return cmpr_ctx->buf;
+#else
+	(void)cmpr;
+	(void)buffer;
+	(void)len;
+	(void)data_len;
+	return NULL;
+#endif
+}
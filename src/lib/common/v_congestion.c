@@ -0,0 +1,524 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+/*
+ * This file contains implementation of TCP like congestion control. The
+ * retransmission timeout is computed according RFC 6298 and two algorithms
+ * are available for changing size of congestion window: NewReno (RFC 5681)
+ * and CUBIC (RFC 8312). Lost packets are detected with NAK commands and with
+ * expiration of retransmission timeout.
+ */
+
+#include <string.h>
+#include <assert.h>
+
+#include "verse_types.h"
+
+#include "v_congestion.h"
+#include "v_connection.h"
+#include "v_history.h"
+#include "v_sys_commands.h"
+#include "v_common.h"
+
+static void v_cc_newreno_loss(struct VDgramConn *dgram_conn, const struct timeval *tv);
+static void v_cc_newreno_ack(struct VDgramConn *dgram_conn, uint32 acked_size, const struct timeval *tv);
+static void v_cc_newreno_timeout(struct VDgramConn *dgram_conn, const struct timeval *tv);
+static void v_cc_cubic_init(struct VDgramConn *dgram_conn);
+static void v_cc_cubic_ack(struct VDgramConn *dgram_conn, uint32 acked_size, const struct timeval *tv);
+static void v_cc_cubic_loss(struct VDgramConn *dgram_conn, const struct timeval *tv);
+static void v_cc_cubic_timeout(struct VDgramConn *dgram_conn, const struct timeval *tv);
+
+/**
+ * List of supported algorithms of congestion control
+ */
+static const struct VCCAlgorithm cc_algorithms[] = {
+		{CC_ALG_NEWRENO, "newreno", NULL, v_cc_newreno_ack, v_cc_newreno_loss, v_cc_newreno_timeout},
+		{CC_ALG_CUBIC, "cubic", v_cc_cubic_init, v_cc_cubic_ack, v_cc_cubic_loss, v_cc_cubic_timeout},
+		{CC_ALG_RESERVED, NULL, NULL, NULL, NULL, NULL}
+};
+
+/**
+ * \brief This function returns maximal size of segment used by congestion
+ * control
+ */
+static uint32 v_cc_mss(struct VDgramConn *dgram_conn)
+{
+	return (dgram_conn->io_ctx.mtu > 0) ? dgram_conn->io_ctx.mtu : DEFAULT_MTU;
+}
+
+/**
+ * \brief This function returns time in microseconds
+ */
+static uint64 v_cc_time(const struct timeval *tv)
+{
+	return (uint64)tv->tv_sec*1000000 + (uint64)tv->tv_usec;
+}
+
+/**
+ * \brief This function returns ID of last sent payload packet
+ */
+static uint32 v_cc_last_pay_id(struct VDgramConn *dgram_conn)
+{
+	return dgram_conn->host_id + dgram_conn->count_s_pay - 1;
+}
+
+/**
+ * \brief This function computes new slow start threshold after loss
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	window		The size of window before loss
+ * \param[in]	beta		The multiplicative decrease factor (multiplied by 1000)
+ */
+static uint32 v_cc_ssthresh(struct VDgramConn *dgram_conn,
+		uint32 window,
+		uint32 beta)
+{
+	uint32 min_cwin = CC_MIN_CWIN*v_cc_mss(dgram_conn);
+	uint32 ssthresh = (uint32)(((uint64)window*beta)/1000);
+
+	return (ssthresh > min_cwin) ? ssthresh : min_cwin;
+}
+
+/**
+ * \brief This function increases congestion window in slow start phase
+ * (Appropriate Byte Counting with limit of two segments)
+ */
+static void v_cc_slow_start(struct VDgramConn *dgram_conn, uint32 acked_size)
+{
+	uint32 limit = 2*v_cc_mss(dgram_conn);
+
+	dgram_conn->cwin += (acked_size < limit) ? acked_size : limit;
+}
+
+/**
+ * \brief Increase of congestion window for NewReno algorithm. Window is
+ * increased exponentially during slow start phase and by one segment per
+ * round trip time during congestion avoidance phase.
+ */
+static void v_cc_newreno_ack(struct VDgramConn *dgram_conn,
+		uint32 acked_size,
+		const struct timeval *tv)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+
+	(void)tv;
+
+	if(dgram_conn->cwin < cc_state->ssthresh) {
+		v_cc_slow_start(dgram_conn, acked_size);
+	} else {
+		cc_state->acked += acked_size;
+		while(cc_state->acked >= dgram_conn->cwin) {
+			cc_state->acked -= dgram_conn->cwin;
+			dgram_conn->cwin += v_cc_mss(dgram_conn);
+		}
+	}
+}
+
+/**
+ * \brief Congestion window of NewReno is halved, when loss is detected
+ */
+static void v_cc_newreno_loss(struct VDgramConn *dgram_conn,
+		const struct timeval *tv)
+{
+	(void)tv;
+
+	dgram_conn->cc_state.ssthresh = v_cc_ssthresh(dgram_conn, dgram_conn->sent_size, 500);
+	dgram_conn->cwin = dgram_conn->cc_state.ssthresh;
+	dgram_conn->cc_state.acked = 0;
+}
+
+/**
+ * \brief Slow start is started again from one segment, when retransmission
+ * timeout expired
+ */
+static void v_cc_newreno_timeout(struct VDgramConn *dgram_conn,
+		const struct timeval *tv)
+{
+	(void)tv;
+
+	dgram_conn->cc_state.ssthresh = v_cc_ssthresh(dgram_conn, dgram_conn->sent_size, 500);
+	dgram_conn->cwin = v_cc_mss(dgram_conn);
+	dgram_conn->cc_state.acked = 0;
+}
+
+/**
+ * \brief This function computes cube root of x (Newton's method)
+ */
+static double v_cc_cbrt(double x)
+{
+	double y;
+	int i;
+
+	if(x <= 0.0) {
+		return 0.0;
+	}
+
+	y = (x > 1.0) ? x/3.0 : 1.0;
+	for(i = 0; i < 40; i++) {
+		y = (2.0*y + x/(y*y))/3.0;
+	}
+
+	return y;
+}
+
+/**
+ * \brief Initialize state of CUBIC algorithm
+ */
+static void v_cc_cubic_init(struct VDgramConn *dgram_conn)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+
+	cc_state->w_max = 0;
+	cc_state->w_est = 0;
+	cc_state->k = 0;
+	cc_state->epoch_start = 0;
+}
+
+/**
+ * \brief Increase of congestion window for CUBIC algorithm. During congestion
+ * avoidance the window follows cubic function of time elapsed since the last
+ * reduction of window. The window is never smaller than the estimated window
+ * of standard TCP.
+ */
+static void v_cc_cubic_ack(struct VDgramConn *dgram_conn,
+		uint32 acked_size,
+		const struct timeval *tv)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+	double mss = v_cc_mss(dgram_conn);
+	double cwin = dgram_conn->cwin;
+	double t, target, alpha;
+	uint64 now = v_cc_time(tv);
+
+	if(dgram_conn->cwin < cc_state->ssthresh) {
+		v_cc_slow_start(dgram_conn, acked_size);
+		return;
+	}
+
+	/* Begin new epoch of congestion avoidance */
+	if(cc_state->epoch_start == 0) {
+		cc_state->epoch_start = now;
+		if(cc_state->w_max > dgram_conn->cwin) {
+			cc_state->k = (uint32)(1000000.0*v_cc_cbrt(
+					((cc_state->w_max - cwin)/mss)*1000.0/CUBIC_C));
+		} else {
+			cc_state->k = 0;
+			cc_state->w_max = dgram_conn->cwin;
+		}
+		cc_state->w_est = dgram_conn->cwin;
+	}
+
+	/* W_cubic(t + RTT) = C*(t - K)^3 + W_max */
+	t = ((double)now - (double)cc_state->epoch_start +
+			(double)dgram_conn->srtt - (double)cc_state->k)/1000000.0;
+	target = cc_state->w_max + mss*((double)CUBIC_C/1000.0)*t*t*t;
+
+	/* Estimation of window of standard TCP (TCP friendly region) */
+	alpha = 3.0*(1000 - CUBIC_BETA)/(1000 + CUBIC_BETA);
+	cc_state->w_est += (uint32)(alpha*mss*acked_size/cwin);
+	if(target < cc_state->w_est) {
+		target = cc_state->w_est;
+	}
+
+	/* Window could not grow faster than 1.5 times per round trip time */
+	if(target > 1.5*cwin) {
+		target = 1.5*cwin;
+	}
+
+	if(target > cwin) {
+		dgram_conn->cwin += (uint32)((target - cwin)*acked_size/cwin);
+	}
+}
+
+/**
+ * \brief Congestion window of CUBIC is multiplied by beta, when loss is
+ * detected. Fast convergence releases bandwidth for new flows.
+ */
+static void v_cc_cubic_loss(struct VDgramConn *dgram_conn,
+		const struct timeval *tv)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+
+	(void)tv;
+
+	cc_state->epoch_start = 0;
+
+	if(dgram_conn->cwin < cc_state->w_max) {
+		cc_state->w_max = (uint32)(((uint64)dgram_conn->cwin*(1000 + CUBIC_BETA))/2000);
+	} else {
+		cc_state->w_max = dgram_conn->cwin;
+	}
+
+	cc_state->ssthresh = v_cc_ssthresh(dgram_conn, dgram_conn->cwin, CUBIC_BETA);
+	dgram_conn->cwin = cc_state->ssthresh;
+	cc_state->acked = 0;
+}
+
+/**
+ * \brief Slow start is started again from one segment, when retransmission
+ * timeout expired
+ */
+static void v_cc_cubic_timeout(struct VDgramConn *dgram_conn,
+		const struct timeval *tv)
+{
+	v_cc_cubic_loss(dgram_conn, tv);
+	dgram_conn->cwin = v_cc_mss(dgram_conn);
+}
+
+/**
+ * \brief This function tries to find algorithm of congestion control with
+ * name.
+ *
+ * \return This function returns pointer at algorithm or NULL, when algorithm
+ * with this name is not supported.
+ */
+const struct VCCAlgorithm *v_cc_find_algorithm(const char *name)
+{
+	const struct VCCAlgorithm *cc_alg;
+
+	for(cc_alg = cc_algorithms; cc_alg->name != NULL; cc_alg++) {
+		if(strcmp(cc_alg->name, name) == 0) {
+			return cc_alg;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief This function returns algorithm of congestion control with ID.
+ * When such algorithm does not exist, then default algorithm is returned.
+ */
+const struct VCCAlgorithm *v_cc_get_algorithm(uint8 id)
+{
+	const struct VCCAlgorithm *cc_alg;
+
+	for(cc_alg = cc_algorithms; cc_alg->name != NULL; cc_alg++) {
+		if(cc_alg->id == id) {
+			return cc_alg;
+		}
+	}
+
+	return v_cc_get_algorithm(DEFAULT_CC_ALG);
+}
+
+/**
+ * \brief This function initialize state of congestion control at datagram
+ * connection
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	alg_id		The ID of algorithm used for TCP like congestion control
+ */
+void v_cc_init(struct VDgramConn *dgram_conn, uint8 alg_id)
+{
+	const struct VCCAlgorithm *cc_alg = v_cc_get_algorithm(alg_id);
+
+	dgram_conn->cc_alg = cc_alg->id;
+
+	dgram_conn->srtt = 0;
+	dgram_conn->rttvar = 0;
+	dgram_conn->rto = CC_INIT_RTO;
+
+	dgram_conn->cwin = CC_INIT_CWIN*v_cc_mss(dgram_conn);
+
+	memset(&dgram_conn->cc_state, 0, sizeof(struct VCCState));
+	dgram_conn->cc_state.ssthresh = 0xFFFFFFFF;
+
+	if(cc_alg->init != NULL) {
+		cc_alg->init(dgram_conn);
+	}
+}
+
+/**
+ * \brief This function updates SRTT, RTTVAR and RTO with new sample of round
+ * trip time (RFC 6298)
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	rtt			The measured round trip time in microseconds
+ */
+void v_cc_rtt_sample(struct VDgramConn *dgram_conn, uint32 rtt)
+{
+	uint32 delta, var;
+
+	if(dgram_conn->srtt == 0) {
+		dgram_conn->srtt = rtt;
+		dgram_conn->rttvar = rtt/2;
+	} else {
+		delta = (dgram_conn->srtt > rtt) ? dgram_conn->srtt - rtt : rtt - dgram_conn->srtt;
+		dgram_conn->rttvar = (3*(uint64)dgram_conn->rttvar + delta)/4;
+		dgram_conn->srtt = (7*(uint64)dgram_conn->srtt + rtt)/8;
+	}
+
+	/* Clock granularity is one millisecond */
+	var = (4*dgram_conn->rttvar > 1000) ? 4*dgram_conn->rttvar : 1000;
+	dgram_conn->rto = dgram_conn->srtt + var;
+
+	if(dgram_conn->rto < CC_MIN_RTO) {
+		dgram_conn->rto = CC_MIN_RTO;
+	} else if(dgram_conn->rto > CC_MAX_RTO) {
+		dgram_conn->rto = CC_MAX_RTO;
+	}
+}
+
+/**
+ * \brief This function is called, when some payload packets were
+ * acknowledged by peer
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	acked_size	The size of acknowledged commands
+ * \param[in]	*tv			The current time
+ */
+void v_cc_ack(struct VDgramConn *dgram_conn,
+		uint32 acked_size,
+		const struct timeval *tv)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+
+	if(dgram_conn->cc_meth != CC_TCP_LIKE || acked_size == 0) {
+		return;
+	}
+
+	/* Recovery ends, when all packets sent before loss were acknowledged */
+	if(cc_state->in_recovery == 1) {
+		if((int32)(dgram_conn->ank_id - cc_state->recover) >= 0) {
+			cc_state->in_recovery = 0;
+		} else {
+			return;
+		}
+	}
+
+	v_cc_get_algorithm(dgram_conn->cc_alg)->ack(dgram_conn, acked_size, tv);
+}
+
+/**
+ * \brief This function is called for each packet negatively acknowledged by
+ * the peer. Congestion window is reduced only once for packets lost in the
+ * same window.
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	nak_id		The ID of lost payload packet
+ * \param[in]	*tv			The current time
+ */
+void v_cc_nak(struct VDgramConn *dgram_conn,
+		uint32 nak_id,
+		const struct timeval *tv)
+{
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+
+	if(dgram_conn->cc_meth != CC_TCP_LIKE) {
+		return;
+	}
+
+	if(cc_state->in_recovery == 1 &&
+			(int32)(nak_id - cc_state->recover) <= 0)
+	{
+		return;
+	}
+
+	cc_state->in_recovery = 1;
+	cc_state->recover = v_cc_last_pay_id(dgram_conn);
+
+	v_cc_get_algorithm(dgram_conn->cc_alg)->loss(dgram_conn, tv);
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Packet: %u lost, CWIN: %u, SSTHRESH: %u\n",
+			nak_id, dgram_conn->cwin, cc_state->ssthresh);
+}
+
+/**
+ * \brief This function checks, if the oldest not acknowledged packet was
+ * sent before more than RTO. When RTO expired, then congestion window is
+ * reduced and RTO is doubled (exponential back-off). Caller has to re-send
+ * commands of packets sent before more than RTO then.
+ *
+ * \param[in]	*dgram_conn	The datagram connection
+ * \param[in]	*tv			The current time
+ *
+ * \return This function returns 1, when RTO expired. Otherwise it returns 0.
+ */
+int v_cc_check_timeout(struct VDgramConn *dgram_conn,
+		const struct timeval *tv)
+{
+	struct VPacket_History *history = &dgram_conn->packet_history;
+	struct VCCState *cc_state = &dgram_conn->cc_state;
+	struct VSent_Packet *sent_packet;
+	uint64 now = v_cc_time(tv);
+
+	if(dgram_conn->cc_meth != CC_TCP_LIKE || history->count == 0) {
+		return 0;
+	}
+
+	sent_packet = v_packet_history_find_packet(history, history->first_id);
+	if(sent_packet == NULL) {
+		return 0;
+	}
+
+	/* Was the oldest packet sent before more than RTO? */
+	if(now < v_cc_time(&sent_packet->tv) + dgram_conn->rto) {
+		return 0;
+	}
+
+	/* Was RTO expired during last RTO? */
+	if(now < v_cc_time(&cc_state->tv_rto) + dgram_conn->rto) {
+		return 0;
+	}
+
+	cc_state->tv_rto = *tv;
+	cc_state->in_recovery = 1;
+	cc_state->recover = v_cc_last_pay_id(dgram_conn);
+
+	v_cc_get_algorithm(dgram_conn->cc_alg)->timeout(dgram_conn, tv);
+
+	/* Exponential back-off */
+	dgram_conn->rto = (2*dgram_conn->rto < CC_MAX_RTO) ? 2*dgram_conn->rto : CC_MAX_RTO;
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "RTO expired, CWIN: %u, RTO: %u [us]\n",
+			dgram_conn->cwin, dgram_conn->rto);
+
+	return 1;
+}
+
+/**
+ * \brief This function returns size of data, that could be sent without
+ * congesting network.
+ */
+uint32 v_cc_send_window(struct VDgramConn *dgram_conn)
+{
+	if(dgram_conn->cc_meth != CC_TCP_LIKE) {
+		return dgram_conn->cwin;
+	}
+
+	return (dgram_conn->cwin > dgram_conn->sent_size) ?
+			dgram_conn->cwin - dgram_conn->sent_size : 0;
+}
@@ -151,6 +151,8 @@ void v_conn_dgram_init(struct VDgramConn *dgram_conn)
 	int i;
 
 	dgram_conn->io_ctx.sockfd = -1;
+	/* Packets are sent immediately by default */
+	dgram_conn->io_ctx.batch = NULL;
 	/* Allocate buffer for incoming packets */
 	if(dgram_conn->io_ctx.buf == NULL)
 		dgram_conn->io_ctx.buf = (char*)calloc(MAX_PACKET_SIZE, sizeof(char));
@@ -187,14 +189,13 @@ void v_conn_dgram_init(struct VDgramConn *dgram_conn)
 	dgram_conn->count_s_ack = 0;
 	/* Ack Ration staff */
 	dgram_conn->last_acked_pay = 0;
-	/* Default Smoothed RTT */
-	dgram_conn->srtt = 0;
 	dgram_conn->rwin_host = 0xFFFFFFFF;	/* Default value */
 	dgram_conn->rwin_peer = 0xFFFFFFFF;	/* Default value */
 	dgram_conn->sent_size = 0;
 	dgram_conn->rwin_host_scale = 0;	/* rwin_host is >> by this value for outgoing packet */
 	dgram_conn->rwin_peer_scale = 0;	/* rwin_host is << by this value for incoming packet */
-	dgram_conn->cwin = 0xFFFFFFFF;		/* TODO: Congestion Control */
+	/* Congestion Control (SRTT, RTO and congestion window) */
+	v_cc_init(dgram_conn, DEFAULT_CC_ALG);
 	/* Command compression */
 	dgram_conn->host_cmd_cmpr = CMPR_RESERVED;
 	dgram_conn->peer_cmd_cmpr = CMPR_RESERVED;
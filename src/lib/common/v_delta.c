@@ -0,0 +1,302 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "verse.h"
+
+#include "v_common.h"
+#include "v_commands.h"
+#include "v_delta.h"
+#include "v_layer_commands.h"
+
+/**
+ * \brief This function returns size of one component of value with data_type
+ */
+uint8 v_delta_type_size(const uint8 data_type)
+{
+	switch(data_type) {
+		case VRS_VALUE_TYPE_UINT8:
+			return UINT8_SIZE;
+		case VRS_VALUE_TYPE_UINT16:
+			return UINT16_SIZE;
+		case VRS_VALUE_TYPE_UINT32:
+			return UINT32_SIZE;
+		case VRS_VALUE_TYPE_UINT64:
+			return UINT64_SIZE;
+		case VRS_VALUE_TYPE_REAL16:
+			return REAL16_SIZE;
+		case VRS_VALUE_TYPE_REAL32:
+			return REAL32_SIZE;
+		case VRS_VALUE_TYPE_REAL64:
+			return REAL64_SIZE;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * \brief This function creates storage of values received as delta
+ */
+struct VDeltaRecv *v_delta_recv_create(void)
+{
+	struct VDeltaRecv *delta_recv;
+
+	delta_recv = (struct VDeltaRecv*)calloc(1, sizeof(struct VDeltaRecv));
+
+	if(delta_recv == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return NULL;
+	}
+
+	v_hash_array_init(&delta_recv->items,
+			HASH_MOD_65536,
+			0,
+			DELTA_RECV_KEY_SIZE);
+
+	return delta_recv;
+}
+
+/**
+ * \brief This function destroys storage of values received as delta
+ */
+void v_delta_recv_destroy(struct VDeltaRecv **delta_recv)
+{
+	struct VBucket *vbucket;
+
+	if(*delta_recv == NULL) {
+		return;
+	}
+
+	for(vbucket = (*delta_recv)->items.lb.first;
+			vbucket != NULL;
+			vbucket = vbucket->next)
+	{
+		free(vbucket->data);
+	}
+
+	v_hash_array_destroy(&(*delta_recv)->items);
+
+	free(*delta_recv);
+	*delta_recv = NULL;
+}
+
+/**
+ * \brief This function removes all stored values of layer (or all layers of
+ * node, when layer_id is VRS_RESERVED_LAYER_ID)
+ */
+void v_delta_recv_remove(struct VDeltaRecv *delta_recv,
+		const uint32 node_id,
+		const uint16 layer_id)
+{
+	struct VBucket *vbucket, *next_vbucket;
+	struct VDeltaRecvItem *item;
+
+	if(delta_recv == NULL) {
+		return;
+	}
+
+	for(vbucket = delta_recv->items.lb.first;
+			vbucket != NULL;
+			vbucket = next_vbucket)
+	{
+		next_vbucket = vbucket->next;
+		item = (struct VDeltaRecvItem*)vbucket->data;
+		if(item->node_id == node_id &&
+				(layer_id == VRS_RESERVED_LAYER_ID || item->layer_id == layer_id))
+		{
+			v_hash_array_remove_item(&delta_recv->items, item);
+			free(item);
+		}
+	}
+}
+
+/**
+ * \brief This function creates new item for storing received values
+ */
+static struct VDeltaRecvItem *v_delta_recv_item_create(struct VDeltaRecv *delta_recv,
+		const uint32 node_id,
+		const uint16 layer_id,
+		const uint32 item_id,
+		const uint16 value_size)
+{
+	struct VDeltaRecvItem *item;
+
+	item = (struct VDeltaRecvItem*)calloc(1, sizeof(struct VDeltaRecvItem) +
+			DELTA_RECV_HISTORY_LEN*value_size);
+
+	if(item == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return NULL;
+	}
+
+	item->node_id = node_id;
+	item->layer_id = layer_id;
+	item->item_id = item_id;
+	item->value_size = value_size;
+
+	if(v_hash_array_add_item(&delta_recv->items, item, sizeof(struct VDeltaRecvItem)) == NULL) {
+		free(item);
+		return NULL;
+	}
+
+	return item;
+}
+
+/**
+ * \brief This function decodes value received as delta
+ *
+ * \param[in]	*delta_recv	The storage of received values
+ * \param[in]	node_id		The ID of node
+ * \param[in]	layer_id	The ID of layer
+ * \param[in]	item_id		The ID of layer item
+ * \param[in]	value_size	The size of value in bytes
+ * \param[in]	seq			The sequence number of value
+ * \param[in]	base		The sequence number of base value
+ * \param[in]	*delta		The received delta
+ * \param[out]	*value		The decoded value
+ *
+ * \return This function returns 1, when value was decoded and it is newer then
+ * all values delivered to client application before. Otherwise it returns 0.
+ */
+int v_delta_recv_value(struct VDeltaRecv *delta_recv,
+		const uint32 node_id,
+		const uint16 layer_id,
+		const uint32 item_id,
+		const uint16 value_size,
+		const uint16 seq,
+		const uint16 base,
+		const void *delta,
+		void *value)
+{
+	struct VDeltaRecvItem find_item, *item = NULL;
+	struct VBucket *vbucket;
+	uint32 seq32, base32;
+	uint32 i, slot;
+	int deliver;
+
+	/* Reconstruct full sequence number from the newest received one */
+	seq32 = delta_recv->last_seq + (int16)(seq - (uint16)delta_recv->last_seq);
+	if((int32)(seq32 - delta_recv->last_seq) > 0) {
+		delta_recv->last_seq = seq32;
+	}
+
+	memset(&find_item, 0, sizeof(struct VDeltaRecvItem));
+	find_item.node_id = node_id;
+	find_item.layer_id = layer_id;
+	find_item.item_id = item_id;
+
+	vbucket = v_hash_array_find_item(&delta_recv->items, &find_item);
+	if(vbucket != NULL) {
+		item = (struct VDeltaRecvItem*)vbucket->data;
+		/* Layer was recreated with different type of values */
+		if(item->value_size != value_size) {
+			v_hash_array_remove_item(&delta_recv->items, item);
+			free(item);
+			item = NULL;
+		}
+	}
+
+	if(item != NULL) {
+		/* Drop duplicated values */
+		for(i = 0; i < item->count; i++) {
+			if(item->seqs[i] == seq32) {
+				return 0;
+			}
+		}
+	}
+
+	if(seq == base) {
+		/* Complete value */
+		memcpy(value, delta, value_size);
+	} else {
+		base32 = seq32 - (uint16)(seq - base);
+		slot = DELTA_RECV_HISTORY_LEN;
+		if(item != NULL) {
+			for(i = 0; i < item->count; i++) {
+				if(item->seqs[i] == base32) {
+					slot = i;
+					break;
+				}
+			}
+		}
+		if(slot == DELTA_RECV_HISTORY_LEN) {
+			v_print_log(VRS_PRINT_WARNING,
+					"Base value: %u of item: %u in layer: %d of node: %u not found\n",
+					base32, item_id, layer_id, node_id);
+			return 0;
+		}
+		for(i = 0; i < value_size; i++) {
+			((uint8*)value)[i] = ((const uint8*)delta)[i] ^
+					item->data[slot*value_size + i];
+		}
+	}
+
+	if(item == NULL) {
+		item = v_delta_recv_item_create(delta_recv, node_id, layer_id, item_id, value_size);
+		if(item == NULL) {
+			return 1;
+		}
+	}
+
+	deliver = (item->count == 0 || (int32)(seq32 - item->newest_seq) > 0);
+
+	/* Store value for decoding of following deltas. When history is full,
+	 * then the oldest value is replaced */
+	if(item->count < DELTA_RECV_HISTORY_LEN) {
+		slot = item->count++;
+	} else {
+		slot = 0;
+		for(i = 1; i < item->count; i++) {
+			if((int32)(item->seqs[i] - item->seqs[slot]) < 0) {
+				slot = i;
+			}
+		}
+		if((int32)(seq32 - item->seqs[slot]) < 0) {
+			slot = DELTA_RECV_HISTORY_LEN;
+		}
+	}
+	if(slot < DELTA_RECV_HISTORY_LEN) {
+		item->seqs[slot] = seq32;
+		memcpy(&item->data[slot*value_size], value, value_size);
+	}
+
+	if(deliver == 1) {
+		item->newest_seq = seq32;
+	}
+
+	return deliver;
+}
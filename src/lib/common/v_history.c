@@ -61,13 +61,15 @@ void v_print_packet_history(struct VPacket_History *history)
 {
 	struct VSent_Packet *packet;
 	struct VBucket *vbucket;
+	uint32 i;
 	int cmd_id;
 
 	v_print_log(VRS_PRINT_DEBUG_MSG, "Packet history:\n\t");
-	packet = history->packets.first;
-	while(packet!=NULL) {
-		v_print_log_simple(VRS_PRINT_DEBUG_MSG, "%d, ", packet->id);
-		packet = packet->next;
+	for(i = 0; i < history->length && history->count > 0; i++) {
+		packet = v_packet_history_find_packet(history, history->first_id + i);
+		if(packet != NULL) {
+			v_print_log_simple(VRS_PRINT_DEBUG_MSG, "%d, ", packet->id);
+		}
 	}
 	v_print_log_simple(VRS_PRINT_DEBUG_MSG, "\n");
 
@@ -90,18 +92,24 @@ void v_print_packet_history(struct VPacket_History *history)
  */
 void v_packet_history_destroy(struct VPacket_History *history)
 {
-	struct VSent_Packet *sent_packet;
+	uint32 i;
 	int cmd_id;
 
-	/* Free all pointer at commands in all sent packet */
-	sent_packet = history->packets.first;
-	while(sent_packet != NULL) {
-		v_list_free(&sent_packet->cmds);
-		sent_packet = sent_packet->next;
+	/* Free arrays of pointers at commands in all slots of ring buffer */
+	if(history->packets != NULL) {
+		for(i = 0; i < history->length; i++) {
+			if(history->packets[i].cmds != NULL) {
+				free(history->packets[i].cmds);
+			}
+		}
+
+		/* Free ring buffer of sent packets */
+		free(history->packets);
+		history->packets = NULL;
 	}
 
-	/* Free linked list of sent packets */
-	v_list_free(&history->packets);
+	history->length = 0;
+	history->count = 0;
 
 	/* Free commands in hashed linked lists */
 	for(cmd_id=0; cmd_id <= MAX_CMD_ID; cmd_id++) {
@@ -123,16 +131,65 @@ void v_packet_history_init(struct VPacket_History *history)
 {
 	int cmd_id;
 
-	history->packets.first = NULL;
-	history->packets.last = NULL;
+	history->packets = (struct VSent_Packet*)calloc(INIT_PACKET_HISTORY_LEN,
+			sizeof(struct VSent_Packet));
+	history->length = (history->packets != NULL) ? INIT_PACKET_HISTORY_LEN : 0;
+	history->first_id = 0;
+	history->count = 0;
 
+	/* Histories of commands are created, when they are used */
 	for(cmd_id=0; cmd_id<=MAX_CMD_ID; cmd_id++) {
-		history->cmd_hist[cmd_id] = v_cmd_queue_create(cmd_id, 0, 0);
+		history->cmd_hist[cmd_id] = NULL;
 	}
 }
 
 /**
- * \brief Find packet with id in the linked list of sent packet. When such
+ * \brief This function moves packets to the new ring buffer, that is big
+ * enough to store packets with IDs from first_id to id.
+ * \param[in]	*history	The history of sent packets.
+ * \param[in]	id			The ID of packet, that will be added to the history.
+ * \return		This function returns 1, when ring buffer was resized. Otherwise
+ * it returns 0.
+ */
+static int v_packet_history_grow(struct VPacket_History *history,
+		uint32 id)
+{
+	struct VSent_Packet *new_packets, *packet;
+	uint32 new_length = (history->length > 0) ? history->length : INIT_PACKET_HISTORY_LEN;
+	uint32 i;
+
+	while(new_length <= id - history->first_id) {
+		if(new_length > (UINT32_MAX >> 1)) {
+			return 0;
+		}
+		new_length <<= 1;
+	}
+
+	new_packets = (struct VSent_Packet*)calloc(new_length, sizeof(struct VSent_Packet));
+	if(new_packets == NULL) {
+		return 0;
+	}
+
+	/* Move used slots to the new ring buffer. Arrays of commands in unused
+	 * slots are freed. */
+	for(i = 0; i < history->length; i++) {
+		packet = &history->packets[i];
+		if(packet->used == 1) {
+			new_packets[packet->id & (new_length - 1)] = *packet;
+		} else if(packet->cmds != NULL) {
+			free(packet->cmds);
+		}
+	}
+
+	free(history->packets);
+	history->packets = new_packets;
+	history->length = new_length;
+
+	return 1;
+}
+
+/**
+ * \brief Find packet with id in the ring buffer of sent packets. When such
  * packet is not found, then NULL is returned.
  * \param[in]	*history	The history of sent packets.
  * \param[in]	id			The ID of packet.
@@ -141,16 +198,19 @@ void v_packet_history_init(struct VPacket_History *history)
 struct VSent_Packet *v_packet_history_find_packet(struct VPacket_History *history,
 		uint32 id)
 {
-	struct VSent_Packet *packet = NULL;
+	struct VSent_Packet *packet;
+
+	if(history->count == 0 || (id - history->first_id) >= history->length) {
+		return NULL;
+	}
 
-	packet = history->packets.first;
+	packet = &history->packets[id & (history->length - 1)];
 
-	while(packet != NULL) {
-		if(packet->id == id) break;
-		packet = packet->next;
+	if(packet->used == 1 && packet->id == id) {
+		return packet;
 	}
 
-	return packet;
+	return NULL;
 }
 
 /**
@@ -165,25 +225,82 @@ struct VSent_Packet *v_packet_history_add_packet(struct VPacket_History *history
 {
 	struct VSent_Packet *packet = NULL;
 
-	packet = (struct VSent_Packet*)malloc(sizeof(struct VSent_Packet));
-
-	/* Check if memory for sent packet was allocated */
-	if(packet != NULL) {
-		packet->cmds.first = NULL;
-		packet->cmds.last = NULL;
-
-		packet->id = id;
+	if(history->count == 0) {
+		history->first_id = id;
+	}
 
-		v_print_log(VRS_PRINT_DEBUG_MSG, "Adding packet: %d to history\n", packet->id);
+	/* Packets are added in order of IDs */
+	assert((id - history->first_id) < (UINT32_MAX >> 1));
 
-		v_list_add_tail(&history->packets, packet);
-	} else {
+	/* Check if there is free slot for sent packet */
+	if((id - history->first_id) >= history->length &&
+			v_packet_history_grow(history, id) != 1)
+	{
 		v_print_log(VRS_PRINT_DEBUG_MSG, "Unable to allocate enough memory for sent packet: %d\n", id);
+		return NULL;
 	}
 
+	packet = &history->packets[id & (history->length - 1)];
+
+	assert(packet->used == 0);
+
+	packet->used = 1;
+	packet->id = id;
+	packet->cmd_count = 0;
+	packet->size = 0;
+
+	history->count++;
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Adding packet: %d to history\n", packet->id);
+
 	return packet;
 }
 
+/**
+ * \brief This function adds pointer at command to the array of commands
+ * in the sent packet.
+ *
+ * Buckets in command history point at items of this array. When the array
+ * is reallocated, then these pointers are updated.
+ *
+ * \return This function returns pointer at new item of array or NULL, when
+ * it was not possible to allocate memory.
+ */
+static struct VSent_Command *v_sent_packet_add_cmd(struct VSent_Packet *sent_packet)
+{
+	struct VSent_Command *cmds;
+	uint16 i;
+
+	if(sent_packet->cmd_count == sent_packet->cmd_length) {
+		uint32 new_length = (sent_packet->cmd_length == 0) ?
+				INIT_SENT_CMDS_LEN : 2*sent_packet->cmd_length;
+
+		if(new_length > UINT16_MAX) {
+			return NULL;
+		}
+
+		cmds = (struct VSent_Command*)realloc(sent_packet->cmds,
+				new_length*sizeof(struct VSent_Command));
+		if(cmds == NULL) {
+			return NULL;
+		}
+
+		/* Update back pointers from command history */
+		if(cmds != sent_packet->cmds) {
+			for(i = 0; i < sent_packet->cmd_count; i++) {
+				if(cmds[i].vbucket != NULL) {
+					cmds[i].vbucket->ptr = (void*)&cmds[i];
+				}
+			}
+		}
+
+		sent_packet->cmds = cmds;
+		sent_packet->cmd_length = new_length;
+	}
+
+	return &sent_packet->cmds[sent_packet->cmd_count++];
+}
+
 /**
  * \brief This function add command to the history of sent command
  *
@@ -211,6 +328,11 @@ int v_packet_history_add_cmd(struct VPacket_History *history,
 	uint16 cmd_size = v_cmd_struct_size(cmd);
 	int ret = 0;
 
+	/* History of this type of commands is created with the first command */
+	if(v_cmd_queue_get(history->cmd_hist, cmd_id, 0, 0) == NULL) {
+		return 0;
+	}
+
 	/* Are duplications allowed for this type of commands? */
 	if(history->cmd_hist[cmd_id]->flag & REMOVE_HASH_DUPS) {
 		/* Try to find command with the same address */
@@ -233,9 +355,8 @@ int v_packet_history_add_cmd(struct VPacket_History *history,
 			 * command to the NULL (obsolete command would not be re-send) */
 			((struct VSent_Command*)(vbucket->ptr))->vbucket = NULL;
 
-			/* Remove data with the same key as cmd_data has from hashed linked
-			 * list */
-			ret = v_hash_array_remove_item(&history->cmd_hist[cmd_id]->cmds, vbucket->data);
+			/* Remove bucket of obsolete command from hashed linked list */
+			ret = v_hash_array_remove_bucket(&history->cmd_hist[cmd_id]->cmds, vbucket);
 
 			if(ret == 1) {
 				/* Destroy original command */
@@ -251,13 +372,11 @@ int v_packet_history_add_cmd(struct VPacket_History *history,
 	vbucket = v_hash_array_add_item(&history->cmd_hist[cmd_id]->cmds, _cmd, cmd_size);
 
 	if(vbucket != NULL) {
-		/* Create new command */
-		sent_cmd = (struct VSent_Command*)malloc(sizeof(struct VSent_Command));
+		/* Add command to the array of sent packet */
+		sent_cmd = v_sent_packet_add_cmd(sent_packet);
 		/* Check if it was possible to allocate enough memory for sent command */
 		if(sent_cmd != NULL) {
 			sent_cmd->id = cmd_id;
-			/* Add command to the linked list of sent packet */
-			v_list_add_tail(&sent_packet->cmds, sent_cmd);
 			/* Set up pointer at command data */
 			sent_cmd->vbucket = vbucket;
 			/* Set up pointer at owner of this command item to be able to obsolete
@@ -272,7 +391,7 @@ int v_packet_history_add_cmd(struct VPacket_History *history,
 			/* When memory wasn't allocated, then free bucket from hashed
 			 * linked list */
 			v_print_log(VRS_PRINT_ERROR, "Unable allocate enough memory for sent command\n");
-			ret = v_hash_array_remove_item(&history->cmd_hist[cmd_id]->cmds, _cmd);
+			ret = v_hash_array_remove_bucket(&history->cmd_hist[cmd_id]->cmds, vbucket);
 			if(ret == 1) {
 				v_cmd_destroy(_cmd);
 			}
@@ -309,13 +428,20 @@ int v_packet_history_rem_packet(struct vContext *C, uint32 id)
 
 	if(sent_packet != NULL) {
 		struct VSent_Command *sent_cmd;
+		uint16 i;
 
 		v_print_log(VRS_PRINT_DEBUG_MSG, "Removing packet: %d from history\n", sent_packet->id);
 
-		/* Go through the whole list of sent commands and free them from the
+		/* Decrease total size of commands that were sent and weren't
+		 * acknowledged yet. Whole size of packet is subtracted, because
+		 * commands of the packet could be obsoleted or re-sent already. */
+		dgram_conn->sent_size -= sent_packet->size;
+		sent_packet->size = 0;
+
+		/* Go through the whole array of sent commands and free them from the
 		 * hashed linked list */
-		sent_cmd = sent_packet->cmds.first;
-		while(sent_cmd != NULL) {
+		for(i = 0; i < sent_packet->cmd_count; i++) {
+			sent_cmd = &sent_packet->cmds[i];
 			/* Remove own command from hashed linked list if it wasn't already
 			 * removed, when command was obsoleted by some newer packet */
 			if(sent_cmd->vbucket != NULL) {
@@ -324,9 +450,6 @@ int v_packet_history_rem_packet(struct vContext *C, uint32 id)
 				/* Bucket has to include some data */
 				assert(sent_cmd->vbucket->data != NULL);
 
-				/* Decrease total size of commands that were sent and wasn't acknowladged yet*/
-				dgram_conn->sent_size -= v_cmd_size(cmd);
-
 				/* Put fake command for create/destroy commands at verse server */
 				if(vs_ctx != NULL) {
 					struct VSession *vsession = CTX_current_session(C);
@@ -341,8 +464,10 @@ int v_packet_history_rem_packet(struct vContext *C, uint32 id)
 					}
 				}
 
-				/* Remove command from the history of sent commands */
-				ret = v_hash_array_remove_item(&history->cmd_hist[sent_cmd->id]->cmds, sent_cmd->vbucket->data);
+				/* Remove command from the history of sent commands. Bucket is
+				 * stored in sent command, then commands with the same key
+				 * are not searched. */
+				ret = v_hash_array_remove_bucket(&history->cmd_hist[sent_cmd->id]->cmds, sent_cmd->vbucket);
 
 				if(ret == 1) {
 					/* Destroy command */
@@ -352,15 +477,20 @@ int v_packet_history_rem_packet(struct vContext *C, uint32 id)
 					ret = 0;
 				}
 			}
-			sent_cmd = sent_cmd->next;
 		}
 
-		/* Free linked list of sent commands */
-		v_list_free(&sent_packet->cmds);
+		/* Release slot of ring buffer (array of commands is kept for next
+		 * packet) */
+		sent_packet->cmd_count = 0;
+		sent_packet->used = 0;
+		history->count--;
 
-		/* Remove packet itself from the linked list of sent packet */
-		v_list_rem_item(&history->packets, sent_packet);
-		free(sent_packet);
+		/* Move beginning of ring buffer to the oldest packet in history */
+		if(history->count > 0) {
+			while(history->packets[history->first_id & (history->length - 1)].used == 0) {
+				history->first_id++;
+			}
+		}
 
 		ret = 1;
 	} else {
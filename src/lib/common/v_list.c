@@ -40,6 +40,7 @@
 #include <assert.h>
 
 #include "v_list.h"
+#include "v_slab.h"
 #include "v_common.h"
 
 void v_list_add_head(struct VListBase *listbase, void *vitem)
@@ -431,201 +432,369 @@ int v_array_init(struct VArrayBase *arraybase)
 /* -------------- Two way linked list with hashed access array -------------- */
 
 /**
- * \brief This function is hash function, that compute simple hash: modulo 256
- * from key of the item. The key is specified in has_array structure as
- * key_offset and key_size. This function doesn't include lock of the mutex,
- * because this function is always called, when has_array is already locked.
- * \param[in]	*hash_array	The pointer at structure storing linked list and
- * own array of access array
- * \param[in]	*item		The pointer at item containing key for computing
- * hash function.
- * \return This function returns index to the array of hashes, when
- * hash_array->key_size is bigger then 0, otherwise it returns -1, because it
- * is not possible to compute hash function from key with zero size.
+ * \brief This function mixes 64 bit value (finalizer of MurmurHash3)
  */
-static int32 v_hash_func_uint16(struct VHashArrayBase *hash_array, void *item)
+static uint64 v_hash_mix(uint64 x)
 {
-	uint8 *data = NULL;
-	int32 hash_value = -1;
-	int16 i = 0;
-	long unsigned int tmp = 0;
-
-	if(hash_array->key_size == 0) return -1;
-
-	/* Compute index from address */
-	if(hash_array->key_size % 2 == 0) {
-		for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-				i < hash_array->key_size;
-				i+=2, data+=2)
-		{
-			tmp += *(uint16*)data;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	return x;
+}
+
+/**
+ * \brief This function computes hash of key in item. All bytes of the key
+ * are mixed, then keys differing only in high bits are spread over whole
+ * array of slots too.
+ * \param[in]	*hash_array	The pointer at hashed linked list
+ * \param[in]	*item		The pointer at item containing key
+ * \return This function returns 32 bit hash of key.
+ */
+static uint32 v_hash_key(struct VHashArrayBase *hash_array, const void *item)
+{
+	const uint8 *key = (const uint8*)item + hash_array->key_offset;
+	uint32 size = hash_array->key_size;
+	uint64 h = 0x9e3779b97f4a7c15ULL ^ size;
+	uint64 k;
+
+	while(size >= 8) {
+		memcpy(&k, key, 8);
+		h = v_hash_mix(h ^ k);
+		key += 8;
+		size -= 8;
+	}
+
+	if(size > 0) {
+		k = 0;
+		memcpy(&k, key, size);
+		h = v_hash_mix(h ^ k);
+	}
+
+	return (uint32)(h ^ (h >> 32));
+}
+
+/**
+ * \brief This function compares keys of two items
+ * \return This function returns 0, when keys are the same.
+ */
+static int v_hash_key_cmp(struct VHashArrayBase *hash_array,
+		const void *item1,
+		const void *item2)
+{
+	return memcmp((const uint8*)item1 + hash_array->key_offset,
+			(const uint8*)item2 + hash_array->key_offset,
+			hash_array->key_size);
+}
+
+/**
+ * \brief This function tries to find slot with the same key as the item has.
+ * Some lists (queues and history of commands) could contain more items with
+ * the same key. Every key has only one slot and buckets with the same key are
+ * linked in ring, then such items do not make long clusters of slots.
+ * \return This function returns index of slot or -1, when no slot was found.
+ */
+static int64 v_hash_slots_find(struct VHashArrayBase *hash_array,
+		struct VHashSlot *slots,
+		uint32 length,
+		uint32 hash,
+		const void *item)
+{
+	uint32 mask = length - 1;
+	uint32 i;
+
+	if(slots == NULL) return -1;
+
+	for(i = hash & mask; slots[i].vbucket != NULL; i = (i + 1) & mask) {
+		if(slots[i].hash == hash) {
+			/* All buckets have to include pointer at data */
+			assert(slots[i].vbucket->data != NULL);
+
+			if(v_hash_key_cmp(hash_array, item, slots[i].vbucket->data) == 0) {
+				return i;
+			}
 		}
-	} else {
-		for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-				i < hash_array->key_size-1;
-				i+=2, data+=2)
-		{
-			tmp += *(uint16*)data;
+	}
+
+	return -1;
+}
+
+/**
+ * \brief This function tries to find the first item with the same key in the
+ * linked list of buckets. It is used by small hashed linked list without array
+ * of slots.
+ * \return This function returns pointer at bucket or NULL.
+ */
+static struct VBucket *v_hash_list_find(struct VHashArrayBase *hash_array,
+		const void *item)
+{
+	struct VBucket *vbucket;
+
+	for(vbucket = hash_array->lb.first; vbucket != NULL; vbucket = vbucket->next) {
+		if(v_hash_key_cmp(hash_array, item, vbucket->data) == 0) {
+			return vbucket;
 		}
-		/* Add not padded data to the tmp variable */
-		tmp += *(uint8*)data;
 	}
 
-	hash_value = tmp % hash_array->length;
+	return NULL;
+}
+
+/**
+ * \brief This function tries to find slot pointing at the bucket
+ * \return This function returns index of slot or -1, when no slot was found.
+ */
+static int64 v_hash_slots_find_bucket(struct VHashSlot *slots,
+		uint32 length,
+		uint32 hash,
+		const struct VBucket *vbucket)
+{
+	uint32 mask = length - 1;
+	uint32 i;
+
+	if(slots == NULL) return -1;
 
-	return hash_value;
+	for(i = hash & mask; slots[i].vbucket != NULL; i = (i + 1) & mask) {
+		if(slots[i].vbucket == vbucket) {
+			return i;
+		}
+	}
+
+	return -1;
 }
 
 /**
- * \brief The hash function, that implement simple hash function: modulo 65536.
- * The size of array of hashes is 65536*sizeof(VBucketP). This function doesn't
- * include lock of the mutex, because this function is always called, when
- * has_array is already locked.
- * \param[in]	*hash_array	The pointer at hashed linked list
- * \param[in[	*item		The pointer at item containing key to be used as
- * input to hash function
- * \return	This function returns index to the array of hashes, when
- * hash_array->key_size is bigger then 0, otherwise it returns -1, because it
- * is not possible to compute hash function from key with zero size.
+ * \brief This function adds bucket to the first free slot. There has to be
+ * at least one free slot in the array.
  */
-static int32 v_hash_func_uint32(struct VHashArrayBase *hash_array, void *item)
+static void v_hash_slots_insert(struct VHashSlot *slots,
+		uint32 length,
+		uint32 hash,
+		struct VBucket *vbucket)
 {
-	uint8 *data = NULL;
-	int16 i = 0;
-	int32 hash_value = -1;
-	uint32 modulo = 0;
-	long unsigned int tmp = 0;
-
-	if(hash_array->key_size == 0) return -1;
-
-	modulo = hash_array->key_size % 4;
-	/* Compute index from address */
-	switch(modulo) {
-		case 0:
-			for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-					i < hash_array->key_size;
-					i+=4, data+=4)
-			{
-				tmp += *(uint32*)data;
-			}
-			break;
-		case 1:
-			for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-					i < hash_array->key_size-1;
-					i+=4, data+=4)
-			{
-				tmp += *(uint32*)data;
-			}
-			tmp += *(uint16*)data;
-			data += 2;
-			tmp += *(uint8*)data;
-			break;
-		case 2:
-			for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-					i < hash_array->key_size-1;
-					i+=4, data+=4)
-			{
-				tmp += *(uint32*)data;
-			}
-			tmp += *(uint16*)data;
-			break;
-		case 3:
-			for(tmp=0, i=0, data=(uint8*)item + hash_array->key_offset;
-					i < hash_array->key_size-1;
-					i+=4, data+=4)
-			{
-				tmp += *(uint32*)data;
-			}
-			tmp += *(uint8*)data;
+	uint32 mask = length - 1;
+	uint32 i;
+
+	for(i = hash & mask; slots[i].vbucket != NULL; i = (i + 1) & mask) {}
+
+	slots[i].hash = hash;
+	slots[i].vbucket = vbucket;
+}
+
+/**
+ * \brief This function removes slot from the array. Following slots of the
+ * same cluster are shifted back, then no "deleted" marks are needed and
+ * searching can stop at the first empty slot.
+ */
+static void v_hash_slots_remove(struct VHashSlot *slots,
+		uint32 length,
+		uint32 index)
+{
+	uint32 mask = length - 1;
+	uint32 i = index, j = index, k;
+
+	while(1) {
+		j = (j + 1) & mask;
+
+		if(slots[j].vbucket == NULL) {
 			break;
+		}
+
+		/* Ideal position of item in slot j */
+		k = slots[j].hash & mask;
+
+		/* Item can't be moved, when its ideal position is in range (i, j] */
+		if( (i <= j) ? (i < k && k <= j) : (i < k || k <= j) ) {
+			continue;
+		}
+
+		slots[i] = slots[j];
+		i = j;
 	}
 
-	hash_value = tmp % hash_array->length;
+	slots[i].vbucket = NULL;
+	slots[i].hash = 0;
+}
 
-	return hash_value;
+/**
+ * \brief This function tries to find bucket with the same key as the item
+ * has. Buckets of small hashed linked list are searched directly, otherwise
+ * new and old array of slots is searched.
+ * \return This function returns pointer at bucket or NULL.
+ */
+static struct VBucket *v_hash_array_find_key(struct VHashArrayBase *hash_array,
+		const void *item)
+{
+	uint32 hash;
+	int64 index;
+
+	if(hash_array->slots == NULL) {
+		return v_hash_list_find(hash_array, item);
+	}
+
+	hash = v_hash_key(hash_array, item);
+
+	index = v_hash_slots_find(hash_array, hash_array->slots,
+			hash_array->length, hash, item);
+	if(index >= 0) {
+		return hash_array->slots[index].vbucket;
+	}
+
+	/* Key could be still in old array of slots */
+	index = v_hash_slots_find(hash_array, hash_array->old_slots,
+			hash_array->old_length, hash, item);
+	if(index >= 0) {
+		return hash_array->old_slots[index].vbucket;
+	}
+
+	return NULL;
 }
 
-/*static void print_mem(void *mem, uint32 size)
+/**
+ * \brief This function finishes resizing of array of slots
+ */
+static void v_hash_array_migrate_end(struct VHashArrayBase *hash_array)
+{
+	free(hash_array->old_slots);
+	hash_array->old_slots = NULL;
+	hash_array->old_length = 0;
+	hash_array->migrate_next = NULL;
+	hash_array->migrate_last = NULL;
+}
+
+/**
+ * \brief This function moves up to steps items from the old array of slots
+ * to the new one. Items are moved in order of the linked list and only the
+ * first bucket of every key gets slot.
+ */
+static void v_hash_array_migrate(struct VHashArrayBase *hash_array,
+		uint32 steps)
 {
-	int i;
-	for(i=0; i<size; i++) {
-		printf("%X", (int)*((char*)mem+i));
+	struct VBucket *vbucket;
+	uint32 hash;
+
+	while(hash_array->old_slots != NULL && steps > 0) {
+		vbucket = hash_array->migrate_next;
+
+		assert(vbucket != NULL && vbucket->data != NULL);
+
+		hash = v_hash_key(hash_array, vbucket->data);
+		if(v_hash_slots_find(hash_array, hash_array->slots, hash_array->length,
+				hash, vbucket->data) == -1)
+		{
+			v_hash_slots_insert(hash_array->slots, hash_array->length,
+					hash, vbucket);
+		}
+
+		if(vbucket == hash_array->migrate_last) {
+			v_hash_array_migrate_end(hash_array);
+		} else {
+			hash_array->migrate_next = vbucket->next;
+		}
+
+		steps--;
 	}
-	printf("\n");
-}*/
+}
+
+/**
+ * \brief This function allocates new array of slots, when small hashed linked
+ * list grows or when there is not enough free slots for new key. Old items are
+ * moved to the new array incrementally by following calls of add/remove
+ * functions.
+ * \param[in]	*hash_array	The pointer at hashed linked list
+ * \param[in]	new_key		The new item will have new key
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+static int v_hash_array_reserve(struct VHashArrayBase *hash_array,
+		uint8 new_key)
+{
+	struct VHashSlot *slots;
+	struct VBucket *vbucket;
+	uint32 length, hash;
+
+	/* Array of slots is allocated, when small hashed linked list grows */
+	if(hash_array->slots == NULL) {
+		if(hash_array->count + 1 <= HASH_SMALL_COUNT) {
+			return 1;
+		}
+
+		length = HASH_MIN_LENGTH;
+		while(4 * ((uint64)hash_array->key_count + 1) > 3 * (uint64)length) {
+			length <<= 1;
+		}
+
+		slots = (struct VHashSlot*)calloc(length, sizeof(struct VHashSlot));
+		if(slots == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "calloc(): no memory allocated\n");
+			return 0;
+		}
+
+		/* Small list is short, then all items are added at once */
+		for(vbucket = hash_array->lb.first; vbucket != NULL; vbucket = vbucket->next) {
+			hash = v_hash_key(hash_array, vbucket->data);
+			if(v_hash_slots_find(hash_array, slots, length, hash, vbucket->data) == -1) {
+				v_hash_slots_insert(slots, length, hash, vbucket);
+			}
+		}
+
+		hash_array->slots = slots;
+		hash_array->length = length;
+		return 1;
+	}
+
+	/* Maximal load factor is 3/4 */
+	if(new_key == 0 ||
+			4 * ((uint64)hash_array->key_count + 1) <= 3 * (uint64)hash_array->length)
+	{
+		return 1;
+	}
+
+	/* Previous resizing has to be finished before next one */
+	if(hash_array->old_slots != NULL) {
+		v_hash_array_migrate(hash_array, hash_array->count);
+	}
+
+	length = hash_array->length << 1;
+	slots = (struct VHashSlot*)calloc(length, sizeof(struct VHashSlot));
+	if(slots == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "calloc(): no memory allocated\n");
+		return 0;
+	}
+
+	hash_array->old_slots = hash_array->slots;
+	hash_array->old_length = hash_array->length;
+	hash_array->migrate_next = hash_array->lb.first;
+	hash_array->migrate_last = hash_array->lb.last;
+	hash_array->slots = slots;
+	hash_array->length = length;
+
+	if(hash_array->migrate_next == NULL) {
+		v_hash_array_migrate_end(hash_array);
+	}
+
+	return 1;
+}
 
 /**
  * \brief		This function tries to find item in hashed linked list.
  * \param[in]	*hash_array	The pointer at hashed linked list
  * \param[in]	*item		The pointer at item containing key for hash
  * function. The relative position of key in item is stored in hash_array.
- * \return		This function returns pointer at bucket, when item was found
- * in hashed linked list and it returns NULL, when item was not found.
+ * \return		This function returns pointer at bucket, when item with the same
+ * key was found in hashed linked list and it returns NULL, when item was not
+ * found. When more items have the same key, then pointer at the oldest one
+ * is returned.
  */
 struct VBucket *v_hash_array_find_item(struct VHashArrayBase *hash_array,
 		void *item)
 {
 	struct VBucket *vbucket = NULL;
-	int64 index = -1;
 
 	pthread_mutex_lock(&hash_array->mutex);
 
-	/* Hashed linked list has to include array of buckets */
-	assert(hash_array->buckets != NULL);
-
-	/* Hashed linked list has to have own hash function */
-	assert(hash_array->hash_func != NULL);
-
-	index = hash_array->hash_func(hash_array, item);
-
-	/* Found index has to be in  valid range? */
-	assert(index >= 0 && index < hash_array->length);
-
-	/* Is there any collision at this index? */
-	if(hash_array->buckets[index].next == NULL) {
-		/* If there is no collision, then return pointer at item */
-		vbucket = hash_array->buckets[index].vbucket;
-
-		/* Is there any bucket with data? */
-		if(vbucket != NULL) {
-			/* Bucket has to include some data */
-			assert(vbucket->data != NULL);
-
-			/* And check if the key of found bucket has the same as key
-			 * as the item has. */
-			if( !(memcmp((uint8*)item + hash_array->key_offset,
-					(uint8*)vbucket->data + hash_array->key_offset,
-					hash_array->key_size) == 0) )
-			{
-				/* This happens, when item is in the collision with the
-				 * bucket in the hashed linked list, but item and found bucket
-				 * has different key */
-				vbucket = NULL;
-			}
-		}
-	} else {
-		struct VBucketP *bucket_p;
-
-		/* When collision is at this index, then go through the list
-		 * and compare addresses of each item and key */
-		for( bucket_p = &hash_array->buckets[index];
-				bucket_p != NULL;
-				bucket_p = bucket_p->next)
-		{
-			/* All pointers at buckets have to include some bucket */
-			assert(bucket_p->vbucket != NULL);
-
-			/* All buckets have to include pointer at data */
-			assert(bucket_p->vbucket->data != NULL);
-
-			if( memcmp((uint8*)item + hash_array->key_offset,
-					(uint8*)bucket_p->vbucket->data + hash_array->key_offset,
-					hash_array->key_size) == 0 )
-			{
-				vbucket = bucket_p->vbucket;
-				break;
-			}
-		}
+	if(hash_array->count > 0) {
+		vbucket = v_hash_array_find_key(hash_array, item);
 	}
 
 	pthread_mutex_unlock(&hash_array->mutex);
@@ -642,27 +811,24 @@ struct VBucket *v_hash_array_add_item(struct VHashArrayBase *hash_array,
 		void *item,
 		uint16 item_size)
 {
-	struct VBucket *vbucket = NULL;
-	int64 index = -1;
+	struct VBucket *vbucket = NULL, *key_bucket;
 
 	pthread_mutex_lock(&hash_array->mutex);
 
-	/* Hashed linked list has to have own hash function */
-	assert(hash_array->hash_func != NULL);
-
-	/* Hashed linked list has to have buckets */
-	assert(hash_array->buckets != NULL);
-
 	/* The item_size has to be bigger then (key_offset + key_size).*/
 	assert( item_size >= (hash_array->key_offset + hash_array->key_size) );
 
-	index = hash_array->hash_func(hash_array, item);
+	/* Item with the same key is added only to the ring of this key */
+	key_bucket = (hash_array->count > 0) ?
+			v_hash_array_find_key(hash_array, item) : NULL;
 
-	/* Is computed index in allowed range */
-	assert(index >= 0 && index < hash_array->length);
+	/* Make sure, that there is free slot for new item */
+	if(v_hash_array_reserve(hash_array, (key_bucket == NULL)) != 1) {
+		goto end;
+	}
 
 	/* Create new bucket */
-	vbucket = (struct VBucket*)calloc(1, sizeof(struct VBucket));
+	vbucket = (struct VBucket*)v_slab_calloc(sizeof(struct VBucket));
 
 	/* Check if it was possible to allocate memory for bucket */
 	if(vbucket == NULL) {
@@ -671,8 +837,6 @@ struct VBucket *v_hash_array_add_item(struct VHashArrayBase *hash_array,
 		goto end;
 	}
 
-	v_list_add_tail(&hash_array->lb, vbucket);
-
 	if(hash_array->flags & HASH_COPY_BUCKET) {
 		/* Allocate memory for item */
 		vbucket->data = malloc(item_size);
@@ -680,8 +844,7 @@ struct VBucket *v_hash_array_add_item(struct VHashArrayBase *hash_array,
 		if(vbucket->data == NULL) {
 			v_print_log(VRS_PRINT_ERROR,
 					"Not enough memory for new data of bucket\n");
-			v_list_rem_item(&hash_array->lb, vbucket);
-			free(vbucket);
+			v_slab_free(vbucket, sizeof(struct VBucket));
 			vbucket = NULL;
 			goto end;
 		}
@@ -691,57 +854,135 @@ struct VBucket *v_hash_array_add_item(struct VHashArrayBase *hash_array,
 		vbucket->data = item;
 	}
 
-	if(hash_array->buckets[index].vbucket == NULL) {
-		/* It is first item at this index */
-		hash_array->buckets[index].vbucket = vbucket;
-		hash_array->buckets[index].next = NULL;
-	} else {
-		/* There is collision at this index */
-		struct VBucketP *vbucket_p, *new_vbucket_p;
+	v_list_add_tail(&hash_array->lb, vbucket);
 
-		/* Create new bucket pointer */
-		new_vbucket_p = (struct VBucketP *)calloc(1, sizeof(struct VBucketP));
+	if(key_bucket != NULL) {
+		/* Add bucket to the end of ring of buckets with the same key */
+		vbucket->key_next = key_bucket;
+		vbucket->key_prev = key_bucket->key_prev;
+		key_bucket->key_prev->key_next = vbucket;
+		key_bucket->key_prev = vbucket;
+	} else {
+		vbucket->key_next = vbucket;
+		vbucket->key_prev = vbucket;
 
-		/* Check if it was possible to allocate memory for pointer at
-		 * bucket */
-		if(new_vbucket_p == NULL) {
-			v_print_log(VRS_PRINT_ERROR,
-					"Not enough memory for new pointer at bucket\n");
-			v_list_rem_item(&hash_array->lb, vbucket);
-			if(hash_array->flags & HASH_COPY_BUCKET) {
-				free(vbucket->data);
-			}
-			free(vbucket);
-			vbucket = NULL;
-			goto end;
+		if(hash_array->slots != NULL) {
+			v_hash_slots_insert(hash_array->slots, hash_array->length,
+					v_hash_key(hash_array, item), vbucket);
 		}
 
-		/* Go to the end of the list */
-		for(vbucket_p = &hash_array->buckets[index];
-				vbucket_p->next != NULL;
-				vbucket_p = vbucket_p->next) {}
-
-		/* Paste new bucket pointer at the end of the linked list */
-		vbucket_p->next = new_vbucket_p;
-
-		new_vbucket_p->vbucket = vbucket;
-		new_vbucket_p->next = NULL;
+		hash_array->key_count++;
 	}
 
 	hash_array->count++;
 
+	v_hash_array_migrate(hash_array, HASH_MIGRATE_STEP);
+
 end:
 	pthread_mutex_unlock(&hash_array->mutex);
 
 	return vbucket;
 }
 
+/**
+ * \brief This function removes bucket from hashed linked list. The bucket is
+ * unlinked from the ring of buckets with the same key and only when the slot
+ * points at this bucket, then the slot is moved to the next bucket of the
+ * ring. Mutex has to be locked.
+ */
+static void _v_hash_array_remove_bucket(struct VHashArrayBase *hash_array,
+		struct VBucket *vbucket)
+{
+	struct VBucket *key_next = NULL;
+	uint32 hash;
+	int64 index, old_index;
+
+	if(vbucket->key_next != vbucket) {
+		key_next = vbucket->key_next;
+	}
+
+	if(hash_array->slots != NULL) {
+		hash = v_hash_key(hash_array, vbucket->data);
+
+		/* Bucket could be in both arrays of slots during resizing */
+		index = v_hash_slots_find_bucket(hash_array->slots,
+				hash_array->length, hash, vbucket);
+		old_index = v_hash_slots_find_bucket(hash_array->old_slots,
+				hash_array->old_length, hash, vbucket);
+
+		if(index >= 0) {
+			v_hash_slots_remove(hash_array->slots, hash_array->length, index);
+		}
+		if(old_index >= 0) {
+			v_hash_slots_remove(hash_array->old_slots, hash_array->old_length, old_index);
+		}
+
+		/* Other bucket with the same key takes slot in new array of slots */
+		if((index >= 0 || old_index >= 0) && key_next != NULL) {
+			v_hash_slots_insert(hash_array->slots, hash_array->length,
+					hash, key_next);
+		}
+	}
+
+	/* Remove bucket from the ring of buckets with the same key */
+	if(key_next != NULL) {
+		vbucket->key_prev->key_next = vbucket->key_next;
+		vbucket->key_next->key_prev = vbucket->key_prev;
+	} else {
+		hash_array->key_count--;
+	}
+	vbucket->key_prev = NULL;
+	vbucket->key_next = NULL;
+
+	/* Update range of buckets, that are not moved to new array of slots yet */
+	if(hash_array->old_slots != NULL) {
+		if(vbucket == hash_array->migrate_last) {
+			if(vbucket == hash_array->migrate_next) {
+				v_hash_array_migrate_end(hash_array);
+			} else {
+				hash_array->migrate_last = vbucket->prev;
+			}
+		} else if(vbucket == hash_array->migrate_next) {
+			hash_array->migrate_next = vbucket->next;
+		}
+	}
+
+	/* Free data of the item, when the item was copied */
+	if(hash_array->flags & HASH_COPY_BUCKET) {
+		free(vbucket->data);
+		vbucket->data = NULL;
+	}
+	vbucket->ptr = NULL;
+
+	/* Remove bucket from the linked list of buckets and free it */
+	v_list_rem_item(&hash_array->lb, vbucket);
+	v_slab_free(vbucket, sizeof(struct VBucket));
+
+	hash_array->count--;
+
+	if(hash_array->count == 0) {
+		/* Free memory of empty hashed linked list. New array of slots will
+		 * be allocated, when it grows over HASH_SMALL_COUNT items again. */
+		if(hash_array->old_slots != NULL) {
+			v_hash_array_migrate_end(hash_array);
+		}
+		free(hash_array->slots);
+		hash_array->slots = NULL;
+		hash_array->length = 0;
+	} else {
+		v_hash_array_migrate(hash_array, HASH_MIGRATE_STEP);
+	}
+}
+
 /**
  * \brief This function tries to remove item from hashed linked list. The size
  * of item has to be bigger then key_offset and key_size, because the key in
  * this item is used as input for hash function. When corresponding bucket is
  * found, then it is removed from hashed linked list. If flag of hash_array is
- * set to HASH_COPY_BUCKET, then data of bucket are freed.
+ * set to HASH_COPY_BUCKET, then data of bucket are freed. When more items have
+ * the same key, then bucket pointing at the item itself is preferred and
+ * ring of buckets with this key is searched. Use v_hash_array_remove_bucket(),
+ * when bucket of the item is known.
  * \param[in]	*hash_array	The pointer at hashed linked list
  * \param		*item		The pointer at item to try to removed from hashed
  * linked list
@@ -750,131 +991,70 @@ end:
  */
 int v_hash_array_remove_item(struct VHashArrayBase *hash_array, void *item)
 {
-	int ret = 0;
-	int64 index = -1;
+	struct VBucket *vbucket = NULL, *key_bucket;
 
 	pthread_mutex_lock(&hash_array->mutex);
 
-	if(hash_array->buckets != NULL) {
-
-		/* Each hash array has to have own hash function */
-		assert(hash_array->hash_func != NULL);
-
-		index = hash_array->hash_func(hash_array, item);
+	if(hash_array->count == 0) {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Item wasn't removed, hashed linked list is empty\n");
+		pthread_mutex_unlock(&hash_array->mutex);
+		return 0;
+	}
 
-		/* Hash function has to return index in allowed range */
-		assert(index >=0 && index < hash_array->length);
+	key_bucket = v_hash_array_find_key(hash_array, item);
 
-		/* Was any bucket found at this index? */
-		if(hash_array->buckets[index].vbucket != NULL) {
+	if(key_bucket == NULL) {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Item wasn't removed, no item with the same key\n");
+		pthread_mutex_unlock(&hash_array->mutex);
+		return 0;
+	}
 
-			/* Is there any collision at this index? */
-			if(hash_array->buckets[index].next == NULL) {
-				/* If there is no collision, then it is simple */
+	/* Try to find bucket of the item itself */
+	vbucket = key_bucket;
+	while(vbucket->data != item) {
+		vbucket = vbucket->key_next;
+		if(vbucket == key_bucket) {
+			break;
+		}
+	}
 
-				/* Bucket has to include some data */
-				assert(hash_array->buckets[index].vbucket->data != NULL);
+	_v_hash_array_remove_bucket(hash_array, vbucket);
 
-				/* Is this really item, that we try to remove */
-				if( (memcmp((uint8*)item + hash_array->key_offset,
-						(uint8*)hash_array->buckets[index].vbucket->data + hash_array->key_offset,
-						hash_array->key_size) == 0))
-				{
-					/* Free data of the item, when the item was copied */
-					if(hash_array->flags & HASH_COPY_BUCKET) {
-						free(hash_array->buckets[index].vbucket->data);
-						hash_array->buckets[index].vbucket->data = NULL;
-					}
-					hash_array->buckets[index].vbucket->ptr = NULL;
+	pthread_mutex_unlock(&hash_array->mutex);
 
-					/* Remove bucket from the linked list of buckets */
-					v_list_rem_item(&hash_array->lb, hash_array->buckets[index].vbucket);
+	return 1;
+}
 
-					/* Free bucket */
-					free(hash_array->buckets[index].vbucket);
-					/* Update VbucketP pointer */
-					hash_array->buckets[index].vbucket = NULL;
+/**
+ * \brief This function removes bucket from hashed linked list. The bucket
+ * has to be in this hashed linked list and it is freed. If flag of hash_array
+ * is set to HASH_COPY_BUCKET, then data of bucket are freed too. Items with
+ * the same key are not searched, then it is preferred way of removing items
+ * from lists containing many items with the same key.
+ * \param[in]	*hash_array	The pointer at hashed linked list
+ * \param[in]	*vbucket	The pointer at bucket returned by
+ * v_hash_array_add_item() or v_hash_array_find_item()
+ * \return	This function returns 1, when bucket was removed and it returns 0,
+ * when hashed linked list is empty.
+ */
+int v_hash_array_remove_bucket(struct VHashArrayBase *hash_array,
+		struct VBucket *vbucket)
+{
+	assert(vbucket != NULL && vbucket->key_next != NULL);
 
-					hash_array->count--;
+	pthread_mutex_lock(&hash_array->mutex);
 
-					ret = 1;
-				} else {
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Item wasn't removed, key of item doesn't match at index: %d\n", index);
-				}
-			} else {
-				/* When collision is at this index, then it is necessary to find
-				 * right bucket. Go through the list and compare key of each item */
-				struct VBucketP *vbucket_p, *prev_vbucket_p;
-
-				for( vbucket_p = &hash_array->buckets[index], prev_vbucket_p = NULL;
-						vbucket_p != NULL;
-						prev_vbucket_p = vbucket_p, vbucket_p = vbucket_p->next)
-				{
-					/* Pointer at bucket has to include valid pointer */
-					assert(vbucket_p->vbucket != NULL);
-
-					/* Bucket has to include pointer at data*/
-					assert(vbucket_p->vbucket->data != NULL);
-
-					if( memcmp((uint8*)item + hash_array->key_offset,
-							(uint8*)vbucket_p->vbucket->data + hash_array->key_offset,
-							hash_array->key_size) == 0 )
-					{
-						/* Free data of the item, when the item was copied */
-						if(hash_array->flags & HASH_COPY_BUCKET) {
-							free(vbucket_p->vbucket->data);
-							vbucket_p->vbucket->data = NULL;
-						}
-						vbucket_p->vbucket->ptr = NULL;
-
-						/* Remove bucket from the linked list */
-						v_list_rem_item(&hash_array->lb, vbucket_p->vbucket);
-
-						/* Free bucket */
-						free(vbucket_p->vbucket);
-						vbucket_p->vbucket = NULL;
-
-						/* Update VbucketP linked list */
-						if(prev_vbucket_p == NULL) {
-							struct VBucketP *next_vbucket_p = vbucket_p->next;
-							/* In this case first VBucketP is removed from
-							 * the list and second VBucketP will be removed.
-							 * Second VBucketP has to exist, because we are
-							 * handling collision */
-							vbucket_p->vbucket = vbucket_p->next->vbucket;
-							vbucket_p->next = vbucket_p->next->next;
-							free(next_vbucket_p);
-						} else {
-							if(vbucket_p->next==NULL) {
-								/* In this case last VBucketP is removed from the list */
-								prev_vbucket_p->next = NULL;
-								free(vbucket_p);
-							} else {
-								/* VBucketP between other VBucketPs is removed */
-								prev_vbucket_p->next = vbucket_p->next;
-								free(vbucket_p);
-							}
-						}
-
-						hash_array->count--;
-
-						ret = 1;
-						break;
-					}
-				}
-
-				if(ret != 1) {
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Item wasn't removed, no item with the same key at index: %d\n", index);
-				}
-			}
-		} else {
-			v_print_log(VRS_PRINT_DEBUG_MSG, "Item wasn't removed, no item at index: %d\n", index);
-		}
+	if(hash_array->count == 0) {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Bucket wasn't removed, hashed linked list is empty\n");
+		pthread_mutex_unlock(&hash_array->mutex);
+		return 0;
 	}
 
+	_v_hash_array_remove_bucket(hash_array, vbucket);
+
 	pthread_mutex_unlock(&hash_array->mutex);
 
-	return ret;
+	return 1;
 }
 
 /**
@@ -905,42 +1085,34 @@ uint32 v_hash_array_count_items(struct VHashArrayBase *hash_array)
  */
 int v_hash_array_destroy(struct VHashArrayBase *hash_array)
 {
-	uint32 i;
-	struct VBucket *vbucket;
-	struct VBucketP *vbucket_p, *next_vbucket_p;
+	struct VBucket *vbucket, *next_vbucket;
 
 	pthread_mutex_lock(&hash_array->mutex);
 
-	if(hash_array->flags & HASH_COPY_BUCKET) {
-		for(vbucket = hash_array->lb.first;
-				vbucket != NULL;
-				vbucket = vbucket->next)
-		{
+	for(vbucket = hash_array->lb.first;
+			vbucket != NULL;
+			vbucket = next_vbucket)
+	{
+		next_vbucket = vbucket->next;
+		if(hash_array->flags & HASH_COPY_BUCKET) {
 			free(vbucket->data);
-			vbucket->data = NULL;
 		}
+		v_slab_free(vbucket, sizeof(struct VBucket));
 	}
+	hash_array->lb.first = NULL;
+	hash_array->lb.last = NULL;
 
-	v_list_free(&hash_array->lb);
-
-	/* Go to through the whole access array and free VBucketP for indexes
-	 * with collisions */
-	for(i = 0; i< hash_array->length; i++) {
-		if(hash_array->buckets[i].next != NULL) {
-			vbucket_p = hash_array->buckets[i].next;
-			while(vbucket_p != NULL) {
-				next_vbucket_p = vbucket_p->next;
-				free(vbucket_p);
-				vbucket_p = next_vbucket_p;
-			}
-		}
+	if(hash_array->old_slots != NULL) {
+		v_hash_array_migrate_end(hash_array);
 	}
 
-	free(hash_array->buckets);
-	hash_array->buckets = NULL;
+	if(hash_array->slots != NULL) {
+		free(hash_array->slots);
+		hash_array->slots = NULL;
+	}
 
 	hash_array->count = 0;
-	hash_array->hash_func = NULL;
+	hash_array->key_count = 0;
 	hash_array->key_offset = 0;
 	hash_array->key_size = 0;
 	hash_array->length = 0;
@@ -955,11 +1127,12 @@ int v_hash_array_destroy(struct VHashArrayBase *hash_array)
 /**
  * \brief This function initialize new hashed linked list. This hashed linked
  * list could store hashed data, or it could include only pointers at external
- * data. Two hash functions are supported now.
+ * data. Array of slots is allocated, when list contains more than
+ * HASH_SMALL_COUNT items and it grows with number of items.
  * \param[out]	*hash_array	The pointer at hashed linked list to be initialized
- * \param[in]	flags		The flags, where type of hash is specified and this
- * flag specify, if items will be copied to the bucket, or buckets will include
- * only pointers at items.
+ * \param[in]	flags		The flags, where expected size of hash is specified
+ * and this flag specify, if items will be copied to the bucket, or buckets
+ * will include only pointers at items.
  * \param[in]	key_offset	The offset of key in item
  * \param[in]	key_size	The size of key in item
  * \return This function returns 1, when hashed linked list is initialized and
@@ -970,8 +1143,7 @@ int v_hash_array_init(struct VHashArrayBase *hash_array,
 		uint8 key_offset,
 		uint8 key_size)
 {
-	uint32 i;
-	int res, ret = 0;
+	int res;
 
 	/* Initialize mutex of this array */
 	if((res = pthread_mutex_init(&hash_array->mutex, NULL)) != 0) {
@@ -982,55 +1154,21 @@ int v_hash_array_init(struct VHashArrayBase *hash_array,
 
 	pthread_mutex_lock(&hash_array->mutex);
 
-	/* Default values */
 	hash_array->lb.first = NULL;
 	hash_array->lb.last = NULL;
 	hash_array->count = 0;
+	hash_array->key_count = 0;
 	hash_array->length = 0;
-	hash_array->buckets = NULL;
-	hash_array->hash_func = NULL;
-	hash_array->key_offset = 0;
-	hash_array->key_size = 0;
-	hash_array->flags = 0;
-
-	if(flags & HASH_MOD_256) {
-		hash_array->length = 256;
-		hash_array->buckets = (struct VBucketP*)calloc(hash_array->length,
-				sizeof(struct VBucketP));
-		if(hash_array->buckets == NULL) {
-			v_print_log(VRS_PRINT_ERROR, "calloc(): no memory allocated\n");
-			goto end;
-		}
-		for(i=0; i<hash_array->length; i++) {
-			hash_array->buckets[i].vbucket = NULL;
-			hash_array->buckets[i].next = NULL;
-		}
-		hash_array->hash_func = v_hash_func_uint16;
-	} else if(flags & HASH_MOD_65536) {
-		hash_array->length = 65536;
-		hash_array->buckets = (struct VBucketP*)calloc(hash_array->length,
-				sizeof(struct VBucketP));
-		if(hash_array->buckets == NULL) {
-			v_print_log(VRS_PRINT_ERROR, "calloc(): no memory allocated\n");
-			goto end;
-		}
-		for(i=0; i<hash_array->length; i++) {
-			hash_array->buckets[i].vbucket = NULL;
-			hash_array->buckets[i].next = NULL;
-		}
-		hash_array->hash_func = v_hash_func_uint32;
-	} else {
-		v_print_log(VRS_PRINT_ERROR, "Unsupported hash function\n");
-		goto end;
-	}
-
-	ret = 1;
+	hash_array->slots = NULL;
+	hash_array->old_slots = NULL;
+	hash_array->old_length = 0;
+	hash_array->migrate_next = NULL;
+	hash_array->migrate_last = NULL;
 	hash_array->key_offset = key_offset;
 	hash_array->key_size = key_size;
 	hash_array->flags = flags;
 
-end:
 	pthread_mutex_unlock(&hash_array->mutex);
 
-	return ret;
+	return 1;
 }
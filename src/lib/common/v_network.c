@@ -33,6 +33,11 @@
  *
  */
 
+#ifdef __linux__
+/* Needed for sendmmsg() and recvmmsg() */
+#define _GNU_SOURCE
+#endif
+
 #ifdef WITH_OPENSSL
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -426,6 +431,9 @@ void v_print_packet_header(const unsigned char level, const VPacket *vpacket)
 				case FIN_FLAG:
 					v_print_log_simple(level, "FIN,");
 					break;
+				case CMP_FLAG:
+					v_print_log_simple(level, "CMP,");
+					break;
 			}
 		}
 	}
@@ -793,6 +801,230 @@ again:
 
 }
 
+/**
+ * \brief This function initializes empty batch of outgoing packets
+ */
+void v_packet_batch_init(struct VPacketBatch *batch)
+{
+	batch->sockfd = -1;
+	batch->count = 0;
+}
+
+/**
+ * \brief This function sends all packets queued in the batch. All packets
+ * are sent with one call of sendmmsg(), when it is available.
+ *
+ * \param[in]	*batch	The batch of outgoing packets
+ *
+ * \return	This function returns number of packets, that were sent.
+ */
+int v_packet_batch_flush(struct VPacketBatch *batch)
+{
+	struct VBatchPacket *packet;
+	unsigned int i, sent = 0;
+	int ret;
+#ifdef __linux__
+	struct mmsghdr msgs[MAX_PACKET_BATCH_COUNT];
+	struct iovec iovecs[MAX_PACKET_BATCH_COUNT];
+#endif
+
+	if(batch->count == 0) {
+		return 0;
+	}
+
+#ifdef __linux__
+	memset(msgs, 0, batch->count*sizeof(struct mmsghdr));
+	for(i = 0; i < batch->count; i++) {
+		packet = &batch->packets[i];
+		iovecs[i].iov_base = packet->buf;
+		iovecs[i].iov_len = packet->buf_size;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		if(packet->connected == 0) {
+			if(packet->peer_addr.ip_ver == IPV4) {
+				msgs[i].msg_hdr.msg_name = &packet->peer_addr.addr.ipv4;
+				msgs[i].msg_hdr.msg_namelen = sizeof(packet->peer_addr.addr.ipv4);
+			} else {
+				msgs[i].msg_hdr.msg_name = &packet->peer_addr.addr.ipv6;
+				msgs[i].msg_hdr.msg_namelen = sizeof(packet->peer_addr.addr.ipv6);
+			}
+		}
+	}
+
+	i = 0;
+	while(i < batch->count) {
+		ret = sendmmsg(batch->sockfd, &msgs[i], batch->count - i, 0);
+		if(ret == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			/* Skip packet, that could not be sent */
+			v_print_log(VRS_PRINT_ERROR, "sendmmsg(%d, ..., %d, 0): %s\n",
+					batch->sockfd, batch->count - i, strerror(errno));
+			i++;
+		} else {
+			i += ret;
+			sent += ret;
+		}
+	}
+#else
+	for(i = 0; i < batch->count; i++) {
+		packet = &batch->packets[i];
+		if(packet->connected == 1) {
+			ret = send(batch->sockfd, packet->buf, packet->buf_size, 0);
+		} else if(packet->peer_addr.ip_ver == IPV4) {
+			ret = sendto(batch->sockfd, packet->buf, packet->buf_size, 0,
+					(struct sockaddr*)&packet->peer_addr.addr.ipv4,
+					sizeof(packet->peer_addr.addr.ipv4));
+		} else {
+			ret = sendto(batch->sockfd, packet->buf, packet->buf_size, 0,
+					(struct sockaddr*)&packet->peer_addr.addr.ipv6,
+					sizeof(packet->peer_addr.addr.ipv6));
+		}
+		if(ret == -1) {
+			v_print_log(VRS_PRINT_ERROR, "sendto(): %s\n", strerror(errno));
+		} else {
+			sent++;
+		}
+	}
+#endif
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Batch of %d packets sent to socket: %d\n",
+			sent, batch->sockfd);
+
+	batch->count = 0;
+
+	return sent;
+}
+
+/**
+ * \brief This function copies packet from IO context to the batch of
+ * outgoing packets. Queued packets are sent, when the batch is full or
+ * packet is sent through different socket.
+ *
+ * \return	This function returns 1, when packet was queued and it returns 0,
+ * when packet is too big for batch.
+ */
+static int v_packet_batch_add(struct VPacketBatch *batch,
+		const struct IO_CTX *io_ctx)
+{
+	struct VBatchPacket *packet;
+
+	if(io_ctx->buf_size > MAX_PACKET_BATCH_SIZE) {
+		return 0;
+	}
+
+	if(batch->count > 0 &&
+			(batch->sockfd != io_ctx->sockfd || batch->count == MAX_PACKET_BATCH_COUNT))
+	{
+		v_packet_batch_flush(batch);
+	}
+
+	batch->sockfd = io_ctx->sockfd;
+
+	packet = &batch->packets[batch->count];
+	packet->connected = (io_ctx->flags & SOCKET_CONNECTED) ? 1 : 0;
+	if(packet->connected == 0) {
+		packet->peer_addr = io_ctx->peer_addr;
+		packet->peer_addr.ip_ver = io_ctx->host_addr.ip_ver;
+	}
+	packet->buf_size = (unsigned short)io_ctx->buf_size;
+	memcpy(packet->buf, io_ctx->buf, io_ctx->buf_size);
+	batch->count++;
+
+	return 1;
+}
+
+/**
+ * \brief This function receives up to count packets from unconnected UDP
+ * socket with one call of recvmmsg(), when it is available. Socket has to
+ * be non-blocking.
+ *
+ * \param[in]	sockfd		The UDP socket
+ * \param[out]	**bufs		The array of buffers (MAX_PACKET_SIZE bytes each)
+ * \param[out]	*buf_sizes	The array of sizes of received packets
+ * \param[out]	*peer_addrs	The array of addresses of senders
+ * \param[in]	count		The number of buffers
+ * \param[out]	*error_num	The error number, when no packet was received
+ *
+ * \return	This function returns number of received packets.
+ */
+int v_receive_packet_batch(int sockfd,
+		char **bufs,
+		ssize_t *buf_sizes,
+		struct VNetworkAddress *peer_addrs,
+		unsigned int count,
+		int *error_num)
+{
+	struct sockaddr_storage addrs[MAX_PACKET_BATCH_COUNT];
+	unsigned int i;
+	int ret;
+#ifdef __linux__
+	struct mmsghdr msgs[MAX_PACKET_BATCH_COUNT];
+	struct iovec iovecs[MAX_PACKET_BATCH_COUNT];
+#else
+	socklen_t addr_len;
+#endif
+
+	*error_num = 0;
+
+	if(count > MAX_PACKET_BATCH_COUNT) {
+		count = MAX_PACKET_BATCH_COUNT;
+	}
+
+#ifdef __linux__
+	memset(msgs, 0, count*sizeof(struct mmsghdr));
+	for(i = 0; i < count; i++) {
+		iovecs[i].iov_base = bufs[i];
+		iovecs[i].iov_len = MAX_PACKET_SIZE;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+	}
+
+	do {
+		ret = recvmmsg(sockfd, msgs, count, MSG_DONTWAIT, NULL);
+	} while(ret == -1 && errno == EINTR);
+
+	if(ret == -1) {
+		*error_num = errno;
+		return 0;
+	}
+
+	for(i = 0; i < (unsigned int)ret; i++) {
+		buf_sizes[i] = msgs[i].msg_len;
+	}
+#else
+	for(i = 0; i < count; i++) {
+		addr_len = sizeof(struct sockaddr_storage);
+		buf_sizes[i] = recvfrom(sockfd, bufs[i], MAX_PACKET_SIZE, MSG_DONTWAIT,
+				(struct sockaddr*)&addrs[i], &addr_len);
+		if(buf_sizes[i] == -1) {
+			*error_num = errno;
+			break;
+		}
+	}
+	ret = i;
+#endif
+
+	for(i = 0; i < (unsigned int)ret; i++) {
+		memset(&peer_addrs[i], 0, sizeof(struct VNetworkAddress));
+		peer_addrs[i].protocol = UDP;
+		if(addrs[i].ss_family == AF_INET) {
+			peer_addrs[i].ip_ver = IPV4;
+			memcpy(&peer_addrs[i].addr.ipv4, &addrs[i], sizeof(struct sockaddr_in));
+			peer_addrs[i].port = ntohs(peer_addrs[i].addr.ipv4.sin_port);
+		} else if(addrs[i].ss_family == AF_INET6) {
+			peer_addrs[i].ip_ver = IPV6;
+			memcpy(&peer_addrs[i].addr.ipv6, &addrs[i], sizeof(struct sockaddr_in6));
+			peer_addrs[i].port = ntohs(peer_addrs[i].addr.ipv6.sin6_port);
+		}
+	}
+
+	return ret;
+}
+
 /* Send Verse packet through unsecured UDP socket. */
 int v_send_packet(struct IO_CTX *io_ctx, int *error_num)
 {
@@ -829,6 +1061,17 @@ again:
 		}
 	} else {
 #endif
+		/* Queue packet in batch, when packets of this connection are
+		 * sent in batches */
+		if(io_ctx->batch != NULL) {
+			if(v_packet_batch_add(io_ctx->batch, io_ctx) == 1) {
+				return SEND_PACKET_SUCCESS;
+			}
+			/* Packet is too big for batch. Send queued packets first to
+			 * keep order of packets. */
+			v_packet_batch_flush(io_ctx->batch);
+		}
+
 		if (io_ctx->flags & SOCKET_CONNECTED) {
 			if((ret = send(io_ctx->sockfd, io_ctx->buf, io_ctx->buf_size, 0)) == -1) {
 				if(error_num != NULL) *error_num = errno;
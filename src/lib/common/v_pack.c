@@ -37,6 +37,10 @@
 #include "verse_types.h"
 #include "v_pack.h"
 
+#ifdef V_PACK_SSSE3
+#include <tmmintrin.h>
+#endif
+
 /* Pack string8 to the buffer */
 size_t vnp_raw_pack_string8(void *buffer, char *string)
 {
@@ -123,3 +127,122 @@ size_t vnp_raw_pack_real64(void *buffer, real64 data)
 	size += vnp_raw_pack_uint32(buffer, punt.uint[0]);
 	return size;
 }
+
+#ifdef V_PACK_SSSE3
+/**
+ * \brief Reverse order of bytes in 16 bytes long blocks of values using
+ * SSSE3 byte shuffle.
+ */
+__attribute__((target("ssse3")))
+static size_t _vnp_raw_swap_ssse3(uint8 *dst,
+		const uint8 *src,
+		const size_t size,
+		const size_t len)
+{
+	__m128i mask;
+	size_t pos;
+
+	switch(size) {
+	case 2:
+		mask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+		break;
+	case 4:
+		mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		break;
+	case 8:
+		mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+		break;
+	default:
+		return 0;
+	}
+
+	for(pos = 0; pos + 16 <= len; pos += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(src + pos));
+		_mm_storeu_si128((__m128i *)(dst + pos), _mm_shuffle_epi8(block, mask));
+	}
+
+	return pos;
+}
+#endif
+
+/**
+ * \brief Convert the beginning of array of 2, 4 or 8 bytes long values
+ * between byte order of host and network byte order.
+ *
+ * Conversion is the same in both directions, then this function is used for
+ * packing and unpacking of arrays. Only whole 16 bytes long blocks are
+ * converted here using SIMD instructions, when the CPU supports them. The
+ * rest of values has to be converted by caller.
+ *
+ * \param[out]	*dst	The destination buffer
+ * \param[in]	*src	The source buffer
+ * \param[in]	size	The size of one value in bytes
+ * \param[in]	count	The number of values in array
+ *
+ * \return This function returns number of converted values.
+ */
+size_t vnp_raw_swap_array(void *dst,
+		const void *src,
+		const size_t size,
+		const size_t count)
+{
+#ifdef V_PACK_SSSE3
+	if(count * size >= 16 && __builtin_cpu_supports("ssse3")) {
+		return _vnp_raw_swap_ssse3(dst, src, size, count * size) / size;
+	}
+#else
+	(void)dst;
+	(void)src;
+	(void)size;
+	(void)count;
+#endif
+	return 0;
+}
+
+/**
+ * \brief Pack array of two bytes values (uint16, int16, real16) to the buffer
+ */
+size_t vnp_raw_pack_uint16_array(void *buffer, const void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(buffer, data, sizeof(uint16), count);
+	uint16 value;
+
+	for(; i < count; i++) {
+		memcpy(&value, (const uint8 *)data + i*sizeof(value), sizeof(value));
+		vnp_raw_pack_uint16((uint8 *)buffer + i*sizeof(value), value);
+	}
+
+	return count*sizeof(value);
+}
+
+/**
+ * \brief Pack array of four bytes values (uint32, int32, real32) to the buffer
+ */
+size_t vnp_raw_pack_uint32_array(void *buffer, const void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(buffer, data, sizeof(uint32), count);
+	uint32 value;
+
+	for(; i < count; i++) {
+		memcpy(&value, (const uint8 *)data + i*sizeof(value), sizeof(value));
+		vnp_raw_pack_uint32((uint8 *)buffer + i*sizeof(value), value);
+	}
+
+	return count*sizeof(value);
+}
+
+/**
+ * \brief Pack array of eight bytes values (uint64, int64, real64) to the buffer
+ */
+size_t vnp_raw_pack_uint64_array(void *buffer, const void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(buffer, data, sizeof(uint64), count);
+	uint64 value;
+
+	for(; i < count; i++) {
+		memcpy(&value, (const uint8 *)data + i*sizeof(value), sizeof(value));
+		vnp_raw_pack_uint64((uint8 *)buffer + i*sizeof(value), value);
+	}
+
+	return count*sizeof(value);
+}
@@ -43,9 +43,11 @@
 #include "v_fake_commands.h"
 #include "v_out_queue.h"
 #include "v_history.h"
+#include "v_congestion.h"
 #include "v_cmd_queue.h"
 
 #include "v_resend_mechanism.h"
+#include "v_compress.h"
 
 /**
  * \brief This function check if it is necessary to send payload packet
@@ -57,9 +59,11 @@ static int check_pay_flag(struct vContext *C)
 	struct timeval tv;
 	int ret = 0;
 
-	/* When there are no payload data to send, then there is possibly need
-	 * for sending keep alive packet. */
-	if(v_out_queue_get_count(vsession->out_queue) > 0) {
+	/* When there are no payload data to send or congestion window is full,
+	 * then there is possibly need for sending keep alive packet. */
+	if(v_out_queue_get_count(vsession->out_queue) > 0 &&
+			v_cc_send_window(vconn) > 0)
+	{
 		ret = 1;
 	} else {
 		long int d_timeout, d_sec_timeout, d_usec_timeout;
@@ -115,6 +119,109 @@ static int check_ack_nak_flag(struct vContext *C)
 	return ret;
 }
 
+/**
+ * \brief This function adds not obsolete commands of lost packet back to the
+ * outgoing queue and it removes the packet from history of sent packets.
+ * Commands are added to the head of the queue in reverse order, then they
+ * are sent in original order.
+ */
+static void resend_lost_packet(struct vContext *C,
+		struct VSent_Packet *sent_packet)
+{
+	struct VSession *vsession = CTX_current_session(C);
+	struct VDgramConn *vconn = CTX_current_dgram_conn(C);
+	struct VSent_Command *sent_cmd;
+	int j;
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Try to re-send packet: %d\n", sent_packet->id);
+
+	/* Go through all commands in command array and add not
+	 * obsolete commands to the outgoing queue */
+	for(j = sent_packet->cmd_count; j > 0; j--) {
+		sent_cmd = &sent_packet->cmds[j-1];
+
+		if(sent_cmd->vbucket != NULL &&
+				sent_cmd->vbucket->data != NULL)
+		{
+			/* Try to add command back to the outgoing command queue */
+			if(v_out_queue_push_head(vsession->out_queue,
+					sent_cmd->prio,
+					(struct Generic_Cmd*)sent_cmd->vbucket->data) == 1)
+			{
+				/* Remove bucket from the history of sent commands too */
+				v_hash_array_remove_bucket(&vconn->packet_history.cmd_hist[sent_cmd->id]->cmds,
+						sent_cmd->vbucket);
+
+				/* When command was added back to the queue,
+				 * then forget sent command (not data of command) */
+				sent_cmd->vbucket = NULL;
+			}
+		}
+	}
+
+	/* When all not obsolete commands are added to outgoing
+	 * queue, then this packet could be removed from packet
+	 * history*/
+	v_packet_history_rem_packet(C, sent_packet->id);
+}
+
+/**
+ * \brief This function checks expiration of retransmission timeout. When RTO
+ * expired, then packets sent before more than RTO are considered as lost and
+ * their commands are re-sent like commands of negatively acknowledged packets.
+ * Otherwise size of these packets would stay in sent_size and reduced
+ * congestion window would not allow to send anything, until the peer sends
+ * NAK command.
+ */
+static void check_rto(struct vContext *C)
+{
+	struct VDgramConn *vconn = CTX_current_dgram_conn(C);
+	struct VPacket_History *history = &vconn->packet_history;
+	struct VSent_Packet *sent_packet;
+	struct timeval tv, tv_rto, tv_lost;
+	uint32 rto = vconn->rto, first_id, last_id, id;
+
+	if(vconn->cc_meth != CC_TCP_LIKE) {
+		return;
+	}
+
+	gettimeofday(&tv, NULL);
+
+	if(v_cc_check_timeout(vconn, &tv) != 1) {
+		return;
+	}
+
+	/* Packets sent before tv_lost are lost */
+	tv_rto.tv_sec = rto / 1000000;
+	tv_rto.tv_usec = rto % 1000000;
+	timersub(&tv, &tv_rto, &tv_lost);
+
+	/* Find the newest lost packet (packets are sent in order of IDs) */
+	first_id = history->first_id;
+	last_id = first_id - 1;
+	for(id = first_id;
+			(int32)(vconn->host_id + vconn->count_s_pay - id) > 0;
+			id++)
+	{
+		sent_packet = v_packet_history_find_packet(history, id);
+		if(sent_packet != NULL) {
+			if(timercmp(&sent_packet->tv, &tv_lost, >)) {
+				break;
+			}
+			last_id = id;
+		}
+	}
+
+	/* Re-send the newest packet at first, because commands are added to the
+	 * head of outgoing queue */
+	for(id = last_id; (int32)(id - first_id) >= 0; id--) {
+		sent_packet = v_packet_history_find_packet(history, id);
+		if(sent_packet != NULL) {
+			resend_lost_packet(C, sent_packet);
+		}
+	}
+}
+
 /**
  * \brief This function set size of congestion window (congestion control)
  */
@@ -127,8 +234,8 @@ static void set_host_cwin(struct vContext *C)
 		dgram_conn->cwin = 0xFFFF;
 		break;
 	case CC_TCP_LIKE:
-		/* TODO: implement real TCP like congestion control */
-		dgram_conn->cwin = 0xFFFF;
+		/* Congestion window is changed, when packets are acknowledged or
+		 * lost, or when retransmission timeout expires (see check_rto()) */
 		break;
 	case CC_RESERVED:
 		v_print_log(VRS_PRINT_WARNING, "CC_RESERVED should never be used\n");
@@ -171,134 +278,84 @@ static void set_host_rwin(struct vContext *C)
 }
 
 /**
- * \brief This function packs and compress command to the packet from one
- * priority queue.
+ * \brief This function packs and compress commands from outgoing queue to the
+ * packet. Commands are chosen by scheduler of priority queues.
  *
  * \param[in]	*C	The verse context
  * \param[in]	*sent_packet	The pointer at structure with send packet
  * \param[in]	buffer_pos		The curent size of buffer of sent packet
- * \param[in]	prio			The priority of sub queue
- * \param[in]	prio_win		The window size of current prio queue
- * \param[out]	tot_cmd_size	The total size of commands that were poped from prio queue
+ * \param[in]	window			The size of window, that could be used by commands
+ * \param[out]	tot_cmd_size	The total size of commands that were poped from queue
  */
-static int pack_prio_queue(struct vContext *C,
+static int pack_out_queue(struct vContext *C,
 		struct VSent_Packet *sent_packet,
 		int buffer_pos,
-		uint8 prio,
-		uint16 prio_win,
+		uint32 window,
 		uint16 *tot_cmd_size)
 {
 	struct VSession *vsession = CTX_current_session(C);
 	struct VDgramConn *vconn = CTX_current_dgram_conn(C);
 	struct IO_CTX *io_ctx = CTX_io_ctx(C);
+	struct VOutQueueSched sched;
+	struct VOutQueueBatch batch;
 	struct Generic_Cmd *cmd;
-	int ret, last_cmd_count = 0;
-	uint16 cmd_count, cmd_len, cmd_size, sum_len=0;
-	int8 cmd_share;
-	uint8  last_cmd_id = CMD_RESERVED_ID;
-
-	while( (v_out_queue_get_count_prio(vsession->out_queue, prio) > 0) &&
-			(sum_len < prio_win) &&
-			(buffer_pos < vconn->io_ctx.mtu))
-	{
-		cmd_count = 0;
-		cmd_share = 0;
-
-		/* Compute how many commands could be compressed to the packet
-		 * and compute right length of compressed commands. */
-		cmd_len = ((prio_win - sum_len)<(vconn->io_ctx.mtu - buffer_pos)) ?
-				(prio_win - sum_len) :
-				(vconn->io_ctx.mtu - buffer_pos);
-
-		/* Remove command from queue */
-		cmd = v_out_queue_pop(vsession->out_queue, prio, &cmd_count, &cmd_share, &cmd_len);
-
-		/* When it is not possible to pop more commands from queue, then break
-		 * while loop */
-		if(cmd == NULL) {
-			break;
-		}
+	int ret;
+	uint16 i, cmd_size;
 
-		/* Is this command fake command? */
-		if(cmd->id < MIN_CMD_ID) {
-			if(cmd->id == FAKE_CMD_CONNECT_TERMINATE) {
-				struct VS_CTX *vs_ctx = CTX_server_ctx(C);
-				if(vs_ctx != NULL) {
-					vconn->host_state = UDP_SERVER_STATE_CLOSEREQ;
-				} else {
-					vconn->host_state = UDP_CLIENT_STATE_CLOSING;
+	v_out_queue_sched_init(&sched, vsession->out_queue, window, vconn->host_cmd_cmpr);
+
+	while( (buffer_pos < vconn->io_ctx.mtu) &&
+			(v_out_queue_sched_pop(&sched, vconn->io_ctx.mtu - buffer_pos, &batch) > 0) )
+	{
+		/* Debug print */
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Prio: %d, count: %d, length: %d\n",
+				batch.prio, batch.count, batch.len);
+
+		for(i = 0; i < batch.count; i++) {
+			cmd = batch.cmds[i];
+
+			/* Is this command fake command? */
+			if(cmd->id < MIN_CMD_ID) {
+				if(cmd->id == FAKE_CMD_CONNECT_TERMINATE) {
+					struct VS_CTX *vs_ctx = CTX_server_ctx(C);
+					if(vs_ctx != NULL) {
+						vconn->host_state = UDP_SERVER_STATE_CLOSEREQ;
+					} else {
+						vconn->host_state = UDP_CLIENT_STATE_CLOSING;
+					}
+				} else if(cmd->id == FAKE_CMD_FPS) {
+					struct Fps_Cmd *fps_cmd = (struct Fps_Cmd*)cmd;
+					/* Change value of FPS. It will be sent in negotiate command
+					 * until it is confirmed be the peer (server) */
+					vsession->fps_host = fps_cmd->fps;
 				}
-			} else if(cmd->id == FAKE_CMD_FPS) {
-				struct Fps_Cmd *fps_cmd = (struct Fps_Cmd*)cmd;
-				/* Change value of FPS. It will be sent in negotiate command
-				 * until it is confirmed be the peer (server) */
-				vsession->fps_host = fps_cmd->fps;
+				v_cmd_destroy(&cmd);
+				continue;
 			}
-			v_cmd_destroy(&cmd);
-		} else {
 
 			/* What was size of command in queue */
 			cmd_size = v_cmd_size(cmd);
 
-			if(!(buffer_pos < (vconn->io_ctx.mtu - cmd_size))) {
-				/* When there is not enough space for other command,
-				 * then push command back to the beginning of queue. */
-				v_out_queue_push_head(vsession->out_queue, prio, cmd);
-				break;
-			} else {
+			/* Update total size of commands that were poped from queue */
+			*tot_cmd_size += cmd_size;
 
-				/* Update total size of commands that were poped from queue */
-				*tot_cmd_size += cmd_size;
-
-				/* When compression is not allowed, then add this command as is */
-				if( vconn->host_cmd_cmpr == CMPR_NONE) {
-					cmd_count = 0;
-					cmd_len = cmd_size;
-					/* Debug print */
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Cmd: %d, count: %d, length: %d\n",
-							cmd->id, cmd_count, cmd_len);
-					/* Add command to the buffer */
-					buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, cmd_len, 0);
-				} else {
-					/* When command compression is allowed and was ID of command changed? */
-					if( (cmd->id != last_cmd_id) || (last_cmd_count <= 0) )	{
-						/* When this command is alone, then use default command size */
-						if(cmd_count == 0) {
-							cmd_len = cmd_size;
-						} else {
-							/* FIXME: do not recompute command length here, but do it right,
-							 * when command is added to the queue */
-							cmd_len = v_cmds_len(cmd, cmd_count, cmd_share, cmd_len);
-						}
-						/* Debug print */
-						v_print_log(VRS_PRINT_DEBUG_MSG, "Cmd: %d, count: %d, length: %d\n",
-								cmd->id, cmd_count, cmd_len);
-						/* Add command to the buffer */
-						buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, cmd_len, cmd_share);
-						/* Set up current count of commands in the line */
-						last_cmd_count = cmd_count;
-						/* Update summary of commands length */
-						sum_len += cmd_len;
-					} else {
-						buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, 0, cmd_share);
-					}
-				}
-
-				/* Print command */
-				v_cmd_print(VRS_PRINT_DEBUG_MSG, cmd);
-
-				/* TODO: remove command alias here (layer value set/unset) */
+			if(batch.compressed == 1) {
+				/* The first command of compressed sequence includes header
+				 * with length of whole sequence */
+				buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd,
+						(i == 0) ? batch.len : 0, batch.share);
+			} else {
+				/* Add command to the buffer as is */
+				buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, cmd_size, 0);
+			}
 
-				/* Add command to the packet history */
-				ret = v_packet_history_add_cmd(&vconn->packet_history, sent_packet, cmd, prio);
-				assert(ret == 1);
-				(void)ret;
+			/* Print command */
+			v_cmd_print(VRS_PRINT_DEBUG_MSG, cmd);
 
-				/* Update last command id */
-				last_cmd_id = cmd->id;
-				/* Decrement counter of commands in queue */
-				last_cmd_count--;
-			}
+			/* Add command to the packet history */
+			ret = v_packet_history_add_cmd(&vconn->packet_history, sent_packet, cmd, batch.prio);
+			assert(ret == 1);
+			(void)ret;
 		}
 	}
 
@@ -319,8 +376,8 @@ int send_packet_in_OPEN_CLOSEREQ_state(struct vContext *C)
 	struct timeval tv;
 	int ret, keep_alive_packet = -1, full_packet = 0;
 	int error_num;
-	uint16 swin, prio_win, sent_size = 0;
-	uint32 rwin;
+	uint16 sent_size = 0;
+	uint32 swin, rwin, cwin;
 	int cmd_rank = 0;
 
 	/* Verse packet header */
@@ -329,6 +386,10 @@ int send_packet_in_OPEN_CLOSEREQ_state(struct vContext *C)
 	/* Clear header flags */
 	s_packet->header.flags = 0;
 
+	/* Commands of packets lost after RTO are added back to the queue before
+	 * checking, if payload packet should be sent */
+	check_rto(C);
+
 	/* Check if it is necessary to send payload packet */
 	ret = check_pay_flag(C);
 	if(ret != 0) {
@@ -388,7 +449,9 @@ int send_packet_in_OPEN_CLOSEREQ_state(struct vContext *C)
 	rwin = vconn->rwin_peer - vconn->sent_size;
 
 	/* Select smallest window for sending (congestion control window or flow control window)*/
-	swin = (vconn->cwin < rwin) ? vconn->cwin : rwin;
+	cwin = v_cc_send_window(vconn);
+	swin = (cwin < rwin) ? cwin : rwin;
+	swin = (swin < 0xFFFF) ? swin : 0xFFFF;
 
 	/* Set up Payload ID, when there is need to send payload packet */
 	if(s_packet->header.flags & PAY_FLAG)
@@ -430,55 +493,40 @@ int send_packet_in_OPEN_CLOSEREQ_state(struct vContext *C)
 		assert(sent_packet != NULL);
 
 		if(keep_alive_packet != 1) {
-			real32 prio_sum_high, prio_sum_low, r_prio;
-			uint32 prio_count;
-			int16 prio, max_prio, min_prio;
-			uint16 tot_cmd_size;
+			uint16 tot_cmd_size = 0, cmd_pos = buffer_pos, cmpr_len;
 
 			/* Print outgoing command with green color */
 			if(is_log_level(VRS_PRINT_DEBUG_MSG)) {
 				printf("%c[%d;%dm", 27, 1, 32);
 			}
 
-			max_prio = v_out_queue_get_max_prio(vsession->out_queue);
-			min_prio = v_out_queue_get_min_prio(vsession->out_queue);
-
-			prio_sum_high = v_out_queue_get_prio_sum_high(vsession->out_queue);
-			prio_sum_low = v_out_queue_get_prio_sum_low(vsession->out_queue);
-
 			v_print_log(VRS_PRINT_DEBUG_MSG, "Packing prio queues, cmd count: %d\n", v_out_queue_get_count(vsession->out_queue));
 
-			/* Go through all priorities and pick commands from priority queues */
-			for(prio = max_prio; prio >= min_prio; prio--)
-			{
-				/* TODO: Add better check here */
-				if(prio <= VRS_DEFAULT_PRIORITY && buffer_pos >= vconn->io_ctx.mtu) {
-					full_packet = 1;
-					break;
-				}
-
-				prio_count = v_out_queue_get_count_prio(vsession->out_queue, prio);
-
-				if(prio_count > 0) {
-					r_prio = v_out_queue_get_prio(vsession->out_queue, prio);
-
-					/* Compute size of buffer that could be occupied by
-					 * commands from this queue */
-					if(prio >= VRS_DEFAULT_PRIORITY) {
-						prio_win = ((swin - buffer_pos)*r_prio)/prio_sum_high;
-					} else {
-						prio_win = ((swin - buffer_pos)*r_prio)/prio_sum_low;
-					}
+			/* Pack commands chosen by scheduler of priority queues to the buffer */
+			buffer_pos = pack_out_queue(C, sent_packet, buffer_pos,
+					(swin > buffer_pos) ? (swin - buffer_pos) : 0, &tot_cmd_size);
+			sent_size += tot_cmd_size;
+			sent_packet->size = tot_cmd_size;
 
-					/* Debug print */
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Queue: %d, count: %d, r_prio: %6.3f, prio_win: %d\n",
-							prio, prio_count, r_prio, prio_win);
+			/* Packet is full and there are still some commands to send */
+			if(buffer_pos >= vconn->io_ctx.mtu &&
+					v_out_queue_get_count(vsession->out_queue) > 0)
+			{
+				full_packet = 1;
+			}
 
-					/* Get total size of commands that were stored in queue (sent_size) */
-					tot_cmd_size = 0;
-					/* Pack commands from queues with high priority to the buffer */
-					buffer_pos = pack_prio_queue(C, sent_packet, buffer_pos, prio, prio_win, &tot_cmd_size);
-					sent_size += tot_cmd_size;
+			/* Try to compress node commands in the payload. When it doesn't
+			 * help, then commands are sent uncompressed. */
+			if(buffer_pos > cmd_pos) {
+				cmpr_len = v_compress_payload(vconn->host_cmd_cmpr,
+						&io_ctx->buf[cmd_pos], buffer_pos - cmd_pos);
+				if(cmpr_len > 0) {
+					v_print_log(VRS_PRINT_DEBUG_MSG, "Payload compressed: %d -> %d\n",
+							buffer_pos - cmd_pos, cmpr_len);
+					buffer_pos = cmd_pos + cmpr_len;
+					/* Set flag in the header packed to the buffer */
+					s_packet->header.flags |= CMP_FLAG;
+					v_pack_packet_header(s_packet, io_ctx->buf);
 				}
 			}
 
@@ -577,14 +625,12 @@ static unsigned long int packet_rtt(struct VSent_Packet *sent_packet,
  */
 static int handle_ack_nak_commands(struct vContext *C)
 {
-	struct VSession *vsession = CTX_current_session(C);
 	struct VDgramConn *vconn = CTX_current_dgram_conn(C);
 	struct VPacket *r_packet = CTX_r_packet(C);
 	struct VSent_Packet *sent_packet;
-	struct VSent_Command *sent_cmd, *sent_cmd_prev;
 	unsigned long int rtt = ULONG_MAX;
 	struct timeval tv;
-	uint32 ack_id, nak_id;
+	uint32 ack_id, nak_id, sent_size, acked_size = 0;
 	int i, ret=-1;
 
 	gettimeofday(&tv, NULL);
@@ -607,14 +653,11 @@ static int handle_ack_nak_commands(struct vContext *C)
 		}
 
 		if(rtt<ULONG_MAX) {
-			/* Computation of SRTT as described in RFC */
-			if(vconn->srtt==0) {
-				vconn->srtt = rtt;
-			} else {
-				vconn->srtt = RTT_ALPHA*vconn->srtt + (1-RTT_ALPHA)*rtt;
-			}
+			/* Computation of SRTT, RTTVAR and RTO as described in RFC 6298 */
+			v_cc_rtt_sample(vconn, rtt);
 			v_print_log(VRS_PRINT_DEBUG_MSG, "RTT: %d [us]\n", rtt);
-			v_print_log(VRS_PRINT_DEBUG_MSG, "SRTT: %d [us]\n", vconn->srtt);
+			v_print_log(VRS_PRINT_DEBUG_MSG, "SRTT: %d [us], RTTVAR: %d [us], RTO: %d [us]\n",
+					vconn->srtt, vconn->rttvar, vconn->rto);
 		}
 	}
 
@@ -635,6 +678,9 @@ static int handle_ack_nak_commands(struct vContext *C)
 				ret = -2;
 			}
 
+			/* Size of not acknowledged data before removing packets */
+			sent_size = vconn->sent_size;
+
 			/* If this is not the last ACK command in the sequence of
 			 * ACK/NAK commands, then remove all packets from history of
 			 * sent packet, that are in following sub-sequence of ACK
@@ -658,6 +704,9 @@ static int handle_ack_nak_commands(struct vContext *C)
 				 * commands. Update ANK ID. */
 				vconn->ank_id = r_packet->sys_cmd[i].ack_cmd.pay_id;
 			}
+
+			/* Update size of acknowledged data */
+			acked_size += sent_size - vconn->sent_size;
 		} else if(r_packet->sys_cmd[i].cmd.id == CMD_NAK_ID) {
 
 			/* Check if ACK and NAK commands are the first system commands */
@@ -677,43 +726,17 @@ static int handle_ack_nak_commands(struct vContext *C)
 				/* Update ANK ID */
 				sent_packet = v_packet_history_find_packet(&vconn->packet_history, nak_id);
 				if(sent_packet != NULL) {
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Try to re-send packet: %d\n", nak_id);
-					sent_cmd = sent_packet->cmds.last;
-
-					/* Go through all commands in command list and add not
-					 * obsolete commands to the outgoing queue */
-					while(sent_cmd != NULL) {
-						sent_cmd_prev = sent_cmd->prev;
-
-						if(sent_cmd->vbucket != NULL &&
-								sent_cmd->vbucket->data != NULL)
-						{
-							/* Try to add command back to the outgoing command queue */
-							if(v_out_queue_push_head(vsession->out_queue,
-									sent_cmd->prio,
-									(struct Generic_Cmd*)sent_cmd->vbucket->data) == 1)
-							{
-								/* Remove bucket from the history of sent commands too */
-								v_hash_array_remove_item(&vconn->packet_history.cmd_hist[sent_cmd->id]->cmds,
-										sent_cmd->vbucket->data);
-
-								/* When command was added back to the queue,
-								 * then delete sent command (not data of command) */
-								v_list_free_item(&sent_packet->cmds, sent_cmd);
-							}
-						}
-						sent_cmd = sent_cmd_prev;
-					}
-
-					/* When all not obsolete commands are added to outgoing
-					 * queue, then this packet could be removed from packet
-					 * history*/
-					v_packet_history_rem_packet(C, nak_id);
+					/* Packet was lost, inform congestion control */
+					v_cc_nak(vconn, nak_id, &tv);
+					resend_lost_packet(C, sent_packet);
 				}
 			}
 		}
 	}
 
+	/* Congestion window could be increased, when some data were acknowledged */
+	v_cc_ack(vconn, acked_size, &tv);
+
 	return ret;
 }
 
@@ -726,7 +749,8 @@ static int handle_ack_nak_commands(struct vContext *C)
  * \param[in]	*C	The verse context.
  *
  * \return		This function returns RECEIVE_PACKET_DELAYED, when delayd packet
- * was received, otherwise it returns RECEIVE_PACKET_SUCCESS.
+ * was received, RECEIVE_PACKET_CORRUPTED, when compressed node commands could
+ * not be decompressed, otherwise it returns RECEIVE_PACKET_SUCCESS.
  */
 static int handle_node_commands(struct vContext *C)
 {
@@ -734,6 +758,8 @@ static int handle_node_commands(struct vContext *C)
 	struct VDgramConn *vconn = CTX_current_dgram_conn(C);
 	struct VPacket *r_packet = CTX_r_packet(C);
 	struct Ack_Nak_Cmd ack_nak_cmd;
+	const char *data = (const char*)r_packet->data;
+	uint16 data_size = r_packet->data_size;
 
 	/* Note: when ACK and NAK command are add to the AckNak history,
 	 * then this vector of commands is automatically compressed. */
@@ -754,15 +780,28 @@ static int handle_node_commands(struct vContext *C)
 		return RECEIVE_PACKET_UNORDERED;
 	}
 
+	/* Decompress node commands, when peer compressed them */
+	if(data != NULL && (r_packet->header.flags & CMP_FLAG)) {
+		data = v_decompress_payload(vconn->peer_cmd_cmpr,
+				data, r_packet->data_size, &data_size);
+		if(data == NULL) {
+			if(is_log_level(VRS_PRINT_WARNING))
+				v_print_log(VRS_PRINT_WARNING, "Unable to decompress payload of packet: %d\n",
+						r_packet->header.payload_id);
+			/* Drop this packet */
+			return RECEIVE_PACKET_CORRUPTED;
+		}
+	}
+
 	/* ADD ACK command to the list of ACK NAK commands */
 	ack_nak_cmd.id = CMD_ACK_ID;
 	ack_nak_cmd.pay_id = r_packet->header.payload_id;
 	v_ack_nak_history_add_cmd(&vconn->ack_nak, &ack_nak_cmd);
 
 	/* Check if there are really node commands */
-	if(r_packet->data!=NULL) {
+	if(data != NULL) {
 		/* Unpack node commands and put them to the queue of incoming commands */
-		v_cmd_unpack((char*)r_packet->data, r_packet->data_size, vsession->in_queue);
+		v_cmd_unpack(data, data_size, vsession->in_queue);
 	}
 
 	return RECEIVE_PACKET_SUCCESS;
@@ -782,7 +821,8 @@ int handle_packet_in_OPEN_state(struct vContext *C)
 	/* Does packet contains node commands? */
 	if(r_packet->header.flags & PAY_FLAG) {
 		ret = handle_node_commands(C);
-		if(ret == RECEIVE_PACKET_UNORDERED)
+		if(ret == RECEIVE_PACKET_UNORDERED ||
+				ret == RECEIVE_PACKET_CORRUPTED)
 			return ret;
 		r_packet->acked=0;
 	}
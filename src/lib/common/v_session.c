@@ -63,6 +63,8 @@ void v_init_session(struct VSession *vsession)
 	vsession->fps_host = DEFAULT_FPS;	/* Default value */
 	vsession->fps_peer = DEFAULT_FPS;	/* Default value */
 	vsession->tmp_flags = 0;
+	vsession->delta_seq = 0;
+	vsession->delta_recv = NULL;
 	vsession->client_name = NULL;
 	vsession->client_version = NULL;
 }
@@ -114,6 +116,9 @@ void v_destroy_session(struct VSession *vsession)
 		free(vsession->host_token.str);
 		vsession->host_token.str = NULL;
 	}
+	if(vsession->delta_recv != NULL) {
+		v_delta_recv_destroy(&vsession->delta_recv);
+	}
 	if(vsession->client_name != NULL) {
 		free(vsession->client_name);
 		vsession->client_name = NULL;
@@ -0,0 +1,415 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+/**
+ * \file	v_slab.c
+ * \brief	Size-classed allocator of small objects
+ *
+ * Commands, buckets of hashed linked lists and items of queues are small
+ * objects, that are allocated and freed many times per second. Free objects
+ * are kept in the cache of each thread and they are allocated without any
+ * lock. Objects are moved between caches of threads and shared depot of each
+ * class in batches. It is common, that object is allocated by one thread
+ * (receiving commands) and it is freed by another thread (handling
+ * commands), then such objects travel through the depot. Memory of chunks is
+ * never returned to the system, it is reused for new objects.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "v_slab.h"
+#include "v_common.h"
+
+/**
+ * Free object linked in the list of free objects
+ */
+typedef struct VSlabObject {
+	struct VSlabObject	*next;
+} VSlabObject;
+
+/**
+ * Chunk of memory split to objects. Header of chunk uses space of the first
+ * object.
+ */
+typedef struct VSlabChunk {
+	struct VSlabChunk	*next;
+} VSlabChunk;
+
+/**
+ * Cache of free objects owned by one thread
+ */
+typedef struct VSlabCache {
+	struct VSlabObject	*first;			/* List of free objects */
+	uint32				count;			/* Number of objects in the list */
+	uint64				alloc_count;	/* Allocations not added to statistics yet */
+	uint64				free_count;		/* Frees not added to statistics yet */
+} VSlabCache;
+
+/**
+ * Shared depot of one size class
+ */
+typedef struct VSlabClass {
+	pthread_mutex_t		mutex;
+	struct VSlabObject	*depot;			/* List of free objects */
+	struct VSlabChunk	*chunks;		/* List of all chunks */
+	uint32				chunk_used;		/* Number of bytes used in the last chunk */
+	struct VSlabStats	stats;
+} VSlabClass;
+
+static struct VSlabClass v_slab_classes[SLAB_CLASS_COUNT];
+
+static __thread struct VSlabCache v_slab_caches[SLAB_CLASS_COUNT];
+static __thread int v_slab_registered = 0;
+
+static pthread_once_t v_slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t v_slab_key;
+
+/**
+ * \brief This function returns index of the smallest class for objects with
+ * size
+ */
+static inline int v_slab_class_index(size_t size)
+{
+	if(size <= SLAB_MIN_SIZE) {
+		return 0;
+	}
+
+	/* Number of bits of (size - 1) gives exponent of next power of 2 and
+	 * SLAB_MIN_SIZE is 2^4 */
+	return (32 - __builtin_clz((uint32)(size - 1))) - 4;
+}
+
+/**
+ * \brief This function adds counters of thread cache to the statistics.
+ * Mutex of class has to be locked.
+ */
+static void v_slab_merge_stats(struct VSlabClass *slab_class,
+		struct VSlabCache *cache)
+{
+	slab_class->stats.alloc_count += cache->alloc_count;
+	slab_class->stats.free_count += cache->free_count;
+	cache->alloc_count = 0;
+	cache->free_count = 0;
+}
+
+/**
+ * \brief This function returns up to count objects from cache of thread to
+ * the shared depot
+ */
+static void v_slab_flush(struct VSlabClass *slab_class,
+		struct VSlabCache *cache,
+		uint32 count)
+{
+	struct VSlabObject *first, *last;
+	uint32 i;
+
+	if(cache->count == 0) {
+		return;
+	}
+
+	/* Find the end of the batch outside the lock */
+	first = last = cache->first;
+	for(i = 1; i < count && last->next != NULL; i++) {
+		last = last->next;
+	}
+	cache->first = last->next;
+	cache->count -= i;
+
+	pthread_mutex_lock(&slab_class->mutex);
+
+	last->next = slab_class->depot;
+	slab_class->depot = first;
+	slab_class->stats.depot_count += i;
+	slab_class->stats.flush_count++;
+	v_slab_merge_stats(slab_class, cache);
+
+	pthread_mutex_unlock(&slab_class->mutex);
+}
+
+/**
+ * \brief This function returns all free objects of exiting thread to the
+ * shared depots
+ */
+static void v_slab_thread_exit(void *arg)
+{
+	struct VSlabCache *caches = (struct VSlabCache*)arg;
+	int i;
+
+	for(i = 0; i < SLAB_CLASS_COUNT; i++) {
+		v_slab_flush(&v_slab_classes[i], &caches[i], caches[i].count);
+		if(caches[i].alloc_count != 0 || caches[i].free_count != 0) {
+			pthread_mutex_lock(&v_slab_classes[i].mutex);
+			v_slab_merge_stats(&v_slab_classes[i], &caches[i]);
+			pthread_mutex_unlock(&v_slab_classes[i].mutex);
+		}
+	}
+}
+
+/**
+ * \brief This function initializes shared depots of all classes
+ */
+static void v_slab_init(void)
+{
+	int i;
+
+	for(i = 0; i < SLAB_CLASS_COUNT; i++) {
+		pthread_mutex_init(&v_slab_classes[i].mutex, NULL);
+		v_slab_classes[i].depot = NULL;
+		v_slab_classes[i].chunks = NULL;
+		v_slab_classes[i].chunk_used = SLAB_CHUNK_SIZE;
+		memset(&v_slab_classes[i].stats, 0, sizeof(struct VSlabStats));
+		v_slab_classes[i].stats.size = SLAB_MIN_SIZE << i;
+	}
+
+	pthread_key_create(&v_slab_key, v_slab_thread_exit);
+}
+
+/**
+ * \brief This function registers cache of current thread, then free objects
+ * are returned to depots, when thread exits
+ */
+static void v_slab_register(void)
+{
+	pthread_once(&v_slab_once, v_slab_init);
+	pthread_setspecific(v_slab_key, v_slab_caches);
+	v_slab_registered = 1;
+}
+
+/**
+ * \brief This function moves batch of objects from the shared depot to the
+ * cache of thread. New chunk is allocated, when the depot is empty.
+ *
+ * \return This function returns 1 on success and 0, when it was not
+ * possible to allocate new chunk.
+ */
+static int v_slab_refill(struct VSlabClass *slab_class,
+		struct VSlabCache *cache)
+{
+	struct VSlabObject *obj;
+	struct VSlabChunk *chunk;
+	uint32 size = slab_class->stats.size, i;
+	int ret = 1;
+
+	pthread_mutex_lock(&slab_class->mutex);
+
+	v_slab_merge_stats(slab_class, cache);
+
+	for(i = 0; i < SLAB_BATCH_SIZE; i++) {
+		if(slab_class->depot != NULL) {
+			obj = slab_class->depot;
+			slab_class->depot = obj->next;
+			slab_class->stats.depot_count--;
+		} else {
+			/* Split the last chunk to new objects */
+			if(slab_class->chunk_used + size > SLAB_CHUNK_SIZE) {
+				if(cache->first != NULL) {
+					/* Don't allocate new chunk, when some object was got */
+					break;
+				}
+				chunk = (struct VSlabChunk*)malloc(SLAB_CHUNK_SIZE);
+				if(chunk == NULL) {
+					v_print_log(VRS_PRINT_ERROR, "Not enough memory for new slab\n");
+					ret = 0;
+					break;
+				}
+				chunk->next = slab_class->chunks;
+				slab_class->chunks = chunk;
+				/* The first object is used for header of chunk */
+				slab_class->chunk_used = size;
+				slab_class->stats.chunk_count++;
+				slab_class->stats.obj_count += SLAB_CHUNK_SIZE/size - 1;
+			}
+			obj = (struct VSlabObject*)((uint8*)slab_class->chunks + slab_class->chunk_used);
+			slab_class->chunk_used += size;
+		}
+		obj->next = cache->first;
+		cache->first = obj;
+		cache->count++;
+	}
+
+	slab_class->stats.refill_count++;
+
+	pthread_mutex_unlock(&slab_class->mutex);
+
+	return ret;
+}
+
+/**
+ * \brief This function allocates memory for object with size. Objects bigger
+ * than SLAB_MAX_SIZE are allocated with malloc().
+ *
+ * \param[in]	size	The size of object
+ *
+ * \return This function returns pointer at new object or NULL, when it was
+ * not possible to allocate memory.
+ */
+void *v_slab_alloc(size_t size)
+{
+	struct VSlabCache *cache;
+	struct VSlabObject *obj;
+	int index;
+
+	if(size > SLAB_MAX_SIZE) {
+		return malloc(size);
+	}
+
+	index = v_slab_class_index(size);
+	cache = &v_slab_caches[index];
+
+	if(cache->first == NULL) {
+		if(v_slab_registered == 0) {
+			v_slab_register();
+		}
+		if(v_slab_refill(&v_slab_classes[index], cache) != 1 &&
+				cache->first == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	obj = cache->first;
+	cache->first = obj->next;
+	cache->count--;
+	cache->alloc_count++;
+
+	return (void*)obj;
+}
+
+/**
+ * \brief This function allocates memory for object with size and it sets
+ * memory to zero.
+ */
+void *v_slab_calloc(size_t size)
+{
+	void *ptr = v_slab_alloc(size);
+
+	if(ptr != NULL) {
+		memset(ptr, 0, size);
+	}
+
+	return ptr;
+}
+
+/**
+ * \brief This function frees object allocated with v_slab_alloc(). Object
+ * could be freed by other thread, than the thread, that allocated it.
+ *
+ * \param[in]	*ptr	The pointer at object (it could be NULL)
+ * \param[in]	size	The size of object used in v_slab_alloc()
+ */
+void v_slab_free(void *ptr, size_t size)
+{
+	struct VSlabCache *cache;
+	struct VSlabObject *obj = (struct VSlabObject*)ptr;
+	int index;
+
+	if(ptr == NULL) {
+		return;
+	}
+
+	if(size > SLAB_MAX_SIZE) {
+		free(ptr);
+		return;
+	}
+
+	if(v_slab_registered == 0) {
+		v_slab_register();
+	}
+
+	index = v_slab_class_index(size);
+	cache = &v_slab_caches[index];
+
+	obj->next = cache->first;
+	cache->first = obj;
+	cache->count++;
+	cache->free_count++;
+
+	if(cache->count > SLAB_CACHE_SIZE) {
+		v_slab_flush(&v_slab_classes[index], cache, SLAB_BATCH_SIZE);
+	}
+}
+
+/**
+ * \brief This function copies statistics of all classes
+ *
+ * \param[out]	stats	The array of statistics indexed by class
+ */
+void v_slab_get_stats(struct VSlabStats stats[SLAB_CLASS_COUNT])
+{
+	int i;
+
+	pthread_once(&v_slab_once, v_slab_init);
+
+	for(i = 0; i < SLAB_CLASS_COUNT; i++) {
+		pthread_mutex_lock(&v_slab_classes[i].mutex);
+		/* Counters of current thread are added to be up to date */
+		v_slab_merge_stats(&v_slab_classes[i], &v_slab_caches[i]);
+		stats[i] = v_slab_classes[i].stats;
+		pthread_mutex_unlock(&v_slab_classes[i].mutex);
+	}
+}
+
+/**
+ * \brief This function prints statistics of all classes
+ */
+void v_slab_print_stats(const unsigned char level)
+{
+	struct VSlabStats stats[SLAB_CLASS_COUNT];
+	int i;
+
+	if(!is_log_level(level)) {
+		return;
+	}
+
+	v_slab_get_stats(stats);
+
+	for(i = 0; i < SLAB_CLASS_COUNT; i++) {
+		if(stats[i].chunk_count == 0) {
+			continue;
+		}
+		v_print_log(level,
+				"Slab %u B: chunks: %u, objects: %llu, free in depot: %llu, allocated: %llu, freed: %llu, refills: %llu, flushes: %llu\n",
+				stats[i].size,
+				stats[i].chunk_count,
+				(unsigned long long)stats[i].obj_count,
+				(unsigned long long)stats[i].depot_count,
+				(unsigned long long)stats[i].alloc_count,
+				(unsigned long long)stats[i].free_count,
+				(unsigned long long)stats[i].refill_count,
+				(unsigned long long)stats[i].flush_count);
+	}
+}
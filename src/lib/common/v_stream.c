@@ -132,12 +132,11 @@ int v_STREAM_pack_message(struct vContext *C)
 	struct VStreamConn *conn = CTX_current_stream_conn(C);
 	struct IO_CTX *io_ctx = CTX_io_ctx(C);
 	struct VMessage *s_message = CTX_s_message(C);
+	struct VOutQueueSched sched;
+	struct VOutQueueBatch batch;
 	struct Generic_Cmd *cmd, *fake_cmd;
-	int ret = -1, queue_size = 0, buffer_pos = 0, prio_cmd_count, cmd_rank=0;
-	int8 cmd_share;
-	int16 prio, max_prio, min_prio;
-	uint16 cmd_count, cmd_len, prio_win, swin, sent_size, tot_cmd_size;
-	real32 prio_sum_high, prio_sum_low, r_prio;
+	int ret = -1, queue_size = 0, buffer_pos = 0, swin, cmd_rank=0;
+	uint16 i;
 	int is_fake_cmd_received = 0;
 
 	/* Is here something to send? */
@@ -179,93 +178,56 @@ int v_STREAM_pack_message(struct vContext *C)
 
 		buffer_pos += v_pack_stream_system_commands(s_message, &io_ctx->buf[buffer_pos]);
 
-		max_prio = v_out_queue_get_max_prio(vsession->out_queue);
-		min_prio = v_out_queue_get_min_prio(vsession->out_queue);
-
-		prio_sum_high = v_out_queue_get_prio_sum_high(vsession->out_queue);
-		prio_sum_low = v_out_queue_get_prio_sum_low(vsession->out_queue);
-
 		v_print_log(VRS_PRINT_DEBUG_MSG, "Packing prio queues, cmd count: %d\n",
 				v_out_queue_get_count(vsession->out_queue));
 
-		/* Go through all priorities and pick commands from priority queues */
-		for(prio = max_prio; prio >= min_prio; prio--)
-		{
-			prio_cmd_count = v_out_queue_get_count_prio(vsession->out_queue, prio);
-
-			if(prio_cmd_count > 0) {
-
-				r_prio = v_out_queue_get_prio(vsession->out_queue, prio);
-
-				/* Compute size of buffer that could be occupied by
-				 * commands from this queue */
-				if(prio >= VRS_DEFAULT_PRIORITY) {
-					prio_win = ((swin - buffer_pos)*r_prio)/prio_sum_high;
-				} else {
-					prio_win = ((swin - buffer_pos)*r_prio)/prio_sum_low;
-				}
-
-				/* Debug print */
-				v_print_log(VRS_PRINT_DEBUG_MSG, "Queue: %d, count: %d, r_prio: %6.3f, prio_win: %d\n",
-						prio, prio_cmd_count, r_prio, prio_win);
-
-				/* Get total size of commands that were stored in queue (sent_size) */
-				sent_size = 0;
-				tot_cmd_size = 0;
-
-				while(prio_cmd_count > 0) {
-					cmd_share = 0;
-					cmd_count = 0;
-					cmd_len = prio_win - sent_size;
-
-					/* Pack commands from queues with high priority to the buffer */
-					cmd = v_out_queue_pop(vsession->out_queue, prio, &cmd_count, &cmd_share, &cmd_len);
-					if(cmd != NULL) {
-
-						/* Is this command fake command? */
-						if(cmd->id < MIN_CMD_ID) {
-							if(cmd->id == FAKE_CMD_CONNECT_TERMINATE) {
-								/* Close connection */
-								struct VS_CTX *vs_ctx = CTX_server_ctx(C);
-								if(vs_ctx != NULL) {
-									vsession->stream_conn->host_state = TCP_SERVER_STATE_CLOSING;
-								} else {
-									vsession->stream_conn->host_state = TCP_CLIENT_STATE_CLOSING;
-								}
-							} else if(cmd->id == FAKE_CMD_FPS) {
-								struct Fps_Cmd *fps_cmd = (struct Fps_Cmd*)cmd;
-								/* Change value of FPS. It will be sent in negotiate command
-								 * until it is confirmed be the peer (server) */
-								vsession->fps_host = fps_cmd->fps;
-							}
+		/* Commands are not compressed, when TCP is used */
+		v_out_queue_sched_init(&sched, vsession->out_queue,
+				(swin > buffer_pos) ? (uint32)(swin - buffer_pos) : 0,
+				CMPR_NONE);
+
+		/* Pick commands chosen by scheduler of priority queues */
+		while(v_out_queue_sched_pop(&sched, MAX_PACKET_SIZE - buffer_pos, &batch) > 0) {
+			for(i = 0; i < batch.count; i++) {
+				cmd = batch.cmds[i];
+
+				/* Is this command fake command? */
+				if(cmd->id < MIN_CMD_ID) {
+					if(cmd->id == FAKE_CMD_CONNECT_TERMINATE) {
+						/* Close connection */
+						if(vs_ctx != NULL) {
+							vsession->stream_conn->host_state = TCP_SERVER_STATE_CLOSING;
 						} else {
-							buffer_pos += tot_cmd_size = v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, v_cmd_size(cmd), 0);
-							if(is_log_level(VRS_PRINT_DEBUG_MSG)) {
-								printf("%c[%d;%dm", 27, 1, 32);
-								v_cmd_print(VRS_PRINT_DEBUG_MSG, cmd);
-								printf("%c[%dm", 27, 0);
-							}
-							sent_size += tot_cmd_size;
+							vsession->stream_conn->host_state = TCP_CLIENT_STATE_CLOSING;
 						}
+					} else if(cmd->id == FAKE_CMD_FPS) {
+						struct Fps_Cmd *fps_cmd = (struct Fps_Cmd*)cmd;
+						/* Change value of FPS. It will be sent in negotiate command
+						 * until it is confirmed be the peer (server) */
+						vsession->fps_host = fps_cmd->fps;
+					}
+				} else {
+					buffer_pos += v_cmd_pack(&io_ctx->buf[buffer_pos], cmd, v_cmd_size(cmd), 0);
+					if(is_log_level(VRS_PRINT_DEBUG_MSG)) {
+						printf("%c[%d;%dm", 27, 1, 32);
+						v_cmd_print(VRS_PRINT_DEBUG_MSG, cmd);
+						printf("%c[%dm", 27, 0);
+					}
+				}
 
-						fake_cmd = v_cmd_fake_ack(cmd);
-
-						if(fake_cmd != NULL) {
-							is_fake_cmd_received = 1;
-							/* Push command to the queue of incoming commands */
-							v_in_queue_push(vsession->in_queue, fake_cmd);
-							/* Print content of fake command */
-							v_fake_cmd_print(VRS_PRINT_DEBUG_MSG, fake_cmd);
-						}
+				fake_cmd = v_cmd_fake_ack(cmd);
 
-						/* It is not necessary to put cmd to history of sent commands,
-						 * when TCP is used. */
-						v_cmd_destroy(&cmd);
-						prio_cmd_count--;
-					} else {
-						break;
-					}
+				if(fake_cmd != NULL) {
+					is_fake_cmd_received = 1;
+					/* Push command to the queue of incoming commands */
+					v_in_queue_push(vsession->in_queue, fake_cmd);
+					/* Print content of fake command */
+					v_fake_cmd_print(VRS_PRINT_DEBUG_MSG, fake_cmd);
 				}
+
+				/* It is not necessary to put cmd to history of sent commands,
+				 * when TCP is used. */
+				v_cmd_destroy(&cmd);
 			}
 		}
 
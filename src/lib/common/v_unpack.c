@@ -32,9 +32,11 @@
  */
 
 #include "verse_types.h"
+#include "v_pack.h"
 #include "v_unpack.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 /* Following functions are used for unpacking basic data types from
  * received packet. All multi-byte quantities are transmitted in network
@@ -110,6 +112,54 @@ size_t vnp_raw_unpack_real64(const void *buffer, real64 *data)
 	return size;
 }
 
+/**
+ * \brief Unpack array of two bytes values (uint16, int16, real16) from buffer
+ */
+size_t vnp_raw_unpack_uint16_array(const void *buffer, void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(data, buffer, sizeof(uint16), count);
+	uint16 value;
+
+	for(; i < count; i++) {
+		vnp_raw_unpack_uint16((const uint8 *)buffer + i*sizeof(value), &value);
+		memcpy((uint8 *)data + i*sizeof(value), &value, sizeof(value));
+	}
+
+	return count*sizeof(value);
+}
+
+/**
+ * \brief Unpack array of four bytes values (uint32, int32, real32) from buffer
+ */
+size_t vnp_raw_unpack_uint32_array(const void *buffer, void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(data, buffer, sizeof(uint32), count);
+	uint32 value;
+
+	for(; i < count; i++) {
+		vnp_raw_unpack_uint32((const uint8 *)buffer + i*sizeof(value), &value);
+		memcpy((uint8 *)data + i*sizeof(value), &value, sizeof(value));
+	}
+
+	return count*sizeof(value);
+}
+
+/**
+ * \brief Unpack array of eight bytes values (uint64, int64, real64) from buffer
+ */
+size_t vnp_raw_unpack_uint64_array(const void *buffer, void *data, const size_t count)
+{
+	size_t i = vnp_raw_swap_array(data, buffer, sizeof(uint64), count);
+	uint64 value;
+
+	for(; i < count; i++) {
+		vnp_raw_unpack_uint64((const uint8 *)buffer + i*sizeof(value), &value);
+		memcpy((uint8 *)data + i*sizeof(value), &value, sizeof(value));
+	}
+
+	return count*sizeof(value);
+}
+
 /**
  * \brief		Unpack string8 from the buffer
  * \details		This function check if it is possible to unpack string8 from the buffer,
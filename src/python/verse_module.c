@@ -492,13 +492,14 @@ static void cb_c_receive_layer_unsubscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
-		result = PyObject_CallMethod((PyObject*)session, "cb_receive_layer_unsubscribe", "(IHII)",
-				node_id, layer_id, version, crc32);
+		result = PyObject_CallMethod((PyObject*)session, "cb_receive_layer_unsubscribe", "(IHIII)",
+				node_id, layer_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -545,13 +546,14 @@ static void cb_c_receive_layer_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t layer_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
-		result = PyObject_CallMethod((PyObject*)session, "cb_receive_layer_subscribe", "(IHII)",
-				node_id, layer_id, version, crc32);
+		result = PyObject_CallMethod((PyObject*)session, "cb_receive_layer_subscribe", "(IHIII)",
+				node_id, layer_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -567,17 +569,18 @@ static PyObject *Session_send_layer_subscribe(PyObject *self, PyObject *args, Py
 	uint16_t layer_id;
 	uint32_t version;
 	uint32_t crc32;
+	uint32_t epoch = 0;
 	int ret;
-	static char *kwlist[] = {"prio", "node_id", "layer_id", "version", "crc32", NULL};
+	static char *kwlist[] = {"prio", "node_id", "layer_id", "version", "crc32", "epoch", NULL};
 
 	/* Parse arguments */
-	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIHII", kwlist,
-			&prio, &node_id, &layer_id, &version, &crc32)) {
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIHIII", kwlist,
+			&prio, &node_id, &layer_id, &version, &crc32, &epoch)) {
 		return NULL;
 	}
 
 	/* Call C API function */
-	ret = vrs_send_layer_subscribe(session->session_id, prio, node_id, layer_id, version, crc32);
+	ret = vrs_send_layer_subscribe(session->session_id, prio, node_id, layer_id, version, crc32, epoch);
 
 	/* Check if calling function was successful */
 	if(ret != VRS_SUCCESS) {
@@ -1229,14 +1232,15 @@ static void cb_c_receive_taggroup_unsubscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
 		result = PyObject_CallMethod((PyObject*)session,
-				"cb_receive_taggroup_unsubscribe", "(IHII)",
-				node_id, taggroup_id, version, crc32);
+				"cb_receive_taggroup_unsubscribe", "(IHIII)",
+				node_id, taggroup_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -1283,14 +1287,15 @@ static void cb_c_receive_taggroup_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint16_t taggroup_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
 		result = PyObject_CallMethod((PyObject*)session,
-				"cb_receive_taggroup_subscribe", "(IHII)",
-				node_id, taggroup_id, version, crc32);
+				"cb_receive_taggroup_subscribe", "(IHIII)",
+				node_id, taggroup_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -1306,17 +1311,18 @@ static PyObject *Session_send_taggroup_subscribe(PyObject *self, PyObject *args,
 	uint16_t taggroup_id;
 	uint32_t version;
 	uint32_t crc32;
+	uint32_t epoch = 0;
 	int ret;
-	static char *kwlist[] = {"prio", "node_id", "taggroup_id", "version", "crc32", NULL};
+	static char *kwlist[] = {"prio", "node_id", "taggroup_id", "version", "crc32", "epoch", NULL};
 
 	/* Parse arguments */
-	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIHII", kwlist,
-			&prio, &node_id, &taggroup_id, &version, &crc32)) {
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIHIII", kwlist,
+			&prio, &node_id, &taggroup_id, &version, &crc32, &epoch)) {
 		return NULL;
 	}
 
 	/* Call C API function */
-	ret = vrs_send_taggroup_subscribe(session->session_id, prio, node_id, taggroup_id, version, crc32);
+	ret = vrs_send_taggroup_subscribe(session->session_id, prio, node_id, taggroup_id, version, crc32, epoch);
 
 	/* Check if calling function was successful */
 	if(ret != VRS_SUCCESS) {
@@ -1723,14 +1729,15 @@ static PyObject *Session_cb_receive_node_unsubscribe(PyObject *self, PyObject *a
 static void cb_c_receive_node_unsubscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
 		result = PyObject_CallMethod((PyObject*)session,
-				"cb_receive_node_unsubscribe", "(III)",
-				node_id, version, crc32);
+				"cb_receive_node_unsubscribe", "(IIII)",
+				node_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -1775,14 +1782,15 @@ static PyObject *Session_cb_receive_node_subscribe(PyObject *self, PyObject *arg
 static void cb_c_receive_node_subscribe(const uint8_t session_id,
 		const uint32_t node_id,
 		const uint32_t version,
-		const uint32_t crc32)
+		const uint32_t crc32,
+		const uint32_t epoch)
 {
 	session_SessionObject *session = session_list[session_id];
 	if(session != NULL) {
 		PyObject *result = NULL;
 		result = PyObject_CallMethod((PyObject*)session,
-				"cb_receive_node_subscribe", "(III)",
-				node_id, version, crc32);
+				"cb_receive_node_subscribe", "(IIII)",
+				node_id, version, crc32, epoch);
 		if(result == NULL || PyErr_Occurred() != NULL) {
 			PyErr_Print();
 		}
@@ -1797,17 +1805,18 @@ static PyObject *Session_send_node_subscribe(PyObject *self, PyObject *args, PyO
 	uint32_t node_id;
 	uint32_t version;
 	uint32_t crc32;
+	uint32_t epoch = 0;
 	int ret;
-	static char *kwlist[] = {"prio", "node_id", "version", "crc32", NULL};
+	static char *kwlist[] = {"prio", "node_id", "version", "crc32", "epoch", NULL};
 
 	/* Parse arguments */
-	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIII", kwlist,
-			&prio, &node_id, &version, &crc32)) {
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|BIIII", kwlist,
+			&prio, &node_id, &version, &crc32, &epoch)) {
 		return NULL;
 	}
 
 	/* Call C API function */
-	ret = vrs_send_node_subscribe(session->session_id, prio, node_id, version, crc32);
+	ret = vrs_send_node_subscribe(session->session_id, prio, node_id, version, crc32, epoch);
 
 	/* Check if calling function was successful */
 	if(ret != VRS_SUCCESS) {
@@ -2868,6 +2877,8 @@ void initverse(void)
 	PyModule_AddIntConstant(module, "TP_TCP", VRS_TP_TCP);
 	PyModule_AddIntConstant(module, "CMD_CMPR_NONE", VRS_CMD_CMPR_NONE);
 	PyModule_AddIntConstant(module, "CMD_CMPR_ADDR_SHARE", VRS_CMD_CMPR_ADDR_SHARE);
+	PyModule_AddIntConstant(module, "CMD_CMPR_DEFLATE", VRS_CMD_CMPR_DEFLATE);
+	PyModule_AddIntConstant(module, "VALUE_DELTA", VRS_VALUE_DELTA);
 
 	/* Error constant used, when connection with server is closed */
 	PyModule_AddIntConstant(module, "CONN_TERM_HOST_UNKNOWN", VRS_CONN_TERM_HOST_UNKNOWN);
@@ -25,6 +25,7 @@
 #define MONGO_HAVE_STDINT 1
 
 #include <mongo.h>
+#include <string.h>
 
 #include "vs_main.h"
 #include "vs_mongo_main.h"
@@ -45,8 +46,8 @@ static void vs_mongo_layer_save_version(struct VSLayer *layer,
 		uint32 version)
 {
 	bson bson_version;
-	VSLayerValue *layer_value;
-	VBucket *bucket;
+	void *layer_value;
+	uint32 i;
 	char str_num[15];
 	int data_id;
 
@@ -55,34 +56,33 @@ static void vs_mongo_layer_save_version(struct VSLayer *layer,
 	bson_append_int(&bson_version, "crc32", layer->crc32);
 
 	bson_append_start_object(&bson_version, "values");
-	bucket = layer->values.lb.first;
-	while(bucket != NULL) {
-		layer_value = (struct VSLayerValue*)bucket->data;
-		sprintf(str_num, "%d", layer_value->id);
+	for(i = 0; i < layer->values.count; i++) {
+		layer_value = vs_layer_values_at(&layer->values, i);
+		sprintf(str_num, "%u", layer->values.ids[i]);
 		bson_append_start_array(&bson_version, str_num);
 		switch(layer->data_type) {
 		case VRS_VALUE_TYPE_UINT8:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_int(&bson_version, str_num, ((uint8*)layer_value->value)[data_id]);
+				bson_append_int(&bson_version, str_num, ((uint8*)layer_value)[data_id]);
 			}
 			break;
 		case VRS_VALUE_TYPE_UINT16:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_int(&bson_version, str_num, ((uint16*)layer_value->value)[data_id]);
+				bson_append_int(&bson_version, str_num, ((uint16*)layer_value)[data_id]);
 			}
 			break;
 		case VRS_VALUE_TYPE_UINT32:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_int(&bson_version, str_num, ((uint32*)layer_value->value)[data_id]);
+				bson_append_int(&bson_version, str_num, ((uint32*)layer_value)[data_id]);
 			}
 			break;
 		case VRS_VALUE_TYPE_UINT64:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_int(&bson_version, str_num, ((uint64*)layer_value->value)[data_id]);
+				bson_append_int(&bson_version, str_num, ((uint64*)layer_value)[data_id]);
 			}
 			break;
 		case VRS_VALUE_TYPE_REAL16:
@@ -91,19 +91,17 @@ static void vs_mongo_layer_save_version(struct VSLayer *layer,
 		case VRS_VALUE_TYPE_REAL32:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_double(&bson_version, str_num, ((float*)layer_value->value)[data_id]);
+				bson_append_double(&bson_version, str_num, ((float*)layer_value)[data_id]);
 			}
 			break;
 		case VRS_VALUE_TYPE_REAL64:
 			for(data_id = 0; data_id < layer->num_vec_comp; data_id++) {
 				sprintf(str_num, "%d", data_id);
-				bson_append_double(&bson_version, str_num, ((double*)layer_value->value)[data_id]);
+				bson_append_double(&bson_version, str_num, ((double*)layer_value)[data_id]);
 			}
 			break;
 		}
 		bson_append_finish_array(&bson_version);
-
-		bucket = bucket->next;
 	}
 	bson_append_finish_object(&bson_version);
 
@@ -114,137 +112,120 @@ static void vs_mongo_layer_save_version(struct VSLayer *layer,
 }
 
 /**
- * \brief This function tries to update layer stored in MongoDB
+ * \brief This function creates update of layer stored in MongoDB
  */
-int vs_mongo_layer_update(struct VS_CTX *vs_ctx,
-		struct VSNode *node,
-		struct VSLayer *layer)
+static void vs_mongo_layer_update(struct VSNode *node,
+		struct VSLayer *layer,
+		bson *cond,
+		bson *op)
 {
-	bson cond, op;
 	bson bson_version;
-	int ret;
 
 	/* TODO: delete old version, when there is too much versions:
 	int old_saved_version = layer->saved_version;
 	*/
 
-	bson_init(&cond);
+	bson_init(cond);
 	{
-		bson_append_oid(&cond, "_id", &layer->oid);
+		bson_append_oid(cond, "_id", &layer->oid);
 		/* To be sure that right layer will be updated */
-		bson_append_int(&cond, "node_id", node->id);
-		bson_append_int(&cond, "layer_id", layer->id);
+		bson_append_int(cond, "node_id", node->id);
+		bson_append_int(cond, "layer_id", layer->id);
 	}
-	bson_finish(&cond);
+	bson_finish(cond);
 
-	bson_init(&op);
+	bson_init(op);
 	{
 		/* Update item current_version in document */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
-			bson_append_int(&op, "current_version", layer->version);
+			bson_append_int(op, "current_version", layer->version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 		/* Create new bson object representing current version and add it to
 		 * the object versions */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
 			bson_init(&bson_version);
 			{
 				vs_mongo_layer_save_version(layer, &bson_version, UINT32_MAX);
 			}
 			bson_finish(&bson_version);
-			bson_append_bson(&op, "versions", &bson_version);
+			bson_append_bson(op, "versions", &bson_version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 	}
-	bson_finish(&op);
-
-	ret = mongo_update(vs_ctx->mongo_conn, vs_ctx->mongo_layer_ns, &cond, &op,
-			MONGO_UPDATE_BASIC, 0);
+	bson_finish(op);
 
 	bson_destroy(&bson_version);
-	bson_destroy(&cond);
-	bson_destroy(&op);
-
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to update layer %d to MongoDB: %s, error: %s\n",
-				layer->id, vs_ctx->mongo_layer_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
-
-	return 1;
 }
 
 /**
- * \brief This function tries to save new layer to MongoDB
+ * \brief This function creates new document of layer
  */
-int vs_mongo_layer_add_new(struct VS_CTX *vs_ctx,
-		struct VSNode *node,
-		struct VSLayer *layer)
+static void vs_mongo_layer_add_new(struct VSNode *node,
+		struct VSLayer *layer,
+		bson *bson_layer)
 {
-	bson bson_layer;
-	int ret;
-
-	bson_init(&bson_layer);
+	bson_init(bson_layer);
 
 	bson_oid_gen(&layer->oid);
-	bson_append_oid(&bson_layer, "_id", &layer->oid);
-	bson_append_int(&bson_layer, "node_id", node->id);
-	bson_append_int(&bson_layer, "layer_id", layer->id);
-	bson_append_int(&bson_layer, "custom_type", layer->custom_type);
-	bson_append_int(&bson_layer, "data_type", layer->data_type);
-	bson_append_int(&bson_layer, "vec_size", layer->num_vec_comp);
-	bson_append_int(&bson_layer, "current_version", layer->version);
+	bson_append_oid(bson_layer, "_id", &layer->oid);
+	bson_append_int(bson_layer, "node_id", node->id);
+	bson_append_int(bson_layer, "layer_id", layer->id);
+	bson_append_int(bson_layer, "custom_type", layer->custom_type);
+	bson_append_int(bson_layer, "data_type", layer->data_type);
+	bson_append_int(bson_layer, "vec_size", layer->num_vec_comp);
+	bson_append_int(bson_layer, "current_version", layer->version);
 
 	if(layer->parent != NULL) {
-		bson_append_int(&bson_layer, "parent_layer_id", layer->parent->id);
+		bson_append_int(bson_layer, "parent_layer_id", layer->parent->id);
 	}
 
-	bson_append_start_object(&bson_layer, "versions");
-	vs_mongo_layer_save_version(layer, &bson_layer, UINT32_MAX);
-	bson_append_finish_object(&bson_layer);
-
-	bson_finish(&bson_layer);
-
-	ret = mongo_insert(vs_ctx->mongo_conn, vs_ctx->mongo_layer_ns, &bson_layer, NULL);
-	bson_destroy(&bson_layer);
+	bson_append_start_object(bson_layer, "versions");
+	vs_mongo_layer_save_version(layer, bson_layer, UINT32_MAX);
+	bson_append_finish_object(bson_layer);
 
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to write layer %d of node %d to MongoDB: %s, error: %s\n",
-				layer->id, node->id, vs_ctx->mongo_layer_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
-
-	return 1;
+	bson_finish(bson_layer);
 }
 
 /**
- * \brief This function tries to save layer into the MongoDB
+ * \brief This function adds snapshot of changed layer to the batch. Layer is
+ * marked as saved and the batch is written to MongoDB later.
+ *
+ * Caller has to hold write lock of data.
+ *
+ * \return This function returns 1, when snapshot of layer was added to the
+ * batch. Otherwise it returns 0.
  */
-int vs_mongo_layer_save(struct VS_CTX *vs_ctx,
+int vs_mongo_layer_snapshot(struct VSMongoSaveBatch *batch,
 		struct VSNode *node,
 		struct VSLayer *layer)
 {
-	int ret = 1;
+	struct VSMongoSaveItem *item;
 
-	if((int)layer->saved_version == -1) {
+	if(layer->saved_version == layer->version) {
+		return 0;
+	}
+
+	item = vs_mongo_save_item_add(batch, MONGO_SAVE_LAYER, node->id,
+			layer->id, layer->saved_version,
+			((int)layer->saved_version == -1) ? 1 : 0);
+	if(item == NULL) {
+		return 0;
+	}
+
+	if(item->insert == 1) {
 		/* Save new layer to MongoDB */
-		ret = vs_mongo_layer_add_new(vs_ctx, node, layer);
+		vs_mongo_layer_add_new(node, layer, &item->doc);
 	} else {
 		/* Update item in database */
-		ret = vs_mongo_layer_update(vs_ctx, node, layer);
+		vs_mongo_layer_update(node, layer, &item->cond, &item->doc);
 	}
 
-	if(ret == 1) {
-		layer->saved_version = layer->version;
-	}
+	layer->saved_version = layer->version;
 
-	return ret;
+	return 1;
 }
 
 /**
@@ -261,7 +242,7 @@ static void vs_mongo_layer_load_data(struct VSNode *node,
 
 	/* Try to get values of layer */
 	if( bson_find(&version_data_iter, bson_version, "values") == BSON_OBJECT ) {
-		struct VSLayerValue *item;
+		uint64 value[4];
 		bson_iterator items_iter, values_iter;
 		const char *key;
 		uint8 val_uint8;
@@ -271,7 +252,6 @@ static void vs_mongo_layer_load_data(struct VSNode *node,
 		real32 val_real32;
 		real64 val_real64;
 		uint32 item_id;
-		int item_data_size = vs_layer_data_size(layer);
 		int value_id;
 
 		bson_iterator_subiterator(&version_data_iter, &items_iter);
@@ -282,9 +262,7 @@ static void vs_mongo_layer_load_data(struct VSNode *node,
 
 			bson_iterator_subiterator(&items_iter, &values_iter);
 
-			item = (struct VSLayerValue*)calloc(1, sizeof(struct VSLayerValue));
-			item->id = item_id;
-			item->value = (void*)calloc(layer->num_vec_comp, item_data_size);
+			memset(value, 0, sizeof(value));
 
 			value_id = 0;
 
@@ -294,27 +272,27 @@ static void vs_mongo_layer_load_data(struct VSNode *node,
 				switch(layer->data_type) {
 				case VRS_VALUE_TYPE_UINT8:
 					val_uint8 = (uint8)bson_iterator_int(&values_iter);
-					((uint8*)item->value)[value_id] = val_uint8;
+					((uint8*)value)[value_id] = val_uint8;
 					break;
 				case VRS_VALUE_TYPE_UINT16:
 					val_uint16 = (uint16)bson_iterator_int(&values_iter);
-					((uint16*)item->value)[value_id] = val_uint16;
+					((uint16*)value)[value_id] = val_uint16;
 					break;
 				case VRS_VALUE_TYPE_UINT32:
 					val_uint32 = (uint32)bson_iterator_int(&values_iter);
-					((uint32*)item->value)[value_id] = val_uint32;
+					((uint32*)value)[value_id] = val_uint32;
 					break;
 				case VRS_VALUE_TYPE_UINT64:
 					val_uint64 = (uint64)bson_iterator_long(&values_iter);
-					((uint64*)item->value)[value_id] = val_uint64;
+					((uint64*)value)[value_id] = val_uint64;
 					break;
 				case VRS_VALUE_TYPE_REAL32:
 					val_real32 = (real32)bson_iterator_double(&values_iter);
-					((real32*)item->value)[value_id] = val_real32;
+					((real32*)value)[value_id] = val_real32;
 					break;
 				case VRS_VALUE_TYPE_REAL64:
 					val_real64 = (real64)bson_iterator_double(&values_iter);
-					((real64*)item->value)[value_id] = val_real64;
+					((real64*)value)[value_id] = val_real64;
 					break;
 				default:
 					break;
@@ -322,7 +300,7 @@ static void vs_mongo_layer_load_data(struct VSNode *node,
 				value_id++;
 			}
 
-			v_hash_array_add_item(&layer->values, item, sizeof(struct VSLayerValue));
+			vs_layer_values_set(&layer->values, item_id, value);
 		}
 	}
 }
@@ -442,6 +420,10 @@ struct VSLayer *vs_mongo_layer_load_linked(struct VS_CTX *vs_ctx,
 
 						/* Try to load data of layer */
 						vs_mongo_layer_load_data(node, layer, &bson_version);
+
+						/* Changes before loaded version are not known */
+						vs_journal_reset(&layer->journal, layer->version,
+								vs_journal_new_epoch());
 					}
 				}
 			}
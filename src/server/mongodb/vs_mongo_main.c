@@ -25,44 +25,608 @@
 #define MONGO_HAVE_STDINT 1
 #include <mongo.h>
 #include <bson.h>
-#include <bcon.h>
 
 #include <unistd.h>
+#include <string.h>
 #include <stdint.h>
+#include <time.h>
 
 #include "vs_main.h"
+#include "vs_data.h"
 #include "vs_mongo_main.h"
 #include "vs_mongo_node.h"
 #include "vs_node.h"
+#include "vs_link.h"
+#include "vs_taggroup.h"
+#include "vs_layer.h"
 #include "vs_sys_nodes.h"
 
 #include "v_common.h"
 
 
 /**
- * \brief This function save current server context to Mongo database
+ * \brief This function adds node to the end of queue. Ring buffer of queue
+ * is enlarged, when it is full.
  *
- * \param[in] *session	The pointer at verse
+ * \return This function returns 1, when node was added to the queue.
+ * Otherwise it returns 0.
+ */
+static int vs_mongo_queue_push(struct VSMongoQueue *queue,
+		uint32 node_id,
+		time_t time)
+{
+	struct VSMongoQueueItem *items, *item;
+	uint32 length, i;
+
+	if(queue->count == queue->length) {
+		length = (queue->length == 0) ? MONGO_QUEUE_MIN_LENGTH : 2 * queue->length;
+		items = (struct VSMongoQueueItem*)malloc(length * sizeof(struct VSMongoQueueItem));
+		if(items == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+			return 0;
+		}
+		for(i = 0; i < queue->count; i++) {
+			items[i] = queue->items[(queue->first + i) % queue->length];
+		}
+		if(queue->items != NULL) {
+			free(queue->items);
+		}
+		queue->items = items;
+		queue->first = 0;
+		queue->length = length;
+	}
+
+	item = &queue->items[(queue->first + queue->count) % queue->length];
+	item->node_id = node_id;
+	item->time = time;
+	queue->count++;
+
+	return 1;
+}
+
+/**
+ * \brief This function removes the oldest node from the queue
  *
- * \return This function returns 1, when context was save. Otherwise it
- * returns 0
+ * \return This function returns 1, when some node was removed. It returns 0,
+ * when queue is empty.
  */
-int vs_mongo_context_save(struct VS_CTX *vs_ctx)
+static int vs_mongo_queue_pop(struct VSMongoQueue *queue,
+		struct VSMongoQueueItem *item)
 {
-	struct VSNode *node;
+	if(queue->count == 0) {
+		return 0;
+	}
+
+	*item = queue->items[queue->first];
+	queue->first = (queue->first + 1) % queue->length;
+	queue->count--;
+
+	return 1;
+}
+
+/**
+ * \brief This function frees ring buffer of queue
+ */
+static void vs_mongo_queue_destroy(struct VSMongoQueue *queue)
+{
+	if(queue->items != NULL) {
+		free(queue->items);
+		queue->items = NULL;
+	}
+	queue->first = queue->count = queue->length = 0;
+}
+
+/**
+ * \brief This function adds changed node to the queue of nodes, that will be
+ * saved to MongoDB. It has to be called, when version of node, its tag group
+ * or layer was increased. Node is added to the queue only once, until it
+ * is saved.
+ *
+ * Caller has to hold read lock of data at least.
+ */
+void vs_mongo_node_dirty(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	if(vs_ctx->mongo_conn == NULL || !(node->flags & VS_NODE_SAVEABLE)) {
+		return;
+	}
+
+	pthread_mutex_lock(&vs_ctx->mongo_queue_mutex);
+	if(!(node->flags & VS_NODE_DIRTY) &&
+			vs_mongo_queue_push(&vs_ctx->mongo_dirty, node->id, time(NULL)) == 1)
+	{
+		node->flags |= VS_NODE_DIRTY;
+	}
+	pthread_mutex_unlock(&vs_ctx->mongo_queue_mutex);
+}
+
+/**
+ * \brief This function adds node and all its child nodes, that were not saved
+ * yet, to the queue of changed nodes.
+ *
+ * Caller has to hold write lock of data.
+ */
+void vs_mongo_branch_dirty(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	struct VSLink *link;
+
+	if(node->saved_version != node->version) {
+		vs_mongo_node_dirty(vs_ctx, node);
+	}
+
+	link = node->children_links.first;
+	while(link != NULL) {
+		vs_mongo_branch_dirty(vs_ctx, link->child);
+		link = link->next;
+	}
+}
+
+/**
+ * \brief This function adds node with data in memory to the queue of nodes,
+ * that could be evicted from memory, when nobody uses them. Nodes are queued
+ * in order of node->idle_since.
+ *
+ * Caller has to hold read lock of data at least.
+ */
+void vs_mongo_node_evictable(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	if(vs_ctx->mongo_conn == NULL || !(node->flags & VS_NODE_SAVEABLE)) {
+		return;
+	}
+
+	pthread_mutex_lock(&vs_ctx->mongo_queue_mutex);
+	if(!(node->flags & VS_NODE_IDLE_QUEUED) &&
+			vs_mongo_queue_push(&vs_ctx->mongo_idle, node->id, node->idle_since) == 1)
+	{
+		node->flags |= VS_NODE_IDLE_QUEUED;
+	}
+	pthread_mutex_unlock(&vs_ctx->mongo_queue_mutex);
+}
+
+/**
+ * \brief This function finds node without loading of its data from MongoDB
+ */
+static struct VSNode *vs_mongo_node_lookup(struct VS_CTX *vs_ctx,
+		uint32 node_id)
+{
+	struct VSNode find_node;
 	struct VBucket *bucket;
 
-	/* Go through all nodes and save changed node to the database */
-	bucket = vs_ctx->data.nodes.lb.first;
-	while(bucket != NULL) {
-		node = (struct VSNode*)bucket->data;
-		if(vs_mongo_node_save(vs_ctx, node) == 0) {
+	find_node.id = node_id;
+	bucket = v_hash_array_find_item(&vs_ctx->data.nodes, &find_node);
+
+	return (bucket != NULL) ? (struct VSNode*)bucket->data : NULL;
+}
+
+/**
+ * \brief This function adds new item to the batch of snapshots. Caller has to
+ * initialize documents of new item.
+ *
+ * \return This function returns pointer at new item or NULL, when it wasn't
+ * possible to allocate memory for new item.
+ */
+struct VSMongoSaveItem *vs_mongo_save_item_add(struct VSMongoSaveBatch *batch,
+		uint8 type,
+		uint32 node_id,
+		uint16 item_id,
+		uint32 old_saved_version,
+		uint8 insert)
+{
+	struct VSMongoSaveItem *item;
+
+	item = (struct VSMongoSaveItem*)calloc(1, sizeof(struct VSMongoSaveItem));
+	if(item == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return NULL;
+	}
+
+	item->type = type;
+	item->insert = insert;
+	item->failed = 0;
+	item->node_id = node_id;
+	item->item_id = item_id;
+	item->old_saved_version = old_saved_version;
+
+	v_list_add_tail(&batch->items, item);
+	batch->count++;
+
+	return item;
+}
+
+/**
+ * \brief This function frees all items of the batch
+ */
+static void vs_mongo_save_batch_destroy(struct VSMongoSaveBatch *batch)
+{
+	struct VSMongoSaveItem *item, *next_item;
+
+	item = batch->items.first;
+	while(item != NULL) {
+		next_item = item->next;
+		if(item->insert == 0) {
+			bson_destroy(&item->cond);
+		}
+		bson_destroy(&item->doc);
+		free(item);
+		item = next_item;
+	}
+
+	batch->items.first = batch->items.last = NULL;
+	batch->count = 0;
+}
+
+/**
+ * \brief This function returns namespace used for entities of given type
+ */
+static const char *vs_mongo_save_ns(struct VS_CTX *vs_ctx, uint8 type)
+{
+	switch(type) {
+	case MONGO_SAVE_NODE:
+		return vs_ctx->mongo_node_ns;
+	case MONGO_SAVE_TAGGROUP:
+		return vs_ctx->mongo_tg_ns;
+	case MONGO_SAVE_LAYER:
+		return vs_ctx->mongo_layer_ns;
+	}
+	return NULL;
+}
+
+/**
+ * \brief This function marks snapshot of node as failed, when snapshot of
+ * some its tag group or layer could not be written. Document of node refers
+ * to tag groups and layers using ObjectId, then it can't be written before
+ * them.
+ *
+ * \return This function returns number of skipped snapshots of nodes.
+ */
+static uint32 vs_mongo_save_batch_skip_nodes(struct VSMongoSaveBatch *batch)
+{
+	struct VSMongoSaveItem *item, *child_item;
+	uint32 skipped = 0;
+
+	for(item = batch->items.first; item != NULL; item = item->next) {
+		if(item->type != MONGO_SAVE_NODE) {
+			continue;
+		}
+
+		for(child_item = batch->items.first; child_item != NULL; child_item = child_item->next) {
+			if(child_item->type != MONGO_SAVE_NODE &&
+					child_item->node_id == item->node_id &&
+					child_item->failed == 1)
+			{
+				v_print_log(VRS_PRINT_DEBUG_MSG,
+						"Skipping document of node %d, because some its entity could not be written\n",
+						item->node_id);
+				item->failed = 1;
+				skipped++;
+				break;
+			}
+		}
+	}
+
+	return skipped;
+}
+
+/**
+ * \brief This function writes snapshots of one type to MongoDB. New
+ * documents are inserted in one bulk operation. Snapshots marked as failed
+ * are not written.
+ *
+ * \return This function returns number of items, that could not be written.
+ */
+static uint32 vs_mongo_save_batch_write_type(struct VS_CTX *vs_ctx,
+		struct VSMongoSaveBatch *batch,
+		const bson **docs,
+		uint8 type)
+{
+	struct VSMongoSaveItem *item;
+	const char *ns = vs_mongo_save_ns(vs_ctx, type);
+	uint32 failed = 0;
+	int count = 0, ret;
+
+	/* Insert new documents in bulk */
+	for(item = batch->items.first; item != NULL; item = item->next) {
+		if(item->type == type && item->insert == 1 && item->failed == 0) {
+			docs[count++] = &item->doc;
+		}
+	}
+
+	if(count > 0) {
+		ret = mongo_insert_batch(vs_ctx->mongo_conn, ns, docs, count, NULL, 0);
+		if(ret != MONGO_OK) {
 			v_print_log(VRS_PRINT_ERROR,
-					"Saving data to MongoDB: %s failed\n",
-					vs_ctx->mongodb_db_name);
-			return 0;
+					"Unable to write %d documents to MongoDB: %s, error: %s\n",
+					count, ns,
+					mongo_get_server_err_string(vs_ctx->mongo_conn));
+			for(item = batch->items.first; item != NULL; item = item->next) {
+				if(item->type == type && item->insert == 1 && item->failed == 0) {
+					item->failed = 1;
+					failed++;
+				}
+			}
+		}
+	}
+
+	/* Update existing documents */
+	for(item = batch->items.first; item != NULL; item = item->next) {
+		if(item->type != type || item->insert == 1 || item->failed == 1) {
+			continue;
+		}
+
+		ret = mongo_update(vs_ctx->mongo_conn, ns, &item->cond, &item->doc,
+				MONGO_UPDATE_BASIC, 0);
+		if(ret != MONGO_OK) {
+			v_print_log(VRS_PRINT_ERROR,
+					"Unable to update document of node %d to MongoDB: %s, error: %s\n",
+					item->node_id, ns,
+					mongo_get_server_err_string(vs_ctx->mongo_conn));
+			item->failed = 1;
+			failed++;
 		}
-		bucket = bucket->next;
+	}
+
+	return failed;
+}
+
+/**
+ * \brief This function writes all snapshots of the batch to MongoDB. Tag
+ * groups and layers are written before nodes, because node refers to them.
+ * Node is not written, when some its tag group or layer could not be
+ * written. Caller must not hold lock of data.
+ *
+ * \return This function returns number of items, that could not be written.
+ */
+static uint32 vs_mongo_save_batch_write(struct VS_CTX *vs_ctx,
+		struct VSMongoSaveBatch *batch)
+{
+	struct VSMongoSaveItem *item;
+	const bson **docs;
+	uint32 failed = 0;
+
+	docs = (const bson**)malloc(batch->count * sizeof(bson*));
+	if(docs == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		for(item = batch->items.first; item != NULL; item = item->next) {
+			item->failed = 1;
+		}
+		return batch->count;
+	}
+
+	failed += vs_mongo_save_batch_write_type(vs_ctx, batch, docs, MONGO_SAVE_TAGGROUP);
+	failed += vs_mongo_save_batch_write_type(vs_ctx, batch, docs, MONGO_SAVE_LAYER);
+	failed += vs_mongo_save_batch_skip_nodes(batch);
+	failed += vs_mongo_save_batch_write_type(vs_ctx, batch, docs, MONGO_SAVE_NODE);
+
+	free(docs);
+
+	return failed;
+}
+
+/**
+ * \brief This function marks entities, that could not be written to MongoDB,
+ * as not saved. Their nodes are queued again and they will be saved in
+ * next pass. Node skipped due to failed tag group or layer is marked as not
+ * saved too (see vs_mongo_save_batch_skip_nodes()).
+ *
+ * Caller has to hold write lock of data.
+ */
+static void vs_mongo_save_batch_rollback(struct VS_CTX *vs_ctx,
+		struct VSMongoSaveBatch *batch)
+{
+	struct VSMongoSaveItem *item;
+	struct VSNode *node;
+	struct VSTagGroup *tg;
+	struct VSLayer *layer;
+
+	for(item = batch->items.first; item != NULL; item = item->next) {
+		if(item->failed == 0) {
+			continue;
+		}
+
+		/* Node could be destroyed during writing */
+		if((node = vs_node_find(vs_ctx, item->node_id)) == NULL) {
+			continue;
+		}
+
+		switch(item->type) {
+		case MONGO_SAVE_NODE:
+			node->saved_version = item->old_saved_version;
+			break;
+		case MONGO_SAVE_TAGGROUP:
+			if((tg = vs_taggroup_find(node, item->item_id)) != NULL) {
+				tg->saved_version = item->old_saved_version;
+			}
+			break;
+		case MONGO_SAVE_LAYER:
+			if((layer = vs_layer_find(node, item->item_id)) != NULL) {
+				layer->saved_version = item->old_saved_version;
+			}
+			break;
+		}
+
+		vs_mongo_node_dirty(vs_ctx, node);
+	}
+}
+
+/**
+ * \brief This function does one pass of saving changed data to MongoDB.
+ *
+ * Changed nodes are taken from the queue of dirty nodes in order of their
+ * changes. Snapshots of these nodes are created, when write lock of data is
+ * held. Snapshots are written to MongoDB after releasing of this lock. Thus
+ * data shards are blocked only for time of creating snapshots.
+ *
+ * \param[in] *vs_ctx	The pointer at verse server context
+ * \param[in] max_count	The maximal number of snapshots in one pass
+ *
+ * \return This function returns number of saved entities or -1, when some
+ * entity could not be saved.
+ */
+static int vs_mongo_save_pass(struct VS_CTX *vs_ctx, uint32 max_count)
+{
+	struct VSMongoSaveBatch batch;
+	struct VSMongoQueueItem queue_item;
+	struct VSNode *node;
+	uint32 failed = 0;
+	int ret;
+
+	batch.items.first = batch.items.last = NULL;
+	batch.count = 0;
+
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
+
+	/* Create snapshots of changed nodes until batch is full */
+	while(batch.count < max_count) {
+		pthread_mutex_lock(&vs_ctx->mongo_queue_mutex);
+		ret = vs_mongo_queue_pop(&vs_ctx->mongo_dirty, &queue_item);
+		pthread_mutex_unlock(&vs_ctx->mongo_queue_mutex);
+
+		if(ret == 0) {
+			break;
+		}
+
+		/* Node could be destroyed after it was queued */
+		if((node = vs_mongo_node_lookup(vs_ctx, queue_item.node_id)) == NULL) {
+			continue;
+		}
+
+		node->flags &= ~VS_NODE_DIRTY;
+		vs_mongo_node_snapshot(vs_ctx, &batch, node);
+
+		/* Saved node could be evicted from memory later */
+		if(!(node->flags & VS_NODE_UNLOADED)) {
+			vs_mongo_node_evictable(vs_ctx, node);
+		}
+	}
+
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+	if(batch.count == 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&vs_ctx->mongo_mutex);
+	failed = vs_mongo_save_batch_write(vs_ctx, &batch);
+	pthread_mutex_unlock(&vs_ctx->mongo_mutex);
+
+	if(failed > 0) {
+		pthread_rwlock_wrlock(&vs_ctx->data.lock);
+		vs_mongo_save_batch_rollback(vs_ctx, &batch);
+		pthread_rwlock_unlock(&vs_ctx->data.lock);
+		ret = -1;
+	} else {
+		ret = batch.count;
+	}
+
+	v_print_log(VRS_PRINT_DEBUG_MSG,
+			"Saved %d of %d documents to MongoDB: %s\n",
+			batch.count - failed, batch.count,
+			vs_ctx->mongodb_db_name);
+
+	vs_mongo_save_batch_destroy(&batch);
+
+	return ret;
+}
+
+/**
+ * \brief This function removes tag groups and layers of saved nodes from
+ * memory, when nobody was subscribed to these nodes for configured time.
+ * Data are loaded from MongoDB again, when node is used (see vs_node_find()).
+ *
+ * Nodes are taken from the queue of nodes with data in memory in order of
+ * time, when they were seen idle. The pass stops at the first node, that
+ * is not idle for configured time. Used nodes and nodes, that can't be
+ * evicted yet, are queued again.
+ *
+ * \param[in] *vs_ctx	The pointer at verse server context
+ *
+ * \return This function returns number of evicted nodes.
+ */
+static int vs_mongo_evict_pass(struct VS_CTX *vs_ctx)
+{
+	struct VSMongoQueueItem queue_item;
+	struct VSNode *node;
+	time_t now = time(NULL);
+	uint32 i, queued;
+	int count = 0;
+
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
+	pthread_mutex_lock(&vs_ctx->mongo_queue_mutex);
+
+	/* Requeued nodes are not visited twice in one pass */
+	queued = vs_ctx->mongo_idle.count;
+
+	for(i = 0; i < queued; i++) {
+		queue_item = vs_ctx->mongo_idle.items[vs_ctx->mongo_idle.first];
+		if(now - queue_item.time < (time_t)vs_ctx->mongodb_evict_time) {
+			break;
+		}
+
+		vs_mongo_queue_pop(&vs_ctx->mongo_idle, &queue_item);
+
+		/* Node could be destroyed after it was queued */
+		if((node = vs_mongo_node_lookup(vs_ctx, queue_item.node_id)) == NULL) {
+			continue;
+		}
+
+		node->flags &= ~VS_NODE_IDLE_QUEUED;
+
+		if(!(node->flags & VS_NODE_SAVEABLE) ||
+				(node->flags & VS_NODE_UNLOADED))
+		{
+			continue;
+		}
+
+		if(node->node_subs.first != NULL) {
+			/* Node is used now */
+			node->idle_since = now;
+		} else if(now - node->idle_since >= (time_t)vs_ctx->mongodb_evict_time &&
+				vs_data_shard_is_idle(vs_ctx, node->id) == 1 &&
+				vs_mongo_node_evict_data(node) == 1)
+		{
+			/* Data shard handles commands of loaded node without
+			 * write lock. Node with queued commands can't be evicted */
+			count++;
+			continue;
+		}
+
+		/* Node was used or it has unsaved changes. Try it again later. */
+		if(vs_mongo_queue_push(&vs_ctx->mongo_idle, node->id, node->idle_since) == 1) {
+			node->flags |= VS_NODE_IDLE_QUEUED;
+		}
+	}
+
+	pthread_mutex_unlock(&vs_ctx->mongo_queue_mutex);
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+	if(count > 0) {
+		v_print_log(VRS_PRINT_DEBUG_MSG,
+				"Data of %d nodes evicted from memory\n", count);
+	}
+
+	return count;
+}
+
+/**
+ * \brief This function saves all changes, that were not saved yet, to Mongo
+ * database
+ *
+ * \param[in] *vs_ctx	The pointer at verse server context
+ *
+ * \return This function returns 1, when context was save. Otherwise it
+ * returns 0
+ */
+int vs_mongo_context_save(struct VS_CTX *vs_ctx)
+{
+	int ret;
+
+	/* Save changed nodes in batches until there is nothing to save */
+	while((ret = vs_mongo_save_pass(vs_ctx, vs_ctx->mongodb_save_batch)) > 0);
+
+	if(ret == -1) {
+		v_print_log(VRS_PRINT_ERROR,
+				"Saving data to MongoDB: %s failed\n",
+				vs_ctx->mongodb_db_name);
+		return 0;
 	}
 
 	v_print_log(VRS_PRINT_DEBUG_MSG,
@@ -87,6 +651,9 @@ int vs_mongo_context_save(struct VS_CTX *vs_ctx)
  */
 int vs_mongo_context_load(struct VS_CTX *vs_ctx)
 {
+	struct VSNode *node;
+	struct VBucket *bucket;
+
 	/* Try to find parent of scene nodes in MongoDB */
 	if(vs_mongo_node_node_exist(vs_ctx, VRS_SCENE_PARENT_NODE_ID) == 1) {
 
@@ -113,6 +680,17 @@ int vs_mongo_context_load(struct VS_CTX *vs_ctx)
 		}
 	}
 
+	/* Queue nodes, that were not saved yet (e.g. new parent of scene nodes).
+	 * Later changes are queued, when they are made. */
+	bucket = vs_ctx->data.nodes.lb.first;
+	while(bucket != NULL) {
+		node = (struct VSNode*)bucket->data;
+		if(node->saved_version != node->version) {
+			vs_mongo_node_dirty(vs_ctx, node);
+		}
+		bucket = bucket->next;
+	}
+
 	return 1;
 }
 
@@ -124,6 +702,11 @@ int vs_mongo_conn_init(struct VS_CTX *vs_ctx)
 {
 	int status;
 
+	pthread_mutex_init(&vs_ctx->mongo_mutex, NULL);
+	pthread_mutex_init(&vs_ctx->mongo_queue_mutex, NULL);
+	memset(&vs_ctx->mongo_dirty, 0, sizeof(struct VSMongoQueue));
+	memset(&vs_ctx->mongo_idle, 0, sizeof(struct VSMongoQueue));
+
 	vs_ctx->mongo_conn = mongo_alloc();
 	mongo_init(vs_ctx->mongo_conn);
 
@@ -233,6 +816,10 @@ void vs_mongo_conn_destroy(struct VS_CTX *vs_ctx)
 		mongo_destroy(vs_ctx->mongo_conn);
 		mongo_dealloc(vs_ctx->mongo_conn);
 		vs_ctx->mongo_conn = NULL;
+		pthread_mutex_destroy(&vs_ctx->mongo_mutex);
+		vs_mongo_queue_destroy(&vs_ctx->mongo_dirty);
+		vs_mongo_queue_destroy(&vs_ctx->mongo_idle);
+		pthread_mutex_destroy(&vs_ctx->mongo_queue_mutex);
 		v_print_log(VRS_PRINT_DEBUG_MSG,
 				"Connection to MongoDB server %s:%d destroyed\n",
 				vs_ctx->mongodb_server, vs_ctx->mongodb_port);
@@ -241,14 +828,39 @@ void vs_mongo_conn_destroy(struct VS_CTX *vs_ctx)
 
 /**
  * \brief This function tries to do continuous saving of data to MongoDB and
- * it frees nodes from memory, when node does not have any subscriber.
+ * it frees data of nodes from memory, when node does not have any subscriber.
+ *
+ * Changed nodes, tag groups and layers are saved in batches once per
+ * configured interval. Thus only changes made during last few seconds
+ * could be lost, when server crashes.
  */
 void *vs_mongo_save_loop(void *arg)
 {
 	struct VS_CTX *vs_ctx = (struct VS_CTX *)arg;
+	unsigned int seconds = 0;
 
 	while(vs_ctx->state != SERVER_STATE_CLOSED) {
 		sleep(1);
+
+		if(++seconds < vs_ctx->mongodb_save_interval ||
+				vs_ctx->state != SERVER_STATE_READY)
+		{
+			continue;
+		}
+		seconds = 0;
+
+		/* Save changes in batches. Lock of data is released between
+		 * batches. When batch is not full, then all changes were saved. */
+		while(vs_ctx->state == SERVER_STATE_READY &&
+				vs_mongo_save_pass(vs_ctx, vs_ctx->mongodb_save_batch) >=
+						(int)vs_ctx->mongodb_save_batch);
+
+		/* Free memory used by nodes, that were saved and nobody uses them */
+		if(vs_ctx->mongodb_evict_time > 0 &&
+				vs_ctx->state == SERVER_STATE_READY)
+		{
+			vs_mongo_evict_pass(vs_ctx);
+		}
 	}
 
 	v_print_log(VRS_PRINT_DEBUG_MSG, "Exiting saving thread\n");
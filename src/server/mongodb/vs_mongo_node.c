@@ -25,6 +25,7 @@
 #define MONGO_HAVE_STDINT 1
 
 #include <mongo.h>
+#include <time.h>
 
 #include "vs_main.h"
 #include "vs_mongo_main.h"
@@ -42,8 +43,7 @@
 /**
  * \brief This function writes new version of node to MongoDB
  */
-static void vs_mongo_node_save_version(struct VS_CTX *vs_ctx,
-		struct VSNode *node,
+static void vs_mongo_node_save_version(struct VSNode *node,
 		bson *bson_node,
 		uint32 version)
 {
@@ -95,8 +95,8 @@ static void vs_mongo_node_save_version(struct VS_CTX *vs_ctx,
 	bucket = node->tag_groups.lb.first;
 	while(bucket != NULL) {
 		tg = (struct VSTagGroup*)bucket->data;
-		/* Save own tag group to MongoDB */
-		if( vs_mongo_taggroup_save(vs_ctx, node, tg) == 1) {
+		/* Tag group has ObjectId, when its snapshot was created */
+		if((int)tg->saved_version != -1) {
 			sprintf(str_num, "%d", tg->id);
 			/* Save direct reference at tag group using ObjectId */
 			bson_append_oid(&bson_version, str_num, &tg->oid);
@@ -110,8 +110,8 @@ static void vs_mongo_node_save_version(struct VS_CTX *vs_ctx,
 	bucket = node->layers.lb.first;
 	while(bucket != NULL) {
 		layer = (struct VSLayer*)bucket->data;
-		/* Try to save or update own layer */
-		if( vs_mongo_layer_save(vs_ctx, node, layer) == 1) {
+		/* Layer has ObjectId, when its snapshot was created */
+		if((int)layer->saved_version != -1) {
 			sprintf(str_num, "%d", layer->id);
 			/* Save direct reference at layer using ObjectId */
 			bson_append_oid(&bson_version, str_num, &layer->oid);
@@ -127,169 +127,139 @@ static void vs_mongo_node_save_version(struct VS_CTX *vs_ctx,
 }
 
 /**
- * \brief This function adds new node to MongoDB
- *
- * \param vs_ctx	The Verse server context
- * \param node		The node that will be saved to the database
- *
- * \return The function return 1 on success. Otherwise it returns 0.
+ * \brief This function creates new document of node
  */
-int vs_mongo_node_add_new(struct VS_CTX *vs_ctx, struct VSNode *node)
+static void vs_mongo_node_add_new(struct VSNode *node, bson *bson_node)
 {
-	bson bson_node;
-	int ret;
-
-	bson_init(&bson_node);
+	bson_init(bson_node);
 	/* Object ID has to be in every document */
-	bson_append_new_oid(&bson_node, "_id");
+	bson_append_new_oid(bson_node, "_id");
 	/* Save Node ID, Custom Type of node and current version */
-	bson_append_int(&bson_node, "node_id", node->id);
-	bson_append_int(&bson_node, "custom_type", node->custom_type);
-	bson_append_int(&bson_node, "current_version", node->version);
+	bson_append_int(bson_node, "node_id", node->id);
+	bson_append_int(bson_node, "custom_type", node->custom_type);
+	bson_append_int(bson_node, "current_version", node->version);
 
 	/* Create object of versions and save first version */
-	bson_append_start_object(&bson_node, "versions");
-	vs_mongo_node_save_version(vs_ctx, node, &bson_node, UINT32_MAX);
-	bson_append_finish_object(&bson_node);
-
-	bson_finish(&bson_node);
-	ret = mongo_insert(vs_ctx->mongo_conn, vs_ctx->mongo_node_ns, &bson_node, 0);
-	bson_destroy(&bson_node);
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to write node %d to MongoDB: %s, error: %s\n",
-				node->id, vs_ctx->mongo_node_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
-
-	return 1;
-}
-
-/**
- * \brief This function tries to update data stored in node (tag groups and
- * layers). When tag groups and layers are same, then nothing happens.
- */
-int vs_mongo_node_update_data(struct VS_CTX *vs_ctx, struct VSNode *node)
-{
-	struct VSTagGroup *tg;
-	struct VSLayer *layer;
-	struct VBucket *bucket;
-
-
-	bucket = node->tag_groups.lb.first;
-	while(bucket != NULL) {
-		tg = (struct VSTagGroup*)bucket->data;
-		if(vs_mongo_taggroup_save(vs_ctx, node, tg) != 1) {
-			return 0;
-		}
-		bucket = bucket->next;
-	}
+	bson_append_start_object(bson_node, "versions");
+	vs_mongo_node_save_version(node, bson_node, UINT32_MAX);
+	bson_append_finish_object(bson_node);
 
-	bucket = node->layers.lb.first;
-	while(bucket != NULL) {
-		layer = (struct VSLayer*)bucket->data;
-		if(vs_mongo_layer_save(vs_ctx, node, layer) != 1) {
-			return 0;
-		}
-		bucket = bucket->next;
-	}
-
-	return 1;
+	bson_finish(bson_node);
 }
 
 /**
- * \brief This function tries to update node in MongoDB
+ * \brief This function creates update of node stored in MongoDB
  */
-int vs_mongo_node_update(struct VS_CTX *vs_ctx, struct VSNode *node)
+static void vs_mongo_node_update(struct VSNode *node, bson *cond, bson *op)
 {
-	bson cond, op;
 	bson bson_version;
-	int ret;
 
 	/* TODO: delete old version, when there is too much versions:
 	int old_saved_version = node->saved_version;
 	*/
 
-	bson_init(&cond);
+	bson_init(cond);
 	{
-		bson_append_int(&cond, "node_id", node->id);
+		bson_append_int(cond, "node_id", node->id);
 	}
-	bson_finish(&cond);
+	bson_finish(cond);
 
-	bson_init(&op);
+	bson_init(op);
 	{
 		/* Update item current_version in document */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
-			bson_append_int(&op, "current_version", node->version);
+			bson_append_int(op, "current_version", node->version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 		/* Create new bson object representing current version and add it to
 		 * the object versions */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
 			bson_init(&bson_version);
 			{
-				vs_mongo_node_save_version(vs_ctx, node, &bson_version, UINT32_MAX);
+				vs_mongo_node_save_version(node, &bson_version, UINT32_MAX);
 			}
 			bson_finish(&bson_version);
-			bson_append_bson(&op, "versions", &bson_version);
+			bson_append_bson(op, "versions", &bson_version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 	}
-	bson_finish(&op);
-
-	ret = mongo_update(vs_ctx->mongo_conn, vs_ctx->mongo_node_ns, &cond, &op, MONGO_UPDATE_BASIC, 0);
+	bson_finish(op);
 
 	bson_destroy(&bson_version);
-	bson_destroy(&cond);
-	bson_destroy(&op);
-
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to update node %d to MongoDB: %s, error: %s\n",
-				node->id, vs_ctx->mongo_node_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
-
-	return 1;
 }
 
 /**
- * \brief This function writes content of node to Mongo database
+ * \brief This function adds snapshots of changed node, its tag groups and
+ * layers to the batch. Entities are marked as saved and the batch is written
+ * to MongoDB later without lock of data.
+ *
+ * Caller has to hold write lock of data.
  *
  * \param vs_ctx	The Verse server context
+ * \param batch	The batch of snapshots
  * \param node		The node that will be saved to the database
  *
- * \return The function return 1 on success. Otherwise it returns 0.
+ * \return The function returns number of snapshots added to the batch.
  */
-int vs_mongo_node_save(struct VS_CTX *vs_ctx, struct VSNode *node)
+int vs_mongo_node_snapshot(struct VS_CTX *vs_ctx,
+		struct VSMongoSaveBatch *batch,
+		struct VSNode *node)
 {
-	int ret = 1;
+	struct VSMongoSaveItem *item;
+	struct VSTagGroup *tg;
+	struct VSLayer *layer;
+	struct VBucket *bucket;
+	uint32 count = batch->count;
 
 	/* Save only node that is in subtree of scene node */
-	if(node->flags & VS_NODE_SAVEABLE) {
-
-		if((int)node->saved_version == -1) {
-			/* Create new mongo document for unsaved node */
-			ret = vs_mongo_node_add_new(vs_ctx, node);
-		} else if(node->saved_version < node->version) {
-			/* Try to find document and add update current version */
-			ret = vs_mongo_node_update(vs_ctx, node);
-		} else {
-			/* When structure of node is same, then tag groups or layers can
-			 * be changed. Let's try to update tag groups and layers. */
-			ret = vs_mongo_node_update_data(vs_ctx, node);
-		}
+	if(!(node->flags & VS_NODE_SAVEABLE)) {
+		return 0;
+	}
+
+	/* Changed node has to contain references at all tag groups and
+	 * layers, then they have to be loaded first */
+	if((node->flags & VS_NODE_UNLOADED) &&
+			node->saved_version != node->version &&
+			vs_mongo_node_load_data(vs_ctx, node) != 1)
+	{
+		return 0;
+	}
 
-		if(ret == 1) {
+	/* Tag groups and layers has to be saved before node, because node
+	 * refers to them using ObjectId */
+	bucket = node->tag_groups.lb.first;
+	while(bucket != NULL) {
+		tg = (struct VSTagGroup*)bucket->data;
+		vs_mongo_taggroup_snapshot(batch, node, tg);
+		bucket = bucket->next;
+	}
+
+	bucket = node->layers.lb.first;
+	while(bucket != NULL) {
+		layer = (struct VSLayer*)bucket->data;
+		vs_mongo_layer_snapshot(batch, node, layer);
+		bucket = bucket->next;
+	}
+
+	if(node->saved_version != node->version) {
+		item = vs_mongo_save_item_add(batch, MONGO_SAVE_NODE, node->id, 0,
+				node->saved_version,
+				((int)node->saved_version == -1) ? 1 : 0);
+		if(item != NULL) {
+			if(item->insert == 1) {
+				/* Create new mongo document for unsaved node */
+				vs_mongo_node_add_new(node, &item->doc);
+			} else {
+				/* Try to find document and add update current version */
+				vs_mongo_node_update(node, &item->cond, &item->doc);
+			}
 			node->saved_version = node->version;
 		}
 	}
 
-	return ret;
+	return batch->count - count;
 }
 
 /**
@@ -322,6 +292,195 @@ int vs_mongo_node_node_exist(struct VS_CTX *vs_ctx,
 }
 
 
+/**
+ * \brief This function loads tag groups and layers of node from the version
+ * of node stored in MongoDB
+ */
+static void vs_mongo_node_load_entities(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		bson *bson_version)
+{
+	bson_iterator version_data_iter;
+
+	/* Try to get tag groups */
+	if( bson_find(&version_data_iter, bson_version, "tag_groups") == BSON_OBJECT ) {
+		bson_iterator tg_ids_iter;
+		bson_oid_t *oid;
+		uint32 tg_id;
+		const char *key;
+
+		bson_iterator_subiterator(&version_data_iter, &tg_ids_iter);
+
+		/* Go through all tag group ObjectIDs */
+		while( bson_iterator_next(&tg_ids_iter) == BSON_OID) {
+			key = bson_iterator_key(&tg_ids_iter);
+			oid = bson_iterator_oid(&tg_ids_iter);
+
+			sscanf(key, "%ud", &tg_id);
+
+			vs_mongo_taggroup_load_linked(vs_ctx, oid, node, (uint16)tg_id, -1);
+		}
+	}
+
+	/* Try to get layers */
+	if( bson_find(&version_data_iter, bson_version, "layers") == BSON_OBJECT ) {
+		bson_iterator layer_ids_iter;
+		bson_oid_t *oid;
+		uint32 layer_id;
+		const char *key;
+
+		bson_iterator_subiterator(&version_data_iter, &layer_ids_iter);
+
+		/* Go through all layer ObjectIDs */
+		while( bson_iterator_next(&layer_ids_iter) == BSON_OID) {
+			key = bson_iterator_key(&layer_ids_iter);
+			oid = bson_iterator_oid(&layer_ids_iter);
+
+			sscanf(key, "%ud", &layer_id);
+
+			vs_mongo_layer_load_linked(vs_ctx, oid, node, (uint16)layer_id, -1);
+		}
+	}
+}
+
+/**
+ * \brief This function loads tag groups and layers of node, that were not
+ * loaded yet or that were evicted from memory.
+ *
+ * \param *vs_ctx	The Verse server context
+ * \param *node		The node with unloaded data
+ *
+ * \return The function returns 1, when data of node were loaded. Otherwise it
+ * returns 0.
+ */
+int vs_mongo_node_load_data(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	bson query;
+	mongo_cursor cursor;
+	uint32 version = node->version;
+	int ret = 0;
+
+	if(vs_ctx->mongo_conn == NULL) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&vs_ctx->mongo_mutex);
+
+	bson_init(&query);
+	bson_append_int(&query, "node_id", node->id);
+	bson_finish(&query);
+
+	mongo_cursor_init(&cursor, vs_ctx->mongo_conn, vs_ctx->mongo_node_ns);
+	mongo_cursor_set_query(&cursor, &query);
+
+	if( mongo_cursor_next(&cursor) == MONGO_OK ) {
+		const bson *bson_node = mongo_cursor_bson(&cursor);
+		bson_iterator node_data_iter, version_iter;
+		bson bson_versions, bson_version;
+		char str_num[15];
+
+		if( bson_find(&node_data_iter, bson_node, "versions") == BSON_OBJECT ) {
+			bson_iterator_subobject_init(&node_data_iter, &bson_versions, 0);
+
+			sprintf(str_num, "%u", UINT32_MAX);
+
+			if( bson_find(&version_iter, &bson_versions, str_num) == BSON_OBJECT ) {
+				bson_iterator_subobject_init(&version_iter, &bson_version, 0);
+				vs_mongo_node_load_entities(vs_ctx, node, &bson_version);
+				bson_destroy(&bson_version);
+				ret = 1;
+			}
+			bson_destroy(&bson_versions);
+		}
+	}
+
+	bson_destroy(&query);
+	mongo_cursor_destroy(&cursor);
+
+	pthread_mutex_unlock(&vs_ctx->mongo_mutex);
+
+	if(ret == 1) {
+		/* Loading of tag groups and layers is not change of node */
+		node->version = node->saved_version = version;
+		vs_node_journal_reset(node, node->version);
+		node->flags &= ~VS_NODE_UNLOADED;
+		node->idle_since = time(NULL);
+		vs_mongo_node_evictable(vs_ctx, node);
+		v_print_log(VRS_PRINT_DEBUG_MSG,
+				"Data of node: %d loaded from MongoDB\n", node->id);
+	} else {
+		v_print_log(VRS_PRINT_ERROR,
+				"Unable to load data of node: %d from MongoDB\n", node->id);
+	}
+
+	return ret;
+}
+
+/**
+ * \brief This function removes tag groups and layers of node from memory.
+ * Node has to be saved and nobody can be subscribed to this node.
+ *
+ * \return The function returns 1, when data of node were evicted. Otherwise
+ * it returns 0.
+ */
+int vs_mongo_node_evict_data(struct VSNode *node)
+{
+	struct VSTagGroup *tg;
+	struct VSLayer *layer;
+	struct VBucket *bucket;
+	uint32 version = node->version;
+
+	if(!(node->flags & VS_NODE_SAVEABLE) ||
+			(node->flags & VS_NODE_UNLOADED) ||
+			node->state != ENTITY_CREATED ||
+			node->node_subs.first != NULL ||
+			node->saved_version != node->version)
+	{
+		return 0;
+	}
+
+	/* All tag groups have to be saved and nobody can know about them */
+	bucket = node->tag_groups.lb.first;
+	while(bucket != NULL) {
+		tg = (struct VSTagGroup*)bucket->data;
+		if(tg->state != ENTITY_CREATED ||
+				tg->saved_version != tg->version ||
+				tg->tg_folls.first != NULL ||
+				tg->tg_subs.first != NULL)
+		{
+			return 0;
+		}
+		bucket = bucket->next;
+	}
+
+	/* All layers have to be saved and nobody can know about them */
+	bucket = node->layers.lb.first;
+	while(bucket != NULL) {
+		layer = (struct VSLayer*)bucket->data;
+		if(layer->state != ENTITY_CREATED ||
+				layer->saved_version != layer->version ||
+				layer->layer_folls.first != NULL ||
+				layer->layer_subs.first != NULL)
+		{
+			return 0;
+		}
+		bucket = bucket->next;
+	}
+
+	vs_node_taggroups_destroy(node);
+	vs_node_layers_destroy(node);
+
+	/* Destroying of data in memory is not change of node */
+	node->version = node->saved_version = version;
+	vs_node_journal_reset(node, node->version);
+	node->flags |= VS_NODE_UNLOADED;
+
+	v_print_log(VRS_PRINT_DEBUG_MSG,
+			"Data of node: %d evicted from memory\n", node->id);
+
+	return 1;
+}
+
 /**
  * \brief This function read concrete version of node from Mongo database
  *
@@ -462,45 +621,13 @@ struct VSNode *vs_mongo_node_load_linked(struct VS_CTX *vs_ctx,
 
 						}
 
-						/* Try to get tag groups */
-						if( bson_find(&version_data_iter, &bson_version, "tag_groups") == BSON_OBJECT ) {
-							bson_iterator tg_ids_iter;
-							bson_oid_t *oid;
-							uint32 tg_id;
-							const char *key;
-
-							bson_iterator_subiterator(&version_data_iter, &tg_ids_iter);
-
-							/* Go through all tag group ObjectIDs */
-							while( bson_iterator_next(&tg_ids_iter) == BSON_OID) {
-								key = bson_iterator_key(&tg_ids_iter);
-								oid = bson_iterator_oid(&tg_ids_iter);
-
-								sscanf(key, "%ud", &tg_id);
-
-								vs_mongo_taggroup_load_linked(vs_ctx, oid, node, (uint16)tg_id, -1);
-							}
-						}
-
-						/* Try to get layers */
-						if( bson_find(&version_data_iter, &bson_version, "layers") == BSON_OBJECT ) {
-							bson_iterator layer_ids_iter;
-							bson_oid_t *oid;
-							uint32 layer_id;
-							const char *key;
+						/* Changes before loaded version are not known */
+						vs_node_journal_reset(node, node->version);
 
-							bson_iterator_subiterator(&version_data_iter, &layer_ids_iter);
-
-							/* Go through all layer ObjectIDs */
-							while( bson_iterator_next(&layer_ids_iter) == BSON_OID) {
-								key = bson_iterator_key(&layer_ids_iter);
-								oid = bson_iterator_oid(&layer_ids_iter);
-
-								sscanf(key, "%ud", &layer_id);
-
-								vs_mongo_layer_load_linked(vs_ctx, oid, node, (uint16)layer_id, -1);
-							}
-						}
+						/* Tag groups and layers are loaded, when node is
+						 * used for the first time */
+						node->flags |= VS_NODE_UNLOADED;
+						node->idle_since = time(NULL);
 					}
 				} else {
 					v_print_log(VRS_PRINT_WARNING,
@@ -129,138 +129,119 @@ static void vs_mongo_taggroup_save_version(struct VSTagGroup *tg,
 }
 
 /**
- * \brief This function tries to update tag group in MongoDB. It adds new
+ * \brief This function creates update of tag group in MongoDB. It adds new
  * version of data.
  */
-int vs_mongo_taggroup_update(struct VS_CTX *vs_ctx,
-		struct VSNode *node,
-		struct VSTagGroup *tg)
+static void vs_mongo_taggroup_update(struct VSNode *node,
+		struct VSTagGroup *tg,
+		bson *cond,
+		bson *op)
 {
-	bson cond, op;
 	bson bson_version;
-	int ret;
 
 	/* TODO: delete old version, when there is too much versions:
 	int old_saved_version = tg->saved_version;
 	*/
 
-	bson_init(&cond);
+	bson_init(cond);
 	{
-		bson_append_oid(&cond, "_id", &tg->oid);
+		bson_append_oid(cond, "_id", &tg->oid);
 		/* To be sure that right tag group will be updated */
-		bson_append_int(&cond, "node_id", node->id);
-		bson_append_int(&cond, "taggroup_id", tg->id);
+		bson_append_int(cond, "node_id", node->id);
+		bson_append_int(cond, "taggroup_id", tg->id);
 	}
-	bson_finish(&cond);
+	bson_finish(cond);
 
-	bson_init(&op);
+	bson_init(op);
 	{
 		/* Update item current_version in document */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
-			bson_append_int(&op, "current_version", tg->version);
+			bson_append_int(op, "current_version", tg->version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 		/* Create new bson object representing current version and add it to
 		 * the object versions */
-		bson_append_start_object(&op, "$set");
+		bson_append_start_object(op, "$set");
 		{
 			bson_init(&bson_version);
 			{
 				vs_mongo_taggroup_save_version(tg, &bson_version, UINT32_MAX);
 			}
 			bson_finish(&bson_version);
-			bson_append_bson(&op, "versions", &bson_version);
+			bson_append_bson(op, "versions", &bson_version);
 		}
-		bson_append_finish_object(&op);
+		bson_append_finish_object(op);
 	}
-	bson_finish(&op);
-
-	ret = mongo_update(vs_ctx->mongo_conn, vs_ctx->mongo_tg_ns, &cond, &op,
-			MONGO_UPDATE_BASIC, 0);
+	bson_finish(op);
 
 	bson_destroy(&bson_version);
-	bson_destroy(&cond);
-	bson_destroy(&op);
-
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to update tag group %d to MongoDB: %s, error: %s\n",
-				tg->id, vs_ctx->mongo_tg_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
-
-	return 1;
 }
 
 /**
- * \brief This function tries to add new tag group to MongoDB
+ * \brief This function creates new document of tag group
  */
-int vs_mongo_taggroup_add_new(struct VS_CTX *vs_ctx,
-		struct VSNode *node,
-		struct VSTagGroup *tg)
+static void vs_mongo_taggroup_add_new(struct VSNode *node,
+		struct VSTagGroup *tg,
+		bson *bson_tg)
 {
-	bson bson_tg;
-	int ret;
-	bson_init(&bson_tg);
+	bson_init(bson_tg);
 
 	bson_oid_gen(&tg->oid);
-	bson_append_oid(&bson_tg, "_id", &tg->oid);
-	bson_append_int(&bson_tg, "node_id", node->id);
-	bson_append_int(&bson_tg, "taggroup_id", tg->id);
-	bson_append_int(&bson_tg, "custom_type", tg->custom_type);
-	bson_append_int(&bson_tg, "current_version", tg->version);
-
-	bson_append_start_object(&bson_tg, "versions");
-	vs_mongo_taggroup_save_version(tg, &bson_tg, UINT32_MAX);
-	bson_append_finish_object(&bson_tg);
-
-	bson_finish(&bson_tg);
-
-	ret = mongo_insert(vs_ctx->mongo_conn, vs_ctx->mongo_tg_ns, &bson_tg, 0);
-
-	bson_destroy(&bson_tg);
+	bson_append_oid(bson_tg, "_id", &tg->oid);
+	bson_append_int(bson_tg, "node_id", node->id);
+	bson_append_int(bson_tg, "taggroup_id", tg->id);
+	bson_append_int(bson_tg, "custom_type", tg->custom_type);
+	bson_append_int(bson_tg, "current_version", tg->version);
 
-	if(ret != MONGO_OK) {
-		v_print_log(VRS_PRINT_ERROR,
-				"Unable to write tag group %d of node %d to MongoDB: %s, error: %s\n",
-				tg->id, node->id, vs_ctx->mongo_tg_ns,
-				mongo_get_server_err_string(vs_ctx->mongo_conn));
-		return 0;
-	}
+	bson_append_start_object(bson_tg, "versions");
+	vs_mongo_taggroup_save_version(tg, bson_tg, UINT32_MAX);
+	bson_append_finish_object(bson_tg);
 
-	return 1;
+	bson_finish(bson_tg);
 }
 
 /**
- * \brief This function saves tag group to the MongoDB
+ * \brief This function adds snapshot of changed tag group to the batch. Tag
+ * group is marked as saved and the batch is written to MongoDB later.
+ *
+ * Caller has to hold write lock of data.
  *
- * \param[in] *vs_ctx	The verse server context
+ * \param[in] *batch	The batch of snapshots
  * \param[in] *node		The node containing tag group
  * \param[in] *tg		The tag group that will be saved
  *
- * \return	This function returns 1 on success. Otherwise it returns 0;
+ * \return	This function returns 1, when snapshot of tag group was added to
+ * the batch. Otherwise it returns 0.
  */
-int vs_mongo_taggroup_save(struct VS_CTX *vs_ctx,
+int vs_mongo_taggroup_snapshot(struct VSMongoSaveBatch *batch,
 		struct VSNode *node,
 		struct VSTagGroup *tg)
 {
-	int ret = 1;
+	struct VSMongoSaveItem *item;
+
+	if(tg->saved_version == tg->version) {
+		return 0;
+	}
 
-	if((int)tg->saved_version == -1) {
+	item = vs_mongo_save_item_add(batch, MONGO_SAVE_TAGGROUP, node->id,
+			tg->id, tg->saved_version,
+			((int)tg->saved_version == -1) ? 1 : 0);
+	if(item == NULL) {
+		return 0;
+	}
+
+	if(item->insert == 1) {
 		/* Add new tag group to MongoDB */
-		ret = vs_mongo_taggroup_add_new(vs_ctx, node, tg);
-	} else if(tg->saved_version < tg->version) {
+		vs_mongo_taggroup_add_new(node, tg, &item->doc);
+	} else {
 		/* Update document in database */
-		ret = vs_mongo_taggroup_update(vs_ctx, node, tg);
+		vs_mongo_taggroup_update(node, tg, &item->cond, &item->doc);
 	}
 
-	if(ret == 1) {
-		tg->saved_version = tg->version;
-	}
+	tg->saved_version = tg->version;
 
-	return ret;
+	return 1;
 }
 
 /**
@@ -495,6 +476,10 @@ struct VSTagGroup *vs_mongo_taggroup_load_linked(struct VS_CTX *vs_ctx,
 
 						/* Try to load tags */
 						vs_mongo_taggroup_load_data(tg, &bson_version);
+
+						/* Changes before loaded version are not known */
+						vs_journal_reset(&tg->journal, tg->version,
+								vs_journal_new_epoch());
 					}
 				}
 			}
@@ -29,6 +29,9 @@
 #include <stdint.h>
 
 #include "vs_main.h"
+#include "vs_data.h"
+#include "vs_dgram_worker.h"
+#include "vs_persist.h"
 #include "v_common.h"
 
 /**
@@ -49,13 +52,20 @@ void vs_read_config_file(struct VS_CTX *vs_ctx, const char *ini_file_name)
 		char *ca_certificate_file_name;
 		char *private_key;
 		char *fc_type;
+		char *cc_type, *cc_alg;
 #ifdef WITH_MONGODB
 		char *mongodb_server_hostname;
 		int mongodb_server_port;
 		char *mongodb_server_db_name;
 		char *mongodb_user;
 		char *mongodb_pass;
+		int mongodb_save_interval;
+		int mongodb_save_batch;
+		int mongodb_evict_time;
 #endif
+		char *persist_engine;
+		char *persist_dir;
+		int persist_snapshot_interval;
 		int fc_win_scale;
 		int in_queue_max_size;
 		int out_queue_max_size;
@@ -63,7 +73,10 @@ void vs_read_config_file(struct VS_CTX *vs_ctx, const char *ini_file_name)
 		int ws_port_number;
 		int udp_low_port_number;
 		int udp_high_port_number;
+		int udp_shared_port_number;
 		int max_session_count;
+		int data_thread_count;
+		int dgram_thread_count;
 
 		v_print_log(VRS_PRINT_DEBUG_MSG, "Reading config file: %s\n",
 				ini_file_name);
@@ -124,11 +137,50 @@ void vs_read_config_file(struct VS_CTX *vs_ctx, const char *ini_file_name)
 			}
 		}
 
+		/* Try to get UDP port shared by all unsecured datagram connections */
+		udp_shared_port_number = iniparser_getint(ini_dict, "Global:UDP_shared_port", -1);
+		if(udp_shared_port_number != -1) {
+			if(udp_shared_port_number == 0) {
+				vs_ctx->dgram_shared_port = 0;
+			} else if(udp_shared_port_number < 49152 || udp_shared_port_number > 65535) {
+				v_print_log(VRS_PRINT_WARNING, "UDP shared port: %d out of range: 49152-65535\n",
+						udp_shared_port_number);
+			} else if(udp_shared_port_number >= vs_ctx->port_low &&
+					udp_shared_port_number <= vs_ctx->port_high) {
+				v_print_log(VRS_PRINT_WARNING, "UDP shared port: %d is in range of UDP ports: %d-%d\n",
+						udp_shared_port_number, vs_ctx->port_low, vs_ctx->port_high);
+			} else {
+				vs_ctx->dgram_shared_port = udp_shared_port_number;
+			}
+		}
+
 		max_session_count = iniparser_getint(ini_dict, "Global:MaxSessionCount", -1);
 		if(max_session_count != -1) {
 			vs_ctx->max_sessions = max_session_count;
 		}
 
+		/* Try to get number of threads handling node commands */
+		data_thread_count = iniparser_getint(ini_dict, "Global:DataThreads", -1);
+		if(data_thread_count != -1) {
+			if(data_thread_count >= 1 && data_thread_count <= MAX_DATA_THREAD_COUNT) {
+				vs_ctx->data_threads = data_thread_count;
+			} else {
+				v_print_log(VRS_PRINT_WARNING, "DataThreads: %d out of range: 1-%d\n",
+						data_thread_count, MAX_DATA_THREAD_COUNT);
+			}
+		}
+
+		/* Try to get number of threads handling datagram connections */
+		dgram_thread_count = iniparser_getint(ini_dict, "Global:DgramThreads", -1);
+		if(dgram_thread_count != -1) {
+			if(dgram_thread_count >= 1 && dgram_thread_count <= MAX_DGRAM_THREAD_COUNT) {
+				vs_ctx->dgram_threads = dgram_thread_count;
+			} else {
+				v_print_log(VRS_PRINT_WARNING, "DgramThreads: %d out of range: 1-%d\n",
+						dgram_thread_count, MAX_DGRAM_THREAD_COUNT);
+			}
+		}
+
 		/* Try to load section [Users] */
 		user_auth_method = iniparser_getstring(ini_dict, "Users:Method", NULL);
 		if(user_auth_method != NULL &&
@@ -205,6 +257,34 @@ void vs_read_config_file(struct VS_CTX *vs_ctx, const char *ini_file_name)
 			}
 		}
 
+		/* Type of Congestion Control */
+		cc_type = iniparser_getstring(ini_dict, "CongestionControl:Type", NULL);
+		if(cc_type != NULL) {
+			if(strcmp(cc_type, "tcp_like")==0) {
+				v_print_log(VRS_PRINT_DEBUG_MSG,
+						"congestion_control type: %s\n", cc_type);
+				vs_ctx->cc_meth = CC_TCP_LIKE;
+			} else if(strcmp(cc_type, "none")==0) {
+				v_print_log(VRS_PRINT_DEBUG_MSG,
+						"congestion_control type: %s\n", cc_type);
+				vs_ctx->cc_meth = CC_NONE;
+			}
+		}
+
+		/* Algorithm of TCP like Congestion Control */
+		cc_alg = iniparser_getstring(ini_dict, "CongestionControl:Algorithm", NULL);
+		if(cc_alg != NULL) {
+			const struct VCCAlgorithm *alg = v_cc_find_algorithm(cc_alg);
+			if(alg != NULL) {
+				v_print_log(VRS_PRINT_DEBUG_MSG,
+						"congestion_control algorithm: %s\n", alg->name);
+				vs_ctx->cc_alg = alg->id;
+			} else {
+				v_print_log(VRS_PRINT_WARNING,
+						"Unsupported congestion_control algorithm: %s\n", cc_alg);
+			}
+		}
+
 		/* Scale of Flow Control window */
 		fc_win_scale = iniparser_getint(ini_dict, "FlowControl:WinScale", -1);
 		if(fc_win_scale != -1) {
@@ -283,8 +363,72 @@ void vs_read_config_file(struct VS_CTX *vs_ctx, const char *ini_file_name)
 			v_print_log_simple(VRS_PRINT_DEBUG_MSG, "\n");
 			vs_ctx->mongodb_pass = strdup(mongodb_pass);
 		}
+
+		/* Period of saving changed data to MongoDB */
+		mongodb_save_interval = iniparser_getint(ini_dict,
+				"MongoDB:SaveInterval", -1);
+		if(mongodb_save_interval > 0) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"mongodb save interval: %d\n", mongodb_save_interval);
+			vs_ctx->mongodb_save_interval = mongodb_save_interval;
+		}
+
+		/* Maximal number of documents saved in one batch */
+		mongodb_save_batch = iniparser_getint(ini_dict,
+				"MongoDB:SaveBatchSize", -1);
+		if(mongodb_save_batch > 0) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"mongodb save batch size: %d\n", mongodb_save_batch);
+			vs_ctx->mongodb_save_batch = mongodb_save_batch;
+		}
+
+		/* Time of node without subscribers before it is removed from memory */
+		mongodb_evict_time = iniparser_getint(ini_dict,
+				"MongoDB:EvictTime", -1);
+		if(mongodb_evict_time != -1) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"mongodb evict time: %d\n", mongodb_evict_time);
+			vs_ctx->mongodb_evict_time = mongodb_evict_time;
+		}
 #endif
 
+		/* Built-in persistence engine */
+		persist_engine = iniparser_getstring(ini_dict,
+				"Persistence:Engine", NULL);
+		if(persist_engine != NULL) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"persistence engine: %s\n", persist_engine);
+			if(strcmp(persist_engine, "wal") == 0) {
+				vs_ctx->persist_engine = PERSIST_ENGINE_WAL;
+			} else if(strcmp(persist_engine, "none") == 0) {
+				vs_ctx->persist_engine = PERSIST_ENGINE_NONE;
+			} else {
+				v_print_log(VRS_PRINT_WARNING,
+						"Unsupported persistence engine: %s\n", persist_engine);
+			}
+		}
+
+		/* Directory with snapshot and write-ahead log */
+		persist_dir = iniparser_getstring(ini_dict,
+				"Persistence:Directory", NULL);
+		if(persist_dir != NULL) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"persistence directory: %s\n", persist_dir);
+			if(vs_ctx->persist_dir != NULL) {
+				free(vs_ctx->persist_dir);
+			}
+			vs_ctx->persist_dir = strdup(persist_dir);
+		}
+
+		/* Period of creating snapshots */
+		persist_snapshot_interval = iniparser_getint(ini_dict,
+				"Persistence:SnapshotInterval", -1);
+		if(persist_snapshot_interval > 0) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"persistence snapshot interval: %d\n", persist_snapshot_interval);
+			vs_ctx->persist_snapshot_interval = persist_snapshot_interval;
+		}
+
 		iniparser_freedict(ini_dict);
 	} else {
 		v_print_log(VRS_PRINT_WARNING, "Unable to load config file: %s\n",
@@ -27,6 +27,8 @@
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "verse_types.h"
 
@@ -44,10 +46,20 @@
 #include "v_common.h"
 #include "v_context.h"
 #include "v_list.h"
+#include "v_slab.h"
 #include "v_fake_commands.h"
 
+static void vs_handle_cmd_view(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd);
+
 /**
  * \brief This function handle all received node commands
+ *
+ * Caller has to hold read lock of vs_ctx->data.lock, when command changes
+ * only content of one node (see vs_data_cmd_node_id()). Write lock has to be
+ * held for all other commands.
+ *
  * \param[in] *vs_ctx	The pointer at verse server context
  * \param[in] *vsession	The pointer at verse session that sent this command
  * \param[in] *cmd		The pointer at command
@@ -56,8 +68,10 @@ static void vs_handle_node_cmd(struct VS_CTX *vs_ctx,
 		struct VSession *vsession,
 		struct Generic_Cmd *cmd)
 {
-	pthread_mutex_lock(&vs_ctx->data.mutex);
 	switch(cmd->id) {
+		case FAKE_CMD_CMD_VIEW:
+			vs_handle_cmd_view(vs_ctx, vsession, cmd);
+			break;
 		case CMD_NODE_CREATE:
 			vs_handle_node_create(vs_ctx, vsession, cmd);
 			break;
@@ -262,24 +276,408 @@ static void vs_handle_node_cmd(struct VS_CTX *vs_ctx,
 		case CMD_LAYER_UNSET_VALUE:
 			vs_handle_layer_unset_value(vs_ctx, vsession, cmd);
 			break;
+		case FAKE_CMD_LAYER_SET_ACK:
+			vs_handle_layer_set_ack(vs_ctx, vsession, cmd);
+			break;
 		default:
 			v_print_log(VRS_PRINT_WARNING, "Yet unimplemented command id: %d\n", cmd->id);
 			break;
 	}
-	pthread_mutex_unlock(&vs_ctx->data.mutex);
+}
+
+/**
+ * \brief This function handles all commands in the view of received commands.
+ * Commands are decoded one by one from the receive buffer to the buffer on
+ * the stack. Handlers of commands never keep pointer at received command.
+ */
+static void vs_handle_cmd_view(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	struct Cmd_View_Cmd *view = (struct Cmd_View_Cmd*)cmd;
+	union VCmdViewBuf view_buf;
+	uint16 i;
+
+	for(i = 0; i < view->count; i++) {
+		if(v_cmd_view_get(view, i, &view_buf.cmd) != 1) {
+			v_print_log(VRS_PRINT_WARNING,
+					"Malformed view of commands: %d, skipping %d commands\n",
+					view->cmd_id, view->count - i);
+			break;
+		}
+		vs_handle_node_cmd(vs_ctx, vsession, &view_buf.cmd);
+	}
+}
+
+/**
+ * \brief This function tries to get ID of node, that is the only one node
+ * modified by this command.
+ *
+ * Commands of tag groups, tags and layers change only content of one node and
+ * they can be handled in data shard of this node. Node commands can change
+ * node tree, links between nodes, subscribers and followers of child nodes
+ * (vs_handle_link_change(), vs_node_destroy_branch(), etc.) and they have to
+ * be handled exclusively by main data thread.
+ *
+ * \param[in]	*cmd		The pointer at command
+ * \param[out]	*node_id	The ID of node modified by this command
+ *
+ * \return This function returns 1, when command could be handled in data
+ * shard. Otherwise it returns 0.
+ */
+static int vs_data_cmd_node_id(struct Generic_Cmd *cmd, uint32 *node_id)
+{
+	switch(cmd->id) {
+		case FAKE_CMD_TAGGROUP_CREATE_ACK:
+			*node_id = ((struct TagGroup_Create_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_TAGGROUP_DESTROY_ACK:
+			*node_id = ((struct TagGroup_Destroy_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_TAG_CREATE_ACK:
+			*node_id = ((struct Tag_Create_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_TAG_DESTROY_ACK:
+			*node_id = ((struct Tag_Destroy_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_LAYER_CREATE_ACK:
+			*node_id = ((struct Layer_Create_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_LAYER_DESTROY_ACK:
+			*node_id = ((struct Layer_Destroy_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_LAYER_SET_ACK:
+			*node_id = ((struct Layer_Set_Ack_Cmd*)cmd)->node_id;
+			return 1;
+		case FAKE_CMD_CMD_VIEW:
+			/* All commands in view modify the same node, when ID of node
+			 * is part of shared address */
+			if(((struct Cmd_View_Cmd*)cmd)->share >= UINT32_SIZE) {
+				union VCmdViewBuf view_buf;
+				if(v_cmd_view_get((struct Cmd_View_Cmd*)cmd, 0, &view_buf.cmd) == 1) {
+					return vs_data_cmd_node_id(&view_buf.cmd, node_id);
+				}
+			}
+			break;
+		default:
+			/* All commands of tag groups, tags and layers have node_id
+			 * as first parameter */
+			if((cmd->id >= CMD_TAGGROUP_CREATE && cmd->id <= CMD_TAG_SET_STRING8) ||
+					(cmd->id >= CMD_LAYER_CREATE && cmd->id <= CMD_LAYER_SET_VEC4_REAL64))
+			{
+				*node_id = UINT32(cmd->data[0]);
+				return 1;
+			}
+			break;
+	}
+
+	return 0;
+}
+
+/**
+ * \brief This function is main function of data shard thread. It handles
+ * commands from the queue of shard, when server holds read lock of data.
+ */
+static void *vs_data_shard_loop(void *arg)
+{
+	struct VSDataShard *shard = (struct VSDataShard*)arg;
+	struct VS_CTX *vs_ctx = shard->vs_ctx;
+	struct VSDataShardCmd *shard_cmd, *next_shard_cmd;
+	struct VListBase cmds;
+	uint32 count;
+
+	pthread_mutex_lock(&shard->mutex);
+
+	while(shard->running == 1) {
+		if(shard->cmds.first == NULL) {
+			pthread_cond_wait(&shard->work_cond, &shard->mutex);
+			continue;
+		}
+
+		/* Take all queued commands at once */
+		cmds = shard->cmds;
+		shard->cmds.first = shard->cmds.last = NULL;
+		pthread_mutex_unlock(&shard->mutex);
+
+		count = 0;
+		pthread_rwlock_rdlock(&vs_ctx->data.lock);
+		shard_cmd = cmds.first;
+		while(shard_cmd != NULL) {
+			next_shard_cmd = shard_cmd->next;
+			vs_handle_node_cmd(vs_ctx, shard_cmd->vsession, shard_cmd->cmd);
+			v_cmd_destroy(&shard_cmd->cmd);
+			v_slab_free(shard_cmd, sizeof(struct VSDataShardCmd));
+			count++;
+			shard_cmd = next_shard_cmd;
+		}
+		pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+		pthread_mutex_lock(&shard->mutex);
+		shard->count -= count;
+		if(shard->count == 0) {
+			pthread_cond_signal(&shard->idle_cond);
+		}
+	}
+
+	pthread_mutex_unlock(&shard->mutex);
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+/**
+ * \brief This function adds command to the queue of data shard. The shard
+ * becomes owner of this command.
+ */
+static int vs_data_shard_push(struct VSDataShard *shard,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	struct VSDataShardCmd *shard_cmd;
+
+	shard_cmd = (struct VSDataShardCmd*)v_slab_alloc(sizeof(struct VSDataShardCmd));
+	if(shard_cmd == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Not enough memory for shard command\n");
+		return 0;
+	}
+
+	shard_cmd->vsession = vsession;
+	shard_cmd->cmd = cmd;
+
+	pthread_mutex_lock(&shard->mutex);
+	v_list_add_tail(&shard->cmds, shard_cmd);
+	shard->count++;
+	pthread_cond_signal(&shard->work_cond);
+	pthread_mutex_unlock(&shard->mutex);
+
+	return 1;
+}
+
+/**
+ * \brief This function tries to add command to the queue of data shard of
+ * node.
+ *
+ * Tag groups and layers of node evicted from memory are loaded from MongoDB,
+ * when node is used (see vs_node_find()). Loading changes node, then it can
+ * be done only with write lock of data and commands of such node are not
+ * queued in data shard. Read lock of data prevents eviction of node between
+ * this check and adding command to the queue (see vs_data_shard_is_idle()).
+ *
+ * \return This function returns 1, when command was added to the queue.
+ * Otherwise it returns 0.
+ */
+static int vs_data_shard_push_node_cmd(struct VS_CTX *vs_ctx,
+		uint32 node_id,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	struct VSDataShard *shard = &vs_ctx->data.shards[node_id % vs_ctx->data.shard_count];
+	int ret;
+#ifdef WITH_MONGODB
+	struct VSNode find_node;
+	struct VBucket *bucket;
+
+	pthread_rwlock_rdlock(&vs_ctx->data.lock);
+
+	find_node.id = node_id;
+	bucket = v_hash_array_find_item(&vs_ctx->data.nodes, &find_node);
+	if(bucket != NULL &&
+			(((struct VSNode*)bucket->data)->flags & VS_NODE_UNLOADED))
+	{
+		pthread_rwlock_unlock(&vs_ctx->data.lock);
+		return 0;
+	}
+#endif
+
+	ret = vs_data_shard_push(shard, vsession, cmd);
+
+#ifdef WITH_MONGODB
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+#endif
+
+	return ret;
+}
+
+/**
+ * \brief This function returns 1, when data shard of node does not have any
+ * queued command. Caller has to hold write lock of data, then no command can
+ * be added to the queue of shard (see vs_data_shard_push_node_cmd()).
+ */
+int vs_data_shard_is_idle(struct VS_CTX *vs_ctx, uint32 node_id)
+{
+	struct VSDataShard *shard;
+	int ret;
+
+	if(vs_ctx->data.shard_count == 0) {
+		return 1;
+	}
+
+	shard = &vs_ctx->data.shards[node_id % vs_ctx->data.shard_count];
+
+	pthread_mutex_lock(&shard->mutex);
+	ret = (shard->count == 0) ? 1 : 0;
+	pthread_mutex_unlock(&shard->mutex);
+
+	return ret;
+}
+
+/**
+ * \brief This function waits until all data shards handle all commands in
+ * their queues.
+ *
+ * This is cross-shard barrier: commands received before command, that
+ * changes node tree, have to be handled before this command.
+ */
+static void vs_data_shards_wait(struct VS_CTX *vs_ctx)
+{
+	struct VSDataShard *shard;
+	int i;
+
+	for(i = 0; i < vs_ctx->data.shard_count; i++) {
+		shard = &vs_ctx->data.shards[i];
+		pthread_mutex_lock(&shard->mutex);
+		while(shard->count > 0) {
+			pthread_cond_wait(&shard->idle_cond, &shard->mutex);
+		}
+		pthread_mutex_unlock(&shard->mutex);
+	}
+}
+
+/**
+ * \brief This function handles one command received from client. Command is
+ * queued in the data shard of node or it is handled immediately with
+ * exclusive access to the data of server.
+ */
+static void vs_data_dispatch_cmd(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	uint32 node_id;
+
+	if(vs_ctx->data.shard_count > 0 &&
+			vs_data_cmd_node_id(cmd, &node_id) == 1 &&
+			vs_data_shard_push_node_cmd(vs_ctx, node_id, vsession, cmd) == 1)
+	{
+		return;
+	}
+
+	vs_data_shards_wait(vs_ctx);
+
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
+	vs_handle_node_cmd(vs_ctx, vsession, cmd);
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+	v_cmd_destroy(&cmd);
+}
+
+/**
+ * \brief This function creates data shards. When only one data thread is
+ * configured, then no shard is created and main data thread handles all
+ * commands.
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+int vs_data_shards_init(struct VS_CTX *vs_ctx)
+{
+	struct VSDataShard *shard;
+	int i;
+
+	vs_ctx->data.shards = NULL;
+	vs_ctx->data.shard_count = 0;
+
+	if(vs_ctx->data_threads <= 1) {
+		return 1;
+	}
+
+	vs_ctx->data.shards = (struct VSDataShard*)calloc(vs_ctx->data_threads,
+			sizeof(struct VSDataShard));
+	if(vs_ctx->data.shards == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "calloc(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	for(i = 0; i < vs_ctx->data_threads; i++) {
+		shard = &vs_ctx->data.shards[i];
+		shard->vs_ctx = vs_ctx;
+		shard->index = i;
+		shard->running = 1;
+		shard->cmds.first = shard->cmds.last = NULL;
+		shard->count = 0;
+		pthread_mutex_init(&shard->mutex, NULL);
+		pthread_cond_init(&shard->work_cond, NULL);
+		pthread_cond_init(&shard->idle_cond, NULL);
+
+		if(pthread_create(&shard->thread, NULL, vs_data_shard_loop, (void*)shard) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
+			pthread_cond_destroy(&shard->idle_cond);
+			pthread_cond_destroy(&shard->work_cond);
+			pthread_mutex_destroy(&shard->mutex);
+			vs_data_shards_destroy(vs_ctx);
+			return 0;
+		}
+
+		vs_ctx->data.shard_count++;
+	}
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Created %d data shards\n",
+			vs_ctx->data.shard_count);
+
+	return 1;
+}
+
+/**
+ * \brief This function stops all threads of data shards and it destroys
+ * commands, that were not handled yet.
+ */
+void vs_data_shards_destroy(struct VS_CTX *vs_ctx)
+{
+	struct VSDataShard *shard;
+	struct VSDataShardCmd *shard_cmd;
+	int i;
+
+	for(i = 0; i < vs_ctx->data.shard_count; i++) {
+		shard = &vs_ctx->data.shards[i];
+
+		pthread_mutex_lock(&shard->mutex);
+		shard->running = 0;
+		pthread_cond_signal(&shard->work_cond);
+		pthread_mutex_unlock(&shard->mutex);
+
+		if(pthread_join(shard->thread, NULL) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_join(): %s\n", strerror(errno));
+		}
+
+		while((shard_cmd = shard->cmds.first) != NULL) {
+			v_list_rem_item(&shard->cmds, shard_cmd);
+			v_cmd_destroy(&shard_cmd->cmd);
+			v_slab_free(shard_cmd, sizeof(struct VSDataShardCmd));
+		}
+
+		pthread_cond_destroy(&shard->idle_cond);
+		pthread_cond_destroy(&shard->work_cond);
+		pthread_mutex_destroy(&shard->mutex);
+	}
+
+	if(vs_ctx->data.shards != NULL) {
+		free(vs_ctx->data.shards);
+		vs_ctx->data.shards = NULL;
+	}
+	vs_ctx->data.shard_count = 0;
 }
 
 /**
  * \brief This is function of main data thread. It waits for new data in
- * incoming queues of session, that are in OPEN/CLOSEREQ states.
+ * incoming queues of session, that are in OPEN/CLOSEREQ states. Commands are
+ * distributed to data shards or they are handled in this thread.
  */
 void *vs_data_loop(void *arg)
 {
 	struct VS_CTX *vs_ctx = (struct VS_CTX*)arg;
+	struct VSession *vsession;
 	struct Generic_Cmd *cmd;
 	struct timespec ts;
 	struct timeval tv;
-	int i, ret = 0;
+	int ret = 0;
 
 	gettimeofday(&tv, NULL);
 	ts.tv_sec = tv.tv_sec + 1;
@@ -293,14 +691,18 @@ void *vs_data_loop(void *arg)
         ret = sem_wait(vs_ctx->data.sem);
 #endif
 		if(ret == 0) {
-			for(i=0; i<vs_ctx->max_sessions; i++) {
-				if(vs_ctx->vsessions[i]->dgram_conn->host_state == UDP_SERVER_STATE_OPEN ||
-						vs_ctx->vsessions[i]->stream_conn->host_state == TCP_SERVER_STATE_STREAM_OPEN)
+			/* Handle only sessions, that received some commands */
+			while((vsession = v_ready_ring_pop(&vs_ctx->data.ready_sessions)) != NULL) {
+				if(vsession->dgram_conn->host_state == UDP_SERVER_STATE_OPEN ||
+						vsession->stream_conn->host_state == TCP_SERVER_STATE_STREAM_OPEN)
 				{
 					/* Pop all data of incoming messages from queue */
-					while(v_in_queue_cmd_count(vs_ctx->vsessions[i]->in_queue) > 0) {
-						cmd = v_in_queue_pop(vs_ctx->vsessions[i]->in_queue);
-						vs_handle_node_cmd(vs_ctx, vs_ctx->vsessions[i], cmd);
+					while((cmd = v_in_queue_pop(vsession->in_queue)) != NULL) {
+						vs_data_dispatch_cmd(vs_ctx, vsession, cmd);
+					}
+				} else {
+					/* Drop commands of session, that is not open anymore */
+					while((cmd = v_in_queue_pop(vsession->in_queue)) != NULL) {
 						v_cmd_destroy(&cmd);
 					}
 				}
@@ -312,6 +714,8 @@ void *vs_data_loop(void *arg)
 		}
 	}
 
+	vs_data_shards_destroy(vs_ctx);
+
 	v_print_log(VRS_PRINT_DEBUG_MSG, "Exiting data thread\n");
 
 	pthread_exit(NULL);
@@ -0,0 +1,197 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "v_common.h"
+
+#include "vs_delta.h"
+
+#define vs_delta_base(delta, state) \
+	((uint8*)(state) + (delta)->header_size)
+#define vs_delta_sent(delta, state, index) \
+	((uint8*)(state) + (delta)->header_size + \
+			(1 + ((index) % DELTA_HISTORY_LEN)) * (delta)->value_size)
+
+/**
+ * \brief This function creates state of delta coding for one layer and one
+ * subscriber
+ *
+ * \param[in]	value_size	The size of value sent to the client
+ */
+struct VSDelta *vs_delta_create(uint16 value_size)
+{
+	struct VSDelta *delta;
+	uint16 state_size;
+
+	delta = (struct VSDelta*)calloc(1, sizeof(struct VSDelta));
+	if(delta == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return NULL;
+	}
+
+	delta->value_size = value_size;
+	/* Keep states of items and values in them aligned */
+	delta->header_size = (sizeof(struct VSDeltaItem) + 7) & ~7;
+	state_size = (delta->header_size + (1 + DELTA_HISTORY_LEN)*value_size + 7) & ~7;
+
+	delta->empty = (uint8*)calloc(1, state_size);
+	if(delta->empty == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		free(delta);
+		return NULL;
+	}
+
+	vs_layer_values_init(&delta->items, state_size);
+
+	return delta;
+}
+
+/**
+ * \brief This function destroys state of delta coding
+ */
+void vs_delta_destroy(struct VSDelta **delta)
+{
+	if(*delta == NULL) {
+		return;
+	}
+
+	vs_layer_values_destroy(&(*delta)->items);
+	free((*delta)->empty);
+	free(*delta);
+	*delta = NULL;
+}
+
+/**
+ * \brief This function encodes value of item as delta against the newest
+ * value acknowledged by client. Complete value is encoded (base is equal to
+ * seq), when no value was acknowledged yet or base value is too old.
+ *
+ * \param[in]	*delta		The state of delta coding
+ * \param[in]	*vsession	The session of subscriber
+ * \param[in]	item_id		The ID of layer item
+ * \param[in]	*value		The value in representation sent to the client
+ * \param[out]	*seq		The sequence number of this value
+ * \param[out]	*base		The sequence number of base value
+ * \param[out]	*out		The encoded value
+ *
+ * \return This function returns 1, when value was encoded and it returns 0,
+ * when it was not possible to allocate memory for state of item.
+ */
+int vs_delta_encode(struct VSDelta *delta,
+		struct VSession *vsession,
+		uint32 item_id,
+		const void *value,
+		uint16 *seq,
+		uint16 *base,
+		void *out)
+{
+	struct VSDeltaItem *state;
+	uint8 *base_value;
+	uint32 seq32, i;
+
+	state = (struct VSDeltaItem*)vs_layer_values_find(&delta->items, item_id);
+	if(state == NULL) {
+		state = (struct VSDeltaItem*)vs_layer_values_set(&delta->items,
+				item_id, delta->empty);
+		if(state == NULL) {
+			return 0;
+		}
+	}
+
+	/* Sequence numbers are shared by all layers of session, because data
+	 * shards could send values to the same client at the same time */
+	seq32 = __atomic_add_fetch(&vsession->delta_seq, 1, __ATOMIC_RELAXED);
+
+	if(state->base_valid == 1 &&
+			state->sent_count - state->base_index < DELTA_HISTORY_LEN &&
+			seq32 - state->base_seq <= DELTA_MAX_DISTANCE)
+	{
+		base_value = vs_delta_base(delta, state);
+		for(i = 0; i < delta->value_size; i++) {
+			((uint8*)out)[i] = ((const uint8*)value)[i] ^ base_value[i];
+		}
+		*base = (uint16)state->base_seq;
+	} else {
+		memcpy(out, value, delta->value_size);
+		*base = (uint16)seq32;
+	}
+	*seq = (uint16)seq32;
+
+	/* Remember sent value, because it could become base value */
+	state->sent_seq[state->sent_count % DELTA_HISTORY_LEN] = seq32;
+	memcpy(vs_delta_sent(delta, state, state->sent_count), value,
+			delta->value_size);
+	state->sent_count++;
+
+	return 1;
+}
+
+/**
+ * \brief This function handles acknowledgment of value sent as delta. When
+ * acknowledged value is newer then current base value, then it becomes new
+ * base value.
+ */
+void vs_delta_ack(struct VSDelta *delta,
+		struct VSession *vsession,
+		uint32 item_id,
+		uint16 seq)
+{
+	struct VSDeltaItem *state;
+	uint32 cur_seq, index, j;
+
+	state = (struct VSDeltaItem*)vs_layer_values_find(&delta->items, item_id);
+	if(state == NULL) {
+		return;
+	}
+
+	cur_seq = __atomic_load_n(&vsession->delta_seq, __ATOMIC_RELAXED);
+
+	/* Try to find acknowledged value from the newest to the oldest one */
+	for(j = 0; j < DELTA_HISTORY_LEN && j < state->sent_count; j++) {
+		index = state->sent_count - 1 - j;
+		if((uint16)state->sent_seq[index % DELTA_HISTORY_LEN] == seq &&
+				cur_seq - state->sent_seq[index % DELTA_HISTORY_LEN] <= DELTA_MAX_DISTANCE)
+		{
+			if(state->base_valid == 0 || index > state->base_index) {
+				memcpy(vs_delta_base(delta, state),
+						vs_delta_sent(delta, state, index),
+						delta->value_size);
+				state->base_seq = state->sent_seq[index % DELTA_HISTORY_LEN];
+				state->base_index = index;
+				state->base_valid = 1;
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * \brief This function removes state of unset item
+ */
+void vs_delta_remove(struct VSDelta *delta, uint32 item_id)
+{
+	vs_layer_values_unset(&delta->items, item_id);
+}
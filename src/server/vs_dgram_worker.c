@@ -0,0 +1,1005 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "vs_main.h"
+#include "vs_dgram_worker.h"
+#include "vs_udp_connect.h"
+
+#include "v_context.h"
+#include "v_common.h"
+#include "v_session.h"
+#include "v_list.h"
+#include "v_network.h"
+#include "v_sys_commands.h"
+
+/**
+ * \brief This function computes time of next update of connection from FPS
+ * negotiated for this session.
+ */
+static void vs_dgram_worker_schedule_conn(struct VSDgramWorkerConn *conn,
+		const struct timeval *tv_now)
+{
+	struct timeval tv_period;
+	uint32 period = (uint32)(1000000/conn->vsession->fps_host);
+
+	tv_period.tv_sec = period / 1000000;
+	tv_period.tv_usec = period % 1000000;
+	timeradd(tv_now, &tv_period, &conn->tv_update);
+}
+
+/**
+ * \brief This function arms timer of worker to the time of the nearest
+ * update of connection. When tv_next is NULL, then timer is disarmed.
+ */
+static void vs_dgram_worker_arm_timer(struct VSDgramWorker *worker,
+		const struct timeval *tv_next,
+		const struct timeval *tv_now)
+{
+	struct itimerspec timer_spec;
+	struct timeval tv_diff;
+
+	memset(&timer_spec, 0, sizeof(struct itimerspec));
+
+	if(tv_next != NULL) {
+		if(timercmp(tv_next, tv_now, >)) {
+			timersub(tv_next, tv_now, &tv_diff);
+			timer_spec.it_value.tv_sec = tv_diff.tv_sec;
+			timer_spec.it_value.tv_nsec = tv_diff.tv_usec * 1000;
+		} else {
+			/* Zero value would disarm the timer */
+			timer_spec.it_value.tv_nsec = 1;
+		}
+	}
+
+	if(timerfd_settime(worker->timer_fd, 0, &timer_spec, NULL) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "timerfd_settime(): %s\n", strerror(errno));
+	}
+}
+
+/**
+ * \brief This function tries to find connection of session in the lists of
+ * connections of worker. Worker has to be locked.
+ */
+static struct VSDgramWorkerConn *vs_dgram_worker_find_conn(struct VSDgramWorker *worker,
+		struct VSession *vsession)
+{
+	struct VSDgramWorkerConn *conn;
+
+	for(conn = worker->new_conns.first; conn != NULL; conn = conn->next) {
+		if(conn->vsession == vsession) {
+			return conn;
+		}
+	}
+
+	for(conn = worker->conns.first; conn != NULL; conn = conn->next) {
+		if(conn->vsession == vsession) {
+			return conn;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief This function sets key of connection from address and port of client.
+ */
+static void vs_dgram_conn_key_set(struct VSDgramConnKey *key,
+		const struct VNetworkAddress *addr)
+{
+	memset(key, 0, sizeof(struct VSDgramConnKey));
+	key->ip_ver = addr->ip_ver;
+	if(addr->ip_ver == IPV4) {
+		key->port = addr->addr.ipv4.sin_port;
+		memcpy(key->addr, &addr->addr.ipv4.sin_addr, sizeof(struct in_addr));
+	} else if(addr->ip_ver == IPV6) {
+		key->port = addr->addr.ipv6.sin6_port;
+		memcpy(key->addr, &addr->addr.ipv6.sin6_addr, sizeof(struct in6_addr));
+	}
+}
+
+/**
+ * \brief This function creates socket of worker bound to the shared port.
+ * All workers bind own socket to the same port with SO_REUSEPORT and kernel
+ * distributes packets between sockets according address of client.
+ */
+static int vs_dgram_worker_open_socket(struct VSDgramWorker *worker)
+{
+	struct VS_CTX *vs_ctx = worker->vs_ctx;
+	struct sockaddr_in addr4;
+	struct sockaddr_in6 addr6;
+	int flag, ret;
+
+	if(vs_ctx->tcp_io_ctx.host_addr.ip_ver == IPV4) {
+		worker->dgram_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	} else {
+		worker->dgram_fd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	}
+
+	if(worker->dgram_fd == -1) {
+		v_print_log(VRS_PRINT_ERROR, "socket(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	/* Set socket non-blocking */
+	flag = fcntl(worker->dgram_fd, F_GETFL, 0);
+	if( (fcntl(worker->dgram_fd, F_SETFL, flag | O_NONBLOCK)) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "fcntl(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	/* Set socket to reuse addresses and port */
+	flag = 1;
+	if( setsockopt(worker->dgram_fd, SOL_SOCKET, SO_REUSEADDR,
+			(const void*) &flag, (socklen_t) sizeof(flag)) != 0 ||
+		setsockopt(worker->dgram_fd, SOL_SOCKET, SO_REUSEPORT,
+			(const void*) &flag, (socklen_t) sizeof(flag)) != 0)
+	{
+		v_print_log(VRS_PRINT_ERROR, "setsockopt(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	if(vs_ctx->tcp_io_ctx.host_addr.ip_ver == IPV4) {
+		memset(&addr4, 0, sizeof(struct sockaddr_in));
+		addr4.sin_family = AF_INET;
+		addr4.sin_addr.s_addr = htonl(INADDR_ANY);
+		addr4.sin_port = htons(vs_ctx->dgram_shared_port);
+		ret = bind(worker->dgram_fd, (struct sockaddr*)&addr4, sizeof(addr4));
+	} else {
+		memset(&addr6, 0, sizeof(struct sockaddr_in6));
+		addr6.sin6_family = AF_INET6;
+		addr6.sin6_addr = in6addr_any;
+		addr6.sin6_port = htons(vs_ctx->dgram_shared_port);
+		ret = bind(worker->dgram_fd, (struct sockaddr*)&addr6, sizeof(addr6));
+	}
+
+	if(ret == -1) {
+		v_print_log(VRS_PRINT_ERROR, "bind(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function tries to find negotiated token in the packet stored
+ * in the spare buffer of worker. Only packets sent by client in REQUEST state
+ * contain token.
+ * \return	This function returns pointer at token or NULL.
+ */
+static const char *vs_dgram_worker_packet_token(struct VSDgramWorker *worker,
+		const char *buf,
+		unsigned short buf_size)
+{
+	struct VPacket *packet = worker->r_packet;
+	int i;
+
+	v_unpack_packet_header(buf, buf_size, packet);
+
+	if(packet->header.flags != (PAY_FLAG|SYN_FLAG)) {
+		return NULL;
+	}
+
+	v_unpack_packet_system_commands(buf, buf_size, packet);
+
+	for(i = 0;
+			i < MAX_SYSTEM_COMMAND_COUNT && packet->sys_cmd[i].cmd.id != CMD_RESERVED_ID;
+			i++)
+	{
+		if(packet->sys_cmd[i].cmd.id == CMD_CHANGE_L_ID &&
+				packet->sys_cmd[i].negotiate_cmd.feature == FTR_TOKEN &&
+				packet->sys_cmd[i].negotiate_cmd.count > 0)
+		{
+			return (char*)packet->sys_cmd[i].negotiate_cmd.value[0].string8.str;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief This function tries to find pending connection with token and it
+ * moves this connection to the worker.
+ */
+static struct VSDgramWorkerConn *vs_dgram_worker_adopt_conn(struct VSDgramWorker *worker,
+		const char *token,
+		const struct VSDgramConnKey *key,
+		const struct timeval *tv_now)
+{
+	struct VSDgramDemux *demux = worker->vs_ctx->dgram_demux;
+	struct VSDgramWorkerConn *conn;
+
+	pthread_mutex_lock(&demux->mutex);
+
+	for(conn = demux->pending.first; conn != NULL; conn = conn->next) {
+		if(conn->canceled == 0 &&
+				conn->vsession->peer_token.str != NULL &&
+				strcmp(conn->vsession->peer_token.str, token) == 0)
+		{
+			break;
+		}
+	}
+
+	if(conn != NULL) {
+		v_list_rem_item(&demux->pending, conn);
+		conn->key = *key;
+		conn->worker = worker;
+		v_hash_array_add_item(&demux->conns, conn, sizeof(struct VSDgramWorkerConn));
+
+		/* Connection has to be in the list of worker before it is removed
+		 * from the list of pending connections (see wait function) */
+		pthread_mutex_lock(&worker->mutex);
+		v_list_add_tail(&worker->conns, conn);
+		worker->count++;
+		pthread_mutex_unlock(&worker->mutex);
+
+		pthread_cond_broadcast(&demux->release_cond);
+	}
+
+	pthread_mutex_unlock(&demux->mutex);
+
+	if(conn != NULL) {
+		CTX_r_packet_set(conn->C, worker->r_packet);
+		CTX_s_packet_set(conn->C, worker->s_packet);
+		conn->vsession->dgram_conn->io_ctx.sockfd = worker->dgram_fd;
+		conn->vsession->dgram_conn->io_ctx.batch = worker->batch;
+		conn->tv_update = *tv_now;
+	}
+
+	return conn;
+}
+
+/**
+ * \brief This function moves new connections to the list of handled
+ * connections and it adds their sockets to the epoll. It also marks
+ * connections canceled by TCP threads as closed.
+ */
+static void vs_dgram_worker_accept_conns(struct VSDgramWorker *worker,
+		const struct timeval *tv_now)
+{
+	struct VSDgramWorkerConn *conn;
+	struct VDgramConn *dgram_conn;
+	struct epoll_event event;
+
+	pthread_mutex_lock(&worker->mutex);
+
+	while((conn = worker->new_conns.first) != NULL) {
+		v_list_rem_item(&worker->new_conns, conn);
+		v_list_add_tail(&worker->conns, conn);
+
+		/* All connections of this worker share packet structures */
+		CTX_r_packet_set(conn->C, worker->r_packet);
+		CTX_s_packet_set(conn->C, worker->s_packet);
+
+		/* Update connection as soon as possible */
+		conn->tv_update = *tv_now;
+
+		dgram_conn = conn->vsession->dgram_conn;
+		dgram_conn->io_ctx.batch = worker->batch;
+		memset(&event, 0, sizeof(struct epoll_event));
+		event.events = EPOLLIN;
+		event.data.ptr = conn;
+		if(epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD,
+				dgram_conn->io_ctx.sockfd, &event) == -1)
+		{
+			v_print_log(VRS_PRINT_ERROR, "epoll_ctl(): %s\n", strerror(errno));
+			conn->closed = 1;
+		}
+	}
+
+	for(conn = worker->conns.first; conn != NULL; conn = conn->next) {
+		if(conn->canceled == 1) {
+			conn->closed = 1;
+		}
+	}
+
+	pthread_mutex_unlock(&worker->mutex);
+}
+
+/**
+ * \brief This function removes connection from worker, it frees port used by
+ * connection and it notifies TCP thread waiting for end of this connection.
+ */
+static void vs_dgram_worker_release_conn(struct VSDgramWorker *worker,
+		struct VSDgramWorkerConn *conn)
+{
+	struct VSDgramDemux *demux = worker->vs_ctx->dgram_demux;
+	struct VDgramConn *dgram_conn = conn->vsession->dgram_conn;
+
+	/* Send packets queued by this connection before socket is closed */
+	v_packet_batch_flush(worker->batch);
+	dgram_conn->io_ctx.batch = NULL;
+
+	if(dgram_conn->io_ctx.flags & SOCKET_SHARED) {
+		/* Connection uses shared socket, remove it from table of connections */
+		pthread_mutex_lock(&demux->mutex);
+		v_hash_array_remove_item(&demux->conns, conn);
+		pthread_mutex_unlock(&demux->mutex);
+		dgram_conn->io_ctx.sockfd = -1;
+	} else if(dgram_conn->io_ctx.sockfd != -1) {
+		epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, dgram_conn->io_ctx.sockfd, NULL);
+	}
+
+	vs_dgram_conn_release(conn->C);
+	free(conn->C);
+
+	pthread_mutex_lock(&worker->mutex);
+	v_list_rem_item(&worker->conns, conn);
+	worker->count--;
+	pthread_cond_broadcast(&worker->release_cond);
+	pthread_mutex_unlock(&worker->mutex);
+
+	free(conn);
+}
+
+/**
+ * \brief This function releases pending connections, that were canceled or
+ * that did not receive any packet, before token timed out.
+ * \return	This function returns 1, when there are still some pending
+ * connections, otherwise it returns 0.
+ */
+static int vs_dgram_demux_update_pending(struct VSDgramDemux *demux)
+{
+	struct VSDgramWorkerConn *conn, *next_conn;
+	int ret;
+
+	pthread_mutex_lock(&demux->mutex);
+
+	for(conn = demux->pending.first; conn != NULL; conn = next_conn) {
+		next_conn = conn->next;
+
+		if(conn->canceled == 1 ||
+				vs_dgram_conn_update(conn->C) == VS_DGRAM_CONN_CLOSE)
+		{
+			v_list_rem_item(&demux->pending, conn);
+			vs_dgram_conn_release(conn->C);
+			free(conn->C);
+			free(conn);
+			pthread_cond_broadcast(&demux->release_cond);
+		}
+	}
+
+	ret = (demux->pending.first != NULL) ? 1 : 0;
+
+	pthread_mutex_unlock(&demux->mutex);
+
+	return ret;
+}
+
+/**
+ * \brief This function releases closed connections and it updates
+ * connections, that reached time of update. Then the timer is armed to
+ * the time of the nearest update.
+ */
+static void vs_dgram_worker_update_conns(struct VSDgramWorker *worker)
+{
+	struct VSDgramWorkerConn *conn, *next_conn;
+	struct timeval tv_now, tv_pending, *tv_next = NULL;
+
+	gettimeofday(&tv_now, NULL);
+
+	/* The first worker checks timeouts of pending connections */
+	if(worker->index == 0 && worker->vs_ctx->dgram_demux != NULL) {
+		if(vs_dgram_demux_update_pending(worker->vs_ctx->dgram_demux) == 1) {
+			tv_pending.tv_sec = tv_now.tv_sec + 1;
+			tv_pending.tv_usec = tv_now.tv_usec;
+			tv_next = &tv_pending;
+		}
+	}
+
+	for(conn = worker->conns.first; conn != NULL; conn = next_conn) {
+		next_conn = conn->next;
+
+		if(conn->closed == 0 && timercmp(&conn->tv_update, &tv_now, <=)) {
+			if(vs_dgram_conn_update(conn->C) == VS_DGRAM_CONN_CLOSE) {
+				conn->closed = 1;
+			} else {
+				vs_dgram_worker_schedule_conn(conn, &tv_now);
+			}
+		}
+
+		if(conn->closed == 1) {
+			vs_dgram_worker_release_conn(worker, conn);
+			continue;
+		}
+
+		if(tv_next == NULL || timercmp(&conn->tv_update, tv_next, <)) {
+			tv_next = &conn->tv_update;
+		}
+	}
+
+	vs_dgram_worker_arm_timer(worker, tv_next, &tv_now);
+}
+
+/**
+ * \brief This function receives packets from socket bound to shared port and
+ * it passes them to connections according address of client.
+ * \return	This function returns 1, when some connection was adopted or
+ * closed. Connections of worker have to be updated then and timer has to be
+ * armed for new connection.
+ */
+static int vs_dgram_worker_receive_shared(struct VSDgramWorker *worker)
+{
+	struct VSDgramDemux *demux = worker->vs_ctx->dgram_demux;
+	struct VSDgramWorkerConn *conn, key_conn;
+	struct VBucket *vbucket;
+	struct VNetworkAddress peer_addrs[DGRAM_WORKER_MAX_RECV];
+	ssize_t sizes[DGRAM_WORKER_MAX_RECV];
+	struct VDgramConn *dgram_conn;
+	struct timeval tv_now;
+	const char *token;
+	char *buf;
+	int i, count, error_num, update = 0;
+
+	count = v_receive_packet_batch(worker->dgram_fd, worker->bufs, sizes,
+			peer_addrs, DGRAM_WORKER_MAX_RECV, &error_num);
+
+	if(count == 0 && error_num != 0 &&
+			error_num != EAGAIN && error_num != EWOULDBLOCK)
+	{
+		v_print_log(VRS_PRINT_ERROR, "recvmmsg(): %s\n", strerror(error_num));
+	}
+
+	for(i = 0; i < count; i++) {
+		if(sizes[i] <= 0 || peer_addrs[i].ip_ver == 0) {
+			continue;
+		}
+
+		vs_dgram_conn_key_set(&key_conn.key, &peer_addrs[i]);
+
+		/* Try to find connection of this client */
+		pthread_mutex_lock(&demux->mutex);
+		vbucket = v_hash_array_find_item(&demux->conns, &key_conn);
+		conn = (vbucket != NULL) ? (struct VSDgramWorkerConn*)vbucket->data : NULL;
+		if(conn != NULL && conn->worker != worker) {
+			/* Connection is handled by other worker */
+			conn = NULL;
+			vbucket = NULL;
+		}
+		pthread_mutex_unlock(&demux->mutex);
+
+		gettimeofday(&tv_now, NULL);
+
+		/* When connection was not found, then it could be first packet of
+		 * pending connection */
+		if(vbucket == NULL) {
+			token = vs_dgram_worker_packet_token(worker, worker->bufs[i],
+					(unsigned short)sizes[i]);
+			if(token != NULL) {
+				conn = vs_dgram_worker_adopt_conn(worker, token, &key_conn.key, &tv_now);
+				/* Timer of worker could be disarmed, when it had no
+				 * connection before */
+				if(conn != NULL) {
+					update = 1;
+				}
+			}
+		}
+
+		if(conn == NULL) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"Packet from unknown client at shared port ignored\n");
+			continue;
+		}
+
+		if(conn->closed == 1) {
+			continue;
+		}
+
+		/* Exchange received buffer with buffer of connection */
+		dgram_conn = conn->vsession->dgram_conn;
+		buf = dgram_conn->io_ctx.buf;
+		dgram_conn->io_ctx.buf = worker->bufs[i];
+		worker->bufs[i] = buf;
+		dgram_conn->io_ctx.buf_size = sizes[i];
+		memcpy(&dgram_conn->io_ctx.peer_addr, &peer_addrs[i], sizeof(struct VNetworkAddress));
+
+		/* Handle received packet and send response immediately */
+		vs_dgram_conn_handle_received(conn->C);
+		if(vs_dgram_conn_update(conn->C) == VS_DGRAM_CONN_CLOSE) {
+			conn->closed = 1;
+			update = 1;
+		} else {
+			gettimeofday(&tv_now, NULL);
+			vs_dgram_worker_schedule_conn(conn, &tv_now);
+		}
+	}
+
+	return update;
+}
+
+/**
+ * \brief This is function of datagram worker thread. It handles received
+ * packets of all connections of this worker and it updates connections with
+ * negotiated FPS.
+ */
+static void *vs_dgram_worker_loop(void *arg)
+{
+	struct VSDgramWorker *worker = (struct VSDgramWorker*)arg;
+	struct VSDgramWorkerConn *conn;
+	struct epoll_event events[DGRAM_WORKER_MAX_EVENTS];
+	struct timeval tv_now;
+	uint64_t value;
+	int i, ret, update;
+
+	while(worker->running == 1) {
+		ret = epoll_wait(worker->epoll_fd, events, DGRAM_WORKER_MAX_EVENTS, -1);
+
+		if(ret == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			v_print_log(VRS_PRINT_ERROR, "epoll_wait(): %s\n", strerror(errno));
+			break;
+		}
+
+		update = 0;
+
+		for(i = 0; i < ret; i++) {
+			if(events[i].data.ptr == &worker->event_fd) {
+				/* New connections were added or some were canceled */
+				if(read(worker->event_fd, &value, sizeof(value)) == -1) {
+					v_print_log(VRS_PRINT_ERROR, "read(): %s\n", strerror(errno));
+				}
+				gettimeofday(&tv_now, NULL);
+				vs_dgram_worker_accept_conns(worker, &tv_now);
+				update = 1;
+			} else if(events[i].data.ptr == &worker->dgram_fd) {
+				/* Packets received at shared port */
+				if(vs_dgram_worker_receive_shared(worker) == 1) {
+					update = 1;
+				}
+			} else if(events[i].data.ptr == &worker->timer_fd) {
+				/* Some connection should be updated */
+				if(read(worker->timer_fd, &value, sizeof(value)) == -1) {
+					v_print_log(VRS_PRINT_ERROR, "read(): %s\n", strerror(errno));
+				}
+				update = 1;
+			} else {
+				conn = (struct VSDgramWorkerConn*)events[i].data.ptr;
+
+				/* Closed connection is released after handling of all events */
+				if(conn->closed == 1) {
+					continue;
+				}
+
+				/* Handle received packet and send response immediately */
+				if(vs_dgram_conn_receive(conn->C) == VS_DGRAM_CONN_CLOSE ||
+						vs_dgram_conn_update(conn->C) == VS_DGRAM_CONN_CLOSE)
+				{
+					conn->closed = 1;
+					update = 1;
+				} else {
+					gettimeofday(&tv_now, NULL);
+					vs_dgram_worker_schedule_conn(conn, &tv_now);
+				}
+			}
+		}
+
+		if(update == 1) {
+			vs_dgram_worker_update_conns(worker);
+		}
+
+		/* Send all packets queued during handling of events */
+		v_packet_batch_flush(worker->batch);
+	}
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+/**
+ * \brief This function adds file descriptor to the epoll of worker.
+ */
+static int vs_dgram_worker_add_fd(struct VSDgramWorker *worker, int *fd)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, sizeof(struct epoll_event));
+	event.events = EPOLLIN;
+	event.data.ptr = fd;
+
+	if(epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, *fd, &event) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "epoll_ctl(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function allocates spare buffers for packets received from
+ * shared socket. Buffers are exchanged with buffers of connections, when
+ * packets are received.
+ */
+static int vs_dgram_worker_alloc_bufs(struct VSDgramWorker *worker)
+{
+	int i;
+
+	for(i = 0; i < DGRAM_WORKER_MAX_RECV; i++) {
+		worker->bufs[i] = (char*)malloc(MAX_PACKET_SIZE*sizeof(char));
+		if(worker->bufs[i] == NULL) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function frees resources of datagram worker, that is not running.
+ */
+static void vs_dgram_worker_free(struct VSDgramWorker *worker)
+{
+	int i;
+
+	if(worker->dgram_fd != -1) close(worker->dgram_fd);
+	for(i = 0; i < DGRAM_WORKER_MAX_RECV; i++) {
+		if(worker->bufs[i] != NULL) free(worker->bufs[i]);
+	}
+	if(worker->batch != NULL) free(worker->batch);
+	if(worker->event_fd != -1) close(worker->event_fd);
+	if(worker->timer_fd != -1) close(worker->timer_fd);
+	if(worker->epoll_fd != -1) close(worker->epoll_fd);
+	if(worker->r_packet != NULL) free(worker->r_packet);
+	if(worker->s_packet != NULL) free(worker->s_packet);
+	pthread_cond_destroy(&worker->release_cond);
+	pthread_mutex_destroy(&worker->mutex);
+}
+
+/**
+ * \brief This function creates datagram workers. Each worker is thread
+ * handling many datagram connections.
+ */
+int vs_dgram_workers_init(struct VS_CTX *vs_ctx)
+{
+	struct VSDgramWorker *worker;
+	int i;
+
+	vs_ctx->dgram_workers = (struct VSDgramWorker*)calloc(vs_ctx->dgram_threads,
+			sizeof(struct VSDgramWorker));
+	vs_ctx->dgram_worker_count = 0;
+
+	if(vs_ctx->dgram_workers == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "calloc(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	/* Initialize table of connections using shared port */
+	if(vs_ctx->dgram_shared_port != 0) {
+		struct VSDgramDemux *demux;
+
+		demux = (struct VSDgramDemux*)calloc(1, sizeof(struct VSDgramDemux));
+		if(demux == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "calloc(): %s\n", strerror(errno));
+			vs_dgram_workers_destroy(vs_ctx);
+			return 0;
+		}
+		pthread_mutex_init(&demux->mutex, NULL);
+		pthread_cond_init(&demux->release_cond, NULL);
+		v_hash_array_init(&demux->conns,
+				HASH_MOD_256,
+				offsetof(struct VSDgramWorkerConn, key),
+				sizeof(struct VSDgramConnKey));
+		demux->pending.first = demux->pending.last = NULL;
+		vs_ctx->dgram_demux = demux;
+	}
+
+	for(i = 0; i < vs_ctx->dgram_threads; i++) {
+		worker = &vs_ctx->dgram_workers[i];
+		worker->vs_ctx = vs_ctx;
+		worker->index = i;
+		worker->running = 1;
+		worker->new_conns.first = worker->new_conns.last = NULL;
+		worker->conns.first = worker->conns.last = NULL;
+		worker->count = 0;
+		pthread_mutex_init(&worker->mutex, NULL);
+		pthread_cond_init(&worker->release_cond, NULL);
+
+		worker->r_packet = (struct VPacket*)calloc(1, sizeof(struct VPacket));
+		worker->s_packet = (struct VPacket*)calloc(1, sizeof(struct VPacket));
+		worker->epoll_fd = epoll_create1(0);
+		worker->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+		worker->event_fd = eventfd(0, EFD_NONBLOCK);
+		worker->dgram_fd = -1;
+		worker->batch = (struct VPacketBatch*)malloc(sizeof(struct VPacketBatch));
+		if(worker->batch != NULL) {
+			v_packet_batch_init(worker->batch);
+		}
+
+		if(worker->r_packet == NULL || worker->s_packet == NULL ||
+				worker->batch == NULL ||
+				worker->epoll_fd == -1 ||
+				worker->timer_fd == -1 ||
+				worker->event_fd == -1 ||
+				vs_dgram_worker_add_fd(worker, &worker->timer_fd) != 1 ||
+				vs_dgram_worker_add_fd(worker, &worker->event_fd) != 1 ||
+				(vs_ctx->dgram_demux != NULL &&
+						(vs_dgram_worker_alloc_bufs(worker) != 1 ||
+						 vs_dgram_worker_open_socket(worker) != 1 ||
+						 vs_dgram_worker_add_fd(worker, &worker->dgram_fd) != 1)))
+		{
+			v_print_log(VRS_PRINT_ERROR, "Unable to initialize datagram worker: %s\n",
+					strerror(errno));
+			vs_dgram_worker_free(worker);
+			vs_dgram_workers_destroy(vs_ctx);
+			return 0;
+		}
+
+		if(pthread_create(&worker->thread, NULL, vs_dgram_worker_loop, (void*)worker) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
+			vs_dgram_worker_free(worker);
+			vs_dgram_workers_destroy(vs_ctx);
+			return 0;
+		}
+
+		vs_ctx->dgram_worker_count++;
+	}
+
+	if(vs_ctx->dgram_demux != NULL) {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Created %d datagram workers sharing UDP port: %d\n",
+				vs_ctx->dgram_worker_count, vs_ctx->dgram_shared_port);
+	} else {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "Created %d datagram workers\n",
+				vs_ctx->dgram_worker_count);
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function stops all datagram workers and it releases
+ * connections, that were not closed yet.
+ */
+void vs_dgram_workers_destroy(struct VS_CTX *vs_ctx)
+{
+	struct VSDgramWorker *worker;
+	struct VSDgramWorkerConn *conn;
+	uint64_t value = 1;
+	int i;
+
+	for(i = 0; i < vs_ctx->dgram_worker_count; i++) {
+		worker = &vs_ctx->dgram_workers[i];
+
+		worker->running = 0;
+		if(write(worker->event_fd, &value, sizeof(value)) == -1) {
+			v_print_log(VRS_PRINT_ERROR, "write(): %s\n", strerror(errno));
+		}
+
+		if(pthread_join(worker->thread, NULL) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_join(): %s\n", strerror(errno));
+		}
+
+		/* Move new connections to the list of connections */
+		while((conn = worker->new_conns.first) != NULL) {
+			v_list_rem_item(&worker->new_conns, conn);
+			v_list_add_tail(&worker->conns, conn);
+		}
+
+		while((conn = worker->conns.first) != NULL) {
+			vs_dgram_worker_release_conn(worker, conn);
+		}
+
+		vs_dgram_worker_free(worker);
+	}
+
+	if(vs_ctx->dgram_workers != NULL) {
+		free(vs_ctx->dgram_workers);
+		vs_ctx->dgram_workers = NULL;
+	}
+	vs_ctx->dgram_worker_count = 0;
+
+	if(vs_ctx->dgram_demux != NULL) {
+		struct VSDgramDemux *demux = vs_ctx->dgram_demux;
+
+		/* Release connections, that did not receive any packet */
+		while((conn = demux->pending.first) != NULL) {
+			v_list_rem_item(&demux->pending, conn);
+			vs_dgram_conn_release(conn->C);
+			free(conn->C);
+			free(conn);
+		}
+		pthread_cond_broadcast(&demux->release_cond);
+
+		v_hash_array_destroy(&demux->conns);
+		pthread_cond_destroy(&demux->release_cond);
+		pthread_mutex_destroy(&demux->mutex);
+		free(demux);
+		vs_ctx->dgram_demux = NULL;
+	}
+}
+
+/**
+ * \brief This function opens datagram connection of session and it passes
+ * the connection to the worker with the lowest number of connections.
+ * \param[in]	*vs_ctx	The verse server context
+ * \param[in]	*C		The copy of Verse context. The worker becomes owner
+ * of this copy and it is freed, when connection is closed.
+ * \return		This function returns 1, when connection was added to the
+ * worker, otherwise it returns 0.
+ */
+int vs_dgram_workers_add_conn(struct VS_CTX *vs_ctx, struct vContext *C)
+{
+	struct VSDgramWorker *worker = NULL;
+	struct VSDgramWorkerConn *conn;
+	uint64_t value = 1;
+	int i;
+
+	/* Find worker with the lowest number of connections */
+	for(i = 0; i < vs_ctx->dgram_worker_count; i++) {
+		if(worker == NULL || vs_ctx->dgram_workers[i].count < worker->count) {
+			worker = &vs_ctx->dgram_workers[i];
+		}
+	}
+
+	conn = (struct VSDgramWorkerConn*)calloc(1, sizeof(struct VSDgramWorkerConn));
+
+	if(worker == NULL || conn == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Unable to add datagram connection to worker\n");
+		if(conn != NULL) free(conn);
+		free(C);
+		return 0;
+	}
+
+	/* Open socket and switch connection to the LISTEN state */
+	if(vs_dgram_conn_open(C) != 1) {
+		vs_dgram_conn_release(C);
+		free(conn);
+		free(C);
+		return 0;
+	}
+
+	conn->C = C;
+	conn->vsession = CTX_current_session(C);
+
+	/* Connection using shared port waits for first packet. The first
+	 * worker is woken up to check timeout of this connection. */
+	if(vs_ctx->dgram_demux != NULL &&
+			conn->vsession->dgram_conn->io_ctx.host_addr.port == vs_ctx->dgram_shared_port)
+	{
+		worker = &vs_ctx->dgram_workers[0];
+
+		pthread_mutex_lock(&vs_ctx->dgram_demux->mutex);
+		v_list_add_tail(&vs_ctx->dgram_demux->pending, conn);
+		pthread_mutex_unlock(&vs_ctx->dgram_demux->mutex);
+
+		if(write(worker->event_fd, &value, sizeof(value)) == -1) {
+			v_print_log(VRS_PRINT_ERROR, "write(): %s\n", strerror(errno));
+		}
+
+		return 1;
+	}
+
+	pthread_mutex_lock(&worker->mutex);
+	v_list_add_tail(&worker->new_conns, conn);
+	worker->count++;
+	pthread_mutex_unlock(&worker->mutex);
+
+	/* Wake up worker */
+	if(write(worker->event_fd, &value, sizeof(value)) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "write(): %s\n", strerror(errno));
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function requests closing of datagram connection of session.
+ * Connection is released by the worker later.
+ */
+void vs_dgram_workers_cancel_conn(struct VS_CTX *vs_ctx, struct VSession *vsession)
+{
+	struct VSDgramWorker *worker;
+	struct VSDgramWorkerConn *conn;
+	uint64_t value = 1;
+	int i;
+
+	/* Connection could wait for first packet */
+	if(vs_ctx->dgram_demux != NULL) {
+		pthread_mutex_lock(&vs_ctx->dgram_demux->mutex);
+		for(conn = vs_ctx->dgram_demux->pending.first; conn != NULL; conn = conn->next) {
+			if(conn->vsession == vsession) {
+				conn->canceled = 1;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&vs_ctx->dgram_demux->mutex);
+
+		if(conn != NULL) {
+			if(write(vs_ctx->dgram_workers[0].event_fd, &value, sizeof(value)) == -1) {
+				v_print_log(VRS_PRINT_ERROR, "write(): %s\n", strerror(errno));
+			}
+			return;
+		}
+	}
+
+	for(i = 0; i < vs_ctx->dgram_worker_count; i++) {
+		worker = &vs_ctx->dgram_workers[i];
+
+		pthread_mutex_lock(&worker->mutex);
+		conn = vs_dgram_worker_find_conn(worker, vsession);
+		if(conn != NULL) {
+			conn->canceled = 1;
+		}
+		pthread_mutex_unlock(&worker->mutex);
+
+		if(conn != NULL) {
+			if(write(worker->event_fd, &value, sizeof(value)) == -1) {
+				v_print_log(VRS_PRINT_ERROR, "write(): %s\n", strerror(errno));
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * \brief This function waits until datagram connection of session is
+ * released by worker (this is blocking operation). It returns immediately,
+ * when session does not use any datagram worker.
+ */
+void vs_dgram_workers_wait_conn(struct VS_CTX *vs_ctx, struct VSession *vsession)
+{
+	struct VSDgramWorker *worker;
+	struct VSDgramWorkerConn *conn;
+	int i;
+
+	/* Wait until connection receives first packet or it is released. Pending
+	 * connection is added to the worker before it is removed from the list. */
+	if(vs_ctx->dgram_demux != NULL) {
+		pthread_mutex_lock(&vs_ctx->dgram_demux->mutex);
+		do {
+			for(conn = vs_ctx->dgram_demux->pending.first; conn != NULL; conn = conn->next) {
+				if(conn->vsession == vsession) {
+					pthread_cond_wait(&vs_ctx->dgram_demux->release_cond,
+							&vs_ctx->dgram_demux->mutex);
+					break;
+				}
+			}
+		} while(conn != NULL);
+		pthread_mutex_unlock(&vs_ctx->dgram_demux->mutex);
+	}
+
+	for(i = 0; i < vs_ctx->dgram_worker_count; i++) {
+		worker = &vs_ctx->dgram_workers[i];
+
+		pthread_mutex_lock(&worker->mutex);
+		while(vs_dgram_worker_find_conn(worker, vsession) != NULL) {
+			pthread_cond_wait(&worker->release_cond, &worker->mutex);
+		}
+		pthread_mutex_unlock(&worker->mutex);
+	}
+}
@@ -49,6 +49,7 @@
 #include "vs_main.h"
 #include "vs_tcp_connect.h"
 #include "vs_udp_connect.h"
+#include "vs_dgram_worker.h"
 #include "vs_auth_pam.h"
 #include "vs_auth_csv.h"
 #include "vs_node.h"
@@ -529,21 +530,41 @@ int vs_NEGOTIATE_token_ded_loop(struct vContext *C)
 				strncpy(trans_proto, "udp", 3);
 				trans_proto[3] = '\0';
 
-				/* Create copy of new Verse context for new thread */
+				/* Create copy of new Verse context for datagram connection */
 				new_C = (struct vContext*)calloc(1, sizeof(struct vContext));
 				memcpy(new_C, C, sizeof(struct vContext));
 
-				/* Try to create new thread */
-				if((ret = pthread_create(&vsession->udp_thread, NULL, vs_main_dgram_loop, (void*)new_C)) != 0) {
-					if(is_log_level(VRS_PRINT_ERROR)) v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
-					ret = 0;
-					goto end;
-				}
+#ifdef WITH_EPOLL
+				/* Unsecured datagram connection is handled by shared
+				 * datagram worker. DTLS connections use own thread, because
+				 * DTLS handshake is blocking. */
+				if(!(vsession->flags & VRS_SEC_DATA_TLS)) {
+					/* Use shared port instead of port from port range */
+					if(vs_ctx->dgram_shared_port != 0) {
+						vs_dgram_port_free(vs_ctx, vsession->dgram_conn->io_ctx.host_addr.port);
+						vsession->dgram_conn->io_ctx.host_addr.port = vs_ctx->dgram_shared_port;
+					}
 
-				/* Wait for datagram thread to be in LISTEN state */
-				while(vsession->dgram_conn->host_state != UDP_SERVER_STATE_LISTEN) {
-					/* Sleep 1 milisecond */
-					usleep(1000);
+					/* Connection is in LISTEN state, when it is added */
+					if(vs_dgram_workers_add_conn(vs_ctx, new_C) != 1) {
+						ret = 0;
+						goto end;
+					}
+				} else
+#endif
+				{
+					/* Try to create new thread */
+					if((ret = pthread_create(&vsession->udp_thread, NULL, vs_main_dgram_loop, (void*)new_C)) != 0) {
+						if(is_log_level(VRS_PRINT_ERROR)) v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
+						ret = 0;
+						goto end;
+					}
+
+					/* Wait for datagram thread to be in LISTEN state */
+					while(vsession->dgram_conn->host_state != UDP_SERVER_STATE_LISTEN) {
+						/* Sleep 1 milisecond */
+						usleep(1000);
+					}
 				}
 			} else if(vsession->flags & VRS_TP_TCP) {
 				strncpy(trans_proto, "tcp", 3);
@@ -739,9 +760,9 @@ int vs_RESPOND_userauth_loop(struct vContext *C)
 				{
 					long int avatar_id;
 
-					pthread_mutex_lock(&vs_ctx->data.mutex);
+					pthread_rwlock_wrlock(&vs_ctx->data.lock);
 					avatar_id = vs_create_avatar_node(vs_ctx, vsession, user_id);
-					pthread_mutex_unlock(&vs_ctx->data.mutex);
+					pthread_rwlock_unlock(&vs_ctx->data.lock);
 
 					if(avatar_id == -1) {
 						v_print_log(VRS_PRINT_ERROR, "Failed to create avatar node\n");
@@ -1035,9 +1056,16 @@ int vs_handle_handshake(struct vContext *C)
 		} else {
 			/* When thread was not confirmed, then try to cancel
 			 * UDP thread*/
-			if(pthread_cancel(vsession->udp_thread) != 0) {
-				v_print_log(VRS_PRINT_DEBUG_MSG, "UDP thread was not canceled\n");
+			if(vsession->udp_thread != 0) {
+				if(pthread_cancel(vsession->udp_thread) != 0) {
+					v_print_log(VRS_PRINT_DEBUG_MSG, "UDP thread was not canceled\n");
+				}
 			}
+#ifdef WITH_EPOLL
+			else {
+				vs_dgram_workers_cancel_conn(CTX_server_ctx(C), vsession);
+			}
+#endif
 			return -1;
 		}
 		break;
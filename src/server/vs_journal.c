@@ -0,0 +1,278 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "v_common.h"
+
+#include "vs_journal.h"
+
+/* The last epoch of journal */
+static uint32 journal_epoch = 0;
+
+/**
+ * \brief This function returns new epoch of journal. Epochs are not reused
+ * until counter overflows and the counter is seeded, when the first epoch is
+ * created, then epochs differ after restart of server. Epoch 0 is never
+ * returned, because it is sent by clients, that don't know epoch.
+ */
+uint32 vs_journal_new_epoch(void)
+{
+	uint32 epoch = 0, seed;
+
+	if(__atomic_load_n(&journal_epoch, __ATOMIC_RELAXED) == 0) {
+		seed = (uint32)time(NULL) ^ ((uint32)getpid() << 16);
+		__atomic_compare_exchange_n(&journal_epoch, &epoch, seed, 0,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	}
+
+	do {
+		epoch = __atomic_add_fetch(&journal_epoch, 1, __ATOMIC_RELAXED);
+	} while(epoch == 0);
+
+	return epoch;
+}
+
+/**
+ * \brief This function initializes empty journal of entity with version
+ */
+void vs_journal_init(struct VSJournal *journal, uint32 version, uint32 epoch)
+{
+	journal->entries = NULL;
+	journal->first = 0;
+	journal->count = 0;
+	journal->length = 0;
+	journal->base_version = version;
+	journal->epoch = epoch;
+}
+
+/**
+ * \brief This function frees all changes stored in journal
+ */
+void vs_journal_destroy(struct VSJournal *journal)
+{
+	if(journal->entries != NULL) {
+		free(journal->entries);
+	}
+	vs_journal_init(journal, 0, 0);
+}
+
+/**
+ * \brief This function drops all changes. It has to be called, when version
+ * of entity is changed without journal (entity was loaded from database,
+ * version counter overflowed, etc.). Versions held by clients are not valid
+ * in new epoch.
+ */
+void vs_journal_reset(struct VSJournal *journal, uint32 version, uint32 epoch)
+{
+	journal->first = 0;
+	journal->count = 0;
+	journal->base_version = version;
+	journal->epoch = epoch;
+}
+
+/**
+ * \brief This function adds change of item to the journal. When journal is
+ * full, then the oldest change is dropped.
+ *
+ * \param[in]	*journal	The journal of entity
+ * \param[in]	version		The version of entity after this change
+ * \param[in]	item_id		The ID of changed item
+ * \param[in]	type		The type of change (JOURNAL_ITEM_*)
+ */
+void vs_journal_add(struct VSJournal *journal,
+		uint32 version,
+		uint32 item_id,
+		uint8 type)
+{
+	struct VSJournalEntry *entry;
+
+	/* Grow ring buffer until it reaches maximal length */
+	if(journal->count == journal->length && journal->length < JOURNAL_MAX_LENGTH) {
+		uint32 length = (journal->length == 0) ? JOURNAL_MIN_LENGTH : 2 * journal->length;
+		struct VSJournalEntry *entries;
+		uint32 i;
+
+		entries = (struct VSJournalEntry*)malloc(length * sizeof(struct VSJournalEntry));
+		if(entries != NULL) {
+			for(i = 0; i < journal->count; i++) {
+				entries[i] = journal->entries[(journal->first + i) % journal->length];
+			}
+			free(journal->entries);
+			journal->entries = entries;
+			journal->length = length;
+			journal->first = 0;
+		} else if(journal->length == 0) {
+			/* Journal without memory can't cover any older version */
+			v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+			journal->base_version = version;
+			return;
+		}
+	}
+
+	/* Drop the oldest change, when journal is full */
+	if(journal->count == journal->length) {
+		journal->base_version = journal->entries[journal->first].version;
+		journal->first = (journal->first + 1) % journal->length;
+		journal->count--;
+	}
+
+	entry = &journal->entries[(journal->first + journal->count) % journal->length];
+	entry->version = version;
+	entry->item_id = item_id;
+	entry->type = type;
+	journal->count++;
+}
+
+/**
+ * \brief This function compares changes according ID of item and version
+ */
+static int vs_journal_entry_cmp(const void *a, const void *b)
+{
+	const struct VSJournalEntry *entry1 = (const struct VSJournalEntry*)a;
+	const struct VSJournalEntry *entry2 = (const struct VSJournalEntry*)b;
+
+	if(entry1->item_id != entry2->item_id) {
+		return (entry1->item_id < entry2->item_id) ? -1 : 1;
+	}
+	if(entry1->version != entry2->version) {
+		return (entry1->version < entry2->version) ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * \brief This function creates list of items changed after version. Each
+ * item is in the list only once.
+ *
+ * \param[in]	*journal	The journal of entity
+ * \param[in]	epoch		The epoch of version held by client
+ * \param[in]	version		The version of entity held by client
+ * \param[in]	cur_version	The current version of entity
+ * \param[out]	**changes	The array of changed items (it has to be freed
+ * by caller, when it is not NULL)
+ *
+ * \return This function returns number of changed items. It returns -1,
+ * when journal doesn't cover this version (or version is from other epoch)
+ * and whole entity has to be sent.
+ */
+int vs_journal_changes(struct VSJournal *journal,
+		uint32 epoch,
+		uint32 version,
+		uint32 cur_version,
+		struct VSJournalChange **changes)
+{
+	struct VSJournalEntry *entries, *entry;
+	uint32 i, count = 0, change_count = 0;
+
+	*changes = NULL;
+
+	if(epoch != journal->epoch || version == 0 ||
+			version < journal->base_version || version > cur_version) {
+		return -1;
+	}
+
+	if(version == cur_version || journal->count == 0) {
+		return 0;
+	}
+
+	entries = (struct VSJournalEntry*)malloc(journal->count * sizeof(struct VSJournalEntry));
+	if(entries == NULL) {
+		return -1;
+	}
+
+	/* Copy changes newer than version */
+	for(i = 0; i < journal->count; i++) {
+		entry = &journal->entries[(journal->first + i) % journal->length];
+		if(entry->version > version) {
+			entries[count++] = *entry;
+		}
+	}
+
+	if(count > 0) {
+		*changes = (struct VSJournalChange*)malloc(count * sizeof(struct VSJournalChange));
+		if(*changes == NULL) {
+			free(entries);
+			return -1;
+		}
+
+		/* Group changes of the same item. The first change of item tells,
+		 * if item existed in the old version. */
+		qsort(entries, count, sizeof(struct VSJournalEntry), vs_journal_entry_cmp);
+
+		for(i = 0; i < count; i++) {
+			if(i == 0 || entries[i].item_id != entries[i-1].item_id) {
+				(*changes)[change_count].item_id = entries[i].item_id;
+				(*changes)[change_count].created =
+						(entries[i].type == JOURNAL_ITEM_CREATE) ? 1 : 0;
+				(*changes)[change_count].destroyed = 0;
+				change_count++;
+			}
+			/* IDs of destroyed items can be reused by new items */
+			if(entries[i].type == JOURNAL_ITEM_DESTROY) {
+				(*changes)[change_count-1].destroyed = 1;
+			}
+		}
+	}
+
+	free(entries);
+
+	return change_count;
+}
+
+/**
+ * \brief This function compares ID of item with ID of changed item
+ */
+static int vs_journal_change_cmp(const void *key, const void *item)
+{
+	uint32 item_id = *(const uint32*)key;
+	const struct VSJournalChange *change = (const struct VSJournalChange*)item;
+
+	if(item_id != change->item_id) {
+		return (item_id < change->item_id) ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * \brief This function tries to find change of item in the array of changes
+ * created by vs_journal_changes()
+ *
+ * \return This function returns pointer at change of item. When item was not
+ * changed, then NULL is returned.
+ */
+struct VSJournalChange *vs_journal_find_change(struct VSJournalChange *changes,
+		int change_count,
+		uint32 item_id)
+{
+	if(changes == NULL || change_count <= 0) {
+		return NULL;
+	}
+
+	return (struct VSJournalChange*)bsearch(&item_id, changes, change_count,
+			sizeof(struct VSJournalChange), vs_journal_change_cmp);
+}
@@ -22,6 +22,7 @@
  *
  */
 
+#include <string.h>
 
 #include "v_common.h"
 #include "v_layer_commands.h"
@@ -29,6 +30,8 @@
 
 #include "vs_layer.h"
 #include "vs_node_access.h"
+#include "vs_persist.h"
+#include "vs_delta.h"
 
 /**
  * \brief This function increments version of layer
@@ -41,6 +44,9 @@ void vs_layer_inc_version(struct VSLayer *layer)
 	} else {
 		layer->version = 1;
 		layer->saved_version = 0;
+		/* Journal can't be used for versions before overflow */
+		vs_journal_reset(&layer->journal, layer->version,
+				vs_journal_new_epoch());
 	}
 }
 
@@ -110,10 +116,8 @@ struct VSLayer *vs_layer_create(struct VSNode *node,
 		return NULL;
 	}
 
-	v_hash_array_init(&layer->values,
-				HASH_MOD_65536,
-				offsetof(VSLayerValue, id),
-				sizeof(uint32));
+	vs_layer_values_init(&layer->values,
+			layer->num_vec_comp * vs_layer_data_size(layer));
 
 	/* When parent layer is not NULL, then add this layer to the linked list
 	 * of child layers */
@@ -132,6 +136,7 @@ struct VSLayer *vs_layer_create(struct VSNode *node,
 	layer->version = 0;
 	layer->saved_version = -1;
 	layer->crc32 = 0;
+	vs_journal_init(&layer->journal, layer->version, vs_journal_new_epoch());
 
 #ifdef WITH_MONGODB
 	for(i=0; i<3; i++) {
@@ -140,6 +145,8 @@ struct VSLayer *vs_layer_create(struct VSNode *node,
 #endif
 
 	vs_node_inc_version(node);
+	vs_journal_add(&node->layer_journal, node->version, layer->id,
+			JOURNAL_ITEM_CREATE);
 
 	return layer;
 }
@@ -150,19 +157,12 @@ struct VSLayer *vs_layer_create(struct VSNode *node,
 void vs_layer_destroy(struct VSNode *node, struct VSLayer *layer)
 {
 	struct VSLayer *child_layer;
-	struct VSLayerValue *item;
-	struct VBucket *vbucket;
-
-	/* Free values in all items */
-	vbucket = (struct VBucket*)layer->values.lb.first;
-	while(vbucket != NULL) {
-		item = (struct VSLayerValue*)vbucket->data;
-		free(item->value);
-		vbucket = vbucket->next;
-	}
+	struct VSEntitySubscriber *layer_subscriber;
+	uint16 layer_id;
 
-	/* Destroy hashed array with items */
-	v_hash_array_destroy(&layer->values);
+	/* Free values of all items */
+	vs_layer_values_destroy(&layer->values);
+	vs_journal_destroy(&layer->journal);
 
 	/* Set references to parent layer in all child layers to NULL */
 	child_layer = layer->child_layers.first;
@@ -179,6 +179,13 @@ void vs_layer_destroy(struct VSNode *node, struct VSLayer *layer)
 		v_list_rem_item(&layer->parent->child_layers, layer);
 	}
 
+	/* Free state of delta coding of all subscribers */
+	layer_subscriber = layer->layer_subs.first;
+	while(layer_subscriber != NULL) {
+		vs_delta_destroy(&layer_subscriber->delta);
+		layer_subscriber = layer_subscriber->next;
+	}
+
 	/* Free list of followers and subscribers */
 	v_list_free(&layer->layer_folls);
 	v_list_free(&layer->layer_subs);
@@ -186,10 +193,13 @@ void vs_layer_destroy(struct VSNode *node, struct VSLayer *layer)
 	v_print_log(VRS_PRINT_DEBUG_MSG, "Layer: %d destroyed\n", layer->id);
 
 	/* Destroy this layer itself */
+	layer_id = layer->id;
 	v_hash_array_remove_item(&node->layers, layer);
 	free(layer);
 
 	vs_node_inc_version(node);
+	vs_journal_add(&node->layer_journal, node->version, layer_id,
+			JOURNAL_ITEM_DESTROY);
 }
 
 /**
@@ -217,6 +227,7 @@ int vs_layer_unsubscribe(struct VSLayer *layer, struct VSession *vsession)
 	}
 
 	/* Remove client from the list of subscribers */
+	vs_delta_destroy(&layer_subscriber->delta);
 	v_list_free_item(&layer->layer_subs, layer_subscriber);
 
 	return 1;
@@ -375,21 +386,199 @@ int vs_layer_send_destroy(struct VSNode *node,
 }
 
 /**
- * \brief This function send unset layer value to the client
+ * \brief This function sends one command to all subscribers of the layer
+ *
+ * Command is created only once and it is shared by outgoing queues of all
+ * subscribers. Reference of caller at the command is dropped.
+ *
+ * \return This function returns 1, when command was added to the outgoing
+ * queues of all subscribers. Otherwise it returns 0.
+ */
+static int vs_layer_send_cmd_to_subs(struct VSLayer *layer,
+		struct Generic_Cmd *cmd)
+{
+	struct VSEntitySubscriber *layer_subscriber;
+	int ret = 1;
+
+	layer_subscriber = layer->layer_subs.first;
+	while(layer_subscriber != NULL) {
+		if(v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
+				0,
+				layer_subscriber->node_sub->prio,
+				v_cmd_share(cmd)) != 1)
+		{
+			ret = 0;
+		}
+		layer_subscriber = layer_subscriber->next;
+	}
+
+	v_cmd_destroy(&cmd);
+
+	return ret;
+}
+
+/**
+ * \brief This function converts value of item to the representation sent to
+ * the subscriber with requested precision
+ *
+ * When precision VRS_LAYER_PRECISION_REAL16 is requested for layer with
+ * real32 or real64 values, then values are converted to real16. Other layers
+ * are always sent with full precision.
+ *
+ * \return This function returns type of converted value.
+ */
+static uint8 vs_layer_value_convert(struct VSLayer *layer,
+		void *value,
+		uint8 precision,
+		void *out)
+{
+	int i;
+
+	if(precision == VRS_LAYER_PRECISION_REAL16) {
+		switch(layer->data_type) {
+		case VRS_VALUE_TYPE_REAL32:
+			for(i = 0; i < layer->num_vec_comp; i++) {
+				((real16*)out)[i] = v_real32_to_real16(((real32*)value)[i]);
+			}
+			return VRS_VALUE_TYPE_REAL16;
+		case VRS_VALUE_TYPE_REAL64:
+			for(i = 0; i < layer->num_vec_comp; i++) {
+				((real16*)out)[i] = v_real64_to_real16(((real64*)value)[i]);
+			}
+			return VRS_VALUE_TYPE_REAL16;
+		default:
+			break;
+		}
+	}
+
+	memcpy(out, value, layer->num_vec_comp * vs_layer_data_size(layer));
+
+	return layer->data_type;
+}
+
+/**
+ * \brief This function returns size of value sent to the subscriber with
+ * requested precision
+ */
+static uint16 vs_layer_value_size(struct VSLayer *layer, uint8 precision)
+{
+	if(precision == VRS_LAYER_PRECISION_REAL16 &&
+			(layer->data_type == VRS_VALUE_TYPE_REAL32 ||
+			 layer->data_type == VRS_VALUE_TYPE_REAL64))
+	{
+		return layer->num_vec_comp * REAL16_SIZE;
+	}
+
+	return layer->num_vec_comp * vs_layer_data_size(layer);
+}
+
+/**
+ * \brief This function creates command layer_set_value with requested precision
+ */
+static struct Generic_Cmd *vs_layer_set_value_create(struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id,
+		void *value,
+		uint8 precision)
+{
+	uint64 sent_value[4];
+	uint8 data_type;
+
+	data_type = vs_layer_value_convert(layer, value, precision, sent_value);
+
+	return v_layer_set_value_create(node->id, layer->id, item_id,
+			data_type, layer->num_vec_comp, sent_value);
+}
+
+/**
+ * \brief This function creates command layer_set_delta for one subscriber.
+ * Value is encoded against the newest value acknowledged by this subscriber.
  */
-int vs_layer_send_unset_value(struct VSEntitySubscriber *layer_subscriber,
+static struct Generic_Cmd *vs_layer_set_delta_create(struct VSEntitySubscriber *layer_subscriber,
 		struct VSNode *node,
 		struct VSLayer *layer,
-		struct VSLayerValue *value)
+		uint32 item_id,
+		void *value)
 {
-	struct Generic_Cmd *unset_value_cmd;
+	uint64 sent_value[4], delta_value[4];
+	uint16 seq, base;
+	uint8 data_type;
+
+	data_type = vs_layer_value_convert(layer, value,
+			layer_subscriber->precision, sent_value);
+
+	if(vs_delta_encode(layer_subscriber->delta,
+			layer_subscriber->node_sub->session,
+			item_id, sent_value, &seq, &base, delta_value) != 1)
+	{
+		return NULL;
+	}
+
+	return v_layer_set_delta_create(node->id, layer->id, item_id,
+			data_type, layer->num_vec_comp, seq, base, delta_value);
+}
+
+/**
+ * \brief This function sends new value of item to all subscribers of the layer
+ *
+ * Command is created only once for each precision requested by subscribers
+ * and it is shared by outgoing queues of these subscribers. Subscribers
+ * receiving values as delta get own command.
+ *
+ * \return This function returns 1, when command was added to the outgoing
+ * queues of all subscribers. Otherwise it returns 0.
+ */
+static int vs_layer_send_value_to_subs(struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id,
+		void *value)
+{
+	struct VSEntitySubscriber *layer_subscriber;
+	struct Generic_Cmd *set_value_cmd[2] = {NULL, NULL};
+	struct Generic_Cmd *delta_cmd;
+	uint8 precision;
+	int ret = 1;
+
+	layer_subscriber = layer->layer_subs.first;
+	while(layer_subscriber != NULL) {
+		/* Subscriber receiving delta has to get own command */
+		if(layer_subscriber->delta != NULL) {
+			delta_cmd = vs_layer_set_delta_create(layer_subscriber, node,
+					layer, item_id, value);
+			if(delta_cmd == NULL ||
+					v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
+							0,
+							layer_subscriber->node_sub->prio,
+							delta_cmd) != 1)
+			{
+				ret = 0;
+			}
+			layer_subscriber = layer_subscriber->next;
+			continue;
+		}
+		precision = layer_subscriber->precision;
+		if(set_value_cmd[precision] == NULL) {
+			set_value_cmd[precision] = vs_layer_set_value_create(node, layer,
+					item_id, value, precision);
+		}
+		if(set_value_cmd[precision] == NULL ||
+				v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
+						0,
+						layer_subscriber->node_sub->prio,
+						v_cmd_share(set_value_cmd[precision])) != 1)
+		{
+			ret = 0;
+		}
+		layer_subscriber = layer_subscriber->next;
+	}
 
-	unset_value_cmd = v_layer_unset_value_create(node->id, layer->id, value->id);
+	for(precision = 0; precision < 2; precision++) {
+		if(set_value_cmd[precision] != NULL) {
+			v_cmd_destroy(&set_value_cmd[precision]);
+		}
+	}
 
-	return v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
-			0,
-			layer_subscriber->node_sub->prio,
-			unset_value_cmd);
+	return ret;
 }
 
 /**
@@ -398,12 +587,18 @@ int vs_layer_send_unset_value(struct VSEntitySubscriber *layer_subscriber,
 int vs_layer_send_set_value(struct VSEntitySubscriber *layer_subscriber,
 		struct VSNode *node,
 		struct VSLayer *layer,
-		struct VSLayerValue *value)
+		uint32 item_id,
+		void *value)
 {
 	struct Generic_Cmd *set_value_cmd;
 
-	set_value_cmd = v_layer_set_value_create(node->id, layer->id, value->id,
-			layer->data_type, layer->num_vec_comp, value->value);
+	if(layer_subscriber->delta != NULL) {
+		set_value_cmd = vs_layer_set_delta_create(layer_subscriber, node,
+				layer, item_id, value);
+	} else {
+		set_value_cmd = vs_layer_set_value_create(node, layer, item_id, value,
+				layer_subscriber->precision);
+	}
 
 	if(set_value_cmd != NULL) {
 		return v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
@@ -608,6 +803,11 @@ int vs_handle_layer_create(struct VS_CTX *vs_ctx,
 
 	layer->state = ENTITY_CREATING;
 
+	vs_persist_layer_create(vs_ctx, node, layer);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
 	ret = 1;
 
 	/* Send layer_create to all node subscribers */
@@ -673,6 +873,9 @@ int vs_handle_layer_destroy_ack(struct VS_CTX *vs_ctx,
 	if(layer->layer_folls.first == NULL) {
 		layer->state = ENTITY_DELETED;
 		vs_layer_destroy(node, layer);
+#ifdef WITH_MONGODB
+		vs_mongo_node_dirty(vs_ctx, node);
+#endif
 	}
 
 end:
@@ -736,12 +939,47 @@ int vs_handle_layer_destroy(struct VS_CTX *vs_ctx,
 
 	ret = vs_layer_send_destroy(node, layer);
 
+	vs_persist_layer_destroy(vs_ctx, node, layer);
+
 end:
 	pthread_mutex_unlock(&node->mutex);
 
 	return ret;
 }
 
+/**
+ * \brief This function sends values of items changed since version held by
+ * client. Items, that were destroyed since this version, are unset.
+ */
+static void vs_layer_send_changes(struct VSEntitySubscriber *layer_subscriber,
+		struct VSNode *node,
+		struct VSLayer *layer,
+		struct VSJournalChange *changes,
+		int change_count)
+{
+	struct Generic_Cmd *unset_value_cmd;
+	void *value;
+	int i;
+
+	for(i = 0; i < change_count; i++) {
+		value = vs_layer_values_find(&layer->values, changes[i].item_id);
+		if(value != NULL) {
+			vs_layer_send_set_value(layer_subscriber, node, layer,
+					changes[i].item_id, value);
+		} else if(changes[i].created == 0) {
+			/* Client has value of item, that does not exist any more */
+			unset_value_cmd = v_layer_unset_value_create(node->id, layer->id,
+					changes[i].item_id);
+			if(unset_value_cmd != NULL) {
+				v_out_queue_push_tail(layer_subscriber->node_sub->session->out_queue,
+						0,
+						layer_subscriber->node_sub->prio,
+						unset_value_cmd);
+			}
+		}
+	}
+}
+
 int vs_handle_layer_subscribe(struct VS_CTX *vs_ctx,
 		struct VSession *vsession,
 		struct Generic_Cmd *layer_subscribe_cmd)
@@ -750,12 +988,15 @@ int vs_handle_layer_subscribe(struct VS_CTX *vs_ctx,
 	struct VSLayer *layer;
 	struct VSNodeSubscriber *node_subscriber;
 	struct VSEntitySubscriber *layer_subscriber;
-	struct VBucket *vbucket;
-	struct VSLayerValue *value;
+	uint32 i;
 	uint32 node_id = UINT32(layer_subscribe_cmd->data[0]);
 	uint16 layer_id = UINT16(layer_subscribe_cmd->data[UINT32_SIZE]);
-/*	uint32 version = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE]);
-	uint32 crc32 = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]); */
+	uint32 version = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE]);
+	uint8 precision = UINT8(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE]);
+	uint8 flags = UINT8(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE]);
+	uint32 epoch = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE+UINT8_SIZE+UINT8_SIZE]);
+	struct VSJournalChange *changes;
+	int change_count;
 	int ret = 0;
 
 	/* Try to find node */
@@ -830,15 +1071,39 @@ int vs_handle_layer_subscribe(struct VS_CTX *vs_ctx,
 	/* Add new subscriber to the list of layer subscribers */
 	layer_subscriber = (struct VSEntitySubscriber*)malloc(sizeof(struct VSEntitySubscriber));
 	layer_subscriber->node_sub = node_subscriber;
+	layer_subscriber->precision = (precision == VRS_LAYER_PRECISION_REAL16) ?
+			VRS_LAYER_PRECISION_REAL16 : VRS_LAYER_PRECISION_FULL;
+	layer_subscriber->delta = NULL;
+	if(flags & LAYER_SUBSCRIBE_DELTA) {
+		layer_subscriber->delta = vs_delta_create(vs_layer_value_size(layer,
+				layer_subscriber->precision));
+	}
 	v_list_add_tail(&layer->layer_subs, layer_subscriber);
 	ret = 1;
 
-	vbucket = layer->values.lb.first;
+	/* When client holds version covered by journal, then send only items
+	 * changed since this version */
+	if(version != 0) {
+		change_count = vs_journal_changes(&layer->journal, epoch, version,
+				layer->version, &changes);
+		if(change_count >= 0) {
+			v_print_log(VRS_PRINT_DEBUG_MSG,
+					"%s() sending %d changes of layer (id: %d) since version: %u\n",
+					__func__, change_count, layer->id, version);
+			vs_layer_send_changes(layer_subscriber, node, layer,
+					changes, change_count);
+			if(changes != NULL) {
+				free(changes);
+			}
+			goto end;
+		}
+	}
+
 	/* Send value_set cmd for all items in this layer */
-	while(vbucket != NULL) {
-		value = (struct VSLayerValue*)vbucket->data;
-		vs_layer_send_set_value(layer_subscriber, node, layer, value);
-		vbucket = vbucket->next;
+	for(i = 0; i < layer->values.count; i++) {
+		vs_layer_send_set_value(layer_subscriber, node, layer,
+				layer->values.ids[i],
+				vs_layer_values_at(&layer->values, i));
 	}
 
 end:
@@ -857,8 +1122,8 @@ int vs_handle_layer_unsubscribe(struct VS_CTX *vs_ctx,
 
 	uint32 node_id = UINT32(layer_unsubscribe_cmd->data[0]);
 	uint16 layer_id = UINT16(layer_unsubscribe_cmd->data[UINT32_SIZE]);
-/*	uint32 version = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE]);
-	uint32 crc32 = UINT32(layer_subscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE]); */
+	uint8 versing = UINT8(layer_unsubscribe_cmd->data[UINT32_SIZE+UINT16_SIZE+UINT32_SIZE+UINT32_SIZE]);
+	struct Generic_Cmd *unsubscribe_cmd;
 	int ret = 0;
 
 	/* Try to find node */
@@ -880,6 +1145,17 @@ int vs_handle_layer_unsubscribe(struct VS_CTX *vs_ctx,
 
 	ret = vs_layer_unsubscribe(layer, vsession);
 
+	/* When client requested versing, then send it version of layer, that
+	 * could be used for next subscribing */
+	if(ret == 1 && versing != 0) {
+		unsubscribe_cmd = v_layer_unsubscribe_create(node->id, layer->id,
+				layer->version, layer->crc32, 0, layer->journal.epoch);
+		if(unsubscribe_cmd != NULL) {
+			v_out_queue_push_tail(vsession->out_queue, 0,
+					VRS_DEFAULT_PRIORITY, unsubscribe_cmd);
+		}
+	}
+
 end:
 	pthread_mutex_unlock(&node->mutex);
 
@@ -933,11 +1209,9 @@ int vs_handle_layer_set_value(struct VS_CTX *vs_ctx,
 {
 	struct VSNode *node;
 	struct VSLayer *layer;
-	struct VSLayerValue *item, _item;
-	struct VBucket *vbucket;
-	struct VSEntitySubscriber *layer_subscriber;
+	void *value;
+	uint8 change_type;
 	int ret = 0;
-	int item_data_size;
 
 	uint32 node_id = UINT32(layer_set_value_cmd->data[0]);
 	uint16 layer_id = UINT16(layer_set_value_cmd->data[UINT32_SIZE]);
@@ -987,61 +1261,89 @@ int vs_handle_layer_set_value(struct VS_CTX *vs_ctx,
 	}
 
 	/* Set item value */
-
-	item_data_size = vs_layer_data_size(layer);
-	if(item_data_size > 0) {
-		/* Try to find item value first */
-		_item.id = item_id;
-		vbucket = v_hash_array_find_item(&layer->values, &_item);
-		if(vbucket == NULL) {
-			/* When this item doesn't exist yet, then allocate memory for this item
-			 * and add it to the hashed array */
-			item = calloc(1, sizeof(struct VSLayerValue));
-
-			if(item == NULL) {
-				v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
-				goto end;
-			}
-
-			item->id = item_id;
-
-			/* Allocate memory for values and copy data to this memory */
-			item->value = (void*)calloc(layer->num_vec_comp, item_data_size);
-			if(item->value != NULL) {
-				v_hash_array_add_item(&layer->values, item, sizeof(struct VSLayerValue));
-				memcpy(item->value,
-						&layer_set_value_cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE],
-						layer->num_vec_comp * item_data_size);
-			} else {
-				free(item);
-				item = NULL;
-				v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
-				goto end;
-			}
-		} else {
-			/* When data exist, then only change values */
-			item = (struct VSLayerValue*)vbucket->data;
-			memcpy(item->value,
-					&layer_set_value_cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE],
-					layer->num_vec_comp * item_data_size);
-		}
-	} else {
+	if(layer->values.value_size == 0) {
 		v_print_log(VRS_PRINT_ERROR, "Unsupported data type: %d\n",
 				layer->data_type);
 		goto end;
 	}
 
+	change_type = (vs_layer_values_find(&layer->values, item_id) != NULL) ?
+			JOURNAL_ITEM_CHANGE : JOURNAL_ITEM_CREATE;
+
+	value = vs_layer_values_set(&layer->values, item_id,
+			&layer_set_value_cmd->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE]);
+	if(value == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		goto end;
+	}
+
 	vs_layer_inc_version(layer);
+	vs_journal_add(&layer->journal, layer->version, item_id, change_type);
+
+	vs_persist_layer_set(vs_ctx, node, layer, item_id, value);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, node);
+#endif
 
 	ret = 1;
 
 	/* Send command layer_set_value to all layer subscribers */
-	layer_subscriber = layer->layer_subs.first;
-	while(layer_subscriber != NULL) {
-		if(vs_layer_send_set_value(layer_subscriber, node, layer, item) != 1) {
-			ret = 0;
+	if(layer->layer_subs.first != NULL) {
+		ret = vs_layer_send_value_to_subs(node, layer, item_id, value);
+	}
+
+end:
+	pthread_mutex_unlock(&node->mutex);
+
+	return ret;
+}
+
+/**
+ * \brief This function is called, when client acknowledge receiving of
+ * layer_set_delta command. Acknowledged value could be used as base value of
+ * next delta sent to this client.
+ */
+int vs_handle_layer_set_ack(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
+		struct Generic_Cmd *cmd)
+{
+	struct VSNode *node;
+	struct VSLayer *layer;
+	struct VSEntitySubscriber *layer_subscriber;
+	struct Layer_Set_Ack_Cmd *layer_set_ack = (struct Layer_Set_Ack_Cmd*)cmd;
+	int ret = 0;
+
+	/* Try to find node */
+	if((node = vs_node_find(vs_ctx, layer_set_ack->node_id)) == NULL) {
+		v_print_log(VRS_PRINT_DEBUG_MSG, "%s() node (id: %d) not found\n",
+				__func__, layer_set_ack->node_id);
+		return 0;
+	}
+
+	pthread_mutex_lock(&node->mutex);
+
+	/* Try to find layer */
+	if( (layer = vs_layer_find(node, layer_set_ack->layer_id)) == NULL) {
+		v_print_log(VRS_PRINT_DEBUG_MSG,
+				"%s() layer (id: %d) in node (id: %d) not found\n",
+				__func__,
+				layer_set_ack->layer_id,
+				layer_set_ack->node_id);
+		goto end;
+	}
+
+	for(layer_subscriber = layer->layer_subs.first;
+			layer_subscriber != NULL;
+			layer_subscriber = layer_subscriber->next)
+	{
+		if(layer_subscriber->node_sub->session->session_id == vsession->session_id) {
+			if(layer_subscriber->delta != NULL) {
+				vs_delta_ack(layer_subscriber->delta, vsession,
+						layer_set_ack->item_id, layer_set_ack->seq);
+				ret = 1;
+			}
+			break;
 		}
-		layer_subscriber = layer_subscriber->next;
 	}
 
 end:
@@ -1071,38 +1373,33 @@ static int vs_layer_unset_value(struct VSNode *node,
 		uint8 send_command)
 {
 	struct VSLayer *child_layer;
-	struct VSLayerValue *item = NULL, _item;
-	struct VBucket *vbucket;
 	struct VSEntitySubscriber *layer_subscriber;
+	struct Generic_Cmd *unset_value_cmd;
 
-	/* Try to find item value first */
-	_item.id = item_id;
-	vbucket = v_hash_array_find_item(&layer->values, &_item);
-	if(vbucket != NULL) {
-		item = (struct VSLayerValue*)vbucket->data;
-
+	/* Try to remove item value first */
+	if(vs_layer_values_unset(&layer->values, item_id) == 1) {
 		/* Send unset command only for parent layer */
-		if(send_command == 1) {
+		if(send_command == 1 && layer->layer_subs.first != NULL) {
 			/* Send item value unset to all layer subscribers */
-
-			layer_subscriber = layer->layer_subs.first;
-			while(layer_subscriber != NULL) {
-				vs_layer_send_unset_value(layer_subscriber, node, layer, item);
-				layer_subscriber = layer_subscriber->next;
+			unset_value_cmd = v_layer_unset_value_create(node->id, layer->id, item_id);
+			if(unset_value_cmd != NULL) {
+				vs_layer_send_cmd_to_subs(layer, unset_value_cmd);
 			}
 		}
-
-		/* Free value */
-		free(item->value);
-		/* Remove value from hashed array */
-		v_hash_array_remove_item(&layer->values, item);
-		/* Free item */
-		free(item);
+		/* Forget state of delta coding of this item */
+		layer_subscriber = layer->layer_subs.first;
+		while(layer_subscriber != NULL) {
+			if(layer_subscriber->delta != NULL) {
+				vs_delta_remove(layer_subscriber->delta, item_id);
+			}
+			layer_subscriber = layer_subscriber->next;
+		}
 	} else {
 		return 0;
 	}
 
 	vs_layer_inc_version(layer);
+	vs_journal_add(&layer->journal, layer->version, item_id, JOURNAL_ITEM_DESTROY);
 
 	/* Try to unset values in all child values, but don't send unset_value command
 	 * about this unsetting, because client will receive layer_unset of parent
@@ -1160,6 +1457,13 @@ int vs_handle_layer_unset_value(struct VS_CTX *vs_ctx,
 
 	ret = vs_layer_unset_value(node, layer, item_id, 1);
 
+	if(ret == 1) {
+		vs_persist_layer_unset(vs_ctx, node, layer, item_id);
+#ifdef WITH_MONGODB
+		vs_mongo_node_dirty(vs_ctx, node);
+#endif
+	}
+
 end:
 	pthread_mutex_unlock(&node->mutex);
 
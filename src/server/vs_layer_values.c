@@ -0,0 +1,410 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "v_common.h"
+
+#include "vs_layer_values.h"
+
+/**
+ * \brief This function computes hash of item ID
+ */
+static uint32 vs_layer_values_hash(uint32 item_id)
+{
+	item_id ^= item_id >> 16;
+	item_id *= 0x85ebca6b;
+	item_id ^= item_id >> 13;
+	item_id *= 0xc2b2ae35;
+	item_id ^= item_id >> 16;
+
+	return item_id;
+}
+
+/**
+ * \brief This function tries to find slot of sparse index with item ID
+ * \return This function returns index of slot with item or index of empty
+ * slot, where item could be added.
+ */
+static uint32 vs_layer_values_slot(struct VSLayerValues *values,
+		uint32 item_id)
+{
+	uint32 mask = values->index_length - 1;
+	uint32 i;
+
+	for(i = vs_layer_values_hash(item_id) & mask;
+			values->index[i] != 0;
+			i = (i + 1) & mask)
+	{
+		if(values->ids[values->index[i] - 1] == item_id) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+/**
+ * \brief This function tries to find position of item in dense array of IDs.
+ * It is used by small layer without sparse index.
+ * \return This function returns position of item + 1 or 0, when item is not
+ * set.
+ */
+static uint32 vs_layer_values_scan(struct VSLayerValues *values,
+		uint32 item_id)
+{
+	uint32 pos;
+
+	for(pos = 0; pos < values->count; pos++) {
+		if(values->ids[pos] == item_id) {
+			return pos + 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief This function rebuilds sparse index with new length
+ */
+static int vs_layer_values_reindex(struct VSLayerValues *values,
+		uint32 index_length)
+{
+	uint32 *index, mask = index_length - 1;
+	uint32 pos, i;
+
+	index = (uint32*)calloc(index_length, sizeof(uint32));
+	if(index == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return 0;
+	}
+
+	for(pos = 0; pos < values->count; pos++) {
+		for(i = vs_layer_values_hash(values->ids[pos]) & mask;
+				index[i] != 0;
+				i = (i + 1) & mask) {}
+		index[i] = pos + 1;
+	}
+
+	free(values->index);
+	values->index = index;
+	values->index_length = index_length;
+
+	return 1;
+}
+
+/**
+ * \brief This function makes sure, that there is space for one new item
+ */
+static int vs_layer_values_reserve(struct VSLayerValues *values)
+{
+	if(values->count == values->length) {
+		uint32 length = (values->length == 0) ? LAYER_VALUES_MIN_LENGTH : 2 * values->length;
+		uint32 *ids;
+		uint8 *data;
+
+		ids = (uint32*)realloc(values->ids, length * sizeof(uint32));
+		if(ids == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+			return 0;
+		}
+		values->ids = ids;
+
+		data = (uint8*)realloc(values->data, (size_t)length * values->value_size);
+		if(data == NULL) {
+			v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+			return 0;
+		}
+		values->data = data;
+
+		values->length = length;
+	}
+
+	/* Load factor of sparse index is kept under 1/2. Small layer doesn't
+	 * need sparse index. */
+	if(values->count + 1 > LAYER_VALUES_SMALL_COUNT &&
+			2 * ((uint64)values->count + 1) > values->index_length)
+	{
+		uint32 index_length = (values->index_length == 0) ?
+				4 * LAYER_VALUES_SMALL_COUNT : 2 * values->index_length;
+
+		if(vs_layer_values_reindex(values, index_length) != 1) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function initializes empty storage of layer items. No memory
+ * is allocated until first item is set.
+ *
+ * \param[out]	*values		The pointer at storage
+ * \param[in]	value_size	The size of one item value in bytes
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+int vs_layer_values_init(struct VSLayerValues *values, uint16 value_size)
+{
+	values->ids = NULL;
+	values->data = NULL;
+	values->count = 0;
+	values->length = 0;
+	values->index = NULL;
+	values->index_length = 0;
+	values->value_size = value_size;
+
+	return (value_size > 0) ? 1 : 0;
+}
+
+/**
+ * \brief This function frees all items of layer
+ */
+void vs_layer_values_destroy(struct VSLayerValues *values)
+{
+	if(values->ids != NULL) free(values->ids);
+	if(values->data != NULL) free(values->data);
+	if(values->index != NULL) free(values->index);
+
+	values->ids = NULL;
+	values->data = NULL;
+	values->index = NULL;
+	values->count = 0;
+	values->length = 0;
+	values->index_length = 0;
+}
+
+/**
+ * \brief This function tries to find value of item
+ *
+ * \return This function returns pointer at value of item or NULL, when item
+ * is not set.
+ */
+void *vs_layer_values_find(struct VSLayerValues *values, uint32 item_id)
+{
+	uint32 slot, pos;
+
+	if(values->count == 0) {
+		return NULL;
+	}
+
+	if(values->index == NULL) {
+		pos = vs_layer_values_scan(values, item_id);
+		return (pos != 0) ? vs_layer_values_at(values, pos - 1) : NULL;
+	}
+
+	slot = vs_layer_values_slot(values, item_id);
+
+	if(values->index[slot] == 0) {
+		return NULL;
+	}
+
+	return vs_layer_values_at(values, values->index[slot] - 1);
+}
+
+/**
+ * \brief This function sets value of item. New item is added, when item with
+ * this ID is not set yet.
+ *
+ * \param[in]	*values		The pointer at storage
+ * \param[in]	item_id		The ID of item
+ * \param[in]	*value		The pointer at new value (value_size bytes)
+ *
+ * \return This function returns pointer at stored value or NULL, when it was
+ * not possible to allocate memory for new item.
+ */
+void *vs_layer_values_set(struct VSLayerValues *values,
+		uint32 item_id,
+		const void *value)
+{
+	void *item_value;
+	uint32 slot, pos;
+
+	if(values->count > 0) {
+		if(values->index == NULL) {
+			pos = vs_layer_values_scan(values, item_id);
+		} else {
+			pos = values->index[vs_layer_values_slot(values, item_id)];
+		}
+		if(pos != 0) {
+			/* When item exists, then only change value */
+			item_value = vs_layer_values_at(values, pos - 1);
+			memcpy(item_value, value, values->value_size);
+			return item_value;
+		}
+	}
+
+	if(vs_layer_values_reserve(values) != 1) {
+		return NULL;
+	}
+
+	/* Add new item at the end of dense arrays */
+	pos = values->count;
+	values->ids[pos] = item_id;
+	item_value = vs_layer_values_at(values, pos);
+	memcpy(item_value, value, values->value_size);
+
+	if(values->index != NULL) {
+		slot = vs_layer_values_slot(values, item_id);
+		values->index[slot] = pos + 1;
+	}
+
+	values->count++;
+
+	return item_value;
+}
+
+/**
+ * \brief This function unsets (removes) item.
+ *
+ * \return This function returns 1, when item was removed and it returns 0,
+ * when item was not set.
+ */
+int vs_layer_values_unset(struct VSLayerValues *values, uint32 item_id)
+{
+	uint32 mask, slot, i, j, k, pos, last;
+
+	if(values->count == 0) {
+		return 0;
+	}
+
+	last = values->count - 1;
+
+	if(values->index == NULL) {
+		/* Small layer: move the last item to the free position */
+		pos = vs_layer_values_scan(values, item_id);
+		if(pos == 0) {
+			return 0;
+		}
+		pos--;
+		if(pos != last) {
+			values->ids[pos] = values->ids[last];
+			memcpy(vs_layer_values_at(values, pos),
+					vs_layer_values_at(values, last),
+					values->value_size);
+		}
+		goto end;
+	}
+
+	slot = vs_layer_values_slot(values, item_id);
+	if(values->index[slot] == 0) {
+		return 0;
+	}
+
+	pos = values->index[slot] - 1;
+
+	/* Remove slot from sparse index and shift back following slots of
+	 * the same cluster */
+	mask = values->index_length - 1;
+	i = j = slot;
+	while(1) {
+		j = (j + 1) & mask;
+		if(values->index[j] == 0) {
+			break;
+		}
+		k = vs_layer_values_hash(values->ids[values->index[j] - 1]) & mask;
+		if( (i <= j) ? (i < k && k <= j) : (i < k || k <= j) ) {
+			continue;
+		}
+		values->index[i] = values->index[j];
+		i = j;
+	}
+	values->index[i] = 0;
+
+	/* Move the last item to the free position */
+	if(pos != last) {
+		values->ids[pos] = values->ids[last];
+		memcpy(vs_layer_values_at(values, pos),
+				vs_layer_values_at(values, last),
+				values->value_size);
+		slot = vs_layer_values_slot(values, values->ids[pos]);
+		values->index[slot] = pos + 1;
+	}
+
+end:
+	values->count--;
+
+	if(values->count == 0) {
+		vs_layer_values_destroy(values);
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function loads all items to the empty storage at once. It is
+ * used, when layer is restored from snapshot. Arrays are copied and sparse
+ * index is built only once.
+ *
+ * \param[out]	*values		The pointer at empty storage
+ * \param[in]	*ids		The array of item IDs (unique)
+ * \param[in]	*data		The array of item values
+ * \param[in]	count		The number of items
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+int vs_layer_values_load(struct VSLayerValues *values,
+		const uint32 *ids,
+		const void *data,
+		uint32 count)
+{
+	uint32 length = (count < LAYER_VALUES_MIN_LENGTH) ? LAYER_VALUES_MIN_LENGTH : count;
+	uint32 index_length;
+
+	if(values->count != 0) {
+		return 0;
+	}
+
+	if(count == 0) {
+		return 1;
+	}
+
+	values->ids = (uint32*)malloc(length * sizeof(uint32));
+	values->data = (uint8*)malloc((size_t)length * values->value_size);
+	if(values->ids == NULL || values->data == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		vs_layer_values_destroy(values);
+		return 0;
+	}
+
+	memcpy(values->ids, ids, count * sizeof(uint32));
+	memcpy(values->data, data, (size_t)count * values->value_size);
+	values->count = count;
+	values->length = length;
+
+	if(count > LAYER_VALUES_SMALL_COUNT) {
+		/* Keep load factor of sparse index under 1/2 */
+		for(index_length = 4 * LAYER_VALUES_SMALL_COUNT;
+				index_length < 2 * count;
+				index_length *= 2) {}
+		if(vs_layer_values_reindex(values, index_length) != 1) {
+			vs_layer_values_destroy(values);
+			return 0;
+		}
+	}
+
+	return 1;
+}
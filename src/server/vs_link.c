@@ -31,6 +31,7 @@
 #include "vs_node.h"
 #include "vs_node_access.h"
 #include "vs_link.h"
+#include "vs_persist.h"
 
 /**
  * \brief This function test two nodes, if parent node could be parent of child
@@ -80,7 +81,9 @@ static void vs_link_update_child(struct VSNode *parent_node,
 
 	/* Update properties of child node */
 	child_node->level = parent_node->level + 1;
-	child_node->flags = parent_node->flags;
+	/* Only saveable flag is inherited, loading state is own to each node */
+	child_node->flags = (child_node->flags & ~VS_NODE_SAVEABLE) |
+			(parent_node->flags & VS_NODE_SAVEABLE);
 
 	link = parent_node->children_links.first;
 
@@ -113,6 +116,8 @@ struct VSLink *vs_link_create(struct VSNode *parent, struct VSNode *child)
 		child->parent_link = link;
 		child->level = parent->level + 1;
 		vs_node_inc_version(parent);
+		vs_journal_add(&parent->child_journal, parent->version,
+				child->id, JOURNAL_ITEM_CREATE);
 		vs_node_inc_version(child);
 	} else {
 		v_print_log(VRS_PRINT_WARNING,
@@ -246,8 +251,20 @@ int vs_handle_link_change(struct VS_CTX *vs_ctx,
 
 	/* Update version in child node, parent node and old parent node */
 	vs_node_inc_version(parent_node);
+	vs_journal_add(&parent_node->child_journal, parent_node->version,
+			child_node->id, JOURNAL_ITEM_CREATE);
 	vs_node_inc_version(child_node);
 	vs_node_inc_version(old_parent_node);
+	vs_journal_add(&old_parent_node->child_journal, old_parent_node->version,
+			child_node->id, JOURNAL_ITEM_DESTROY);
+
+	vs_persist_node_link(vs_ctx, child_node);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, parent_node);
+	vs_mongo_node_dirty(vs_ctx, old_parent_node);
+	/* Child nodes could become saveable */
+	vs_mongo_branch_dirty(vs_ctx, child_node);
+#endif
 
 	/* Subscribers of old and new parent node will receive information about
 	 * changing link between nodes. Prevent double sending command Node_Link,
@@ -38,9 +38,11 @@
 #include "vs_udp_connect.h"
 #include "vs_auth_csv.h"
 #include "vs_data.h"
+#include "vs_dgram_worker.h"
 #include "vs_node.h"
 #include "vs_sys_nodes.h"
 #include "vs_user.h"
+#include "vs_persist.h"
 
 #ifdef WITH_MONGODB
 #include "vs_mongo_main.h"
@@ -53,6 +55,7 @@
 #include "v_common.h"
 #include "v_session.h"
 #include "v_network.h"
+#include "v_slab.h"
 
 
 struct VS_CTX *local_vs_ctx = NULL;
@@ -210,7 +213,8 @@ static void vs_init(struct VS_CTX *vs_ctx)
 
 	vs_ctx->default_perm = VRS_PERM_NODE_READ;
 
-	vs_ctx->cc_meth = CC_NONE;		/* "List" of allowed methods of Congestion Control */
+	vs_ctx->cc_meth = CC_TCP_LIKE;	/* "List" of allowed methods of Congestion Control */
+	vs_ctx->cc_alg = DEFAULT_CC_ALG;	/* Algorithm of TCP like Congestion Control */
 	vs_ctx->fc_meth = FC_TCP_LIKE;	/* "List" of allowed methods of Flow Control */
 
 	vs_ctx->cmd_cmpr = CMPR_ADDR_SHARE;
@@ -220,6 +224,14 @@ static void vs_init(struct VS_CTX *vs_ctx)
 	vs_ctx->in_queue_max_size = 1048576;	/* 1MB */
 	vs_ctx->out_queue_max_size = 1048576;	/* 1MB */
 
+	vs_ctx->data_threads = DEFAULT_DATA_THREAD_COUNT;
+
+	vs_ctx->dgram_threads = DEFAULT_DGRAM_THREAD_COUNT;
+	vs_ctx->dgram_shared_port = 0;			/* Each connection uses port from port range */
+	vs_ctx->dgram_demux = NULL;
+	vs_ctx->dgram_workers = NULL;
+	vs_ctx->dgram_worker_count = 0;
+
 	vs_ctx->tls_ctx = NULL;
 	vs_ctx->dtls_ctx = NULL;
 	
@@ -234,6 +246,14 @@ static void vs_init(struct VS_CTX *vs_ctx)
 	vs_ctx->data.avatar_node = NULL;
 
 	vs_ctx->data.sem = NULL;
+	vs_ctx->data.shards = NULL;
+	vs_ctx->data.shard_count = 0;
+	vs_ctx->data.ready_sessions.cells = NULL;
+
+	vs_ctx->persist_engine = PERSIST_ENGINE_NONE;
+	vs_ctx->persist_dir = strdup(PERSIST_DIRECTORY);
+	vs_ctx->persist_snapshot_interval = PERSIST_SNAPSHOT_INTERVAL;
+	vs_ctx->persist = NULL;
 
 #if WITH_MONGODB
 	vs_ctx->mongo_conn = NULL;
@@ -245,6 +265,9 @@ static void vs_init(struct VS_CTX *vs_ctx)
 	vs_ctx->mongo_node_ns = NULL;
 	vs_ctx->mongo_tg_ns = NULL;
 	vs_ctx->mongo_layer_ns = NULL;
+	vs_ctx->mongodb_save_interval = MONGO_SAVE_INTERVAL;
+	vs_ctx->mongodb_save_batch = MONGO_SAVE_BATCH_SIZE;
+	vs_ctx->mongodb_evict_time = MONGO_EVICT_TIME;
 #endif
 }
 
@@ -327,6 +350,8 @@ static void vs_destroy_ctx(struct VS_CTX *vs_ctx)
 		vs_ctx->vsessions = NULL;
 	}
 
+	v_ready_ring_destroy(&vs_ctx->data.ready_sessions);
+
 	if(vs_ctx->port_list != NULL) {
 		free(vs_ctx->port_list);
 		vs_ctx->port_list = NULL;
@@ -383,6 +408,11 @@ static void vs_destroy_ctx(struct VS_CTX *vs_ctx)
 	vs_destroy_stream_ctx(vs_ctx);
 #endif
 
+	if(vs_ctx->persist_dir != NULL) {
+		free(vs_ctx->persist_dir);
+		vs_ctx->persist_dir = NULL;
+	}
+
 #ifdef WITH_MONGODB
 	if(vs_ctx->mongodb_server != NULL) {
 		free(vs_ctx->mongodb_server);
@@ -665,9 +695,9 @@ int main(int argc, char *argv[])
 			exit(EXIT_FAILURE);
 	}
 
-	/* Initialize data mutex */
-	if( pthread_mutex_init(&vs_ctx.data.mutex, NULL) != 0) {
-		v_print_log(VRS_PRINT_ERROR, "pthread_mutex_init(): failed\n");
+	/* Initialize data lock */
+	if( pthread_rwlock_init(&vs_ctx.data.lock, NULL) != 0) {
+		v_print_log(VRS_PRINT_ERROR, "pthread_rwlock_init(): failed\n");
 		vs_destroy_ctx(&vs_ctx);
 		exit(EXIT_FAILURE);
 	}
@@ -691,6 +721,15 @@ int main(int argc, char *argv[])
 	}
 #endif
 
+	/* Try to recover shared data from snapshot and write-ahead log */
+	if(vs_ctx.persist_engine == PERSIST_ENGINE_WAL) {
+		if(vs_persist_init(&vs_ctx) != 1) {
+			v_print_log(VRS_PRINT_ERROR, "vs_persist_init(): failed\n");
+			vs_destroy_ctx(&vs_ctx);
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	if(vs_ctx.stream_protocol == TCP) {
 		/* Initialize Verse server context */
 		if(vs_init_stream_ctx(&vs_ctx) == -1) {
@@ -727,6 +766,22 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 
+	/* Try to create data shards (worker threads handling node commands) */
+	if(vs_data_shards_init(&vs_ctx) != 1) {
+		v_print_log(VRS_PRINT_ERROR, "vs_data_shards_init(): failed\n");
+		vs_destroy_ctx(&vs_ctx);
+		exit(EXIT_FAILURE);
+	}
+
+#ifdef WITH_EPOLL
+	/* Try to create datagram workers (threads handling UDP connections) */
+	if(vs_dgram_workers_init(&vs_ctx) != 1) {
+		v_print_log(VRS_PRINT_ERROR, "vs_dgram_workers_init(): failed\n");
+		vs_destroy_ctx(&vs_ctx);
+		exit(EXIT_FAILURE);
+	}
+#endif
+
 	/* Try to create new data thread */
 	if(pthread_create(&vs_ctx.data_thread, NULL, vs_data_loop, (void*)&vs_ctx) != 0) {
 		v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
@@ -743,14 +798,26 @@ int main(int argc, char *argv[])
 		}
 	}
 
-#if 0
-	if(pthread_create(&vs_ctx.save_thread, NULL, vs_mongo_save_loop, (void*)&vs_ctx) != 0) {
-		v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
-		vs_destroy_ctx(&vs_ctx);
-		exit(EXIT_FAILURE);
+#ifdef WITH_MONGODB
+	/* Try to create thread for continuous saving of data to MongoDB */
+	if(vs_ctx.mongo_conn != NULL) {
+		if(pthread_create(&vs_ctx.save_thread, NULL, vs_mongo_save_loop, (void*)&vs_ctx) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
+			vs_destroy_ctx(&vs_ctx);
+			exit(EXIT_FAILURE);
+		}
 	}
 #endif
 
+	/* Try to create thread flushing write-ahead log and writing snapshots */
+	if(vs_ctx.persist != NULL) {
+		if(pthread_create(&vs_ctx.persist->thread, NULL, vs_persist_loop, (void*)&vs_ctx) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_create(): %s\n", strerror(errno));
+			vs_destroy_ctx(&vs_ctx);
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	/* Set up pointer to local server CTX -> server server could be terminated
 	 * with signal now. */
 	local_vs_ctx = &vs_ctx;
@@ -769,14 +836,35 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 
+#ifdef WITH_EPOLL
+	/* Stop datagram workers */
+	vs_dgram_workers_destroy(&vs_ctx);
+#endif
+
 #ifdef WITH_MONGODB
 	/* Try to save data and disconnect from MongoDB server */
 	if(vs_ctx.mongo_conn != NULL) {
+		/* Saving thread has to finish writing of last batch */
+		if(pthread_join(vs_ctx.save_thread, &res) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_join(): %s\n", strerror(errno));
+		}
+		/* Save only changes, that were not saved yet */
 		vs_mongo_context_save(&vs_ctx);
 		vs_mongo_conn_destroy(&vs_ctx);
 	}
 #endif
 
+	/* Write final snapshot and close write-ahead log */
+	if(vs_ctx.persist != NULL) {
+		if(pthread_join(vs_ctx.persist->thread, &res) != 0) {
+			v_print_log(VRS_PRINT_ERROR, "pthread_join(): %s\n", strerror(errno));
+		}
+		vs_persist_destroy(&vs_ctx);
+	}
+
+	/* Print statistics of memory pools used for commands and queues */
+	v_slab_print_stats(VRS_PRINT_DEBUG_MSG);
+
 	/* Free Verse server context */
 	vs_destroy_ctx(&vs_ctx);
 
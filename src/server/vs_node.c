@@ -29,6 +29,8 @@
 #include "v_list.h"
 #include "v_common.h"
 #include "v_node_commands.h"
+#include "v_taggroup_commands.h"
+#include "v_layer_commands.h"
 
 #include "vs_main.h"
 #include "vs_node.h"
@@ -39,9 +41,14 @@
 #include "vs_taggroup.h"
 #include "vs_tag.h"
 #include "vs_layer.h"
+#include "vs_persist.h"
 
 #include "v_fake_commands.h"
 
+#ifdef WITH_MONGODB
+#include "vs_mongo_node.h"
+#endif
+
 static int vs_node_send_destroy(struct VSNode *node);
 
 /**
@@ -128,6 +135,17 @@ static int vs_node_unsubscribe(struct VSNode *node,
 			_node_subscriber = _next_node_subscriber;
 		}
 
+		/* Remove client from followers of child node, because node follower
+		 * relay on node subscriber of this node */
+		node_follower = child_node->node_folls.first;
+		while(node_follower != NULL) {
+			if(node_follower->node_sub == node_subscriber) {
+				v_list_free_item(&child_node->node_folls, node_follower);
+				break;
+			}
+			node_follower = node_follower->next;
+		}
+
 		link = link->next;
 	}
 
@@ -191,6 +209,13 @@ static int vs_node_unsubscribe(struct VSNode *node,
 	/* Finally remove this session from list of node subscribers */
 	v_list_free_item(&node->node_subs, node_subscriber);
 
+#ifdef WITH_MONGODB
+	/* Node could be evicted from memory after some time */
+	if(node->node_subs.first == NULL) {
+		node->idle_since = time(NULL);
+	}
+#endif
+
 	return 1;
 }
 
@@ -236,13 +261,194 @@ int vs_node_send_data(struct VSNode *node,
 }
 
 
+/**
+ * \brief This function adds subscriber to the list of followers of entity,
+ * that is already known by the client, without sending create command.
+ */
+static void vs_node_follow_entity(struct VListBase *folls,
+		struct VSNodeSubscriber *node_subscriber)
+{
+	struct VSEntityFollower *follower;
+
+	for(follower = folls->first; follower != NULL; follower = follower->next) {
+		if(follower->node_sub->session->session_id == node_subscriber->session->session_id) {
+			return;
+		}
+	}
+
+	follower = (struct VSEntityFollower*)calloc(1, sizeof(struct VSEntityFollower));
+	if(follower != NULL) {
+		follower->node_sub = node_subscriber;
+		follower->state = ENTITY_CREATED;
+		v_list_add_tail(folls, follower);
+	}
+}
+
+/**
+ * \brief This function puts command to the outgoing queue of subscriber
+ */
+static void vs_node_send_cmd(struct VSNodeSubscriber *node_subscriber,
+		struct Generic_Cmd *cmd)
+{
+	if(cmd != NULL) {
+		v_out_queue_push_tail(node_subscriber->session->out_queue,
+				0,
+				node_subscriber->prio,
+				cmd);
+	}
+}
+
+/**
+ * \brief This function sends only child nodes, tag groups and layers created
+ * or removed since version held by subscriber. Entities, that were not
+ * changed, are marked as known by the client without sending create command.
+ *
+ * \return This function returns 1, when changes were sent. It returns 0, when
+ * journals of node don't cover this version (or epoch doesn't match) and all
+ * data have to be sent.
+ */
+static int vs_node_send_changes(struct VS_CTX *vs_ctx,
+		struct VSNodeSubscriber *node_subscriber,
+		struct VSNode *node,
+		uint32 epoch,
+		uint32 version)
+{
+	struct VSJournalChange *child_changes = NULL, *tg_changes = NULL,
+			*layer_changes = NULL, *change;
+	struct VSNode *child_node;
+	struct VSLink *link;
+	struct VBucket *bucket;
+	struct VSTagGroup *tg, find_tg;
+	struct VSLayer *layer, find_layer;
+	int child_count, tg_count, layer_count, i, ret = 0;
+
+	child_count = vs_journal_changes(&node->child_journal, epoch, version,
+			node->version, &child_changes);
+	tg_count = vs_journal_changes(&node->tg_journal, epoch, version,
+			node->version, &tg_changes);
+	layer_count = vs_journal_changes(&node->layer_journal, epoch, version,
+			node->version, &layer_changes);
+
+	if(child_count < 0 || tg_count < 0 || layer_count < 0) {
+		goto end;
+	}
+
+	v_print_log(VRS_PRINT_DEBUG_MSG,
+			"%s() sending %d changes of node (id: %d) since version: %u\n",
+			__func__, child_count + tg_count + layer_count, node->id, version);
+
+	/* Child nodes. Client knows child nodes linked before its version */
+	for(link = node->children_links.first; link != NULL; link = link->next) {
+		child_node = link->child;
+		change = vs_journal_find_change(child_changes, child_count, child_node->id);
+		if(change != NULL && change->created == 1) {
+			vs_node_send_create(node_subscriber, child_node, NULL);
+		} else if(child_node->state == ENTITY_CREATING ||
+				child_node->state == ENTITY_CREATED) {
+			vs_node_follow_entity(&child_node->node_folls, node_subscriber);
+		} else if(child_node->state == ENTITY_DELETING) {
+			vs_node_send_cmd(node_subscriber, v_node_destroy_create(child_node->id));
+		}
+	}
+
+	/* Child nodes, that were destroyed or linked to other node */
+	for(i = 0; i < child_count; i++) {
+		if(child_changes[i].created == 1) {
+			continue;
+		}
+		child_node = vs_node_find(vs_ctx, child_changes[i].item_id);
+		if(child_node == NULL) {
+			vs_node_send_cmd(node_subscriber,
+					v_node_destroy_create(child_changes[i].item_id));
+		} else if(child_node->parent_link != NULL &&
+				child_node->parent_link->parent != node) {
+			vs_node_send_cmd(node_subscriber,
+					v_node_link_create(child_node->parent_link->parent->id,
+							child_node->id));
+		}
+	}
+
+	/* Tag groups. ID of destroyed tag group could be used by new one */
+	for(bucket = node->tag_groups.lb.first; bucket != NULL; bucket = bucket->next) {
+		tg = (struct VSTagGroup*)bucket->data;
+		change = vs_journal_find_change(tg_changes, tg_count, tg->id);
+		if(change != NULL && (change->created == 1 || change->destroyed == 1)) {
+			if(change->created == 0) {
+				vs_node_send_cmd(node_subscriber,
+						v_taggroup_destroy_create(node->id, tg->id));
+			}
+			vs_taggroup_send_create(node_subscriber, node, tg);
+		} else if(tg->state == ENTITY_CREATING || tg->state == ENTITY_CREATED) {
+			vs_node_follow_entity(&tg->tg_folls, node_subscriber);
+		} else if(tg->state == ENTITY_DELETING) {
+			vs_node_send_cmd(node_subscriber,
+					v_taggroup_destroy_create(node->id, tg->id));
+		}
+	}
+
+	for(i = 0; i < tg_count; i++) {
+		find_tg.id = (uint16)tg_changes[i].item_id;
+		if(tg_changes[i].created == 0 &&
+				v_hash_array_find_item(&node->tag_groups, &find_tg) == NULL)
+		{
+			vs_node_send_cmd(node_subscriber,
+					v_taggroup_destroy_create(node->id, find_tg.id));
+		}
+	}
+
+	/* Layers. ID of destroyed layer could be used by new one */
+	for(bucket = node->layers.lb.first; bucket != NULL; bucket = bucket->next) {
+		layer = (struct VSLayer*)bucket->data;
+		change = vs_journal_find_change(layer_changes, layer_count, layer->id);
+		if(change != NULL && (change->created == 1 || change->destroyed == 1)) {
+			if(change->created == 0) {
+				vs_node_send_cmd(node_subscriber,
+						v_layer_destroy_create(node->id, layer->id));
+			}
+			vs_layer_send_create(node_subscriber, node, layer);
+		} else if(layer->state == ENTITY_CREATING || layer->state == ENTITY_CREATED) {
+			vs_node_follow_entity(&layer->layer_folls, node_subscriber);
+		} else if(layer->state == ENTITY_DELETING) {
+			vs_node_send_cmd(node_subscriber,
+					v_layer_destroy_create(node->id, layer->id));
+		}
+	}
+
+	for(i = 0; i < layer_count; i++) {
+		find_layer.id = (uint16)layer_changes[i].item_id;
+		if(layer_changes[i].created == 0 &&
+				v_hash_array_find_item(&node->layers, &find_layer) == NULL)
+		{
+			vs_node_send_cmd(node_subscriber,
+					v_layer_destroy_create(node->id, find_layer.id));
+		}
+	}
+
+	ret = 1;
+
+end:
+	if(child_changes != NULL) {
+		free(child_changes);
+	}
+	if(tg_changes != NULL) {
+		free(tg_changes);
+	}
+	if(layer_changes != NULL) {
+		free(layer_changes);
+	}
+
+	return ret;
+}
+
 /**
  * \brief This function add session (client) to the list of clients that are
  * subscribed this node.
  */
-static int vs_node_subscribe(struct VSession *vsession,
+static int vs_node_subscribe(struct VS_CTX *vs_ctx,
+		struct VSession *vsession,
 		struct VSNode *node,
-		uint32 version)
+		uint32 version,
+		uint32 epoch)
 {
 	struct VSNodePermission		*perm;
 	struct VSNodeSubscriber		*node_subscriber;
@@ -257,14 +463,6 @@ static int vs_node_subscribe(struct VSession *vsession,
 	node_subscriber->prio = VRS_DEFAULT_PRIORITY;
 	v_list_add_tail(&node->node_subs, node_subscriber);
 
-	/* TODO: send node_subscribe with version and commands with difference
-	 * between this version and current state, when versing will be supported */
-	if(version != 0) {
-		v_print_log(VRS_PRINT_WARNING,
-				"Version: %d != 0, versing is not supported yet\n", version);
-	}
-
-
 	/* If the node is locked, then send node_lock to the subscriber */
 	if(node->lock.session != NULL) {
 		vs_node_send_lock(node_subscriber, node->lock.session, node);
@@ -286,6 +484,14 @@ static int vs_node_subscribe(struct VSession *vsession,
 		return 0;
 	}
 
+	/* When client holds version covered by journals of node, then send only
+	 * child nodes, tag groups and layers changed since this version */
+	if(version != 0 &&
+			vs_node_send_changes(vs_ctx, node_subscriber, node, epoch, version) == 1)
+	{
+		return 1;
+	}
+
 	vs_node_send_data(node, node_subscriber);
 
 	return 1;
@@ -302,9 +508,25 @@ void vs_node_inc_version(struct VSNode *node)
 	} else {
 		node->version = 1;
 		node->saved_version = 0;
+		/* Journals can't be used for versions before overflow */
+		vs_node_journal_reset(node, node->version);
 	}
 }
 
+/**
+ * \brief This function drops all changes in journals of node. It has to be
+ * called, when version of node is changed without journals.
+ */
+void vs_node_journal_reset(struct VSNode *node, uint32 version)
+{
+	uint32 epoch = vs_journal_new_epoch();
+
+	/* All journals of node share one epoch */
+	vs_journal_reset(&node->child_journal, version, epoch);
+	vs_journal_reset(&node->tg_journal, version, epoch);
+	vs_journal_reset(&node->layer_journal, version, epoch);
+}
+
 /**
  * \brief This function sends Node_Create command to the subscriber of parent
  * node.
@@ -370,6 +592,11 @@ int vs_node_send_create(struct VSNodeSubscriber *node_subscriber,
 /**
  * \brief Try to find node using node_id
  *
+ * When tag groups and layers of node were evicted to MongoDB, then they are
+ * loaded by this function. Commands of such node are never handled in data
+ * shard (see vs_data_shard_push_node_cmd()), then loading is always done with
+ * write lock of data.
+ *
  * \param[in] *vs_ctx	The pointer at server context
  * \param[in] node_id	The ID of node
  *
@@ -386,6 +613,12 @@ struct VSNode *vs_node_find(struct VS_CTX *vs_ctx, uint32 node_id)
 	bucket = v_hash_array_find_item(&vs_ctx->data.nodes, &find_node);
 	if(bucket != NULL) {
 		node = (struct VSNode *)bucket->data;
+#ifdef WITH_MONGODB
+		/* Load tag groups and layers of node, when they were evicted */
+		if(node->flags & VS_NODE_UNLOADED) {
+			vs_mongo_node_load_data(vs_ctx, node);
+		}
+#endif
 	}
 
 	return node;
@@ -396,6 +629,7 @@ struct VSNode *vs_node_find(struct VS_CTX *vs_ctx, uint32 node_id)
  */
 void vs_node_init(struct VSNode *node)
 {
+	uint32 epoch;
 	int res;
 
 	node->id = 0xFFFFFFFF;
@@ -445,7 +679,14 @@ void vs_node_init(struct VSNode *node)
 	node->version = 0;
 	node->saved_version = -1;
 	node->crc32 = 0;
-
+	epoch = vs_journal_new_epoch();
+	vs_journal_init(&node->child_journal, node->version, epoch);
+	vs_journal_init(&node->tg_journal, node->version, epoch);
+	vs_journal_init(&node->layer_journal, node->version, epoch);
+
+#ifdef WITH_MONGODB
+	node->idle_since = 0;
+#endif
 }
 
 /**
@@ -550,6 +791,12 @@ static int vs_node_destroy(struct VS_CTX *vs_ctx, struct VSNode *node)
 			if(node->parent_link != NULL) {
 				struct VSNode *parent_node = node->parent_link->parent;
 				v_list_free_item(&parent_node->children_links, node->parent_link);
+				vs_node_inc_version(parent_node);
+				vs_journal_add(&parent_node->child_journal, parent_node->version,
+						node->id, JOURNAL_ITEM_DESTROY);
+#ifdef WITH_MONGODB
+				vs_mongo_node_dirty(vs_ctx, parent_node);
+#endif
 			}
 
 			/* Remove all tag groups and tags */
@@ -564,6 +811,10 @@ static int vs_node_destroy(struct VS_CTX *vs_ctx, struct VSNode *node)
 			}
 			v_hash_array_destroy(&node->layers);
 
+			vs_journal_destroy(&node->child_journal);
+			vs_journal_destroy(&node->tg_journal);
+			vs_journal_destroy(&node->layer_journal);
+
 			v_print_log(VRS_PRINT_DEBUG_MSG, "Node: %d destroyed\n", node->id);
 
 			/* Remove node from the hashed linked list of nodes */
@@ -734,6 +985,8 @@ static struct VSNode *vs_node_new(struct VS_CTX *vs_ctx,
 		v_list_add_tail(&node->permissions, perm);
 	}
 
+	vs_persist_node_create(vs_ctx, node);
+
 	/* Send node_create to all subscribers of avatar node data */
 	node_subscriber = avatar_node->node_subs.first;
 	while(node_subscriber) {
@@ -819,9 +1072,9 @@ int vs_handle_node_unsubscribe(struct VS_CTX *vs_ctx,
 {
 	struct VSNode *node;
 	struct VSNodeSubscriber *node_subscriber;
+	struct Generic_Cmd *unsubscribe_cmd;
 	uint32 node_id = UINT32(node_unsubscribe->data[0]);
-	uint32 version = UINT32(node_unsubscribe->data[UINT32_SIZE]);
-	/*uint32 crc32 = UINT32(node_unsubscribe->data[UINT32_SIZE + UINT32_SIZE]);*/
+	uint8 versing = UINT8(node_unsubscribe->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE]);
 	int ret = 1;
 
 	/* Try to find node */
@@ -831,14 +1084,6 @@ int vs_handle_node_unsubscribe(struct VS_CTX *vs_ctx,
 		return 0;
 	}
 
-	/* TODO: when versing will be supported, then compute crc32, save data to
-	 * the disk and send node_unsubscribe command to the client with version number
-	 * and crc32 */
-	if(version != 0) {
-		v_print_log(VRS_PRINT_WARNING,
-				"Version: %d != 0, versing is not supported yet\n", version);
-	}
-	
 	pthread_mutex_lock(&node->mutex);
 
 	/* Node has to be created */
@@ -847,6 +1092,17 @@ int vs_handle_node_unsubscribe(struct VS_CTX *vs_ctx,
 		node_subscriber = vs_node_get_subscriber(node, vsession);
 		if(node_subscriber != NULL) {
 			ret = vs_node_unsubscribe(node, node_subscriber, 0);
+			/* When client requested versing, then send it version of node,
+			 * that could be used for next subscribing */
+			if(ret == 1 && versing != 0) {
+				unsubscribe_cmd = v_node_unsubscribe_create(node->id,
+						node->version, node->crc32, 0,
+						node->child_journal.epoch);
+				if(unsubscribe_cmd != NULL) {
+					v_out_queue_push_tail(vsession->out_queue, 0,
+							VRS_DEFAULT_PRIORITY, unsubscribe_cmd);
+				}
+			}
 		} else {
 			v_print_log(VRS_PRINT_DEBUG_MSG,
 					"%s() client not subscribed to this node (id: %d)\n",
@@ -875,6 +1131,7 @@ int vs_handle_node_subscribe(struct VS_CTX *vs_ctx,
 	uint32 node_id = UINT32(node_subscribe->data[0]);
 	uint32 version = UINT32(node_subscribe->data[UINT32_SIZE]);
 	/*uint32 crc32 = UINT32(node_subscribe->data[UINT32_SIZE + UINT32_SIZE]);*/
+	uint32 epoch = UINT32(node_subscribe->data[UINT32_SIZE + UINT32_SIZE + UINT32_SIZE]);
 	int ret = 1;
 
 	/* Try to find node */
@@ -897,7 +1154,7 @@ int vs_handle_node_subscribe(struct VS_CTX *vs_ctx,
 					"%s() client %d is already subscribed to the node (id: %d)\n",
 					__func__, vsession->session_id, node->id);
 		} else {
-			ret = vs_node_subscribe(vsession, node, version);
+			ret = vs_node_subscribe(vs_ctx, vsession, node, version, epoch);
 		}
 	} else {
 		ret = 0;
@@ -989,6 +1246,9 @@ int vs_handle_node_destroy(struct VS_CTX *vs_ctx,
 			ret = 0;
 		} else {
 			ret = vs_node_send_destroy(node);
+			if(node->state == ENTITY_DELETING) {
+				vs_persist_node_destroy(vs_ctx, node);
+			}
 		}
 	} else {
 		ret = 0;
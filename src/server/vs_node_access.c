@@ -30,6 +30,7 @@
 #include "v_node_commands.h"
 
 #include "vs_node.h"
+#include "vs_persist.h"
 
 /**
  * \brief This function checks if client can write to the node
@@ -452,6 +453,11 @@ int vs_handle_node_owner(struct VS_CTX *vs_ctx,
 
 	vs_node_inc_version(node);
 
+	vs_persist_node_owner(vs_ctx, node);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
 	ret = 1;
 	/* Send node_owner to all node followers */
 	for(node_follower = node->node_folls.first;
@@ -528,6 +534,11 @@ int vs_handle_node_perm(struct VS_CTX *vs_ctx,
 			if(ret == 1) {
 				struct VSession *lost_locker_session = NULL;
 
+				vs_persist_node_perm(vs_ctx, node, user, permissions);
+#ifdef WITH_MONGODB
+				vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
 				/* Unlock locked node, when locker of the node lost permission
 				 * to lock this node (it can not no longer write to node) */
 				if(node->lock.session != NULL &&
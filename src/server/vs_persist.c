@@ -0,0 +1,1849 @@
+/*
+ *
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ *
+ * Contributor(s): Jiri Hnidek <jiri.hnidek@tul.cz>.
+ *
+ */
+
+/**
+ * \file	vs_persist.c
+ * \brief	Built-in persistence of shared data.
+ *
+ * All changes of nodes, tag groups, tags and layers are appended to the
+ * write-ahead log, when they are handled. The log is flushed to the disk once
+ * per second. Compact snapshot of all shared data is written periodically by
+ * forked child process, then the server is blocked only during fork. Records
+ * in snapshot are aligned and layer items are stored in the same dense arrays
+ * as in memory, then mapped snapshot is loaded without any parsing. Logs
+ * older than snapshot are removed. Shared data are recovered at startup from
+ * the snapshot and the tail of the log.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "verse_types.h"
+
+#include "v_common.h"
+#include "v_layer_commands.h"
+
+#include "vs_main.h"
+#include "vs_node.h"
+#include "vs_node_access.h"
+#include "vs_link.h"
+#include "vs_entity.h"
+#include "vs_taggroup.h"
+#include "vs_tag.h"
+#include "vs_layer.h"
+#include "vs_persist.h"
+
+/* Number of padding bytes added after data of record */
+#define PERSIST_PADDING(size)	((PERSIST_RECORD_ALIGN - ((size) % PERSIST_RECORD_ALIGN)) % PERSIST_RECORD_ALIGN)
+
+/* Initial value of FNV-1a checksum */
+#define PERSIST_CHECKSUM_INIT	2166136261U
+
+/* Size of buffer used for writing snapshot */
+#define PERSIST_BUFFER_SIZE		65536
+
+/**
+ * Function writing one record to the log or snapshot. Record could contain
+ * two blocks of data and each of them is padded.
+ */
+typedef int (*VSPersistWriteFunc)(void *writer,
+		struct VSPersistRecord *rec,
+		const void *data1,
+		uint32 size1,
+		const void *data2,
+		uint32 size2);
+
+/**
+ * Snapshot, that is written
+ */
+typedef struct VSPersistSnapshot {
+	int			fd;				/* File descriptor of temporary file */
+	uint32		used;			/* Number of used bytes in buffer */
+	uint32		record_count;	/* Number of written records */
+	uint64		size;			/* Size of snapshot */
+} VSPersistSnapshot;
+
+/* Buffer used for writing snapshot. It is static, because child process
+ * writing snapshot can't allocate memory (other threads of parent process
+ * could hold lock of allocator during fork) */
+static uint8 vs_persist_buffer[PERSIST_BUFFER_SIZE];
+
+static const uint8 vs_persist_padding[PERSIST_RECORD_ALIGN] = {0};
+
+/**
+ * \brief This function updates FNV-1a checksum with block of data
+ */
+static uint32 vs_persist_checksum(uint32 hash, const void *data, uint32 size)
+{
+	const uint8 *bytes = (const uint8*)data;
+	uint32 i;
+
+	for(i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/**
+ * \brief This function returns 1, when data of node are persistent. Only
+ * scene node and common nodes are stored. Other nodes are created by server.
+ */
+static int vs_persist_node_is_persistent(struct VSNode *node)
+{
+	return (node->id == VRS_SCENE_PARENT_NODE_ID ||
+			node->id >= VRS_FIRST_COMMON_NODE_ID) ? 1 : 0;
+}
+
+/**
+ * \brief This function returns size of one value of tag
+ */
+static uint32 vs_persist_value_size(uint8 data_type)
+{
+	switch(data_type) {
+		case VRS_VALUE_TYPE_UINT8:
+			return UINT8_SIZE;
+		case VRS_VALUE_TYPE_UINT16:
+			return UINT16_SIZE;
+		case VRS_VALUE_TYPE_UINT32:
+			return UINT32_SIZE;
+		case VRS_VALUE_TYPE_UINT64:
+			return UINT64_SIZE;
+		case VRS_VALUE_TYPE_REAL16:
+			return REAL16_SIZE;
+		case VRS_VALUE_TYPE_REAL32:
+			return REAL32_SIZE;
+		case VRS_VALUE_TYPE_REAL64:
+			return REAL64_SIZE;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * \brief This function initializes new record
+ */
+static void vs_persist_record_init(struct VSPersistRecord *rec,
+		uint8 type,
+		uint32 node_id)
+{
+	memset(rec, 0, sizeof(struct VSPersistRecord));
+	rec->type = type;
+	rec->node_id = node_id;
+}
+
+/**
+ * \brief This function writes whole buffer to the file descriptor
+ */
+static int vs_persist_write_all(int fd, const void *data, size_t size)
+{
+	const uint8 *bytes = (const uint8*)data;
+	ssize_t ret;
+
+	while(size > 0) {
+		ret = write(fd, bytes, size);
+		if(ret == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return 0;
+		}
+		bytes += ret;
+		size -= ret;
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function creates path of file in directory with persistent data
+ */
+static void vs_persist_path(struct VS_CTX *vs_ctx,
+		char *path,
+		const char *name,
+		const char *suffix)
+{
+	snprintf(path, PATH_MAX, "%s/%s%s", vs_ctx->persist_dir, name, suffix);
+}
+
+/**
+ * \brief This function creates path of write-ahead log with sequence number
+ */
+static void vs_persist_wal_path(struct VS_CTX *vs_ctx, char *path, uint32 seq)
+{
+	snprintf(path, PATH_MAX, "%s/%s.%u", vs_ctx->persist_dir, PERSIST_WAL_FILE, seq);
+}
+
+/**
+ * \brief This function flushes directory entries (created, renamed and
+ * removed files) to the disk
+ */
+static void vs_persist_sync_dir(struct VS_CTX *vs_ctx)
+{
+	int fd = open(vs_ctx->persist_dir, O_RDONLY);
+
+	if(fd != -1) {
+		fsync(fd);
+		close(fd);
+	}
+}
+
+/**
+ * \brief This function compares sequence numbers of logs
+ */
+static int vs_persist_seq_cmp(const void *a, const void *b)
+{
+	uint32 seq1 = *(const uint32*)a, seq2 = *(const uint32*)b;
+
+	return (seq1 < seq2) ? -1 : (seq1 > seq2) ? 1 : 0;
+}
+
+/**
+ * \brief This function finds sequence numbers of all write-ahead logs in
+ * directory with persistent data
+ *
+ * \param[out]	**seqs	The sorted array of sequence numbers (it has to be
+ * freed by caller, when it is not NULL)
+ *
+ * \return This function returns number of logs or -1 on error.
+ */
+static int vs_persist_wal_list(struct VS_CTX *vs_ctx, uint32 **seqs)
+{
+	size_t prefix_len = strlen(PERSIST_WAL_FILE);
+	struct dirent *entry;
+	uint32 *array = NULL, *tmp;
+	int count = 0, length = 0;
+	unsigned long seq;
+	char *end;
+	DIR *dir;
+
+	*seqs = NULL;
+
+	if((dir = opendir(vs_ctx->persist_dir)) == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "opendir(%s): %s\n",
+				vs_ctx->persist_dir, strerror(errno));
+		return -1;
+	}
+
+	while((entry = readdir(dir)) != NULL) {
+		if(strncmp(entry->d_name, PERSIST_WAL_FILE, prefix_len) != 0 ||
+				entry->d_name[prefix_len] != '.')
+		{
+			continue;
+		}
+
+		errno = 0;
+		seq = strtoul(&entry->d_name[prefix_len + 1], &end, 10);
+		if(errno != 0 || *end != '\0' || end == &entry->d_name[prefix_len + 1] ||
+				seq > UINT32_MAX)
+		{
+			continue;
+		}
+
+		if(count == length) {
+			length = (length == 0) ? 16 : 2 * length;
+			tmp = (uint32*)realloc(array, length * sizeof(uint32));
+			if(tmp == NULL) {
+				v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+				free(array);
+				closedir(dir);
+				return -1;
+			}
+			array = tmp;
+		}
+		array[count++] = (uint32)seq;
+	}
+
+	closedir(dir);
+
+	if(count > 0) {
+		qsort(array, count, sizeof(uint32), vs_persist_seq_cmp);
+	}
+
+	*seqs = array;
+
+	return count;
+}
+
+/**
+ * \brief This function removes all write-ahead logs older than snapshot
+ */
+static void vs_persist_wal_cleanup(struct VS_CTX *vs_ctx, uint32 snapshot_seq)
+{
+	char path[PATH_MAX];
+	uint32 *seqs;
+	int i, count;
+
+	count = vs_persist_wal_list(vs_ctx, &seqs);
+
+	for(i = 0; i < count && seqs[i] < snapshot_seq; i++) {
+		vs_persist_wal_path(vs_ctx, path, seqs[i]);
+		if(unlink(path) == -1) {
+			v_print_log(VRS_PRINT_WARNING, "unlink(%s): %s\n",
+					path, strerror(errno));
+		}
+	}
+
+	if(seqs != NULL) {
+		free(seqs);
+	}
+}
+
+/**
+ * \brief This function opens new write-ahead log
+ */
+static int vs_persist_wal_open(struct VS_CTX *vs_ctx,
+		struct VSPersist *persist,
+		uint32 seq)
+{
+	char path[PATH_MAX];
+
+	vs_persist_wal_path(vs_ctx, path, seq);
+
+	if((persist->wal = fopen(path, "ab")) == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "fopen(%s): %s\n", path, strerror(errno));
+		return 0;
+	}
+
+	persist->wal_seq = seq;
+	persist->record_count = 0;
+
+	vs_persist_sync_dir(vs_ctx);
+
+	return 1;
+}
+
+/**
+ * \brief This function closes current write-ahead log and all buffered
+ * records are written to the disk. Mutex of log has to be locked.
+ */
+static void vs_persist_wal_close(struct VSPersist *persist)
+{
+	if(persist->wal != NULL) {
+		fflush(persist->wal);
+		fdatasync(fileno(persist->wal));
+		fclose(persist->wal);
+		persist->wal = NULL;
+	}
+}
+
+/**
+ * \brief This function appends one record to the write-ahead log. Mutex of
+ * log has to be locked.
+ */
+static int vs_persist_wal_write(void *writer,
+		struct VSPersistRecord *rec,
+		const void *data1,
+		uint32 size1,
+		const void *data2,
+		uint32 size2)
+{
+	struct VSPersist *persist = (struct VSPersist*)writer;
+	uint32 pad1 = PERSIST_PADDING(size1), pad2 = PERSIST_PADDING(size2);
+	uint32 checksum;
+
+	if(persist->wal == NULL) {
+		return 0;
+	}
+
+	rec->data_size = size1 + pad1 + size2;
+	rec->size = sizeof(struct VSPersistRecord) + rec->data_size + pad2;
+	rec->checksum = 0;
+
+	checksum = vs_persist_checksum(PERSIST_CHECKSUM_INIT, rec, sizeof(struct VSPersistRecord));
+	checksum = vs_persist_checksum(checksum, data1, size1);
+	checksum = vs_persist_checksum(checksum, vs_persist_padding, pad1);
+	checksum = vs_persist_checksum(checksum, data2, size2);
+	checksum = vs_persist_checksum(checksum, vs_persist_padding, pad2);
+	rec->checksum = checksum;
+
+	fwrite(rec, sizeof(struct VSPersistRecord), 1, persist->wal);
+	if(size1 > 0) fwrite(data1, 1, size1, persist->wal);
+	if(pad1 > 0) fwrite(vs_persist_padding, 1, pad1, persist->wal);
+	if(size2 > 0) fwrite(data2, 1, size2, persist->wal);
+	if(pad2 > 0) fwrite(vs_persist_padding, 1, pad2, persist->wal);
+
+	if(ferror(persist->wal)) {
+		v_print_log(VRS_PRINT_ERROR, "Unable to write to write-ahead log %u\n",
+				persist->wal_seq);
+		clearerr(persist->wal);
+		return 0;
+	}
+
+	persist->record_count++;
+
+	return 1;
+}
+
+/**
+ * \brief This function appends block of data to the snapshot
+ */
+static int vs_persist_snapshot_append(struct VSPersistSnapshot *snap,
+		const void *data,
+		uint32 size)
+{
+	if(snap->used + size > PERSIST_BUFFER_SIZE) {
+		if(vs_persist_write_all(snap->fd, vs_persist_buffer, snap->used) != 1) {
+			return 0;
+		}
+		snap->used = 0;
+	}
+
+	if(size > PERSIST_BUFFER_SIZE) {
+		/* Big arrays of layer items are written directly */
+		if(vs_persist_write_all(snap->fd, data, size) != 1) {
+			return 0;
+		}
+	} else if(size > 0) {
+		memcpy(&vs_persist_buffer[snap->used], data, size);
+		snap->used += size;
+	}
+
+	snap->size += size;
+
+	return 1;
+}
+
+/**
+ * \brief This function appends one record to the snapshot. Records of
+ * snapshot are not protected with checksum, because snapshot is used only,
+ * when it was completely written.
+ */
+static int vs_persist_snapshot_record(void *writer,
+		struct VSPersistRecord *rec,
+		const void *data1,
+		uint32 size1,
+		const void *data2,
+		uint32 size2)
+{
+	struct VSPersistSnapshot *snap = (struct VSPersistSnapshot*)writer;
+	uint32 pad1 = PERSIST_PADDING(size1), pad2 = PERSIST_PADDING(size2);
+
+	rec->data_size = size1 + pad1 + size2;
+	rec->size = sizeof(struct VSPersistRecord) + rec->data_size + pad2;
+	rec->checksum = 0;
+
+	if(vs_persist_snapshot_append(snap, rec, sizeof(struct VSPersistRecord)) != 1 ||
+			vs_persist_snapshot_append(snap, data1, size1) != 1 ||
+			vs_persist_snapshot_append(snap, vs_persist_padding, pad1) != 1 ||
+			vs_persist_snapshot_append(snap, data2, size2) != 1 ||
+			vs_persist_snapshot_append(snap, vs_persist_padding, pad2) != 1)
+	{
+		return 0;
+	}
+
+	snap->record_count++;
+
+	return 1;
+}
+
+/**
+ * \brief This function writes node and its permissions
+ */
+static int vs_persist_emit_node(VSPersistWriteFunc write_func,
+		void *writer,
+		struct VSNode *node,
+		uint32 parent_id)
+{
+	struct VSPersistRecord rec;
+	struct VSNodePermission *perm;
+
+	vs_persist_record_init(&rec, PERSIST_NODE_CREATE, node->id);
+	rec.ref_id = parent_id;
+	rec.item_id = (node->owner != NULL) ? node->owner->user_id : VRS_SUPER_USER_UID;
+	rec.custom_type = node->custom_type;
+	if(write_func(writer, &rec, NULL, 0, NULL, 0) != 1) {
+		return 0;
+	}
+
+	for(perm = node->permissions.first; perm != NULL; perm = perm->next) {
+		vs_persist_record_init(&rec, PERSIST_NODE_PERM, node->id);
+		rec.ref_id = perm->user->user_id;
+		rec.item_id = perm->permissions;
+		if(write_func(writer, &rec, NULL, 0, NULL, 0) != 1) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function writes tag group
+ */
+static int vs_persist_emit_taggroup(VSPersistWriteFunc write_func,
+		void *writer,
+		struct VSNode *node,
+		struct VSTagGroup *tg)
+{
+	struct VSPersistRecord rec;
+
+	vs_persist_record_init(&rec, PERSIST_TAGGROUP_CREATE, node->id);
+	rec.entity_id = tg->id;
+	rec.custom_type = tg->custom_type;
+
+	return write_func(writer, &rec, NULL, 0, NULL, 0);
+}
+
+/**
+ * \brief This function writes tag
+ */
+static int vs_persist_emit_tag(VSPersistWriteFunc write_func,
+		void *writer,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag)
+{
+	struct VSPersistRecord rec;
+
+	vs_persist_record_init(&rec, PERSIST_TAG_CREATE, node->id);
+	rec.entity_id = tg->id;
+	rec.item_id = tag->id;
+	rec.data_type = tag->data_type;
+	rec.count = tag->count;
+	rec.custom_type = tag->custom_type;
+
+	return write_func(writer, &rec, NULL, 0, NULL, 0);
+}
+
+/**
+ * \brief This function writes value of tag, when value was set
+ */
+static int vs_persist_emit_tag_value(VSPersistWriteFunc write_func,
+		void *writer,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag)
+{
+	struct VSPersistRecord rec;
+	uint32 size;
+
+	if(tag->flag != TAG_INITIALIZED || tag->value == NULL) {
+		return 1;
+	}
+
+	if(tag->data_type == VRS_VALUE_TYPE_STRING8) {
+		size = strlen((char*)tag->value) + 1;
+	} else {
+		size = tag->count * vs_persist_value_size(tag->data_type);
+	}
+
+	vs_persist_record_init(&rec, PERSIST_TAG_SET, node->id);
+	rec.entity_id = tg->id;
+	rec.item_id = tag->id;
+	rec.data_type = tag->data_type;
+	rec.count = tag->count;
+
+	return write_func(writer, &rec, tag->value, size, NULL, 0);
+}
+
+/**
+ * \brief This function writes layer
+ */
+static int vs_persist_emit_layer(VSPersistWriteFunc write_func,
+		void *writer,
+		struct VSNode *node,
+		struct VSLayer *layer)
+{
+	struct VSPersistRecord rec;
+
+	vs_persist_record_init(&rec, PERSIST_LAYER_CREATE, node->id);
+	rec.entity_id = layer->id;
+	rec.ref_id = (layer->parent != NULL) ? layer->parent->id : VRS_RESERVED_LAYER_ID;
+	rec.data_type = layer->data_type;
+	rec.count = layer->num_vec_comp;
+	rec.custom_type = layer->custom_type;
+
+	return write_func(writer, &rec, NULL, 0, NULL, 0);
+}
+
+/**
+ * \brief This function writes snapshot of all persistent data to the file
+ *
+ * This function is called in forked child process, then it can't allocate
+ * any memory, print logs or use any lock.
+ *
+ * \param[in]	*vs_ctx		The Verse server context
+ * \param[in]	*path		The path of temporary file
+ * \param[in]	wal_seq		The first log, that is not included in snapshot
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+static int vs_persist_snapshot_write(struct VS_CTX *vs_ctx,
+		const char *path,
+		uint32 wal_seq)
+{
+	struct VSPersistSnapshotHeader header;
+	struct VSPersistSnapshot snap;
+	struct VSPersistRecord rec;
+	struct VBucket *node_bucket, *tg_bucket, *tag_bucket, *layer_bucket;
+	struct VSNode *node;
+	struct VSTagGroup *tg;
+	struct VSTag *tag;
+	struct VSLayer *layer;
+	int ret = 0;
+
+	if((snap.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1) {
+		return 0;
+	}
+	snap.used = 0;
+	snap.record_count = 0;
+	snap.size = 0;
+
+	/* Header is written again, when size of snapshot is known */
+	memset(&header, 0, sizeof(struct VSPersistSnapshotHeader));
+	if(vs_persist_snapshot_append(&snap, &header, sizeof(header)) != 1) {
+		goto end;
+	}
+
+	/* Only nodes in the scene are stored. Nodes are created as children of
+	 * root node first and they are linked to their parents, when all nodes
+	 * exist */
+	for(node_bucket = vs_ctx->data.nodes.lb.first;
+			node_bucket != NULL;
+			node_bucket = node_bucket->next)
+	{
+		node = (struct VSNode*)node_bucket->data;
+
+		if(!(node->flags & VS_NODE_SAVEABLE) ||
+				node->state == ENTITY_DELETING)
+		{
+			continue;
+		}
+
+		if(vs_persist_emit_node(vs_persist_snapshot_record, &snap,
+				node, VRS_ROOT_NODE_ID) != 1)
+		{
+			goto end;
+		}
+
+		for(tg_bucket = node->tag_groups.lb.first;
+				tg_bucket != NULL;
+				tg_bucket = tg_bucket->next)
+		{
+			tg = (struct VSTagGroup*)tg_bucket->data;
+			if(tg->state == ENTITY_DELETING) {
+				continue;
+			}
+			if(vs_persist_emit_taggroup(vs_persist_snapshot_record, &snap,
+					node, tg) != 1)
+			{
+				goto end;
+			}
+
+			for(tag_bucket = tg->tags.lb.first;
+					tag_bucket != NULL;
+					tag_bucket = tag_bucket->next)
+			{
+				tag = (struct VSTag*)tag_bucket->data;
+				if(tag->state == ENTITY_DELETING) {
+					continue;
+				}
+				if(vs_persist_emit_tag(vs_persist_snapshot_record, &snap,
+						node, tg, tag) != 1 ||
+						vs_persist_emit_tag_value(vs_persist_snapshot_record, &snap,
+								node, tg, tag) != 1)
+				{
+					goto end;
+				}
+			}
+		}
+
+		/* Layers are in order of creating, then parent layer is always
+		 * created before child layer */
+		for(layer_bucket = node->layers.lb.first;
+				layer_bucket != NULL;
+				layer_bucket = layer_bucket->next)
+		{
+			layer = (struct VSLayer*)layer_bucket->data;
+			if(layer->state == ENTITY_DELETING) {
+				continue;
+			}
+			if(vs_persist_emit_layer(vs_persist_snapshot_record, &snap,
+					node, layer) != 1)
+			{
+				goto end;
+			}
+
+			/* Dense arrays of items are stored without any conversion */
+			if(layer->values.count > 0) {
+				vs_persist_record_init(&rec, PERSIST_LAYER_VALUES, node->id);
+				rec.entity_id = layer->id;
+				rec.item_id = layer->values.count;
+				if(vs_persist_snapshot_record(&snap, &rec,
+						layer->values.ids,
+						layer->values.count * sizeof(uint32),
+						layer->values.data,
+						layer->values.count * layer->values.value_size) != 1)
+				{
+					goto end;
+				}
+			}
+		}
+	}
+
+	/* Links between nodes */
+	for(node_bucket = vs_ctx->data.nodes.lb.first;
+			node_bucket != NULL;
+			node_bucket = node_bucket->next)
+	{
+		node = (struct VSNode*)node_bucket->data;
+
+		if(node->id < VRS_FIRST_COMMON_NODE_ID ||
+				!(node->flags & VS_NODE_SAVEABLE) ||
+				node->state == ENTITY_DELETING ||
+				node->parent_link == NULL)
+		{
+			continue;
+		}
+
+		vs_persist_record_init(&rec, PERSIST_NODE_LINK, node->id);
+		rec.ref_id = node->parent_link->parent->id;
+		if(vs_persist_snapshot_record(&snap, &rec, NULL, 0, NULL, 0) != 1) {
+			goto end;
+		}
+	}
+
+	if(vs_persist_write_all(snap.fd, vs_persist_buffer, snap.used) != 1) {
+		goto end;
+	}
+
+	memcpy(header.magic, PERSIST_SNAPSHOT_MAGIC, sizeof(PERSIST_SNAPSHOT_MAGIC));
+	header.format = PERSIST_FORMAT_VERSION;
+	header.wal_seq = wal_seq;
+	header.last_common_node_id = vs_ctx->data.last_common_node_id;
+	header.record_count = snap.record_count;
+	header.size = snap.size;
+
+	if(pwrite(snap.fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+		goto end;
+	}
+
+	if(fsync(snap.fd) == -1) {
+		goto end;
+	}
+
+	ret = 1;
+
+end:
+	close(snap.fd);
+
+	return ret;
+}
+
+/**
+ * \brief This function replaces old snapshot with new one, when it was
+ * successfully written, and it removes logs included in new snapshot.
+ */
+static void vs_persist_snapshot_commit(struct VS_CTX *vs_ctx,
+		uint32 wal_seq)
+{
+	char tmp_path[PATH_MAX], path[PATH_MAX];
+
+	vs_persist_path(vs_ctx, tmp_path, PERSIST_SNAPSHOT_FILE, ".tmp");
+	vs_persist_path(vs_ctx, path, PERSIST_SNAPSHOT_FILE, "");
+
+	if(rename(tmp_path, path) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "rename(%s): %s\n",
+				tmp_path, strerror(errno));
+		return;
+	}
+
+	vs_persist_sync_dir(vs_ctx);
+
+	vs_persist_wal_cleanup(vs_ctx, wal_seq);
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Snapshot of shared data written (log: %u)\n",
+			wal_seq);
+}
+
+/**
+ * \brief This function starts writing snapshot in child process
+ *
+ * Current log is closed and new log is started, when data are locked. Child
+ * process has copy of shared data in the same state as is stored in closed
+ * logs.
+ */
+static int vs_persist_snapshot_start(struct VS_CTX *vs_ctx,
+		struct VSPersist *persist)
+{
+	char tmp_path[PATH_MAX];
+	uint32 wal_seq;
+	pid_t pid;
+
+	vs_persist_path(vs_ctx, tmp_path, PERSIST_SNAPSHOT_FILE, ".tmp");
+
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
+
+	pthread_mutex_lock(&persist->mutex);
+	vs_persist_wal_close(persist);
+	if(vs_persist_wal_open(vs_ctx, persist, persist->wal_seq + 1) != 1) {
+		pthread_mutex_unlock(&persist->mutex);
+		pthread_rwlock_unlock(&vs_ctx->data.lock);
+		return 0;
+	}
+	wal_seq = persist->wal_seq;
+	pthread_mutex_unlock(&persist->mutex);
+
+	pid = fork();
+
+	if(pid == 0) {
+		/* Child process */
+		_exit((vs_persist_snapshot_write(vs_ctx, tmp_path, wal_seq) == 1) ?
+				EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+	if(pid == -1) {
+		v_print_log(VRS_PRINT_ERROR, "fork(): %s\n", strerror(errno));
+		return 0;
+	}
+
+	persist->snapshot_pid = pid;
+	persist->snapshot_seq = wal_seq;
+
+	return 1;
+}
+
+/**
+ * \brief This function checks, if child process finished writing of snapshot
+ *
+ * \param[in]	wait	When it is equal to 1, then this function waits for
+ * child process.
+ */
+static void vs_persist_snapshot_check(struct VS_CTX *vs_ctx,
+		struct VSPersist *persist,
+		int wait)
+{
+	char tmp_path[PATH_MAX];
+	int status;
+	pid_t pid;
+
+	if(persist->snapshot_pid == 0) {
+		return;
+	}
+
+	pid = waitpid(persist->snapshot_pid, &status, (wait == 1) ? 0 : WNOHANG);
+	if(pid == 0 || (pid == -1 && errno == EINTR)) {
+		return;
+	}
+
+	persist->snapshot_pid = 0;
+
+	if(pid != -1 && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+		vs_persist_snapshot_commit(vs_ctx, persist->snapshot_seq);
+	} else {
+		v_print_log(VRS_PRINT_ERROR, "Unable to write snapshot of shared data\n");
+		vs_persist_path(vs_ctx, tmp_path, PERSIST_SNAPSHOT_FILE, ".tmp");
+		unlink(tmp_path);
+	}
+}
+
+/**
+ * \brief This function writes snapshot in this process. Shared data have to
+ * be locked for writing.
+ */
+static int vs_persist_snapshot_sync(struct VS_CTX *vs_ctx,
+		struct VSPersist *persist)
+{
+	char tmp_path[PATH_MAX];
+	uint32 wal_seq = persist->wal_seq + 1;
+
+	vs_persist_path(vs_ctx, tmp_path, PERSIST_SNAPSHOT_FILE, ".tmp");
+
+	if(vs_persist_snapshot_write(vs_ctx, tmp_path, wal_seq) != 1) {
+		v_print_log(VRS_PRINT_ERROR, "Unable to write snapshot of shared data\n");
+		unlink(tmp_path);
+		return 0;
+	}
+
+	/* New log has to be opened before old logs are removed */
+	pthread_mutex_lock(&persist->mutex);
+	vs_persist_wal_close(persist);
+	vs_persist_wal_open(vs_ctx, persist, wal_seq);
+	pthread_mutex_unlock(&persist->mutex);
+
+	vs_persist_snapshot_commit(vs_ctx, wal_seq);
+
+	return 1;
+}
+
+/**
+ * \brief This function updates level of nodes in branch after node was
+ * linked to new parent. Nodes in scene are marked as saveable.
+ */
+static void vs_persist_branch_update(struct VS_CTX *vs_ctx,
+		struct VSNode *node)
+{
+	struct VSNode *parent_node;
+	struct VSLink *link;
+
+	if(node->parent_link != NULL) {
+		parent_node = node->parent_link->parent;
+		node->level = parent_node->level + 1;
+		if(node == vs_ctx->data.scene_node ||
+				(parent_node->flags & VS_NODE_SAVEABLE))
+		{
+			node->flags |= VS_NODE_SAVEABLE;
+		} else {
+			node->flags &= ~VS_NODE_SAVEABLE;
+		}
+	}
+
+	for(link = node->children_links.first; link != NULL; link = link->next) {
+		vs_persist_branch_update(vs_ctx, link->child);
+	}
+}
+
+/**
+ * \brief This function tries to find tag in tag group
+ */
+static struct VSTag *vs_persist_tag_find(struct VSTagGroup *tg, uint16 tag_id)
+{
+	struct VSTag find_tag;
+	struct VBucket *bucket;
+
+	find_tag.id = tag_id;
+	bucket = v_hash_array_find_item(&tg->tags, &find_tag);
+
+	return (bucket != NULL) ? (struct VSTag*)bucket->data : NULL;
+}
+
+/**
+ * \brief This function destroys layer and all its child layers
+ */
+static void vs_persist_layer_remove(struct VSNode *node, struct VSLayer *layer)
+{
+	while(layer->child_layers.first != NULL) {
+		vs_persist_layer_remove(node, (struct VSLayer*)layer->child_layers.first);
+	}
+
+	vs_layer_destroy(node, layer);
+}
+
+/**
+ * \brief This function unsets item in layer and all its child layers
+ */
+static void vs_persist_layer_item_remove(struct VSLayer *layer, uint32 item_id)
+{
+	struct VSLayer *child_layer;
+
+	if(vs_layer_values_unset(&layer->values, item_id) != 1) {
+		return;
+	}
+
+	vs_layer_inc_version(layer);
+
+	for(child_layer = layer->child_layers.first;
+			child_layer != NULL;
+			child_layer = child_layer->next)
+	{
+		vs_persist_layer_item_remove(child_layer, item_id);
+	}
+}
+
+/**
+ * \brief This function applies one record from snapshot or log to shared
+ * data. Records referring to not existing entities are ignored.
+ *
+ * \return This function returns 1, when record was applied. Otherwise it
+ * returns 0.
+ */
+static int vs_persist_apply(struct VS_CTX *vs_ctx,
+		const struct VSPersistRecord *rec,
+		const uint8 *data)
+{
+	struct VSNode *node, *parent_node;
+	struct VSUser *user;
+	struct VSLink *link;
+	struct VSTagGroup *tg = NULL;
+	struct VSTag *tag;
+	struct VSLayer *layer = NULL, *parent_layer;
+	uint32 size;
+	uint64 ids_size;
+
+	node = vs_node_find(vs_ctx, rec->node_id);
+
+	if(rec->type == PERSIST_NODE_CREATE) {
+		if(node != NULL) {
+			/* Scene node is created by server */
+			return 1;
+		}
+		if(rec->node_id < VRS_FIRST_COMMON_NODE_ID) {
+			return 0;
+		}
+
+		/* Parent node, that does not exist (avatar node), is replaced with
+		 * root node. Such nodes are removed after recovery, when they are
+		 * not linked to other node. */
+		if((parent_node = vs_node_find(vs_ctx, rec->ref_id)) == NULL) {
+			parent_node = vs_ctx->data.root_node;
+		}
+		if((user = vs_user_find(vs_ctx, (uint16)rec->item_id)) == NULL) {
+			user = vs_ctx->super_user;
+		}
+
+		node = vs_node_create_linked(vs_ctx, parent_node, user,
+				rec->node_id, rec->custom_type);
+		if(node == NULL) {
+			return 0;
+		}
+		node->state = ENTITY_CREATED;
+
+		if(node->id > vs_ctx->data.last_common_node_id) {
+			vs_ctx->data.last_common_node_id = node->id;
+		}
+
+		return 1;
+	}
+
+	if(node == NULL) {
+		return 0;
+	}
+
+	/* Find tag group or layer of record */
+	switch(rec->type) {
+		case PERSIST_TAGGROUP_DESTROY:
+		case PERSIST_TAG_CREATE:
+		case PERSIST_TAG_DESTROY:
+		case PERSIST_TAG_SET:
+			if((tg = vs_taggroup_find(node, rec->entity_id)) == NULL) {
+				return 0;
+			}
+			break;
+		case PERSIST_LAYER_DESTROY:
+		case PERSIST_LAYER_SET:
+		case PERSIST_LAYER_UNSET:
+		case PERSIST_LAYER_VALUES:
+			if((layer = vs_layer_find(node, rec->entity_id)) == NULL) {
+				return 0;
+			}
+			break;
+		default:
+			break;
+	}
+
+	switch(rec->type) {
+		case PERSIST_NODE_DESTROY:
+			if(node->id < VRS_FIRST_COMMON_NODE_ID) {
+				return 0;
+			}
+			vs_node_destroy_branch(vs_ctx, node, 0);
+			break;
+		case PERSIST_NODE_LINK:
+			if(node->id < VRS_FIRST_COMMON_NODE_ID ||
+					(link = node->parent_link) == NULL ||
+					(parent_node = vs_node_find(vs_ctx, rec->ref_id)) == NULL ||
+					vs_link_test_nodes(parent_node, node) != 1)
+			{
+				return 0;
+			}
+			if(link->parent != parent_node) {
+				v_list_rem_item(&link->parent->children_links, link);
+				v_list_add_tail(&parent_node->children_links, link);
+				link->parent = parent_node;
+				vs_persist_branch_update(vs_ctx, node);
+			}
+			break;
+		case PERSIST_NODE_PERM:
+			if((user = vs_user_find(vs_ctx, (uint16)rec->ref_id)) == NULL) {
+				return 0;
+			}
+			return vs_node_set_perm(node, user, (uint8)rec->item_id);
+		case PERSIST_NODE_OWNER:
+			if((user = vs_user_find(vs_ctx, (uint16)rec->ref_id)) == NULL) {
+				return 0;
+			}
+			node->owner = user;
+			break;
+		case PERSIST_TAGGROUP_CREATE:
+			if(vs_taggroup_find(node, rec->entity_id) != NULL ||
+					(tg = vs_taggroup_create(node, rec->entity_id, rec->custom_type)) == NULL)
+			{
+				return 0;
+			}
+			tg->state = ENTITY_CREATED;
+			break;
+		case PERSIST_TAGGROUP_DESTROY:
+			vs_taggroup_destroy(node, tg);
+			break;
+		case PERSIST_TAG_CREATE:
+			if(!(rec->data_type > VRS_VALUE_TYPE_RESERVED &&
+					rec->data_type <= VRS_VALUE_TYPE_STRING8) ||
+					vs_persist_tag_find(tg, (uint16)rec->item_id) != NULL ||
+					(tag = vs_tag_create(tg, (uint16)rec->item_id, rec->data_type,
+							rec->count, rec->custom_type)) == NULL)
+			{
+				return 0;
+			}
+			tag->state = ENTITY_CREATED;
+			break;
+		case PERSIST_TAG_DESTROY:
+			if((tag = vs_persist_tag_find(tg, (uint16)rec->item_id)) == NULL) {
+				return 0;
+			}
+			return vs_tag_destroy(tg, tag);
+		case PERSIST_TAG_SET:
+			if((tag = vs_persist_tag_find(tg, (uint16)rec->item_id)) == NULL ||
+					tag->data_type != rec->data_type || tag->count != rec->count)
+			{
+				return 0;
+			}
+			if(tag->data_type == VRS_VALUE_TYPE_STRING8) {
+				if(rec->data_size == 0 || data[rec->data_size - 1] != '\0') {
+					return 0;
+				}
+				if(tag->value != NULL) {
+					free(tag->value);
+				}
+				tag->value = strdup((const char*)data);
+			} else {
+				size = tag->count * vs_persist_value_size(tag->data_type);
+				if(rec->data_size < size) {
+					return 0;
+				}
+				vs_tag_set_values(tag, tag->count, 0, (void*)data);
+			}
+			tag->flag = TAG_INITIALIZED;
+			vs_taggroup_inc_version(tg);
+			break;
+		case PERSIST_LAYER_CREATE:
+			if(vs_persist_value_size(rec->data_type) == 0 ||
+					rec->count < 1 || rec->count > 4 ||
+					vs_layer_find(node, rec->entity_id) != NULL)
+			{
+				return 0;
+			}
+			parent_layer = NULL;
+			if(rec->ref_id != VRS_RESERVED_LAYER_ID &&
+					(parent_layer = vs_layer_find(node, (uint16)rec->ref_id)) == NULL)
+			{
+				return 0;
+			}
+			layer = vs_layer_create(node, parent_layer, rec->entity_id,
+					rec->data_type, rec->count, rec->custom_type);
+			if(layer == NULL) {
+				return 0;
+			}
+			layer->state = ENTITY_CREATED;
+			break;
+		case PERSIST_LAYER_DESTROY:
+			vs_persist_layer_remove(node, layer);
+			break;
+		case PERSIST_LAYER_SET:
+			if(rec->data_size < layer->values.value_size ||
+					vs_layer_values_set(&layer->values, rec->item_id, data) == NULL)
+			{
+				return 0;
+			}
+			vs_layer_inc_version(layer);
+			break;
+		case PERSIST_LAYER_UNSET:
+			vs_persist_layer_item_remove(layer, rec->item_id);
+			break;
+		case PERSIST_LAYER_VALUES:
+			/* Values follow padded array of IDs */
+			ids_size = (uint64)rec->item_id * sizeof(uint32);
+			ids_size += PERSIST_PADDING(ids_size);
+			if(ids_size + (uint64)rec->item_id * layer->values.value_size > rec->data_size) {
+				return 0;
+			}
+			return vs_layer_values_load(&layer->values, (const uint32*)data,
+					data + ids_size, rec->item_id);
+		default:
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function checks, if record at offset is complete
+ *
+ * \param[in]	checksum	When it is equal to 1, then checksum of record is
+ * checked too.
+ */
+static int vs_persist_record_check(const uint8 *buf,
+		size_t size,
+		size_t offset,
+		int checksum)
+{
+	const struct VSPersistRecord *rec;
+	struct VSPersistRecord header;
+	uint32 hash;
+
+	if(size - offset < sizeof(struct VSPersistRecord)) {
+		return 0;
+	}
+
+	rec = (const struct VSPersistRecord*)&buf[offset];
+
+	if(rec->size < sizeof(struct VSPersistRecord) ||
+			rec->size % PERSIST_RECORD_ALIGN != 0 ||
+			rec->size > size - offset ||
+			rec->data_size > rec->size - sizeof(struct VSPersistRecord))
+	{
+		return 0;
+	}
+
+	if(checksum == 1) {
+		header = *rec;
+		header.checksum = 0;
+		hash = vs_persist_checksum(PERSIST_CHECKSUM_INIT, &header, sizeof(header));
+		hash = vs_persist_checksum(hash, &buf[offset + sizeof(header)],
+				rec->size - sizeof(header));
+		if(hash != rec->checksum) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function maps file to the memory
+ *
+ * \return This function returns 1, when file was mapped, 0, when file does
+ * not exist or it is empty and -1 on error.
+ */
+static int vs_persist_map(const char *path, uint8 **buf, size_t *size)
+{
+	struct stat st;
+	int fd;
+
+	*buf = NULL;
+	*size = 0;
+
+	if((fd = open(path, O_RDONLY)) == -1) {
+		if(errno == ENOENT) {
+			return 0;
+		}
+		v_print_log(VRS_PRINT_ERROR, "open(%s): %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if(fstat(fd, &st) == -1) {
+		v_print_log(VRS_PRINT_ERROR, "fstat(%s): %s\n", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	if(st.st_size == 0) {
+		close(fd);
+		return 0;
+	}
+
+	*buf = (uint8*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if(*buf == MAP_FAILED) {
+		v_print_log(VRS_PRINT_ERROR, "mmap(%s): %s\n", path, strerror(errno));
+		*buf = NULL;
+		return -1;
+	}
+
+	*size = st.st_size;
+
+	return 1;
+}
+
+/**
+ * \brief This function loads snapshot of shared data
+ *
+ * \param[out]	*wal_seq	The first log, that is not included in snapshot
+ *
+ * \return This function returns 1 on success and 0, when snapshot is damaged.
+ */
+static int vs_persist_snapshot_load(struct VS_CTX *vs_ctx, uint32 *wal_seq)
+{
+	const struct VSPersistSnapshotHeader *header;
+	const struct VSPersistRecord *rec;
+	char path[PATH_MAX];
+	uint8 *buf;
+	size_t size, offset;
+	uint32 i, skipped = 0;
+	int ret;
+
+	*wal_seq = 0;
+
+	vs_persist_path(vs_ctx, path, PERSIST_SNAPSHOT_FILE, "");
+
+	if((ret = vs_persist_map(path, &buf, &size)) != 1) {
+		return (ret == 0) ? 1 : 0;
+	}
+
+	ret = 0;
+	header = (const struct VSPersistSnapshotHeader*)buf;
+
+	if(size < sizeof(struct VSPersistSnapshotHeader) ||
+			memcmp(header->magic, PERSIST_SNAPSHOT_MAGIC, sizeof(PERSIST_SNAPSHOT_MAGIC)) != 0 ||
+			header->format != PERSIST_FORMAT_VERSION ||
+			header->size != size)
+	{
+		v_print_log(VRS_PRINT_ERROR, "Snapshot %s is damaged\n", path);
+		goto end;
+	}
+
+	offset = sizeof(struct VSPersistSnapshotHeader);
+	for(i = 0; i < header->record_count; i++) {
+		if(vs_persist_record_check(buf, size, offset, 0) != 1) {
+			v_print_log(VRS_PRINT_ERROR, "Snapshot %s is damaged at offset %lu\n",
+					path, (unsigned long)offset);
+			goto end;
+		}
+		rec = (const struct VSPersistRecord*)&buf[offset];
+		if(vs_persist_apply(vs_ctx, rec, &buf[offset + sizeof(struct VSPersistRecord)]) != 1) {
+			skipped++;
+		}
+		offset += rec->size;
+	}
+
+	if(header->last_common_node_id > vs_ctx->data.last_common_node_id) {
+		vs_ctx->data.last_common_node_id = header->last_common_node_id;
+	}
+
+	*wal_seq = header->wal_seq;
+
+	v_print_log(VRS_PRINT_DEBUG_MSG,
+			"Snapshot loaded: %u records (%u skipped)\n",
+			header->record_count, skipped);
+
+	ret = 1;
+
+end:
+	munmap(buf, size);
+
+	return ret;
+}
+
+/**
+ * \brief This function replays one write-ahead log
+ *
+ * \return This function returns 1, when whole log was replayed and 0, when
+ * log ends with incomplete or damaged record.
+ */
+static int vs_persist_wal_replay(struct VS_CTX *vs_ctx, uint32 seq)
+{
+	const struct VSPersistRecord *rec;
+	char path[PATH_MAX];
+	uint8 *buf;
+	size_t size, offset = 0;
+	uint32 count = 0;
+	int ret;
+
+	vs_persist_wal_path(vs_ctx, path, seq);
+
+	if((ret = vs_persist_map(path, &buf, &size)) != 1) {
+		return (ret == 0) ? 1 : 0;
+	}
+
+	while(offset < size) {
+		if(vs_persist_record_check(buf, size, offset, 1) != 1) {
+			v_print_log(VRS_PRINT_WARNING,
+					"Write-ahead log %s is damaged at offset %lu\n",
+					path, (unsigned long)offset);
+			break;
+		}
+		rec = (const struct VSPersistRecord*)&buf[offset];
+		vs_persist_apply(vs_ctx, rec, &buf[offset + sizeof(struct VSPersistRecord)]);
+		offset += rec->size;
+		count++;
+	}
+
+	munmap(buf, size);
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Write-ahead log %u replayed: %u records\n",
+			seq, count);
+
+	return (offset == size) ? 1 : 0;
+}
+
+/**
+ * \brief This function finishes recovery of shared data. Nodes, that were
+ * not linked to any existing node, are removed. Levels of nodes are updated
+ * and journals of entities are reset.
+ */
+static void vs_persist_recover_finish(struct VS_CTX *vs_ctx)
+{
+	struct VSNode *root_node = vs_ctx->data.root_node, *node;
+	struct VSLink *link, *next_link;
+	struct VBucket *node_bucket, *bucket;
+
+	for(link = root_node->children_links.first; link != NULL; link = next_link) {
+		next_link = link->next;
+		if(link->child->id >= VRS_FIRST_COMMON_NODE_ID) {
+			vs_node_destroy_branch(vs_ctx, link->child, 0);
+		}
+	}
+
+	vs_persist_branch_update(vs_ctx, root_node);
+
+	/* Versions are not persistent. Clients, that subscribe with version
+	 * received before restart, have to receive whole entity. */
+	for(node_bucket = vs_ctx->data.nodes.lb.first;
+			node_bucket != NULL;
+			node_bucket = node_bucket->next)
+	{
+		node = (struct VSNode*)node_bucket->data;
+		if(vs_persist_node_is_persistent(node) != 1) {
+			continue;
+		}
+		vs_node_journal_reset(node, node->version + 1);
+		for(bucket = node->tag_groups.lb.first; bucket != NULL; bucket = bucket->next) {
+			struct VSTagGroup *tg = (struct VSTagGroup*)bucket->data;
+			vs_journal_reset(&tg->journal, tg->version + 1,
+					vs_journal_new_epoch());
+		}
+		for(bucket = node->layers.lb.first; bucket != NULL; bucket = bucket->next) {
+			struct VSLayer *layer = (struct VSLayer*)bucket->data;
+			vs_journal_reset(&layer->journal, layer->version + 1,
+					vs_journal_new_epoch());
+		}
+	}
+}
+
+/**
+ * \brief This function recovers shared data from snapshot and write-ahead
+ * logs and it starts new log.
+ *
+ * \return This function returns 1 on success. Otherwise it returns 0.
+ */
+int vs_persist_init(struct VS_CTX *vs_ctx)
+{
+	struct VSPersist *persist;
+	uint32 *seqs = NULL;
+	uint32 snapshot_seq, next_seq;
+	int i, count, damaged = 0;
+
+#ifdef WITH_MONGODB
+	if(vs_ctx->mongo_conn != NULL) {
+		v_print_log(VRS_PRINT_WARNING,
+				"Built-in persistence is disabled, because MongoDB is used\n");
+		return 1;
+	}
+#endif
+
+	if(mkdir(vs_ctx->persist_dir, 0755) == -1 && errno != EEXIST) {
+		v_print_log(VRS_PRINT_ERROR, "mkdir(%s): %s\n",
+				vs_ctx->persist_dir, strerror(errno));
+		return 0;
+	}
+
+	/* Recover shared data */
+	if(vs_persist_snapshot_load(vs_ctx, &snapshot_seq) != 1) {
+		return 0;
+	}
+
+	if((count = vs_persist_wal_list(vs_ctx, &seqs)) == -1) {
+		return 0;
+	}
+
+	next_seq = snapshot_seq;
+	for(i = 0; i < count; i++) {
+		if(seqs[i] >= next_seq) {
+			next_seq = seqs[i] + 1;
+		}
+		if(seqs[i] < snapshot_seq || damaged == 1) {
+			continue;
+		}
+		if(vs_persist_wal_replay(vs_ctx, seqs[i]) != 1) {
+			/* Following logs can't be applied to incomplete data */
+			damaged = 1;
+		}
+	}
+
+	if(seqs != NULL) {
+		free(seqs);
+	}
+
+	vs_persist_recover_finish(vs_ctx);
+
+	persist = (struct VSPersist*)calloc(1, sizeof(struct VSPersist));
+	if(persist == NULL) {
+		v_print_log(VRS_PRINT_ERROR, "Out of memory\n");
+		return 0;
+	}
+
+	pthread_mutex_init(&persist->mutex, NULL);
+	persist->snapshot_pid = 0;
+
+	if(vs_persist_wal_open(vs_ctx, persist, next_seq) != 1) {
+		pthread_mutex_destroy(&persist->mutex);
+		free(persist);
+		return 0;
+	}
+
+	vs_ctx->persist = persist;
+
+	/* Damaged log must not be replayed again */
+	if(damaged == 1) {
+		return vs_persist_snapshot_sync(vs_ctx, persist);
+	}
+
+	return 1;
+}
+
+/**
+ * \brief This function writes final snapshot and closes write-ahead log
+ */
+void vs_persist_destroy(struct VS_CTX *vs_ctx)
+{
+	struct VSPersist *persist = vs_ctx->persist;
+
+	if(persist == NULL) {
+		return;
+	}
+
+	/* Wait for snapshot written by child process */
+	vs_persist_snapshot_check(vs_ctx, persist, 1);
+
+	/* Data are locked until end, then no change could be logged */
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
+
+	/* Final snapshot replaces all logs, then they don't have to be replayed
+	 * at next start */
+	vs_persist_snapshot_sync(vs_ctx, persist);
+
+	pthread_mutex_lock(&persist->mutex);
+	vs_persist_wal_close(persist);
+	pthread_mutex_unlock(&persist->mutex);
+
+	vs_ctx->persist = NULL;
+
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
+
+	pthread_mutex_destroy(&persist->mutex);
+	free(persist);
+}
+
+/**
+ * \brief This function flushes write-ahead log and writes snapshots
+ */
+void *vs_persist_loop(void *arg)
+{
+	struct VS_CTX *vs_ctx = (struct VS_CTX *)arg;
+	struct VSPersist *persist = vs_ctx->persist;
+	unsigned int seconds = 0;
+	int fd;
+
+	while(vs_ctx->state != SERVER_STATE_CLOSED) {
+		sleep(1);
+
+		/* Records are copied to the kernel with lock of log and they are
+		 * written to the disk without lock. Log is closed only by this
+		 * thread. */
+		pthread_mutex_lock(&persist->mutex);
+		fflush(persist->wal);
+		fd = fileno(persist->wal);
+		pthread_mutex_unlock(&persist->mutex);
+		fdatasync(fd);
+
+		vs_persist_snapshot_check(vs_ctx, persist, 0);
+
+		if(++seconds < vs_ctx->persist_snapshot_interval ||
+				vs_ctx->state != SERVER_STATE_READY)
+		{
+			continue;
+		}
+		seconds = 0;
+
+		/* Snapshot isn't needed, when nothing was changed */
+		if(persist->snapshot_pid == 0 && persist->record_count > 0) {
+			vs_persist_snapshot_start(vs_ctx, persist);
+		}
+	}
+
+	v_print_log(VRS_PRINT_DEBUG_MSG, "Exiting persistence thread\n");
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+/**
+ * \brief This function locks write-ahead log, when changes of node are
+ * persistent
+ */
+static struct VSPersist *vs_persist_lock(struct VS_CTX *vs_ctx,
+		struct VSNode *node)
+{
+	struct VSPersist *persist = vs_ctx->persist;
+
+	if(persist == NULL || vs_persist_node_is_persistent(node) != 1) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&persist->mutex);
+
+	return persist;
+}
+
+/**
+ * \brief This function logs creating of node
+ */
+void vs_persist_node_create(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+
+	if(persist != NULL) {
+		vs_persist_emit_node(vs_persist_wal_write, persist, node,
+				(node->parent_link != NULL) ? node->parent_link->parent->id : VRS_ROOT_NODE_ID);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs destroying of node and its child nodes
+ */
+void vs_persist_node_destroy(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_NODE_DESTROY, node->id);
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs new link between node and its parent
+ */
+void vs_persist_node_link(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_NODE_LINK, node->id);
+		rec.ref_id = node->parent_link->parent->id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs changed permissions of user
+ */
+void vs_persist_node_perm(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSUser *user,
+		uint8 permissions)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_NODE_PERM, node->id);
+		rec.ref_id = user->user_id;
+		rec.item_id = permissions;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs new owner of node
+ */
+void vs_persist_node_owner(struct VS_CTX *vs_ctx, struct VSNode *node)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_NODE_OWNER, node->id);
+		rec.ref_id = node->owner->user_id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs creating of tag group
+ */
+void vs_persist_taggroup_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+
+	if(persist != NULL) {
+		vs_persist_emit_taggroup(vs_persist_wal_write, persist, node, tg);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs destroying of tag group
+ */
+void vs_persist_taggroup_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_TAGGROUP_DESTROY, node->id);
+		rec.entity_id = tg->id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs creating of tag
+ */
+void vs_persist_tag_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+
+	if(persist != NULL) {
+		vs_persist_emit_tag(vs_persist_wal_write, persist, node, tg, tag);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs destroying of tag
+ */
+void vs_persist_tag_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_TAG_DESTROY, node->id);
+		rec.entity_id = tg->id;
+		rec.item_id = tag->id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs new value of tag
+ */
+void vs_persist_tag_set(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSTag *tag)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+
+	if(persist != NULL) {
+		vs_persist_emit_tag_value(vs_persist_wal_write, persist, node, tg, tag);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs creating of layer
+ */
+void vs_persist_layer_create(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+
+	if(persist != NULL) {
+		vs_persist_emit_layer(vs_persist_wal_write, persist, node, layer);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs destroying of layer and its child layers
+ */
+void vs_persist_layer_destroy(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_LAYER_DESTROY, node->id);
+		rec.entity_id = layer->id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs new value of layer item
+ */
+void vs_persist_layer_set(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id,
+		const void *value)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_LAYER_SET, node->id);
+		rec.entity_id = layer->id;
+		rec.item_id = item_id;
+		vs_persist_wal_write(persist, &rec, value, layer->values.value_size, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
+
+/**
+ * \brief This function logs unsetting of layer item
+ */
+void vs_persist_layer_unset(struct VS_CTX *vs_ctx,
+		struct VSNode *node,
+		struct VSLayer *layer,
+		uint32 item_id)
+{
+	struct VSPersist *persist = vs_persist_lock(vs_ctx, node);
+	struct VSPersistRecord rec;
+
+	if(persist != NULL) {
+		vs_persist_record_init(&rec, PERSIST_LAYER_UNSET, node->id);
+		rec.entity_id = layer->id;
+		rec.item_id = item_id;
+		vs_persist_wal_write(persist, &rec, NULL, 0, NULL, 0);
+		pthread_mutex_unlock(&persist->mutex);
+	}
+}
@@ -38,6 +38,7 @@
 #include "vs_taggroup.h"
 #include "vs_tag.h"
 #include "vs_layer.h"
+#include "vs_delta.h"
 
 
 /**
@@ -182,6 +183,7 @@ static void vs_layer_free_avatar_reference(struct VSNode *node,
 			if(layer_subscriber->node_sub->session->session_id == session->session_id) {
 				v_print_log(VRS_PRINT_DEBUG_MSG, "Free subscriber: %d from layer: %d\n",
 						session->avatar_id, layer->id);
+				vs_delta_destroy(&layer_subscriber->delta);
 				v_list_free_item(&layer->layer_subs, layer_subscriber);
 				break;
 			}
@@ -251,6 +253,11 @@ static void vs_free_avatar_reference(struct VSNode *node,
 			v_print_log(VRS_PRINT_DEBUG_MSG, "Free subscriber: %d from node: %d\n",
 					session->avatar_id, node->id);
 			v_list_free_item(&node->node_subs, node_subscriber);
+#ifdef WITH_MONGODB
+			if(node->node_subs.first == NULL) {
+				node->idle_since = time(NULL);
+			}
+#endif
 			if(was_locked == 0) {
 				/* No need to go through other subscribers,
 				 * because send_unlock needn't to be sent in this
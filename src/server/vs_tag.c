@@ -34,6 +34,7 @@
 #include "vs_node.h"
 #include "vs_node_access.h"
 #include "vs_taggroup.h"
+#include "vs_persist.h"
 
 /**
  * \brief This function add any TagSet command to the queue of outgoing commands
@@ -315,6 +316,7 @@ struct VSTag *vs_tag_create(struct VSTagGroup *tg,
 	}
 
 	vs_taggroup_inc_version(tg);
+	vs_journal_add(&tg->journal, tg->version, tag->id, JOURNAL_ITEM_CREATE);
 
 	return tag;
 }
@@ -328,6 +330,7 @@ struct VSTag *vs_tag_create(struct VSTagGroup *tg,
 int vs_tag_destroy(struct VSTagGroup *tg, struct VSTag *tag)
 {
 	if(tag->tag_folls.first == NULL) {
+		uint16 tag_id = tag->id;
 
 		/* Free value */
 		if(tag->value != NULL) {
@@ -341,6 +344,7 @@ int vs_tag_destroy(struct VSTagGroup *tg, struct VSTag *tag)
 		free(tag);
 
 		vs_taggroup_inc_version(tg);
+		vs_journal_add(&tg->journal, tg->version, tag_id, JOURNAL_ITEM_DESTROY);
 
 		return 1;
 	} else {
@@ -553,6 +557,11 @@ int vs_handle_tag_create(struct VS_CTX *vs_ctx,
 
 	tag->state = ENTITY_CREATING;
 
+	vs_persist_tag_create(vs_ctx, node, tg, tag);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
 	/* Send TagCreate to all subscribers of tag group */
 	tg_subscriber = tg->tg_subs.first;
 	while(tg_subscriber != NULL) {
@@ -625,6 +634,9 @@ int vs_handle_tag_destroy_ack(struct VS_CTX *vs_ctx,
 	if(tag->tag_folls.first == NULL) {
 		tag->state = ENTITY_DELETED;
 		vs_tag_destroy(tg, tag);
+#ifdef WITH_MONGODB
+		vs_mongo_node_dirty(vs_ctx, node);
+#endif
 	}
 
 	ret = 1;
@@ -692,6 +704,8 @@ int vs_handle_tag_destroy(struct VS_CTX *vs_ctx,
 
 	ret = vs_tag_send_destroy(node, tg, tag);
 
+	vs_persist_tag_destroy(vs_ctx, node, tg, tag);
+
 end:
 	pthread_mutex_unlock(&node->mutex);
 
@@ -712,6 +726,7 @@ int vs_handle_tag_set(struct VS_CTX *vs_ctx,
 	struct VSTagGroup			*tg;
 	struct VSTag				*tag;
 	struct VSEntitySubscriber	*tg_subscriber;
+	struct Generic_Cmd			*tag_set_cmd;
 	uint32 						node_id;
 	uint16 						taggroup_id;
 	uint16						tag_id;
@@ -827,14 +842,36 @@ int vs_handle_tag_set(struct VS_CTX *vs_ctx,
 	tag->flag = TAG_INITIALIZED;
 
 	vs_taggroup_inc_version(tg);
-
-	/* Send this tag to all client subscribed to the TagGroup */
-	tg_subscriber = tg->tg_subs.first;
-	while(tg_subscriber != NULL) {
-		if(vs_tag_send_set(tg_subscriber->node_sub->session, tg_subscriber->node_sub->prio, node, tg, tag) != 1) {
+	vs_journal_add(&tg->journal, tg->version, tag->id, JOURNAL_ITEM_CHANGE);
+
+	vs_persist_tag_set(vs_ctx, node, tg, tag);
+#ifdef WITH_MONGODB
+	vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
+	/* Send this tag to all client subscribed to the TagGroup. Command is
+	 * created only once and it is shared by all outgoing queues. */
+	if(tg->tg_subs.first != NULL) {
+		tag_set_cmd = v_tag_set_create(node->id, tg->id, tag->id,
+				tag->data_type, tag->count, tag->value);
+		if(tag_set_cmd == NULL) {
 			ret = 0;
+			goto end;
 		}
-		tg_subscriber = tg_subscriber->next;
+
+		tg_subscriber = tg->tg_subs.first;
+		while(tg_subscriber != NULL) {
+			if(v_out_queue_push_tail(tg_subscriber->node_sub->session->out_queue,
+					0,
+					tg_subscriber->node_sub->prio,
+					v_cmd_share(tag_set_cmd)) != 1)
+			{
+				ret = 0;
+			}
+			tg_subscriber = tg_subscriber->next;
+		}
+
+		v_cmd_destroy(&tag_set_cmd);
 	}
 
 end:
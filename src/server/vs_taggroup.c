@@ -29,8 +29,11 @@
 #include "vs_node.h"
 #include "vs_node_access.h"
 #include "vs_entity.h"
+#include "vs_persist.h"
 #include "v_common.h"
 #include "v_fake_commands.h"
+#include "v_tag_commands.h"
+#include "v_taggroup_commands.h"
 
 /**
  * \brief This function increments version of tag group
@@ -43,6 +46,8 @@ void vs_taggroup_inc_version(struct VSTagGroup *tg)
 	} else {
 		tg->version = 1;
 		tg->saved_version = 0;
+		/* Journal can't be used for versions before overflow */
+		vs_journal_reset(&tg->journal, tg->version, vs_journal_new_epoch());
 	}
 }
 
@@ -213,6 +218,7 @@ static void vs_taggroup_init(struct VSTagGroup *tg)
 	tg->version = 0;
 	tg->saved_version = -1;
 	tg->crc32 = 0;
+	vs_journal_init(&tg->journal, tg->version, vs_journal_new_epoch());
 
 #ifdef WITH_MONGODB
 	for(i=0; i<3; i++) {
@@ -280,6 +286,7 @@ struct VSTagGroup *vs_taggroup_create(struct VSNode *node,
 	tg->custom_type = custom_type;
 
 	vs_node_inc_version(node);
+	vs_journal_add(&node->tg_journal, node->version, tg->id, JOURNAL_ITEM_CREATE);
 
 	return tg;
 }
@@ -337,6 +344,7 @@ int vs_taggroup_destroy(struct VSNode *node, struct VSTagGroup *tg)
 {
 	struct VBucket *bucket;
 	struct VSTag *tag;
+	uint16 tg_id;
 
 	/* All clients had to received TagGroup_Destroy command */
 	assert(tg->tg_folls.first == NULL);
@@ -358,6 +366,7 @@ int vs_taggroup_destroy(struct VSNode *node, struct VSTagGroup *tg)
 
 	/* Destroy all tags in this taggroup */
 	v_hash_array_destroy(&tg->tags);
+	vs_journal_destroy(&tg->journal);
 
 	/* Free list of followers and subscribers */
 	v_list_free(&tg->tg_folls);
@@ -366,10 +375,12 @@ int vs_taggroup_destroy(struct VSNode *node, struct VSTagGroup *tg)
 	v_print_log(VRS_PRINT_DEBUG_MSG, "TagGroup: %d destroyed\n", tg->id);
 
 	/* Destroy this tag group itself */
+	tg_id = tg->id;
 	v_hash_array_remove_item(&node->tag_groups, tg);
 	free(tg);
 
 	vs_node_inc_version(node);
+	vs_journal_add(&node->tg_journal, node->version, tg_id, JOURNAL_ITEM_DESTROY);
 
 	return 1;
 }
@@ -407,6 +418,7 @@ int vs_node_taggroups_destroy(struct VSNode *node)
 
 		/* Destroy all tags in this taggroup */
 		v_hash_array_destroy(&tg->tags);
+		vs_journal_destroy(&tg->journal);
 
 		/* Free list of followers and subscribers */
 		v_list_free(&tg->tg_folls);
@@ -462,6 +474,9 @@ int vs_handle_taggroup_destroy_ack(struct VS_CTX *vs_ctx,
 	if(tg->tg_folls.first == NULL) {
 		tg->state = ENTITY_DELETED;
 		vs_taggroup_destroy(node, tg);
+#ifdef WITH_MONGODB
+		vs_mongo_node_dirty(vs_ctx, node);
+#endif
 	}
 
 	return 1;
@@ -614,6 +629,11 @@ int vs_handle_taggroup_create(struct VS_CTX *vs_ctx,
 		/* Set state for this entity */
 		tg->state = ENTITY_CREATING;
 
+		vs_persist_taggroup_create(vs_ctx, node, tg);
+#ifdef WITH_MONGODB
+		vs_mongo_node_dirty(vs_ctx, node);
+#endif
+
 		ret = 1;
 
 		/* Send tag group create command to all subscribers to the node
@@ -675,6 +695,8 @@ int vs_handle_taggroup_destroy(struct VS_CTX *vs_ctx,
 		}
 
 		ret = vs_taggroup_send_destroy(node, tg);
+
+		vs_persist_taggroup_destroy(vs_ctx, node, tg);
 	} else {
 		v_print_log(VRS_PRINT_DEBUG_MSG,
 				"%s(): user: %s can't write to node: %d\n",
@@ -690,6 +712,85 @@ end:
 	return ret;
 }
 
+/**
+ * \brief This function sends only tags changed since version held by client.
+ * Tags, that were not changed, are marked as known by the client without
+ * sending tag_create command.
+ */
+static void vs_taggroup_send_changes(struct VSEntitySubscriber *tg_subscriber,
+		struct VSNode *node,
+		struct VSTagGroup *tg,
+		struct VSJournalChange *changes,
+		int change_count)
+{
+	struct VSNodeSubscriber *node_subscriber = tg_subscriber->node_sub;
+	struct VSession *vsession = node_subscriber->session;
+	struct VSJournalChange *change;
+	struct VSEntityFollower *tag_follower;
+	struct Generic_Cmd *tag_destroy_cmd;
+	struct VSTag *tag, find_tag;
+	struct VBucket *bucket;
+	int i;
+
+	for(bucket = tg->tags.lb.first; bucket != NULL; bucket = bucket->next) {
+		tag = (struct VSTag*)bucket->data;
+		change = vs_journal_find_change(changes, change_count, tag->id);
+
+		if(change != NULL && (change->created == 1 || change->destroyed == 1)) {
+			/* Client could know destroyed tag with the same ID */
+			if(change->created == 0) {
+				tag_destroy_cmd = v_tag_destroy_create(node->id, tg->id, tag->id);
+				if(tag_destroy_cmd != NULL) {
+					v_out_queue_push_tail(vsession->out_queue, 0,
+							node_subscriber->prio, tag_destroy_cmd);
+				}
+			}
+			/* Tag was created after version held by client */
+			vs_tag_send_create(tg_subscriber, node, tg, tag);
+			if( ((vsession->flags & VRS_TP_TCP) ||
+					(vsession->flags & VRS_TP_WEBSOCKET)) &&
+					(tag->flag & TAG_INITIALIZED))
+			{
+				vs_tag_send_set(vsession, node_subscriber->prio, node, tg, tag);
+			}
+		} else if(tag->state == ENTITY_CREATING || tag->state == ENTITY_CREATED) {
+			/* Client already knows this tag */
+			tag_follower = (struct VSEntityFollower*)calloc(1, sizeof(struct VSEntityFollower));
+			if(tag_follower != NULL) {
+				tag_follower->node_sub = node_subscriber;
+				tag_follower->state = ENTITY_CREATED;
+				v_list_add_tail(&tag->tag_folls, tag_follower);
+			}
+			if(change != NULL && (tag->flag & TAG_INITIALIZED)) {
+				vs_tag_send_set(vsession, node_subscriber->prio, node, tg, tag);
+			}
+		} else {
+			/* Tag known by client is being destroyed */
+			tag_destroy_cmd = v_tag_destroy_create(node->id, tg->id, tag->id);
+			if(tag_destroy_cmd != NULL) {
+				v_out_queue_push_tail(vsession->out_queue, 0,
+						node_subscriber->prio, tag_destroy_cmd);
+			}
+		}
+	}
+
+	/* Send tag_destroy for tags, that were destroyed since version held
+	 * by client */
+	for(i = 0; i < change_count; i++) {
+		if(changes[i].created == 1) {
+			continue;
+		}
+		find_tag.id = (uint16)changes[i].item_id;
+		if(v_hash_array_find_item(&tg->tags, &find_tag) == NULL) {
+			tag_destroy_cmd = v_tag_destroy_create(node->id, tg->id, find_tag.id);
+			if(tag_destroy_cmd != NULL) {
+				v_out_queue_push_tail(vsession->out_queue, 0,
+						node_subscriber->prio, tag_destroy_cmd);
+			}
+		}
+	}
+}
+
 /**
  * \brief This function handle node_subscribe command
  */
@@ -700,6 +801,8 @@ int vs_handle_taggroup_subscribe(struct VS_CTX *vs_ctx,
 	struct VSNode	*node;
 	uint32			node_id = UINT32(taggroup_subscribe->data[0]);
 	uint16			taggroup_id = UINT16(taggroup_subscribe->data[UINT32_SIZE]);
+	uint32			version = UINT32(taggroup_subscribe->data[UINT32_SIZE + UINT16_SIZE]);
+	uint32			epoch = UINT32(taggroup_subscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE]);
 	int				ret = 0;
 
 	/* Try to find node */
@@ -723,6 +826,8 @@ int vs_handle_taggroup_subscribe(struct VS_CTX *vs_ctx,
 		struct VSTag				*tag;
 		struct VSEntitySubscriber	*tg_subscriber;
 		struct VBucket				*bucket;
+		struct VSJournalChange		*changes;
+		int							change_count;
 
 		/* Try to find node subscriber */
 		node_subscriber = node->node_subs.first;
@@ -766,8 +871,28 @@ int vs_handle_taggroup_subscribe(struct VS_CTX *vs_ctx,
 		/* Add new subscriber to the list of tag group subscribers */
 		tg_subscriber = (struct VSEntitySubscriber*)malloc(sizeof(struct VSEntitySubscriber));
 		tg_subscriber->node_sub = node_subscriber;
+		tg_subscriber->precision = VRS_LAYER_PRECISION_FULL;
+		tg_subscriber->delta = NULL;
 		v_list_add_tail(&tg->tg_subs, tg_subscriber);
 
+		/* When client holds version covered by journal, then send only
+		 * changes since this version */
+		if(version != 0) {
+			change_count = vs_journal_changes(&tg->journal, epoch, version,
+					tg->version, &changes);
+			if(change_count >= 0) {
+				v_print_log(VRS_PRINT_DEBUG_MSG,
+						"%s() sending %d changes of tag_group (id: %d) since version: %u\n",
+						__func__, change_count, tg->id, version);
+				vs_taggroup_send_changes(tg_subscriber, node, tg,
+						changes, change_count);
+				if(changes != NULL) {
+					free(changes);
+				}
+				goto end;
+			}
+		}
+
 		/* Try to send tag_create for all tags in this tag group */
 		bucket = tg->tags.lb.first;
 		while(bucket != NULL) {
@@ -809,6 +934,8 @@ int vs_handle_taggroup_unsubscribe(struct VS_CTX *vs_ctx,
 	struct VSTagGroup			*tg;
 	uint32						node_id = UINT32(taggroup_unsubscribe->data[0]);
 	uint16						taggroup_id = UINT16(taggroup_unsubscribe->data[UINT32_SIZE]);
+	uint8						versing = UINT8(taggroup_unsubscribe->data[UINT32_SIZE + UINT16_SIZE + UINT32_SIZE + UINT32_SIZE]);
+	struct Generic_Cmd			*unsubscribe_cmd;
 	int							ret = 0;
 
 	/* Try to find node */
@@ -831,6 +958,16 @@ int vs_handle_taggroup_unsubscribe(struct VS_CTX *vs_ctx,
 			ret = 0;
 		} else {
 			ret = vs_taggroup_unsubscribe(tg, vsession);
+			/* When client requested versing, then send it version of tag
+			 * group, that could be used for next subscribing */
+			if(ret == 1 && versing != 0) {
+				unsubscribe_cmd = v_taggroup_unsubscribe_create(node->id,
+						tg->id, tg->version, tg->crc32, 0, tg->journal.epoch);
+				if(unsubscribe_cmd != NULL) {
+					v_out_queue_push_tail(vsession->out_queue, 0,
+							VRS_DEFAULT_PRIORITY, unsubscribe_cmd);
+				}
+			}
 		}
 	}
 
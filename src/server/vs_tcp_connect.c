@@ -49,6 +49,7 @@
 #include "vs_main.h"
 #include "vs_tcp_connect.h"
 #include "vs_udp_connect.h"
+#include "vs_dgram_worker.h"
 #include "vs_auth_pam.h"
 #include "vs_auth_csv.h"
 #include "vs_node.h"
@@ -219,13 +220,19 @@ end:
 			v_print_log(VRS_PRINT_DEBUG_MSG, "UDP thread was not joined\n");
 		}
 	}
+#ifdef WITH_EPOLL
+	else {
+		/* Wait for datagram worker to release connection of this session */
+		vs_dgram_workers_wait_conn(vs_ctx, vsession);
+	}
+#endif
 
-	pthread_mutex_lock(&vs_ctx->data.mutex);
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
 	/* Unsubscribe this session (this avatar) from all nodes */
 	vs_node_free_avatar_reference(vs_ctx, vsession);
 	/* Try to destroy avatar node */
 	vs_node_destroy_avatar_node(vs_ctx, vsession);
-	pthread_mutex_unlock(&vs_ctx->data.mutex);
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
 
 	/* Close socket */
 	if(io_ctx->sockfd != -1) {
@@ -861,6 +868,11 @@ static int vs_init_sessions(VS_CTX *vs_ctx)
 
 	vs_ctx->connected_clients = 0;
 
+	/* Initialize ring of sessions with received commands */
+	if(v_ready_ring_init(&vs_ctx->data.ready_sessions, vs_ctx->max_sessions) != 1) {
+		return -1;
+	}
+
 	/* Initialize list of connections */
 	vs_ctx->vsessions = (struct VSession**)calloc(vs_ctx->max_sessions, sizeof(struct VSession*));
 	for (i=0; i<vs_ctx->max_sessions; i++) {
@@ -873,6 +885,10 @@ static int vs_init_sessions(VS_CTX *vs_ctx)
 		/* Set up input and output queues */
 		vs_ctx->vsessions[i]->in_queue = (struct VInQueue*)calloc(1, sizeof(VInQueue));
 		v_in_queue_init(vs_ctx->vsessions[i]->in_queue, vs_ctx->in_queue_max_size);
+		v_in_queue_set_ready_ring(vs_ctx->vsessions[i]->in_queue,
+				&vs_ctx->data.ready_sessions, vs_ctx->vsessions[i]);
+		/* Data thread decodes long commands from received data */
+		vs_ctx->vsessions[i]->in_queue->cmd_views = 1;
 		vs_ctx->vsessions[i]->out_queue = (struct VOutQueue*)calloc(1, sizeof(VOutQueue));
 		v_out_queue_init(vs_ctx->vsessions[i]->out_queue, vs_ctx->out_queue_max_size);
 		/* Allocate memory for TCP connection */
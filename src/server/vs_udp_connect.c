@@ -60,6 +60,7 @@
 #include "v_session.h"
 
 #include "v_unpack.h"
+#include "v_compress.h"
 
 static void vs_LISTEN_init(struct vContext *C);
 static void vs_RESPOND_init(struct vContext *C);
@@ -73,6 +74,16 @@ static int dtls_cookie_initialized = 0;
 static unsigned char dtls_cookie_secret[DTLS_COOKIE_SECRET_LENGTH];
 #endif
 
+/**
+ * \brief This function returns 1, when server is able to use proposed method
+ * of Congestion Control. Server supports configured method and method
+ * CC_NONE for clients that do not support configured method.
+ */
+static int vs_cc_meth_is_supported(struct VS_CTX *vs_ctx, uint8 cc_meth)
+{
+	return (cc_meth == vs_ctx->cc_meth || cc_meth == CC_NONE) ? 1 : 0;
+}
+
 /* Initialize VConnection at Verse server for potential clients */
 void vs_init_dgram_conn(struct VDgramConn *dgram_conn)
 {
@@ -238,7 +249,7 @@ static int vs_LISTEN_CHANGE_L_cb(struct vContext *C, struct Generic_Cmd *cmd)
 			if(change_l_cmd->value[value_rank].uint8 == CC_RESERVED) {
 				break;
 			/* TODO: better implementation: server could have list of supported CC methods */
-			} else if(change_l_cmd->value[value_rank].uint8 == vs_ctx->cc_meth) {
+			} else if(vs_cc_meth_is_supported(vs_ctx, change_l_cmd->value[value_rank].uint8) == 1) {
 				/* It will try to use first found supported method, but ... */
 				if(dgram_conn->cc_meth == CC_RESERVED) {
 					/* Congestion Control has not been proposed yet */
@@ -255,6 +266,8 @@ static int vs_LISTEN_CHANGE_L_cb(struct vContext *C, struct Generic_Cmd *cmd)
 				}
 				tmp = 1;
 				dgram_conn->cc_meth = change_l_cmd->value[value_rank].uint8;
+				/* Use configured algorithm of congestion control */
+				v_cc_init(dgram_conn, vs_ctx->cc_alg);
 				break;
 			}
 		}
@@ -279,9 +292,7 @@ static int vs_LISTEN_CHANGE_L_cb(struct vContext *C, struct Generic_Cmd *cmd)
 	/* Client wants to negotiate type of command compression */
 	if(change_l_cmd->feature == FTR_CMD_COMPRESS) {
 		for(value_rank=0; value_rank<change_l_cmd->count; value_rank++) {
-			if(change_l_cmd->value[value_rank].uint8 == CMPR_NONE ||
-					change_l_cmd->value[value_rank].uint8 == CMPR_ADDR_SHARE)
-			{
+			if(v_compress_is_supported(change_l_cmd->value[value_rank].uint8) == 1) {
 				dgram_conn->peer_cmd_cmpr = change_l_cmd->value[value_rank].uint8;
 				tmp = 1;
 				break;
@@ -318,7 +329,7 @@ static int	vs_LISTEN_CHANGE_R_cb(struct vContext *C, struct Generic_Cmd *cmd)
 			/* This could not be never send */
 			if(change_r_cmd->value[value_rank].uint8 == CC_RESERVED) {
 				break;
-			} else if(change_r_cmd->value[value_rank].uint8 == vs_ctx->cc_meth) { /* TODO: better implementation */
+			} else if(vs_cc_meth_is_supported(vs_ctx, change_r_cmd->value[value_rank].uint8) == 1) {
 				/* It will try to use first found supported method, but ... */
 				if(dgram_conn->cc_meth == CC_RESERVED) {
 					/* Congestion Control has not been proposed yet */
@@ -335,6 +346,8 @@ static int	vs_LISTEN_CHANGE_R_cb(struct vContext *C, struct Generic_Cmd *cmd)
 				}
 				tmp = 1;
 				dgram_conn->cc_meth = change_r_cmd->value[value_rank].uint8;
+				/* Use configured algorithm of congestion control */
+				v_cc_init(dgram_conn, vs_ctx->cc_alg);
 				break;
 			}
 		}
@@ -349,9 +362,7 @@ static int	vs_LISTEN_CHANGE_R_cb(struct vContext *C, struct Generic_Cmd *cmd)
 	/* Client wants to negotiate type of command compression */
 	if(change_r_cmd->feature == FTR_CMD_COMPRESS) {
 		for(value_rank=0; value_rank<change_r_cmd->count; value_rank++) {
-			if(change_r_cmd->value[value_rank].uint8 == CMPR_NONE ||
-					change_r_cmd->value[value_rank].uint8 == CMPR_ADDR_SHARE)
-			{
+			if(v_compress_is_supported(change_r_cmd->value[value_rank].uint8) == 1) {
 				dgram_conn->host_cmd_cmpr = change_r_cmd->value[value_rank].uint8;
 				tmp = 1;
 				break;
@@ -701,8 +712,9 @@ static void vs_RESPOND_init(struct vContext *C)
 	dgram_conn->peer_id = r_packet->header.payload_id;
 
 	/* When unsecured connection is used, then "connect" server to the client
-	 * after first phase of handshake */
-	if(!(dgram_conn->flags & SOCKET_SECURED)) {
+	 * after first phase of handshake. Shared socket can not be connected. */
+	if(!(dgram_conn->flags & SOCKET_SECURED) &&
+			!(io_ctx->flags & SOCKET_SHARED)) {
 		/* When handshake is finished, then do connect */
 		if(io_ctx->peer_addr.ip_ver == IPV4) {
 			ret = connect(io_ctx->sockfd, (struct sockaddr*)&io_ctx->peer_addr.addr.ipv4, sizeof(io_ctx->peer_addr.addr.ipv4));
@@ -1375,30 +1387,35 @@ static int vs_init_dgram_ctx(struct vContext *C)
 /************************************** MAIN loop **************************************/
 
 /**
- * \brief Main UDP thread. This thread waits for connection from client. It
- * expects connection from certain IP address and client has to send negotiated
- * token in its REQUEST state.
- * \param[in]	*arg	The void pointer is pointer at copy of Verse context.
- * \return		This thread does not return any usefull information now.
+ * \brief This function creates socket of datagram connection and it switches
+ * connection to the LISTEN state. Connection waits for packet from client
+ * after this function.
+ * \param[in]	*C	The copy of Verse context for this datagram connection
+ * \return		This function returns 1, when datagram connection was opened
+ * and it returns 0, when it was not possible to open connection.
  */
-void *vs_main_dgram_loop(void *arg)
+int vs_dgram_conn_open(struct vContext *C)
 {
-	struct vContext *C = (struct vContext*)arg;
 	struct VS_CTX *vs_ctx = CTX_server_ctx(C);
 	struct VSession *vsession = CTX_current_session(C);
-	struct VDgramConn *dgram_conn=vsession->dgram_conn;
-	struct VPacket *r_packet=NULL, *s_packet=NULL;
-	struct timeval tv;
-	fd_set set;
-	int i, j, ret, error_num;
+	struct VDgramConn *dgram_conn = vsession->dgram_conn;
 
 	/* Set up datagram connection */
 	CTX_current_dgram_conn_set(C, dgram_conn);
 
 	/* Copy version of IP from Verse server context */
 	dgram_conn->io_ctx.host_addr.ip_ver = vs_ctx->tcp_io_ctx.host_addr.ip_ver;
-	if (vs_init_dgram_ctx(C) != 1) {
-		goto end;
+
+	if(vs_ctx->dgram_shared_port != 0 &&
+			dgram_conn->io_ctx.host_addr.port == vs_ctx->dgram_shared_port)
+	{
+		/* Connection will use socket shared by many connections. The socket
+		 * is assigned by datagram worker, that receives first packet with
+		 * negotiated token. */
+		dgram_conn->io_ctx.host_addr.protocol = UDP;
+		dgram_conn->io_ctx.flags = SOCKET_SHARED;
+	} else if (vs_init_dgram_ctx(C) != 1) {
+		return 0;
 	}
 
 	/* Set up IO CTX */
@@ -1407,7 +1424,7 @@ void *vs_main_dgram_loop(void *arg)
 #if (defined WITH_OPENSSL) && OPENSSL_VERSION_NUMBER>=0x10000000
 	if(vsession->flags & VRS_SEC_DATA_TLS) {
 		if( vs_init_dtls_connection(C) == 0) {
-			goto end;
+			return 0;
 		}
 		/*dgram_conn->io_ctx.mtu -= 100;*/
 		dgram_conn->flags |= SOCKET_SECURED;
@@ -1421,6 +1438,221 @@ void *vs_main_dgram_loop(void *arg)
 	dgram_conn->io_ctx.flags &= ~SOCKET_SECURED;
 #endif
 
+	vs_LISTEN_init(C);
+
+	return 1;
+}
+
+/**
+ * \brief This function handles packet received to the buffer of datagram
+ * connection according state of connection.
+ * \param[in]	*C	The copy of Verse context for this datagram connection
+ * \return		This function returns VS_DGRAM_CONN_RESTART, when DTLS
+ * handshake should be restarted, otherwise it returns VS_DGRAM_CONN_CONTINUE.
+ */
+int vs_dgram_conn_handle_received(struct vContext *C)
+{
+	struct VSession *vsession = CTX_current_session(C);
+	struct VDgramConn *dgram_conn = CTX_current_dgram_conn(C);
+	struct VPacket *r_packet = CTX_r_packet(C);
+	struct timeval tv;
+	int ret = RECEIVE_PACKET_ERROR;
+
+	/* Check if the packet is from the authenticated client */
+	if((dgram_conn->io_ctx.flags & SOCKET_CONNECTED) ||
+			v_compare_addr(&vsession->peer_address, &dgram_conn->io_ctx.peer_addr)==1) {
+
+		/* Get time of receiving packet */
+		gettimeofday(&tv, NULL);
+
+		/* Handle packet according state of connection */
+		switch(dgram_conn->host_state) {
+		case UDP_SERVER_STATE_LISTEN:
+			ret = vs_handle_packet(C, vs_LISTEN_handle_packet);
+			break;
+		case UDP_SERVER_STATE_RESPOND:
+			ret = vs_handle_packet(C, vs_RESPOND_handle_packet);
+			break;
+		case UDP_SERVER_STATE_OPEN:
+			ret = vs_handle_packet(C, vs_OPEN_CLOSEREQ_handle_packet);
+			break;
+		case UDP_SERVER_STATE_CLOSEREQ:
+			ret = vs_handle_packet(C, vs_OPEN_CLOSEREQ_handle_packet);
+			break;
+		case UDP_SERVER_STATE_CLOSED:
+			ret = vs_handle_packet(C, vs_CLOSED_handle_packet);
+			break;
+		default:
+			break;
+		}
+
+		/* Update time of last receiving payload packet for
+		 * current connection */
+		if(r_packet->header.flags & PAY_FLAG) {
+			dgram_conn->tv_pay_recv.tv_sec = tv.tv_sec;
+			dgram_conn->tv_pay_recv.tv_usec = tv.tv_usec;
+		}
+
+		/* Handle returned values */
+		switch(ret) {
+		case RECEIVE_PACKET_ATTEMPTS_EXCEED:
+			return VS_DGRAM_CONN_RESTART;
+		case RECEIVE_PACKET_CORRUPTED:
+			if(dgram_conn->host_state == UDP_SERVER_STATE_LISTEN)
+				vs_LISTEN_init(C);
+			break;
+		default:
+			break;
+		}
+	} else {
+		if(is_log_level(VRS_PRINT_WARNING)) {
+			v_print_log(VRS_PRINT_WARNING, "Client sent packet from wrong address: ");
+			v_print_addr(VRS_PRINT_WARNING, &dgram_conn->io_ctx.peer_addr);
+			v_print_log_simple(VRS_PRINT_WARNING, " != ");
+			v_print_addr(VRS_PRINT_WARNING, &vsession->peer_address);
+			v_print_log_simple(VRS_PRINT_WARNING, "\n");
+		}
+	}
+
+	return VS_DGRAM_CONN_CONTINUE;
+}
+
+/**
+ * \brief This function tries to receive one packet from the socket of datagram
+ * connection and it handles this packet according state of connection.
+ * \param[in]	*C	The copy of Verse context for this datagram connection
+ * \return		This function returns VS_DGRAM_CONN_CLOSE, when connection
+ * should be closed, VS_DGRAM_CONN_RESTART, when DTLS handshake should be
+ * restarted, otherwise it returns VS_DGRAM_CONN_CONTINUE.
+ */
+int vs_dgram_conn_receive(struct vContext *C)
+{
+	struct VDgramConn *dgram_conn = CTX_current_dgram_conn(C);
+	int ret, error_num;
+
+	/* Try to receive packet */
+	ret = v_receive_packet(&dgram_conn->io_ctx, &error_num);
+
+	/* If receiving of packet was successful, then process the packet */
+	if((ret==1) && (dgram_conn->io_ctx.buf_size > 0)) {
+		return vs_dgram_conn_handle_received(C);
+	} else {
+		if(error_num == ECONNREFUSED) {
+			v_print_log(VRS_PRINT_WARNING, "Closing connection ...\n");
+			return VS_DGRAM_CONN_CLOSE;
+		}
+	}
+
+	return VS_DGRAM_CONN_CONTINUE;
+}
+
+/**
+ * \brief This function checks timeouts of datagram connection and it sends
+ * payload packets, when connection is in OPEN state. It has to be called at
+ * least with frequency of negotiated FPS and after each received packet.
+ * \param[in]	*C	The copy of Verse context for this datagram connection
+ * \return		This function returns VS_DGRAM_CONN_CLOSE, when connection
+ * timed out, otherwise it returns VS_DGRAM_CONN_CONTINUE.
+ */
+int vs_dgram_conn_update(struct vContext *C)
+{
+	struct VSession *vsession = CTX_current_session(C);
+	struct VDgramConn *dgram_conn = CTX_current_dgram_conn(C);
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	/* Check if token is still fresh */
+	if(dgram_conn->host_state == UDP_SERVER_STATE_LISTEN &&
+			(tv.tv_sec - vsession->peer_token.tv.tv_sec) > VRS_TIMEOUT) {
+		v_print_log(VRS_PRINT_ERROR, "Token timed out\n");
+		return VS_DGRAM_CONN_CLOSE;
+	}
+
+	if(dgram_conn->host_state != UDP_SERVER_STATE_LISTEN) {
+
+		/* Verse server has to try to send payload packets with negotiated FPSs */
+		if(dgram_conn->host_state == UDP_SERVER_STATE_OPEN) {
+			vs_OPEN_CLOSEREQ_send_packet(C);
+		} else {
+			/* When client is too long in the handshake or teardown
+			 * state, then terminate connection. */
+			if((tv.tv_sec - dgram_conn->state[dgram_conn->host_state].tv_state_began.tv_sec) >= VRS_TIMEOUT) {
+				v_print_log(VRS_PRINT_DEBUG_MSG, "Connection timed out\n");
+				return VS_DGRAM_CONN_CLOSE;
+			}
+		}
+
+		/* When no valid packet received from client for defined time, then consider this
+		 * connection as dead and free it */
+		if((tv.tv_sec - dgram_conn->tv_pay_recv.tv_sec) >= VRS_TIMEOUT) {
+			v_print_log(VRS_PRINT_DEBUG_MSG, "Connection timed out\n");
+			return VS_DGRAM_CONN_CLOSE;
+		}
+	}
+
+	return VS_DGRAM_CONN_CONTINUE;
+}
+
+/**
+ * \brief This function decreases aggregation of port from the port range.
+ * Shared port is not part of port range and it is ignored.
+ * \param[in]	*vs_ctx	The verse server context
+ * \param[in]	port	The number of port used by datagram connection
+ */
+void vs_dgram_port_free(struct VS_CTX *vs_ctx, unsigned short port)
+{
+	int i, j;
+
+	for(i=vs_ctx->port_low, j=0; i<vs_ctx->port_high; i++, j++) {
+		if(port == vs_ctx->port_list[j].port_number) {
+			v_print_log(VRS_PRINT_DEBUG_MSG, "Free port: %d\n", vs_ctx->port_list[j].port_number);
+			vs_ctx->port_list[j].aggregation--;
+			break;
+		}
+	}
+}
+
+/**
+ * \brief This function frees port used by datagram connection and it clears
+ * datagram connection for other session.
+ * \param[in]	*C	The copy of Verse context for this datagram connection
+ */
+void vs_dgram_conn_release(struct vContext *C)
+{
+	struct VS_CTX *vs_ctx = CTX_server_ctx(C);
+	struct VSession *vsession = CTX_current_session(C);
+	struct VDgramConn *dgram_conn = vsession->dgram_conn;
+
+	/* Free port used by datagram connection */
+	vs_dgram_port_free(vs_ctx, dgram_conn->io_ctx.host_addr.port);
+
+	/* Clear this datagram connection for other session */
+	vs_clear_vconn(dgram_conn);
+}
+
+/**
+ * \brief Main UDP thread. This thread waits for connection from client. It
+ * expects connection from certain IP address and client has to send negotiated
+ * token in its REQUEST state. This thread is used only for connections, that
+ * are not handled by shared datagram workers (DTLS connections).
+ * \param[in]	*arg	The void pointer is pointer at copy of Verse context.
+ * \return		This thread does not return any usefull information now.
+ */
+void *vs_main_dgram_loop(void *arg)
+{
+	struct vContext *C = (struct vContext*)arg;
+	struct VSession *vsession = CTX_current_session(C);
+	struct VDgramConn *dgram_conn=vsession->dgram_conn;
+	struct VPacket *r_packet=NULL, *s_packet=NULL;
+	struct timeval tv;
+	fd_set set;
+	int ret;
+
+	if(vs_dgram_conn_open(C) != 1) {
+		goto end;
+	}
+
 	/* Packet structure for receiving */
 	r_packet = (struct VPacket*)calloc(1, sizeof(struct VPacket));
 	CTX_r_packet_set(C, r_packet);
@@ -1429,8 +1661,6 @@ void *vs_main_dgram_loop(void *arg)
 	s_packet = (struct VPacket*)calloc(1, sizeof(struct VPacket));
 	CTX_s_packet_set(C, s_packet);
 
-	vs_LISTEN_init(C);
-
 hello:
 #if (defined WITH_OPENSSL) && OPENSSL_VERSION_NUMBER>=0x10000000
 	/* Wait for DTLS Hello Command from client */
@@ -1537,15 +1767,6 @@ again:
 
 	/* "Never ending" listen loop */
 	while(1) {
-		gettimeofday(&tv, NULL);
-
-		/* Check if token is still fresh */
-		if(dgram_conn->host_state == UDP_SERVER_STATE_LISTEN &&
-				(tv.tv_sec - vsession->peer_token.tv.tv_sec) > VRS_TIMEOUT) {
-			v_print_log(VRS_PRINT_ERROR, "Token timed out\n");
-			goto end;
-		}
-
 		/* Initialize set */
 		FD_ZERO(&set);
 		FD_SET(dgram_conn->io_ctx.sockfd, &set);
@@ -1561,74 +1782,11 @@ again:
 		}
 		/* Check if the event occurred on sockfd */
 		else if(ret>0 && FD_ISSET(dgram_conn->io_ctx.sockfd, &set)) {
-
-			/* Try to receive packet */
-			ret = v_receive_packet(&dgram_conn->io_ctx, &error_num);
-
-			/* If receiving of packet was successful, then process the packet */
-			if((ret==1) && (dgram_conn->io_ctx.buf_size > 0)) {
-
-				/* Check if the packet is from the authenticated client */
-				if((dgram_conn->io_ctx.flags & SOCKET_CONNECTED) ||
-						v_compare_addr(&vsession->peer_address, &dgram_conn->io_ctx.peer_addr)==1) {
-
-					/* Get time of receiving packet */
-					gettimeofday(&tv, NULL);
-
-					/* Handle packet according state of connection */
-					switch(dgram_conn->host_state) {
-					case UDP_SERVER_STATE_LISTEN:
-						ret = vs_handle_packet(C, vs_LISTEN_handle_packet);
-						break;
-					case UDP_SERVER_STATE_RESPOND:
-						ret = vs_handle_packet(C, vs_RESPOND_handle_packet);
-						break;
-					case UDP_SERVER_STATE_OPEN:
-						ret = vs_handle_packet(C, vs_OPEN_CLOSEREQ_handle_packet);
-						break;
-					case UDP_SERVER_STATE_CLOSEREQ:
-						ret = vs_handle_packet(C, vs_OPEN_CLOSEREQ_handle_packet);
-						break;
-					case UDP_SERVER_STATE_CLOSED:
-						ret = vs_handle_packet(C, vs_CLOSED_handle_packet);
-						break;
-					default:
-						break;
-					}
-
-					/* Update time of last receiving payload packet for
-					 * current connection */
-					if(r_packet->header.flags & PAY_FLAG) {
-						dgram_conn->tv_pay_recv.tv_sec = tv.tv_sec;
-						dgram_conn->tv_pay_recv.tv_usec = tv.tv_usec;
-					}
-
-					/* Handle returned values */
-					switch(ret) {
-					case RECEIVE_PACKET_ATTEMPTS_EXCEED:
-						goto hello;
-						break;
-					case RECEIVE_PACKET_CORRUPTED:
-						if(dgram_conn->host_state == UDP_SERVER_STATE_LISTEN)
-							vs_LISTEN_init(C);
-						break;
-					default:
-						break;
-					}
-				} else {
-					if(is_log_level(VRS_PRINT_WARNING)) {
-						v_print_log(VRS_PRINT_WARNING, "Client sent packet from wrong address: ");
-						v_print_addr(VRS_PRINT_WARNING, &dgram_conn->io_ctx.peer_addr);
-						v_print_log_simple(VRS_PRINT_WARNING, " != ");
-						v_print_addr(VRS_PRINT_WARNING, &vsession->peer_address);
-						v_print_log_simple(VRS_PRINT_WARNING, "\n");
-					}
-				}
-			} else {
-				if(error_num == ECONNREFUSED) {
-					v_print_log(VRS_PRINT_WARNING, "Closing connection ...\n");
-					break;
-				}
+			ret = vs_dgram_conn_receive(C);
+			if(ret == VS_DGRAM_CONN_RESTART) {
+				goto hello;
+			} else if(ret == VS_DGRAM_CONN_CLOSE) {
+				break;
 			}
 		}
 
@@ -1642,44 +1800,13 @@ again:
 		}
 #endif
 
-		gettimeofday(&tv, NULL);
-		if(dgram_conn->host_state != UDP_SERVER_STATE_LISTEN) {
-
-			/* Verse server has to try to send payload packets with negotiated FPSs */
-			if(dgram_conn->host_state == UDP_SERVER_STATE_OPEN) {
-				vs_OPEN_CLOSEREQ_send_packet(C);
-			} else {
-				/* When client is too long in the handshake or teardown
-				 * state, then terminate connection. */
-				if((tv.tv_sec - dgram_conn->state[dgram_conn->host_state].tv_state_began.tv_sec) >= VRS_TIMEOUT) {
-					v_print_log(VRS_PRINT_DEBUG_MSG, "Connection timed out\n");
-					break;
-				}
-			}
-
-			/* When no valid packet received from client for defined time, then consider this
-			 * connection as dead and free it */
-			if((tv.tv_sec - dgram_conn->tv_pay_recv.tv_sec) >= VRS_TIMEOUT) {
-				v_print_log(VRS_PRINT_DEBUG_MSG, "Connection timed out\n");
-				break;
-			}
-
-		}
-	}
-
-end:
-
-	/* Free port used by datagram connection */
-	for(i=vs_ctx->port_low, j=0; i<vs_ctx->port_high; i++, j++) {
-		if(dgram_conn->io_ctx.host_addr.port == vs_ctx->port_list[j].port_number) {
-			v_print_log(VRS_PRINT_DEBUG_MSG, "Free port: %d\n", vs_ctx->port_list[j].port_number);
-			vs_ctx->port_list[j].aggregation--;
+		if(vs_dgram_conn_update(C) == VS_DGRAM_CONN_CLOSE) {
 			break;
 		}
 	}
 
-	/* Clear this datagram connection for other session */
-	vs_clear_vconn(dgram_conn);
+end:
+	vs_dgram_conn_release(C);
 
 	free(r_packet);
 	free(s_packet);
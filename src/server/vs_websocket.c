@@ -777,12 +777,12 @@ end:
 	}
 
 
-	pthread_mutex_lock(&vs_ctx->data.mutex);
+	pthread_rwlock_wrlock(&vs_ctx->data.lock);
 	/* Unsubscribe this session (this avatar) from all nodes */
 	vs_node_free_avatar_reference(vs_ctx, vsession);
 	/* Try to destroy avatar node */
 	vs_node_destroy_avatar_node(vs_ctx, vsession);
-	pthread_mutex_unlock(&vs_ctx->data.mutex);
+	pthread_rwlock_unlock(&vs_ctx->data.lock);
 
 	/* This session could be used again for authentication */
 	stream_conn->host_state = TCP_SERVER_STATE_LISTEN;
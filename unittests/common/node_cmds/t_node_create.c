@@ -40,6 +40,8 @@
 #include "v_node_commands.h"
 #include "v_in_queue.h"
 #include "v_out_queue.h"
+#include "v_fake_commands.h"
+#include "v_sys_commands.h"
 
 #define CHUNK_NUM	4
 #define CHUNK_SIZE	4
@@ -258,6 +260,92 @@ START_TEST( test_Node_Create_out_queue )
 }
 END_TEST
 
+/**
+ * \brief Test scheduling of priority queues in outgoing queue
+ */
+START_TEST( test_Node_Create_out_queue_sched )
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct VOutQueueSched sched;
+	struct VOutQueueBatch batch;
+	struct Generic_Cmd *node_create;
+	int i, j, packet, popped = 0;
+
+	/* Commands of the first chunk share address */
+	for(j=0; j<CHUNK_SIZE; j++) {
+		node_create = v_node_create_create(cmd_values[0][j].node_id,
+				cmd_values[0][j].parent_id,
+				cmd_values[0][j].user_id,
+				cmd_values[0][j].type);
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, node_create);
+	}
+
+	/* Command with higher priority is pushed as the last one */
+	node_create = v_node_create_create(cmd_values[2][0].node_id,
+			cmd_values[2][0].parent_id,
+			cmd_values[2][0].user_id,
+			cmd_values[2][0].type);
+	v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY + 1, node_create);
+
+	v_out_queue_sched_init(&sched, out_queue, 1500, CMPR_ADDR_SHARE);
+
+	/* Command with higher priority has to be popped first */
+	fail_unless( v_out_queue_sched_pop(&sched, 1500, &batch) == 1,
+			"Command with higher priority was not popped");
+	fail_unless( batch.prio == VRS_DEFAULT_PRIORITY + 1 && batch.compressed == 0,
+			"Batch with wrong priority: %d", batch.prio);
+	fail_unless( UINT32(batch.cmds[0]->data[2+4]) == cmd_values[2][0].node_id,
+			"Node_Create Node_ID: %d != %d",
+			UINT32(batch.cmds[0]->data[2+4]), cmd_values[2][0].node_id);
+	v_cmd_destroy(&batch.cmds[0]);
+
+	/* Sequence of commands with the same ID is popped at once */
+	fail_unless( v_out_queue_sched_pop(&sched, 1500, &batch) == CHUNK_SIZE,
+			"Sequence of commands was not popped at once");
+	fail_unless( batch.compressed == 1 && batch.share > 0,
+			"Sequence of commands is not compressed");
+	fail_unless( batch.len == v_cmds_len(batch.cmds[0], CHUNK_SIZE, batch.share, 0),
+			"Length of sequence: %d", batch.len);
+
+	for(j=0; j<CHUNK_SIZE; j++) {
+		fail_unless( UINT32(batch.cmds[j]->data[2+4]) == cmd_values[0][j].node_id,
+				"Node_Create Node_ID: %d != %d",
+				UINT32(batch.cmds[j]->data[2+4]), cmd_values[0][j].node_id);
+		v_cmd_destroy(&batch.cmds[j]);
+	}
+
+	fail_unless( v_out_queue_sched_pop(&sched, 1500, &batch) == 0,
+			"Command was popped from empty queue");
+
+	/* Small packets have to carry all commands in the same order */
+	for(j=0; j<CHUNK_SIZE; j++) {
+		node_create = v_node_create_create(cmd_values[1][j].node_id,
+				cmd_values[1][j].parent_id,
+				cmd_values[1][j].user_id,
+				cmd_values[1][j].type);
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, node_create);
+	}
+
+	for(packet = 0; packet < 10 && v_out_queue_get_count(out_queue) > 0; packet++) {
+		v_out_queue_sched_init(&sched, out_queue, 32, CMPR_ADDR_SHARE);
+		while(v_out_queue_sched_pop(&sched, 32, &batch) > 0) {
+			fail_unless( batch.len <= 32, "Batch is too long: %d", batch.len);
+			for(i=0; i<batch.count; i++, popped++) {
+				fail_unless( UINT32(batch.cmds[i]->data[2+4]) == cmd_values[1][popped].node_id,
+						"Node_Create Node_ID: %d != %d",
+						UINT32(batch.cmds[i]->data[2+4]), cmd_values[1][popped].node_id);
+				v_cmd_destroy(&batch.cmds[i]);
+			}
+		}
+	}
+
+	fail_unless( popped == CHUNK_SIZE,
+			"Number of popped commands: %d != %d", popped, CHUNK_SIZE);
+
+	v_out_queue_destroy(&out_queue);
+}
+END_TEST
+
 /**
  * \brief Test packing and unpacking Node_Create commands
  */
@@ -357,6 +445,128 @@ START_TEST( test_Node_Create_pack_unpack )
 }
 END_TEST
 
+/**
+ * \brief Test unpacking Node_Create commands to the view of receive buffer
+ */
+START_TEST( test_Node_Create_unpack_view )
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct VInQueue *in_queue = v_in_queue_create();
+	struct Generic_Cmd *_node_create, *node_create = NULL;
+	struct Cmd_View_Cmd *view;
+	union VCmdViewBuf view_buf;
+	uint16 count, len, buffer_len, buffer_pos = 0;
+	int8 share;
+	int j, view_count = 2*CMD_VIEW_MIN_COUNT;
+	char buffer[65535] = {0,};
+
+	in_queue->cmd_views = 1;
+
+	/* All commands share UserID and ParentID */
+	for(j=0; j<view_count; j++) {
+		node_create = v_node_create_create(600+j, 1, 1001, 300+j);
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, node_create);
+	}
+
+	for(j=0; j<view_count; j++) {
+		count = 0;
+		share = 0;
+		len = 65535;
+
+		_node_create = v_out_queue_pop(out_queue, VRS_DEFAULT_PRIORITY, &count, &share, &len);
+
+		fail_unless( _node_create != NULL,
+				"Node_Create pop failed");
+
+		if(j == 0) {
+			fail_unless( count == view_count,
+					"Count of compressed commands: %d != %d", count, view_count);
+			buffer_pos += v_cmd_pack(&buffer[buffer_pos], _node_create, len, share);
+		} else {
+			buffer_pos += v_cmd_pack(&buffer[buffer_pos], _node_create, 0, share);
+		}
+
+		v_cmd_destroy(&_node_create);
+	}
+
+	buffer_len = buffer_pos;
+
+	/* Commands are not decoded, only view is added to the queue */
+	buffer_pos = v_cmd_unpack(buffer, buffer_len, in_queue);
+
+	fail_unless( buffer_pos == buffer_len,
+			"Unpacked buffer size: %d != packed buffer size: %d", buffer_pos, buffer_len);
+	fail_unless( v_in_queue_cmd_count(in_queue) == 1,
+			"Count of commands in queue: %d != 1", v_in_queue_cmd_count(in_queue));
+	fail_unless( v_in_queue_size(in_queue) == view_count * (1 + 2 + 4 + 4 + 2),
+			"Size of view in queue: %d != %d", v_in_queue_size(in_queue),
+			view_count * (1 + 2 + 4 + 4 + 2));
+
+	_node_create = v_in_queue_pop(in_queue);
+
+	fail_unless( _node_create != NULL && _node_create->id == FAKE_CMD_CMD_VIEW,
+			"Cmd_View pop failed");
+
+	view = (struct Cmd_View_Cmd*)_node_create;
+
+	fail_unless( view->count == view_count,
+			"Cmd_View Count: %d != %d", view->count, view_count);
+
+	for(j=0; j<view_count; j++) {
+		fail_unless( v_cmd_view_get(view, j, &view_buf.cmd) == 1,
+				"Cmd_View get %d failed", j);
+
+		node_create = &view_buf.cmd;
+
+		fail_unless( node_create->id == CMD_NODE_CREATE,
+				"Node_Create OpCode: %d != %d", node_create->id, CMD_NODE_CREATE);
+		fail_unless( UINT16(node_create->data[0]) == 1001,
+				"Node_Create User_ID: %d != %d", UINT16(node_create->data[0]), 1001);
+		fail_unless( UINT32(node_create->data[2]) == 1,
+				"Node_Create Parent_ID: %d != %d", UINT32(node_create->data[2]), 1);
+		fail_unless( UINT32(node_create->data[2+4]) == (uint32)(600+j),
+				"Node_Create Node_ID: %d != %d", UINT32(node_create->data[2+4]), 600+j);
+		fail_unless( UINT16(node_create->data[2+4+4]) == 300+j,
+				"Node_Create Type: %d != %d", UINT16(node_create->data[2+4+4]), 300+j);
+	}
+
+	fail_unless( v_cmd_view_get(view, view_count, &view_buf.cmd) == 0,
+			"Cmd_View get out of view");
+
+	/* Malformed view with commands out of the receive buffer */
+	view->offset = view->buffer->size;
+	fail_unless( v_cmd_view_get(view, 0, &view_buf.cmd) == 0,
+			"Cmd_View get out of buffer");
+
+	/* Malformed view of command, that can't be viewed */
+	view->offset = 0;
+	view->cmd_id = CMD_TAG_SET_STRING8;
+	fail_unless( v_cmd_view_get(view, 0, &view_buf.cmd) == 0,
+			"Cmd_View get of variable length command");
+
+	v_cmd_destroy(&_node_create);
+
+	/* View can't be used, when command with the same ID is in the queue */
+	node_create = v_node_create_create(599, 1, 1001, 299);
+	v_in_queue_push(in_queue, node_create);
+
+	buffer_pos = v_cmd_unpack(buffer, buffer_len, in_queue);
+
+	fail_unless( v_in_queue_cmd_count(in_queue) == 1 + view_count,
+			"Count of commands in queue: %d != %d",
+			v_in_queue_cmd_count(in_queue), 1 + view_count);
+
+	while((_node_create = v_in_queue_pop(in_queue)) != NULL) {
+		fail_unless( _node_create->id == CMD_NODE_CREATE,
+				"Node_Create OpCode: %d != %d", _node_create->id, CMD_NODE_CREATE);
+		v_cmd_destroy(&_node_create);
+	}
+
+	v_in_queue_destroy(&in_queue);
+	v_out_queue_destroy(&out_queue);
+}
+END_TEST
+
 /**
  * \brief This function creates test suite for Node_Create command
  */
@@ -368,7 +578,9 @@ struct Suite *node_create_suite(void)
 	tcase_add_test(tc_core, test_Node_Create_create);
 	tcase_add_test(tc_core, test_Node_Create_in_queue);
 	tcase_add_test(tc_core, test_Node_Create_out_queue);
+	tcase_add_test(tc_core, test_Node_Create_out_queue_sched);
 	tcase_add_test(tc_core, test_Node_Create_pack_unpack);
+	tcase_add_test(tc_core, test_Node_Create_unpack_view);
 
 	suite_add_tcase(suite, tc_core);
 
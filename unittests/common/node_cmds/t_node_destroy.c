@@ -89,6 +89,43 @@ START_TEST ( test_Node_Destroy_create )
 }
 END_TEST
 
+START_TEST ( test_Node_Destroy_shared )
+{
+	struct VOutQueue *out_queue1 = v_out_queue_create();
+	struct VOutQueue *out_queue2 = v_out_queue_create();
+	struct Generic_Cmd *node_destroy, *_node_destroy1, *_node_destroy2;
+	const uint32 node_id = 65538;
+
+	node_destroy = v_node_destroy_create(node_id);
+
+	/* Share one command with two outgoing queues */
+	v_out_queue_push_tail(out_queue1, 0, VRS_DEFAULT_PRIORITY, v_cmd_share(node_destroy));
+	v_out_queue_push_tail(out_queue2, 0, VRS_DEFAULT_PRIORITY, v_cmd_share(node_destroy));
+	v_cmd_destroy(&node_destroy);
+
+	fail_unless( node_destroy == NULL,
+			"Node_Destroy destroy failed");
+
+	_node_destroy1 = v_out_queue_pop(out_queue1, VRS_DEFAULT_PRIORITY, NULL, NULL, NULL);
+	_node_destroy2 = v_out_queue_pop(out_queue2, VRS_DEFAULT_PRIORITY, NULL, NULL, NULL);
+
+	fail_unless( _node_destroy1 != NULL && _node_destroy1 == _node_destroy2,
+			"Node_Destroy is not shared by outgoing queues");
+
+	/* Command has to be valid until the last reference is dropped */
+	v_cmd_destroy(&_node_destroy1);
+
+	fail_unless( UINT32(_node_destroy2->data[0]) == node_id,
+			"Node_Destroy Node_ID: %d != %d",
+			UINT32(_node_destroy2->data[0]), node_id);
+
+	v_cmd_destroy(&_node_destroy2);
+
+	v_out_queue_destroy(&out_queue1);
+	v_out_queue_destroy(&out_queue2);
+}
+END_TEST
+
 START_TEST( test_Node_Destroy_in_queue )
 {
 	struct VInQueue *in_queue = v_in_queue_create();
@@ -301,6 +338,7 @@ struct Suite *node_destroy_suite(void)
 	struct TCase *tc_core = tcase_create("Core");
 
 	tcase_add_test(tc_core, test_Node_Destroy_create);
+	tcase_add_test(tc_core, test_Node_Destroy_shared);
 	tcase_add_test(tc_core, test_Node_Destroy_in_queue);
 	tcase_add_test(tc_core, test_Node_Destroy_out_queue);
 	tcase_add_test(tc_core, test_Node_Destroy_pack_unpack);
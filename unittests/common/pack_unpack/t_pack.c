@@ -160,6 +160,39 @@ START_TEST ( test_Pack_Uint32 )
 END_TEST
 
 
+/**
+ * \brief Unit test of packing array of uint32 values
+ */
+START_TEST ( test_Pack_Uint32_Array )
+{
+	size_t buf_pos = 0;
+	unsigned char buffer[UINT32_BUF_SIZE] = {0, };
+	unsigned char expected_results[UINT32_BUF_SIZE] = {
+			0x00, 0x00, 0x00, 0x00,	/* 0 */
+			0x00, 0x00, 0x00, 0x01,	/* 1 */
+			0x00, 0x00, 0x02, 0x00,	/* 512 */
+			0x00, 0x01, 0x00, 0x04,	/* 65540 */
+			0x01, 0x00, 0x00, 0x00,	/* 16 777 216 */
+			0xff, 0xff, 0xff, 0xff,	/* 4 294 967 295 */
+			0,
+	};
+	uint32 values[6] = {0, 1, 512, 65540, 16777216, 4294967295};
+	int i;
+
+	buf_pos += vnp_raw_pack_uint32_array((void*)&buffer[buf_pos], values, 6);
+
+	fail_unless( buf_pos == 6*4,
+			"Size of uint32 buffer: %d != 24",
+			buf_pos);
+
+	for(i = 0; i < UINT32_BUF_SIZE; i++) {
+		fail_unless( buffer[i] == expected_results[i],
+				"Buffer of uint32 differs at position: %d (%d != %d)",
+				i, buffer[i], expected_results[i]);
+	}
+}
+END_TEST
+
 /**
  * \brief Unit test of packing uint64 values
  */
@@ -280,6 +313,7 @@ struct Suite *pack_suite(void)
 	tcase_add_test(tc_core, test_Pack_Uint8);
 	tcase_add_test(tc_core, test_Pack_Uint16);
 	tcase_add_test(tc_core, test_Pack_Uint32);
+	tcase_add_test(tc_core, test_Pack_Uint32_Array);
 	tcase_add_test(tc_core, test_Pack_Uint64);
 	tcase_add_test(tc_core, test_Pack_Real32);
 	tcase_add_test(tc_core, test_Pack_Real64);
@@ -272,6 +272,50 @@ START_TEST ( test_UnPack_Uint64 )
 END_TEST
 
 
+/**
+ * \brief Unit test of unpacking array of uint64 values
+ */
+START_TEST ( test_UnPack_Uint64_Array )
+{
+	size_t buf_pos = 0;
+	unsigned char buffer[UINT64_BUF_SIZE] = {
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	/* 0 */
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,	/* 1 */
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,	/* 512 */
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x04,	/* 65540 */
+			0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,	/* 4 294 967 296 */
+			0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,	/* 18 446 744 073 709 551 615 */
+			0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,	/* 72 623 859 790 382 856 */
+			0,
+	};
+	uint64 expected_results[UINT64_TV_SIZE] = {
+			0,
+			1,
+			512,
+			65540,
+			4294967296,
+			0xffffffffffffffff,
+			0x0102030405060708,
+			0,
+	};
+	uint64 results[UINT64_TV_SIZE] = {0,};
+	int i;
+
+	buf_pos += vnp_raw_unpack_uint64_array((void*)&buffer[buf_pos],
+			results, 7);
+
+	fail_unless( buf_pos == 7*8,
+			"Size of uint64 buffer: %d != 56",
+			buf_pos);
+
+	for(i = 0; i < UINT64_TV_SIZE; i++) {
+		fail_unless( results[i] == expected_results[i],
+				"Test vector of uint64 differs at position: %d (%d != %d)",
+				i, results[i], expected_results[i]);
+	}
+}
+END_TEST
+
 /**
  * \brief Unit test of packing real32 values
  */
@@ -526,6 +570,7 @@ struct Suite *unpack_suite(void)
 	tcase_add_test(tc_core, test_UnPack_Uint16);
 	tcase_add_test(tc_core, test_UnPack_Uint32);
 	tcase_add_test(tc_core, test_UnPack_Uint64);
+	tcase_add_test(tc_core, test_UnPack_Uint64_Array);
 	tcase_add_test(tc_core, test_UnPack_Real32);
 	tcase_add_test(tc_core, test_UnPack_Real64);
 	tcase_add_test(tc_core, test_UnPack_String8);
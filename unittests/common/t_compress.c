@@ -0,0 +1,153 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "v_common.h"
+#include "v_compress.h"
+#include "v_sys_commands.h"
+
+#define PAYLOAD_SIZE	512
+
+/**
+ * \brief This function fills buffer with sequence of similar commands
+ */
+static void fill_payload(char *buffer, uint16 len)
+{
+	uint16 i;
+
+	for(i = 0; i < len; i++) {
+		switch(i % 16) {
+		case 0:
+			buffer[i] = (char)130;	/* OpCode */
+			break;
+		case 1:
+			buffer[i] = 16;	/* Length */
+			break;
+		case 13:
+			buffer[i] = (char)(i >> 4);	/* Item ID */
+			break;
+		default:
+			buffer[i] = (char)(i % 16);
+			break;
+		}
+	}
+}
+
+START_TEST ( test_Compress_payload )
+{
+	char buffer[PAYLOAD_SIZE], orig[PAYLOAD_SIZE];
+	const char *data;
+	uint16 cmpr_len, data_len = 0;
+
+	if(v_compress_is_supported(CMPR_DEFLATE) == 0) {
+		return;
+	}
+
+	fill_payload(buffer, PAYLOAD_SIZE);
+	memcpy(orig, buffer, PAYLOAD_SIZE);
+
+	/* Payload is replaced with shorter compressed data */
+	cmpr_len = v_compress_payload(CMPR_DEFLATE, buffer, PAYLOAD_SIZE);
+	fail_unless( cmpr_len > 0 && cmpr_len < PAYLOAD_SIZE,
+			"Payload was not compressed: %d", cmpr_len);
+
+	/* Compressed payload could not be confused with system commands */
+	fail_unless( (unsigned char)buffer[0] > MAX_SYS_CMD_ID,
+			"Compressed payload starts with system command ID: %d",
+			(unsigned char)buffer[0]);
+
+	/* Decompressed payload is the same as original payload */
+	data = v_decompress_payload(CMPR_DEFLATE, buffer, cmpr_len, &data_len);
+	fail_unless( data != NULL, "Payload was not decompressed");
+	fail_unless( data_len == PAYLOAD_SIZE,
+			"Wrong size of decompressed payload: %d", data_len);
+	fail_unless( memcmp(data, orig, PAYLOAD_SIZE) == 0,
+			"Decompressed payload differs from original");
+
+	/* Corrupted payload is detected */
+	memset(buffer, 0xFF, cmpr_len);
+	data = v_decompress_payload(CMPR_DEFLATE, buffer, cmpr_len, &data_len);
+	fail_unless( data == NULL, "Corrupted payload was decompressed");
+}
+END_TEST
+
+START_TEST ( test_Compress_payload_fallback )
+{
+	char buffer[PAYLOAD_SIZE], orig[PAYLOAD_SIZE];
+	uint16 i;
+
+	fill_payload(buffer, PAYLOAD_SIZE);
+
+	/* Payload is compressed only by negotiated method */
+	fail_unless( v_compress_payload(CMPR_NONE, buffer, PAYLOAD_SIZE) == 0,
+			"Payload was compressed with CMPR_NONE");
+	fail_unless( v_compress_payload(CMPR_ADDR_SHARE, buffer, PAYLOAD_SIZE) == 0,
+			"Payload was compressed with CMPR_ADDR_SHARE");
+
+	/* Short payload is not compressed */
+	fail_unless( v_compress_payload(CMPR_DEFLATE, buffer, CMPR_MIN_PAYLOAD_SIZE - 1) == 0,
+			"Short payload was compressed");
+
+	/* Random data could not be compressed and buffer is not changed */
+	srand(1);
+	for(i = 0; i < PAYLOAD_SIZE; i++) {
+		buffer[i] = (char)rand();
+	}
+	memcpy(orig, buffer, PAYLOAD_SIZE);
+	fail_unless( v_compress_payload(CMPR_DEFLATE, buffer, PAYLOAD_SIZE) == 0,
+			"Random payload was compressed");
+	fail_unless( memcmp(buffer, orig, PAYLOAD_SIZE) == 0,
+			"Not compressed payload was changed");
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for compression of payloads
+ */
+struct Suite *compress_suite(void)
+{
+	struct Suite *suite = suite_create("Compress");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Compress_payload);
+	tcase_add_test(tc_core, test_Compress_payload_fallback);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
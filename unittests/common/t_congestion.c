@@ -0,0 +1,357 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <string.h>
+
+#include "v_common.h"
+#include "v_congestion.h"
+#include "v_connection.h"
+#include "v_history.h"
+#include "v_sys_commands.h"
+
+#define TEST_MSS	1000
+
+/**
+ * \brief Initialize datagram connection with TCP like congestion control
+ */
+static void cc_conn_init(struct VDgramConn *dgram_conn, uint8 alg_id)
+{
+	memset(dgram_conn, 0, sizeof(struct VDgramConn));
+	dgram_conn->io_ctx.mtu = TEST_MSS;
+	dgram_conn->cc_meth = CC_TCP_LIKE;
+	dgram_conn->host_id = 1;
+	v_cc_init(dgram_conn, alg_id);
+	v_packet_history_init(&dgram_conn->packet_history);
+}
+
+/**
+ * \brief Simulate sending of payload packet at time tv
+ */
+static void cc_conn_send(struct VDgramConn *dgram_conn,
+		uint32 size,
+		const struct timeval *tv)
+{
+	struct VSent_Packet *sent_packet;
+
+	sent_packet = v_packet_history_add_packet(&dgram_conn->packet_history,
+			dgram_conn->host_id + dgram_conn->count_s_pay);
+	fail_unless( sent_packet != NULL, "Sent packet was not added to history");
+	sent_packet->tv = *tv;
+	sent_packet->size = size;
+	dgram_conn->sent_size += size;
+	dgram_conn->count_s_pay++;
+}
+
+START_TEST ( test_CC_rtt )
+{
+	struct VDgramConn dgram_conn;
+
+	cc_conn_init(&dgram_conn, CC_ALG_NEWRENO);
+
+	fail_unless( dgram_conn.rto == CC_INIT_RTO,
+			"Initial RTO: %u != %u", dgram_conn.rto, CC_INIT_RTO);
+
+	/* The first sample (RFC 6298) */
+	v_cc_rtt_sample(&dgram_conn, 100000);
+	fail_unless( dgram_conn.srtt == 100000 && dgram_conn.rttvar == 50000,
+			"SRTT: %u, RTTVAR: %u", dgram_conn.srtt, dgram_conn.rttvar);
+	fail_unless( dgram_conn.rto == 300000,
+			"RTO: %u != 300000", dgram_conn.rto);
+
+	/* Next samples are smoothed */
+	v_cc_rtt_sample(&dgram_conn, 200000);
+	fail_unless( dgram_conn.srtt == 112500 && dgram_conn.rttvar == 62500,
+			"SRTT: %u, RTTVAR: %u", dgram_conn.srtt, dgram_conn.rttvar);
+	fail_unless( dgram_conn.rto == 362500,
+			"RTO: %u != 362500", dgram_conn.rto);
+
+	/* RTO is bounded */
+	cc_conn_init(&dgram_conn, CC_ALG_NEWRENO);
+	v_cc_rtt_sample(&dgram_conn, 1000);
+	fail_unless( dgram_conn.rto == CC_MIN_RTO,
+			"RTO: %u != %u", dgram_conn.rto, CC_MIN_RTO);
+	cc_conn_init(&dgram_conn, CC_ALG_NEWRENO);
+	v_cc_rtt_sample(&dgram_conn, 30000000);
+	fail_unless( dgram_conn.rto == CC_MAX_RTO,
+			"RTO: %u != %u", dgram_conn.rto, CC_MAX_RTO);
+}
+END_TEST
+
+START_TEST ( test_CC_newreno )
+{
+	struct VDgramConn dgram_conn;
+	struct timeval tv = {10, 0};
+	uint32 i;
+
+	cc_conn_init(&dgram_conn, CC_ALG_NEWRENO);
+
+	fail_unless( dgram_conn.cc_alg == CC_ALG_NEWRENO, "Wrong algorithm");
+	fail_unless( dgram_conn.cwin == CC_INIT_CWIN*TEST_MSS,
+			"Initial CWIN: %u != %u", dgram_conn.cwin, CC_INIT_CWIN*TEST_MSS);
+
+	/* Slow start: window grows with acknowledged bytes, but at most two
+	 * segments per ACK */
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cwin == 11000, "CWIN: %u != 11000", dgram_conn.cwin);
+	v_cc_ack(&dgram_conn, 5000, &tv);
+	fail_unless( dgram_conn.cwin == 13000, "CWIN: %u != 13000", dgram_conn.cwin);
+
+	/* Loss halves window of sent data */
+	for(i = 0; i < 13; i++) {
+		cc_conn_send(&dgram_conn, 1000, &tv);
+	}
+	v_cc_nak(&dgram_conn, 3, &tv);
+	fail_unless( dgram_conn.cc_state.ssthresh == 6500,
+			"SSTHRESH: %u != 6500", dgram_conn.cc_state.ssthresh);
+	fail_unless( dgram_conn.cwin == 6500, "CWIN: %u != 6500", dgram_conn.cwin);
+
+	/* Window is reduced only once for losses in the same window */
+	v_cc_nak(&dgram_conn, 5, &tv);
+	fail_unless( dgram_conn.cwin == 6500, "CWIN: %u != 6500", dgram_conn.cwin);
+
+	/* Window doesn't grow during recovery */
+	dgram_conn.ank_id = 10;
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cwin == 6500, "CWIN: %u != 6500", dgram_conn.cwin);
+
+	/* Congestion avoidance: one segment per window of acknowledged data */
+	dgram_conn.ank_id = 13;
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cc_state.in_recovery == 0, "Recovery didn't end");
+	fail_unless( dgram_conn.cwin == 6500, "CWIN: %u != 6500", dgram_conn.cwin);
+	v_cc_ack(&dgram_conn, 6000, &tv);
+	fail_unless( dgram_conn.cwin == 7500, "CWIN: %u != 7500", dgram_conn.cwin);
+	fail_unless( dgram_conn.cc_state.acked == 500,
+			"Acked: %u != 500", dgram_conn.cc_state.acked);
+
+	/* Loss in the new window reduces window again. Slow start threshold is
+	 * never smaller than minimal window */
+	dgram_conn.sent_size = 1000;
+	v_cc_nak(&dgram_conn, 14, &tv);
+	fail_unless( dgram_conn.cc_state.ssthresh == CC_MIN_CWIN*TEST_MSS,
+			"SSTHRESH: %u != %u", dgram_conn.cc_state.ssthresh, CC_MIN_CWIN*TEST_MSS);
+	fail_unless( dgram_conn.cwin == CC_MIN_CWIN*TEST_MSS,
+			"CWIN: %u != %u", dgram_conn.cwin, CC_MIN_CWIN*TEST_MSS);
+
+	v_packet_history_destroy(&dgram_conn.packet_history);
+}
+END_TEST
+
+START_TEST ( test_CC_newreno_timeout )
+{
+	struct VDgramConn dgram_conn;
+	struct timeval tv = {10, 0};
+	uint32 i, rto;
+
+	cc_conn_init(&dgram_conn, CC_ALG_NEWRENO);
+	v_cc_rtt_sample(&dgram_conn, 100000);
+
+	for(i = 0; i < 10; i++) {
+		cc_conn_send(&dgram_conn, 1000, &tv);
+	}
+
+	/* RTO didn't expire yet */
+	tv.tv_usec = 299999;
+	fail_unless( v_cc_check_timeout(&dgram_conn, &tv) == 0, "RTO expired too early");
+	fail_unless( dgram_conn.cwin == CC_INIT_CWIN*TEST_MSS, "CWIN: %u", dgram_conn.cwin);
+
+	/* RTO expired: slow start from one segment and RTO is doubled */
+	tv.tv_usec = 300000;
+	fail_unless( v_cc_check_timeout(&dgram_conn, &tv) == 1, "RTO didn't expire");
+	fail_unless( dgram_conn.cwin == TEST_MSS, "CWIN: %u != %u", dgram_conn.cwin, TEST_MSS);
+	fail_unless( dgram_conn.cc_state.ssthresh == 5000,
+			"SSTHRESH: %u != 5000", dgram_conn.cc_state.ssthresh);
+	fail_unless( dgram_conn.rto == 600000, "RTO: %u != 600000", dgram_conn.rto);
+	fail_unless( dgram_conn.cc_state.in_recovery == 1, "Recovery didn't start");
+
+	/* RTO could expire only once per RTO */
+	tv.tv_usec = 899999;
+	fail_unless( v_cc_check_timeout(&dgram_conn, &tv) == 0, "RTO expired twice");
+	fail_unless( dgram_conn.rto == 600000, "RTO: %u != 600000", dgram_conn.rto);
+
+	/* Exponential back-off is bounded by maximal RTO */
+	tv.tv_usec = 900000;
+	for(i = 0; i < 20; i++) {
+		rto = dgram_conn.rto;
+		fail_unless( v_cc_check_timeout(&dgram_conn, &tv) == 1, "RTO didn't expire");
+		fail_unless( dgram_conn.rto == ((2*rto < CC_MAX_RTO) ? 2*rto : CC_MAX_RTO),
+				"RTO: %u after %u", dgram_conn.rto, rto);
+		tv.tv_sec += dgram_conn.rto/1000000;
+		tv.tv_usec += dgram_conn.rto%1000000;
+		if(tv.tv_usec >= 1000000) {
+			tv.tv_sec++;
+			tv.tv_usec -= 1000000;
+		}
+	}
+	fail_unless( dgram_conn.rto == CC_MAX_RTO, "RTO: %u != %u", dgram_conn.rto, CC_MAX_RTO);
+
+	/* Window grows again in slow start, when recovery ended */
+	dgram_conn.ank_id = 10;
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cwin == 2*TEST_MSS, "CWIN: %u != %u", dgram_conn.cwin, 2*TEST_MSS);
+
+	/* New RTT sample computes RTO again */
+	v_cc_rtt_sample(&dgram_conn, 100000);
+	fail_unless( dgram_conn.rto < CC_MAX_RTO, "RTO: %u", dgram_conn.rto);
+
+	v_packet_history_destroy(&dgram_conn.packet_history);
+}
+END_TEST
+
+START_TEST ( test_CC_cubic )
+{
+	struct VDgramConn dgram_conn;
+	struct timeval tv = {10, 0};
+	uint32 i, cwin;
+
+	cc_conn_init(&dgram_conn, CC_ALG_CUBIC);
+	v_cc_rtt_sample(&dgram_conn, 100000);
+
+	fail_unless( dgram_conn.cc_alg == CC_ALG_CUBIC, "Wrong algorithm");
+
+	/* Slow start is the same as NewReno */
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cwin == 11000, "CWIN: %u != 11000", dgram_conn.cwin);
+
+	/* Loss multiplies window by beta */
+	for(i = 0; i < 11; i++) {
+		cc_conn_send(&dgram_conn, 1000, &tv);
+	}
+	v_cc_nak(&dgram_conn, 1, &tv);
+	fail_unless( dgram_conn.cc_state.w_max == 11000,
+			"W_max: %u != 11000", dgram_conn.cc_state.w_max);
+	fail_unless( dgram_conn.cc_state.ssthresh == 7700,
+			"SSTHRESH: %u != 7700", dgram_conn.cc_state.ssthresh);
+	fail_unless( dgram_conn.cwin == 7700, "CWIN: %u != 7700", dgram_conn.cwin);
+
+	/* New epoch: K is time to reach W_max again (cube root of
+	 * (11000-7700)/1000/0.4 = 2.021 s) */
+	dgram_conn.ank_id = 11;
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cc_state.k >= 2020000 && dgram_conn.cc_state.k <= 2022000,
+			"K: %u", dgram_conn.cc_state.k);
+	fail_unless( dgram_conn.cwin > 7700 && dgram_conn.cwin < 8000,
+			"CWIN: %u", dgram_conn.cwin);
+
+	/* Concave region: window approaches W_max, but it doesn't exceed it */
+	tv.tv_sec += 1;
+	tv.tv_usec = dgram_conn.cc_state.k - 1000000 - dgram_conn.srtt;
+	for(i = 0; i < 40; i++) {
+		v_cc_ack(&dgram_conn, 1000, &tv);
+	}
+	fail_unless( dgram_conn.cwin >= 10900 && dgram_conn.cwin <= 11000,
+			"CWIN: %u", dgram_conn.cwin);
+
+	/* Convex region: window grows over W_max, but at most 1.5 times per
+	 * acknowledged window */
+	tv.tv_sec += 10;
+	cwin = dgram_conn.cwin;
+	v_cc_ack(&dgram_conn, cwin, &tv);
+	fail_unless( dgram_conn.cwin > 11000 && dgram_conn.cwin <= cwin + cwin/2,
+			"CWIN: %u", dgram_conn.cwin);
+
+	/* Fast convergence: loss before reaching W_max reduces W_max */
+	dgram_conn.cc_state.w_max = 2*dgram_conn.cwin;
+	cwin = dgram_conn.cwin;
+	cc_conn_send(&dgram_conn, 1000, &tv);
+	v_cc_nak(&dgram_conn, 12, &tv);
+	fail_unless( dgram_conn.cc_state.w_max == (uint32)(((uint64)cwin*(1000 + CUBIC_BETA))/2000),
+			"W_max: %u", dgram_conn.cc_state.w_max);
+	fail_unless( dgram_conn.cwin == (uint32)(((uint64)cwin*CUBIC_BETA)/1000),
+			"CWIN: %u", dgram_conn.cwin);
+
+	v_packet_history_destroy(&dgram_conn.packet_history);
+}
+END_TEST
+
+START_TEST ( test_CC_cubic_timeout )
+{
+	struct VDgramConn dgram_conn;
+	struct timeval tv = {10, 0};
+	uint32 i;
+
+	cc_conn_init(&dgram_conn, CC_ALG_CUBIC);
+	v_cc_rtt_sample(&dgram_conn, 100000);
+
+	for(i = 0; i < 10; i++) {
+		cc_conn_send(&dgram_conn, 1000, &tv);
+	}
+
+	/* Timeout reduces window to one segment, slow start threshold is
+	 * reduced by beta and RTO is doubled */
+	tv.tv_usec = 300000;
+	fail_unless( v_cc_check_timeout(&dgram_conn, &tv) == 1, "RTO didn't expire");
+	fail_unless( dgram_conn.cwin == TEST_MSS, "CWIN: %u != %u", dgram_conn.cwin, TEST_MSS);
+	fail_unless( dgram_conn.cc_state.ssthresh == 7000,
+			"SSTHRESH: %u != 7000", dgram_conn.cc_state.ssthresh);
+	fail_unless( dgram_conn.cc_state.w_max == 10000,
+			"W_max: %u != 10000", dgram_conn.cc_state.w_max);
+	fail_unless( dgram_conn.rto == 600000, "RTO: %u != 600000", dgram_conn.rto);
+
+	/* Slow start up to slow start threshold */
+	dgram_conn.ank_id = 10;
+	for(i = 0; i < 3; i++) {
+		v_cc_ack(&dgram_conn, 2000, &tv);
+	}
+	fail_unless( dgram_conn.cwin == 7000, "CWIN: %u != 7000", dgram_conn.cwin);
+	fail_unless( dgram_conn.cc_state.epoch_start == 0, "Epoch started in slow start");
+
+	/* Congestion avoidance starts new epoch */
+	v_cc_ack(&dgram_conn, 1000, &tv);
+	fail_unless( dgram_conn.cc_state.epoch_start != 0, "Epoch didn't start");
+
+	v_packet_history_destroy(&dgram_conn.packet_history);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for congestion control
+ */
+struct Suite *congestion_suite(void)
+{
+	struct Suite *suite = suite_create("Congestion");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_CC_rtt);
+	tcase_add_test(tc_core, test_CC_newreno);
+	tcase_add_test(tc_core, test_CC_newreno_timeout);
+	tcase_add_test(tc_core, test_CC_cubic);
+	tcase_add_test(tc_core, test_CC_cubic_timeout);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
@@ -0,0 +1,152 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+
+#include <check.h>
+#include <string.h>
+
+#include "v_delta.h"
+
+#define NODE_ID		65539
+#define LAYER_ID	2
+
+/**
+ * \brief This function encodes value as delta against base value
+ */
+static void xor_value(const uint32 *value, const uint32 *base, uint32 *delta)
+{
+	int i;
+
+	for(i = 0; i < 2; i++) {
+		delta[i] = value[i] ^ base[i];
+	}
+}
+
+START_TEST ( test_Delta_recv_value )
+{
+	struct VDeltaRecv *delta_recv = v_delta_recv_create();
+	uint32 v1[2] = {10, 20}, v2[2] = {11, 20}, v3[2] = {12, 21};
+	uint32 delta[2], value[2];
+	int ret;
+
+	fail_unless( delta_recv != NULL, "Storage was not created");
+
+	/* Complete value (base is equal to sequence number) */
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v1), 1, 1, v1, value);
+	fail_unless( ret == 1 && memcmp(value, v1, sizeof(v1)) == 0,
+			"Complete value was not delivered");
+
+	/* Delta against received value */
+	xor_value(v2, v1, delta);
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v2), 2, 1, delta, value);
+	fail_unless( ret == 1 && memcmp(value, v2, sizeof(v2)) == 0,
+			"Delta was not decoded");
+
+	/* Duplicated value is not delivered again */
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v2), 2, 1, delta, value);
+	fail_unless( ret == 0, "Duplicated value was delivered");
+
+	/* Value of the other item could not be decoded with this base */
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 8,
+			sizeof(v2), 3, 1, delta, value);
+	fail_unless( ret == 0, "Delta without base value was delivered");
+
+	/* Delayed value is decoded, but it is older then delivered value */
+	xor_value(v3, v1, delta);
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v3), 5, 1, delta, value);
+	fail_unless( ret == 1 && memcmp(value, v3, sizeof(v3)) == 0,
+			"Newer delta was not decoded");
+	xor_value(v2, v1, delta);
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v2), 4, 1, delta, value);
+	fail_unless( ret == 0 && memcmp(value, v2, sizeof(v2)) == 0,
+			"Older delta was delivered");
+
+	/* Stored values are removed with layer */
+	v_delta_recv_remove(delta_recv, NODE_ID, LAYER_ID);
+	xor_value(v3, v1, delta);
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 7,
+			sizeof(v3), 6, 1, delta, value);
+	fail_unless( ret == 0, "Delta of removed layer was delivered");
+
+	v_delta_recv_destroy(&delta_recv);
+	fail_unless( delta_recv == NULL, "Storage was not destroyed");
+}
+END_TEST
+
+START_TEST ( test_Delta_recv_seq_wrap )
+{
+	struct VDeltaRecv *delta_recv = v_delta_recv_create();
+	uint32 v1[2] = {1, 2}, v2[2] = {3, 4};
+	uint32 delta[2], value[2];
+	int ret;
+
+	/* Only 16 bits of sequence numbers are sent */
+	delta_recv->last_seq = 0xFFFE;
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 1,
+			sizeof(v1), 0xFFFF, 0xFFFF, v1, value);
+	fail_unless( ret == 1, "Complete value was not delivered");
+
+	xor_value(v2, v1, delta);
+	ret = v_delta_recv_value(delta_recv, NODE_ID, LAYER_ID, 1,
+			sizeof(v2), 0x0001, 0xFFFF, delta, value);
+	fail_unless( ret == 1 && memcmp(value, v2, sizeof(v2)) == 0,
+			"Delta was not decoded after wrap of sequence number");
+	fail_unless( delta_recv->last_seq == 0x10001,
+			"Wrong sequence number: %u", delta_recv->last_seq);
+
+	v_delta_recv_destroy(&delta_recv);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for values received as delta
+ */
+struct Suite *delta_suite(void)
+{
+	struct Suite *suite = suite_create("Delta");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Delta_recv_value);
+	tcase_add_test(tc_core, test_Delta_recv_seq_wrap);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
@@ -0,0 +1,358 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "v_common.h"
+#include "v_list.h"
+
+#define ITEM_COUNT 100000
+
+/* Structure of testing item */
+typedef struct HA_item {
+	uint32	id;
+	uint32	value;
+} HA_item;
+
+START_TEST ( test_Hash_Array_add_find_remove )
+{
+	struct VHashArrayBase hash_array;
+	struct HA_item *items, key;
+	struct VBucket *vbucket;
+	uint32 i;
+
+	items = (struct HA_item*)calloc(ITEM_COUNT, sizeof(struct HA_item));
+
+	fail_unless( v_hash_array_init(&hash_array, HASH_MOD_65536,
+			offsetof(HA_item, id), sizeof(uint32)) == 1,
+			"Hash array init failed");
+
+	/* Add items with keys, that differ only in high bits too */
+	for(i = 0; i < ITEM_COUNT; i++) {
+		items[i].id = i << 15;
+		items[i].value = i;
+		vbucket = v_hash_array_add_item(&hash_array, &items[i], sizeof(HA_item));
+		fail_unless( vbucket != NULL,
+				"Item %d was not added", i);
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == ITEM_COUNT,
+			"Count of items: %d != %d",
+			v_hash_array_count_items(&hash_array), ITEM_COUNT);
+
+	/* Find all items */
+	for(i = 0; i < ITEM_COUNT; i++) {
+		key.id = i << 15;
+		vbucket = v_hash_array_find_item(&hash_array, &key);
+		fail_unless( vbucket != NULL && vbucket->data == &items[i],
+				"Item %d was not found", i);
+	}
+
+	/* Items with not existing keys can't be found */
+	key.id = 1;
+	fail_unless( v_hash_array_find_item(&hash_array, &key) == NULL,
+			"Not existing item was found");
+
+	/* Remove every second item */
+	for(i = 0; i < ITEM_COUNT; i += 2) {
+		key.id = i << 15;
+		fail_unless( v_hash_array_remove_item(&hash_array, &key) == 1,
+				"Item %d was not removed", i);
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == ITEM_COUNT/2,
+			"Count of items: %d != %d",
+			v_hash_array_count_items(&hash_array), ITEM_COUNT/2);
+
+	for(i = 0; i < ITEM_COUNT; i++) {
+		key.id = i << 15;
+		vbucket = v_hash_array_find_item(&hash_array, &key);
+		if(i % 2 == 0) {
+			fail_unless( vbucket == NULL,
+					"Removed item %d was found", i);
+		} else {
+			fail_unless( vbucket != NULL && vbucket->data == &items[i],
+					"Item %d was not found", i);
+		}
+	}
+
+	v_hash_array_destroy(&hash_array);
+	free(items);
+}
+END_TEST
+
+START_TEST ( test_Hash_Array_order )
+{
+	struct VHashArrayBase hash_array;
+	struct HA_item item, key;
+	struct VBucket *vbucket;
+	uint32 i;
+
+	v_hash_array_init(&hash_array, HASH_MOD_256 | HASH_COPY_BUCKET,
+			offsetof(HA_item, id), sizeof(uint32));
+
+	/* Add items during resizing and remove some of them */
+	for(i = 0; i < 1000; i++) {
+		item.id = 1000 - i;
+		item.value = i;
+		v_hash_array_add_item(&hash_array, &item, sizeof(HA_item));
+		if(i % 3 == 0) {
+			key.id = 1000 - i;
+			v_hash_array_remove_item(&hash_array, &key);
+		}
+	}
+
+	/* Linked list has to keep order of adding */
+	for(i = 1, vbucket = hash_array.lb.first;
+			vbucket != NULL;
+			vbucket = vbucket->next)
+	{
+		if(i % 3 == 0) i++;
+		fail_unless( ((struct HA_item*)vbucket->data)->value == i,
+				"Value of item: %d != %d",
+				((struct HA_item*)vbucket->data)->value, i);
+		i++;
+	}
+
+	/* Remove all items */
+	for(i = 0; i < 1000; i++) {
+		key.id = 1000 - i;
+		v_hash_array_remove_item(&hash_array, &key);
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == 0,
+			"Hash array is not empty");
+	fail_unless( hash_array.lb.first == NULL,
+			"Linked list is not empty");
+
+	v_hash_array_destroy(&hash_array);
+}
+END_TEST
+
+START_TEST ( test_Hash_Array_small )
+{
+	struct VHashArrayBase hash_array;
+	struct HA_item items[2*HASH_SMALL_COUNT], key;
+	struct VBucket *vbucket;
+	uint32 i;
+
+	v_hash_array_init(&hash_array, HASH_MOD_256,
+			offsetof(HA_item, id), sizeof(uint32));
+
+	/* Small hashed linked list doesn't allocate array of slots */
+	for(i = 0; i < HASH_SMALL_COUNT; i++) {
+		items[i].id = i;
+		items[i].value = i;
+		v_hash_array_add_item(&hash_array, &items[i], sizeof(HA_item));
+	}
+
+	fail_unless( hash_array.slots == NULL,
+			"Small hashed linked list allocated array of slots");
+
+	key.id = HASH_SMALL_COUNT - 1;
+	vbucket = v_hash_array_find_item(&hash_array, &key);
+	fail_unless( vbucket != NULL && vbucket->data == &items[HASH_SMALL_COUNT - 1],
+			"Item was not found in small hashed linked list");
+
+	key.id = 0;
+	fail_unless( v_hash_array_remove_item(&hash_array, &key) == 1,
+			"Item was not removed from small hashed linked list");
+
+	/* All items have to be found, when list is not small any more */
+	for(i = HASH_SMALL_COUNT; i < 2*HASH_SMALL_COUNT; i++) {
+		items[i].id = i;
+		items[i].value = i;
+		v_hash_array_add_item(&hash_array, &items[i], sizeof(HA_item));
+	}
+
+	fail_unless( hash_array.slots != NULL,
+			"Array of slots was not allocated");
+
+	for(i = 0; i < 2*HASH_SMALL_COUNT; i++) {
+		key.id = i;
+		vbucket = v_hash_array_find_item(&hash_array, &key);
+		if(i == 0) {
+			fail_unless( vbucket == NULL, "Removed item was found");
+		} else {
+			fail_unless( vbucket != NULL && vbucket->data == &items[i],
+					"Item %d was not found", i);
+		}
+	}
+
+	v_hash_array_destroy(&hash_array);
+}
+END_TEST
+
+START_TEST ( test_Hash_Array_same_keys )
+{
+	struct VHashArrayBase hash_array;
+	struct HA_item items[1000];
+	struct VBucket *vbucket;
+	uint32 i, j;
+
+	v_hash_array_init(&hash_array, HASH_MOD_256,
+			offsetof(HA_item, id), sizeof(uint32));
+
+	/* History of sent commands contains more items with the same key and
+	 * items are removed with pointer at own data. Remove some items during
+	 * resizing of array of slots too. */
+	for(i = 0; i < 1000; i++) {
+		items[i].id = 1;
+		items[i].value = i;
+		v_hash_array_add_item(&hash_array, &items[i], sizeof(HA_item));
+		if(i % 3 == 2) {
+			fail_unless( v_hash_array_remove_item(&hash_array, &items[i - 1]) == 1,
+					"Item %d was not removed", i - 1);
+		}
+	}
+
+	/* Exactly the removed items have to be missing in linked list */
+	for(i = 0, vbucket = hash_array.lb.first;
+			vbucket != NULL;
+			vbucket = vbucket->next)
+	{
+		if(i % 3 == 1) i++;
+		fail_unless( vbucket->data == &items[i],
+				"Value of item: %d != %d",
+				((struct HA_item*)vbucket->data)->value, i);
+		i++;
+	}
+
+	/* Remove remaining items from the end */
+	for(j = 1000; j > 0; j--) {
+		if((j - 1) % 3 == 1) continue;
+		fail_unless( v_hash_array_remove_item(&hash_array, &items[j - 1]) == 1,
+				"Item %d was not removed", j - 1);
+		fail_unless( hash_array.lb.last == NULL || ((struct VBucket*)hash_array.lb.last)->data != &items[j - 1],
+				"Other item was removed instead of item %d", j - 1);
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == 0,
+			"Hash array is not empty");
+
+	v_hash_array_destroy(&hash_array);
+}
+END_TEST
+
+START_TEST ( test_Hash_Array_shared_key )
+{
+	struct VHashArrayBase hash_array;
+	struct HA_item *items, key;
+	struct VBucket **vbuckets, *vbucket;
+	uint32 i;
+
+	items = (struct HA_item*)calloc(ITEM_COUNT, sizeof(struct HA_item));
+	vbuckets = (struct VBucket**)calloc(ITEM_COUNT, sizeof(struct VBucket*));
+
+	v_hash_array_init(&hash_array, HASH_MOD_256,
+			offsetof(HA_item, id), sizeof(uint32));
+
+	/* Values of one layer share address in queues of commands. Every even
+	 * item has the same key and odd items have unique keys. */
+	for(i = 0; i < ITEM_COUNT; i++) {
+		items[i].id = (i % 2 == 0) ? 0 : i;
+		items[i].value = i;
+		vbuckets[i] = v_hash_array_add_item(&hash_array, &items[i], sizeof(HA_item));
+		fail_unless( vbuckets[i] != NULL,
+				"Item %d was not added", i);
+	}
+
+	/* Items with the same key use only one slot */
+	fail_unless( hash_array.key_count == ITEM_COUNT/2 + 1,
+			"Count of keys: %d != %d", hash_array.key_count, ITEM_COUNT/2 + 1);
+
+	/* The oldest item with the key is found */
+	key.id = 0;
+	vbucket = v_hash_array_find_item(&hash_array, &key);
+	fail_unless( vbucket != NULL && vbucket->data == &items[0],
+			"The oldest item with shared key was not found");
+
+	/* Remove all items with shared key except the last one */
+	for(i = 0; i < ITEM_COUNT - 2; i += 2) {
+		fail_unless( v_hash_array_remove_bucket(&hash_array, vbuckets[i]) == 1,
+				"Item %d was not removed", i);
+		vbucket = v_hash_array_find_item(&hash_array, &key);
+		fail_unless( vbucket != NULL && vbucket->data == &items[i + 2],
+				"Item %d was not found after removing item %d", i + 2, i);
+	}
+
+	/* Items with unique keys have to be still in the list */
+	for(i = 3; i < ITEM_COUNT; i += 2) {
+		key.id = i;
+		vbucket = v_hash_array_find_item(&hash_array, &key);
+		fail_unless( vbucket != NULL && vbucket->data == &items[i],
+				"Item %d was not found", i);
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == ITEM_COUNT/2 + 1,
+			"Count of items: %d != %d",
+			v_hash_array_count_items(&hash_array), ITEM_COUNT/2 + 1);
+
+	for(i = 0; i < ITEM_COUNT; i++) {
+		if(i % 2 == 1 || i == ITEM_COUNT - 2) {
+			v_hash_array_remove_bucket(&hash_array, vbuckets[i]);
+		}
+	}
+
+	fail_unless( v_hash_array_count_items(&hash_array) == 0,
+			"Hash array is not empty");
+
+	v_hash_array_destroy(&hash_array);
+
+	free(vbuckets);
+	free(items);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for hashed linked list
+ */
+struct Suite *hash_array_suite(void)
+{
+	struct Suite *suite = suite_create("Hash_Array");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Hash_Array_add_find_remove);
+	tcase_add_test(tc_core, test_Hash_Array_order);
+	tcase_add_test(tc_core, test_Hash_Array_small);
+	tcase_add_test(tc_core, test_Hash_Array_same_keys);
+	tcase_add_test(tc_core, test_Hash_Array_shared_key);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
@@ -0,0 +1,289 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <string.h>
+
+#include "v_common.h"
+#include "v_history.h"
+#include "v_connection.h"
+#include "v_context.h"
+#include "v_node_commands.h"
+#include "v_commands.h"
+#include "v_cmd_queue.h"
+
+#define PACKET_COUNT	1000
+#define PACKET_CMDS		40
+
+/**
+ * \brief Add packet with commands to the history of sent packets
+ */
+static struct VSent_Packet *history_add_packet(struct VDgramConn *conn,
+		uint32 id,
+		uint32 cmd_count)
+{
+	struct VSent_Packet *packet;
+	struct Generic_Cmd *cmd;
+	uint32 i;
+
+	packet = v_packet_history_add_packet(&conn->packet_history, id);
+	fail_unless( packet != NULL, "Packet: %u was not added", id);
+
+	for(i = 0; i < cmd_count; i++) {
+		/* Some commands obsolete commands sent in previous packets */
+		cmd = v_node_destroy_create((id*7 + i) % 3000);
+		packet->size += v_cmd_size(cmd);
+		conn->sent_size += v_cmd_size(cmd);
+		fail_unless( v_packet_history_add_cmd(&conn->packet_history, packet, cmd, 128) == 1,
+				"Command: %u was not added to packet: %u", i, id);
+	}
+
+	return packet;
+}
+
+/**
+ * \brief This function checks, that history doesn't contain any command
+ */
+static void history_check_empty(struct VDgramConn *conn)
+{
+	struct VPacket_History *history = &conn->packet_history;
+	int id;
+
+	fail_unless( history->count == 0,
+			"Count of packets: %u != 0", history->count);
+	fail_unless( conn->sent_size == 0,
+			"Size of sent commands: %d != 0", conn->sent_size);
+
+	for(id = 0; id <= MAX_CMD_ID; id++) {
+		if(history->cmd_hist[id] != NULL) {
+			fail_unless( v_hash_array_count_items(&history->cmd_hist[id]->cmds) == 0,
+					"History of commands: %d is not empty", id);
+		}
+	}
+}
+
+START_TEST ( test_History_wraparound )
+{
+	struct vContext C;
+	struct VDgramConn conn;
+	struct VPacket r_packet;
+	struct VPacket_History *history = &conn.packet_history;
+	struct VSent_Packet *packet;
+	uint32 base = UINT32_MAX - 100, i;
+
+	memset(&C, 0, sizeof(struct vContext));
+	memset(&conn, 0, sizeof(struct VDgramConn));
+	memset(&r_packet, 0, sizeof(struct VPacket));
+	CTX_current_dgram_conn_set(&C, &conn);
+	CTX_r_packet_set(&C, &r_packet);
+
+	v_packet_history_init(history);
+
+	/* Window of packets slides over the end of ID space. Slots are reused
+	 * and ring buffer doesn't grow. */
+	for(i = 0; i < 4*INIT_PACKET_HISTORY_LEN; i++) {
+		packet = history_add_packet(&conn, base + i, 4);
+		fail_unless( packet->id == base + i,
+				"Packet ID: %u != %u", packet->id, base + i);
+		if(i >= INIT_PACKET_HISTORY_LEN/2) {
+			fail_unless( v_packet_history_rem_packet(&C, base + i - INIT_PACKET_HISTORY_LEN/2) == 1,
+					"Packet: %u was not removed", base + i - INIT_PACKET_HISTORY_LEN/2);
+		}
+	}
+
+	fail_unless( history->length == INIT_PACKET_HISTORY_LEN,
+			"Length of ring buffer: %u != %u", history->length, INIT_PACKET_HISTORY_LEN);
+	fail_unless( history->count == INIT_PACKET_HISTORY_LEN/2,
+			"Count of packets: %u != %u", history->count, INIT_PACKET_HISTORY_LEN/2);
+	fail_unless( history->first_id == base + 3*INIT_PACKET_HISTORY_LEN + INIT_PACKET_HISTORY_LEN/2,
+			"First ID: %u", history->first_id);
+
+	/* Removed packets are not found, when slot is reused */
+	fail_unless( v_packet_history_find_packet(history, base) == NULL,
+			"Removed packet: %u was found", base);
+	fail_unless( v_packet_history_find_packet(history, base + i) == NULL,
+			"Not sent packet: %u was found", base + i);
+
+	for(i = 3*INIT_PACKET_HISTORY_LEN + INIT_PACKET_HISTORY_LEN/2; i < 4*INIT_PACKET_HISTORY_LEN; i++) {
+		packet = v_packet_history_find_packet(history, base + i);
+		fail_unless( packet != NULL && packet->id == base + i,
+				"Packet: %u was not found", base + i);
+		fail_unless( v_packet_history_rem_packet(&C, base + i) == 1,
+				"Packet: %u was not removed", base + i);
+	}
+
+	history_check_empty(&conn);
+
+	v_packet_history_destroy(history);
+}
+END_TEST
+
+START_TEST ( test_History_grow )
+{
+	struct vContext C;
+	struct VDgramConn conn;
+	struct VPacket r_packet;
+	struct VPacket_History *history = &conn.packet_history;
+	struct VSent_Packet *packet;
+	uint32 base = UINT32_MAX - PACKET_COUNT/2, i, j;
+
+	memset(&C, 0, sizeof(struct vContext));
+	memset(&conn, 0, sizeof(struct VDgramConn));
+	memset(&r_packet, 0, sizeof(struct VPacket));
+	CTX_current_dgram_conn_set(&C, &conn);
+	CTX_r_packet_set(&C, &r_packet);
+
+	v_packet_history_init(history);
+
+	/* Ring buffer grows, when packets are not acknowledged */
+	for(i = 0; i < PACKET_COUNT; i++) {
+		history_add_packet(&conn, base + i, PACKET_CMDS);
+	}
+
+	fail_unless( history->length >= PACKET_COUNT,
+			"Length of ring buffer: %u < %u", history->length, PACKET_COUNT);
+	fail_unless( (history->length & (history->length - 1)) == 0,
+			"Length of ring buffer: %u is not power of 2", history->length);
+	fail_unless( history->count == PACKET_COUNT,
+			"Count of packets: %u != %u", history->count, PACKET_COUNT);
+
+	/* Packets and their commands are kept, when ring buffer grows */
+	for(i = 0; i < PACKET_COUNT; i++) {
+		packet = v_packet_history_find_packet(history, base + i);
+		fail_unless( packet != NULL && packet->id == base + i,
+				"Packet: %u was not found", base + i);
+		fail_unless( packet->cmd_count == PACKET_CMDS,
+				"Count of commands in packet: %u: %d != %d",
+				base + i, packet->cmd_count, PACKET_CMDS);
+		for(j = 0; j < packet->cmd_count; j++) {
+			if(packet->cmds[j].vbucket != NULL) {
+				fail_unless( packet->cmds[j].vbucket->ptr == &packet->cmds[j],
+						"Command: %u of packet: %u points at wrong owner", j, base + i);
+			}
+		}
+	}
+	fail_unless( v_packet_history_find_packet(history, base + PACKET_COUNT) == NULL,
+			"Not sent packet was found");
+
+	/* Commands obsoleted by newer packets are not in older packets */
+	packet = v_packet_history_find_packet(history, base);
+	fail_unless( packet->cmds[PACKET_CMDS - 1].vbucket == NULL,
+			"Obsolete command was not removed from packet");
+
+	for(i = 0; i < PACKET_COUNT; i++) {
+		fail_unless( v_packet_history_rem_packet(&C, base + i) == 1,
+				"Packet: %u was not removed", base + i);
+	}
+
+	history_check_empty(&conn);
+
+	v_packet_history_destroy(history);
+}
+END_TEST
+
+START_TEST ( test_History_remove_out_of_order )
+{
+	struct vContext C;
+	struct VDgramConn conn;
+	struct VPacket r_packet;
+	struct VPacket_History *history = &conn.packet_history;
+	uint32 base = UINT32_MAX - 10, i;
+
+	memset(&C, 0, sizeof(struct vContext));
+	memset(&conn, 0, sizeof(struct VDgramConn));
+	memset(&r_packet, 0, sizeof(struct VPacket));
+	CTX_current_dgram_conn_set(&C, &conn);
+	CTX_r_packet_set(&C, &r_packet);
+
+	v_packet_history_init(history);
+
+	for(i = 0; i < PACKET_COUNT; i++) {
+		history_add_packet(&conn, base + i, PACKET_CMDS);
+	}
+
+	/* Packets acknowledged out of order. The oldest packet is kept, then
+	 * beginning of ring buffer doesn't move */
+	for(i = 1; i < PACKET_COUNT; i += 2) {
+		fail_unless( v_packet_history_rem_packet(&C, base + i) == 1,
+				"Packet: %u was not removed", base + i);
+	}
+	fail_unless( history->first_id == base,
+			"First ID: %u != %u", history->first_id, base);
+	fail_unless( v_packet_history_rem_packet(&C, base + 1) == 0,
+			"Packet: %u was removed twice", base + 1);
+
+	for(i = 0; i < PACKET_COUNT; i++) {
+		fail_unless( (v_packet_history_find_packet(history, base + i) != NULL) == ((i % 2) == 0),
+				"Packet: %u was (not) found", base + i);
+	}
+
+	/* Removing of the oldest packet moves beginning over removed packets */
+	fail_unless( v_packet_history_rem_packet(&C, base) == 1,
+			"Packet: %u was not removed", base);
+	fail_unless( history->first_id == base + 2,
+			"First ID: %u != %u", history->first_id, base + 2);
+
+	/* New packets can be added after out of order removal */
+	history_add_packet(&conn, base + PACKET_COUNT, PACKET_CMDS);
+	fail_unless( v_packet_history_find_packet(history, base + PACKET_COUNT) != NULL,
+			"Packet: %u was not found", base + PACKET_COUNT);
+
+	for(i = PACKET_COUNT; i >= 2; i -= 2) {
+		fail_unless( v_packet_history_rem_packet(&C, base + i) == 1,
+				"Packet: %u was not removed", base + i);
+	}
+
+	history_check_empty(&conn);
+
+	v_packet_history_destroy(history);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for history of sent packets
+ */
+struct Suite *history_suite(void)
+{
+	struct Suite *suite = suite_create("History");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_History_wraparound);
+	tcase_add_test(tc_core, test_History_grow);
+	tcase_add_test(tc_core, test_History_remove_out_of_order);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
@@ -0,0 +1,295 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <string.h>
+
+#include "verse.h"
+#include "v_common.h"
+#include "v_commands.h"
+#include "v_out_queue.h"
+#include "v_node_commands.h"
+#include "v_layer_commands.h"
+#include "v_tag_commands.h"
+
+#define LOW_PRIORITY	(VRS_DEFAULT_PRIORITY - 10)
+
+/**
+ * \brief This function checks, that lengths of sequences of commands with
+ * the same ID updated incrementally are the same as lengths computed with
+ * v_cmds_len() and that counters match commands in priority queues
+ */
+static void out_queue_check_runs(struct VOutQueue *out_queue)
+{
+	struct VOutQueueCommand *queue_cmd, *next_cmd;
+	struct VOutQueueRun *run;
+	struct Generic_Cmd *cmd;
+	uint32 count, total = 0;
+	int prio;
+
+	for(prio = 0; prio <= MAX_PRIORITY; prio++) {
+		queue_cmd = out_queue->queues[prio]->cmds.first;
+		count = 0;
+		while(queue_cmd != NULL) {
+			run = queue_cmd->run;
+			count++;
+			if(run == NULL) {
+				queue_cmd = queue_cmd->next;
+				continue;
+			}
+
+			/* Commands of sequence are stored one after another */
+			cmd = (struct Generic_Cmd*)queue_cmd->vbucket->data;
+			for(next_cmd = queue_cmd->next;
+					next_cmd != NULL && next_cmd->run == run;
+					next_cmd = next_cmd->next)
+			{
+				fail_unless( next_cmd->id == queue_cmd->id,
+						"Different IDs in sequence: %d != %d", next_cmd->id, queue_cmd->id);
+				count++;
+			}
+
+			fail_unless( run->counter >= 1,
+					"Counter of sequence: %d", run->counter);
+			fail_unless( run->len == v_cmds_len(cmd, run->counter, run->share, 0),
+					"Length of sequence: %d != v_cmds_len(): %d (count: %d, share: %d)",
+					run->len, v_cmds_len(cmd, run->counter, run->share, 0),
+					run->counter, run->share);
+
+			queue_cmd = next_cmd;
+		}
+
+		fail_unless( count == out_queue->queues[prio]->count,
+				"Count of commands in priority queue %d: %u != %u",
+				prio, count, out_queue->queues[prio]->count);
+		total += count;
+	}
+
+	fail_unless( total == out_queue->count,
+			"Count of commands in queue: %u != %u", total, out_queue->count);
+}
+
+/**
+ * \brief This function checks, that sequence starting with the first command
+ * in priority queue contains count commands
+ */
+static void out_queue_check_counter(struct VOutQueue *out_queue,
+		uint8 prio,
+		uint16 count)
+{
+	struct VOutQueueCommand *queue_cmd = out_queue->queues[prio]->cmds.first;
+
+	fail_unless( queue_cmd != NULL, "Priority queue %d is empty", prio);
+	fail_unless( queue_cmd->run != NULL && queue_cmd->run->counter == count,
+			"Counter of sequence: %d != %d",
+			(queue_cmd->run != NULL) ? queue_cmd->run->counter : 0, count);
+}
+
+static struct Generic_Cmd *layer_set_create(uint32 node_id,
+		uint16 layer_id,
+		uint32 item_id)
+{
+	uint8 value = (uint8)item_id;
+
+	return v_layer_set_value_create(node_id, layer_id, item_id,
+			VRS_VALUE_TYPE_UINT8, 1, &value);
+}
+
+static struct Generic_Cmd *tag_set_create(uint32 node_id,
+		uint16 taggroup_id,
+		uint16 tag_id)
+{
+	uint8 value = (uint8)tag_id;
+
+	return v_tag_set_create(node_id, taggroup_id, tag_id,
+			VRS_VALUE_TYPE_UINT8, 1, &value);
+}
+
+START_TEST ( test_OutQueue_push_run_len )
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct VOutQueueCommand *queue_cmd;
+	uint32 i;
+
+	fail_unless( out_queue != NULL, "Outgoing queue was not created");
+
+	/* Sequence with the shared address of node and layer, length coded
+	 * with one byte and with three bytes */
+	for(i = 0; i < 100; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(10, 1, i));
+		out_queue_check_runs(out_queue);
+	}
+	out_queue_check_counter(out_queue, VRS_DEFAULT_PRIORITY, 100);
+
+	/* Shared address is reduced by commands of other layer and other node */
+	v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(10, 2, 0));
+	out_queue_check_runs(out_queue);
+	v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(11, 2, 0));
+	out_queue_check_runs(out_queue);
+	queue_cmd = out_queue->queues[VRS_DEFAULT_PRIORITY]->cmds.first;
+	fail_unless( queue_cmd->run->share == 0,
+			"Shared address: %d != 0", queue_cmd->run->share);
+
+	/* Other command interrupts sequence and new sequence is started */
+	v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, v_node_destroy_create(1000));
+	for(i = 0; i < 10; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(12, 1, i));
+		v_out_queue_push_tail(out_queue, 0, LOW_PRIORITY, v_node_destroy_create(2000 + i));
+		out_queue_check_runs(out_queue);
+	}
+
+	/* Commands re-sent from history are added to the head */
+	for(i = 0; i < 10; i++) {
+		v_out_queue_push_head(out_queue, VRS_DEFAULT_PRIORITY, v_node_destroy_create(3000 + i));
+		out_queue_check_runs(out_queue);
+	}
+	out_queue_check_counter(out_queue, VRS_DEFAULT_PRIORITY, 10);
+
+	v_out_queue_destroy(&out_queue);
+}
+END_TEST
+
+START_TEST ( test_OutQueue_merge_run_len )
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	uint32 i;
+
+	for(i = 0; i < 200; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, tag_set_create(10, 1, i));
+	}
+	out_queue_check_runs(out_queue);
+
+	/* Command with the same address replaces data of queued command */
+	for(i = 0; i < 200; i += 7) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, tag_set_create(10, 1, i));
+		out_queue_check_runs(out_queue);
+	}
+	out_queue_check_counter(out_queue, VRS_DEFAULT_PRIORITY, 200);
+
+	/* Command with the same address and other priority is moved from
+	 * the middle of sequence to other priority queue */
+	for(i = 1; i < 200; i += 2) {
+		v_out_queue_push_tail(out_queue, 0, LOW_PRIORITY, tag_set_create(10, 1, i));
+		out_queue_check_runs(out_queue);
+	}
+	out_queue_check_counter(out_queue, VRS_DEFAULT_PRIORITY, 100);
+	out_queue_check_counter(out_queue, LOW_PRIORITY, 100);
+
+	/* Moving commands back extends the sequence again */
+	for(i = 1; i < 200; i += 4) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, tag_set_create(10, 1, i));
+		out_queue_check_runs(out_queue);
+	}
+	out_queue_check_counter(out_queue, VRS_DEFAULT_PRIORITY, 150);
+	out_queue_check_counter(out_queue, LOW_PRIORITY, 50);
+
+	fail_unless( v_out_queue_get_count(out_queue) == 200,
+			"Count of commands: %u != 200", v_out_queue_get_count(out_queue));
+
+	v_out_queue_destroy(&out_queue);
+}
+END_TEST
+
+START_TEST ( test_OutQueue_pop_run_len )
+{
+	struct VOutQueue *out_queue = v_out_queue_create();
+	struct Generic_Cmd *cmd;
+	uint16 count, len, max_len;
+	int8 share;
+	uint32 i, popped = 0;
+
+	for(i = 0; i < 300; i++) {
+		v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(10, 1, i));
+	}
+	out_queue_check_runs(out_queue);
+
+	/* Pop commands, that could be packed to buffers of different sizes */
+	for(max_len = 20; v_out_queue_get_count(out_queue) > 0; max_len += 37) {
+		count = 0;
+		share = 0;
+		len = max_len;
+		cmd = v_out_queue_pop(out_queue, VRS_DEFAULT_PRIORITY, &count, &share, &len);
+		fail_unless( cmd != NULL, "Command was not popped (max_len: %d)", max_len);
+
+		if(count > 1) {
+			fail_unless( len <= max_len, "Length: %d > %d", len, max_len);
+			fail_unless( len == v_cmds_len(cmd, count, share, 0),
+					"Length of popped commands: %d != v_cmds_len(): %d (count: %d)",
+					len, v_cmds_len(cmd, count, share, 0), count);
+		}
+		v_cmd_destroy(&cmd);
+		popped++;
+		out_queue_check_runs(out_queue);
+
+		/* Rest of compressed commands */
+		for(i = 1; i < count; i++) {
+			len = 0;
+			cmd = v_out_queue_pop(out_queue, VRS_DEFAULT_PRIORITY, NULL, NULL, &len);
+			fail_unless( cmd != NULL, "Command was not popped");
+			v_cmd_destroy(&cmd);
+			popped++;
+			out_queue_check_runs(out_queue);
+		}
+
+		/* New commands are added to the end of the sequence meanwhile */
+		if(popped < 150) {
+			v_out_queue_push_tail(out_queue, 0, VRS_DEFAULT_PRIORITY, layer_set_create(10, 1, 300 + popped));
+			out_queue_check_runs(out_queue);
+		}
+	}
+
+	fail_unless( v_out_queue_get_size(out_queue) == 0,
+			"Size of queue: %u != 0", v_out_queue_get_size(out_queue));
+
+	v_out_queue_destroy(&out_queue);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for outgoing queue
+ */
+struct Suite *out_queue_suite(void)
+{
+	struct Suite *suite = suite_create("Out_Queue");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_OutQueue_push_run_len);
+	tcase_add_test(tc_core, test_OutQueue_merge_run_len);
+	tcase_add_test(tc_core, test_OutQueue_pop_run_len);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
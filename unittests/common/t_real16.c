@@ -0,0 +1,200 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <math.h>
+#include <float.h>
+
+#include "verse.h"
+#include "v_common.h"
+
+/* Is half precision float NaN? */
+#define REAL16_IS_NAN(h)	(((h) & 0x7C00) == 0x7C00 && ((h) & 0x3FF) != 0)
+
+START_TEST ( test_Real16_exact )
+{
+	/* Values, that could be represented exactly */
+	fail_unless( v_real32_to_real16(0.0f) == 0x0000, "0.0");
+	fail_unless( v_real32_to_real16(-0.0f) == 0x8000, "-0.0");
+	fail_unless( v_real32_to_real16(1.0f) == 0x3C00, "1.0");
+	fail_unless( v_real32_to_real16(-2.0f) == 0xC000, "-2.0");
+	fail_unless( v_real32_to_real16(0.5f) == 0x3800, "0.5");
+	fail_unless( v_real32_to_real16(65504.0f) == 0x7BFF, "Maximal value");
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -14)) == 0x0400, "Minimal normal value");
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -24)) == 0x0001, "Minimal subnormal value");
+	fail_unless( v_real32_to_real16(ldexpf(1023.0f, -24)) == 0x03FF, "Maximal subnormal value");
+
+	fail_unless( v_real16_to_real32(0x3C00) == 1.0f, "1.0");
+	fail_unless( v_real16_to_real32(0x7BFF) == 65504.0f, "Maximal value");
+	fail_unless( v_real16_to_real32(0x0001) == ldexpf(1.0f, -24), "Minimal subnormal value");
+	fail_unless( v_real16_to_real32(0x83FF) == -ldexpf(1023.0f, -24), "Maximal subnormal value");
+	fail_unless( vrs_real16_to_real32(0xC000) == -2.0f, "-2.0");
+}
+END_TEST
+
+START_TEST ( test_Real16_round )
+{
+	/* Halfway values are rounded to even */
+	fail_unless( v_real32_to_real16(1.0f + ldexpf(1.0f, -11)) == 0x3C00,
+			"1 + 2^-11: 0x%04x", v_real32_to_real16(1.0f + ldexpf(1.0f, -11)));
+	fail_unless( v_real32_to_real16(1.0f + 3*ldexpf(1.0f, -11)) == 0x3C02,
+			"1 + 3*2^-11: 0x%04x", v_real32_to_real16(1.0f + 3*ldexpf(1.0f, -11)));
+	/* Other values are rounded to nearest */
+	fail_unless( v_real32_to_real16(1.0f + ldexpf(1.0f, -11) + ldexpf(1.0f, -20)) == 0x3C01,
+			"1 + 2^-11 + 2^-20");
+	fail_unless( v_real32_to_real16(1.0f + ldexpf(1.0f, -11) - ldexpf(1.0f, -20)) == 0x3C00,
+			"1 + 2^-11 - 2^-20");
+	fail_unless( v_real32_to_real16(-1.0f - 3*ldexpf(1.0f, -12)) == 0xBC01,
+			"-1 - 3*2^-12");
+	/* Carry of mantissa increases exponent */
+	fail_unless( v_real32_to_real16(2.0f - ldexpf(1.0f, -12)) == 0x4000,
+			"2 - 2^-12: 0x%04x", v_real32_to_real16(2.0f - ldexpf(1.0f, -12)));
+}
+END_TEST
+
+START_TEST ( test_Real16_overflow )
+{
+	/* Values bigger than maximal value are rounded to infinity */
+	fail_unless( v_real32_to_real16(65519.0f) == 0x7BFF, "65519");
+	fail_unless( v_real32_to_real16(65520.0f) == 0x7C00, "65520");
+	fail_unless( v_real32_to_real16(1.0e6f) == 0x7C00, "1e6");
+	fail_unless( v_real32_to_real16(-1.0e6f) == 0xFC00, "-1e6");
+	fail_unless( v_real32_to_real16(FLT_MAX) == 0x7C00, "FLT_MAX");
+	fail_unless( v_real32_to_real16(INFINITY) == 0x7C00, "Infinity");
+	fail_unless( v_real32_to_real16(-INFINITY) == 0xFC00, "-Infinity");
+
+	fail_unless( isinf(v_real16_to_real32(0x7C00)) && v_real16_to_real32(0x7C00) > 0,
+			"Infinity");
+	fail_unless( isinf(v_real16_to_real32(0xFC00)) && v_real16_to_real32(0xFC00) < 0,
+			"-Infinity");
+}
+END_TEST
+
+START_TEST ( test_Real16_denormal )
+{
+	/* Halfway between zero and minimal subnormal value is rounded to zero */
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -25)) == 0x0000, "2^-25");
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -25) + ldexpf(1.0f, -35)) == 0x0001,
+			"2^-25 + 2^-35");
+	fail_unless( v_real32_to_real16(3*ldexpf(1.0f, -25)) == 0x0002, "3*2^-25");
+	fail_unless( v_real32_to_real16(5*ldexpf(1.0f, -25)) == 0x0002, "5*2^-25");
+	/* Too small values are converted to zero with sign */
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -30)) == 0x0000, "2^-30");
+	fail_unless( v_real32_to_real16(-ldexpf(1.0f, -30)) == 0x8000, "-2^-30");
+	/* Subnormal single precision floats */
+	fail_unless( v_real32_to_real16(ldexpf(1.0f, -140)) == 0x0000, "2^-140");
+	fail_unless( v_real32_to_real16(-ldexpf(1.0f, -140)) == 0x8000, "-2^-140");
+	/* Rounding of maximal subnormal value gives minimal normal value */
+	fail_unless( v_real32_to_real16(ldexpf(1023.5f, -24)) == 0x0400,
+			"1023.5*2^-24: 0x%04x", v_real32_to_real16(ldexpf(1023.5f, -24)));
+}
+END_TEST
+
+START_TEST ( test_Real16_nan )
+{
+	real16 half;
+
+	half = v_real32_to_real16(NAN);
+	fail_unless( REAL16_IS_NAN(half), "NaN: 0x%04x", half);
+	half = v_real32_to_real16(-NAN);
+	fail_unless( REAL16_IS_NAN(half) && (half & 0x8000), "-NaN: 0x%04x", half);
+	half = v_real64_to_real16(NAN);
+	fail_unless( REAL16_IS_NAN(half), "NaN: 0x%04x", half);
+
+	fail_unless( isnan(v_real16_to_real32(0x7E00)), "NaN");
+	fail_unless( isnan(v_real16_to_real32(0xFC01)), "NaN");
+}
+END_TEST
+
+START_TEST ( test_Real16_all_values )
+{
+	real16 half, result;
+	uint32 i;
+
+	/* All half precision floats are converted to single and double
+	 * precision floats and back without change */
+	for(i = 0; i <= 0xFFFF; i++) {
+		half = (real16)i;
+		if(REAL16_IS_NAN(half)) {
+			fail_unless( isnan(v_real16_to_real32(half)), "NaN: 0x%04x", half);
+			continue;
+		}
+		result = v_real32_to_real16(v_real16_to_real32(half));
+		fail_unless( result == half, "0x%04x != 0x%04x", result, half);
+		result = v_real64_to_real16((real64)v_real16_to_real32(half));
+		fail_unless( result == half, "0x%04x != 0x%04x", result, half);
+	}
+}
+END_TEST
+
+START_TEST ( test_Real16_precision_real64 )
+{
+	/* Conversion from double precision is rounded once, then value slightly
+	 * above halfway is rounded up (conversion through single precision would
+	 * round it to even) */
+	fail_unless( v_real64_to_real16(1.0 + ldexp(1.0, -11) + ldexp(1.0, -40)) == 0x3C01,
+			"1 + 2^-11 + 2^-40: 0x%04x",
+			v_real64_to_real16(1.0 + ldexp(1.0, -11) + ldexp(1.0, -40)));
+	fail_unless( v_real64_to_real16(1.0 + ldexp(1.0, -11)) == 0x3C00, "1 + 2^-11");
+	fail_unless( v_real64_to_real16(65520.0) == 0x7C00, "65520");
+	fail_unless( v_real64_to_real16(-1.0e300) == 0xFC00, "-1e300");
+	fail_unless( v_real64_to_real16(ldexp(1.0, -25)) == 0x0000, "2^-25");
+	fail_unless( v_real64_to_real16(ldexp(1.0, -25) + ldexp(1.0, -60)) == 0x0001,
+			"2^-25 + 2^-60");
+	fail_unless( v_real64_to_real16(-ldexp(1.0, -1030)) == 0x8000, "-2^-1030");
+	fail_unless( v_real64_to_real16(ldexp(1023.5, -24)) == 0x0400, "1023.5*2^-24");
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for half precision floats
+ */
+struct Suite *real16_suite(void)
+{
+	struct Suite *suite = suite_create("Real16");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Real16_exact);
+	tcase_add_test(tc_core, test_Real16_round);
+	tcase_add_test(tc_core, test_Real16_overflow);
+	tcase_add_test(tc_core, test_Real16_denormal);
+	tcase_add_test(tc_core, test_Real16_nan);
+	tcase_add_test(tc_core, test_Real16_all_values);
+	tcase_add_test(tc_core, test_Real16_precision_real64);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
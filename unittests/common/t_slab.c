@@ -0,0 +1,151 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "v_common.h"
+#include "v_slab.h"
+
+#define OBJ_COUNT 10000
+
+START_TEST ( test_Slab_alloc_free )
+{
+	void *ptr1, *ptr2, *big;
+	uint8 **objs;
+	uint32 i;
+
+	/* Freed object is reused by the next allocation of the same class */
+	ptr1 = v_slab_alloc(24);
+	fail_unless( ptr1 != NULL, "Object was not allocated");
+	v_slab_free(ptr1, 24);
+	ptr2 = v_slab_alloc(32);
+	fail_unless( ptr2 == ptr1, "Freed object was not reused");
+	v_slab_free(ptr2, 32);
+
+	/* Objects of calloc are cleared */
+	ptr1 = v_slab_alloc(100);
+	memset(ptr1, 0xFF, 100);
+	v_slab_free(ptr1, 100);
+	ptr1 = v_slab_calloc(100);
+	for(i = 0; i < 100; i++) {
+		fail_unless( ((uint8*)ptr1)[i] == 0, "Byte %d is not zero", i);
+	}
+	v_slab_free(ptr1, 100);
+
+	/* Big objects are allocated with malloc() */
+	big = v_slab_alloc(SLAB_MAX_SIZE + 1);
+	fail_unless( big != NULL, "Big object was not allocated");
+	v_slab_free(big, SLAB_MAX_SIZE + 1);
+
+	/* Many objects don't overlap */
+	objs = (uint8**)malloc(OBJ_COUNT*sizeof(uint8*));
+	for(i = 0; i < OBJ_COUNT; i++) {
+		objs[i] = (uint8*)v_slab_alloc(64);
+		fail_unless( objs[i] != NULL, "Object %d was not allocated", i);
+		memset(objs[i], (uint8)i, 64);
+	}
+	for(i = 0; i < OBJ_COUNT; i++) {
+		fail_unless( objs[i][0] == (uint8)i && objs[i][63] == (uint8)i,
+				"Object %d was overwritten", i);
+		v_slab_free(objs[i], 64);
+	}
+	free(objs);
+}
+END_TEST
+
+static void *free_thread(void *arg)
+{
+	uint8 **objs = (uint8**)arg;
+	uint32 i;
+
+	for(i = 0; i < OBJ_COUNT; i++) {
+		v_slab_free(objs[i], 128);
+	}
+
+	return NULL;
+}
+
+START_TEST ( test_Slab_other_thread )
+{
+	struct VSlabStats stats[SLAB_CLASS_COUNT], new_stats[SLAB_CLASS_COUNT];
+	pthread_t thread;
+	uint8 **objs;
+	uint32 i;
+
+	v_slab_get_stats(stats);
+
+	/* Objects freed by other thread are returned to the depot, when thread
+	 * exits */
+	objs = (uint8**)malloc(OBJ_COUNT*sizeof(uint8*));
+	for(i = 0; i < OBJ_COUNT; i++) {
+		objs[i] = (uint8*)v_slab_alloc(128);
+		fail_unless( objs[i] != NULL, "Object %d was not allocated", i);
+	}
+	pthread_create(&thread, NULL, free_thread, objs);
+	pthread_join(thread, NULL);
+	free(objs);
+
+	v_slab_get_stats(new_stats);
+
+	fail_unless( new_stats[3].size == 128, "Wrong size of class: %d",
+			new_stats[3].size);
+	fail_unless( new_stats[3].alloc_count - stats[3].alloc_count == OBJ_COUNT,
+			"Wrong number of allocations");
+	fail_unless( new_stats[3].free_count - stats[3].free_count == OBJ_COUNT,
+			"Wrong number of frees");
+	fail_unless( new_stats[3].depot_count >= OBJ_COUNT,
+			"Freed objects are not in depot");
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for slab allocator
+ */
+struct Suite *slab_suite(void)
+{
+	struct Suite *suite = suite_create("Slab");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Slab_alloc_free);
+	tcase_add_test(tc_core, test_Slab_other_thread);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
@@ -44,5 +44,14 @@ struct Suite *taggroup_create_suite(void);
 struct Suite *negotiate_suite(void);
 struct Suite *pack_suite(void);
 struct Suite *unpack_suite(void);
+struct Suite *hash_array_suite(void);
+struct Suite *slab_suite(void);
+struct Suite *compress_suite(void);
+struct Suite *delta_suite(void);
+struct Suite *history_suite(void);
+struct Suite *congestion_suite(void);
+struct Suite *out_queue_suite(void);
+struct Suite *real16_suite(void);
+struct Suite *journal_suite(void);
 
 #endif /* T_NODE_CREATE_H_ */
@@ -0,0 +1,189 @@
+/*
+ *
+ * ***** BEGIN BSD LICENSE BLOCK *****
+ *
+ * Copyright (c) 2009-2011, Jiri Hnidek
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ***** END BSD LICENSE BLOCK *****
+ *
+ * Authors: Jiri Hnidek <jiri.hnidek@tul.cz>
+ *
+ */
+
+#include <check.h>
+#include <stdlib.h>
+
+#include "v_common.h"
+#include "vs_journal.h"
+
+/**
+ * \brief Add changes of items to journal of entity and update its version
+ */
+static void journal_add_changes(struct VSJournal *journal,
+		uint32 *version,
+		uint32 first_item_id,
+		uint32 count,
+		uint8 type)
+{
+	uint32 i;
+
+	for(i = 0; i < count; i++) {
+		(*version)++;
+		vs_journal_add(journal, *version, first_item_id + i, type);
+	}
+}
+
+/**
+ * \brief Test of changes sent to client resubscribing with version
+ */
+START_TEST ( test_Journal_changes )
+{
+	struct VSJournal journal;
+	struct VSJournalChange *changes;
+	uint32 epoch = vs_journal_new_epoch(), version = 0, old_version;
+	int change_count;
+
+	vs_journal_init(&journal, version, epoch);
+	journal_add_changes(&journal, &version, 0, 10, JOURNAL_ITEM_CREATE);
+	old_version = version;
+	journal_add_changes(&journal, &version, 5, 2, JOURNAL_ITEM_CHANGE);
+	journal_add_changes(&journal, &version, 20, 1, JOURNAL_ITEM_CREATE);
+
+	change_count = vs_journal_changes(&journal, epoch, old_version, version, &changes);
+	fail_unless( change_count == 3,
+			"Number of changes: %d != 3", change_count);
+	fail_unless( vs_journal_find_change(changes, change_count, 5)->created == 0,
+			"Changed item was reported as created");
+	fail_unless( vs_journal_find_change(changes, change_count, 20)->created == 1,
+			"Created item was not reported as created");
+	fail_unless( vs_journal_find_change(changes, change_count, 0) == NULL,
+			"Not changed item was reported as changed");
+	free(changes);
+
+	/* Client holding current version doesn't need anything */
+	change_count = vs_journal_changes(&journal, epoch, version, version, &changes);
+	fail_unless( change_count == 0 && changes == NULL,
+			"Changes were reported for current version");
+
+	vs_journal_destroy(&journal);
+}
+END_TEST
+
+/**
+ * \brief Test of entity destroyed and created again with the same ID. Client
+ * resubscribing with version of destroyed entity has to receive whole entity,
+ * even when the new entity reached this version too.
+ */
+START_TEST ( test_Journal_recreated_entity )
+{
+	struct VSJournal journal;
+	struct VSJournalChange *changes;
+	uint32 old_epoch, new_epoch, version = 0, old_version;
+	int change_count;
+
+	old_epoch = vs_journal_new_epoch();
+	vs_journal_init(&journal, version, old_epoch);
+	journal_add_changes(&journal, &version, 0, 5, JOURNAL_ITEM_CREATE);
+	old_version = version;
+	vs_journal_destroy(&journal);
+
+	/* Entity with the same ID is created again and changed more */
+	version = 0;
+	new_epoch = vs_journal_new_epoch();
+	fail_unless( new_epoch != old_epoch && new_epoch != 0,
+			"New epoch: %u is not unique", new_epoch);
+	vs_journal_init(&journal, version, new_epoch);
+	journal_add_changes(&journal, &version, 100, 8, JOURNAL_ITEM_CREATE);
+	fail_unless( old_version < version,
+			"Old version: %u is not covered by new journal", old_version);
+
+	change_count = vs_journal_changes(&journal, old_epoch, old_version, version, &changes);
+	fail_unless( change_count == -1 && changes == NULL,
+			"Changes (%d) were sent for version of destroyed entity", change_count);
+
+	/* Clients, that don't know epoch, have to receive whole entity too */
+	change_count = vs_journal_changes(&journal, 0, old_version, version, &changes);
+	fail_unless( change_count == -1,
+			"Changes (%d) were sent for version without epoch", change_count);
+
+	change_count = vs_journal_changes(&journal, new_epoch, old_version, version, &changes);
+	fail_unless( change_count == 3,
+			"Number of changes: %d != 3", change_count);
+	free(changes);
+
+	vs_journal_destroy(&journal);
+}
+END_TEST
+
+/**
+ * \brief Test of journal reset, when version is changed without journal
+ */
+START_TEST ( test_Journal_reset )
+{
+	struct VSJournal journal;
+	struct VSJournalChange *changes;
+	uint32 epoch = vs_journal_new_epoch(), new_epoch, version = 0, old_version;
+	int change_count;
+
+	vs_journal_init(&journal, version, epoch);
+	journal_add_changes(&journal, &version, 0, 5, JOURNAL_ITEM_CREATE);
+	old_version = version;
+
+	/* Version counter of entity overflowed */
+	version = 1;
+	new_epoch = vs_journal_new_epoch();
+	vs_journal_reset(&journal, version, new_epoch);
+	journal_add_changes(&journal, &version, 0, 10, JOURNAL_ITEM_CHANGE);
+
+	change_count = vs_journal_changes(&journal, epoch, old_version, version, &changes);
+	fail_unless( change_count == -1,
+			"Changes (%d) were sent for version before reset", change_count);
+
+	change_count = vs_journal_changes(&journal, new_epoch, 1, version, &changes);
+	fail_unless( change_count == 10,
+			"Number of changes: %d != 10", change_count);
+	free(changes);
+
+	vs_journal_destroy(&journal);
+}
+END_TEST
+
+/**
+ * \brief This function creates test suite for journal of entity changes
+ */
+struct Suite *journal_suite(void)
+{
+	struct Suite *suite = suite_create("Journal");
+	struct TCase *tc_core = tcase_create("Core");
+
+	tcase_add_test(tc_core, test_Journal_changes);
+	tcase_add_test(tc_core, test_Journal_recreated_entity);
+	tcase_add_test(tc_core, test_Journal_reset);
+
+	suite_add_tcase(suite, tc_core);
+
+	return suite;
+}
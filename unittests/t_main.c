@@ -107,6 +107,15 @@ int main(int argc, char *argv[])
 	srunner_add_suite(master_sr, negotiate_suite());
 	srunner_add_suite(master_sr, pack_suite());
 	srunner_add_suite(master_sr, unpack_suite());
+	srunner_add_suite(master_sr, hash_array_suite());
+	srunner_add_suite(master_sr, slab_suite());
+	srunner_add_suite(master_sr, compress_suite());
+	srunner_add_suite(master_sr, delta_suite());
+	srunner_add_suite(master_sr, history_suite());
+	srunner_add_suite(master_sr, congestion_suite());
+	srunner_add_suite(master_sr, out_queue_suite());
+	srunner_add_suite(master_sr, real16_suite());
+	srunner_add_suite(master_sr, journal_suite());
 
 	/* When client was started with some arguments */
 	if(argc > 1) {